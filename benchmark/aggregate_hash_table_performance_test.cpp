@@ -10,86 +10,166 @@ See the Mulan PSL v2 for more details. */
 
 #include <benchmark/benchmark.h>
 
+#include "common/lang/functional.h"
 #include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/unordered_map.h"
 #include "common/lang/vector.h"
 #include "sql/expr/aggregate_hash_table.h"
 
+/**
+ * @brief 输入是 (int key, int value) 两列，key 是 0~N-1 打乱顺序，参数0是分组数N
+ * @details 行数是 max(N, MIN_ROWS)，每次迭代都使用一个新的哈希表聚合所有的行，计算 SUM(value)
+ */
 class AggregateHashTableBenchmark : public benchmark::Fixture
 {
 public:
+  static constexpr int MIN_ROWS   = 1 << 20;
+  static constexpr int CHUNK_ROWS = 8192;
+
   void SetUp(const ::benchmark::State &state) override
   {
-    unique_ptr<Column> column1 = make_unique<Column>(AttrType::INTS, 4);
-    unique_ptr<Column> column2 = make_unique<Column>(AttrType::INTS, 4);
-    for (int i = 0; i < state.range(0); i++) {
-      int key = i % 8;
-      column1->append_one((char *)&key);
-      column2->append_one((char *)&i);
+    const int groups = static_cast<int>(state.range(0));
+    const int rows   = std::max(groups, MIN_ROWS);
+    for (int begin = 0; begin < rows; begin += CHUNK_ROWS) {
+      unique_ptr<Column> column1 = make_unique<Column>(AttrType::INTS, 4, CHUNK_ROWS);
+      unique_ptr<Column> column2 = make_unique<Column>(AttrType::INTS, 4, CHUNK_ROWS);
+      for (int i = begin; i < std::min(rows, begin + CHUNK_ROWS); i++) {
+        int key = static_cast<int>((i * 2654435761L) % groups);
+        column1->append_one((char *)&key);
+        column2->append_one((char *)&i);
+      }
+      group_chunks_.emplace_back(make_unique<Chunk>());
+      aggr_chunks_.emplace_back(make_unique<Chunk>());
+      group_chunks_.back()->add_column(std::move(column1), 0);
+      aggr_chunks_.back()->add_column(std::move(column2), 0);
     }
-    group_chunk_.add_column(std::move(column1), 0);
-    aggr_chunk_.add_column(std::move(column2), 0);
   }
 
   void TearDown(const ::benchmark::State &state) override
   {
-    group_chunk_.reset();
-    aggr_chunk_.reset();
+    group_chunks_.clear();
+    aggr_chunks_.clear();
+  }
+
+  void run(benchmark::State &state, const std::function<unique_ptr<AggregateHashTable>()> &create)
+  {
+    int64_t rows = 0;
+    for (auto _ : state) {
+      unique_ptr<AggregateHashTable> hash_table = create();
+      for (size_t i = 0; i < group_chunks_.size(); i++) {
+        hash_table->add_chunk(*group_chunks_[i], *aggr_chunks_[i]);
+        rows += group_chunks_[i]->rows();
+      }
+
+      state.PauseTiming();
+      hash_table.reset();
+      state.ResumeTiming();
+    }
+    state.counters["rows"] = benchmark::Counter(rows, benchmark::Counter::kIsRate);
   }
 
 protected:
-  Chunk group_chunk_;
-  Chunk aggr_chunk_;
+  vector<unique_ptr<Chunk>> group_chunks_;
+  vector<unique_ptr<Chunk>> aggr_chunks_;
 };
 
-class DISABLED_StandardAggregateHashTableBenchmark : public AggregateHashTableBenchmark
+/**
+ * @brief 原来的实现：unordered_map<vector<Value>, vector<Value>>，对每个分组字段的 to_string() 计算哈希值
+ */
+class UnorderedMapAggregateHashTable : public AggregateHashTable
 {
 public:
-  void SetUp(const ::benchmark::State &state) override
+  RC add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk) override
   {
-
-    AggregateHashTableBenchmark::SetUp(state);
-    AggregateExpr        aggregate_expr(AggregateExpr::Type::SUM, nullptr);
-    vector<Expression *> aggregate_exprs;
-    aggregate_exprs.push_back(&aggregate_expr);
-    standard_hash_table_ = make_unique<StandardAggregateHashTable>(aggregate_exprs);
+    for (int r = 0; r < groups_chunk.rows(); r++) {
+      vector<Value> group_values;
+      for (int i = 0; i < groups_chunk.column_num(); i++) {
+        group_values.emplace_back(groups_chunk.get_value(i, r));
+      }
+
+      vector<Value> &aggrs = aggr_values_[group_values];
+      if (aggrs.empty()) {
+        for (int i = 0; i < aggrs_chunk.column_num(); i++) {
+          aggrs.emplace_back(aggrs_chunk.get_value(i, r));
+        }
+        continue;
+      }
+      for (int i = 0; i < aggrs_chunk.column_num(); i++) {
+        aggrs[i].set_int(aggrs[i].get_int() + aggrs_chunk.get_value(i, r).get_int());
+      }
+    }
+    return RC::SUCCESS;
   }
 
-protected:
-  unique_ptr<AggregateHashTable> standard_hash_table_;
+private:
+  struct VectorHash
+  {
+    size_t operator()(const vector<Value> &vec) const
+    {
+      size_t hash = 0;
+      for (const auto &elem : vec) {
+        hash ^= std::hash<string>()(elem.to_string());
+      }
+      return hash;
+    }
+  };
+
+  struct VectorEqual
+  {
+    bool operator()(const vector<Value> &lhs, const vector<Value> &rhs) const
+    {
+      for (size_t i = 0; i < lhs.size(); ++i) {
+        if (rhs[i].compare(lhs[i]) != 0) {
+          return false;
+        }
+      }
+      return lhs.size() == rhs.size();
+    }
+  };
+
+  unordered_map<vector<Value>, vector<Value>, VectorHash, VectorEqual> aggr_values_;
 };
 
-BENCHMARK_DEFINE_F(DISABLED_StandardAggregateHashTableBenchmark, Aggregate)(benchmark::State &state)
+BENCHMARK_DEFINE_F(AggregateHashTableBenchmark, UnorderedMap)(benchmark::State &state)
 {
-  for (auto _ : state) {
-    standard_hash_table_->add_chunk(group_chunk_, aggr_chunk_);
-  }
+  run(state, []() { return make_unique<UnorderedMapAggregateHashTable>(); });
 }
 
-BENCHMARK_REGISTER_F(DISABLED_StandardAggregateHashTableBenchmark, Aggregate)->Arg(16)->Arg(1024)->Arg(8192);
-
-#ifdef USE_SIMD
-class DISABLED_LinearProbingAggregateHashTableBenchmark : public AggregateHashTableBenchmark
+BENCHMARK_DEFINE_F(AggregateHashTableBenchmark, Standard)(benchmark::State &state)
 {
-public:
-  void SetUp(const ::benchmark::State &state) override
-  {
-
-    AggregateHashTableBenchmark::SetUp(state);
-    linear_probing_hash_table_ = make_unique<LinearProbingAggregateHashTable<int>>(AggregateExpr::Type::SUM);
-  }
+  run(state, []() {
+    AggregateExpr        aggregate_expr(AggrFuncType::SUM, nullptr);
+    vector<Expression *> aggregate_exprs;
+    aggregate_exprs.push_back(&aggregate_expr);
+    return make_unique<StandardAggregateHashTable>(aggregate_exprs);
+  });
+}
 
-protected:
-  unique_ptr<AggregateHashTable> linear_probing_hash_table_;
-};
+// 原来的实现聚合1000万个分组需要几个GB的内存，只比较前两组
+BENCHMARK_REGISTER_F(AggregateHashTableBenchmark, UnorderedMap)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(AggregateHashTableBenchmark, Standard)
+    ->Arg(1000)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
 
-BENCHMARK_DEFINE_F(DISABLED_LinearProbingAggregateHashTableBenchmark, Aggregate)(benchmark::State &state)
+/// 参数1表示是否使用 AVX2 的实现，CPU 不支持 AVX2 或者没有打开 USE_SIMD 时都是标量的实现
+BENCHMARK_DEFINE_F(AggregateHashTableBenchmark, LinearProbing)(benchmark::State &state)
 {
-  for (auto _ : state) {
-    linear_probing_hash_table_->add_chunk(group_chunk_, aggr_chunk_);
-  }
+  const bool simd = set_simd_enabled(state.range(1) != 0);
+  state.SetLabel(simd ? "avx2" : "scalar");
+  run(state, []() {
+    AggregateExpr        aggregate_expr(AggrFuncType::SUM, nullptr);
+    vector<Expression *> aggregate_exprs;
+    aggregate_exprs.push_back(&aggregate_expr);
+    return make_unique<LinearProbingAggregateHashTable<int32_t>>(aggregate_exprs);
+  });
+  set_simd_enabled(true);
 }
 
-BENCHMARK_REGISTER_F(DISABLED_LinearProbingAggregateHashTableBenchmark, Aggregate)->Arg(16)->Arg(1024)->Arg(8192);
-#endif
+BENCHMARK_REGISTER_F(AggregateHashTableBenchmark, LinearProbing)
+    ->ArgsProduct({{1000, 1000000, 10000000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+BENCHMARK_MAIN();
@@ -12,7 +12,11 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/expr/arithmetic_operator.hpp"
 
-class DISABLED_ArithmeticBenchmark : public benchmark::Fixture
+/**
+ * @brief 参数0是数组的长度，参数1表示是否使用 AVX2 的实现
+ * @details CPU 不支持 AVX2 或者没有打开 USE_SIMD 时，参数1不管是什么都是标量的实现，label 中会标明实际使用的实现
+ */
+class ArithmeticBenchmark : public benchmark::Fixture
 {
 public:
   void SetUp(const ::benchmark::State &state) override
@@ -21,6 +25,8 @@ public:
     left_    = (float *)malloc(size * sizeof(float));
     right_   = (float *)malloc(size * sizeof(float));
     result_  = (float *)malloc(size * sizeof(float));
+    ints_.assign(size, 1);
+    compare_result_.assign(size, 1);
 
     for (int i = 0; i < size; ++i) {
       left_[i]   = 1.0f;
@@ -37,64 +43,83 @@ public:
     right_ = nullptr;
     free(result_);
     result_ = nullptr;
+    set_simd_enabled(true);
+  }
+
+  void enable_simd(benchmark::State &state)
+  {
+    const bool simd = set_simd_enabled(state.range(1) != 0);
+    state.SetLabel(simd ? "avx2" : "scalar");
   }
 
 protected:
-  float *left_   = nullptr;
-  float *right_  = nullptr;
-  float *result_ = nullptr;
+  float               *left_   = nullptr;
+  float               *right_  = nullptr;
+  float               *result_ = nullptr;
+  std::vector<int>     ints_;
+  std::vector<uint8_t> compare_result_;
 };
 
-BENCHMARK_DEFINE_F(DISABLED_ArithmeticBenchmark, Add)(benchmark::State &state)
+BENCHMARK_DEFINE_F(ArithmeticBenchmark, Add)(benchmark::State &state)
 {
+  enable_simd(state);
   for (auto _ : state) {
     binary_operator<false, false, float, AddOperator>(left_, right_, result_, state.range(0));
+    benchmark::DoNotOptimize(result_);
   }
 }
 
-BENCHMARK_REGISTER_F(DISABLED_ArithmeticBenchmark, Add)->Arg(10)->Arg(1000)->Arg(10000);
-
-BENCHMARK_DEFINE_F(DISABLED_ArithmeticBenchmark, Sub)(benchmark::State &state)
+BENCHMARK_DEFINE_F(ArithmeticBenchmark, Sub)(benchmark::State &state)
 {
+  enable_simd(state);
   for (auto _ : state) {
     binary_operator<false, false, float, SubtractOperator>(left_, right_, result_, state.range(0));
+    benchmark::DoNotOptimize(result_);
   }
 }
 
-BENCHMARK_REGISTER_F(DISABLED_ArithmeticBenchmark, Sub)->Arg(10)->Arg(1000)->Arg(10000);
-
-#ifdef USE_SIMD
-static void DISABLED_benchmark_sum_simd(benchmark::State &state)
+BENCHMARK_DEFINE_F(ArithmeticBenchmark, Mul)(benchmark::State &state)
 {
-  int              size = state.range(0);
-  std::vector<int> data(state.range(0), 1);
+  enable_simd(state);
   for (auto _ : state) {
-    mm256_sum_epi32(data.data(), size);
+    binary_operator<false, true, float, MultiplyOperator>(left_, right_, result_, state.range(0));
+    benchmark::DoNotOptimize(result_);
   }
 }
 
-BENCHMARK(DISABLED_benchmark_sum_simd)->RangeMultiplier(2)->Range(1 << 10, 1 << 12);
-#endif
+BENCHMARK_DEFINE_F(ArithmeticBenchmark, Compare)(benchmark::State &state)
+{
+  enable_simd(state);
+  for (auto _ : state) {
+    compare_result<float, false, false>(left_, right_, state.range(0), compare_result_, CompOp::GREAT_THAN);
+    uint8_t *result = compare_result_.data();
+    benchmark::DoNotOptimize(result);
+  }
+}
 
-static int sum_scalar(const int *data, int size)
+BENCHMARK_DEFINE_F(ArithmeticBenchmark, SumInt)(benchmark::State &state)
 {
-  int sum = 0;
-  for (int i = 0; i < size; i++) {
-    sum += data[i];
+  enable_simd(state);
+  for (auto _ : state) {
+    int res = mm256_sum_epi32(ints_.data(), state.range(0));
+    benchmark::DoNotOptimize(res);
   }
-  return sum;
 }
 
-static void DISABLED_benchmark_sum_scalar(benchmark::State &state)
+BENCHMARK_DEFINE_F(ArithmeticBenchmark, SumFloat)(benchmark::State &state)
 {
-  int              size = state.range(0);
-  std::vector<int> data(size, 1);
+  enable_simd(state);
   for (auto _ : state) {
-    int res = sum_scalar(data.data(), size);
+    float res = mm256_sum_ps(left_, state.range(0));
     benchmark::DoNotOptimize(res);
   }
 }
 
-BENCHMARK(DISABLED_benchmark_sum_scalar)->RangeMultiplier(2)->Range(1 << 10, 1 << 12);
+BENCHMARK_REGISTER_F(ArithmeticBenchmark, Add)->ArgsProduct({{10, 1000, 10000}, {0, 1}});
+BENCHMARK_REGISTER_F(ArithmeticBenchmark, Sub)->ArgsProduct({{10, 1000, 10000}, {0, 1}});
+BENCHMARK_REGISTER_F(ArithmeticBenchmark, Mul)->ArgsProduct({{10, 1000, 10000}, {0, 1}});
+BENCHMARK_REGISTER_F(ArithmeticBenchmark, Compare)->ArgsProduct({{10, 1000, 10000}, {0, 1}});
+BENCHMARK_REGISTER_F(ArithmeticBenchmark, SumInt)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1}});
+BENCHMARK_REGISTER_F(ArithmeticBenchmark, SumFloat)->ArgsProduct({{1 << 10, 1 << 12}, {0, 1}});
 
-BENCHMARK_MAIN();
\ No newline at end of file
+BENCHMARK_MAIN();
@@ -0,0 +1,138 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "common/lang/algorithm.h"
+#include "common/lang/filesystem.h"
+#include "common/lang/memory.h"
+#include "common/lang/stdexcept.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
+
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较给有数据的表创建索引时，逐条插入和批量构建B+树的耗时
+ * @details 键值是乱序的整数，参数是数据量。
+ * 逐条插入使用 BplusTreeHandler::insert_entry，批量构建使用 BplusTreeBulkLoader，
+ * 两者的时间都包含把所有页面写到磁盘。这里没有记录日志，真实环境中逐条插入还要为每次修改写日志。
+ */
+class BplusTreeBuildBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("bplus_tree_bulk_load_test.log", LOG_LEVEL_WARN);
+
+    keys_.resize(state.range(0));
+    for (size_t i = 0; i < keys_.size(); i++) {
+      keys_[i] = static_cast<int>(i);
+    }
+    shuffle(keys_.begin(), keys_.end(), std::mt19937(1));
+
+    filesystem::remove_all(directory_);
+    filesystem::create_directories(directory_);
+    bpm_ = make_unique<BufferPoolManager>();
+    if (OB_FAIL(bpm_->init(make_unique<VacuousDoubleWriteBuffer>()))) {
+      throw runtime_error("failed to init buffer pool manager");
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    bpm_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+  void Build(State &state, bool bulk)
+  {
+    state.PauseTiming();
+    filesystem::remove(index_file_);
+    BplusTreeHandler handler;
+    if (OB_FAIL(handler.create(log_handler_, *bpm_, index_file_.c_str(), AttrType::INTS, sizeof(int)))) {
+      throw runtime_error("failed to create b+tree");
+    }
+    state.ResumeTiming();
+
+    RC rc = RC::SUCCESS;
+    if (bulk) {
+      BplusTreeBulkLoader loader(handler);
+      for (size_t i = 0; i < keys_.size() && OB_SUCC(rc); i++) {
+        rc = loader.add(reinterpret_cast<const char *>(&keys_[i]), RID(keys_[i] / 1024 + 1, keys_[i] % 1024));
+      }
+      if (OB_SUCC(rc)) {
+        rc = loader.finish();
+      }
+    } else {
+      for (size_t i = 0; i < keys_.size() && OB_SUCC(rc); i++) {
+        RID rid(keys_[i] / 1024 + 1, keys_[i] % 1024);
+        rc = handler.insert_entry(reinterpret_cast<const char *>(&keys_[i]), &rid);
+      }
+      if (OB_SUCC(rc)) {
+        rc = handler.sync();
+      }
+    }
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to build b+tree");
+    }
+
+    state.PauseTiming();
+    bpm_->close_file(index_file_.c_str());
+    state.ResumeTiming();
+  }
+
+protected:
+  const filesystem::path directory_  = "bplus_tree_bulk_load_test";
+  const string           index_file_ = (directory_ / "index.btree").string();
+
+  vector<int>                   keys_;
+  VacuousLogHandler             log_handler_;
+  unique_ptr<BufferPoolManager> bpm_;
+};
+
+BENCHMARK_DEFINE_F(BplusTreeBuildBenchmark, Insert)(State &state)
+{
+  for (auto _ : state) {
+    Build(state, false /*bulk*/);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(BplusTreeBuildBenchmark, BulkLoad)(State &state)
+{
+  for (auto _ : state) {
+    Build(state, true /*bulk*/);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(BplusTreeBuildBenchmark, Insert)
+    ->ArgName("rows")
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(kMillisecond)
+    ->UseRealTime();
+BENCHMARK_REGISTER_F(BplusTreeBuildBenchmark, BulkLoad)
+    ->ArgName("rows")
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -40,6 +40,9 @@ struct Stat
   int64_t scan_open_failed_count = 0;
   int64_t mismatch_count         = 0;
   int64_t scan_other_count       = 0;
+
+  int64_t lookup_found_count     = 0;
+  int64_t lookup_not_found_count = 0;
 };
 
 class BenchmarkBase : public Fixture
@@ -150,6 +153,19 @@ public:
     }
   }
 
+  void Lookup(uint32_t value, Stat &stat)
+  {
+    const char *key = reinterpret_cast<const char *>(&value);
+    list<RID>   rids;
+
+    RC rc = handler_.get_entry(key, sizeof(value), rids);
+    if (rc == RC::SUCCESS && rids.size() == 1) {
+      stat.lookup_found_count++;
+    } else {
+      stat.lookup_not_found_count++;
+    }
+  }
+
   void Scan(uint32_t begin, uint32_t end, Stat &stat)
   {
     const char *begin_key = reinterpret_cast<const char *>(&begin);
@@ -348,4 +364,67 @@ BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->Threads(10)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @brief 读多写少的场景，95% 等值查询，5% 插入
+ * @details 预先插入 [0, max) 范围的数据，查询只访问这个范围，所有查询都应该能找到数据；
+ * 插入的数据在 [max, 2*max) 范围内，会引起节点分裂，用来测试乐观读在并发修改下的表现。
+ * 第二个参数为1时启用自适应哈希索引。
+ */
+class ReadMostlyBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "read_mostly"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    uint32_t max = static_cast<uint32_t>(state.range(0));
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    FillUp(0, max);
+
+    AdaptiveHashOptions options;
+    options.enabled = (state.range(1) != 0);
+    handler_.enable_adaptive_hash(options);
+  }
+};
+
+BENCHMARK_DEFINE_F(ReadMostlyBenchmark, ReadMostly)(State &state)
+{
+  const uint32_t max = static_cast<uint32_t>(state.range(0));
+
+  IntegerGenerator lookup_generator(0, max - 1);
+  IntegerGenerator insert_generator(max, max * 2 - 1);
+  IntegerGenerator operation_generator(0, 99);
+
+  Stat stat;
+
+  for (auto _ : state) {
+    if (operation_generator.next() < 5) {
+      Insert(static_cast<uint32_t>(insert_generator.next()), stat);
+    } else {
+      Lookup(static_cast<uint32_t>(lookup_generator.next()), stat);
+    }
+  }
+
+  state.counters.insert({{"lookup_found", Counter(stat.lookup_found_count, Counter::kIsRate)},
+      {"lookup_not_found", Counter(stat.lookup_not_found_count, Counter::kIsRate)},
+      {"insert_success", Counter(stat.insert_success_count, Counter::kIsRate)},
+      {"insert_duplicate", Counter(stat.duplicate_count, Counter::kIsRate)},
+      {"insert_other", Counter(stat.insert_other_count, Counter::kIsRate)}});
+}
+
+BENCHMARK_REGISTER_F(ReadMostlyBenchmark, ReadMostly)
+    ->Threads(16)
+    ->Threads(32)
+    ->Threads(64)
+    ->Args({10 * 10000, 0})
+    ->Args({10 * 10000, 1});
+
+////////////////////////////////////////////////////////////////////////////////
+
 BENCHMARK_MAIN();
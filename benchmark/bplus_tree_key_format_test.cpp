@@ -0,0 +1,118 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较定长格式和紧凑格式的B+树：树高、扇出以及等值查询的性能
+//
+#include <benchmark/benchmark.h>
+
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 键值是 CHAR(KEY_LENGTH)，内容类似于 "user/00001234/profile"，有公共前缀并且远远没有占满整个字段
+ * @details 参数0是键值格式，参数1是数据量
+ */
+class KeyFormatBenchmark : public Fixture
+{
+public:
+  static constexpr int KEY_LENGTH = 64;
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    bpm_.init(make_unique<VacuousDoubleWriteBuffer>());
+    LoggerFactory::init_default("key_format.log", LOG_LEVEL_WARN);
+
+    const char *filename = "key_format.btree";
+    ::remove(filename);
+
+    const auto key_format = static_cast<BplusTreeKeyFormat>(state.range(0));
+    RC rc = handler_.create(log_handler_, bpm_, filename, AttrType::CHARS, KEY_LENGTH, -1, -1, key_format);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to create btree handler");
+    }
+
+    key_num_ = static_cast<int>(state.range(1));
+    for (int i = 0; i < key_num_; i++) {
+      char key[KEY_LENGTH];
+      MakeKey(i, key);
+      RID rid(i, i);
+      rc = handler_.insert_entry(key, &rid);
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to insert entry");
+      }
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+    handler_.close();
+    bpm_.close_file("key_format.btree");
+  }
+
+  static void MakeKey(int value, char *key)
+  {
+    memset(key, 0, KEY_LENGTH);
+    snprintf(key, KEY_LENGTH, "user/%08d/profile", value);
+  }
+
+protected:
+  BufferPoolManager bpm_;
+  BplusTreeHandler  handler_;
+  VacuousLogHandler log_handler_;
+  int               key_num_ = 0;
+};
+
+BENCHMARK_DEFINE_F(KeyFormatBenchmark, PointLookup)(State &state)
+{
+  IntegerGenerator generator(0, key_num_ - 1);
+  int64_t          found = 0;
+  list<RID>        rids;
+  for (auto _ : state) {
+    char key[KEY_LENGTH];
+    MakeKey(static_cast<int>(generator.next()), key);
+    rids.clear();
+    handler_.get_entry(key, strlen(key), rids);
+    found += rids.size();
+  }
+
+  BplusTreeStat stat;
+  handler_.stat(stat);
+  state.SetLabel(handler_.file_header().key_format == static_cast<int32_t>(BplusTreeKeyFormat::COMPACT) ? "compact"
+                                                                                                       : "fixed");
+  state.counters["found"]            = Counter(found, Counter::kIsRate);
+  state.counters["height"]           = stat.height;
+  state.counters["leaf_nodes"]       = stat.leaf_count;
+  state.counters["internal_nodes"]   = stat.internal_count;
+  state.counters["avg_leaf_entries"] = stat.avg_leaf_entries();
+  state.counters["avg_fanout"]       = stat.avg_fanout();
+}
+
+BENCHMARK_REGISTER_F(KeyFormatBenchmark, PointLookup)
+    ->ArgsProduct({{static_cast<int64_t>(BplusTreeKeyFormat::FIXED), static_cast<int64_t>(BplusTreeKeyFormat::COMPACT)},
+        {100 * 1000}});
+
+BENCHMARK_MAIN();
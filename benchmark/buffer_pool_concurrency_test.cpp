@@ -0,0 +1,199 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/filesystem.h"
+#include "common/lang/memory.h"
+#include "common/lang/stdexcept.h"
+#include "common/lang/vector.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 测试多个线程并发获取页面的吞吐量
+ * @details 访问的页面都能够放在内存中，测试的是页表查找与pin/unpin的开销，而不是磁盘IO。
+ * 参数是访问的页面数量。
+ */
+class GetPageBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    LoggerFactory::init_default("buffer_pool_concurrency_test.log", LOG_LEVEL_INFO);
+
+    filesystem::remove(file_name_);
+
+    bpm_ = make_unique<BufferPoolManager>();
+    RC rc = bpm_->init(make_unique<VacuousDoubleWriteBuffer>());
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to init buffer pool manager");
+    }
+
+    rc = bpm_->create_file(file_name_);
+    if (OB_SUCC(rc)) {
+      rc = bpm_->open_file(log_handler_, file_name_, buffer_pool_);
+    }
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to create buffer pool file");
+    }
+
+    page_nums_.clear();
+    for (int64_t i = 0; i < state.range(0); i++) {
+      Frame *frame = nullptr;
+      rc           = buffer_pool_->allocate_page(&frame);
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to allocate page");
+      }
+      page_nums_.push_back(frame->page_num());
+      buffer_pool_->unpin_page(frame);
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    bpm_->close_file(file_name_);
+    bpm_.reset();
+    buffer_pool_ = nullptr;
+    filesystem::remove(file_name_);
+  }
+
+  void GetPage(PageNum page_num, int64_t &success_count, int64_t &failed_count)
+  {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_SUCC(rc)) {
+      buffer_pool_->unpin_page(frame);
+      success_count++;
+    } else {
+      failed_count++;
+    }
+  }
+
+protected:
+  const char                   *file_name_ = "buffer_pool_concurrency_test.bp";
+  VacuousLogHandler             log_handler_;
+  unique_ptr<BufferPoolManager> bpm_;
+  DiskBufferPool               *buffer_pool_ = nullptr;
+  vector<PageNum>               page_nums_;
+};
+
+BENCHMARK_DEFINE_F(GetPageBenchmark, GetPage)(State &state)
+{
+  IntegerGenerator generator(0, static_cast<int>(page_nums_.size()) - 1);
+  int64_t          success_count = 0;
+  int64_t          failed_count  = 0;
+
+  for (auto _ : state) {
+    GetPage(page_nums_[generator.next()], success_count, failed_count);
+  }
+
+  state.counters["success"] = Counter(success_count, Counter::kIsRate);
+  state.counters["failed"]  = Counter(failed_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(GetPageBenchmark, GetPage)
+    ->ArgName("pages")
+    ->Arg(64)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->Threads(16)
+    ->UseRealTime();
+
+/**
+ * @brief 测试多个线程并发地直接从 BPFrameManager 获取页帧的吞吐量
+ * @details 不经过 DiskBufferPool，只有分片页表的查找与pin/unpin。参数是页帧的数量。
+ */
+class FrameManagerBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    frame_manager_ = make_unique<BPFrameManager>("Benchmark");
+    RC rc          = frame_manager_->init(2);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to init frame manager");
+    }
+
+    for (PageNum i = 0; i < state.range(0); i++) {
+      Frame *frame = frame_manager_->alloc(buffer_pool_id_, i);
+      if (frame == nullptr) {
+        throw runtime_error("failed to allocate frame");
+      }
+      frame->unpin();
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    frame_manager_->purge_frames(static_cast<int>(state.range(0)), [](Frame *) { return RC::SUCCESS; });
+    frame_manager_->cleanup();
+    frame_manager_.reset();
+  }
+
+protected:
+  const int                  buffer_pool_id_ = 0;
+  unique_ptr<BPFrameManager> frame_manager_;
+};
+
+BENCHMARK_DEFINE_F(FrameManagerBenchmark, GetFrame)(State &state)
+{
+  IntegerGenerator generator(0, static_cast<int>(state.range(0)) - 1);
+  int64_t          success_count = 0;
+  int64_t          failed_count  = 0;
+
+  for (auto _ : state) {
+    Frame *frame = frame_manager_->get(buffer_pool_id_, generator.next());
+    if (frame != nullptr) {
+      frame->unpin();
+      success_count++;
+    } else {
+      failed_count++;
+    }
+  }
+
+  state.counters["success"] = Counter(success_count, Counter::kIsRate);
+  state.counters["failed"]  = Counter(failed_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(FrameManagerBenchmark, GetFrame)
+    ->ArgName("frames")
+    ->Arg(200)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->Threads(8)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/filesystem.h"
+#include "common/lang/memory.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/log_replayer.h"
+
+using namespace common;
+using namespace benchmark;
+
+class EmptyLogReplayer : public LogReplayer
+{
+public:
+  RC replay(const LogEntry &) override { return RC::SUCCESS; }
+};
+
+/**
+ * @brief 测试不同提交策略下，多个会话并发提交时每秒可以提交多少次
+ * @details 每次提交写入一条日志，然后等待这条日志提交(wait_lsn)。
+ * 参数是提交策略，参考 LogCommitPolicy。
+ */
+class CommitBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    LoggerFactory::init_default("clog_commit_concurrency_test.log", LOG_LEVEL_INFO);
+
+    filesystem::remove_all(directory_);
+
+    handler_ = make_unique<DiskLogHandler>();
+    RC rc    = handler_->init(directory_);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to init log handler");
+    }
+
+    handler_->set_commit_policy(static_cast<LogCommitPolicy>(state.range(0)), 10 /*sync_interval_ms*/);
+
+    EmptyLogReplayer replayer;
+    rc = handler_->replay(replayer, 0);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to replay log handler");
+    }
+
+    rc = handler_->start();
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to start log handler");
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    handler_->stop();
+    handler_->await_termination();
+    handler_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+  void Commit(int64_t &success_count, int64_t &failed_count)
+  {
+    LSN          lsn = 0;
+    vector<char> data(64);
+    RC           rc = handler_->append(lsn, LogModule::Id::TRANSACTION, std::move(data));
+    if (OB_SUCC(rc)) {
+      rc = handler_->wait_lsn(lsn);
+    }
+
+    if (OB_SUCC(rc)) {
+      success_count++;
+    } else {
+      failed_count++;
+    }
+  }
+
+protected:
+  const char                *directory_ = "clog_commit_concurrency_test";
+  unique_ptr<DiskLogHandler> handler_;
+};
+
+BENCHMARK_DEFINE_F(CommitBenchmark, Commit)(State &state)
+{
+  int64_t success_count = 0;
+  int64_t failed_count  = 0;
+  for (auto _ : state) {
+    Commit(success_count, failed_count);
+  }
+
+  state.counters["commits"] = Counter(success_count, Counter::kIsRate);
+  state.counters["failed"]  = Counter(failed_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(CommitBenchmark, Commit)
+    ->ArgName("policy")
+    ->Arg(static_cast<int>(LogCommitPolicy::SYNC_PER_GROUP))
+    ->Arg(static_cast<int>(LogCommitPolicy::SYNC_INTERVAL))
+    ->Arg(static_cast<int>(LogCommitPolicy::NO_SYNC))
+    ->Threads(1)
+    ->Threads(16)
+    ->Threads(128)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,164 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/conf/ini.h"
+#include "common/lang/filesystem.h"
+#include "common/lang/memory.h"
+#include "common/lang/stdexcept.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/log/log.h"
+#include "storage/db/db.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 测试不同回放线程数时，数据库重启恢复需要多长时间
+ * @details 先创建一个数据库，在多张表中插入大量数据，等日志落地后，在页面刷盘之前把整个目录复制一份作为模板。
+ * 此时日志文件就是正常写入的文件，可以使用 clog_dump 查看。
+ * 每次测试都从模板复制一个新的目录，然后初始化数据库，时间主要花在回放日志上。
+ * 参数是回放线程个数，参考配置项 [CLOG] REDO_WORKERS。
+ */
+class RecoveryBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("clog_recovery_test.log", LOG_LEVEL_WARN);
+    if (!filesystem::exists(template_path_)) {
+      generate();
+    }
+  }
+
+  void TearDown(const State &state) override { filesystem::remove_all(work_path_); }
+
+  void Recover(State &state)
+  {
+    state.PauseTiming();
+    filesystem::remove_all(work_path_);
+    filesystem::copy(template_path_, work_path_, filesystem::copy_options::recursive);
+    get_properties()->put("REDO_WORKERS", std::to_string(state.range(0)), "CLOG");
+    state.ResumeTiming();
+
+    auto db = make_unique<Db>();
+    RC   rc = db->init(dbname_, work_path_.c_str(), trx_kit_name_, log_handler_name_);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to recover db");
+    }
+
+    state.PauseTiming();
+    db.reset();
+    state.ResumeTiming();
+  }
+
+private:
+  void generate()
+  {
+    const filesystem::path generate_path = directory_ / "generate";
+    filesystem::remove_all(directory_);
+    filesystem::create_directories(generate_path);
+
+    // 只是为了生成日志，不需要每次提交都等待日志刷盘
+    get_properties()->put("COMMIT_POLICY", "no_sync", "CLOG");
+
+    auto db = make_unique<Db>();
+    RC   rc = db->init(dbname_, generate_path.c_str(), trx_kit_name_, log_handler_name_);
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to init db");
+    }
+
+    vector<AttrInfoSqlNode> attr_infos(field_num_);
+    for (int i = 0; i < field_num_; i++) {
+      attr_infos[i].name   = "field_" + std::to_string(i);
+      attr_infos[i].type   = AttrType::INTS;
+      attr_infos[i].length = 4;
+    }
+
+    vector<Table *> tables;
+    for (int i = 0; i < table_num_; i++) {
+      string table_name = "table_" + std::to_string(i);
+      rc                = db->create_table(table_name.c_str(), attr_infos);
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to create table");
+      }
+      tables.push_back(db->find_table(table_name.c_str()));
+    }
+
+    TrxKit       &trx_kit = db->trx_kit();
+    vector<Value> values(field_num_);
+    for (int i = 0; i < insert_num_; i++) {
+      Trx *trx = trx_kit.create_trx(db->log_handler());
+      trx->start_if_need();
+      for (Value &value : values) {
+        value.set_int(i);
+      }
+
+      Record record;
+      Table *table = tables[i % table_num_];
+      rc           = table->make_record(static_cast<int>(values.size()), values.data(), record);
+      if (OB_SUCC(rc)) {
+        rc = trx->insert_record(table, record);
+      }
+      if (OB_SUCC(rc)) {
+        rc = trx->commit();
+      }
+      trx_kit.destroy_trx(trx);
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to insert record");
+      }
+    }
+
+    rc = db->log_handler().wait_lsn(db->log_handler().current_lsn());
+    if (OB_FAIL(rc)) {
+      throw runtime_error("failed to wait lsn");
+    }
+
+    // 页面还没有刷盘，复制出来的目录重启时需要回放所有日志
+    filesystem::copy(generate_path, template_path_, filesystem::copy_options::recursive);
+    db.reset();
+    filesystem::remove_all(generate_path);
+  }
+
+protected:
+  const filesystem::path directory_        = "clog_recovery_test";
+  const filesystem::path template_path_    = directory_ / "template";
+  const filesystem::path work_path_        = directory_ / "work";
+  const char            *dbname_           = "recovery_db";
+  const char            *trx_kit_name_     = "mvcc";
+  const char            *log_handler_name_ = "disk";
+
+  const int table_num_  = 16;
+  const int field_num_  = 8;
+  const int insert_num_ = 200000;
+};
+
+BENCHMARK_DEFINE_F(RecoveryBenchmark, Recover)(State &state)
+{
+  for (auto _ : state) {
+    Recover(state);
+  }
+}
+
+BENCHMARK_REGISTER_F(RecoveryBenchmark, Recover)
+    ->ArgName("workers")
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
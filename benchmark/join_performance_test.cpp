@@ -0,0 +1,188 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较嵌套循环连接、哈希连接和归并连接执行两表、三表等值连接的性能
+//
+#include <benchmark/benchmark.h>
+
+#include "common/lang/algorithm.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "operator_test_util.h"
+#include "sql/operator/hash_join_physical_operator.h"
+#include "sql/operator/join_physical_operator.h"
+#include "sql/operator/merge_join_physical_operator.h"
+#include "sql/operator/predicate_physical_operator.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+namespace {
+
+/// 嵌套循环连接之后再过滤，right_key 是连接之后的行中右边字段的下标
+unique_ptr<PhysicalOperator> nested_loop_join(
+    unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right, int left_key, int right_key)
+{
+  auto join = make_unique<NestedLoopJoinPhysicalOperator>();
+  join->add_child(std::move(left));
+  join->add_child(std::move(right));
+
+  auto predicate = make_unique<PredicatePhysicalOperator>(
+      make_unique<ComparisonExpr>(EQUAL_TO, make_unique<CellExpr>(left_key), make_unique<CellExpr>(right_key)));
+  predicate->add_child(std::move(join));
+  return predicate;
+}
+
+unique_ptr<PhysicalOperator> hash_join(unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right,
+    int left_key, int right_key, const HashJoinOptions &options)
+{
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  left_keys.emplace_back(new CellExpr(left_key));
+  right_keys.emplace_back(new CellExpr(right_key));
+
+  auto join = make_unique<HashJoinPhysicalOperator>(std::move(left_keys), std::move(right_keys), options);
+  join->add_child(std::move(left));
+  join->add_child(std::move(right));
+  return join;
+}
+
+unique_ptr<PhysicalOperator> merge_join(
+    unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right, int left_key, int right_key)
+{
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  left_keys.emplace_back(new CellExpr(left_key));
+  right_keys.emplace_back(new CellExpr(right_key));
+
+  auto join = make_unique<MergeJoinPhysicalOperator>(std::move(left_keys), std::move(right_keys));
+  join->add_child(std::move(left));
+  join->add_child(std::move(right));
+  return join;
+}
+
+}  // namespace
+
+/**
+ * @brief 每个表的键值是 0~N-1 打乱顺序，连接结果也是N行
+ * @details 参数0是算法：0 嵌套循环，1 哈希连接，2 哈希连接并且把内存限制设置得很小，使用临时文件，
+ * 3 归并连接，这时每个表按照键值排好序，相当于按照索引扫描。
+ * 参数1是每个表的行数
+ */
+class JoinBenchmark : public Fixture
+{
+public:
+  enum Algorithm
+  {
+    NESTED_LOOP,
+    HASH,
+    HASH_SPILL,
+    MERGE,
+  };
+
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("join_performance.log", LOG_LEVEL_WARN);
+
+    const int row_num = static_cast<int>(state.range(1));
+    for (vector<vector<Value>> &rows : tables_) {
+      rows.clear();
+      for (int i = 0; i < row_num; i++) {
+        rows.push_back({Value(static_cast<int>((i * 7919L) % row_num)), Value(i)});
+      }
+      if (state.range(0) == MERGE) {
+        sort(rows.begin(), rows.end(), [](const vector<Value> &a, const vector<Value> &b) {
+          return a[0].compare(b[0]) < 0;
+        });
+      }
+    }
+
+    options_ = HashJoinOptions();
+    if (state.range(0) == HASH_SPILL) {
+      options_.memory = 64 * 1024;
+    }
+  }
+
+  /// left_cells 是左边一行有几个字段
+  unique_ptr<PhysicalOperator> join(int algorithm, unique_ptr<PhysicalOperator> left,
+      unique_ptr<PhysicalOperator> right, int left_cells, int left_key, int right_key)
+  {
+    if (algorithm == NESTED_LOOP) {
+      return nested_loop_join(std::move(left), std::move(right), left_key, left_cells + right_key);
+    }
+    if (algorithm == MERGE) {
+      return merge_join(std::move(left), std::move(right), left_key, right_key);
+    }
+    return hash_join(std::move(left), std::move(right), left_key, right_key, options_);
+  }
+
+  void run(State &state, PhysicalOperator &oper)
+  {
+    int64_t rows = 0;
+    for (auto _ : state) {
+      RC rc = oper.open(nullptr);
+      if (OB_FAIL(rc)) {
+        throw runtime_error("failed to open join operator");
+      }
+      while (OB_SUCC(rc = oper.next())) {
+        rows++;
+      }
+      oper.close();
+    }
+    state.counters["rows"] = Counter(rows, Counter::kIsRate);
+  }
+
+protected:
+  vector<vector<Value>> tables_[3];
+  HashJoinOptions       options_;
+};
+
+BENCHMARK_DEFINE_F(JoinBenchmark, TwoTables)(State &state)
+{
+  auto oper = join(state.range(0),
+      make_unique<RowsPhysicalOperator>("a", 2, &tables_[0]),
+      make_unique<RowsPhysicalOperator>("b", 2, &tables_[1]),
+      2,
+      0 /*a.key*/,
+      0 /*b.key*/);
+  run(state, *oper);
+}
+
+BENCHMARK_DEFINE_F(JoinBenchmark, ThreeTables)(State &state)
+{
+  // (a join b on a.key=b.key) join c on b.key=c.key。归并连接的输出仍然按照键值排序
+  const int algorithm = state.range(0);
+  auto      inner     = join(algorithm,
+      make_unique<RowsPhysicalOperator>("a", 2, &tables_[0]),
+      make_unique<RowsPhysicalOperator>("b", 2, &tables_[1]),
+      2,
+      0 /*a.key*/,
+      0 /*b.key*/);
+  auto oper = join(algorithm,
+      std::move(inner),
+      make_unique<RowsPhysicalOperator>("c", 2, &tables_[2]),
+      4,
+      2 /*b.key*/,
+      0 /*c.key*/);
+  run(state, *oper);
+}
+
+BENCHMARK_REGISTER_F(JoinBenchmark, TwoTables)
+    ->ArgsProduct({{JoinBenchmark::NESTED_LOOP, JoinBenchmark::HASH, JoinBenchmark::HASH_SPILL, JoinBenchmark::MERGE},
+        {1000, 4000}})
+    ->Unit(kMillisecond);
+BENCHMARK_REGISTER_F(JoinBenchmark, ThreeTables)
+    ->ArgsProduct({{JoinBenchmark::NESTED_LOOP, JoinBenchmark::HASH, JoinBenchmark::HASH_SPILL, JoinBenchmark::MERGE},
+        {1000, 4000}})
+    ->Unit(kMillisecond);
+
+BENCHMARK_MAIN();
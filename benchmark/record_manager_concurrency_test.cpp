@@ -13,8 +13,10 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <benchmark/benchmark.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <random>
+#include <unistd.h>
 
 #include "common/lang/stdexcept.h"
 #include "common/log/log.h"
@@ -355,6 +357,112 @@ BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->Threads(10)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @brief 冷数据全表扫描
+ * @details 表比buffer pool大得多，每次扫描前把文件从操作系统的page cache中清掉，
+ * 这样每个页面都需要从磁盘读取。第一个参数是记录数，第二个参数是每次预读的页面数，0表示不预读。
+ */
+class ColdScanBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "cold_scan"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    bpm_.set_read_ahead_pages(static_cast<int>(state.range(1)));
+    bpm_.start_read_ahead();
+
+    int32_t max = static_cast<int32_t>(state.range(0));
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    vector<RID> rids;
+    FillUp(0, max, rids);
+  }
+
+  void TearDown(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    bpm_.stop_read_ahead();
+    BenchmarkBase::TearDown(state);
+  }
+
+  void DropCache()
+  {
+    const int fd = buffer_pool_->file_desc();
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  }
+
+  int64_t ScanAll(Stat &stat)
+  {
+    RecordFileScanner scanner;
+    VacuousTrx        trx;
+    RC                rc = scanner.open_scan(
+        nullptr /*table*/, *buffer_pool_, &trx, log_handler_, ReadWriteMode::READ_ONLY, nullptr /*condition_filter*/);
+    if (rc != RC::SUCCESS) {
+      stat.scan_open_failed_count++;
+      return 0;
+    }
+
+    Record  record;
+    int64_t count = 0;
+    while (OB_SUCC(rc = scanner.next(record))) {
+      count++;
+    }
+
+    if (rc != RC::RECORD_EOF) {
+      stat.scan_other_count++;
+    } else {
+      stat.scan_success_count++;
+    }
+    scanner.close_scan();
+    return count;
+  }
+};
+
+BENCHMARK_DEFINE_F(ColdScanBenchmark, ColdScan)(State &state)
+{
+  Stat        stat;
+  int64_t     record_count = 0;
+  BPFrameStat stat_before  = bpm_.get_frame_manager().stat();
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    DropCache();
+    state.ResumeTiming();
+
+    record_count += ScanAll(stat);
+  }
+
+  state.SetItemsProcessed(record_count);
+  state.SetBytesProcessed(record_count * sizeof(TestRecord));
+  state.counters["success"] = Counter(stat.scan_success_count, Counter::kIsRate);
+  state.counters["other"]   = Counter(stat.scan_other_count, Counter::kIsRate);
+
+  // 每次扫描有多少页面是扫描线程自己读的，多少是预读的
+  BPFrameStat stat_after          = bpm_.get_frame_manager().stat();
+  state.counters["page_miss"]     = Counter(stat_after.miss_count - stat_before.miss_count, Counter::kAvgIterations);
+  state.counters["page_read_ahead"] =
+      Counter(stat_after.read_ahead_count - stat_before.read_ahead_count, Counter::kAvgIterations);
+}
+
+BENCHMARK_REGISTER_F(ColdScanBenchmark, ColdScan)
+    ->ArgNames({"records", "read_ahead"})
+    ->Args({40 * 10000, 0})
+    ->Args({40 * 10000, 64})
+    ->Unit(kMillisecond)
+    ->UseRealTime();
+
+////////////////////////////////////////////////////////////////////////////////
+
 struct MixtureBenchmark : public BenchmarkBase
 {
   string Name() const override { return "mixture"; }
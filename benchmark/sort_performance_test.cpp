@@ -0,0 +1,133 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 比较逐个比较 Value 的排序与 ExternalSorter 在内存中排序、写临时文件归并、top-N 的性能
+//
+#include <benchmark/benchmark.h>
+
+#include "common/lang/algorithm.h"
+#include "common/lang/random.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "sql/operator/external_sorter.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 每一行按照 (整数, 字符串) 排序，payload 是 (行号, 字符串)
+ * @details 参数0是算法：0 把所有的行缓存成 vector<Value> 再使用 Value::compare 排序(原来的实现)，
+ * 1 ExternalSorter 在内存中排序，2 ExternalSorter 把内存限制设置得很小，写临时文件再归并，
+ * 3 ExternalSorter 只输出前100行。
+ * 参数1是行数
+ */
+class SortBenchmark : public Fixture
+{
+public:
+  enum Algorithm
+  {
+    VALUE_COMPARE,
+    IN_MEMORY,
+    SPILL,
+    TOP_N,
+  };
+
+  static constexpr int64_t TOP_N_LIMIT = 100;
+
+  void SetUp(const State &state) override
+  {
+    LoggerFactory::init_default("sort_performance.log", LOG_LEVEL_WARN);
+
+    mt19937 random(0);
+    keys_.clear();
+    payloads_.clear();
+    const int row_num = static_cast<int>(state.range(1));
+    for (int i = 0; i < row_num; i++) {
+      string str = "name_" + to_string(random() % 1000);
+      keys_.push_back({Value(static_cast<int>(random() % 1000)), Value(str.c_str())});
+      payloads_.push_back({Value(i), Value(str.c_str())});
+    }
+  }
+
+  /// 原来的排序算子的做法：缓存所有的行，对行号排序，每次比较都逐个比较 Value
+  int64_t sort_by_value_compare()
+  {
+    vector<int> order(keys_.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = static_cast<int>(i);
+    }
+    vector<vector<Value>> rows = payloads_;
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+      const vector<Value> &cells_a = keys_[a];
+      const vector<Value> &cells_b = keys_[b];
+      for (size_t i = 0; i < cells_a.size(); i++) {
+        const int result = cells_a[i].compare(cells_b[i]);
+        if (result != 0) {
+          return result < 0;
+        }
+      }
+      return false;
+    });
+
+    int64_t sum = 0;
+    for (int index : order) {
+      sum += rows[index][0].get_int();
+    }
+    DoNotOptimize(sum);
+    return static_cast<int64_t>(order.size());
+  }
+
+  int64_t sort_by_sorter(int algorithm)
+  {
+    SortOptions options;
+    if (algorithm == SPILL) {
+      options.memory = SortOptions::MIN_MEMORY;
+    }
+    ExternalSorter sorter({true, true}, options, algorithm == TOP_N ? TOP_N_LIMIT : -1);
+    for (size_t i = 0; i < keys_.size(); i++) {
+      if (OB_FAIL(sorter.add(keys_[i], payloads_[i]))) {
+        throw runtime_error("failed to add row to sorter");
+      }
+    }
+    if (OB_FAIL(sorter.finish())) {
+      throw runtime_error("failed to sort");
+    }
+
+    int64_t       rows = 0;
+    vector<Value> payload;
+    while (OB_SUCC(sorter.next(payload))) {
+      rows++;
+    }
+    return rows;
+  }
+
+protected:
+  vector<vector<Value>> keys_;
+  vector<vector<Value>> payloads_;
+};
+
+BENCHMARK_DEFINE_F(SortBenchmark, Sort)(State &state)
+{
+  const int algorithm = static_cast<int>(state.range(0));
+  int64_t   rows      = 0;
+  for (auto _ : state) {
+    rows += algorithm == VALUE_COMPARE ? sort_by_value_compare() : sort_by_sorter(algorithm);
+  }
+  state.counters["rows"] = Counter(rows, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(SortBenchmark, Sort)
+    ->ArgsProduct({{SortBenchmark::VALUE_COMPARE, SortBenchmark::IN_MEMORY, SortBenchmark::SPILL, SortBenchmark::TOP_N},
+        {10000, 100000}})
+    ->Unit(kMillisecond);
+
+BENCHMARK_MAIN();
@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <dirent.h>
+#include <limits.h>
 #include <iostream>
 #include <stdio.h>
 #include <sys/stat.h>
@@ -20,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include <unistd.h>
 
 #include "common/io/io.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/math/regex.h"
@@ -367,6 +369,33 @@ int writen(int fd, const void *buf, int size)
   return 0;
 }
 
+int writevn(int fd, struct iovec *iov, int iovcnt)
+{
+  const int max_iovcnt = IOV_MAX;
+  while (iovcnt > 0) {
+    const ssize_t ret = ::writev(fd, iov, min(iovcnt, max_iovcnt));
+    if (ret < 0) {
+      const int err = errno;
+      if (EAGAIN != err && EINTR != err)
+        return err;
+      continue;
+    }
+
+    // 跳过已经写完的数据段，并调整写了一部分的数据段
+    size_t written = static_cast<size_t>(ret);
+    while (iovcnt > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+  return 0;
+}
+
 int readn(int fd, void *buf, int size)
 {
   char *tmp = (char *)buf;
@@ -386,4 +415,43 @@ int readn(int fd, void *buf, int size)
   }
   return 0;
 }
+
+int pwriten(int fd, const void *buf, int64_t size, int64_t offset)
+{
+  const char *tmp = (const char *)buf;
+  while (size > 0) {
+    const ssize_t ret = ::pwrite(fd, tmp, size, offset);
+    if (ret >= 0) {
+      tmp += ret;
+      size -= ret;
+      offset += ret;
+      continue;
+    }
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
+
+int preadn(int fd, void *buf, int64_t size, int64_t offset)
+{
+  char *tmp = (char *)buf;
+  while (size > 0) {
+    const ssize_t ret = ::pread(fd, tmp, size, offset);
+    if (ret > 0) {
+      tmp += ret;
+      size -= ret;
+      offset += ret;
+      continue;
+    }
+    if (0 == ret)
+      return -1;  // end of file
+
+    const int err = errno;
+    if (EAGAIN != err && EINTR != err)
+      return err;
+  }
+  return 0;
+}
 }  // namespace common
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <vector>
+#include <sys/uio.h>
 
 #include "common/defs.h"
 #include "common/lang/string.h"
@@ -67,6 +68,17 @@ int getFileSize(const char *filePath, uint64_t &fileLen);
  */
 int writen(int fd, const void *buf, int size);
 
+/**
+ * @brief 使用writev一次性写入多段数据
+ * @details 会处理部分写入的情况，直到所有数据都写完或者出现错误。
+ * 调用结束后，iov 数组中的内容可能会被修改
+ * @param fd  写入的描述符
+ * @param iov 数据段
+ * @param iovcnt 数据段的个数
+ * @return int 0 表示成功，否则返回errno
+ */
+int writevn(int fd, struct iovec *iov, int iovcnt);
+
 /**
  * @brief 一次性读取指定长度的数据
  *
@@ -77,4 +89,26 @@ int writen(int fd, const void *buf, int size);
  */
 int readn(int fd, void *buf, int size);
 
+/**
+ * @brief 从指定位置一次性写入所有数据
+ * @details 使用pwrite，不依赖也不修改文件描述符的偏移量，多个线程可以同时使用同一个描述符
+ * @param fd  写入的描述符
+ * @param buf 写入的数据
+ * @param size 写入多少数据
+ * @param offset 写入的位置
+ * @return int 0 表示成功，否则返回errno
+ */
+int pwriten(int fd, const void *buf, int64_t size, int64_t offset);
+
+/**
+ * @brief 从指定位置一次性读取指定长度的数据
+ * @details 使用pread，不依赖也不修改文件描述符的偏移量，多个线程可以同时使用同一个描述符
+ * @param fd  读取的描述符
+ * @param buf 读取到这里
+ * @param size 读取的数据长度
+ * @param offset 读取的位置
+ * @return int 返回0表示成功。-1 表示读取到文件尾，并且没有读到size大小数据，其它表示errno
+ */
+int preadn(int fd, void *buf, int64_t size, int64_t offset);
+
 }  // namespace common
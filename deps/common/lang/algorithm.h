@@ -14,4 +14,6 @@ See the Mulan PSL v2 for more details. */
 
 using std::max;
 using std::min;
-using std::transform;
\ No newline at end of file
+using std::transform;
+using std::clamp;
+using std::sort;
\ No newline at end of file
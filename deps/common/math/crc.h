@@ -16,3 +16,10 @@ See the Mulan PSL v2 for more details. */
 
 /// 计算buffer的crc校验码
 unsigned int crc32(const char *buffer, unsigned int size);
+
+/**
+ * @brief 在上一次计算结果的基础上继续计算crc校验码
+ * @details 可以把不连续的几段数据合起来计算一个校验码。
+ * crc32(crc32(a, n), b, m) 与把 a、b 拼接起来之后计算 crc32 的结果相同。
+ */
+unsigned int crc32(unsigned int crc, const char *buffer, unsigned int size);
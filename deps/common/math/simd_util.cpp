@@ -11,18 +11,41 @@ See the Mulan PSL v2 for more details. */
 #include <stdint.h>
 #include "common/math/simd_util.h"
 
+namespace {
+
+bool cpu_support_avx2()
+{
 #if defined(USE_SIMD)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
 
-int mm256_extract_epi32_var_indx(const __m256i vec, const unsigned int i)
+bool &simd_switch()
 {
-  __m128i idx = _mm_cvtsi32_si128(i);
-  __m256i val = _mm256_permutevar8x32_epi32(vec, _mm256_castsi128_si256(idx));
-  return _mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+  static bool enabled = cpu_support_avx2();
+  return enabled;
+}
+
+}  // namespace
+
+bool simd_enabled() { return simd_switch(); }
+
+bool set_simd_enabled(bool enabled)
+{
+  simd_switch() = enabled && cpu_support_avx2();
+  return simd_switch();
 }
 
 int mm256_sum_epi32(const int *values, int size)
 {
-  // your code here
+#if defined(USE_SIMD)
+  if (simd_enabled()) {
+    return mm256_sum_epi32_avx2(values, size);
+  }
+#endif
   int sum = 0;
   for (int i = 0; i < size; i++) {
     sum += values[i];
@@ -32,7 +55,11 @@ int mm256_sum_epi32(const int *values, int size)
 
 float mm256_sum_ps(const float *values, int size)
 {
-  // your code here
+#if defined(USE_SIMD)
+  if (simd_enabled()) {
+    return mm256_sum_ps_avx2(values, size);
+  }
+#endif
   float sum = 0;
   for (int i = 0; i < size; i++) {
     sum += values[i];
@@ -40,18 +67,105 @@ float mm256_sum_ps(const float *values, int size)
   return sum;
 }
 
-template <typename V>
-void selective_load(V *memory, int offset, V *vec, __m256i &inv)
+#if defined(USE_SIMD)
+
+int mm256_extract_epi32_var_indx(const __m256i vec, const unsigned int i)
+{
+  __m128i idx = _mm_cvtsi32_si128(i);
+  __m256i val = _mm256_permutevar8x32_epi32(vec, _mm256_castsi128_si256(idx));
+  return _mm_cvtsi128_si32(_mm256_castsi256_si128(val));
+}
+
+int mm256_sum_epi32_avx2(const int *values, int size)
 {
-  int *inv_ptr = reinterpret_cast<int *>(&inv);
-  for (int i = 0; i < SIMD_WIDTH; i++) {
-    if (inv_ptr[i] == -1) {
-      vec[i] = memory[offset++];
+  // 两个累加器，减少相邻两次加法之间的依赖
+  __m256i sum0 = _mm256_setzero_si256();
+  __m256i sum1 = _mm256_setzero_si256();
+  int     i    = 0;
+  for (; i + 2 * SIMD_WIDTH <= size; i += 2 * SIMD_WIDTH) {
+    sum0 = _mm256_add_epi32(sum0, _mm256_loadu_si256((const __m256i *)&values[i]));
+    sum1 = _mm256_add_epi32(sum1, _mm256_loadu_si256((const __m256i *)&values[i + SIMD_WIDTH]));
+  }
+  if (i + SIMD_WIDTH <= size) {
+    sum0 = _mm256_add_epi32(sum0, _mm256_loadu_si256((const __m256i *)&values[i]));
+    i += SIMD_WIDTH;
+  }
+  sum0 = _mm256_add_epi32(sum0, sum1);
+
+  __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum0), _mm256_extracti128_si256(sum0, 1));
+  sum128         = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum128         = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+  int sum        = _mm_cvtsi128_si32(sum128);
+  for (; i < size; i++) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+float mm256_sum_ps_avx2(const float *values, int size)
+{
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  int    i    = 0;
+  for (; i + 2 * SIMD_WIDTH <= size; i += 2 * SIMD_WIDTH) {
+    sum0 = _mm256_add_ps(sum0, _mm256_loadu_ps(&values[i]));
+    sum1 = _mm256_add_ps(sum1, _mm256_loadu_ps(&values[i + SIMD_WIDTH]));
+  }
+  if (i + SIMD_WIDTH <= size) {
+    sum0 = _mm256_add_ps(sum0, _mm256_loadu_ps(&values[i]));
+    i += SIMD_WIDTH;
+  }
+  sum0 = _mm256_add_ps(sum0, sum1);
+
+  __m128 sum128 = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+  sum128        = _mm_add_ps(sum128, _mm_movehl_ps(sum128, sum128));
+  sum128        = _mm_add_ss(sum128, _mm_shuffle_ps(sum128, sum128, 1));
+  float sum     = _mm_cvtss_f32(sum128);
+  for (; i < size; i++) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+namespace {
+
+/// 掩码的每一位表示一个通道是否需要读取新的值，表中是每个需要读取的通道读取的是第几个新的值，也就是前面有几个通道需要读取
+struct ExpandIndexTable
+{
+  ExpandIndexTable()
+  {
+    for (int mask = 0; mask < 256; mask++) {
+      int count = 0;
+      for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+        index[mask][lane] = count;
+        if (mask & (1 << lane)) {
+          count++;
+        }
+      }
     }
   }
+
+  alignas(32) int32_t index[256][SIMD_WIDTH];
+};
+
+const ExpandIndexTable EXPAND_INDEX;
+
+}  // namespace
+
+template <typename V>
+void selective_load(V *memory, int offset, V *vec, __m256i &inv)
+{
+  static_assert(sizeof(V) == sizeof(int32_t), "selective_load only supports 4 bytes types");
+
+  const int     mask     = _mm256_movemask_ps(_mm256_castsi256_ps(inv));
+  const __m256i loaded   = _mm256_loadu_si256((const __m256i *)(memory + offset));
+  const __m256i index    = _mm256_load_si256((const __m256i *)EXPAND_INDEX.index[mask]);
+  const __m256i expanded = _mm256_permutevar8x32_epi32(loaded, index);
+  const __m256i old      = _mm256_loadu_si256((const __m256i *)vec);
+  _mm256_storeu_si256((__m256i *)vec, _mm256_blendv_epi8(old, expanded, inv));
 }
 template void selective_load<uint32_t>(uint32_t *memory, int offset, uint32_t *vec, __m256i &inv);
 template void selective_load<int>(int *memory, int offset, int *vec, __m256i &inv);
 template void selective_load<float>(float *memory, int offset, float *vec, __m256i &inv);
 
-#endif
\ No newline at end of file
+#endif
@@ -10,19 +10,40 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+//
+// 打开 USE_SIMD 时编译 AVX2 的实现。AVX2 的函数使用 SIMD_AVX2 单独指定目标指令集，不使用 -mavx2 编译整个程序，
+// 运行时根据 simd_enabled() 选择 AVX2 或者标量的实现，所以同一个程序在不支持 AVX2 的机器上也可以运行。
+//
+
+/// @brief 是否使用 AVX2 的实现：编译时打开了 USE_SIMD，并且 CPU 支持 AVX2
+bool simd_enabled();
+
+/// @brief 打开或关闭 AVX2 的实现，用于测试和性能对比。不支持时不能打开，返回设置之后的 simd_enabled()
+bool set_simd_enabled(bool enabled);
+
+/// @brief 数组求和，根据 simd_enabled() 选择实现
+int   mm256_sum_epi32(const int *values, int size);
+float mm256_sum_ps(const float *values, int size);
+
 #if defined(USE_SIMD)
 #include <immintrin.h>
 
+#define SIMD_AVX2 __attribute__((target("avx2")))
+
 static constexpr int SIMD_WIDTH = 8;  // AVX2 (256bit)
 
 /// @brief 从 vec 中提取下标为 i 的 int 类型的值。
-int mm256_extract_epi32_var_indx(const __m256i vec, const unsigned int i);
+SIMD_AVX2 int mm256_extract_epi32_var_indx(const __m256i vec, const unsigned int i);
 
-/// @brief 数组求和
-int   mm256_sum_epi32(const int *values, int size);
-float mm256_sum_ps(const float *values, int size);
+/// @brief 数组求和的 AVX2 实现，调用前需要确认 simd_enabled()
+SIMD_AVX2 int   mm256_sum_epi32_avx2(const int *values, int size);
+SIMD_AVX2 float mm256_sum_ps_avx2(const float *values, int size);
 
-/// @brief selective load 的标量实现
+/**
+ * @brief selective load: inv 中等于 -1 的通道按顺序依次读取 memory[offset], memory[offset + 1]...，其它通道保持不变
+ * @details 使用一次非对齐的加载读出 SIMD_WIDTH 个值，再按照 inv 的掩码查表得到每个通道的下标，重排之后与原来的值混合。
+ * 调用者需要保证 memory[offset, offset + SIMD_WIDTH) 都可以读取。V 必须是4字节的类型。
+ */
 template <typename V>
-void selective_load(V *memory, int offset, V *vec, __m256i &inv);
-#endif
\ No newline at end of file
+SIMD_AVX2 void selective_load(V *memory, int offset, V *vec, __m256i &inv);
+#endif
@@ -48,7 +48,18 @@ enum class StorageFormat
 {
   UNKNOWN_FORMAT = 0,
   ROW_FORMAT,
-  PAX_FORMAT
+  PAX_FORMAT,
+  CLUSTERED_FORMAT,  ///< 记录按照主键顺序存放在B+树的叶子节点中，参考 ClusteredRecordHandler
+};
+
+/**
+ * @brief 索引类型
+ * @details B+树索引支持等值和范围查找，哈希索引只支持所有字段都是等值条件的查找。
+ */
+enum class IndexType
+{
+  BPLUS_TREE = 0,
+  HASH
 };
 
 /**
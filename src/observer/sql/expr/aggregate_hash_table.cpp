@@ -9,238 +9,853 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "sql/expr/aggregate_hash_table.h"
+#include "common/lang/algorithm.h"
+
+#include <cstring>
 
 // ----------------------------------StandardAggregateHashTable------------------
 
-RC StandardAggregateHashTable::add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk)
+namespace {
+
+/// murmur3 的 fmix64
+inline uint64_t mix_hash(uint64_t h)
 {
-  // your code here
-  exit(-1);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
 }
 
-void StandardAggregateHashTable::Scanner::open_scan()
+/// 每次处理8个字节，最后再混合一次
+uint64_t hash_bytes(const char *data, size_t len)
 {
-  it_  = static_cast<StandardAggregateHashTable *>(hash_table_)->begin();
-  end_ = static_cast<StandardAggregateHashTable *>(hash_table_)->end();
+  uint64_t h = len * 0x9e3779b97f4a7c15ULL;
+  size_t   i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    h = (h ^ mix_hash(word)) * 0x9e3779b97f4a7c15ULL;
+  }
+  if (i < len) {
+    uint64_t word = 0;
+    memcpy(&word, data + i, len - i);
+    h = (h ^ mix_hash(word)) * 0x9e3779b97f4a7c15ULL;
+  }
+  return mix_hash(h);
 }
 
-RC StandardAggregateHashTable::Scanner::next(Chunk &output_chunk)
+/// 规整之后的一个分组字段的哈希值
+inline uint64_t hash_key(AttrType type, const char *data, int len)
 {
-  if (it_ == end_) {
-    return RC::RECORD_EOF;
+  switch (type) {
+    case AttrType::CHARS: return hash_bytes(data, strnlen(data, len));
+    case AttrType::INTS:
+    case AttrType::DATES:
+    case AttrType::FLOATS: {
+      uint32_t value;
+      memcpy(&value, data, sizeof(value));
+      return mix_hash(value);
+    }
+    case AttrType::LONGS:
+    case AttrType::DOUBLES: {
+      uint64_t value;
+      memcpy(&value, data, sizeof(value));
+      return mix_hash(value);
+    }
+    default: return hash_bytes(data, len);
   }
-  while (it_ != end_ && output_chunk.rows() <= output_chunk.capacity()) {
-    auto &group_by_values = it_->first;
-    auto &aggrs           = it_->second;
-    for (int i = 0; i < output_chunk.column_num(); i++) {
-      auto col_idx = output_chunk.column_ids(i);
-      if (col_idx >= static_cast<int>(group_by_values.size())) {
-        output_chunk.column(i).append_one((char *)aggrs[col_idx - group_by_values.size()].data());
-      } else {
-        output_chunk.column(i).append_one((char *)group_by_values[col_idx].data());
+}
+
+/// 把一个分组字段规整之后写到 dst 中，相等的值写出来的字节也相同
+inline void normalize_key(AttrType type, const char *src, int len, char *dst)
+{
+  switch (type) {
+    case AttrType::CHARS: {
+      const size_t str_len = strnlen(src, len);
+      memcpy(dst, src, str_len);
+      memset(dst + str_len, 0, len - str_len);
+    } break;
+    case AttrType::FLOATS: {
+      float value;
+      memcpy(&value, src, sizeof(value));
+      if (value == 0) {
+        value = 0;
       }
+      memcpy(dst, &value, sizeof(value));
+    } break;
+    case AttrType::DOUBLES: {
+      double value;
+      memcpy(&value, src, sizeof(value));
+      if (value == 0) {
+        value = 0;
+      }
+      memcpy(dst, &value, sizeof(value));
+    } break;
+    default: memcpy(dst, src, len); break;
+  }
+}
+
+/// 按照列的类型读取一个数值
+template <typename T>
+inline T read_number(const Column &column, int index)
+{
+  const char *data = column.data() + static_cast<size_t>(index) * column.attr_len();
+  switch (column.attr_type()) {
+    case AttrType::FLOATS: {
+      float value;
+      memcpy(&value, data, sizeof(value));
+      return static_cast<T>(value);
+    }
+    case AttrType::DOUBLES: {
+      double value;
+      memcpy(&value, data, sizeof(value));
+      return static_cast<T>(value);
+    }
+    case AttrType::LONGS: {
+      int64_t value;
+      memcpy(&value, data, sizeof(value));
+      return static_cast<T>(value);
+    }
+    case AttrType::BOOLEANS: return static_cast<T>(data[0] != 0);
+    default: {
+      int32_t value;
+      memcpy(&value, data, sizeof(value));
+      return static_cast<T>(value);
     }
-    it_++;
   }
-  if (it_ == end_) {
-    return RC::SUCCESS;
+}
+
+bool is_number_type(AttrType type)
+{
+  switch (type) {
+    case AttrType::INTS:
+    case AttrType::FLOATS:
+    case AttrType::DOUBLES:
+    case AttrType::LONGS:
+    case AttrType::BOOLEANS: return true;
+    default: return false;
   }
+}
 
-  return RC::SUCCESS;
+/// 按照输出列的类型写一个数值
+RC append_number(Column &column, bool is_float, int64_t int_value, double double_value)
+{
+  switch (column.attr_type()) {
+    case AttrType::INTS: {
+      int32_t value = is_float ? static_cast<int32_t>(double_value) : static_cast<int32_t>(int_value);
+      return column.append_one(reinterpret_cast<char *>(&value));
+    }
+    case AttrType::LONGS: {
+      int64_t value = is_float ? static_cast<int64_t>(double_value) : int_value;
+      return column.append_one(reinterpret_cast<char *>(&value));
+    }
+    case AttrType::FLOATS: {
+      float value = is_float ? static_cast<float>(double_value) : static_cast<float>(int_value);
+      return column.append_one(reinterpret_cast<char *>(&value));
+    }
+    case AttrType::DOUBLES: {
+      double value = is_float ? double_value : static_cast<double>(int_value);
+      return column.append_one(reinterpret_cast<char *>(&value));
+    }
+    default: {
+      LOG_WARN("unsupported aggregate output type: %s", attr_type_to_string(column.attr_type()));
+      return RC::INVALID_ARGUMENT;
+    }
+  }
 }
 
-size_t StandardAggregateHashTable::VectorHash::operator()(const vector<Value> &vec) const
+/// 检查聚合函数的参数类型，COUNT 之外的参数必须是数值类型
+RC check_aggregate_arguments(
+    const std::vector<AggrFuncType> &aggr_types, Chunk &aggrs_chunk, std::vector<bool> &is_float)
 {
-  size_t hash = 0;
-  for (const auto &elem : vec) {
-    hash ^= std::hash<string>()(elem.to_string());
+  for (int i = 0; i < aggrs_chunk.column_num(); i++) {
+    const AttrType attr_type = aggrs_chunk.column(i).attr_type();
+    if (aggr_types[i] != AggrFuncType::COUNT && !is_number_type(attr_type)) {
+      LOG_WARN("unsupported aggregate argument type: %s", attr_type_to_string(attr_type));
+      return RC::INVALID_ARGUMENT;
+    }
+    is_float.push_back(attr_type == AttrType::FLOATS || attr_type == AttrType::DOUBLES);
   }
-  return hash;
+  return RC::SUCCESS;
 }
 
-bool StandardAggregateHashTable::VectorEqual::operator()(const vector<Value> &lhs, const vector<Value> &rhs) const
+/**
+ * @brief 使用一列数据更新一个聚合函数的状态
+ * @param state_of state_of(r) 返回第r行所在的分组的状态
+ */
+template <typename StateOf>
+RC update_aggregate_states(AggrFuncType aggr_type, bool is_float, const Column &column, int rows, StateOf &&state_of)
 {
-  if (lhs.size() != rhs.size()) {
-    return false;
+  const bool constant = column.column_type() == Column::Type::CONSTANT_COLUMN;
+
+  // 先按照聚合函数和参数类型分开，内层循环中不再判断
+  auto for_each_row = [&](auto &&update) {
+    for (int r = 0; r < rows; r++) {
+      update(state_of(r), constant ? 0 : r);
+    }
+  };
+
+  switch (aggr_type) {
+    case AggrFuncType::COUNT: {
+      for_each_row([](HashAggregateState &state, int) { state.count++; });
+    } break;
+    case AggrFuncType::SUM:
+    case AggrFuncType::AVG: {
+      if (is_float) {
+        for_each_row([&column](HashAggregateState &state, int r) {
+          state.double_value += read_number<double>(column, r);
+          state.count++;
+        });
+      } else {
+        for_each_row([&column](HashAggregateState &state, int r) {
+          state.int_value += read_number<int64_t>(column, r);
+          state.count++;
+        });
+      }
+    } break;
+    case AggrFuncType::MIN:
+    case AggrFuncType::MAX: {
+      const bool is_min = aggr_type == AggrFuncType::MIN;
+      if (is_float) {
+        for_each_row([&column, is_min](HashAggregateState &state, int r) {
+          const double value = read_number<double>(column, r);
+          if (state.count++ == 0 || (is_min ? value < state.double_value : value > state.double_value)) {
+            state.double_value = value;
+          }
+        });
+      } else {
+        for_each_row([&column, is_min](HashAggregateState &state, int r) {
+          const int64_t value = read_number<int64_t>(column, r);
+          if (state.count++ == 0 || (is_min ? value < state.int_value : value > state.int_value)) {
+            state.int_value = value;
+          }
+        });
+      }
+    } break;
+    default: {
+      LOG_WARN("unsupported aggregate type: %d", aggr_type);
+      return RC::INVALID_ARGUMENT;
+    }
   }
-  for (size_t i = 0; i < lhs.size(); ++i) {
-    if (rhs[i].compare(lhs[i]) != 0) {
-      return false;
+  return RC::SUCCESS;
+}
+
+/// 按照输出列的类型写一个聚合函数的结果
+RC write_aggregate_state(AggrFuncType aggr_type, bool is_float, const HashAggregateState &aggr_state, Column &column)
+{
+  switch (aggr_type) {
+    case AggrFuncType::COUNT: return append_number(column, false, aggr_state.count, 0);
+    case AggrFuncType::AVG: {
+      const double sum = is_float ? aggr_state.double_value : static_cast<double>(aggr_state.int_value);
+      return append_number(column, true, 0, aggr_state.count == 0 ? 0 : sum / aggr_state.count);
     }
+    default: return append_number(column, is_float, aggr_state.int_value, aggr_state.double_value);
   }
-  return true;
 }
 
-// ----------------------------------LinearProbingAggregateHashTable------------------
-#ifdef USE_SIMD
-template <typename V>
-RC LinearProbingAggregateHashTable<V>::add_chunk(Chunk &group_chunk, Chunk &aggr_chunk)
+}  // namespace
+
+RC StandardAggregateHashTable::init_layout(Chunk &groups_chunk, Chunk &aggrs_chunk)
+{
+  key_width_ = 0;
+  for (int i = 0; i < groups_chunk.column_num(); i++) {
+    const Column &column = groups_chunk.column(i);
+    group_types_.push_back(column.attr_type());
+    group_lens_.push_back(column.attr_len());
+    group_offsets_.push_back(key_width_);
+    key_width_ += column.attr_len();
+  }
+
+  RC rc = check_aggregate_arguments(aggr_types_, aggrs_chunk, aggr_is_float_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  constexpr int align = alignof(HashAggregateState);
+  states_offset_      = (key_width_ + align - 1) / align * align;
+  row_width_          = states_offset_ + static_cast<int>(sizeof(HashAggregateState) * aggr_types_.size());
+  row_width_     = std::max(row_width_, 1);
+
+  slots_.assign(DEFAULT_CAPACITY, Slot{0, EMPTY_ROW});
+  mask_        = DEFAULT_CAPACITY - 1;
+  initialized_ = true;
+  return RC::SUCCESS;
+}
+
+RC StandardAggregateHashTable::add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk)
 {
-  if (group_chunk.column_num() != 1 || aggr_chunk.column_num() != 1) {
-    LOG_WARN("group_chunk and aggr_chunk size must be 1.");
+  if (aggrs_chunk.column_num() != static_cast<int>(aggr_types_.size())) {
+    LOG_WARN("aggregate column number mismatch. expect=%d, actual=%d", static_cast<int>(aggr_types_.size()), aggrs_chunk.column_num());
     return RC::INVALID_ARGUMENT;
   }
-  if (group_chunk.rows() != aggr_chunk.rows()) {
-    LOG_WARN("group_chunk and aggr _chunk rows must be equal.");
+  const int rows = groups_chunk.column_num() > 0 ? groups_chunk.rows() : aggrs_chunk.rows();
+  if (aggrs_chunk.column_num() > 0 && aggrs_chunk.rows() != rows) {
+    LOG_WARN("group_chunk and aggr_chunk rows must be equal.");
     return RC::INVALID_ARGUMENT;
   }
-  add_batch((int *)group_chunk.column(0).data(), (V *)aggr_chunk.column(0).data(), group_chunk.rows());
-  return RC::SUCCESS;
+
+  RC rc = RC::SUCCESS;
+  if (!initialized_) {
+    rc = init_layout(groups_chunk, aggrs_chunk);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  if (groups_chunk.column_num() != static_cast<int>(group_types_.size())) {
+    LOG_WARN("group column number mismatch. expect=%d, actual=%d", static_cast<int>(group_types_.size()), groups_chunk.column_num());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 1. 按列计算键值和哈希值
+  hashes_.assign(rows, 0);
+  keys_.resize(static_cast<size_t>(rows) * key_width_);
+  for (int i = 0; i < groups_chunk.column_num(); i++) {
+    const Column &column = groups_chunk.column(i);
+    if (column.attr_type() != group_types_[i] || column.attr_len() != group_lens_[i]) {
+      LOG_WARN("group column type mismatch. column=%d", i);
+      return RC::INVALID_ARGUMENT;
+    }
+    add_key_column(column, i, rows);
+  }
+
+  // 2. 逐行探测，提前预取后面的行要访问的槽
+  rows_.resize(rows);
+  for (int r = 0; r < rows; r++) {
+    if (r + PREFETCH_DISTANCE < rows) {
+      __builtin_prefetch(&slots_[hashes_[r + PREFETCH_DISTANCE] & mask_]);
+    }
+    rows_[r] = find_or_insert(hashes_[r], keys_.data() + static_cast<size_t>(r) * key_width_);
+  }
+
+  // 3. 按列更新聚合状态
+  for (int i = 0; i < aggrs_chunk.column_num(); i++) {
+    rc = update_states(aggrs_chunk.column(i), i, rows);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return rc;
 }
 
-template <typename V>
-void LinearProbingAggregateHashTable<V>::Scanner::open_scan()
+void StandardAggregateHashTable::add_key_column(const Column &column, int group_index, int rows)
 {
-  capacity_   = static_cast<LinearProbingAggregateHashTable *>(hash_table_)->capacity();
-  size_       = static_cast<LinearProbingAggregateHashTable *>(hash_table_)->size();
-  scan_pos_   = 0;
-  scan_count_ = 0;
+  const AttrType type     = group_types_[group_index];
+  const int      len      = group_lens_[group_index];
+  const int      offset   = group_offsets_[group_index];
+  const bool     constant = column.column_type() == Column::Type::CONSTANT_COLUMN;
+  for (int r = 0; r < rows; r++) {
+    const char *src = column.data() + (constant ? 0 : static_cast<size_t>(r) * len);
+    char       *dst = keys_.data() + static_cast<size_t>(r) * key_width_ + offset;
+    normalize_key(type, src, len, dst);
+    hashes_[r] = (hashes_[r] ^ hash_key(type, dst, len)) * 0x9e3779b97f4a7c15ULL;
+  }
 }
 
-template <typename V>
-RC LinearProbingAggregateHashTable<V>::Scanner::next(Chunk &output_chunk)
+uint32_t StandardAggregateHashTable::find_or_insert(uint64_t hash, const char *key)
 {
-  if (scan_pos_ >= capacity_ || scan_count_ >= size_) {
-    return RC::RECORD_EOF;
+  const uint32_t hash32 = static_cast<uint32_t>(hash);
+  for (uint32_t index = hash32 & mask_;; index = (index + 1) & mask_) {
+    Slot &slot = slots_[index];
+    if (slot.row == EMPTY_ROW) {
+      if (static_cast<size_t>(size_ + 1) * 2 > slots_.size()) {
+        resize();
+        return find_or_insert(hash, key);
+      }
+
+      const uint32_t row = static_cast<uint32_t>(size_++);
+      arena_.resize(arena_.size() + row_width_);  // 新的行全部是0，也就是聚合状态的初始值
+      memcpy(row_data(row), key, key_width_);
+      slot.hash = hash32;
+      slot.row  = row;
+      return row;
+    }
+    if (slot.hash == hash32 && 0 == memcmp(row_data(slot.row), key, key_width_)) {
+      return slot.row;
+    }
   }
-  auto linear_probing_hash_table = static_cast<LinearProbingAggregateHashTable *>(hash_table_);
-  while (scan_pos_ < capacity_ && scan_count_ < size_ && output_chunk.rows() <= output_chunk.capacity()) {
-    int key;
-    V   value;
-    RC  rc = linear_probing_hash_table->iter_get(scan_pos_, key, value);
-    if (rc == RC::SUCCESS) {
-      output_chunk.column(0).append_one((char *)&key);
-      output_chunk.column(1).append_one((char *)&value);
-      scan_count_++;
+}
+
+void StandardAggregateHashTable::resize()
+{
+  std::vector<Slot> old_slots = std::move(slots_);
+  slots_.assign(old_slots.size() * 2, Slot{0, EMPTY_ROW});
+  mask_ = static_cast<uint32_t>(slots_.size() - 1);
+  for (const Slot &old_slot : old_slots) {
+    if (old_slot.row == EMPTY_ROW) {
+      continue;
     }
-    scan_pos_++;
+    uint32_t index = old_slot.hash & mask_;
+    while (slots_[index].row != EMPTY_ROW) {
+      index = (index + 1) & mask_;
+    }
+    slots_[index] = old_slot;
   }
-  return RC::SUCCESS;
 }
 
-template <typename V>
-void LinearProbingAggregateHashTable<V>::Scanner::close_scan()
+RC StandardAggregateHashTable::update_states(const Column &column, int aggr_index, int rows)
 {
-  capacity_   = -1;
-  size_       = -1;
-  scan_pos_   = -1;
-  scan_count_ = 0;
+  return update_aggregate_states(aggr_types_[aggr_index], aggr_is_float_[aggr_index], column, rows,
+      [this, aggr_index](int r) -> HashAggregateState & { return *state(row_data(rows_[r]), aggr_index); });
 }
 
-template <typename V>
-RC LinearProbingAggregateHashTable<V>::get(int key, V &value)
+RC StandardAggregateHashTable::write_group(uint32_t row, int group_index, Column &column) const
 {
-  RC  rc          = RC::SUCCESS;
-  int index       = (key % capacity_ + capacity_) % capacity_;
-  int iterate_cnt = 0;
-  while (true) {
-    if (keys_[index] == EMPTY_KEY) {
-      rc = RC::NOT_EXIST;
-      break;
-    } else if (keys_[index] == key) {
-      value = values_[index];
-      break;
-    } else {
-      index += 1;
-      index %= capacity_;
-      iterate_cnt++;
-      if (iterate_cnt > capacity_) {
-        rc = RC::NOT_EXIST;
-        break;
+  const char *key = row_data(row) + group_offsets_[group_index];
+  const int   len = group_lens_[group_index];
+  if (column.attr_len() == len) {
+    return column.append_one(const_cast<char *>(key));
+  }
+
+  std::vector<char> buffer(column.attr_len(), 0);
+  memcpy(buffer.data(), key, std::min(len, column.attr_len()));
+  return column.append_one(buffer.data());
+}
+
+RC StandardAggregateHashTable::write_aggregate(uint32_t row, int aggr_index, Column &column) const
+{
+  if (aggr_index < 0 || aggr_index >= static_cast<int>(aggr_types_.size())) {
+    LOG_WARN("invalid aggregate index: %d", aggr_index);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  return write_aggregate_state(
+      aggr_types_[aggr_index], aggr_is_float_[aggr_index], *state(row_data(row), aggr_index), column);
+}
+
+void StandardAggregateHashTable::Scanner::open_scan() { pos_ = 0; }
+
+RC StandardAggregateHashTable::Scanner::next(Chunk &output_chunk)
+{
+  auto *hash_table = static_cast<StandardAggregateHashTable *>(hash_table_);
+  if (pos_ >= hash_table->size_) {
+    return RC::RECORD_EOF;
+  }
+
+  const int group_num = static_cast<int>(hash_table->group_types_.size());
+  RC        rc        = RC::SUCCESS;
+  while (pos_ < hash_table->size_ && output_chunk.rows() < output_chunk.capacity()) {
+    const uint32_t row = static_cast<uint32_t>(pos_++);
+    for (int i = 0; i < output_chunk.column_num() && OB_SUCC(rc); i++) {
+      const int col_idx = output_chunk.column_ids(i);
+      if (col_idx >= group_num) {
+        rc = hash_table->write_aggregate(row, col_idx - group_num, output_chunk.column(i));
+      } else {
+        rc = hash_table->write_group(row, col_idx, output_chunk.column(i));
       }
     }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to write aggregate result. rc=%s", strrc(rc));
+      return rc;
+    }
   }
-  return rc;
+  return RC::SUCCESS;
 }
 
-template <typename V>
-RC LinearProbingAggregateHashTable<V>::iter_get(int pos, int &key, V &value)
+// ----------------------------------LinearProbingAggregateHashTable------------------
+template <typename K>
+LinearProbingAggregateHashTable<K>::LinearProbingAggregateHashTable(
+    const std::vector<Expression *> aggregations, int capacity)
 {
+  for (auto &expr : aggregations) {
+    ASSERT(expr->type() == ExprType::AGGREGATION, "expect aggregate expression");
+    auto *aggregation_expr = static_cast<AggregateExpr *>(expr);
+    aggr_types_.push_back(aggregation_expr->aggregate_type());
+  }
+
+  capacity_ = MIN_CAPACITY;
+  while (capacity_ < capacity) {
+    capacity_ *= 2;
+  }
+  keys_.assign(capacity_, EMPTY_KEY);
+  groups_.assign(capacity_, 0);
+  mask_  = static_cast<uint32_t>(capacity_ - 1);
+  shift_ = 32 - __builtin_ctz(capacity_);
+}
+
+template <typename K>
+RC LinearProbingAggregateHashTable<K>::add_chunk(Chunk &group_chunk, Chunk &aggr_chunk)
+{
+  if (group_chunk.column_num() != 1) {
+    LOG_WARN("linear probing hash table only supports one group by column. column num=%d", group_chunk.column_num());
+    return RC::INVALID_ARGUMENT;
+  }
+  const Column &key_column = group_chunk.column(0);
+  const AttrType key_type  = key_column.attr_type();
+  if (key_column.attr_len() != static_cast<int>(sizeof(K)) ||
+      (key_type != AttrType::INTS && key_type != AttrType::DATES && key_type != AttrType::LONGS)) {
+    LOG_WARN("unsupported group by column. type=%s, len=%d", attr_type_to_string(key_type), key_column.attr_len());
+    return RC::INVALID_ARGUMENT;
+  }
+  if (aggr_chunk.column_num() != static_cast<int>(aggr_types_.size())) {
+    LOG_WARN("aggregate column number mismatch. expect=%d, actual=%d",
+        static_cast<int>(aggr_types_.size()), aggr_chunk.column_num());
+    return RC::INVALID_ARGUMENT;
+  }
+  const int rows = group_chunk.rows();
+  if (aggr_chunk.column_num() > 0 && aggr_chunk.rows() != rows) {
+    LOG_WARN("group_chunk and aggr_chunk rows must be equal.");
+    return RC::INVALID_ARGUMENT;
+  }
+
   RC rc = RC::SUCCESS;
-  if (keys_[pos] == LinearProbingAggregateHashTable<V>::EMPTY_KEY) {
-    rc = RC::NOT_EXIST;
+  if (!initialized_) {
+    rc = check_aggregate_arguments(aggr_types_, aggr_chunk, aggr_is_float_);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    initialized_ = true;
+  }
+
+  // 1. 找到每一行所在的分组
+  positions_.resize(rows);
+  const K *keys = reinterpret_cast<const K *>(key_column.data());
+  if (key_column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    std::fill(positions_.begin(), positions_.end(), rows > 0 ? find_or_insert(keys[0]) : 0);
   } else {
-    key   = keys_[pos];
-    value = values_[pos];
+    add_batch(keys, rows);
+  }
+
+  // 2. 按列更新聚合状态
+  for (int i = 0; i < aggr_chunk.column_num(); i++) {
+    rc = update_aggregate_states(aggr_types_[i], aggr_is_float_[i], aggr_chunk.column(i), rows,
+        [this, i](int r) -> HashAggregateState & { return *state(positions_[r], i); });
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
   }
   return rc;
 }
 
-template <typename V>
-void LinearProbingAggregateHashTable<V>::aggregate(V *value, V value_to_aggregate)
+template <typename K>
+void LinearProbingAggregateHashTable<K>::add_batch(const K *input_keys, int len)
 {
-  if (aggregate_type_ == AggregateExpr::Type::SUM) {
-    *value += value_to_aggregate;
+  int i = 0;
+#if defined(USE_SIMD)
+  // AVX2 没有 scatter，插入新的分组是逐个通道处理的，所以上一批中大部分的行都插入了新的分组时，这一批逐行探测
+  const int old_size = size_;
+  if (simd_enabled() && !insert_heavy_) {
+    if (static_cast<int>(row_ids_.size()) < len) {
+      const int filled = static_cast<int>(row_ids_.size());
+      row_ids_.resize(len);
+      for (int r = filled; r < len; r++) {
+        row_ids_[r] = r;
+      }
+    }
+    i = add_batch_avx2(input_keys, len);
+  }
+#endif
+
+  for (; i < len; i++) {
+    if (i + PREFETCH_DISTANCE < len) {
+      __builtin_prefetch(&keys_[slot_of(input_keys[i + PREFETCH_DISTANCE])]);
+    }
+    positions_[i] = find_or_insert(input_keys[i]);
+  }
+
+#if defined(USE_SIMD)
+  insert_heavy_ = (size_ - old_size) * 2 > len;
+#endif
+}
+
+#if defined(USE_SIMD)
+namespace {
+/// 两个 4x64 位的比较结果合并成8位的掩码
+SIMD_AVX2 inline int movemask_epi64(__m256i low, __m256i high)
+{
+  return _mm256_movemask_pd(_mm256_castsi256_pd(low)) | _mm256_movemask_pd(_mm256_castsi256_pd(high)) << 4;
+}
+}  // namespace
+
+template <typename K>
+__m256i LinearProbingAggregateHashTable<K>::fold_avx2(const K *keys) const
+{
+  if constexpr (sizeof(K) == sizeof(int32_t)) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys));
   } else {
-    ASSERT(false, "unsupported aggregate type");
+    const __m256i low_dwords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    const __m256i keys_low   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys));
+    const __m256i keys_high  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + SIMD_WIDTH / 2));
+    const __m256i fold_low   = _mm256_xor_si256(keys_low, _mm256_srli_epi64(keys_low, 32));
+    const __m256i fold_high  = _mm256_xor_si256(keys_high, _mm256_srli_epi64(keys_high, 32));
+    return _mm256_blend_epi32(_mm256_permutevar8x32_epi32(fold_low, low_dwords),
+        _mm256_permutevar8x32_epi32(fold_high, low_dwords), 0xF0);
   }
 }
 
-template <typename V>
-void LinearProbingAggregateHashTable<V>::resize()
+template <typename K>
+__m256i LinearProbingAggregateHashTable<K>::hash_avx2(__m256i folded) const
 {
-  capacity_ *= 2;
-  std::vector<int> new_keys(capacity_);
-  std::vector<V>   new_values(capacity_);
-
-  for (size_t i = 0; i < keys_.size(); i++) {
-    auto &key   = keys_[i];
-    auto &value = values_[i];
-    if (key != EMPTY_KEY) {
-      int index = (key % capacity_ + capacity_) % capacity_;
-      while (new_keys[index] != EMPTY_KEY) {
-        index = (index + 1) % capacity_;
+  return _mm256_srl_epi32(
+      _mm256_mullo_epi32(folded, _mm256_set1_epi32(static_cast<int>(HASH_MULTIPLIER))), _mm_cvtsi32_si128(shift_));
+}
+
+template <typename K>
+void LinearProbingAggregateHashTable<K>::prefetch_avx2(const K *keys) const
+{
+  alignas(32) uint32_t slots[SIMD_WIDTH];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(slots), hash_avx2(fold_avx2(keys)));
+  for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+    __builtin_prefetch(&keys_[slots[lane]]);
+  }
+}
+
+template <typename K>
+int LinearProbingAggregateHashTable<K>::add_batch_avx2(const K *input_keys, int len)
+{
+  // lane_rows 是每个通道正在处理的行，lane_offsets 是这一行线性探测的偏移量。
+  // inv (invalid) 中等于 -1 的通道已经完成，下一轮读取新的行，等于 0 的通道继续探测下一个槽。
+  alignas(32) int      lane_rows[SIMD_WIDTH]    = {0};
+  alignas(32) int      lane_offsets[SIMD_WIDTH] = {0};
+  alignas(32) uint32_t lane_slots[SIMD_WIDTH];
+
+  const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  __m256i       inv       = _mm256_set1_epi32(-1);
+  int           i         = 0;
+  while (i + SIMD_WIDTH <= len) {
+    // 1. 完成的通道按顺序读取新的行，i += |inv|。所有的通道都读取新的行时，行号是连续的
+    const int  first       = i;
+    const int  loaded      = _mm256_movemask_ps(_mm256_castsi256_ps(inv));
+    const bool consecutive = loaded == 0xFF;
+    selective_load(row_ids_.data(), i, lane_rows, inv);
+    i += __builtin_popcount(loaded);
+
+    // 这一轮最多插入 SIMD_WIDTH 个分组，扩容之后所有通道都从头开始探测
+    if (static_cast<int64_t>(size_ + SIMD_WIDTH) * 2 > capacity_) {
+      resize();
+      memset(lane_offsets, 0, sizeof(lane_offsets));
+    }
+
+    // 预取后面的行要访问的槽
+    if (i + PREFETCH_DISTANCE + SIMD_WIDTH <= len) {
+      prefetch_avx2(input_keys + i + PREFETCH_DISTANCE);
+    }
+
+    // 2. gather 输入的键值，计算哈希值，加上偏移量得到要探测的槽
+    const __m256i rows = _mm256_load_si256(reinterpret_cast<const __m256i *>(lane_rows));
+    __m256i       keys, keys_high, folded;
+    if constexpr (sizeof(K) == sizeof(int32_t)) {
+      keys   = consecutive ? _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input_keys + first))
+                           : _mm256_i32gather_epi32(reinterpret_cast<const int *>(input_keys), rows, sizeof(K));
+      folded = keys;
+    } else {
+      const auto *base = reinterpret_cast<const long long *>(input_keys);
+      if (consecutive) {
+        keys      = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input_keys + first));
+        keys_high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input_keys + first + SIMD_WIDTH / 2));
+      } else {
+        keys      = _mm256_i32gather_epi64(base, _mm256_castsi256_si128(rows), sizeof(K));
+        keys_high = _mm256_i32gather_epi64(base, _mm256_extracti128_si256(rows, 1), sizeof(K));
+      }
+      // 每个64位的键值把高32位和低32位异或，再把8个结果放到一起
+      const __m256i low_dwords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+      const __m256i fold_low   = _mm256_xor_si256(keys, _mm256_srli_epi64(keys, 32));
+      const __m256i fold_high  = _mm256_xor_si256(keys_high, _mm256_srli_epi64(keys_high, 32));
+      folded                   = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(fold_low, low_dwords),
+          _mm256_permutevar8x32_epi32(fold_high, low_dwords), 0xF0);
+    }
+    const __m256i hashes = hash_avx2(folded);
+    const __m256i offsets = _mm256_load_si256(reinterpret_cast<const __m256i *>(lane_offsets));
+    const __m256i slots   = _mm256_and_si256(_mm256_add_epi32(hashes, offsets), _mm256_set1_epi32(mask_));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane_slots), slots);
+
+    // 3. gather 槽中的键值，与输入的键值以及 EMPTY_KEY 比较
+    int match = 0, empty = 0, special = 0;
+    if constexpr (sizeof(K) == sizeof(int32_t)) {
+      const __m256i table_keys = _mm256_i32gather_epi32(reinterpret_cast<const int *>(keys_.data()), slots, sizeof(K));
+      const __m256i empty_keys = _mm256_set1_epi32(EMPTY_KEY);
+      match   = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(table_keys, keys)));
+      empty   = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(table_keys, empty_keys)));
+      special = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(keys, empty_keys)));
+    } else {
+      const auto   *base       = reinterpret_cast<const long long *>(keys_.data());
+      const __m256i table_low  = _mm256_i32gather_epi64(base, _mm256_castsi256_si128(slots), sizeof(K));
+      const __m256i table_high = _mm256_i32gather_epi64(base, _mm256_extracti128_si256(slots, 1), sizeof(K));
+      const __m256i empty_keys = _mm256_set1_epi64x(EMPTY_KEY);
+      match   = movemask_epi64(_mm256_cmpeq_epi64(table_low, keys), _mm256_cmpeq_epi64(table_high, keys_high));
+      empty   = movemask_epi64(_mm256_cmpeq_epi64(table_low, empty_keys), _mm256_cmpeq_epi64(table_high, empty_keys));
+      special = movemask_epi64(_mm256_cmpeq_epi64(keys, empty_keys), _mm256_cmpeq_epi64(keys_high, empty_keys));
+    }
+
+    // 所有的通道都命中时(分组不多时的常见情况)，gather 分组的编号，行号连续时直接写到 positions_ 中
+    if (match == 0xFF && special == 0) {
+      const __m256i groups = _mm256_i32gather_epi32(reinterpret_cast<const int *>(groups_.data()), slots, 4);
+      if (consecutive) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(&positions_[first]), groups);
+      } else {
+        alignas(32) uint32_t lane_groups[SIMD_WIDTH];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lane_groups), groups);
+        for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+          positions_[lane_rows[lane]] = lane_groups[lane];
+        }
+      }
+      _mm256_store_si256(reinterpret_cast<__m256i *>(lane_offsets), _mm256_setzero_si256());
+      inv = _mm256_set1_epi32(-1);
+      continue;
+    }
+
+    // 4. 命中的通道记录分组，遇到空槽的通道插入新的分组。
+    // 同一轮中前面的通道可能已经在这个空槽中插入了分组，所以插入之前需要再检查一次
+    int done = 0;
+    for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+      const int      bit  = 1 << lane;
+      const int      row  = lane_rows[lane];
+      const K        key  = input_keys[row];
+      const uint32_t slot = lane_slots[lane];
+      if (special & bit) {
+        positions_[row] = empty_key_group();
+        done |= bit;
+      } else if (match & bit) {
+        positions_[row] = groups_[slot];
+        done |= bit;
+      } else if (empty & bit) {
+        if (keys_[slot] == EMPTY_KEY) {
+          positions_[row] = insert(slot, key);
+          done |= bit;
+        } else if (keys_[slot] == key) {
+          positions_[row] = groups_[slot];
+          done |= bit;
+        }
       }
-      new_keys[index]   = key;
-      new_values[index] = value;
+      lane_offsets[lane] = (done & bit) ? 0 : lane_offsets[lane] + 1;
     }
+
+    // 5. 更新 inv
+    const __m256i done_bits = _mm256_and_si256(_mm256_set1_epi32(done), lane_bits);
+    inv                     = _mm256_cmpeq_epi32(done_bits, lane_bits);
   }
 
-  keys_   = std::move(new_keys);
-  values_ = std::move(new_values);
+  // 6. 还没有完成的通道逐个处理，[i, len) 由调用者处理
+  const int finished = _mm256_movemask_ps(_mm256_castsi256_ps(inv));
+  for (int lane = 0; lane < SIMD_WIDTH; lane++) {
+    if (!(finished & (1 << lane))) {
+      const int row   = lane_rows[lane];
+      positions_[row] = find_or_insert(input_keys[row]);
+    }
+  }
+  return i;
 }
+#endif
 
-template <typename V>
-void LinearProbingAggregateHashTable<V>::resize_if_need()
+template <typename K>
+uint32_t LinearProbingAggregateHashTable<K>::find_or_insert(K key)
 {
-  if (size_ >= capacity_ / 2) {
+  if (key == EMPTY_KEY) {
+    return empty_key_group();
+  }
+  if (static_cast<int64_t>(size_ + 1) * 2 > capacity_) {
     resize();
   }
+  for (uint32_t slot = slot_of(key);; slot = (slot + 1) & mask_) {
+    if (keys_[slot] == key) {
+      return groups_[slot];
+    }
+    if (keys_[slot] == EMPTY_KEY) {
+      return insert(slot, key);
+    }
+  }
 }
 
-template <typename V>
-void LinearProbingAggregateHashTable<V>::add_batch(int *input_keys, V *input_values, int len)
+template <typename K>
+uint32_t LinearProbingAggregateHashTable<K>::insert(uint32_t slot, K key)
 {
-  // your code here
-  exit(-1);
+  const uint32_t group = static_cast<uint32_t>(size_++);
+  keys_[slot]          = key;
+  groups_[slot]        = group;
+  group_keys_.push_back(key);
+  states_.resize(states_.size() + aggr_types_.size(), HashAggregateState{{0}, 0});
+  return group;
+}
 
-  // inv (invalid) 表示是否有效，inv[i] = -1 表示有效，inv[i] = 0 表示无效。
-  // key[SIMD_WIDTH],value[SIMD_WIDTH] 表示当前循环中处理的键值对。
-  // off (offset) 表示线性探测冲突时的偏移量，key[i] 每次遇到冲突键，则off[i]++，如果key[i] 已经完成聚合，则off[i] = 0，
-  // i = 0 表示selective load 的起始位置。
-  // inv 全部初始化为 -1
-  // off 全部初始化为 0
+template <typename K>
+uint32_t LinearProbingAggregateHashTable<K>::empty_key_group()
+{
+  if (empty_key_group_ < 0) {
+    empty_key_group_ = size_++;
+    group_keys_.push_back(EMPTY_KEY);
+    states_.resize(states_.size() + aggr_types_.size(), HashAggregateState{{0}, 0});
+  }
+  return static_cast<uint32_t>(empty_key_group_);
+}
 
-  // for (; i + SIMD_WIDTH <= len;) {
-    // 1: 根据 `inv` 变量的值，从 `input_keys` 中 `selective load` `SIMD_WIDTH` 个不同的输入键值对。
-    // 2. 计算 i += |inv|, `|inv|` 表示 `inv` 中有效的个数 
-    // 3. 计算 hash 值，
-    // 4. 根据聚合类型（目前只支持 sum），在哈希表中更新聚合结果。如果本次循环，没有找到key[i] 在哈希表中的位置，则不更新聚合结果。
-    // 5. gather 操作，根据 hash 值将 keys_ 的 gather 结果写入 table_key 中。
-    // 6. 更新 inv 和 off。如果本次循环key[i] 聚合完成，则inv[i]=-1，表示该位置在下次循环中读取新的键值对。
-    // 如果本次循环 key[i] 未在哈希表中聚合完成（table_key[i] != key[i]），则inv[i] = 0，表示该位置在下次循环中不需要读取新的键值对。
-    // 如果本次循环中，key[i]聚合完成，则off[i] 更新为 0，表示线性探测偏移量为 0，key[i] 未完成聚合，则off[i]++,表示线性探测偏移量加 1。
-  // }
-  //7. 通过标量线性探测，处理剩余键值对
+template <typename K>
+void LinearProbingAggregateHashTable<K>::resize()
+{
+  capacity_ *= 2;
+  mask_ = static_cast<uint32_t>(capacity_ - 1);
+  shift_--;
+  keys_.assign(capacity_, EMPTY_KEY);
+  groups_.assign(capacity_, 0);
+  for (int group = 0; group < size_; group++) {
+    const K key = group_keys_[group];
+    if (group == empty_key_group_) {
+      continue;
+    }
+    uint32_t slot = slot_of(key);
+    while (keys_[slot] != EMPTY_KEY) {
+      slot = (slot + 1) & mask_;
+    }
+    keys_[slot]   = key;
+    groups_[slot] = static_cast<uint32_t>(group);
+  }
+}
 
-  // resize_if_need();
+template <typename K>
+RC LinearProbingAggregateHashTable<K>::write_key(uint32_t group, Column &column) const
+{
+  if (column.attr_len() != static_cast<int>(sizeof(K))) {
+    LOG_WARN("group by column length mismatch. expect=%d, actual=%d", static_cast<int>(sizeof(K)), column.attr_len());
+    return RC::INVALID_ARGUMENT;
+  }
+  K key = group_keys_[group];
+  return column.append_one(reinterpret_cast<char *>(&key));
 }
 
-template <typename V>
-const int LinearProbingAggregateHashTable<V>::EMPTY_KEY = 0xffffffff;
-template <typename V>
-const int LinearProbingAggregateHashTable<V>::DEFAULT_CAPACITY = 16384;
+template <typename K>
+void LinearProbingAggregateHashTable<K>::Scanner::open_scan()
+{
+  pos_ = 0;
+}
+
+template <typename K>
+RC LinearProbingAggregateHashTable<K>::Scanner::next(Chunk &output_chunk)
+{
+  auto *hash_table = static_cast<LinearProbingAggregateHashTable *>(hash_table_);
+  if (pos_ >= hash_table->size_) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = RC::SUCCESS;
+  while (pos_ < hash_table->size_ && output_chunk.rows() < output_chunk.capacity()) {
+    const uint32_t group = static_cast<uint32_t>(pos_++);
+    for (int i = 0; i < output_chunk.column_num() && OB_SUCC(rc); i++) {
+      const int col_idx = output_chunk.column_ids(i);
+      if (col_idx == 0) {
+        rc = hash_table->write_key(group, output_chunk.column(i));
+      } else if (col_idx <= static_cast<int>(hash_table->aggr_types_.size())) {
+        rc = write_aggregate_state(hash_table->aggr_types_[col_idx - 1],
+            hash_table->aggr_is_float_[col_idx - 1],
+            *hash_table->state(group, col_idx - 1),
+            output_chunk.column(i));
+      } else {
+        LOG_WARN("invalid output column id: %d", col_idx);
+        rc = RC::INVALID_ARGUMENT;
+      }
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to write aggregate result. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+template <typename K>
+void LinearProbingAggregateHashTable<K>::Scanner::close_scan()
+{
+  pos_ = 0;
+}
 
-template class LinearProbingAggregateHashTable<int>;
-template class LinearProbingAggregateHashTable<float>;
-#endif
\ No newline at end of file
+template class LinearProbingAggregateHashTable<int32_t>;
+template class LinearProbingAggregateHashTable<int64_t>;
@@ -9,9 +9,9 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 #pragma once
 
+#include <limits>
 #include <vector>
 #include <iostream>
-#include <unordered_map>
 
 #include "common/math/simd_util.h"
 #include "common/rc.h"
@@ -50,21 +50,30 @@ public:
   virtual ~AggregateHashTable() = default;
 };
 
-class StandardAggregateHashTable : public AggregateHashTable
+/**
+ * @brief 聚合哈希表中一个分组的一个聚合函数的状态，全部是0时就是初始状态
+ */
+struct HashAggregateState
 {
-private:
-  struct VectorHash
-  {
-    std::size_t operator()(const std::vector<Value> &vec) const;
-  };
-
-  struct VectorEqual
+  union
   {
-    bool operator()(const std::vector<Value> &lhs, const std::vector<Value> &rhs) const;
+    int64_t int_value;
+    double  double_value;
   };
+  int64_t count;
+};
 
+/**
+ * @brief 开放寻址的聚合哈希表
+ * @details 分组字段都是定长的，按照类型规整之后(字符串 '\0' 后面的字节清零，浮点数的 -0.0 写成 0.0)
+ * 依次拼接成定长的键值，与聚合状态一起存放在连续的行存储(arena)中，每一行是 [键值][聚合状态0][聚合状态1]...。
+ * 哈希表的槽只记录哈希值和行号，使用线性探测，超过一半的槽被占用时扩容，扩容时使用槽中的哈希值，不需要重新计算。
+ * add_chunk 按列计算整个 chunk 的键值和哈希值，再逐行探测得到每一行所在的组，最后按列更新聚合状态。
+ * 聚合的参数必须是数值类型(COUNT 除外)，整数使用 int64_t 累加，浮点数使用 double 累加。
+ */
+class StandardAggregateHashTable : public AggregateHashTable
+{
 public:
-  using StandardHashTable = std::unordered_map<std::vector<Value>, std::vector<Value>, VectorHash, VectorEqual>;
   class Scanner : public AggregateHashTable::Scanner
   {
   public:
@@ -73,12 +82,15 @@ public:
 
     void open_scan() override;
 
+    /**
+     * @details output_chunk 中的列按照 column_ids 输出，小于分组字段个数的是分组字段，其它的是聚合结果
+     */
     RC next(Chunk &chunk) override;
 
   private:
-    StandardHashTable::iterator end_;
-    StandardHashTable::iterator it_;
+    int pos_ = 0;
   };
+
   StandardAggregateHashTable(const std::vector<Expression *> aggregations)
   {
     for (auto &expr : aggregations) {
@@ -92,21 +104,81 @@ public:
 
   RC add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk) override;
 
-  StandardHashTable::iterator begin() { return aggr_values_.begin(); }
-  StandardHashTable::iterator end() { return aggr_values_.end(); }
+  /// 分组的个数
+  int size() const { return size_; }
+
+private:
+  /// 哈希表的槽，只保存哈希值的低32位和行号
+  struct Slot
+  {
+    uint32_t hash;
+    uint32_t row;
+  };
+
+  static constexpr uint32_t EMPTY_ROW        = 0xFFFFFFFF;
+  static constexpr size_t   DEFAULT_CAPACITY = 1024;
+  static constexpr int      PREFETCH_DISTANCE = 16;
+
+private:
+  /// 第一次添加数据时，根据分组字段和聚合字段的类型确定每一行的格式
+  RC init_layout(Chunk &groups_chunk, Chunk &aggrs_chunk);
+
+  /// 把一列分组字段规整之后写到 keys_ 中，并且把这一列的哈希值合并到 hashes_ 中
+  void add_key_column(const Column &column, int group_index, int rows);
+
+  /// 查找键值所在的行，不存在时插入新的一行
+  uint32_t find_or_insert(uint64_t hash, const char *key);
+  void     resize();
+
+  /// 使用一列数据更新第 aggr_index 个聚合函数的状态，rows_ 中是每一行所在的组
+  RC update_states(const Column &column, int aggr_index, int rows);
+
+  RC write_group(uint32_t row, int group_index, Column &column) const;
+  RC write_aggregate(uint32_t row, int aggr_index, Column &column) const;
+
+  char       *row_data(uint32_t row) { return arena_.data() + static_cast<size_t>(row) * row_width_; }
+  const char *row_data(uint32_t row) const { return arena_.data() + static_cast<size_t>(row) * row_width_; }
+  HashAggregateState *state(char *row, int aggr_index)
+  {
+    return reinterpret_cast<HashAggregateState *>(row + states_offset_) + aggr_index;
+  }
+  const HashAggregateState *state(const char *row, int aggr_index) const
+  {
+    return reinterpret_cast<const HashAggregateState *>(row + states_offset_) + aggr_index;
+  }
 
 private:
-  /// group by values -> aggregate values
-  StandardHashTable                aggr_values_;
   std::vector<AggrFuncType> aggr_types_;
+
+  bool                  initialized_ = false;
+  std::vector<AttrType> group_types_;
+  std::vector<int>      group_lens_;
+  std::vector<int>      group_offsets_;   ///< 每个分组字段在键值中的偏移
+  std::vector<bool>     aggr_is_float_;   ///< 聚合的参数是不是浮点数
+  int                   key_width_     = 0;
+  int                   states_offset_ = 0;  ///< 聚合状态在一行中的偏移，按照8字节对齐
+  int                   row_width_     = 0;
+
+  std::vector<char> arena_;  ///< 所有的行，行号就是分组的编号
+  int               size_ = 0;
+  std::vector<Slot> slots_;
+  uint32_t          mask_ = 0;
+
+  /// add_chunk 中使用的临时空间，避免每次都申请内存
+  std::vector<uint64_t> hashes_;
+  std::vector<char>     keys_;
+  std::vector<uint32_t> rows_;
 };
 
 /**
- * @brief 线性探测哈希表实现
- * @note 当前只支持group by 列为 char/char(4) 类型，且聚合列为单列。
+ * @brief 线性探测哈希表实现，分组字段是一列 int32_t(INTS/DATES) 或者 int64_t(LONGS) 类型的整数，即模板参数 K
+ * @details 槽中存放键值和分组的编号，空槽的键值是 EMPTY_KEY，键值等于 EMPTY_KEY 的分组不放在槽中，单独记录编号。
+ * 聚合状态按照分组的编号连续存放，每个分组是 [聚合状态0][聚合状态1]...。
+ * add_chunk 先找到每一行所在的分组，再像 StandardAggregateHashTable 一样按列更新聚合状态，支持 COUNT/SUM/AVG/MIN/MAX。
+ * 查找分组参考了论文 `Rethinking SIMD Vectorization for In-Memory Databases` 中的 `Algorithm 5`，
+ * simd_enabled() 时使用 AVX2 同时探测 SIMD_WIDTH 行，否则逐行探测。
  */
-#ifdef USE_SIMD
-template <typename V>
+template <typename K>
 class LinearProbingAggregateHashTable : public AggregateHashTable
 {
 public:
@@ -118,55 +190,98 @@ public:
 
     void open_scan() override;
 
+    /**
+     * @details output_chunk 中的列按照 column_ids 输出，0 是分组字段，其它的是聚合结果
+     */
     RC next(Chunk &chunk) override;
 
     void close_scan() override;
 
   private:
-    int capacity_   = -1;
-    int size_       = -1;
-    int scan_pos_   = -1;
-    int scan_count_ = 0;
+    int pos_ = 0;
   };
 
-  LinearProbingAggregateHashTable(AggrFuncType aggregate_type, int capacity = DEFAULT_CAPACITY)
-      : keys_(capacity, EMPTY_KEY), values_(capacity, 0), capacity_(capacity), aggregate_type_(aggregate_type)
-  {}
+  /// @param capacity 初始的槽的个数，会向上取整到2的幂
+  LinearProbingAggregateHashTable(const std::vector<Expression *> aggregations, int capacity = DEFAULT_CAPACITY);
   virtual ~LinearProbingAggregateHashTable() {}
 
-  RC get(int key, V &value);
-
-  RC iter_get(int pos, int &key, V &value);
-
   RC add_chunk(Chunk &group_chunk, Chunk &aggr_chunk) override;
 
-  int capacity() { return capacity_; }
-  int size() { return size_; }
+  int capacity() const { return capacity_; }
+  /// 分组的个数
+  int size() const { return size_; }
 
 private:
-  /**
-   * @brief 将键值对以批量的形式写入哈希表中，这里参考了论文
-   * `Rethinking SIMD Vectorization for In-Memory Databases` 中的 `Algorithm 5`。
-   * @param input_keys 输入的键数组
-   * @param input_values 输入的值数组，与键数组一一对应。
-   * @param len 键值对数组的长度
-   */
-  void add_batch(int *input_keys, V *input_values, int len);
+  static constexpr K        EMPTY_KEY         = std::numeric_limits<K>::min();
+  static constexpr int      DEFAULT_CAPACITY  = 16384;
+  static constexpr int      MIN_CAPACITY      = 16;
+  static constexpr int      PREFETCH_DISTANCE = 16;
+  static constexpr uint32_t HASH_MULTIPLIER   = 0x9E3779B1;
+
+  /// 乘法哈希，取乘积的高位作为槽的下标。64位的键值先把高32位和低32位异或
+  uint32_t slot_of(K key) const
+  {
+    const uint64_t value = static_cast<uint64_t>(key);
+    const uint32_t folded = static_cast<uint32_t>(value ^ (value >> 32));
+    return (folded * HASH_MULTIPLIER) >> shift_;
+  }
 
-  void aggregate(V *value, V value_to_aggregate);
+  /// 找到每一行所在的分组，写到 positions_ 中
+  void add_batch(const K *input_keys, int len);
 
+#if defined(USE_SIMD)
+  /**
+   * @brief add_batch 的 AVX2 实现，返回处理了多少行，剩下的行由调用者逐行处理
+   * @details 每个通道是一个还没有找到分组的行，使用 selective load 给完成的通道读取新的行，
+   * gather 输入的键值和槽中的键值，同时比较 SIMD_WIDTH 个通道。AVX2 没有 scatter，所以命中和插入是逐个通道处理的。
+   */
+  SIMD_AVX2 int add_batch_avx2(const K *input_keys, int len);
+
+  /// 读取连续的 SIMD_WIDTH 个键值，64位的键值把高32位和低32位异或，得到 SIMD_WIDTH 个32位的值
+  SIMD_AVX2 __m256i fold_avx2(const K *keys) const;
+  /// 与 slot_of 相同的哈希函数，没有加上探测的偏移量
+  SIMD_AVX2 __m256i hash_avx2(__m256i folded) const;
+  /// 预取连续的 SIMD_WIDTH 个键值要访问的槽
+  SIMD_AVX2 void prefetch_avx2(const K *keys) const;
+#endif
+
+  /// 查找键值所在的分组，不存在时插入新的分组
+  uint32_t find_or_insert(K key);
+  /// 在空槽 slot 中插入新的分组
+  uint32_t insert(uint32_t slot, K key);
+  uint32_t empty_key_group();
+  /// 槽的个数扩大一倍，重新插入所有的分组
   void resize();
 
-  void resize_if_need();
+  RC write_key(uint32_t group, Column &column) const;
+
+  HashAggregateState *state(uint32_t group, int aggr_index)
+  {
+    return &states_[static_cast<size_t>(group) * aggr_types_.size() + aggr_index];
+  }
+  const HashAggregateState *state(uint32_t group, int aggr_index) const
+  {
+    return &states_[static_cast<size_t>(group) * aggr_types_.size() + aggr_index];
+  }
 
 private:
-  static const int EMPTY_KEY;
-  static const int DEFAULT_CAPACITY;
-
-  std::vector<int>    keys_;
-  std::vector<V>      values_;
-  int                 size_     = 0;
-  int                 capacity_ = 0;
-  AggrFuncType        aggregate_type_;
+  std::vector<AggrFuncType> aggr_types_;
+  std::vector<bool>         aggr_is_float_;  ///< 聚合的参数是不是浮点数，添加第一个 chunk 时确定
+  bool                      initialized_ = false;
+
+  std::vector<K>        keys_;    ///< 每个槽的键值
+  std::vector<uint32_t> groups_;  ///< 每个槽的分组编号
+  int                   capacity_ = 0;
+  uint32_t              mask_     = 0;
+  int                   shift_    = 0;  ///< 32 - log2(capacity_)
+
+  std::vector<K>                  group_keys_;  ///< 每个分组的键值
+  std::vector<HashAggregateState> states_;
+  int                             size_            = 0;
+  int64_t                         empty_key_group_ = -1;  ///< 键值等于 EMPTY_KEY 的分组的编号
+
+  /// add_chunk 中使用的临时空间
+  std::vector<uint32_t> positions_;  ///< 每一行所在的分组
+  std::vector<int>      row_ids_;    ///< 0, 1, 2, ...，selective load 的输入
+  bool                  insert_heavy_ = false;  ///< 上一批中是否超过一半的行插入了新的分组
 };
-#endif
\ No newline at end of file
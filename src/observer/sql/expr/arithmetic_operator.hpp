@@ -10,9 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
-#if defined(USE_SIMD)
+#include <cstring>
+
 #include "common/math/simd_util.h"
-#endif
 
 #include "storage/common/column.h"
 
@@ -24,12 +24,15 @@ struct Equal
     return left == right;
   }
 #if defined(USE_SIMD)
-  static inline __m256 operation(const __m256 &left, const __m256 &right)
+  SIMD_AVX2 static inline __m256 operation(const __m256 &left, const __m256 &right)
   {
     return _mm256_cmp_ps(left, right, _CMP_EQ_OS);
   }
 
-  static inline __m256i operation(const __m256i &left, const __m256i &right) { return _mm256_cmpeq_epi32(left, right); }
+  SIMD_AVX2 static inline __m256i operation(const __m256i &left, const __m256i &right)
+  {
+    return _mm256_cmpeq_epi32(left, right);
+  }
 #endif
 };
 struct NotEqual
@@ -40,12 +43,12 @@ struct NotEqual
     return left != right;
   }
 #if defined(USE_SIMD)
-  static inline __m256 operation(const __m256 &left, const __m256 &right)
+  SIMD_AVX2 static inline __m256 operation(const __m256 &left, const __m256 &right)
   {
     return _mm256_cmp_ps(left, right, _CMP_NEQ_OS);
   }
 
-  static inline __m256i operation(const __m256i &left, const __m256i &right)
+  SIMD_AVX2 static inline __m256i operation(const __m256i &left, const __m256i &right)
   {
     return _mm256_xor_si256(_mm256_set1_epi32(-1), _mm256_cmpeq_epi32(left, right));
   }
@@ -60,12 +63,15 @@ struct GreatThan
     return left > right;
   }
 #if defined(USE_SIMD)
-  static inline __m256 operation(const __m256 &left, const __m256 &right)
+  SIMD_AVX2 static inline __m256 operation(const __m256 &left, const __m256 &right)
   {
     return _mm256_cmp_ps(left, right, _CMP_GT_OS);
   }
 
-  static inline __m256i operation(const __m256i &left, const __m256i &right) { return _mm256_cmpgt_epi32(left, right); }
+  SIMD_AVX2 static inline __m256i operation(const __m256i &left, const __m256i &right)
+  {
+    return _mm256_cmpgt_epi32(left, right);
+  }
 #endif
 };
 
@@ -78,12 +84,12 @@ struct GreatEqual
   }
 
 #if defined(USE_SIMD)
-  static inline __m256 operation(const __m256 &left, const __m256 &right)
+  SIMD_AVX2 static inline __m256 operation(const __m256 &left, const __m256 &right)
   {
     return _mm256_cmp_ps(left, right, _CMP_GE_OS);
   }
 
-  static inline __m256i operation(const __m256i &left, const __m256i &right)
+  SIMD_AVX2 static inline __m256i operation(const __m256i &left, const __m256i &right)
   {
     return _mm256_cmpgt_epi32(left, right) | _mm256_cmpeq_epi32(left, right);
   }
@@ -98,12 +104,15 @@ struct LessThan
     return left < right;
   }
 #if defined(USE_SIMD)
-  static inline __m256 operation(const __m256 &left, const __m256 &right)
+  SIMD_AVX2 static inline __m256 operation(const __m256 &left, const __m256 &right)
   {
     return _mm256_cmp_ps(left, right, _CMP_LT_OS);
   }
 
-  static inline __m256i operation(const __m256i &left, const __m256i &right) { return _mm256_cmpgt_epi32(right, left); }
+  SIMD_AVX2 static inline __m256i operation(const __m256i &left, const __m256i &right)
+  {
+    return _mm256_cmpgt_epi32(right, left);
+  }
 #endif
 };
 
@@ -115,12 +124,12 @@ struct LessEqual
     return left <= right;
   }
 #if defined(USE_SIMD)
-  static inline __m256 operation(const __m256 &left, const __m256 &right)
+  SIMD_AVX2 static inline __m256 operation(const __m256 &left, const __m256 &right)
   {
     return _mm256_cmp_ps(left, right, _CMP_LE_OS);
   }
 
-  static inline __m256i operation(const __m256i &left, const __m256i &right)
+  SIMD_AVX2 static inline __m256i operation(const __m256i &left, const __m256i &right)
   {
     return _mm256_or_si256(_mm256_cmpgt_epi32(right, left), _mm256_cmpeq_epi32(left, right));
   }
@@ -136,9 +145,9 @@ struct AddOperator
   }
 
 #if defined(USE_SIMD)
-  static inline __m256 operation(__m256 left, __m256 right) { return _mm256_add_ps(left, right); }
+  SIMD_AVX2 static inline __m256 operation(__m256 left, __m256 right) { return _mm256_add_ps(left, right); }
 
-  static inline __m256i operation(__m256i left, __m256i right) { return _mm256_add_epi32(left, right); }
+  SIMD_AVX2 static inline __m256i operation(__m256i left, __m256i right) { return _mm256_add_epi32(left, right); }
 #endif
 };
 
@@ -149,11 +158,10 @@ struct SubtractOperator
   {
     return left - right;
   }
-  // your code here
 #if defined(USE_SIMD)
-  static inline __m256 operation(__m256 left, __m256 right) { exit(-1); }
+  SIMD_AVX2 static inline __m256 operation(__m256 left, __m256 right) { return _mm256_sub_ps(left, right); }
 
-  static inline __m256i operation(__m256i left, __m256i right) { exit(-1); }
+  SIMD_AVX2 static inline __m256i operation(__m256i left, __m256i right) { return _mm256_sub_epi32(left, right); }
 #endif
 };
 
@@ -164,11 +172,10 @@ struct MultiplyOperator
   {
     return left * right;
   }
-// your code here
 #if defined(USE_SIMD)
-  static inline __m256 operation(__m256 left, __m256 right) { exit(-1); }
+  SIMD_AVX2 static inline __m256 operation(__m256 left, __m256 right) { return _mm256_mul_ps(left, right); }
 
-  static inline __m256i operation(__m256i left, __m256i right) { exit(-1); }
+  SIMD_AVX2 static inline __m256i operation(__m256i left, __m256i right) { return _mm256_mullo_epi32(left, right); }
 #endif
 };
 
@@ -182,8 +189,8 @@ struct DivideOperator
   }
 
 #if defined(USE_SIMD)
-  static inline __m256  operation(__m256 left, __m256 right) { return _mm256_div_ps(left, right); }
-  static inline __m256i operation(__m256i left, __m256i right)
+  SIMD_AVX2 static inline __m256 operation(__m256 left, __m256 right) { return _mm256_div_ps(left, right); }
+  SIMD_AVX2 static inline __m256i operation(__m256i left, __m256i right)
   {
 
     __m256 left_float   = _mm256_cvtepi32_ps(left);
@@ -204,11 +211,27 @@ struct NegateOperator
   }
 };
 
+#if defined(USE_SIMD)
+/// 比较结果 mask 的每个通道是全0或者全1，压缩成8个字节的0/1之后与 result[0, SIMD_WIDTH) 按位与
+SIMD_AVX2 inline void and_compare_mask(__m256i mask, uint8_t *result)
+{
+  __m256i bits = _mm256_and_si256(mask, _mm256_set1_epi32(1));
+  bits         = _mm256_packus_epi32(bits, bits);  // 每128位中是4个16位的值，重复两次
+  bits         = _mm256_packus_epi16(bits, bits);  // 每128位中是4个8位的值，重复四次
+  bits         = _mm256_permutevar8x32_epi32(bits, _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+
+  uint64_t bytes = _mm_cvtsi128_si64(_mm256_castsi256_si128(bits));
+  uint64_t old;
+  memcpy(&old, result, sizeof(old));
+  old &= bytes;
+  memcpy(result, &old, sizeof(old));
+}
+
+/// compare_operation 的 AVX2 实现，返回处理了多少个值，剩下的由调用者使用标量处理
 template <typename T, bool LEFT_CONSTANT, bool RIGHT_CONSTANT, class OP>
-void compare_operation(T *left, T *right, int n, std::vector<uint8_t> &result)
+SIMD_AVX2 int compare_operation_avx2(T *left, T *right, int n, std::vector<uint8_t> &result)
 {
-#if defined(USE_SIMD)
-  int           i          = 0;
+  int i = 0;
   if constexpr (std::is_same<T, float>::value) {
     for (; i <= n - SIMD_WIDTH; i += SIMD_WIDTH) {
       __m256 left_value, right_value;
@@ -225,12 +248,7 @@ void compare_operation(T *left, T *right, int n, std::vector<uint8_t> &result)
         right_value = _mm256_loadu_ps(&right[i]);
       }
 
-      __m256  result_values = OP::operation(left_value, right_value);
-      __m256i mask          = _mm256_castps_si256(result_values);
-
-      for (int j = 0; j < SIMD_WIDTH; j++) {
-        result[i + j] &= mm256_extract_epi32_var_indx(mask, j) ? 1 : 0;
-      }
+      and_compare_mask(_mm256_castps_si256(OP::operation(left_value, right_value)), &result[i]);
     }
   } else if constexpr (std::is_same<T, int>::value) {
     for (; i <= n - SIMD_WIDTH; i += SIMD_WIDTH) {
@@ -248,32 +266,16 @@ void compare_operation(T *left, T *right, int n, std::vector<uint8_t> &result)
         right_value = _mm256_loadu_si256((__m256i *)&right[i]);
       }
 
-      __m256i result_values = OP::operation(left_value, right_value);
-
-      for (int j = 0; j < SIMD_WIDTH; j++) {
-        result[i + j] &= mm256_extract_epi32_var_indx(result_values, j) ? 1 : 0;
-      }
+      and_compare_mask(OP::operation(left_value, right_value), &result[i]);
     }
   }
-
-  for (; i < n; i++) {
-    auto &left_value  = left[LEFT_CONSTANT ? 0 : i];
-    auto &right_value = right[RIGHT_CONSTANT ? 0 : i];
-    result[i] &= OP::operation(left_value, right_value) ? 1 : 0;
-  }
-#else
-  for (int i = 0; i < n; i++) {
-    auto &left_value  = left[LEFT_CONSTANT ? 0 : i];
-    auto &right_value = right[RIGHT_CONSTANT ? 0 : i];
-    result[i] &= OP::operation(left_value, right_value) ? 1 : 0;
-  }
-#endif
+  return i;
 }
 
+/// binary_operator 的 AVX2 实现，返回处理了多少个值，剩下的由调用者使用标量处理
 template <bool LEFT_CONSTANT, bool RIGHT_CONSTANT, typename T, class OP>
-void binary_operator(T *left_data, T *right_data, T *result_data, int size)
+SIMD_AVX2 int binary_operator_avx2(T *left_data, T *right_data, T *result_data, int size)
 {
-#if defined(USE_SIMD)
   int i = 0;
 
   if constexpr (std::is_same<T, float>::value) {
@@ -315,6 +317,36 @@ void binary_operator(T *left_data, T *right_data, T *result_data, int size)
       _mm256_storeu_si256((__m256i *)&result_data[i], result_value);
     }
   }
+  return i;
+}
+#endif
+
+template <typename T, bool LEFT_CONSTANT, bool RIGHT_CONSTANT, class OP>
+void compare_operation(T *left, T *right, int n, std::vector<uint8_t> &result)
+{
+  int i = 0;
+#if defined(USE_SIMD)
+  if (simd_enabled()) {
+    i = compare_operation_avx2<T, LEFT_CONSTANT, RIGHT_CONSTANT, OP>(left, right, n, result);
+  }
+#endif
+
+  for (; i < n; i++) {
+    auto &left_value  = left[LEFT_CONSTANT ? 0 : i];
+    auto &right_value = right[RIGHT_CONSTANT ? 0 : i];
+    result[i] &= OP::operation(left_value, right_value) ? 1 : 0;
+  }
+}
+
+template <bool LEFT_CONSTANT, bool RIGHT_CONSTANT, typename T, class OP>
+void binary_operator(T *left_data, T *right_data, T *result_data, int size)
+{
+  int i = 0;
+#if defined(USE_SIMD)
+  if (simd_enabled()) {
+    i = binary_operator_avx2<LEFT_CONSTANT, RIGHT_CONSTANT, T, OP>(left_data, right_data, result_data, size);
+  }
+#endif
 
   // 处理剩余未对齐的数据
   for (; i < size; i++) {
@@ -322,13 +354,6 @@ void binary_operator(T *left_data, T *right_data, T *result_data, int size)
     auto &right_value = right_data[RIGHT_CONSTANT ? 0 : i];
     result_data[i]    = OP::template operation<T>(left_value, right_value);
   }
-#else
-  for (int i = 0; i < size; i++) {
-    auto &left_value  = left_data[LEFT_CONSTANT ? 0 : i];
-    auto &right_value = right_data[RIGHT_CONSTANT ? 0 : i];
-    result_data[i]    = OP::template operation<T>(left_value, right_value);
-  }
-#endif
 }
 
 template <bool CONSTANT, typename T, class OP>
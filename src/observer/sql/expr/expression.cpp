@@ -267,6 +267,52 @@ RC ComparisonExpr::compare_value(const Value &left, const Value &right, bool &re
   return rc;
 }
 
+RC ComparisonExpr::compare_in_list(const Tuple &tuple, const Value &left, bool &result)
+{
+  vector<Value> values;
+  if (right_->type() == ExprType::EXPRLIST) {
+    auto &exprs = static_cast<ExprListExpr *>(right_.get())->exprs();
+    values.resize(exprs.size());
+    for (size_t i = 0; i < exprs.size(); i++) {
+      RC rc = exprs[i]->get_value(tuple, values[i]);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get value of in list. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+  } else if (right_->type() == ExprType::SUBQUERY) {
+    LOG_WARN("in sub query is not supported");
+    return RC::UNIMPLENMENT;
+  } else {
+    values.resize(1);
+    RC rc = right_->get_value(tuple, values[0]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get value of right expression. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  result = false;
+  if (left.is_null()) {
+    return RC::SUCCESS;
+  }
+
+  bool matched  = false;
+  bool has_null = false;
+  for (const Value &value : values) {
+    if (value.is_null()) {
+      has_null = true;
+    } else if (left.compare(value) == 0) {
+      matched = true;
+      break;
+    }
+  }
+
+  // x NOT IN (..., NULL) 在没有匹配时结果是未知的
+  result = (comp_ == IN_OP) ? matched : (!matched && !has_null);
+  return RC::SUCCESS;
+}
+
 RC ComparisonExpr::try_get_value(Value &cell) const
 {
   if (left_->type() == ExprType::VALUE && right_->type() == ExprType::VALUE) {
@@ -298,14 +344,22 @@ RC ComparisonExpr::get_value(const Tuple &tuple, Value &value)
     LOG_WARN("failed to get value of left expression. rc=%s", strrc(rc));
     return rc;
   }
+
+  bool bool_value = false;
+  if (comp_ == IN_OP || comp_ == NOT_IN_OP) {
+    rc = compare_in_list(tuple, left_value, bool_value);
+    if (rc == RC::SUCCESS) {
+      value.set_boolean(bool_value);
+    }
+    return rc;
+  }
+
   rc = right_->get_value(tuple, right_value);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to get value of right expression. rc=%s", strrc(rc));
     return rc;
   }
 
-  bool bool_value = false;
-
   rc = compare_value(left_value, right_value, bool_value);
   if (rc == RC::SUCCESS) {
     value.set_boolean(bool_value);
@@ -685,7 +739,7 @@ AggregateExpr::AggregateExpr(AggrFuncType type, unique_ptr<Expression> param)
     }
     return RC::SUCCESS;
   };
-  if (RC::SUCCESS == param_->traverse_check(check_is_constexpr)) {
+  if (param_ != nullptr && RC::SUCCESS == param_->traverse_check(check_is_constexpr)) {
     is_constexpr = true;
   }
 }
@@ -399,6 +399,12 @@ public:
    */
   RC compare_value(const Value &left, const Value &right, bool &value) const;
 
+  /**
+   * @brief 计算 IN / NOT IN，右边是值列表或者单个值(只有一个值的列表在语法解析时就是普通的值)
+   * @details 左边或列表中有 NULL 时按照 SQL 的语义，结果未知的行不会被选中
+   */
+  RC compare_in_list(const Tuple &tuple, const Value &left, bool &value);
+
   template <typename T>
   RC compare_column(const Column &left, const Column &right, std::vector<uint8_t> &result) const;
 
@@ -888,6 +894,8 @@ public:
 
   void reset() { cur_idx_ = 0; }
 
+  std::vector<std::unique_ptr<Expression>> &exprs() { return exprs_; }
+
   RC get_value(const Tuple &tuple, Value &value) override
   {
     if (cur_idx_ >= (int)exprs_.size()) {
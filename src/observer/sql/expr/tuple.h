@@ -368,7 +368,20 @@ public:
     spec = specs_[index];
     return RC::SUCCESS;
   }
-  virtual RC find_cell(const TupleCellSpec &spec, Value &cell, int &index) const override { return RC::INTERNAL; }
+  virtual RC find_cell(const TupleCellSpec &spec, Value &cell, int &index) const override
+  {
+    // 没有设置名字的时候找不到任何字段
+    const int spec_num = std::min(cell_num(), static_cast<int>(specs_.size()));
+    for (int i = 0; i < spec_num; i++) {
+      if (0 == strcmp(specs_[i].table_name(), spec.table_name()) &&
+          0 == strcmp(specs_[i].field_name(), spec.field_name())) {
+        index = i;
+        cell  = cells_[i];
+        return RC::SUCCESS;
+      }
+    }
+    return RC::NOTFOUND;
+  }
   static RC  make(const Tuple &tuple, ValueListTuple &value_list)
   {
     const int cell_num = tuple.cell_num();
@@ -416,7 +429,7 @@ public:
   RC cell_at(int index, Value &value) const override
   {
     const int left_cell_num = left_->cell_num();
-    if (index > 0 && index < left_cell_num) {
+    if (index >= 0 && index < left_cell_num) {
       return left_->cell_at(index, value);
     }
 
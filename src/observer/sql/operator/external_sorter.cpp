@@ -0,0 +1,595 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/external_sorter.h"
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
+#include "common/lang/string_view.h"
+#include "common/log/log.h"
+
+#include <cstring>
+
+SortOptions SortOptions::from_config()
+{
+  SortOptions options;
+
+  const char *section    = "SQL";
+  string      memory     = common::get_properties()->get("SORT_MEMORY_MB", "", section);
+  string      merge_ways = common::get_properties()->get("SORT_MERGE_WAYS", "", section);
+  if (!memory.empty()) {
+    int64_t memory_mb = 0;
+    common::str_to_val(memory, memory_mb);
+    if (memory_mb > 0) {
+      options.memory = memory_mb * 1024 * 1024;
+    }
+  }
+  if (!merge_ways.empty()) {
+    common::str_to_val(merge_ways, options.merge_ways);
+  }
+  options.merge_ways = std::max(options.merge_ways, MIN_MERGE_WAYS);
+  return options;
+}
+
+namespace {
+
+void append_big_endian(uint64_t value, int bytes, string &key)
+{
+  for (int i = bytes - 1; i >= 0; i--) {
+    key.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+  }
+}
+
+void append_double(double value, string &key)
+{
+  if (value == 0) {
+    value = 0;  // -0.0 与 0.0 相等
+  }
+  uint64_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  bits = (bits & (1ULL << 63)) ? ~bits : (bits | (1ULL << 63));
+  append_big_endian(bits, sizeof(bits), key);
+}
+
+void append_bytes(const char *data, int length, string &key)
+{
+  for (int i = 0; i < length; i++) {
+    key.push_back(data[i]);
+    if (data[i] == 0) {
+      key.push_back(static_cast<char>(0xFF));
+    }
+  }
+  key.push_back(0);
+  key.push_back(0);
+}
+
+void append_uint32(uint32_t value, string &record) { record.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+
+uint32_t read_uint32(const char *data)
+{
+  uint32_t value = 0;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/// 与哈希连接写临时文件的格式相同：类型、长度、数据
+void append_value(const Value &value, string &record)
+{
+  int32_t     header[2]  = {static_cast<int32_t>(value.attr_type()), 0};
+  char        bool_value = 0;
+  const char *data       = nullptr;
+  switch (value.attr_type()) {
+    case AttrType::NULLS: break;
+    case AttrType::BOOLEANS: {
+      bool_value = value.get_boolean() ? 1 : 0;
+      data       = &bool_value;
+      header[1]  = 1;
+    } break;
+    default: {
+      data      = value.data();
+      header[1] = value.length();
+    } break;
+  }
+
+  record.append(reinterpret_cast<const char *>(header), sizeof(header));
+  if (header[1] > 0) {
+    record.append(data, header[1]);
+  }
+}
+
+bool read_value(const char *&data, const char *end, Value &value)
+{
+  int32_t header[2];
+  if (end - data < static_cast<ptrdiff_t>(sizeof(header))) {
+    return false;
+  }
+  memcpy(header, data, sizeof(header));
+  data += sizeof(header);
+  if (header[1] < 0 || end - data < header[1]) {
+    return false;
+  }
+
+  const AttrType attr_type = static_cast<AttrType>(header[0]);
+  switch (attr_type) {
+    case AttrType::NULLS: value.set_null(); break;
+    case AttrType::CHARS: {
+      // 长度为0时 set_string 会按照 strlen 计算长度，而 data 后面并不是 '\0'
+      value.set_string(header[1] > 0 ? data : "", header[1]);
+    } break;
+    case AttrType::BOOLEANS: value.set_boolean(data[0] != 0); break;
+    default: {
+      value.set_type(attr_type);
+      value.set_data(data, header[1]);
+    } break;
+  }
+  data += header[1];
+  return true;
+}
+
+constexpr size_t RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// class SortKeyEncoder
+
+void SortKeyEncoder::append(const Value &value, bool asc, string &key)
+{
+  const size_t begin = key.size();
+  if (value.is_null()) {
+    key.push_back(0);
+  } else {
+    key.push_back(1);
+    switch (value.attr_type()) {
+      case AttrType::INTS:
+      case AttrType::FLOATS:
+      case AttrType::DOUBLES: {
+        append_double(value.get_double(), key);
+      } break;
+      case AttrType::DATES: {
+        append_big_endian(static_cast<uint32_t>(value.get_int()) ^ (1U << 31), sizeof(uint32_t), key);
+      } break;
+      case AttrType::LONGS: {
+        append_big_endian(static_cast<uint64_t>(value.get_long()) ^ (1ULL << 63), sizeof(uint64_t), key);
+      } break;
+      case AttrType::BOOLEANS: {
+        key.push_back(value.get_boolean() ? 1 : 0);
+      } break;
+      default: {
+        append_bytes(value.data(), value.length(), key);
+      } break;
+    }
+  }
+
+  if (!asc) {
+    for (size_t i = begin; i < key.size(); i++) {
+      key[i] = static_cast<char>(~key[i]);
+    }
+  }
+}
+
+void SortKeyEncoder::encode(const vector<Value> &values, const vector<bool> &asc, string &key)
+{
+  ASSERT(values.size() == asc.size(), "sort key size mismatch");
+  for (size_t i = 0; i < values.size(); i++) {
+    append(values[i], asc[i], key);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class LoserTree
+
+void LoserTree::init(int ways, Less less)
+{
+  ways_ = ways;
+  less_ = std::move(less);
+  // nodes_[1..ways-1] 是内部节点，nodes_[0] 是胜者。-1 表示还没有参加比赛的位置，任何一路都可以战胜它
+  nodes_.assign(std::max(ways, 1), -1);
+  if (ways_ == 1) {
+    nodes_[0] = 0;
+    return;
+  }
+  for (int way = ways_ - 1; way >= 0; way--) {
+    replay(way);
+  }
+}
+
+void LoserTree::replay(int way)
+{
+  if (ways_ <= 1) {
+    return;
+  }
+
+  int winner = way;
+  for (int parent = (way + ways_) / 2; parent > 0; parent /= 2) {
+    int &loser = nodes_[parent];
+    if (loser == -1) {
+      // 初始化时另一边还没有选手，先留在这里等待比赛
+      loser  = winner;
+      winner = -1;
+      break;
+    }
+    if (less_(loser, winner)) {
+      std::swap(loser, winner);
+    }
+  }
+  if (winner != -1) {
+    nodes_[0] = winner;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class ExternalSorter::Run
+
+ExternalSorter::Run::~Run()
+{
+  if (file_ != nullptr) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+RC ExternalSorter::Run::open()
+{
+  // 临时文件关闭之后自动删除
+  file_ = tmpfile();
+  if (nullptr == file_) {
+    LOG_WARN("failed to create temporary file for sort. error=%s", strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::Run::write(string_view record)
+{
+  if (fwrite(record.data(), record.size(), 1, file_) != 1) {
+    LOG_WARN("failed to write sort temporary file. error=%s", strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::Run::rewind()
+{
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    LOG_WARN("failed to seek sort temporary file. error=%s", strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::Run::read(string &record)
+{
+  uint32_t sizes[2];
+  if (fread(sizes, sizeof(sizes), 1, file_) != 1) {
+    if (feof(file_)) {
+      return RC::RECORD_EOF;
+    }
+    LOG_WARN("failed to read sort temporary file. error=%s", strerror(errno));
+    return RC::IOERR_READ;
+  }
+
+  const size_t body_size = static_cast<size_t>(sizes[0]) + sizes[1];
+  record.resize(RECORD_HEADER_SIZE + body_size);
+  memcpy(record.data(), sizes, sizeof(sizes));
+  if (body_size > 0 && fread(record.data() + RECORD_HEADER_SIZE, body_size, 1, file_) != 1) {
+    LOG_WARN("failed to read sort temporary file. error=%s", strerror(errno));
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class ExternalSorter
+
+ExternalSorter::ExternalSorter(vector<bool> asc, const SortOptions &options, int64_t limit)
+    : asc_(std::move(asc)), options_(options), limit_(limit)
+{
+  options_.memory     = std::max(options_.memory, SortOptions::MIN_MEMORY);
+  options_.merge_ways = std::max(options_.merge_ways, SortOptions::MIN_MERGE_WAYS);
+}
+
+ExternalSorter::~ExternalSorter() { reset(); }
+
+void ExternalSorter::reset()
+{
+  arena_.clear();
+  offsets_.clear();
+  heap_.clear();
+  sources_.clear();
+  runs_.clear();
+  spilled_runs_ = 0;
+  rows_         = 0;
+  merging_      = false;
+  position_     = 0;
+}
+
+string_view ExternalSorter::key_of(string_view record)
+{
+  return record.substr(RECORD_HEADER_SIZE, read_uint32(record.data()));
+}
+
+int ExternalSorter::compare_records(string_view left, string_view right)
+{
+  return key_of(left).compare(key_of(right));
+}
+
+bool ExternalSorter::decode_payload(string_view record, vector<Value> &payload)
+{
+  const uint32_t key_size     = read_uint32(record.data());
+  const uint32_t payload_size = read_uint32(record.data() + sizeof(uint32_t));
+  const char    *data         = record.data() + RECORD_HEADER_SIZE + key_size;
+  const char    *end          = data + payload_size;
+
+  size_t count = 0;
+  while (data < end) {
+    if (count >= payload.size()) {
+      payload.emplace_back();
+    }
+    if (!read_value(data, end, payload[count++])) {
+      return false;
+    }
+  }
+  payload.resize(count);
+  return true;
+}
+
+void ExternalSorter::make_record(const vector<Value> &keys, const vector<Value> &payload, string &record)
+{
+  key_buffer_.clear();
+  SortKeyEncoder::encode(keys, asc_, key_buffer_);
+  if (limit_ >= 0) {
+    // 堆排序不稳定，在键值后面加上行号，键值相同时先添加的行在前面
+    append_big_endian(static_cast<uint64_t>(rows_), sizeof(uint64_t), key_buffer_);
+  }
+  rows_++;
+
+  const size_t begin = record.size();
+  append_uint32(static_cast<uint32_t>(key_buffer_.size()), record);
+  append_uint32(0, record);
+  record.append(key_buffer_);
+
+  const size_t payload_begin = record.size();
+  for (const Value &value : payload) {
+    append_value(value, record);
+  }
+  const uint32_t payload_size = static_cast<uint32_t>(record.size() - payload_begin);
+  memcpy(record.data() + begin + sizeof(uint32_t), &payload_size, sizeof(payload_size));
+}
+
+RC ExternalSorter::add(const vector<Value> &keys, const vector<Value> &payload)
+{
+  if (limit_ >= 0) {
+    if (limit_ == 0) {
+      return RC::SUCCESS;
+    }
+
+    // 最大堆，堆顶是当前保留的行中最大的一行，新的行比它小时才替换
+    auto less = [](const string &left, const string &right) { return compare_records(left, right) < 0; };
+    string record;
+    make_record(keys, payload, record);
+    if (static_cast<int64_t>(heap_.size()) < limit_) {
+      heap_.emplace_back(std::move(record));
+      std::push_heap(heap_.begin(), heap_.end(), less);
+    } else if (less(record, heap_.front())) {
+      std::pop_heap(heap_.begin(), heap_.end(), less);
+      heap_.back() = std::move(record);
+      std::push_heap(heap_.begin(), heap_.end(), less);
+    }
+    return RC::SUCCESS;
+  }
+
+  offsets_.push_back(arena_.size());
+  make_record(keys, payload, arena_);
+
+  const int64_t memory = static_cast<int64_t>(arena_.size() + offsets_.size() * sizeof(size_t));
+  if (memory >= options_.memory) {
+    return spill();
+  }
+  return RC::SUCCESS;
+}
+
+void ExternalSorter::sort_in_memory()
+{
+  const char *arena = arena_.data();
+  auto record_at = [arena](size_t offset) {
+    const uint32_t key_size = read_uint32(arena + offset);
+    return string_view(arena + offset + RECORD_HEADER_SIZE, key_size);
+  };
+  // 稳定排序，键值相同的行保持输入的顺序
+  std::stable_sort(offsets_.begin(), offsets_.end(), [&record_at](size_t left, size_t right) {
+    return record_at(left) < record_at(right);
+  });
+}
+
+RC ExternalSorter::spill()
+{
+  if (offsets_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  sort_in_memory();
+
+  auto run = std::make_unique<Run>();
+  RC   rc  = run->open();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  for (size_t offset : offsets_) {
+    const char *record = arena_.data() + offset;
+    const size_t size  = RECORD_HEADER_SIZE + read_uint32(record) + read_uint32(record + sizeof(uint32_t));
+    rc                 = run->write(string_view(record, size));
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  LOG_TRACE("sort spilled a run. rows=%zu, bytes=%zu", offsets_.size(), arena_.size());
+  runs_.emplace_back(std::move(run));
+  spilled_runs_++;
+  arena_.clear();
+  offsets_.clear();
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::finish()
+{
+  position_ = 0;
+  merging_  = false;
+
+  if (limit_ >= 0) {
+    auto less = [](const string &left, const string &right) { return compare_records(left, right) < 0; };
+    std::sort_heap(heap_.begin(), heap_.end(), less);
+    return RC::SUCCESS;
+  }
+
+  if (runs_.empty()) {
+    sort_in_memory();
+    return RC::SUCCESS;
+  }
+
+  RC rc = spill();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = reduce_runs();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = open_merge(runs_.size());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  merging_ = true;
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::open_merge(size_t count)
+{
+  sources_.clear();
+  sources_.resize(count);
+
+  RC rc = RC::SUCCESS;
+  for (size_t i = 0; i < count; i++) {
+    sources_[i].run = std::move(runs_[i]);
+    rc              = sources_[i].run->rewind();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    rc = advance(static_cast<int>(i));
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  runs_.erase(runs_.begin(), runs_.begin() + count);
+
+  // 已经结束的路比其它的都大，键值相同时编号小的一路(更早的顺串)在前面，保持排序稳定
+  tree_.init(static_cast<int>(count), [this](int left, int right) {
+    const MergeSource &left_source  = sources_[left];
+    const MergeSource &right_source = sources_[right];
+    if (left_source.eof || right_source.eof) {
+      return !left_source.eof;
+    }
+    const int result = compare_records(left_source.record, right_source.record);
+    return result < 0 || (result == 0 && left < right);
+  });
+  return RC::SUCCESS;
+}
+
+RC ExternalSorter::advance(int way)
+{
+  MergeSource &source = sources_[way];
+  RC           rc     = source.run->read(source.record);
+  if (rc == RC::RECORD_EOF) {
+    source.eof = true;
+    source.run.reset();
+    return RC::SUCCESS;
+  }
+  return rc;
+}
+
+RC ExternalSorter::reduce_runs()
+{
+  RC rc = RC::SUCCESS;
+  while (runs_.size() > static_cast<size_t>(options_.merge_ways)) {
+    // 每次归并的路数使得最后一轮正好是 merge_ways 路，减少中间结果的大小
+    const size_t count = std::min<size_t>(options_.merge_ways, runs_.size() - options_.merge_ways + 1);
+
+    auto run = std::make_unique<Run>();
+    rc       = run->open();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    rc = open_merge(count);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    for (int way = tree_.winner(); !sources_[way].eof; way = tree_.winner()) {
+      rc = run->write(sources_[way].record);
+      if (OB_SUCC(rc)) {
+        rc = advance(way);
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      tree_.replay(way);
+    }
+
+    LOG_TRACE("sort merged %zu runs into one", count);
+    // 归并出来的顺串由最早的几个顺串组成，放在最前面，保持排序稳定
+    sources_.clear();
+    runs_.insert(runs_.begin(), std::move(run));
+    spilled_runs_++;
+  }
+  return rc;
+}
+
+RC ExternalSorter::next(vector<Value> &payload)
+{
+  string_view record;
+  if (limit_ >= 0) {
+    if (position_ >= heap_.size()) {
+      return RC::RECORD_EOF;
+    }
+    record = heap_[position_++];
+  } else if (!merging_) {
+    if (position_ >= offsets_.size()) {
+      return RC::RECORD_EOF;
+    }
+    const char *data = arena_.data() + offsets_[position_++];
+    record = string_view(data, RECORD_HEADER_SIZE + read_uint32(data) + read_uint32(data + sizeof(uint32_t)));
+  } else {
+    const int way = tree_.winner();
+    if (sources_[way].eof) {
+      return RC::RECORD_EOF;
+    }
+    if (!decode_payload(sources_[way].record, payload)) {
+      LOG_WARN("failed to decode sort record");
+      return RC::INTERNAL;
+    }
+    RC rc = advance(way);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    tree_.replay(way);
+    return RC::SUCCESS;
+  }
+
+  if (!decode_payload(record, payload)) {
+    LOG_WARN("failed to decode sort record");
+    return RC::INTERNAL;
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,192 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/rc.h"
+#include "sql/parser/value.h"
+
+/**
+ * @brief 排序的配置，在配置文件的 [SQL] 中
+ * @ingroup PhysicalOperator
+ */
+struct SortOptions
+{
+  static constexpr int64_t DEFAULT_MEMORY     = 64L * 1024 * 1024;
+  static constexpr int64_t MIN_MEMORY         = 64L * 1024;
+  static constexpr int     DEFAULT_MERGE_WAYS = 64;
+  static constexpr int     MIN_MERGE_WAYS     = 2;
+
+  int64_t memory     = DEFAULT_MEMORY;      ///< 一个排序算子在内存中最多缓存多少数据，超过时写临时文件
+  int     merge_ways = DEFAULT_MERGE_WAYS;  ///< 一次最多归并多少个顺串
+
+  /**
+   * @brief 读取配置 SORT_MEMORY_MB 和 SORT_MERGE_WAYS
+   */
+  static SortOptions from_config();
+};
+
+/**
+ * @brief 把排序字段编码成可以直接使用 memcmp 比较的字节串
+ * @ingroup PhysicalOperator
+ * @details 每个字段先是一个字节的NULL标记，NULL是0，其它是1，所以升序时NULL在最前面。然后是字段的值：
+ * - 数值(整数、浮点数)都转换成 double，与 Value::compare 比较不同类型的数值的方式相同。
+ *   正数翻转符号位，负数所有的位取反，再按照大端存放；
+ * - 日期是整数，翻转符号位之后按照大端存放；
+ * - 字符串中的0x00写成0x00 0xFF，最后以0x00 0x00结束，短的字符串排在以它为前缀的字符串前面。
+ * 降序的字段把这个字段编码之后的所有字节取反。因为每个字段的编码都不是其它编码的前缀，取反之后顺序正好相反。
+ */
+class SortKeyEncoder
+{
+public:
+  /// 把一个字段编码之后追加到 key 后面
+  static void append(const Value &value, bool asc, std::string &key);
+
+  /// 依次编码多个字段，asc 与 values 一一对应
+  static void encode(const std::vector<Value> &values, const std::vector<bool> &asc, std::string &key);
+};
+
+/**
+ * @brief 败者树，用于多路归并
+ * @ingroup PhysicalOperator
+ * @details 内部节点记录比赛的败者，根节点之上记录最终的胜者。
+ * 某一路的当前元素变化之后，只需要沿着这一路到根节点的路径重新比赛，每次取出最小元素需要 log2(k) 次比较。
+ * 比较函数由调用者提供，已经结束的路应该比其它所有的路都大。
+ */
+class LoserTree
+{
+public:
+  /// less(a, b) 表示第a路当前的元素是否应该排在第b路前面
+  using Less = std::function<bool(int, int)>;
+
+  void init(int ways, Less less);
+
+  /// 当前最小的是哪一路
+  int winner() const { return nodes_[0]; }
+
+  /// 第 way 路的当前元素变化之后重新比赛
+  void replay(int way);
+
+private:
+  int               ways_ = 0;
+  std::vector<int>  nodes_;
+  Less              less_;
+};
+
+/**
+ * @brief 外部排序
+ * @ingroup PhysicalOperator
+ * @details 每一行是一组排序字段和一组输出的值(payload)。排序字段使用 SortKeyEncoder 编码成字节串，
+ * 与 payload 一起序列化之后存放在一块连续的内存(arena)中，只对记录的偏移排序，比较时只需要 memcmp。
+ * 内存中的数据超过 SortOptions::memory 时，把这些行排好序作为一个顺串写到临时文件中。
+ * 所有的行都添加之后，如果写过临时文件，剩下的行也作为一个顺串写出去，再使用败者树多路归并所有的顺串。
+ * 顺串超过 SortOptions::merge_ways 个时，先把最早的几个顺串归并成一个更大的顺串。
+ * 键值相同的行按照添加的顺序输出(稳定排序)。
+ *
+ * 指定了 limit 时(ORDER BY ... LIMIT)只需要最小的 limit 行，使用一个大小为 limit 的最大堆，不需要完整排序，也不会写临时文件。
+ */
+class ExternalSorter
+{
+public:
+  /**
+   * @param asc 每个排序字段是否升序
+   * @param limit 只输出排在最前面的多少行，小于0表示不限制
+   */
+  ExternalSorter(std::vector<bool> asc, const SortOptions &options, int64_t limit = -1);
+  ~ExternalSorter();
+
+  /// 添加一行
+  RC add(const std::vector<Value> &keys, const std::vector<Value> &payload);
+
+  /// 所有的行都添加完了，准备输出
+  RC finish();
+
+  /// 按照顺序输出下一行的 payload，没有更多的行时返回 RECORD_EOF
+  RC next(std::vector<Value> &payload);
+
+  /// 清除所有的数据和临时文件，可以重新添加
+  void reset();
+
+  /// 写到临时文件中的顺串的个数，包括归并过程中产生的顺串
+  int spilled_runs() const { return spilled_runs_; }
+
+private:
+  /// 临时文件中的一个顺串，记录的格式与内存中相同
+  class Run
+  {
+  public:
+    Run() = default;
+    ~Run();
+
+    RC open();
+    RC write(std::string_view record);
+    RC rewind();
+    /// 读取下一条记录到 record 中，没有更多的记录时返回 RECORD_EOF
+    RC read(std::string &record);
+
+  private:
+    FILE *file_ = nullptr;
+  };
+
+  /// 多路归并时的一路
+  struct MergeSource
+  {
+    std::unique_ptr<Run> run;
+    std::string          record;  ///< 当前的记录
+    bool                 eof = false;
+  };
+
+private:
+  /// 把一行序列化之后追加到 record 中：键值长度、payload长度、键值、payload
+  void make_record(const std::vector<Value> &keys, const std::vector<Value> &payload, std::string &record);
+
+  /// 把内存中的行排好序写到一个新的顺串中
+  RC spill();
+  /// 内存中的行按照键值排序
+  void sort_in_memory();
+
+  /// 归并 runs_ 中 [0, count) 这几个顺串，初始化 sources_
+  RC open_merge(size_t count);
+  /// 读取 sources_ 中第 way 路的下一条记录
+  RC advance(int way);
+  /// 不停地归并最早的几个顺串，直到顺串的个数不超过 merge_ways
+  RC reduce_runs();
+
+  static std::string_view key_of(std::string_view record);
+  static bool             decode_payload(std::string_view record, std::vector<Value> &payload);
+  static int              compare_records(std::string_view left, std::string_view right);
+
+private:
+  std::vector<bool> asc_;
+  SortOptions       options_;
+  int64_t           limit_ = -1;
+
+  std::string         key_buffer_;
+  std::string         arena_;    ///< 内存中的记录
+  std::vector<size_t> offsets_;  ///< 每条记录在 arena_ 中的偏移
+
+  std::vector<std::string> heap_;  ///< limit 大于等于0时的最大堆
+
+  std::vector<std::unique_ptr<Run>> runs_;  ///< 还没有归并的顺串
+  std::vector<MergeSource>          sources_;
+  LoserTree                         tree_;
+  int                               spilled_runs_ = 0;
+  int64_t                           rows_         = 0;  ///< 添加了多少行
+
+  bool   merging_  = false;  ///< 是否从 sources_ 中归并输出
+  size_t position_ = 0;      ///< 在内存中输出时，下一个输出的下标
+};
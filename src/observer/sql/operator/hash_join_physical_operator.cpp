@@ -0,0 +1,724 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/hash_join_physical_operator.h"
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
+#include "common/lang/string_view.h"
+#include "common/log/log.h"
+#include "sql/operator/join_physical_operator.h"
+
+HashJoinOptions HashJoinOptions::from_config()
+{
+  HashJoinOptions options;
+
+  const char *section    = "SQL";
+  string      enabled    = common::get_properties()->get("HASH_JOIN", "", section);
+  string      memory     = common::get_properties()->get("HASH_JOIN_MEMORY_MB", "", section);
+  string      partitions = common::get_properties()->get("HASH_JOIN_PARTITIONS", "", section);
+  if (!enabled.empty()) {
+    options.enabled = (enabled == "true" || enabled == "1");
+  }
+  if (!memory.empty()) {
+    int64_t memory_mb = 0;
+    common::str_to_val(memory, memory_mb);
+    if (memory_mb > 0) {
+      options.memory = memory_mb * 1024 * 1024;
+    }
+  }
+  if (!partitions.empty()) {
+    common::str_to_val(partitions, options.partitions);
+  }
+  options.partitions = clamp(options.partitions, 2, MAX_PARTITIONS);
+  return options;
+}
+
+namespace {
+
+size_t mix_hash(size_t h)
+{
+  // murmur3 的 fmix64，让高位和低位都足够分散，分区和哈希表的桶分别使用
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+size_t hash_value(const Value &value)
+{
+  switch (value.attr_type()) {
+    case AttrType::NULLS: return 0;
+    case AttrType::BOOLEANS: return value.get_boolean() ? 1 : 2;
+    default: return std::hash<string_view>()(string_view(value.data(), value.length()));
+  }
+}
+
+size_t hash_keys(const vector<Value> &keys)
+{
+  size_t hash = 0;
+  for (const Value &key : keys) {
+    hash ^= hash_value(key) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  }
+  return mix_hash(hash);
+}
+
+/// 一行数据缓存在内存中大概占用的空间
+int64_t row_memory(const vector<Value> &keys, const vector<Value> &cells)
+{
+  int64_t bytes = static_cast<int64_t>(sizeof(size_t) + 2 * sizeof(vector<Value>) +
+                                       (keys.size() + cells.size()) * sizeof(Value));
+  for (const Value &cell : cells) {
+    if (cell.attr_type() == AttrType::CHARS) {
+      bytes += cell.length();
+    }
+  }
+  return bytes;
+}
+
+bool write_value(FILE *file, const Value &value)
+{
+  int32_t header[2] = {static_cast<int32_t>(value.attr_type()), 0};
+  char    bool_value = 0;
+
+  const char *data = nullptr;
+  switch (value.attr_type()) {
+    case AttrType::NULLS: break;
+    case AttrType::BOOLEANS: {
+      bool_value = value.get_boolean() ? 1 : 0;
+      data       = &bool_value;
+      header[1]  = 1;
+    } break;
+    default: {
+      data      = value.data();
+      header[1] = value.length();
+    } break;
+  }
+
+  if (fwrite(header, sizeof(header), 1, file) != 1) {
+    return false;
+  }
+  return header[1] == 0 || fwrite(data, header[1], 1, file) == 1;
+}
+
+bool read_value(FILE *file, Value &value, string &buffer)
+{
+  int32_t header[2];
+  if (fread(header, sizeof(header), 1, file) != 1) {
+    return false;
+  }
+
+  buffer.resize(header[1]);
+  if (header[1] > 0 && fread(buffer.data(), header[1], 1, file) != 1) {
+    return false;
+  }
+
+  const AttrType attr_type = static_cast<AttrType>(header[0]);
+  switch (attr_type) {
+    case AttrType::NULLS: value.set_null(); break;
+    case AttrType::CHARS: value.set_string(buffer.c_str(), header[1]); break;
+    case AttrType::BOOLEANS: value.set_boolean(buffer[0] != 0); break;
+    default: {
+      value.set_type(attr_type);
+      value.set_data(buffer.data(), header[1]);
+    } break;
+  }
+  return true;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// class HashJoinPhysicalOperator::SpillFile
+
+HashJoinPhysicalOperator::SpillFile::~SpillFile()
+{
+  if (file_ != nullptr) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+RC HashJoinPhysicalOperator::SpillFile::open()
+{
+  // 临时文件关闭之后自动删除
+  file_ = tmpfile();
+  if (nullptr == file_) {
+    LOG_WARN("failed to create temporary file for hash join. error=%s", strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::SpillFile::write(const JoinRow &row)
+{
+  const uint64_t hash         = row.hash;
+  const int32_t  sizes[2]     = {static_cast<int32_t>(row.keys.size()), static_cast<int32_t>(row.cells.size())};
+  bool           write_result = fwrite(&hash, sizeof(hash), 1, file_) == 1 && fwrite(sizes, sizeof(sizes), 1, file_) == 1;
+  for (const Value &key : row.keys) {
+    write_result = write_result && write_value(file_, key);
+  }
+  for (const Value &cell : row.cells) {
+    write_result = write_result && write_value(file_, cell);
+  }
+  if (!write_result) {
+    LOG_WARN("failed to write hash join temporary file. error=%s", strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+
+  rows_++;
+  bytes_ += row_memory(row.keys, row.cells);
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::SpillFile::rewind()
+{
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    LOG_WARN("failed to rewind hash join temporary file. error=%s", strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::SpillFile::read(JoinRow &row)
+{
+  uint64_t hash = 0;
+  if (fread(&hash, sizeof(hash), 1, file_) != 1) {
+    if (feof(file_)) {
+      return RC::RECORD_EOF;
+    }
+    LOG_WARN("failed to read hash join temporary file. error=%s", strerror(errno));
+    return RC::IOERR_READ;
+  }
+
+  int32_t sizes[2];
+  bool    read_result = fread(sizes, sizeof(sizes), 1, file_) == 1;
+  string  buffer;
+  row.hash = hash;
+  row.keys.resize(read_result ? sizes[0] : 0);
+  row.cells.resize(read_result ? sizes[1] : 0);
+  for (Value &key : row.keys) {
+    read_result = read_result && read_value(file_, key, buffer);
+  }
+  for (Value &cell : row.cells) {
+    read_result = read_result && read_value(file_, cell, buffer);
+  }
+  if (!read_result) {
+    LOG_WARN("failed to read hash join temporary file. error=%s", strerror(errno));
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class HashJoinPhysicalOperator
+
+HashJoinPhysicalOperator::HashJoinPhysicalOperator(
+    vector<unique_ptr<Expression>> &&left_keys, vector<unique_ptr<Expression>> &&right_keys, const HashJoinOptions &options)
+    : options_(options)
+{
+  ASSERT(left_keys.size() == right_keys.size() && !left_keys.empty(), "invalid hash join keys");
+  keys_[LEFT]  = std::move(left_keys);
+  keys_[RIGHT] = std::move(right_keys);
+}
+
+HashJoinPhysicalOperator::~HashJoinPhysicalOperator() { reset(); }
+
+string HashJoinPhysicalOperator::param() const { return join_keys_to_string(keys_[LEFT], keys_[RIGHT]); }
+
+RC HashJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  reset();
+  spilled_ = false;
+
+  RC rc = RC::SUCCESS;
+  for (int side : {LEFT, RIGHT}) {
+    rc = children_[side]->open(trx);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to open child of hash join. side=%d, rc=%s", side, strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = read_until_smaller_done();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (!child_eof_[LEFT] && !child_eof_[RIGHT]) {
+    // 两边都没有读完就超过了内存限制，剩下的数据也都写到临时文件中，由 next 逐个分区处理
+    return spill_all();
+  }
+
+  if (child_eof_[LEFT] && child_eof_[RIGHT]) {
+    build_side_ = (buffered_[LEFT].size() <= buffered_[RIGHT].size()) ? LEFT : RIGHT;
+  } else {
+    build_side_ = child_eof_[LEFT] ? LEFT : RIGHT;
+  }
+  probe_side_ = 1 - build_side_;
+
+  build_rows_.swap(buffered_[build_side_]);
+  build_hash_table(build_side_);
+  probe_source_ = ProbeSource::BUFFERED;
+  LOG_TRACE("hash join build on side %d in memory. build rows=%d", build_side_, static_cast<int>(build_rows_.size()));
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (next_match()) {
+      return RC::SUCCESS;
+    }
+
+    rc = build_rows_.empty() ? RC::RECORD_EOF : next_probe_row();
+    if (rc == RC::RECORD_EOF) {
+      // 当前的数据处理完了，再看看还有没有写到临时文件中的分区
+      rc = load_next_partition();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    match_index_ = bucket_heads_[probe_->hash & bucket_mask_];
+  }
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::close()
+{
+  RC rc = RC::SUCCESS;
+  for (unique_ptr<PhysicalOperator> &child : children_) {
+    RC child_rc = child->close();
+    if (OB_FAIL(child_rc)) {
+      LOG_WARN("failed to close child of hash join. rc=%s", strrc(child_rc));
+      rc = child_rc;
+    }
+  }
+
+  reset();
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::read_child(int side, Tuple *&tuple)
+{
+  RC rc = children_[side]->next();
+  if (OB_FAIL(rc)) {
+    if (rc == RC::RECORD_EOF) {
+      child_eof_[side] = true;
+    } else {
+      LOG_WARN("failed to get next tuple from child of hash join. side=%d, rc=%s", side, strrc(rc));
+    }
+    return rc;
+  }
+
+  tuple = children_[side]->current_tuple();
+  if (nullptr == tuple) {
+    LOG_WARN("failed to get current tuple from child of hash join. side=%d", side);
+    return RC::INTERNAL;
+  }
+
+  if (specs_[side].empty()) {
+    const int cell_num = tuple->cell_num();
+    for (int i = 0; i < cell_num; i++) {
+      TupleCellSpec spec;
+      rc = tuple->spec_at(i, spec);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get tuple cell spec. side=%d, index=%d, rc=%s", side, i, strrc(rc));
+        return rc;
+      }
+      specs_[side].push_back(spec);
+    }
+    row_tuples_[side].set_names(specs_[side]);
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::make_keys(int side, const Tuple &tuple, JoinRow &row)
+{
+  vector<unique_ptr<Expression>> &keys = keys_[side];
+  row.keys.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    RC rc = keys[i]->get_value(tuple, row.keys[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get value of hash join key. side=%d, rc=%s", side, strrc(rc));
+      return rc;
+    }
+  }
+  row.hash = hash_keys(row.keys);
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::make_row(int side, const Tuple &tuple, JoinRow &row)
+{
+  RC rc = make_keys(side, tuple, row);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const int cell_num = tuple.cell_num();
+  row.cells.resize(cell_num);
+  for (int i = 0; i < cell_num; i++) {
+    rc = tuple.cell_at(i, row.cells[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get tuple cell. side=%d, index=%d, rc=%s", side, i, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+bool HashJoinPhysicalOperator::keys_equal(const vector<Value> &left, const vector<Value> &right) const
+{
+  for (size_t i = 0; i < left.size(); i++) {
+    if (left[i].compare(right[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC HashJoinPhysicalOperator::read_until_smaller_done()
+{
+  RC rc = RC::SUCCESS;
+  while (!child_eof_[LEFT] && !child_eof_[RIGHT] && buffered_bytes_ <= options_.memory) {
+    for (int side : {LEFT, RIGHT}) {
+      Tuple *tuple = nullptr;
+      rc           = read_child(side, tuple);
+      if (rc == RC::RECORD_EOF) {
+        break;
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+
+      JoinRow row;
+      rc = make_row(side, *tuple, row);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      buffered_bytes_ += row_memory(row.keys, row.cells);
+      buffered_[side].emplace_back(std::move(row));
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void HashJoinPhysicalOperator::build_hash_table(int build_side)
+{
+  size_t bucket_num = 1;
+  while (bucket_num < build_rows_.size()) {
+    bucket_num <<= 1;
+  }
+  bucket_mask_ = bucket_num - 1;
+  bucket_heads_.assign(bucket_num, -1);
+  next_in_bucket_.resize(build_rows_.size());
+  for (size_t i = 0; i < build_rows_.size(); i++) {
+    int &head          = bucket_heads_[build_rows_[i].hash & bucket_mask_];
+    next_in_bucket_[i] = head;
+    head               = static_cast<int>(i);
+  }
+  match_index_ = -1;
+}
+
+bool HashJoinPhysicalOperator::next_match()
+{
+  while (match_index_ != -1) {
+    const JoinRow &row = build_rows_[match_index_];
+    match_index_       = next_in_bucket_[match_index_];
+    if (row.hash == probe_->hash && keys_equal(row.keys, probe_->keys)) {
+      set_row_tuple(build_side_, row);
+      return true;
+    }
+  }
+  return false;
+}
+
+RC HashJoinPhysicalOperator::next_probe_row()
+{
+  RC rc = RC::SUCCESS;
+  switch (probe_source_) {
+    case ProbeSource::BUFFERED: {
+      vector<JoinRow> &rows = buffered_[probe_side_];
+      if (buffered_index_ < rows.size()) {
+        probe_ = &rows[buffered_index_++];
+        set_row_tuple(probe_side_, *probe_);
+        return RC::SUCCESS;
+      }
+
+      rows.clear();
+      rows.shrink_to_fit();
+      probe_source_ = ProbeSource::CHILD;
+      return next_probe_row();
+    } break;
+
+    case ProbeSource::CHILD: {
+      if (child_eof_[probe_side_]) {
+        return RC::RECORD_EOF;
+      }
+
+      Tuple *tuple = nullptr;
+      rc           = read_child(probe_side_, tuple);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+
+      rc = make_keys(probe_side_, *tuple, probe_row_);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      probe_ = &probe_row_;
+      set_joined_tuple(probe_side_, tuple);
+    } break;
+
+    case ProbeSource::SPILL: {
+      rc = current_partition_->files[probe_side_]->read(probe_row_);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      probe_ = &probe_row_;
+      set_row_tuple(probe_side_, probe_row_);
+    } break;
+  }
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::spill_all()
+{
+  spilled_ = true;
+
+  vector<unique_ptr<SpillPartition>> partitions;
+  RC                                 rc = create_partitions(0 /*level*/, partitions);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  for (int side : {LEFT, RIGHT}) {
+    for (const JoinRow &row : buffered_[side]) {
+      rc = write_to_partition(side, 0 /*level*/, row, partitions);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    buffered_[side].clear();
+    buffered_[side].shrink_to_fit();
+
+    rc = spill_child(side, partitions);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  buffered_bytes_ = 0;
+
+  for (unique_ptr<SpillPartition> &partition : partitions) {
+    pending_partitions_.emplace_back(std::move(partition));
+  }
+  LOG_INFO("hash join spilled to %d partitions", options_.partitions);
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::spill_child(int side, vector<unique_ptr<SpillPartition>> &partitions)
+{
+  RC      rc = RC::SUCCESS;
+  JoinRow row;
+  while (!child_eof_[side]) {
+    Tuple *tuple = nullptr;
+    rc           = read_child(side, tuple);
+    if (rc == RC::RECORD_EOF) {
+      break;
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    rc = make_row(side, *tuple, row);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    rc = write_to_partition(side, 0 /*level*/, row, partitions);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  for (unique_ptr<SpillPartition> &partition : partitions) {
+    rc = partition->files[side]->rewind();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::create_partitions(int level, vector<unique_ptr<SpillPartition>> &partitions)
+{
+  partitions.clear();
+  for (int i = 0; i < options_.partitions; i++) {
+    auto partition   = make_unique<SpillPartition>();
+    partition->level = level;
+    for (int side : {LEFT, RIGHT}) {
+      partition->files[side] = make_unique<SpillFile>();
+      RC rc                  = partition->files[side]->open();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    partitions.emplace_back(std::move(partition));
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::write_to_partition(
+    int side, int level, const JoinRow &row, vector<unique_ptr<SpillPartition>> &partitions)
+{
+  return partitions[partition_of(row.hash, level)]->files[side]->write(row);
+}
+
+RC HashJoinPhysicalOperator::load_next_partition()
+{
+  current_partition_.reset();
+  build_rows_.clear();
+  probe_       = nullptr;
+  match_index_ = -1;
+
+  RC rc = RC::SUCCESS;
+  while (!pending_partitions_.empty()) {
+    unique_ptr<SpillPartition> partition = std::move(pending_partitions_.front());
+    pending_partitions_.pop_front();
+
+    SpillFile &left_file  = *partition->files[LEFT];
+    SpillFile &right_file = *partition->files[RIGHT];
+    if (left_file.rows() == 0 || right_file.rows() == 0) {
+      continue;
+    }
+
+    const int build_side = (left_file.bytes() <= right_file.bytes()) ? LEFT : RIGHT;
+    if (partition->files[build_side]->bytes() > options_.memory && partition->level < MAX_SPILL_LEVEL) {
+      rc = repartition(*partition);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    }
+
+    build_rows_.reserve(partition->files[build_side]->rows());
+    while (true) {
+      JoinRow row;
+      rc = partition->files[build_side]->read(row);
+      if (rc == RC::RECORD_EOF) {
+        break;
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      build_rows_.emplace_back(std::move(row));
+    }
+
+    build_side_ = build_side;
+    probe_side_ = 1 - build_side;
+    build_hash_table(build_side_);
+    probe_source_      = ProbeSource::SPILL;
+    current_partition_ = std::move(partition);
+    return RC::SUCCESS;
+  }
+  return RC::RECORD_EOF;
+}
+
+RC HashJoinPhysicalOperator::repartition(SpillPartition &partition)
+{
+  const int                          level = partition.level + 1;
+  vector<unique_ptr<SpillPartition>> partitions;
+  RC                                 rc = create_partitions(level, partitions);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  JoinRow row;
+  for (int side : {LEFT, RIGHT}) {
+    while (OB_SUCC(rc = partition.files[side]->read(row))) {
+      rc = write_to_partition(side, level, row, partitions);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+
+    for (unique_ptr<SpillPartition> &sub_partition : partitions) {
+      rc = sub_partition->files[side]->rewind();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+
+  for (unique_ptr<SpillPartition> &sub_partition : partitions) {
+    pending_partitions_.emplace_back(std::move(sub_partition));
+  }
+  LOG_TRACE("repartition hash join partition. level=%d", level);
+  return RC::SUCCESS;
+}
+
+int HashJoinPhysicalOperator::partition_of(size_t hash, int level) const
+{
+  // 每一层使用不同的哈希值，同一个分区中的数据在下一层可以分开
+  return static_cast<int>(mix_hash(hash + static_cast<size_t>(level)) % options_.partitions);
+}
+
+void HashJoinPhysicalOperator::set_row_tuple(int side, const JoinRow &row)
+{
+  row_tuples_[side].set_cells(row.cells);
+  set_joined_tuple(side, &row_tuples_[side]);
+}
+
+void HashJoinPhysicalOperator::set_joined_tuple(int side, Tuple *tuple)
+{
+  if (side == LEFT) {
+    joined_tuple_.set_left(tuple);
+  } else {
+    joined_tuple_.set_right(tuple);
+  }
+}
+
+void HashJoinPhysicalOperator::reset()
+{
+  for (int side : {LEFT, RIGHT}) {
+    child_eof_[side] = false;
+    buffered_[side].clear();
+    specs_[side].clear();
+  }
+  buffered_bytes_ = 0;
+
+  build_rows_.clear();
+  bucket_heads_.clear();
+  next_in_bucket_.clear();
+  bucket_mask_ = 0;
+
+  probe_source_   = ProbeSource::BUFFERED;
+  buffered_index_ = 0;
+  probe_          = nullptr;
+  match_index_    = -1;
+
+  pending_partitions_.clear();
+  current_partition_.reset();
+}
@@ -0,0 +1,191 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdio>
+#include <deque>
+
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 哈希连接的参数
+ * @ingroup PhysicalOperator
+ * @details 从配置文件的 [SQL] 中读取
+ */
+struct HashJoinOptions
+{
+  static constexpr int64_t DEFAULT_MEMORY     = 64L * 1024 * 1024;
+  static constexpr int     DEFAULT_PARTITIONS = 16;
+  static constexpr int     MAX_PARTITIONS     = 256;
+
+  bool    enabled    = true;                ///< 有等值连接条件时是否使用哈希连接
+  int64_t memory     = DEFAULT_MEMORY;      ///< 一个哈希连接算子在内存中最多缓存多少数据
+  int     partitions = DEFAULT_PARTITIONS;  ///< 数据超过内存限制时，写到多少个临时文件中
+
+  /**
+   * @brief 读取配置 HASH_JOIN、HASH_JOIN_MEMORY_MB 和 HASH_JOIN_PARTITIONS
+   */
+  static HashJoinOptions from_config();
+};
+
+/**
+ * @brief 等值连接的哈希连接算子
+ * @ingroup PhysicalOperator
+ * @details 使用等值条件中的字段计算哈希值，较小的一边(构建端)放到内存的哈希表中，
+ * 另一边(探测端)逐行查找哈希表。
+ * 打开的时候交替读取左右两个孩子，先读完的一边就是较小的一边，作为构建端，
+ * 另一边已经读出来的数据先探测，剩下的直接从孩子算子中读取，不再缓存。
+ * 两边缓存的数据超过内存限制时，使用 grace hash join：把两边的数据都按照哈希值分区写到临时文件中，
+ * 每次处理一个分区，每个分区也是较小的一边作为构建端。分区仍然放不下时再按照哈希值的其它位继续分区，
+ * 最多分 MAX_SPILL_LEVEL 层，之后不再拆分(通常是大量重复的键值)。
+ * 输出的行总是左孩子在前，右孩子在后，与 NestedLoopJoinPhysicalOperator 相同。
+ * 与 ComparisonExpr 一致，两个NULL认为相等。
+ * 只支持按行处理，当前按批处理的执行模式不支持连接。
+ */
+class HashJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  static constexpr int MAX_SPILL_LEVEL = 3;
+
+  /**
+   * @param left_keys 左孩子的连接字段
+   * @param right_keys 右孩子的连接字段，与 left_keys 一一对应
+   */
+  HashJoinPhysicalOperator(std::vector<std::unique_ptr<Expression>> &&left_keys,
+      std::vector<std::unique_ptr<Expression>> &&right_keys, const HashJoinOptions &options);
+  virtual ~HashJoinPhysicalOperator();
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN; }
+  std::string          param() const override;
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override { return &joined_tuple_; }
+
+  /// 最近一次执行时数据是否写到了临时文件中
+  bool spilled() const { return spilled_; }
+  /// 最近一次执行时使用哪一边构建哈希表，0是左孩子，1是右孩子。数据写到临时文件时每个分区可能不同
+  int  build_side() const { return build_side_; }
+
+private:
+  static constexpr int LEFT  = 0;
+  static constexpr int RIGHT = 1;
+
+  /// 缓存下来的一行数据
+  struct JoinRow
+  {
+    size_t             hash = 0;
+    std::vector<Value> keys;
+    std::vector<Value> cells;
+  };
+
+  /// 一个临时文件，依次存放 JoinRow
+  class SpillFile
+  {
+  public:
+    SpillFile() = default;
+    ~SpillFile();
+
+    RC open();
+    RC write(const JoinRow &row);
+    /// 写完之后从头开始读
+    RC rewind();
+    /// @return RECORD_EOF 读完了
+    RC read(JoinRow &row);
+
+    int64_t rows() const { return rows_; }
+    int64_t bytes() const { return bytes_; }
+
+  private:
+    FILE   *file_  = nullptr;
+    int64_t rows_  = 0;
+    int64_t bytes_ = 0;  ///< 这些行缓存在内存中大概占用的空间
+  };
+
+  /// 写到临时文件中的一个分区，包括两边的数据
+  struct SpillPartition
+  {
+    int                   level = 0;
+    std::unique_ptr<SpillFile> files[2];
+  };
+
+  /// 探测端的下一行从哪里来
+  enum class ProbeSource
+  {
+    BUFFERED,  ///< 打开时缓存下来的行
+    CHILD,     ///< 直接从孩子算子读取
+    SPILL,     ///< 当前分区的临时文件
+  };
+
+private:
+  RC   read_child(int side, Tuple *&tuple);
+  RC   make_keys(int side, const Tuple &tuple, JoinRow &row);
+  RC   make_row(int side, const Tuple &tuple, JoinRow &row);
+  bool keys_equal(const std::vector<Value> &left, const std::vector<Value> &right) const;
+
+  /// 交替读取两个孩子，直到一边读完或者超过内存限制
+  RC read_until_smaller_done();
+
+  void build_hash_table(int build_side);
+  /// 从 match_index_ 开始找下一个匹配当前探测行的构建端行
+  bool next_match();
+  RC   next_probe_row();
+
+  /// 把缓存的数据和孩子中剩下的数据都写到临时文件中
+  RC spill_all();
+  RC spill_child(int side, std::vector<std::unique_ptr<SpillPartition>> &partitions);
+  RC create_partitions(int level, std::vector<std::unique_ptr<SpillPartition>> &partitions);
+  RC write_to_partition(int side, int level, const JoinRow &row, std::vector<std::unique_ptr<SpillPartition>> &partitions);
+  /// 加载下一个需要处理的分区，没有分区了返回 RECORD_EOF
+  RC load_next_partition();
+  RC repartition(SpillPartition &partition);
+
+  int partition_of(size_t hash, int level) const;
+
+  /// 输出缓存的一行，side 是这一行来自哪个孩子
+  void set_row_tuple(int side, const JoinRow &row);
+  void set_joined_tuple(int side, Tuple *tuple);
+  void reset();
+
+private:
+  HashJoinOptions options_;
+
+  std::vector<std::unique_ptr<Expression>> keys_[2];
+  std::vector<TupleCellSpec>               specs_[2];  ///< 缓存行的字段名字，从孩子的第一行获取
+
+  bool                 child_eof_[2] = {false, false};
+  std::vector<JoinRow> buffered_[2];  ///< 打开时从两边读出来的数据
+  int64_t              buffered_bytes_ = 0;
+
+  int build_side_ = RIGHT;
+  int probe_side_ = LEFT;
+
+  /// 构建端的数据和哈希表，哈希表使用链表解决冲突，链表中存放的是 build_rows_ 的下标
+  std::vector<JoinRow> build_rows_;
+  std::vector<int>     bucket_heads_;
+  std::vector<int>     next_in_bucket_;
+  size_t               bucket_mask_ = 0;
+
+  ProbeSource probe_source_   = ProbeSource::BUFFERED;
+  size_t      buffered_index_ = 0;
+  JoinRow     probe_row_;             ///< 从孩子或者临时文件中读出来的探测行
+  const JoinRow *probe_      = nullptr;  ///< 当前的探测行
+  int            match_index_ = -1;
+
+  std::deque<std::unique_ptr<SpillPartition>> pending_partitions_;
+  std::unique_ptr<SpillPartition>             current_partition_;
+  bool                                        spilled_ = false;
+
+  ValueListTuple row_tuples_[2];  ///< 缓存行对应的 tuple
+  JoinedTuple    joined_tuple_;
+};
@@ -0,0 +1,271 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/index_nested_loop_join_physical_operator.h"
+#include "common/lang/algorithm.h"
+#include "common/log/log.h"
+#include "sql/operator/join_physical_operator.h"
+
+IndexNestedLoopJoinPhysicalOperator::IndexNestedLoopJoinPhysicalOperator(int inner_side,
+    std::vector<std::unique_ptr<Expression>> &&left_keys, std::vector<std::unique_ptr<Expression>> &&right_keys)
+    : inner_side_(inner_side), outer_side_(1 - inner_side)
+{
+  ASSERT(left_keys.size() == right_keys.size() && !left_keys.empty(), "invalid index nested loop join keys");
+  if (inner_side_ == 0) {
+    inner_keys_ = std::move(left_keys);
+    outer_keys_ = std::move(right_keys);
+  } else {
+    outer_keys_ = std::move(left_keys);
+    inner_keys_ = std::move(right_keys);
+  }
+}
+
+std::string IndexNestedLoopJoinPhysicalOperator::param() const
+{
+  return inner_side_ == 0 ? join_keys_to_string(inner_keys_, outer_keys_) : join_keys_to_string(outer_keys_, inner_keys_);
+}
+
+RC IndexNestedLoopJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2 || children_[inner_side_]->type() != PhysicalOperatorType::INDEX_SCAN) {
+    LOG_WARN("index nested loop join operator should have 2 children and the inner one should be an index scan");
+    return RC::INTERNAL;
+  }
+
+  trx_        = trx;
+  inner_      = static_cast<IndexScanPhysicalOperator *>(children_[inner_side_].get());
+  inner_open_ = false;
+  outer_eof_  = false;
+  outer_rows_.clear();
+  sorted_rows_.clear();
+  null_rows_.clear();
+  matches_.clear();
+  match_pos_ = 0;
+
+  RC rc = children_[outer_side_]->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open outer child of index nested loop join. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC IndexNestedLoopJoinPhysicalOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    while (match_pos_ < matches_.size()) {
+      OuterRow &row = outer_rows_[matches_[match_pos_++]];
+      if (!other_keys_equal(row)) {
+        continue;
+      }
+
+      if (outer_side_ == 0) {
+        joined_tuple_.set_left(&row.tuple);
+        joined_tuple_.set_right(inner_->current_tuple());
+      } else {
+        joined_tuple_.set_left(inner_->current_tuple());
+        joined_tuple_.set_right(&row.tuple);
+      }
+      return RC::SUCCESS;
+    }
+
+    rc = inner_open_ ? next_inner_row() : RC::RECORD_EOF;
+    if (rc == RC::RECORD_EOF) {
+      rc = next_batch();
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC IndexNestedLoopJoinPhysicalOperator::close()
+{
+  RC rc = close_inner();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to close inner child of index nested loop join. rc=%s", strrc(rc));
+  }
+
+  RC outer_rc = children_[outer_side_]->close();
+  if (OB_FAIL(outer_rc)) {
+    LOG_WARN("failed to close outer child of index nested loop join. rc=%s", strrc(outer_rc));
+    rc = outer_rc;
+  }
+
+  outer_rows_.clear();
+  sorted_rows_.clear();
+  null_rows_.clear();
+  matches_.clear();
+  match_pos_ = 0;
+  return rc;
+}
+
+RC IndexNestedLoopJoinPhysicalOperator::next_batch()
+{
+  matches_.clear();
+  match_pos_ = 0;
+
+  RC rc = close_inner();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (phase_ == InnerPhase::POINTS && !null_rows_.empty() && !outer_rows_.empty()) {
+    // 这一批中非NULL的键值处理完了，再扫描一遍内表找出NULL键值的行
+    return open_inner({IndexScanRange()}, InnerPhase::NULLS);
+  }
+
+  outer_rows_.clear();
+  sorted_rows_.clear();
+  null_rows_.clear();
+
+  PhysicalOperator &outer = *children_[outer_side_];
+  while (!outer_eof_ && outer_rows_.size() < BATCH_SIZE) {
+    rc = outer.next();
+    if (rc == RC::RECORD_EOF) {
+      outer_eof_ = true;
+      break;
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get next tuple from outer child of index nested loop join. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    Tuple *tuple = outer.current_tuple();
+    if (nullptr == tuple) {
+      LOG_WARN("failed to get current tuple from outer child of index nested loop join");
+      return RC::INTERNAL;
+    }
+
+    OuterRow row;
+    row.keys.resize(outer_keys_.size());
+    for (size_t i = 0; i < outer_keys_.size(); i++) {
+      rc = outer_keys_[i]->get_value(*tuple, row.keys[i]);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get value of join key. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+    rc = ValueListTuple::make(*tuple, row.tuple);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to copy outer tuple. rc=%s", strrc(rc));
+      return rc;
+    }
+    outer_rows_.emplace_back(std::move(row));
+  }
+
+  if (outer_rows_.empty()) {
+    return RC::RECORD_EOF;
+  }
+
+  for (int i = 0; i < static_cast<int>(outer_rows_.size()); i++) {
+    (outer_rows_[i].keys[0].is_null() ? null_rows_ : sorted_rows_).push_back(i);
+  }
+
+  // 键值排序之后去重，就是一组互不相交并且有序的等值区间
+  std::stable_sort(sorted_rows_.begin(), sorted_rows_.end(), [this](int left, int right) {
+    return outer_rows_[left].keys[0].compare(outer_rows_[right].keys[0]) < 0;
+  });
+
+  std::vector<IndexScanRange> ranges;
+  for (int row_index : sorted_rows_) {
+    const Value &key = outer_rows_[row_index].keys[0];
+    if (!ranges.empty() && ranges.back().left_values.front().compare(key) == 0) {
+      continue;
+    }
+    IndexScanRange range;
+    range.left_values.push_back(key);
+    range.right_values.push_back(key);
+    ranges.emplace_back(std::move(range));
+  }
+
+  if (ranges.empty()) {
+    return open_inner({IndexScanRange()}, InnerPhase::NULLS);
+  }
+  return open_inner(std::move(ranges), InnerPhase::POINTS);
+}
+
+RC IndexNestedLoopJoinPhysicalOperator::open_inner(std::vector<IndexScanRange> ranges, InnerPhase phase)
+{
+  phase_ = phase;
+  inner_->set_ranges(std::move(ranges));
+  RC rc = inner_->open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open inner index scan of index nested loop join. rc=%s", strrc(rc));
+    return rc;
+  }
+  inner_open_ = true;
+  return RC::SUCCESS;
+}
+
+RC IndexNestedLoopJoinPhysicalOperator::close_inner()
+{
+  if (!inner_open_) {
+    return RC::SUCCESS;
+  }
+  inner_open_ = false;
+  return inner_->close();
+}
+
+RC IndexNestedLoopJoinPhysicalOperator::next_inner_row()
+{
+  matches_.clear();
+  match_pos_ = 0;
+
+  RC rc = RC::SUCCESS;
+  while (matches_.empty()) {
+    rc = inner_->next();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    Tuple *tuple = inner_->current_tuple();
+    inner_values_.resize(inner_keys_.size());
+    for (size_t i = 0; i < inner_keys_.size(); i++) {
+      rc = inner_keys_[i]->get_value(*tuple, inner_values_[i]);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get value of join key. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+
+    const Value &key = inner_values_[0];
+    if (phase_ == InnerPhase::NULLS) {
+      if (key.is_null()) {
+        matches_ = null_rows_;
+      }
+      continue;
+    }
+
+    if (key.is_null()) {
+      continue;
+    }
+
+    auto less_than_key = [this](int row_index, const Value &value) {
+      return outer_rows_[row_index].keys[0].compare(value) < 0;
+    };
+    auto iter = std::lower_bound(sorted_rows_.begin(), sorted_rows_.end(), key, less_than_key);
+    for (; iter != sorted_rows_.end() && outer_rows_[*iter].keys[0].compare(key) == 0; ++iter) {
+      matches_.push_back(*iter);
+    }
+  }
+  return rc;
+}
+
+bool IndexNestedLoopJoinPhysicalOperator::other_keys_equal(const OuterRow &row) const
+{
+  for (size_t i = 1; i < row.keys.size(); i++) {
+    if (row.keys[i].compare(inner_values_[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,99 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/expr/tuple.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 索引嵌套循环连接
+ * @ingroup PhysicalOperator
+ * @details 一个孩子是外表，可以是任意的算子；另一个孩子是内表的索引扫描(IndexScanPhysicalOperator)，
+ * 索引的第一个字段就是第一对连接字段。
+ * 每次从外表读取一批行，把这批行中不同的键值作为等值区间重新打开索引扫描，由 Index::get_entries 批量查找，
+ * 相邻的键值可以共用从根节点下降的路径，不需要每一行都扫描一次内表。
+ * 内表的每一行按照键值找出这一批中匹配的外表行，再检查其它的连接条件。
+ * 与 ComparisonExpr 一致，两个NULL认为相等：这一批中有NULL键值时，再扫描一遍内表的索引找出NULL键值的行。
+ * 内表可以是左孩子也可以是右孩子，输出的行总是左孩子在前。
+ */
+class IndexNestedLoopJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  static constexpr int BATCH_SIZE = 128;  ///< 每次从外表读取多少行
+
+  /**
+   * @param inner_side 内表是左孩子(0)还是右孩子(1)
+   * @param left_keys 左孩子的连接字段，第一个对应索引的第一个字段
+   * @param right_keys 右孩子的连接字段，与 left_keys 一一对应
+   */
+  IndexNestedLoopJoinPhysicalOperator(int inner_side, std::vector<std::unique_ptr<Expression>> &&left_keys,
+      std::vector<std::unique_ptr<Expression>> &&right_keys);
+  virtual ~IndexNestedLoopJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_NESTED_LOOP_JOIN; }
+  std::string          param() const override;
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override { return &joined_tuple_; }
+
+private:
+  /// 外表的一行
+  struct OuterRow
+  {
+    std::vector<Value> keys;
+    ValueListTuple     tuple;
+  };
+
+  /// 当前扫描内表的哪些行
+  enum class InnerPhase
+  {
+    POINTS,  ///< 这一批外表行中非NULL的键值
+    NULLS,   ///< 整个索引，只使用NULL键值的行
+  };
+
+private:
+  /// 读取下一批外表行，并使用它们的键值打开索引扫描。外表读完时返回 RECORD_EOF
+  RC next_batch();
+  RC open_inner(std::vector<IndexScanRange> ranges, InnerPhase phase);
+  RC close_inner();
+
+  /// 读取内表的下一行，并找出匹配的外表行放到 matches_ 中
+  RC next_inner_row();
+
+  /// 除了第一对连接字段之外，其它的连接字段是否都相等
+  bool other_keys_equal(const OuterRow &row) const;
+
+private:
+  Trx *trx_        = nullptr;
+  int  inner_side_ = 1;
+  int  outer_side_ = 0;
+
+  std::vector<std::unique_ptr<Expression>> outer_keys_;
+  std::vector<std::unique_ptr<Expression>> inner_keys_;
+
+  IndexScanPhysicalOperator *inner_      = nullptr;
+  bool                       inner_open_ = false;
+  InnerPhase                 phase_      = InnerPhase::POINTS;
+  std::vector<Value>         inner_values_;  ///< 内表当前行的连接字段
+
+  std::vector<OuterRow> outer_rows_;
+  std::vector<int>      sorted_rows_;  ///< 键值不是NULL的外表行，按照键值排序
+  std::vector<int>      null_rows_;    ///< 键值是NULL的外表行
+  bool                  outer_eof_ = false;
+
+  std::vector<int> matches_;  ///< 与内表当前行匹配的外表行
+  size_t           match_pos_ = 0;
+
+  JoinedTuple joined_tuple_;
+};
@@ -13,70 +13,145 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/index_scan_physical_operator.h"
+#include "common/lang/algorithm.h"
 #include "storage/index/index.h"
 #include "storage/trx/trx.h"
 
+bool IndexScanRange::is_point() const
+{
+  if (!left_inclusive || !right_inclusive || left_values.empty() || left_values.size() != right_values.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < left_values.size(); i++) {
+    if (left_values[i].compare(right_values[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
     bool left_inclusive, const Value *right_value, bool right_inclusive)
-    : table_(table),
-      index_(index),
-      mode_(mode),
-      left_inclusive_(left_inclusive),
-      right_inclusive_(right_inclusive)
+    : table_(table), index_(index), mode_(mode)
 {
+  IndexScanRange range;
   if (left_value) {
-    left_value_ = *left_value;
+    range.left_values.push_back(*left_value);
   }
+  range.left_inclusive = left_inclusive;
   if (right_value) {
-    right_value_ = *right_value;
+    range.right_values.push_back(*right_value);
   }
+  range.right_inclusive = right_inclusive;
+  ranges_.push_back(std::move(range));
 }
 
+IndexScanPhysicalOperator::IndexScanPhysicalOperator(
+    Table *table, Index *index, ReadWriteMode mode, std::vector<IndexScanRange> ranges)
+    : table_(table), index_(index), mode_(mode), ranges_(std::move(ranges))
+{}
+
 RC IndexScanPhysicalOperator::open(Trx *trx)
 {
   if (nullptr == table_ || nullptr == index_) {
     return RC::INTERNAL;
   }
 
-  IndexScanner *index_scanner = index_->create_scanner(left_value_.data(),
-      left_value_.length(),
-      left_inclusive_,
-      right_value_.data(),
-      right_value_.length(),
-      right_inclusive_);
-  if (nullptr == index_scanner) {
-    LOG_WARN("failed to create index scanner");
-    return RC::INTERNAL;
-  }
-
   record_handler_ = table_->record_handler();
   if (nullptr == record_handler_) {
     LOG_WARN("invalid record handler");
-    index_scanner->destroy();
     return RC::INTERNAL;
   }
-  index_scanner_ = index_scanner;
+
+  range_index_ = 0;
+  all_rids_.clear();
+  rid_index_    = 0;
+  materialized_ = false;
 
   tuple_.set_schema(table_, table_->table_meta().field_metas());
 
+  // 只扫描索引需要使用键值构造记录，必须有null位图才能知道哪些字段是null
+  const std::vector<FieldMeta> &index_fields = index_->field_metas();
+  if (mode_ != ReadWriteMode::READ_ONLY || index_fields.size() <= 1) {
+    index_only_ = false;
+  }
+  if (index_only_) {
+    const std::vector<FieldMeta> *table_fields = table_->table_meta().field_metas();
+    std::vector<bool>             covered(table_fields->size(), false);
+    for (size_t i = 0; i < table_fields->size(); i++) {
+      for (const FieldMeta &index_field : index_fields) {
+        if (0 == strcmp(index_field.name(), (*table_fields)[i].name())) {
+          covered[i] = true;
+          break;
+        }
+      }
+    }
+    tuple_.set_covered(std::move(covered));
+    tuple_.set_loader([this]() { return load_current_record(); });
+
+    key_length_ = index_->key_length();
+    keys_.resize(static_cast<size_t>(BATCH_SIZE) * key_length_);
+    key_record_.resize(table_->table_meta().record_size());
+  }
+
+  // 只扫描索引时需要从扫描器中获取键值，不使用批量等值查找
+  bool point_mode = !index_only_ && ranges_.size() > 1;
+  for (const IndexScanRange &range : ranges_) {
+    if (!range.is_point() || range.left_values.size() != ranges_.front().left_values.size()) {
+      point_mode = false;
+      break;
+    }
+  }
+
+  RC rc = RC::SUCCESS;
+  if (point_mode) {
+    rc = fetch_points();
+  } else if (mode_ == ReadWriteMode::READ_WRITE) {
+    rc = fetch_all();
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch rids from index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rids_.resize(BATCH_SIZE);
+  sorted_rids_.resize(BATCH_SIZE);
+  record_index_.resize(BATCH_SIZE);
+  records_.resize(BATCH_SIZE);
+  batch_size_  = 0;
+  batch_index_ = 0;
+
   trx_ = trx;
   return RC::SUCCESS;
 }
 
 RC IndexScanPhysicalOperator::next()
 {
-  RID rid;
-  RC  rc = RC::SUCCESS;
+  RC rc = RC::SUCCESS;
 
   bool filter_result = false;
-  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
-    rc = record_handler_->get_record(rid, current_record_);
-    if (OB_FAIL(rc)) {
-      LOG_TRACE("failed to get record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
-      return rc;
+  while (true) {
+    if (batch_index_ >= batch_size_) {
+      rc = index_only_ ? fetch_key_batch() : fetch_batch();
+      if (OB_FAIL(rc)) {
+        break;
+      }
     }
 
-    LOG_TRACE("got a record. rid=%s", rid.to_string().c_str());
+    bool loaded = true;
+    if (key_batch_) {
+      rc = prepare_index_only_record(loaded);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to prepare record from index key. rc=%s", strrc(rc));
+        return rc;
+      }
+    } else {
+      current_record_ = std::move(records_[record_index_[batch_index_]]);
+      tuple_.set_loaded(true);
+    }
+    batch_index_++;
+
+    LOG_TRACE("got a record. rid=%s", current_record_.rid().to_string().c_str());
 
     tuple_.set_record(&current_record_);
     rc = filter(tuple_, filter_result);
@@ -90,6 +165,11 @@ RC IndexScanPhysicalOperator::next()
       continue;
     }
 
+    if (!loaded) {
+      // 页面上的记录都对当前事务可见
+      return rc;
+    }
+
     rc = trx_->visit_record(table_, current_record_, mode_);
     if (rc == RC::RECORD_INVISIBLE) {
       LOG_TRACE("record invisible");
@@ -102,10 +182,236 @@ RC IndexScanPhysicalOperator::next()
   return rc;
 }
 
+RC IndexScanPhysicalOperator::fetch_key_batch()
+{
+  batch_index_ = 0;
+  batch_size_  = 0;
+  key_batch_   = true;
+
+  // 可见性只在同一个批次中缓存。批次中的索引数据插入时，对应的记录已经插入并清除了页面的可见性标记
+  visible_page_ = BP_INVALID_PAGE_NUM;
+
+  RC rc = next_rids(rids_.data(), BATCH_SIZE, batch_size_, keys_.data());
+  if (OB_FAIL(rc)) {
+    batch_size_ = 0;
+  }
+  return rc;
+}
+
+RC IndexScanPhysicalOperator::prepare_index_only_record(bool &loaded)
+{
+  const RID &rid = rids_[batch_index_];
+  if (rid.page_num != visible_page_) {
+    visible_page_   = rid.page_num;
+    visible_result_ = trx_->page_all_visible(table_, rid.page_num);
+  }
+
+  if (!visible_result_) {
+    loaded = true;
+    tuple_.set_loaded(true);
+    return record_handler_->get_record(rid, current_record_);
+  }
+
+  // 多字段索引的键值包含了完整的null位图，其它字段的值保持为0，不会被访问
+  memset(key_record_.data(), 0, key_record_.size());
+  const char *key    = keys_.data() + static_cast<size_t>(batch_index_) * key_length_;
+  int         offset = 0;
+  for (const FieldMeta &field_meta : index_->field_metas()) {
+    memcpy(key_record_.data() + field_meta.offset(), key + offset, field_meta.len());
+    offset += field_meta.len();
+  }
+
+  current_record_ = Record();
+  current_record_.set_data(key_record_.data(), static_cast<int>(key_record_.size()));
+  current_record_.set_rid(rid);
+  tuple_.set_loaded(false);
+  loaded = false;
+  return RC::SUCCESS;
+}
+
+RC IndexScanPhysicalOperator::load_current_record()
+{
+  const RID rid = current_record_.rid();
+
+  RC rc = record_handler_->get_record(rid, current_record_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  tuple_.set_record(&current_record_);
+  tuple_.set_loaded(true);
+
+  // 上层算子需要索引之外的字段，后面的数据直接读取记录
+  index_only_ = false;
+  return rc;
+}
+
+RC IndexScanPhysicalOperator::fetch_batch()
+{
+  batch_index_ = 0;
+  batch_size_  = 0;
+  key_batch_   = false;
+
+  RC rc = next_rids(rids_.data(), BATCH_SIZE, batch_size_);
+  if (OB_FAIL(rc)) {
+    batch_size_ = 0;
+    return rc;
+  }
+
+  std::vector<int> order(batch_size_);
+  for (int i = 0; i < batch_size_; i++) {
+    order[i] = i;
+  }
+  sort(order.begin(), order.end(), [this](int left, int right) {
+    return RID::compare(&rids_[left], &rids_[right]) < 0;
+  });
+
+  for (int i = 0; i < batch_size_; i++) {
+    sorted_rids_[i]          = rids_[order[i]];
+    record_index_[order[i]] = i;
+  }
+
+  rc = record_handler_->get_records(sorted_rids_.data(), batch_size_, records_.data());
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to get records. rc=%s", strrc(rc));
+    batch_size_ = 0;
+    return rc;
+  }
+  return rc;
+}
+
+RC IndexScanPhysicalOperator::fetch_points()
+{
+  std::vector<std::string> keys(ranges_.size());
+  std::vector<const char *> key_ptrs(ranges_.size());
+  std::vector<int>         key_lens(ranges_.size());
+  for (size_t i = 0; i < ranges_.size(); i++) {
+    make_key(ranges_[i].left_values, keys[i], key_lens[i]);
+    key_ptrs[i] = keys[i].c_str();
+  }
+
+  std::vector<std::list<RID>> rids;
+  RC rc = index_->get_entries(key_ptrs, key_lens, rids, static_cast<int>(ranges_.front().left_values.size()));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  for (std::list<RID> &key_rids : rids) {
+    all_rids_.insert(all_rids_.end(), key_rids.begin(), key_rids.end());
+  }
+  materialized_ = true;
+  return rc;
+}
+
+RC IndexScanPhysicalOperator::fetch_all()
+{
+  RC  rc    = RC::SUCCESS;
+  int count = 0;
+  while (true) {
+    all_rids_.resize(all_rids_.size() + BATCH_SIZE);
+    rc = scan_rids(all_rids_.data() + all_rids_.size() - BATCH_SIZE, BATCH_SIZE, count);
+    all_rids_.resize(all_rids_.size() - BATCH_SIZE + count);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    return rc;
+  }
+  materialized_ = true;
+  return RC::SUCCESS;
+}
+
+RC IndexScanPhysicalOperator::next_rids(RID *rids, int capacity, int &count, char *keys)
+{
+  if (!materialized_) {
+    return scan_rids(rids, capacity, count, keys);
+  }
+
+  ASSERT(keys == nullptr, "cannot get keys from materialized rids");
+
+  count = 0;
+  while (count < capacity && rid_index_ < all_rids_.size()) {
+    rids[count++] = all_rids_[rid_index_++];
+  }
+  return count > 0 ? RC::SUCCESS : RC::RECORD_EOF;
+}
+
+RC IndexScanPhysicalOperator::scan_rids(RID *rids, int capacity, int &count, char *keys)
+{
+  count = 0;
+  while (true) {
+    if (nullptr == index_scanner_) {
+      if (range_index_ >= ranges_.size()) {
+        return RC::RECORD_EOF;
+      }
+
+      const IndexScanRange &range = ranges_[range_index_++];
+
+      std::string left_key;
+      std::string right_key;
+      int         left_len  = 0;
+      int         right_len = 0;
+      make_key(range.left_values, left_key, left_len);
+      make_key(range.right_values, right_key, right_len);
+      index_scanner_ = index_->create_scanner(range.left_values.empty() ? nullptr : left_key.c_str(),
+          left_len,
+          range.left_inclusive,
+          range.right_values.empty() ? nullptr : right_key.c_str(),
+          right_len,
+          range.right_inclusive,
+          std::max(1, static_cast<int>(range.left_values.size())),
+          std::max(1, static_cast<int>(range.right_values.size())));
+      if (nullptr == index_scanner_) {
+        LOG_WARN("failed to create index scanner");
+        return RC::INTERNAL;
+      }
+    }
+
+    RC rc = (keys != nullptr) ? index_scanner_->next_batch_with_keys(rids, keys, capacity, count)
+                              : index_scanner_->next_batch(rids, capacity, count);
+    if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+}
+
+void IndexScanPhysicalOperator::make_key(const std::vector<Value> &values, std::string &key, int &last_len) const
+{
+  const std::vector<FieldMeta> &field_metas = index_->field_metas();
+  // 多字段索引的第一个字段是null位图
+  const size_t first = field_metas.size() > 1 ? 1 : 0;
+
+  key.clear();
+  last_len = 0;
+  for (size_t i = 0; i < values.size(); i++) {
+    const FieldMeta &field_meta = field_metas[first + i];
+    const Value     &value      = values[i];
+    const int        copy_len   = std::min(value.length(), field_meta.len());
+    if (i + 1 == values.size() && field_meta.type() == AttrType::CHARS) {
+      // 最后一个字符串字段保留完整的值，由索引处理超长的字符串
+      key.append(value.data(), value.length());
+      last_len = value.length();
+    } else {
+      key.append(value.data(), copy_len);
+      key.append(field_meta.len() - copy_len, '\0');
+      last_len = field_meta.len();
+    }
+  }
+}
+
 RC IndexScanPhysicalOperator::close()
 {
-  index_scanner_->destroy();
-  index_scanner_ = nullptr;
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+  all_rids_.clear();
   return RC::SUCCESS;
 }
 
@@ -143,5 +449,9 @@ RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 
 std::string IndexScanPhysicalOperator::param() const
 {
-  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+  std::string param = std::string(index_->index_meta().name()) + " ON " + table_->name();
+  if (index_only_) {
+    param += " INDEX ONLY";
+  }
+  return param;
 }
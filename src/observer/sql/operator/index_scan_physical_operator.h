@@ -18,15 +18,74 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/physical_operator.h"
 #include "storage/record/record_manager.h"
 
+/**
+ * @brief 索引扫描的一个区间
+ * @ingroup PhysicalOperator
+ * @details 边界是索引前几个字段的值，左右边界的字段个数可以不同。比如索引(a,b)上的条件
+ * a=1 and b>3，左边界是(1,3)，右边界是(1)。边界为空表示没有限制。
+ */
+struct IndexScanRange
+{
+  std::vector<Value> left_values;
+  bool               left_inclusive = true;
+  std::vector<Value> right_values;
+  bool               right_inclusive = true;
+
+  /// 左右边界相同并且都包含边界，即等值查找
+  bool is_point() const;
+};
+
+/**
+ * @brief 只扫描索引时返回的行
+ * @ingroup PhysicalOperator
+ * @details 记录是使用索引的键值构造的，只有索引包含的字段是有效的。访问其它字段时使用 loader 读取完整的记录
+ */
+class IndexOnlyRowTuple : public RowTuple
+{
+public:
+  /**
+   * @param covered 与表的字段一一对应，表示这个字段是否包含在索引中
+   */
+  void set_covered(std::vector<bool> covered) { covered_ = std::move(covered); }
+  void set_loader(std::function<RC()> loader) { loader_ = std::move(loader); }
+
+  /// 当前记录是否是完整的记录
+  void set_loaded(bool loaded) { loaded_ = loaded; }
+
+  RC cell_at(int index, Value &cell) const override
+  {
+    if (!loaded_ && index >= 0 && index < static_cast<int>(covered_.size()) && !covered_[index]) {
+      RC rc = loader_();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    return RowTuple::cell_at(index, cell);
+  }
+
+private:
+  std::vector<bool>   covered_;
+  std::function<RC()> loader_;
+  bool                loaded_ = true;
+};
+
 /**
  * @brief 索引扫描物理算子
  * @ingroup PhysicalOperator
+ * @details 依次扫描多个互不相交的区间。如果所有区间都是等值查找(比如 IN 列表)，就使用 Index::get_entries
+ * 批量查找，相邻的键值可以共用从根节点下降的路径。
+ * 更新和删除时会修改索引，扫描器会失效，所以先取出所有的RID再返回记录。
+ *
+ * 只读的扫描可以只扫描索引(index only)：使用叶子节点中的键值构造记录，页面上的记录都对当前事务可见时
+ * (参考 Trx::page_all_visible)就不需要读取记录。如果上层算子访问了索引之外的字段，就读取这条记录，
+ * 并且之后的数据不再只扫描索引。
  */
 class IndexScanPhysicalOperator : public PhysicalOperator
 {
 public:
   IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
       bool left_inclusive, const Value *right_value, bool right_inclusive);
+  IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, std::vector<IndexScanRange> ranges);
 
   virtual ~IndexScanPhysicalOperator() = default;
 
@@ -42,10 +101,61 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 修改扫描的区间，下一次 open 时生效
+   * @details 索引嵌套循环连接每次使用外表的一批键值重新扫描
+   */
+  void set_ranges(std::vector<IndexScanRange> ranges) { ranges_ = std::move(ranges); }
+
+  /**
+   * @brief 设置是否只扫描索引，只对只读的扫描有效
+   */
+  void set_index_only(bool index_only) { index_only_ = index_only; }
+  bool index_only() const { return index_only_; }
+
 private:
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
 
+  /**
+   * @brief 把字段值转换成索引的键值，字段值按照索引字段的长度依次存放
+   * @param[out] last_len 最后一个字段的长度，字符串类型的字段是字符串的实际长度
+   */
+  void make_key(const std::vector<Value> &values, std::string &key, int &last_len) const;
+
+  /// 等值查找的区间，一次查出所有的RID
+  RC fetch_points();
+
+  /// 扫描所有的区间，取出所有的RID
+  RC fetch_all();
+
+  /// 从索引中获取最多 capacity 个RID，一个区间扫描完成后打开下一个区间
+  RC next_rids(RID *rids, int capacity, int &count, char *keys = nullptr);
+
+  /// 从索引中获取最多 capacity 个RID，不使用已经取出的RID。keys 不为空时同时获取键值
+  RC scan_rids(RID *rids, int capacity, int &count, char *keys = nullptr);
+
+  /**
+   * @brief 从索引中获取下一批RID，并读取对应的记录
+   * @details 先按照页面编号排序再读取记录，同一个页面只需要pin一次。返回记录时仍然保持索引的顺序
+   */
+  RC fetch_batch();
+
+  /// 只扫描索引时，从索引中获取下一批RID和键值
+  RC fetch_key_batch();
+
+  /**
+   * @brief 只扫描索引时，准备 batch_index_ 位置的记录
+   * @param[out] loaded 是否读取了完整的记录。读取了完整的记录时还需要判断可见性
+   */
+  RC prepare_index_only_record(bool &loaded);
+
+  /// 读取当前行完整的记录，之后不再只扫描索引
+  RC load_current_record();
+
+private:
+  static constexpr int BATCH_SIZE = 128;  ///< 每次从索引中获取的RID数量
+
 private:
   Trx               *trx_            = nullptr;
   Table             *table_          = nullptr;
@@ -54,13 +164,29 @@ private:
   IndexScanner      *index_scanner_  = nullptr;
   RecordFileHandler *record_handler_ = nullptr;
 
-  Record   current_record_;
-  RowTuple tuple_;
+  Record            current_record_;
+  IndexOnlyRowTuple tuple_;
+
+  std::vector<RID>    rids_;           ///< 当前批次的RID，按照索引的顺序
+  std::vector<RID>    sorted_rids_;    ///< 按照页面编号排序后的RID
+  std::vector<int>    record_index_;   ///< rids_[i] 对应的记录是 records_[record_index_[i]]
+  std::vector<Record> records_;        ///< 与 sorted_rids_ 一一对应
+  int                 batch_size_  = 0;
+  int                 batch_index_ = 0;
+
+  std::vector<IndexScanRange> ranges_;
+  size_t                      range_index_  = 0;      ///< 下一个要扫描的区间
+  bool                        materialized_ = false;  ///< 是否已经取出了所有的RID
+  std::vector<RID>            all_rids_;              ///< 已经取出的所有RID
+  size_t                      rid_index_ = 0;
 
-  Value left_value_;
-  Value right_value_;
-  bool  left_inclusive_  = false;
-  bool  right_inclusive_ = false;
+  bool              index_only_ = false;  ///< 是否只扫描索引
+  bool              key_batch_  = false;  ///< 当前批次是否是只扫描索引获取的
+  int               key_length_ = 0;
+  std::vector<char> keys_;                ///< 当前批次的键值，与 rids_ 一一对应
+  std::vector<char> key_record_;          ///< 使用键值构造的记录
+  PageNum           visible_page_    = BP_INVALID_PAGE_NUM;  ///< 当前批次中最近检查过可见性的页面
+  bool              visible_result_  = false;
 
   std::vector<std::unique_ptr<Expression>> predicates_;
 };
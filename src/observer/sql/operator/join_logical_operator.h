@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
  * @brief 连接算子
  * @ingroup LogicalOperator
  * @details 连接算子，用于连接两个表。对应的物理算子或者实现，可能有NestedLoopJoin，HashJoin等等。
+ * expressions_ 中是等值连接条件(参考 JoinConditionPushdownRewriter)，都是 ComparisonExpr，
+ * 左边的字段来自左孩子，右边的字段来自右孩子。没有等值连接条件时是笛卡尔积。
  */
 class JoinLogicalOperator : public LogicalOperator
 {
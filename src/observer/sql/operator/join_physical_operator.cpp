@@ -13,6 +13,33 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/join_physical_operator.h"
+#include "sql/expr/expression.h"
+
+namespace {
+
+std::string key_to_string(const Expression &expr)
+{
+  if (expr.type() == ExprType::FIELD) {
+    const FieldExpr &field_expr = static_cast<const FieldExpr &>(expr);
+    return std::string(field_expr.table_name()) + "." + field_expr.field_name();
+  }
+  return expr.name();
+}
+
+}  // namespace
+
+std::string join_keys_to_string(
+    const std::vector<std::unique_ptr<Expression>> &left_keys, const std::vector<std::unique_ptr<Expression>> &right_keys)
+{
+  std::string result;
+  for (size_t i = 0; i < left_keys.size() && i < right_keys.size(); i++) {
+    if (i > 0) {
+      result += ", ";
+    }
+    result += key_to_string(*left_keys[i]) + "=" + key_to_string(*right_keys[i]);
+  }
+  return result;
+}
 
 NestedLoopJoinPhysicalOperator::NestedLoopJoinPhysicalOperator() {}
 
@@ -17,6 +17,14 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/physical_operator.h"
 #include "sql/parser/parse.h"
 
+/**
+ * @brief 等值连接条件的描述，用于 explain，比如 `a.id=b.id, a.name=b.name`
+ * @param left_keys 左孩子的连接字段
+ * @param right_keys 右孩子的连接字段，与 left_keys 一一对应
+ */
+std::string join_keys_to_string(
+    const std::vector<std::unique_ptr<Expression>> &left_keys, const std::vector<std::unique_ptr<Expression>> &right_keys);
+
 /**
  * @brief 最简单的两表（称为左表、右表）join算子
  * @details 依次遍历左表的每一行，然后关联右表的每一行
@@ -0,0 +1,241 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/merge_join_physical_operator.h"
+#include "common/log/log.h"
+#include "sql/operator/join_physical_operator.h"
+
+MergeJoinPhysicalOperator::MergeJoinPhysicalOperator(
+    std::vector<std::unique_ptr<Expression>> &&left_keys, std::vector<std::unique_ptr<Expression>> &&right_keys)
+{
+  ASSERT(left_keys.size() == right_keys.size() && !left_keys.empty(), "invalid merge join keys");
+  keys_[LEFT]  = std::move(left_keys);
+  keys_[RIGHT] = std::move(right_keys);
+}
+
+std::string MergeJoinPhysicalOperator::param() const { return join_keys_to_string(keys_[LEFT], keys_[RIGHT]); }
+
+RC MergeJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("merge join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  RC rc = RC::SUCCESS;
+  for (int side : {LEFT, RIGHT}) {
+    rc = children_[side]->open(trx);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to open child of merge join. side=%d, rc=%s", side, strrc(rc));
+      return rc;
+    }
+    null_rows_[side].clear();
+  }
+
+  left_tuple_ = nullptr;
+  left_eof_   = false;
+  right_eof_  = false;
+  group_.clear();
+  group_pos_      = 0;
+  null_left_pos_  = 0;
+  null_right_pos_ = 0;
+  return advance_right();
+}
+
+RC MergeJoinPhysicalOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  while (!left_eof_) {
+    while (group_pos_ < group_.size()) {
+      JoinRow &row = group_[group_pos_++];
+      if (!other_keys_equal(left_keys_, row.keys)) {
+        continue;
+      }
+      joined_tuple_.set_left(left_tuple_);
+      joined_tuple_.set_right(&row.tuple);
+      return RC::SUCCESS;
+    }
+
+    rc = read_child(LEFT, left_keys_, left_tuple_);
+    if (rc == RC::RECORD_EOF) {
+      // 右边剩下的行不会再匹配，只需要找出NULL键值的行
+      left_eof_ = true;
+      group_.clear();
+      rc        = RC::SUCCESS;
+      while (!right_eof_ && OB_SUCC(rc = advance_right())) {
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      break;
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (left_keys_[0].is_null()) {
+      JoinRow row;
+      rc = copy_row(LEFT, *left_tuple_, left_keys_, row);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      null_rows_[LEFT].emplace_back(std::move(row));
+      continue;
+    }
+
+    group_pos_ = 0;
+    if (!group_.empty() && group_.front().keys[0].compare(left_keys_[0]) == 0) {
+      continue;  // 与上一行的键值相同，再使用一次这一组
+    }
+
+    rc = load_group(left_keys_[0]);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  return next_null_pair();
+}
+
+RC MergeJoinPhysicalOperator::close()
+{
+  RC rc = RC::SUCCESS;
+  for (int side : {LEFT, RIGHT}) {
+    RC child_rc = children_[side]->close();
+    if (OB_FAIL(child_rc)) {
+      LOG_WARN("failed to close child of merge join. side=%d, rc=%s", side, strrc(child_rc));
+      rc = child_rc;
+    }
+    null_rows_[side].clear();
+  }
+
+  group_.clear();
+  left_tuple_ = nullptr;
+  return rc;
+}
+
+RC MergeJoinPhysicalOperator::read_child(int side, std::vector<Value> &keys, Tuple *&tuple)
+{
+  RC rc = children_[side]->next();
+  if (OB_FAIL(rc)) {
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to get next tuple from child of merge join. side=%d, rc=%s", side, strrc(rc));
+    }
+    return rc;
+  }
+
+  tuple = children_[side]->current_tuple();
+  if (nullptr == tuple) {
+    LOG_WARN("failed to get current tuple from child of merge join. side=%d", side);
+    return RC::INTERNAL;
+  }
+
+  keys.resize(keys_[side].size());
+  for (size_t i = 0; i < keys_[side].size(); i++) {
+    rc = keys_[side][i]->get_value(*tuple, keys[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get value of join key. side=%d, rc=%s", side, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC MergeJoinPhysicalOperator::copy_row(int side, Tuple &tuple, std::vector<Value> &keys, JoinRow &row)
+{
+  row.keys = keys;
+  RC rc    = ValueListTuple::make(tuple, row.tuple);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy tuple of merge join. side=%d, rc=%s", side, strrc(rc));
+  }
+  return rc;
+}
+
+RC MergeJoinPhysicalOperator::advance_right()
+{
+  std::vector<Value> keys;
+  Tuple             *tuple = nullptr;
+  while (true) {
+    RC rc = read_child(RIGHT, keys, tuple);
+    if (rc == RC::RECORD_EOF) {
+      right_eof_ = true;
+      return RC::SUCCESS;
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    JoinRow row;
+    rc = copy_row(RIGHT, *tuple, keys, row);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (!keys[0].is_null()) {
+      right_next_ = std::move(row);
+      return RC::SUCCESS;
+    }
+    null_rows_[RIGHT].emplace_back(std::move(row));
+  }
+}
+
+RC MergeJoinPhysicalOperator::load_group(const Value &key)
+{
+  group_.clear();
+
+  RC rc = RC::SUCCESS;
+  while (!right_eof_ && right_next_.keys[0].compare(key) < 0) {
+    rc = advance_right();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  while (!right_eof_ && right_next_.keys[0].compare(key) == 0) {
+    group_.emplace_back(std::move(right_next_));
+    right_next_ = JoinRow();
+    rc          = advance_right();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC MergeJoinPhysicalOperator::next_null_pair()
+{
+  std::vector<JoinRow> &left_rows  = null_rows_[LEFT];
+  std::vector<JoinRow> &right_rows = null_rows_[RIGHT];
+  while (null_left_pos_ < left_rows.size()) {
+    JoinRow &left = left_rows[null_left_pos_];
+    while (null_right_pos_ < right_rows.size()) {
+      JoinRow &right = right_rows[null_right_pos_++];
+      if (!other_keys_equal(left.keys, right.keys)) {
+        continue;
+      }
+      joined_tuple_.set_left(&left.tuple);
+      joined_tuple_.set_right(&right.tuple);
+      return RC::SUCCESS;
+    }
+    null_left_pos_++;
+    null_right_pos_ = 0;
+  }
+  return RC::RECORD_EOF;
+}
+
+bool MergeJoinPhysicalOperator::other_keys_equal(const std::vector<Value> &left, const std::vector<Value> &right) const
+{
+  for (size_t i = 1; i < left.size(); i++) {
+    if (left[i].compare(right[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
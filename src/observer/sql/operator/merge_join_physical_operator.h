@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 归并连接
+ * @ingroup PhysicalOperator
+ * @details 两个孩子都按照第一对连接字段升序输出，比如按照连接字段所在的索引扫描整个表。
+ * 同时向前读取两边，右边键值相同的一组行缓存下来，与左边键值相同的每一行组合输出，再检查其它的连接条件。
+ * 除了键值相同的一组右边的行，不需要缓存数据，也不需要哈希表。
+ *
+ * 索引中NULL比任何值都小，但是 Value::compare 比较NULL与其它值时不满足全序，所以键值是NULL的行不参与归并，
+ * 先缓存下来，两边都读完之后再输出它们的组合。与 ComparisonExpr 一致，两个NULL认为相等。
+ */
+class MergeJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  /**
+   * @param left_keys 左孩子的连接字段，左孩子按照第一个字段升序输出
+   * @param right_keys 右孩子的连接字段，与 left_keys 一一对应，右孩子按照第一个字段升序输出
+   */
+  MergeJoinPhysicalOperator(
+      std::vector<std::unique_ptr<Expression>> &&left_keys, std::vector<std::unique_ptr<Expression>> &&right_keys);
+  virtual ~MergeJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::MERGE_JOIN; }
+  std::string          param() const override;
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override { return &joined_tuple_; }
+
+private:
+  static constexpr int LEFT  = 0;
+  static constexpr int RIGHT = 1;
+
+  /// 缓存下来的一行
+  struct JoinRow
+  {
+    std::vector<Value> keys;
+    ValueListTuple     tuple;
+  };
+
+private:
+  /// 读取一个孩子的下一行，计算连接字段
+  RC read_child(int side, std::vector<Value> &keys, Tuple *&tuple);
+  RC copy_row(int side, Tuple &tuple, std::vector<Value> &keys, JoinRow &row);
+
+  /// 读取右边的下一行放到 right_next_ 中，键值是NULL的行放到一边
+  RC advance_right();
+  /// 右边跳过比 key 小的行，再把与 key 相等的行都放到 group_ 中
+  RC load_group(const Value &key);
+
+  /// 两边的主要部分都处理完了，输出NULL键值的行的下一个组合
+  RC next_null_pair();
+
+  bool other_keys_equal(const std::vector<Value> &left, const std::vector<Value> &right) const;
+
+private:
+  std::vector<std::unique_ptr<Expression>> keys_[2];
+
+  std::vector<Value> left_keys_;            ///< 左边当前行的连接字段
+  Tuple             *left_tuple_ = nullptr;  ///< 左边当前行
+  bool               left_eof_   = false;
+
+  JoinRow              right_next_;  ///< 右边下一个还没有处理的行
+  bool                 right_eof_ = false;
+  std::vector<JoinRow> group_;  ///< 右边键值相同的一组行
+  size_t               group_pos_ = 0;
+
+  std::vector<JoinRow> null_rows_[2];  ///< 两边键值是NULL的行
+  size_t               null_left_pos_  = 0;
+  size_t               null_right_pos_ = 0;
+
+  JoinedTuple joined_tuple_;
+};
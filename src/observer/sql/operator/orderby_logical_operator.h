@@ -21,8 +21,14 @@ public:
   std::vector<std::unique_ptr<OrderByUnit>> &orderby_units() { return orderby_units_; }
   std::vector<std::unique_ptr<Expression>>  &exprs() { return exprs_; }
 
+  /// 只需要排在最前面的多少行(ORDER BY ... LIMIT)，小于0表示不限制
+  int64_t limit() const { return limit_; }
+  void    set_limit(int64_t limit) { limit_ = limit; }
+
 private:
   std::vector<std::unique_ptr<OrderByUnit>> orderby_units_;  
 
   std::vector<std::unique_ptr<Expression>> exprs_;
-};
\ No newline at end of file
+
+  int64_t limit_ = -1;
+};
@@ -1,9 +1,5 @@
 #include "common/log/log.h"
 #include "sql/operator/orderby_physical_operator.h"
-#include "storage/record/record.h"
-#include "sql/stmt/filter_stmt.h"
-#include "storage/field/field.h"
-#include <chrono>
 
 OrderByPhysicalOperator::OrderByPhysicalOperator(
     std::vector<std::unique_ptr<OrderByUnit>> &&orderby_units, std::vector<std::unique_ptr<Expression>> &&exprs)
@@ -20,8 +16,8 @@ RC OrderByPhysicalOperator::open(Trx *trx)
     return RC::INTERNAL;
   }
   if (RC::SUCCESS != (rc = children_[0]->open(trx))) {
-    rc = RC::INTERNAL;
-    LOG_WARN("GroupByOperater child open failed!");
+    LOG_WARN("OrderByPhysicalOperator child open failed! rc=%s", strrc(rc));
+    return rc;
   }
   rc = fetch_and_sort_tables();
   return rc;
@@ -31,104 +27,68 @@ RC OrderByPhysicalOperator::fetch_and_sort_tables()
 {
   RC rc = RC::SUCCESS;
 
-  int                                        index = 0;
-  typedef std::pair<std::vector<Value>, int> CmpPair;
-  std::vector<CmpPair>                       pair_sort_table;  // 要排序的内容
-  std::vector<Value>                         pair_cell;        // 参与排序的列
+  std::vector<bool> order;  // true is asc
+  for (auto &unit : orderby_units_) {
+    order.push_back(unit->sort_type());
+  }
+  sorter_ = std::make_unique<ExternalSorter>(std::move(order), options_, limit_);
 
-  std::vector<Value> row_values(tuple_.exprs().size());  // 缓存每一行
-  int                row_values_index = 0;
-  // int i = 0;
+  std::vector<Value> keys(orderby_units_.size());  // 参与排序的列
+  std::vector<Value> row_values(tuple_.exprs().size());  // select 后的 fieldexpr 的值 和aggexpr 的值
   while (RC::SUCCESS == (rc = children_[0]->next())) {
-    
-    row_values_index = 0;  
-    
-    pair_cell.clear();
-    for (auto &unit : orderby_units_) {
-      auto &expr = unit->expr();
-      Value cell;
-      expr->get_value(*children_[0]->current_tuple(), cell);  
-      pair_cell.emplace_back(cell);
+    Tuple *child_tuple = children_[0]->current_tuple();
+    for (size_t i = 0; i < orderby_units_.size(); i++) {
+      if ((rc = orderby_units_[i]->expr()->get_value(*child_tuple, keys[i])) != RC::SUCCESS) {
+        LOG_WARN("failed to get value of order by unit. rc=%s", strrc(rc));
+        return rc;
+      }
     }
-    // 2 cons pair
-    // 3 cons pair vector
-    pair_sort_table.emplace_back(std::make_pair(pair_cell, index++)); 
-    // store child records
 
-    // 存储select 后的 fieldexpr 的值 和aggexpr 的值
-    Value expr_cell;
+    size_t row_values_index = 0;
     for (auto &expr : tuple_.exprs()) {
-      if (expr->get_value(*children_[0]->current_tuple(), expr_cell) != RC::SUCCESS) {
-        LOG_WARN("error in sort");
-        return RC::INTERNAL;
+      if ((rc = expr->get_value(*child_tuple, row_values[row_values_index++])) != RC::SUCCESS) {
+        LOG_WARN("error in sort. rc=%s", strrc(rc));
+        return rc;
       }
-      row_values[row_values_index++] = expr_cell;
     }
-    values_.emplace_back(row_values);  // values 中缓存每一行
+
+    if ((rc = sorter_->add(keys, row_values)) != RC::SUCCESS) {
+      LOG_WARN("failed to add row to sorter. rc=%s", strrc(rc));
+      return rc;
+    }
   }
   if (RC::RECORD_EOF != rc) {
     LOG_ERROR("Fetch Table Error In SortOperator. RC: %d", rc);
     return rc;
   }
-  rc = RC::SUCCESS;
-  LOG_INFO("Fetch Table Success In SortOperator");
-
-  bool order[orderby_units_.size()];  // specify 1 asc or 2 desc
 
-  for (size_t i = 0; i < orderby_units_.size(); ++i) {
-    order[i] = orderby_units_[i]->sort_type();  // true is asc
-  }
-  // consider null
-  auto cmp = [&order](const CmpPair &a, const CmpPair &b) {
-    auto &cells_a = a.first;
-    auto &cells_b = b.first;
-    assert(cells_a.size() == cells_b.size());
-    for (size_t i = 0; i < cells_a.size(); ++i) {
-      auto &cell_a = cells_a[i];
-      auto &cell_b = cells_b[i];
-      if (cell_a.is_null() && cell_b.is_null()) {
-        continue;
-      }
-      if (cell_a.is_null()) {
-        return order[i] ? true : false;
-      }
-      if (cell_b.is_null()) {
-        return order[i] ? false : true;
-      }
-      if (cell_a != cell_b) {
-        return order[i] ? cell_a < cell_b : cell_a > cell_b;
-      }
-    }
-    return false;  // completely same
-  };
-  std::sort(pair_sort_table.begin(), pair_sort_table.end(), cmp);
-  LOG_INFO("niuxn:Sort Table Success In SortOperator");
-
-  // fill ordered_idx_
-  for (size_t i = 0; i < pair_sort_table.size(); ++i) {
-    ordered_idx_.emplace_back(pair_sort_table[i].second);  // 将原来的每行的标记写入order_index数组中
+  rc = sorter_->finish();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to sort. rc=%s", strrc(rc));
+    return rc;
   }
-  it_ = ordered_idx_.begin();
-
+  LOG_TRACE("Sort Table Success In SortOperator. spilled runs=%d", sorter_->spilled_runs());
   return rc;
 }
 
 RC OrderByPhysicalOperator::next()
 {
-
-  //RC rc = RC::SUCCESS;
-  if (ordered_idx_.end() != it_) {
-    // NOTE: PAY ATTENTION HERE
-
-    tuple_.set_cells(&values_[*it_]);
-    it_++;
-    // children_[0]->current_tuple()->set_record(st_[*it_]);
-    return RC::SUCCESS;
+  if (!sorter_) {
+    return RC::RECORD_EOF;
   }
 
-  return RC::RECORD_EOF;
+  RC rc = sorter_->next(current_);
+  if (rc == RC::SUCCESS) {
+    tuple_.set_cells(&current_);
+  }
+  return rc;
 }
 
-RC OrderByPhysicalOperator::close() { return children_[0]->close(); }
+RC OrderByPhysicalOperator::close()
+{
+  sorter_.reset();
+  current_.clear();
+  return children_[0]->close();
+}
 
-Tuple *OrderByPhysicalOperator::current_tuple() { return &tuple_; }
\ No newline at end of file
+Tuple *OrderByPhysicalOperator::current_tuple() { return &tuple_; }
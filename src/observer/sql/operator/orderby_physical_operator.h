@@ -1,12 +1,18 @@
 #pragma once
 
 #include <memory>
+#include "sql/operator/external_sorter.h"
 #include "sql/operator/physical_operator.h"
 #include "sql/expr/expression.h"
 #include "sql/stmt/orderby_stmt.h"
 #include "sql/expr/tuple.h"
 
-
+/**
+ * @brief 排序算子
+ * @ingroup PhysicalOperator
+ * @details 使用 ExternalSorter 排序，内存中缓存的数据超过 SortOptions::memory 时写临时文件再归并。
+ * 设置了 limit 时只保留排在最前面的 limit 行。
+ */
 class OrderByPhysicalOperator : public PhysicalOperator
 {
 public:
@@ -17,6 +23,12 @@ public:
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::ORDER_BY; }
 
+  void set_options(const SortOptions &options) { options_ = options; }
+  void set_limit(int64_t limit) { limit_ = limit; }
+
+  /// 最近一次排序写了多少个顺串到临时文件
+  int spilled_runs() const { return sorter_ ? sorter_->spilled_runs() : 0; }
+
   RC fetch_and_sort_tables();
   RC open(Trx *trx) override;
   RC next() override;
@@ -25,10 +37,11 @@ public:
   Tuple *current_tuple() override;
 
 private:
-  std::vector<std::unique_ptr<OrderByUnit>> orderby_units_;  
-  std::vector<std::vector<Value>>           values_;
+  std::vector<std::unique_ptr<OrderByUnit>> orderby_units_;
   SplicedTuple                              tuple_;
 
-  std::vector<int>           ordered_idx_;  
-  std::vector<int>::iterator it_;
-};
\ No newline at end of file
+  SortOptions                     options_;
+  int64_t                         limit_ = -1;
+  std::unique_ptr<ExternalSorter> sorter_;
+  std::vector<Value>              current_;  ///< 当前输出的一行
+};
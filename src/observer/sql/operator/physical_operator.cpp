@@ -20,6 +20,9 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
     case PhysicalOperatorType::TABLE_SCAN: return "TABLE_SCAN";
     case PhysicalOperatorType::INDEX_SCAN: return "INDEX_SCAN";
     case PhysicalOperatorType::NESTED_LOOP_JOIN: return "NESTED_LOOP_JOIN";
+    case PhysicalOperatorType::HASH_JOIN: return "HASH_JOIN";
+    case PhysicalOperatorType::INDEX_NESTED_LOOP_JOIN: return "INDEX_NESTED_LOOP_JOIN";
+    case PhysicalOperatorType::MERGE_JOIN: return "MERGE_JOIN";
     case PhysicalOperatorType::EXPLAIN: return "EXPLAIN";
     case PhysicalOperatorType::PREDICATE: return "PREDICATE";
     case PhysicalOperatorType::INSERT: return "INSERT";
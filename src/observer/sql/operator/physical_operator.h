@@ -32,6 +32,9 @@ enum class PhysicalOperatorType
   TABLE_SCAN_VEC,
   INDEX_SCAN,
   NESTED_LOOP_JOIN,
+  HASH_JOIN,
+  INDEX_NESTED_LOOP_JOIN,
+  MERGE_JOIN,
   EXPLAIN,
   PREDICATE,
   PREDICATE_VEC,
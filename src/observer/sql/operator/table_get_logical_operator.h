@@ -34,6 +34,10 @@ public:
 
   bool readonly() const { return (!(static_cast<bool>(mode_))); }
 
+  /// 整个查询中用到的这个表的字段，包括上层算子用到的。生成物理计划时据此判断是否可以只扫描索引
+  const std::vector<Field> &fields() const { return fields_; }
+  void                      set_fields(std::vector<Field> fields) { fields_ = std::move(fields); }
+
 private:
   Table        *table_ = nullptr;
   ReadWriteMode mode_  = ReadWriteMode::READ_WRITE;
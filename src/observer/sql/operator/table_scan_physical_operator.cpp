@@ -18,6 +18,22 @@ See the Mulan PSL v2 for more details. */
 
 using namespace std;
 
+/**
+ * @brief 把主键的值转换成扫描边界
+ * @details 字符串保留完整的值，由B+树处理超长的字符串，与 IndexScanPhysicalOperator::make_key 相同
+ */
+static void make_key(const FieldMeta &field_meta, const Value &value, string &key)
+{
+  if (field_meta.type() == AttrType::CHARS) {
+    key.assign(value.data(), value.length());
+    return;
+  }
+
+  const int copy_len = min(value.length(), field_meta.len());
+  key.assign(value.data(), copy_len);
+  key.append(field_meta.len() - copy_len, '\0');
+}
+
 RC TableScanPhysicalOperator::open(Trx *trx)
 {
   RC rc = table_->get_record_scanner(record_scanner_, trx, mode_);
@@ -25,6 +41,39 @@ RC TableScanPhysicalOperator::open(Trx *trx)
     tuple_.set_schema(table_, table_->table_meta().field_metas());
   }
   trx_ = trx;
+
+  if (OB_SUCC(rc) && use_key_ranges_) {
+    range_index_ = 0;
+    if (!key_ranges_.empty()) {
+      rc = open_key_range();
+    }
+  }
+  return rc;
+}
+
+RC TableScanPhysicalOperator::open_key_range()
+{
+  const IndexScanRange &range       = key_ranges_[range_index_];
+  const FieldMeta      &primary_key = *table_->table_meta().primary_key();
+
+  string left_key;
+  string right_key;
+  if (!range.left_values.empty()) {
+    make_key(primary_key, range.left_values.front(), left_key);
+  }
+  if (!range.right_values.empty()) {
+    make_key(primary_key, range.right_values.front(), right_key);
+  }
+
+  RC rc = record_scanner_.set_key_range(range.left_values.empty() ? nullptr : left_key.data(),
+      static_cast<int>(left_key.size()),
+      range.left_inclusive,
+      range.right_values.empty() ? nullptr : right_key.data(),
+      static_cast<int>(right_key.size()),
+      range.right_inclusive);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to set primary key range. table=%s, rc=%s", table_->name(), strrc(rc));
+  }
   return rc;
 }
 
@@ -32,8 +81,25 @@ RC TableScanPhysicalOperator::next()
 {
   RC rc = RC::SUCCESS;
 
+  if (use_key_ranges_ && range_index_ >= key_ranges_.size()) {
+    return RC::RECORD_EOF;
+  }
+
   bool filter_result = false;
-  while (OB_SUCC(rc = record_scanner_.next(current_record_))) {
+  while (true) {
+    rc = record_scanner_.next(current_record_);
+    if (rc == RC::RECORD_EOF && use_key_ranges_ && ++range_index_ < key_ranges_.size()) {
+      // 当前区间扫描完了，继续扫描下一个区间
+      rc = open_key_range();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    }
+    if (OB_FAIL(rc)) {
+      break;
+    }
+
     LOG_TRACE("got a record. rid=%s", current_record_.rid().to_string().c_str());
     
     tuple_.set_record(&current_record_);
@@ -61,13 +127,25 @@ Tuple *TableScanPhysicalOperator::current_tuple()
   return &tuple_;
 }
 
-string TableScanPhysicalOperator::param() const { return table_->name(); }
+string TableScanPhysicalOperator::param() const
+{
+  if (use_key_ranges_) {
+    return string(table_->name()) + ", primary key ranges=" + to_string(key_ranges_.size());
+  }
+  return table_->name();
+}
 
 void TableScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
 {
   predicates_ = std::move(exprs);
 }
 
+void TableScanPhysicalOperator::set_key_ranges(vector<IndexScanRange> ranges)
+{
+  use_key_ranges_ = true;
+  key_ranges_     = std::move(ranges);
+}
+
 RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 {
   RC    rc = RC::SUCCESS;
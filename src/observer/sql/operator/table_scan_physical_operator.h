@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/rc.h"
+#include "sql/operator/index_scan_physical_operator.h"
 #include "sql/operator/physical_operator.h"
 #include "storage/record/record_manager.h"
 #include "common/types.h"
@@ -41,9 +42,19 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 只扫描主键在这些区间中的记录，只有聚簇存放的表可以使用
+   * @details 区间互不相交并且按照主键顺序排列，参考 IndexRangeAnalyzer::analyze_primary_key。
+   * 区间为空时没有任何记录
+   */
+  void set_key_ranges(std::vector<IndexScanRange> ranges);
+
 private:
   RC filter(RowTuple &tuple, bool &result);
 
+  /// 让扫描器只遍历第 range_index_ 个区间
+  RC open_key_range();
+
 private:
   Table                                   *table_ = nullptr;
   Trx                                     *trx_   = nullptr;
@@ -52,4 +63,8 @@ private:
   Record                                   current_record_;
   RowTuple                                 tuple_;
   std::vector<std::unique_ptr<Expression>> predicates_;  // TODO chang predicate to table tuple filter
+
+  bool                        use_key_ranges_ = false;
+  std::vector<IndexScanRange> key_ranges_;
+  size_t                      range_index_ = 0;  ///< 当前扫描的区间
 };
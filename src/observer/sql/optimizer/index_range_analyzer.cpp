@@ -0,0 +1,340 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/index_range_analyzer.h"
+#include "common/lang/algorithm.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+
+namespace {
+
+/**
+ * @brief 交换比较的左右两边时，比较运算符也要跟着变化。比如 5 < a 等价于 a > 5
+ */
+CompOp swap_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_THAN: return GREAT_THAN;
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    default: return comp;
+  }
+}
+
+/**
+ * @brief 判断常量是否可以直接作为字段的索引键值
+ * @details 只使用类型完全相同的常量，避免类型转换改变比较的语义。超过字段长度的字符串在索引中会被截断，也不使用
+ */
+bool usable_value(const FieldMeta &field, const Value &value)
+{
+  if (value.is_null() || value.attr_type() != field.type()) {
+    return false;
+  }
+  return field.type() != AttrType::CHARS || value.length() <= field.len();
+}
+
+}  // namespace
+
+void IndexRangeAnalyzer::FieldRange::add_compare(CompOp comp, const Value &value)
+{
+  switch (comp) {
+    case EQUAL_TO: {
+      add_points({value});
+    } break;
+    case GREAT_THAN:
+    case GREAT_EQUAL: {
+      const bool inclusive = (comp == GREAT_EQUAL);
+      const int  cmp       = has_left ? value.compare(left) : 1;
+      if (cmp > 0 || (cmp == 0 && !inclusive)) {
+        has_left       = true;
+        left           = value;
+        left_inclusive = inclusive;
+      }
+    } break;
+    case LESS_THAN:
+    case LESS_EQUAL: {
+      const bool inclusive = (comp == LESS_EQUAL);
+      const int  cmp       = has_right ? value.compare(right) : -1;
+      if (cmp < 0 || (cmp == 0 && !inclusive)) {
+        has_right       = true;
+        right           = value;
+        right_inclusive = inclusive;
+      }
+    } break;
+    default: {
+      ASSERT(false, "unsupported comparison. comp=%d", comp);
+    } break;
+  }
+}
+
+void IndexRangeAnalyzer::FieldRange::add_points(std::vector<Value> values)
+{
+  auto less  = [](const Value &a, const Value &b) { return a.compare(b) < 0; };
+  auto equal = [](const Value &a, const Value &b) { return a.compare(b) == 0; };
+  sort(values.begin(), values.end(), less);
+  values.erase(unique(values.begin(), values.end(), equal), values.end());
+
+  if (!has_points) {
+    has_points = true;
+    points     = std::move(values);
+    return;
+  }
+
+  // 同一个字段上有多个等值条件或 IN 列表，取交集
+  std::vector<Value> intersection;
+  set_intersection(
+      points.begin(), points.end(), values.begin(), values.end(), std::back_inserter(intersection), less);
+  points = std::move(intersection);
+}
+
+std::vector<Value> IndexRangeAnalyzer::FieldRange::points_in_range() const
+{
+  std::vector<Value> result;
+  for (const Value &point : points) {
+    if (has_left) {
+      const int cmp = point.compare(left);
+      if (cmp < 0 || (cmp == 0 && !left_inclusive)) {
+        continue;
+      }
+    }
+    if (has_right) {
+      const int cmp = point.compare(right);
+      if (cmp > 0 || (cmp == 0 && !right_inclusive)) {
+        continue;
+      }
+    }
+    result.push_back(point);
+  }
+  return result;
+}
+
+bool IndexRangeAnalyzer::FieldRange::empty() const
+{
+  if (has_points) {
+    return points_in_range().empty();
+  }
+
+  if (has_left && has_right) {
+    const int cmp = left.compare(right);
+    return cmp > 0 || (cmp == 0 && !(left_inclusive && right_inclusive));
+  }
+  return false;
+}
+
+IndexRangeAnalyzer::IndexRangeAnalyzer(std::vector<std::unique_ptr<Expression>> &predicates)
+{
+  for (std::unique_ptr<Expression> &predicate : predicates) {
+    add_predicate(predicate.get());
+  }
+}
+
+void IndexRangeAnalyzer::add_predicate(Expression *expr)
+{
+  if (expr->type() != ExprType::COMPARISON) {
+    return;
+  }
+
+  auto   comparison_expr = static_cast<ComparisonExpr *>(expr);
+  CompOp comp            = comparison_expr->comp();
+
+  Expression *left  = comparison_expr->left().get();
+  Expression *right = comparison_expr->right().get();
+  if (left->type() != ExprType::FIELD) {
+    std::swap(left, right);
+    comp = swap_comp(comp);
+  }
+  if (left->type() != ExprType::FIELD) {
+    return;
+  }
+
+  const FieldMeta *field = static_cast<FieldExpr *>(left)->field().meta();
+  if (nullptr == field) {
+    return;
+  }
+
+  switch (comp) {
+    case EQUAL_TO:
+    case LESS_THAN:
+    case LESS_EQUAL:
+    case GREAT_THAN:
+    case GREAT_EQUAL: {
+      if (right->type() != ExprType::VALUE) {
+        return;
+      }
+      const Value &value = static_cast<ValueExpr *>(right)->get_value();
+      if (usable_value(*field, value)) {
+        field_ranges_[field->name()].add_compare(comp, value);
+      }
+    } break;
+
+    case IN_OP: {
+      // 只有一个值的 IN 列表，语法解析时就是一个普通的值
+      if (right->type() == ExprType::VALUE) {
+        const Value &value = static_cast<ValueExpr *>(right)->get_value();
+        if (usable_value(*field, value)) {
+          field_ranges_[field->name()].add_compare(EQUAL_TO, value);
+        }
+        return;
+      }
+
+      // IN 的左边必须是字段，不能交换
+      if (right->type() != ExprType::EXPRLIST || left != comparison_expr->left().get()) {
+        return;
+      }
+
+      std::vector<Value> values;
+      for (std::unique_ptr<Expression> &child : static_cast<ExprListExpr *>(right)->exprs()) {
+        if (child->type() != ExprType::VALUE) {
+          return;
+        }
+        const Value &value = static_cast<ValueExpr *>(child.get())->get_value();
+        if (value.is_null()) {
+          continue;  // null 不会与任何值相等
+        }
+        if (!usable_value(*field, value)) {
+          return;
+        }
+        values.push_back(value);
+      }
+      field_ranges_[field->name()].add_points(std::move(values));
+    } break;
+
+    default: break;
+  }
+}
+
+int IndexRangeAnalyzer::analyze(
+    const std::vector<FieldMeta> &key_fields, bool unique, std::vector<IndexScanRange> &ranges) const
+{
+  ranges.clear();
+
+  std::vector<Value> eq_values;  // 前缀等值字段的值
+  for (const FieldMeta &field : key_fields) {
+    auto iter = field_ranges_.find(field.name());
+    if (iter == field_ranges_.end()) {
+      break;
+    }
+
+    const FieldRange &field_range = iter->second;
+    if (field_range.empty()) {
+      return EMPTY_MATCH;
+    }
+
+    if (field_range.has_points) {
+      std::vector<Value> points = field_range.points_in_range();
+      if (points.size() == 1) {
+        eq_values.push_back(points.front());
+        continue;
+      }
+
+      // IN 列表，每个值一个区间。points 是递增的，区间也是递增的
+      for (const Value &point : points) {
+        IndexScanRange range;
+        range.left_values = eq_values;
+        range.left_values.push_back(point);
+        range.right_values = range.left_values;
+        ranges.push_back(std::move(range));
+      }
+      return static_cast<int>(eq_values.size()) * 4 + 3;
+    }
+
+    IndexScanRange range;
+    range.left_values  = eq_values;
+    range.right_values = eq_values;
+    if (field_range.has_left) {
+      range.left_values.push_back(field_range.left);
+      range.left_inclusive = field_range.left_inclusive;
+    }
+    if (field_range.has_right) {
+      range.right_values.push_back(field_range.right);
+      range.right_inclusive = field_range.right_inclusive;
+    }
+    ranges.push_back(std::move(range));
+    return static_cast<int>(eq_values.size()) * 4 + 1;
+  }
+
+  if (eq_values.empty()) {
+    return NO_MATCH;
+  }
+
+  IndexScanRange range;
+  range.left_values  = eq_values;
+  range.right_values = eq_values;
+  ranges.push_back(std::move(range));
+
+  const bool full_match = eq_values.size() == key_fields.size();
+  return static_cast<int>(eq_values.size()) * 4 + ((unique && full_match) ? 2 : 0);
+}
+
+Index *IndexRangeAnalyzer::choose_index(Table *table, std::vector<IndexScanRange> &ranges, int *score) const
+{
+  ranges.clear();
+  if (score != nullptr) {
+    *score = NO_MATCH;
+  }
+  if (field_ranges_.empty()) {
+    return nullptr;
+  }
+
+  Index *best_index = nullptr;
+  int    best_score = NO_MATCH;
+
+  const TableMeta &table_meta = table->table_meta();
+  for (int i = 0; i < table_meta.index_num(); i++) {
+    const IndexMeta *index_meta = table_meta.index(i);
+    Index           *index      = table->find_index(index_meta->name());
+    if (nullptr == index) {
+      continue;
+    }
+
+    // 多字段索引的第一个字段是null位图，不参与匹配
+    const std::vector<FieldMeta> &field_metas = index->field_metas();
+    std::vector<FieldMeta>        key_fields(field_metas.begin() + (field_metas.size() > 1 ? 1 : 0), field_metas.end());
+
+    std::vector<IndexScanRange> index_ranges;
+    int                         score = analyze(key_fields, index_meta->unique(), index_ranges);
+    if (index_meta->type() == IndexType::HASH && score != EMPTY_MATCH && score != NO_MATCH) {
+      // 哈希索引只能做所有字段都是等值条件的查找。可以使用时只需要访问很少的页面，比B+树索引更好
+      auto full_point = [&key_fields](const IndexScanRange &range) {
+        return range.is_point() && range.left_values.size() == key_fields.size();
+      };
+      const bool all_points = std::all_of(index_ranges.begin(), index_ranges.end(), full_point);
+      score = all_points ? static_cast<int>(key_fields.size()) * 4 + 3 : NO_MATCH;
+    }
+    if (score > best_score) {
+      best_index = index;
+      best_score = score;
+      ranges     = std::move(index_ranges);
+    }
+  }
+
+  if (best_index != nullptr) {
+    LOG_TRACE("choose index %s. score=%d, range num=%d",
+        best_index->index_meta().name(), best_score, static_cast<int>(ranges.size()));
+  }
+  if (score != nullptr) {
+    *score = best_score;
+  }
+  return best_index;
+}
+
+int IndexRangeAnalyzer::analyze_primary_key(Table *table, std::vector<IndexScanRange> &ranges) const
+{
+  ranges.clear();
+  const FieldMeta *primary_key = table->table_meta().primary_key();
+  if (field_ranges_.empty() || nullptr == primary_key) {
+    return NO_MATCH;
+  }
+
+  return analyze({*primary_key}, true /*unique*/, ranges);
+}
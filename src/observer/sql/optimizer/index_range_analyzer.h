@@ -0,0 +1,97 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sql/operator/index_scan_physical_operator.h"
+#include "sql/parser/parse_defs.h"
+
+class Expression;
+class FieldMeta;
+class Index;
+class Table;
+
+/**
+ * @brief 从过滤条件中分析索引可以使用的扫描区间
+ * @ingroup PhysicalOperator
+ * @details 收集每个字段上与常量的比较(=, <, <=, >, >=)以及 IN 列表，求出每个字段的取值范围。
+ * 对于一个索引，从第一个字段开始，连续的等值字段组成前缀，后面最多再跟一个范围或 IN 列表字段。
+ * 扫描区间只是缩小扫描的数据范围，所有的过滤条件仍然需要在索引扫描算子中执行。
+ */
+class IndexRangeAnalyzer
+{
+public:
+  /// 匹配程度，越大越好。0 表示索引不能使用
+  static constexpr int NO_MATCH    = 0;
+  static constexpr int EMPTY_MATCH = 1 << 30;  ///< 过滤条件互相矛盾，扫描区间是空的
+
+public:
+  explicit IndexRangeAnalyzer(std::vector<std::unique_ptr<Expression>> &predicates);
+
+  /**
+   * @brief 计算索引上的扫描区间
+   * @param key_fields 索引的字段，不包含null位图
+   * @param unique 是否是唯一索引。唯一索引的所有字段都是等值条件时，优先使用
+   * @param[out] ranges 扫描区间，互不相交并且按照索引顺序排列。条件矛盾时为空
+   * @return 匹配程度
+   */
+  int analyze(const std::vector<FieldMeta> &key_fields, bool unique, std::vector<IndexScanRange> &ranges) const;
+
+  /**
+   * @brief 在表的所有索引中选择匹配程度最高的索引
+   * @details 哈希索引只有在所有字段都是等值条件(或者 IN 列表)时才能使用，这时优先于B+树索引
+   * @param[out] score 不为空时返回选中的索引的匹配程度，没有可用的索引时是 NO_MATCH
+   * @return 没有可用的索引时返回 nullptr
+   */
+  Index *choose_index(Table *table, std::vector<IndexScanRange> &ranges, int *score = nullptr) const;
+
+  /**
+   * @brief 计算聚簇存放的表在主键上的扫描区间
+   * @details 聚簇存放的表按照主键存放记录，主键相当于一个包含所有字段的唯一索引
+   * @return 匹配程度，表不是聚簇存放时返回 NO_MATCH
+   */
+  int analyze_primary_key(Table *table, std::vector<IndexScanRange> &ranges) const;
+
+private:
+  /**
+   * @brief 一个字段的取值范围
+   * @details 等值条件和 IN 列表记录在 points 中，其它比较条件记录为左右边界
+   */
+  struct FieldRange
+  {
+    bool  has_left       = false;
+    bool  left_inclusive = false;
+    Value left;
+
+    bool  has_right       = false;
+    bool  right_inclusive = false;
+    Value right;
+
+    bool               has_points = false;
+    std::vector<Value> points;  ///< 递增并且没有重复
+
+    void add_compare(CompOp comp, const Value &value);
+    void add_points(std::vector<Value> values);
+
+    /// 在左右边界范围内的点
+    std::vector<Value> points_in_range() const;
+    bool               empty() const;
+  };
+
+  void add_predicate(Expression *expr);
+
+private:
+  std::map<std::string, FieldRange> field_ranges_;  ///< 字段名称 -> 取值范围
+};
@@ -0,0 +1,171 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/join_condition_pushdown_rewriter.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "storage/table/table.h"
+
+RC JoinConditionPushdownRewriter::rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  if (oper->type() != LogicalOperatorType::PREDICATE || oper->children().size() != 1) {
+    return RC::SUCCESS;
+  }
+
+  LogicalOperator &child = *oper->children().front();
+  if (child.type() != LogicalOperatorType::JOIN && child.type() != LogicalOperatorType::PREDICATE) {
+    return RC::SUCCESS;
+  }
+
+  bool                                      pushed = false;
+  std::vector<std::unique_ptr<Expression>> &exprs  = oper->expressions();
+  for (auto iter = exprs.begin(); iter != exprs.end();) {
+    pushdown(*iter, child, pushed);
+    if (!*iter) {
+      iter = exprs.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  if (!pushed) {
+    return RC::SUCCESS;
+  }
+
+  change_made = true;
+  if (exprs.empty()) {
+    // 所有的条件都放到了连接算子上，不再需要这个谓词算子
+    LOG_TRACE("all conditions of predicate operator were pushed down to join operators, remove it");
+    std::unique_ptr<LogicalOperator> child_oper = std::move(oper->children().front());
+    oper                                        = std::move(child_oper);
+  }
+  return RC::SUCCESS;
+}
+
+void JoinConditionPushdownRewriter::pushdown(
+    std::unique_ptr<Expression> &expr, LogicalOperator &child, bool &change_made)
+{
+  if (expr->type() == ExprType::CONJUNCTION) {
+    auto conjunction_expr = static_cast<ConjunctionExpr *>(expr.get());
+    if (conjunction_expr->conjunction_type() != ConjunctionExpr::Type::AND) {
+      return;
+    }
+
+    std::vector<std::unique_ptr<Expression>> &child_exprs = conjunction_expr->children();
+    for (auto iter = child_exprs.begin(); iter != child_exprs.end();) {
+      pushdown(*iter, child, change_made);
+      if (!*iter) {
+        iter = child_exprs.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+
+    if (child_exprs.empty()) {
+      expr.reset();
+    }
+    return;
+  }
+
+  const char *left_table  = nullptr;
+  const char *right_table = nullptr;
+  if (!is_join_condition(*expr, left_table, right_table)) {
+    return;
+  }
+
+  if (push_to_join(child, expr, left_table, right_table)) {
+    change_made = true;
+  }
+}
+
+bool JoinConditionPushdownRewriter::push_to_join(
+    LogicalOperator &oper, std::unique_ptr<Expression> &expr, const char *left_table, const char *right_table)
+{
+  if (oper.type() == LogicalOperatorType::PREDICATE) {
+    return oper.children().size() == 1 && push_to_join(*oper.children().front(), expr, left_table, right_table);
+  }
+
+  if (oper.type() != LogicalOperatorType::JOIN || oper.children().size() != 2) {
+    return false;
+  }
+
+  LogicalOperator &left_child  = *oper.children()[0];
+  LogicalOperator &right_child = *oper.children()[1];
+
+  const bool left_in_left   = contains_table(left_child, left_table);
+  const bool right_in_left  = contains_table(left_child, right_table);
+  const bool left_in_right  = contains_table(right_child, left_table);
+  const bool right_in_right = contains_table(right_child, right_table);
+
+  if (left_in_left && right_in_left) {
+    return push_to_join(left_child, expr, left_table, right_table);
+  }
+  if (left_in_right && right_in_right) {
+    return push_to_join(right_child, expr, left_table, right_table);
+  }
+
+  if (right_in_left && left_in_right) {
+    // 比较的左边要对应左孩子
+    auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+    std::swap(comparison_expr->left(), comparison_expr->right());
+  } else if (!(left_in_left && right_in_right)) {
+    return false;
+  }
+
+  oper.expressions().emplace_back(std::move(expr));
+  return true;
+}
+
+bool JoinConditionPushdownRewriter::is_join_condition(Expression &expr, const char *&left_table, const char *&right_table)
+{
+  if (expr.type() != ExprType::COMPARISON) {
+    return false;
+  }
+
+  auto comparison_expr = static_cast<ComparisonExpr *>(&expr);
+  if (comparison_expr->comp() != EQUAL_TO || comparison_expr->left()->type() != ExprType::FIELD ||
+      comparison_expr->right()->type() != ExprType::FIELD) {
+    return false;
+  }
+
+  const Field &left_field  = static_cast<FieldExpr *>(comparison_expr->left().get())->field();
+  const Field &right_field = static_cast<FieldExpr *>(comparison_expr->right().get())->field();
+  if (left_field.table() == nullptr || left_field.meta() == nullptr || right_field.table() == nullptr ||
+      right_field.meta() == nullptr) {
+    return false;
+  }
+
+  // 哈希连接按照值的二进制内容计算哈希值，两边类型必须相同
+  const AttrType attr_type = left_field.attr_type();
+  if (attr_type != right_field.attr_type() || attr_type == AttrType::FLOATS || attr_type == AttrType::DOUBLES) {
+    return false;
+  }
+
+  left_table  = left_field.table_name();
+  right_table = right_field.table_name();
+  return 0 != strcmp(left_table, right_table);
+}
+
+bool JoinConditionPushdownRewriter::contains_table(LogicalOperator &oper, const char *table_name)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    return 0 == strcmp(static_cast<TableGetLogicalOperator &>(oper).table()->name(), table_name);
+  }
+
+  for (std::unique_ptr<LogicalOperator> &child : oper.children()) {
+    if (contains_table(*child, table_name)) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,52 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/optimizer/rewrite_rule.h"
+
+class ComparisonExpr;
+
+/**
+ * @brief 把等值连接条件下推到连接算子中
+ * @ingroup Rewriter
+ * @details 连接条件(ON 和 WHERE 中的条件)生成的谓词算子都在连接算子的上面，
+ * 比如 `select * from a, b, c where a.id=b.id and b.id=c.id` 的逻辑计划是：
+ * Predicate(a.id=b.id and b.id=c.id) -> Join(Join(a, b), c)。
+ * 这个规则把 `t1.x=t2.y` 形式的条件放到最下面的、两边分别包含t1和t2的连接算子上，
+ * 上面的例子中 a.id=b.id 放到 Join(a, b) 上，b.id=c.id 放到外面的连接上。
+ * 这样物理计划就可以使用哈希连接，而不是先做笛卡尔积再过滤。
+ * 当前只有内连接，所以条件可以放到任意一层连接上。
+ * 浮点数比较的时候有误差，不能计算哈希值，所以不下推。
+ */
+class JoinConditionPushdownRewriter : public RewriteRule
+{
+public:
+  JoinConditionPushdownRewriter()          = default;
+  virtual ~JoinConditionPushdownRewriter() = default;
+
+  RC rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  /**
+   * @brief 把 expr 中能下推的条件放到 child 下面的连接算子上
+   * @details 下推的条件会从 expr 中删除，全部下推时 expr 变成空的
+   */
+  void pushdown(std::unique_ptr<Expression> &expr, LogicalOperator &child, bool &change_made);
+
+  /// 找到条件对应的连接算子并放进去，找不到时返回false，不修改条件
+  static bool push_to_join(LogicalOperator &oper, std::unique_ptr<Expression> &expr, const char *left_table,
+      const char *right_table);
+
+  /// 是否是两个不同表的字段的等值比较，是的话返回两个字段所在的表
+  static bool is_join_condition(Expression &expr, const char *&left_table, const char *&right_table);
+
+  static bool contains_table(LogicalOperator &oper, const char *table_name);
+};
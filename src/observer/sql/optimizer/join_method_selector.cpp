@@ -0,0 +1,173 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/join_method_selector.h"
+#include "common/lang/algorithm.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+
+JoinMethodChoice JoinMethodSelector::choose(JoinLogicalOperator &join_oper) const
+{
+  std::vector<std::unique_ptr<LogicalOperator>> &children   = join_oper.children();
+  std::vector<std::unique_ptr<Expression>>      &conditions = join_oper.expressions();
+
+  JoinMethodChoice best;
+  if (children.size() != 2) {
+    return best;
+  }
+
+  const double rows[2] = {estimate_rows(*children[0]), estimate_rows(*children[1])};
+  best.cost            = rows[0] * rows[1];
+  if (conditions.empty()) {
+    return best;
+  }
+
+  auto consider = [&best](JoinMethodChoice choice) {
+    if (choice.cost < best.cost) {
+      best = choice;
+    }
+  };
+
+  if (options_.enabled) {
+    const int    build_side  = rows[0] <= rows[1] ? 0 : 1;
+    const double build_bytes = rows[build_side] * estimate_row_bytes(*children[build_side]);
+
+    JoinMethodChoice choice;
+    choice.method = JoinMethod::HASH;
+    choice.cost   = (rows[0] + rows[1]) * (build_bytes > options_.memory ? SPILL_FACTOR : 1);
+    consider(choice);
+  }
+
+  for (size_t i = 0; i < conditions.size(); i++) {
+    Expression *condition = conditions[i].get();
+    if (condition->type() != ExprType::COMPARISON) {
+      continue;
+    }
+    auto comparison_expr = static_cast<ComparisonExpr *>(condition);
+    if (comparison_expr->comp() != EQUAL_TO) {
+      continue;
+    }
+
+    Index *indexes[2] = {
+        find_key_index(*children[0], *comparison_expr->left()), find_key_index(*children[1], *comparison_expr->right())};
+
+    for (int inner_side : {1, 0}) {
+      if (nullptr == indexes[inner_side]) {
+        continue;
+      }
+      JoinMethodChoice choice;
+      choice.method              = JoinMethod::INDEX_NESTED_LOOP;
+      choice.condition           = static_cast<int>(i);
+      choice.inner_side          = inner_side;
+      choice.indexes[inner_side] = indexes[inner_side];
+      choice.cost                = rows[1 - inner_side] * INDEX_LOOKUP_FACTOR;
+      consider(choice);
+    }
+
+    if (indexes[0] != nullptr && indexes[1] != nullptr) {
+      JoinMethodChoice choice;
+      choice.method     = JoinMethod::MERGE;
+      choice.condition  = static_cast<int>(i);
+      choice.indexes[0] = indexes[0];
+      choice.indexes[1] = indexes[1];
+      choice.cost       = (rows[0] + rows[1]) * INDEX_SCAN_FACTOR;
+      consider(choice);
+    }
+  }
+
+  LOG_TRACE("choose join method %d. left rows=%.0f, right rows=%.0f, cost=%.0f",
+            static_cast<int>(best.method), rows[0], rows[1], best.cost);
+  return best;
+}
+
+double JoinMethodSelector::estimate_rows(LogicalOperator &oper)
+{
+  std::vector<std::unique_ptr<LogicalOperator>> &children = oper.children();
+  switch (oper.type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      auto  &table_get_oper = static_cast<TableGetLogicalOperator &>(oper);
+      double rows           = std::max<double>(1, table_get_oper.table()->estimated_record_num());
+      return table_get_oper.predicates().empty() ? rows : std::max(1.0, rows * SELECTIVITY);
+    }
+    case LogicalOperatorType::JOIN: {
+      if (children.size() != 2) {
+        return DEFAULT_ROWS;
+      }
+      const double left  = estimate_rows(*children[0]);
+      const double right = estimate_rows(*children[1]);
+      return oper.expressions().empty() ? left * right : std::max(left, right);
+    }
+    case LogicalOperatorType::PREDICATE: {
+      return children.empty() ? DEFAULT_ROWS : std::max(1.0, estimate_rows(*children[0]) * SELECTIVITY);
+    }
+    default: {
+      return children.empty() ? DEFAULT_ROWS : estimate_rows(*children[0]);
+    }
+  }
+}
+
+double JoinMethodSelector::estimate_row_bytes(LogicalOperator &oper)
+{
+  std::vector<std::unique_ptr<LogicalOperator>> &children = oper.children();
+  switch (oper.type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      return static_cast<TableGetLogicalOperator &>(oper).table()->table_meta().record_size();
+    }
+    case LogicalOperatorType::JOIN: {
+      double bytes = 0;
+      for (std::unique_ptr<LogicalOperator> &child : children) {
+        bytes += estimate_row_bytes(*child);
+      }
+      return bytes;
+    }
+    default: {
+      return children.empty() ? DEFAULT_ROW_BYTES : estimate_row_bytes(*children[0]);
+    }
+  }
+}
+
+Index *JoinMethodSelector::find_key_index(LogicalOperator &child, Expression &key)
+{
+  if (child.type() != LogicalOperatorType::TABLE_GET || key.type() != ExprType::FIELD) {
+    return nullptr;
+  }
+
+  auto &table_get_oper = static_cast<TableGetLogicalOperator &>(child);
+  if (table_get_oper.read_write_mode() != ReadWriteMode::READ_ONLY) {
+    return nullptr;
+  }
+
+  Table     *table      = table_get_oper.table();
+  auto      &field_expr = static_cast<FieldExpr &>(key);
+  if (0 != strcmp(field_expr.table_name(), table->name())) {
+    return nullptr;
+  }
+
+  // 哈希索引不能按照顺序扫描，也不能扫描出NULL键值的行，只使用B+树索引
+  const TableMeta &table_meta = table->table_meta();
+  for (int i = 0; i < table_meta.index_num(); i++) {
+    const IndexMeta                *index_meta = table_meta.index(i);
+    const std::vector<std::string> &fields     = index_meta->field();
+    if (index_meta->type() != IndexType::BPLUS_TREE || fields.empty() ||
+        0 != strcmp(fields.at(fields.size() > 1 ? 1 : 0).c_str(), field_expr.field_name())) {
+      continue;
+    }
+
+    Index *index = table->find_index(index_meta->name());
+    if (index != nullptr) {
+      return index;
+    }
+  }
+  return nullptr;
+}
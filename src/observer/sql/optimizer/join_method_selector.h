@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/hash_join_physical_operator.h"
+
+class Expression;
+class Index;
+class JoinLogicalOperator;
+class LogicalOperator;
+
+/**
+ * @brief 连接算法
+ * @ingroup PhysicalOperator
+ */
+enum class JoinMethod
+{
+  NESTED_LOOP,        ///< 嵌套循环连接，连接条件放到上面的过滤算子中
+  HASH,               ///< 哈希连接
+  INDEX_NESTED_LOOP,  ///< 索引嵌套循环连接，内表使用连接字段上的索引查找
+  MERGE,              ///< 归并连接，两边都按照连接字段上的索引顺序扫描
+};
+
+/**
+ * @brief 选择的连接算法以及使用的索引
+ * @ingroup PhysicalOperator
+ */
+struct JoinMethodChoice
+{
+  JoinMethod method     = JoinMethod::NESTED_LOOP;
+  int        condition  = 0;                   ///< 使用索引的是哪一个连接条件
+  int        inner_side = 1;                   ///< 索引嵌套循环连接的内表是左孩子(0)还是右孩子(1)
+  Index     *indexes[2] = {nullptr, nullptr};  ///< 左右孩子按照哪个索引扫描，为空表示不使用索引
+  double     cost       = 0;
+};
+
+/**
+ * @brief 为连接算子选择连接算法
+ * @ingroup PhysicalOperator
+ * @details 当前没有统计信息，使用表的数据页面估算行数(Table::estimated_record_num)，
+ * 有过滤条件的表按照固定的选择率打折，有连接条件的连接结果按照较大的一边估算。
+ * 代价以顺序处理一行为单位：
+ * - 嵌套循环连接是 L*R；
+ * - 哈希连接是 L+R，较小的一边超过内存限制时需要写临时文件，再乘以 SPILL_FACTOR；
+ * - 索引嵌套循环连接的内表必须是只读的单表，并且连接字段是某个B+树索引的第一个字段，代价是外表行数乘以一次索引查找的代价；
+ * - 归并连接要求两边都满足上面的条件，按照索引顺序扫描整个表，每一行都需要回表，代价是 (L+R)*INDEX_SCAN_FACTOR。
+ * 当前的计划生成没有排序算子，所以只有两边都有合适的索引时才使用归并连接，不会为了归并连接增加排序。
+ */
+class JoinMethodSelector
+{
+public:
+  static constexpr double SELECTIVITY         = 0.1;  ///< 有过滤条件时，估算的表中满足条件的比例
+  static constexpr double SPILL_FACTOR        = 3;    ///< 哈希连接写临时文件时，代价是在内存中的多少倍
+  static constexpr double INDEX_LOOKUP_FACTOR = 5;    ///< 一次索引查找相当于顺序处理多少行
+  static constexpr double INDEX_SCAN_FACTOR   = 2;    ///< 按照索引顺序读取一行相当于顺序处理多少行
+  static constexpr double DEFAULT_ROWS        = 1000;
+  static constexpr double DEFAULT_ROW_BYTES   = 64;
+
+public:
+  explicit JoinMethodSelector(const HashJoinOptions &options) : options_(options) {}
+
+  /**
+   * @brief 选择代价最小的连接算法
+   * @details 没有连接条件时只能使用嵌套循环连接。配置关闭了哈希连接时不考虑哈希连接
+   */
+  JoinMethodChoice choose(JoinLogicalOperator &join_oper) const;
+
+  /// 估算逻辑算子输出多少行
+  static double estimate_rows(LogicalOperator &oper);
+  /// 估算逻辑算子输出的一行有多大，用于判断哈希连接是否会超过内存限制
+  static double estimate_row_bytes(LogicalOperator &oper);
+
+  /**
+   * @brief 查找可以按照连接字段查找或者顺序扫描的索引
+   * @details child 必须是只读的 TABLE_GET，key 是这个表的字段，并且是某个B+树索引的第一个字段
+   * @return 没有合适的索引时返回 nullptr
+   */
+  static Index *find_key_index(LogicalOperator &child, Expression &key);
+
+private:
+  HashJoinOptions options_;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include "common/rc.h"
@@ -262,10 +263,88 @@ private:
       top_oper = std::move(project_oper);
     }
 
+    std::vector<Field> used_fields;
+    collect_used_fields(*top_oper, used_fields);
+    set_used_fields(*top_oper, used_fields);
+
     logical_operator.swap(top_oper);
     return RC::SUCCESS;
   }
 
+  /**
+   * @brief 收集查询计划中所有表达式用到的字段
+   * @details 子查询中引用外层表的字段没有收集，这种情况由索引扫描算子在执行时读取记录
+   */
+  static void collect_used_fields(LogicalOperator &oper, std::vector<Field> &fields)
+  {
+    auto collect = [&fields](Expression *expr) {
+      expr->traverse([&fields](Expression *child) {
+        if (child->type() == ExprType::FIELD) {
+          fields.push_back(static_cast<FieldExpr *>(child)->field());
+        }
+      });
+    };
+
+    for (std::unique_ptr<Expression> &expr : oper.expressions()) {
+      collect(expr.get());
+    }
+    switch (oper.type()) {
+      case LogicalOperatorType::TABLE_GET: {
+        for (std::unique_ptr<Expression> &expr : static_cast<TableGetLogicalOperator &>(oper).predicates()) {
+          collect(expr.get());
+        }
+      } break;
+      case LogicalOperatorType::GROUP_BY: {
+        auto &group_by_oper = static_cast<GroupByLogicalOperator &>(oper);
+        for (std::unique_ptr<Expression> &expr : group_by_oper.group_by_expressions()) {
+          collect(expr.get());
+        }
+        for (std::unique_ptr<AggrFuncExpr> &expr : group_by_oper.aggregate_expressions()) {
+          collect(expr.get());
+        }
+        for (std::unique_ptr<FieldExpr> &expr : group_by_oper.field_exprs()) {
+          collect(expr.get());
+        }
+      } break;
+      case LogicalOperatorType::ORDER_BY: {
+        auto &orderby_oper = static_cast<OrderByLogicalOperator &>(oper);
+        for (std::unique_ptr<OrderByUnit> &unit : orderby_oper.orderby_units()) {
+          collect(unit->expr().get());
+        }
+        for (std::unique_ptr<Expression> &expr : orderby_oper.exprs()) {
+          collect(expr.get());
+        }
+      } break;
+      default: break;
+    }
+
+    for (std::unique_ptr<LogicalOperator> &child : oper.children()) {
+      collect_used_fields(*child, fields);
+    }
+  }
+
+  /// 把用到的字段按照表分给每个 TableGetLogicalOperator
+  static void set_used_fields(LogicalOperator &oper, const std::vector<Field> &fields)
+  {
+    if (oper.type() == LogicalOperatorType::TABLE_GET) {
+      auto              &table_get_oper = static_cast<TableGetLogicalOperator &>(oper);
+      std::vector<Field> table_fields;
+      for (const Field &field : fields) {
+        if (field.table() == table_get_oper.table() && field.meta() != nullptr &&
+            std::none_of(table_fields.begin(), table_fields.end(), [&field](const Field &other) {
+              return other.meta() == field.meta();
+            })) {
+          table_fields.push_back(field);
+        }
+      }
+      table_get_oper.set_fields(std::move(table_fields));
+    }
+
+    for (std::unique_ptr<LogicalOperator> &child : oper.children()) {
+      set_used_fields(*child, fields);
+    }
+  }
+
   static std::unique_ptr<PredicateLogicalOperator> cmp_exprs2predicate_logic_oper(std::vector<std::unique_ptr<Expression>> cmp_exprs)
   {
     if (!cmp_exprs.empty()) {
@@ -32,11 +32,16 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/explain_physical_operator.h"
 #include "sql/operator/expr_vec_physical_operator.h"
 #include "sql/operator/group_by_vec_physical_operator.h"
+#include "sql/operator/hash_join_physical_operator.h"
+#include "sql/operator/index_nested_loop_join_physical_operator.h"
 #include "sql/operator/index_scan_physical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/insert_physical_operator.h"
 #include "sql/operator/join_logical_operator.h"
 #include "sql/operator/join_physical_operator.h"
+#include "sql/operator/merge_join_physical_operator.h"
+#include "sql/operator/orderby_logical_operator.h"
+#include "sql/operator/orderby_physical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/predicate_physical_operator.h"
 #include "sql/operator/project_logical_operator.h"
@@ -49,6 +54,9 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/hash_group_by_physical_operator.h"
 #include "sql/operator/scalar_group_by_physical_operator.h"
 #include "sql/operator/table_scan_vec_physical_operator.h"
+#include "sql/optimizer/index_range_analyzer.h"
+#include "sql/optimizer/join_method_selector.h"
+#include "storage/index/index.h"
 
 
 class TableGetLogicalOperator;
@@ -108,6 +116,10 @@ public:
         return create_plan(static_cast<GroupByLogicalOperator &>(logical_operator), oper);
       } break;
 
+      case LogicalOperatorType::ORDER_BY: {
+        return create_plan(static_cast<OrderByLogicalOperator &>(logical_operator), oper);
+      } break;
+
       default: {
         ASSERT(false, "unknown logical operator type");
         return RC::INVALID_ARGUMENT;
@@ -143,60 +155,51 @@ private:
   static RC create_plan(TableGetLogicalOperator &table_get_oper, std::unique_ptr<PhysicalOperator> &oper)
   {
     std::vector<std::unique_ptr<Expression>> &predicates = table_get_oper.predicates();
-    // 看看是否有可以用于索引查找的表达式
+    // 看看是否有可以用于索引查找的表达式。范围比较和 IN 列表也可以使用索引，多字段索引可以使用前缀
     Table *table = table_get_oper.table();
 
-    Index     *index      = nullptr;
-    ValueExpr *value_expr = nullptr;
-    for (auto &expr : predicates) {
-      if (expr->type() == ExprType::COMPARISON) {
-        auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-        // 简单处理，就找等值查询
-        if (comparison_expr->comp() != EQUAL_TO) {
-          continue;
-        }
-
-        std::unique_ptr<Expression> &left_expr  = comparison_expr->left();
-        std::unique_ptr<Expression> &right_expr = comparison_expr->right();
-        // 左右比较的一边最少是一个值
-        if (left_expr->type() != ExprType::VALUE && right_expr->type() != ExprType::VALUE) {
-          continue;
-        }
-
-        FieldExpr *field_expr = nullptr;
-        if (left_expr->type() == ExprType::FIELD) {
-          ASSERT(right_expr->type() == ExprType::VALUE, "right expr should be a value expr while left is field expr");
-          field_expr = static_cast<FieldExpr *>(left_expr.get());
-          value_expr = static_cast<ValueExpr *>(right_expr.get());
-        } else if (right_expr->type() == ExprType::FIELD) {
-          ASSERT(left_expr->type() == ExprType::VALUE, "left expr should be a value expr while right is a field expr");
-          field_expr = static_cast<FieldExpr *>(right_expr.get());
-          value_expr = static_cast<ValueExpr *>(left_expr.get());
-        }
-
-        if (field_expr == nullptr) {
-          continue;
-        }
+    std::vector<IndexScanRange> ranges;
+    IndexRangeAnalyzer          analyzer(predicates);
+    int                         index_score = IndexRangeAnalyzer::NO_MATCH;
+    Index                      *index       = analyzer.choose_index(table, ranges, &index_score);
 
-        const Field &field = field_expr->field();
-        index              = table->find_index_by_field(field.field_name());
-        if (nullptr != index) {
-          break;
+    // 聚簇存放的表按照主键存放记录，主键上的条件不比其它索引差时直接扫描主键区间，不需要回表
+    std::vector<IndexScanRange> key_ranges;
+    const int                   key_score = analyzer.analyze_primary_key(table, key_ranges);
+    if (key_score != IndexRangeAnalyzer::NO_MATCH && key_score >= index_score) {
+      auto table_scan_oper = new TableScanPhysicalOperator(table, table_get_oper.read_write_mode());
+      table_scan_oper->set_key_ranges(std::move(key_ranges));
+      table_scan_oper->set_predicates(std::move(predicates));
+      oper = std::unique_ptr<PhysicalOperator>(table_scan_oper);
+      LOG_TRACE("use primary key range scan");
+    } else if (index != nullptr) {
+      // 过滤条件仍然全部交给索引扫描算子执行，扫描区间只是缩小了数据范围
+      IndexScanPhysicalOperator *index_scan_oper =
+          new IndexScanPhysicalOperator(table, index, table_get_oper.read_write_mode(), std::move(ranges));
+
+      // 查询用到的这个表的字段(包括上层算子用到的)都在索引中时，只扫描索引，不需要回表
+      if (table_get_oper.read_write_mode() == ReadWriteMode::READ_ONLY && index->field_metas().size() > 1) {
+        const std::vector<FieldMeta> &index_fields = index->field_metas();
+
+        auto in_index = [&index_fields](const FieldMeta *field_meta) {
+          return nullptr != field_meta &&
+                 std::any_of(index_fields.begin(), index_fields.end(), [field_meta](const FieldMeta &index_field) {
+                   return 0 == strcmp(index_field.name(), field_meta->name());
+                 });
+        };
+
+        bool covered = std::all_of(table_get_oper.fields().begin(),
+            table_get_oper.fields().end(),
+            [&in_index](const Field &field) { return in_index(field.meta()); });
+        for (std::unique_ptr<Expression> &predicate : predicates) {
+          predicate->traverse([&in_index, &covered](Expression *expr) {
+            if (expr->type() == ExprType::FIELD && !in_index(static_cast<FieldExpr *>(expr)->field().meta())) {
+              covered = false;
+            }
+          });
         }
+        index_scan_oper->set_index_only(covered);
       }
-    }
-
-    if (index != nullptr) {
-      ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
-
-      const Value               &value           = value_expr->get_value();
-      IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table,
-          index,
-          table_get_oper.read_write_mode(),
-          &value,
-          true /*left_inclusive*/,
-          &value,
-          true /*right_inclusive*/);
 
       index_scan_oper->set_predicates(std::move(predicates));
       oper = std::unique_ptr<PhysicalOperator>(index_scan_oper);
@@ -318,19 +321,74 @@ private:
       return RC::INTERNAL;
     }
 
-    std::unique_ptr<PhysicalOperator> join_physical_oper(new NestedLoopJoinPhysicalOperator);
-    for (auto &child_oper : child_opers) {
+    // 按照估算的代价选择连接算法。嵌套循环连接的连接条件放到上面的过滤算子中
+    std::vector<std::unique_ptr<Expression>> &conditions = join_oper.expressions();
+    HashJoinOptions                           options    = HashJoinOptions::from_config();
+    JoinMethodChoice                          choice     = JoinMethodSelector(options).choose(join_oper);
+
+    std::vector<std::unique_ptr<Expression>> left_keys;
+    std::vector<std::unique_ptr<Expression>> right_keys;
+    if (choice.method != JoinMethod::NESTED_LOOP) {
+      // 使用索引的连接条件放在第一个
+      std::swap(conditions[0], conditions[choice.condition]);
+      for (std::unique_ptr<Expression> &condition : conditions) {
+        auto comparison_expr = static_cast<ComparisonExpr *>(condition.get());
+        left_keys.emplace_back(std::move(comparison_expr->left()));
+        right_keys.emplace_back(std::move(comparison_expr->right()));
+      }
+      conditions.clear();
+    }
+
+    std::unique_ptr<PhysicalOperator> join_physical_oper;
+    switch (choice.method) {
+      case JoinMethod::HASH: {
+        join_physical_oper =
+            std::make_unique<HashJoinPhysicalOperator>(std::move(left_keys), std::move(right_keys), options);
+        LOG_TRACE("use hash join");
+      } break;
+      case JoinMethod::INDEX_NESTED_LOOP: {
+        join_physical_oper = std::make_unique<IndexNestedLoopJoinPhysicalOperator>(
+            choice.inner_side, std::move(left_keys), std::move(right_keys));
+        LOG_TRACE("use index nested loop join");
+      } break;
+      case JoinMethod::MERGE: {
+        join_physical_oper = std::make_unique<MergeJoinPhysicalOperator>(std::move(left_keys), std::move(right_keys));
+        LOG_TRACE("use merge join");
+      } break;
+      default: {
+        join_physical_oper = std::make_unique<NestedLoopJoinPhysicalOperator>();
+      } break;
+    }
+
+    for (int side : {0, 1}) {
       std::unique_ptr<PhysicalOperator> child_physical_oper;
-      rc = create(*child_oper, child_physical_oper);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to create physical child oper. rc=%s", strrc(rc));
-        return rc;
+      if (choice.indexes[side] != nullptr) {
+        // 索引嵌套循环连接的内表和归并连接的两边都按照连接字段上的索引扫描，扫描区间由连接算子决定
+        auto &table_get_oper = static_cast<TableGetLogicalOperator &>(*child_opers[side]);
+        auto  index_scan_oper = std::make_unique<IndexScanPhysicalOperator>(table_get_oper.table(),
+            choice.indexes[side],
+            table_get_oper.read_write_mode(),
+            std::vector<IndexScanRange>{IndexScanRange()});
+        index_scan_oper->set_predicates(std::move(table_get_oper.predicates()));
+        child_physical_oper = std::move(index_scan_oper);
+      } else {
+        rc = create(*child_opers[side], child_physical_oper);
+        if (rc != RC::SUCCESS) {
+          LOG_WARN("failed to create physical child oper. rc=%s", strrc(rc));
+          return rc;
+        }
       }
 
       join_physical_oper->add_child(std::move(child_physical_oper));
     }
 
-    oper = std::move(join_physical_oper);
+    if (!conditions.empty()) {
+      auto conjunction_expr = std::make_unique<ConjunctionExpr>(ConjunctionExpr::Type::AND, conditions);
+      oper = std::make_unique<PredicatePhysicalOperator>(std::move(conjunction_expr));
+      oper->add_child(std::move(join_physical_oper));
+    } else {
+      oper = std::move(join_physical_oper);
+    }
     return rc;
   }
   static RC create_plan(CalcLogicalOperator& logical_oper, std::unique_ptr<PhysicalOperator>& oper) {
@@ -366,6 +424,33 @@ private:
     LOG_TRACE("create a groupby physical operator");
     return rc;
   }
+
+  static RC create_plan(OrderByLogicalOperator &orderby_oper, std::unique_ptr<PhysicalOperator> &oper)
+  {
+    std::vector<std::unique_ptr<LogicalOperator>> &child_opers = orderby_oper.children();
+    std::unique_ptr<PhysicalOperator>              child_phy_oper;
+
+    RC rc = RC::SUCCESS;
+    if (!child_opers.empty()) {
+      rc = create(*child_opers.front(), child_phy_oper);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to create orderby logical operator's child physical operator. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+
+    auto orderby_operator = std::make_unique<OrderByPhysicalOperator>(
+        std::move(orderby_oper.orderby_units()), std::move(orderby_oper.exprs()));
+    orderby_operator->set_options(SortOptions::from_config());
+    orderby_operator->set_limit(orderby_oper.limit());
+    if (child_phy_oper) {
+      orderby_operator->add_child(std::move(child_phy_oper));
+    }
+
+    oper = std::move(orderby_operator);
+    LOG_TRACE("create an orderby physical operator. limit=%ld", orderby_oper.limit());
+    return rc;
+  }
   static RC create_vec_plan(ProjectLogicalOperator& project_oper, std::unique_ptr<PhysicalOperator>& oper) {
     std::vector<std::unique_ptr<LogicalOperator>> &child_opers = project_oper.children();
 
@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 #include <string>
 
+#include "common/types.h"
 #include "sql/parser/value.h"
 
 class Expression;
@@ -194,6 +195,7 @@ struct AttrInfoSqlNode
   std::string name;      ///< Attribute name
   size_t      length;    ///< Length of attribute
   bool        nullable;  ///< Nullable
+  bool        primary_key = false;  ///< 是否主键，只有聚簇存放的表可以指定主键
 };
 
 /**
@@ -227,6 +229,7 @@ struct DropTableSqlNode
 struct CreateIndexSqlNode
 {
   bool                     unique;         ///< Unique Index
+  IndexType                index_type = IndexType::BPLUS_TREE;  ///< Index type
   std::string              index_name;     ///< Index name
   std::string              relation_name;  ///< Relation name
   std::vector<std::string> attr_names;     ///< Attribute names
@@ -1,7 +1,8 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,13 +45,10 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
+/* Identify Bison output, and Bison version.  */
 #define YYBISON 30802
 
-/* Bison version.  */
+/* Bison version string.  */
 #define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
@@ -61,9 +63,13 @@
 /* Pull parsers.  */
 #define YYPULL 1
 
+
+
+
 /* First part of user prologue.  */
 #line 2 "yacc_sql.y"
 
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -84,20 +90,22 @@ string token_name(const char *sql_string, YYLTYPE *llocp)
   return string(sql_string + llocp->first_column, llocp->last_column - llocp->first_column + 1);
 }
 
-int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result, yyscan_t scanner, const char *msg,
-    bool flag = false)
+int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result, yyscan_t scanner, const char *msg, bool flag = false)
 {
   std::unique_ptr<ParsedSqlNode> error_sql_node = std::make_unique<ParsedSqlNode>(SCF_ERROR);
-  error_sql_node->error.error_msg               = msg;
-  error_sql_node->error.line                    = llocp->first_line;
-  error_sql_node->error.column                  = llocp->first_column;
-  error_sql_node->error.flag                    = flag;
+  error_sql_node->error.error_msg = msg;
+  error_sql_node->error.line = llocp->first_line;
+  error_sql_node->error.column = llocp->first_column;
+  error_sql_node->error.flag = flag;
   sql_result->add_sql_node(std::move(error_sql_node));
   return 0;
 }
 
-ArithmeticExpr *create_arithmetic_expression(
-    ArithmeticExpr::Type type, Expression *left, Expression *right, const char *sql_string, YYLTYPE *llocp)
+ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
+                                             Expression *left,
+                                             Expression *right,
+                                             const char *sql_string,
+                                             YYLTYPE *llocp)
 {
   ArithmeticExpr *expr = new ArithmeticExpr(type, left, right);
   expr->set_name(token_name(sql_string, llocp));
@@ -120,192 +128,193 @@ AggrFuncType get_aggr_func_type(char *func_name)
     return AggrFuncType::AVG;
   } else if (0 == strcmp(func_name, "count")) {
     return AggrFuncType::COUNT;
-  }
+  } 
   return AggrFuncType::AGGR_FUNC_TYPE_NUM;
 }
 
-#line 128 "yacc_sql.cpp"
-
-#ifndef YY_CAST
-#ifdef __cplusplus
-#define YY_CAST(Type, Val) static_cast<Type>(Val)
-#define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type>(Val)
-#else
-#define YY_CAST(Type, Val) ((Type)(Val))
-#define YY_REINTERPRET_CAST(Type, Val) ((Type)(Val))
-#endif
-#endif
-#ifndef YY_NULLPTR
-#if defined __cplusplus
-#if 201103L <= __cplusplus
-#define YY_NULLPTR nullptr
-#else
-#define YY_NULLPTR 0
-#endif
-#else
-#define YY_NULLPTR ((void *)0)
-#endif
-#endif
-
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-#undef YYERROR_VERBOSE
-#define YYERROR_VERBOSE 1
-#else
-#define YYERROR_VERBOSE 1
-#endif
 
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_YACC_SQL_HPP_INCLUDED
-#define YY_YY_YACC_SQL_HPP_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-#define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-#define YYTOKENTYPE
-enum yytokentype
+#line 137 "yacc_sql.cpp"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "yacc_sql.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  SEMICOLON    = 258,
-  CREATE       = 259,
-  DROP         = 260,
-  TABLE        = 261,
-  TABLES       = 262,
-  INDEX        = 263,
-  CALC         = 264,
-  SELECT       = 265,
-  DESC         = 266,
-  SHOW         = 267,
-  SYNC         = 268,
-  INSERT       = 269,
-  DELETE       = 270,
-  UPDATE       = 271,
-  LBRACE       = 272,
-  RBRACE       = 273,
-  COMMA        = 274,
-  TRX_BEGIN    = 275,
-  TRX_COMMIT   = 276,
-  TRX_ROLLBACK = 277,
-  INT_T        = 278,
-  STRING_T     = 279,
-  FLOAT_T      = 280,
-  DATE_T       = 281,
-  TEXT_T       = 282,
-  HELP         = 283,
-  EXIT         = 284,
-  DOT          = 285,
-  INTO         = 286,
-  VALUES       = 287,
-  FROM         = 288,
-  WHERE        = 289,
-  AND          = 290,
-  OR           = 291,
-  SET          = 292,
-  ON           = 293,
-  LOAD         = 294,
-  DATA         = 295,
-  INFILE       = 296,
-  EXPLAIN      = 297,
-  IS           = 298,
-  NULL_T       = 299,
-  INNER        = 300,
-  JOIN         = 301,
-  AS           = 302,
-  IN           = 303,
-  EXISTS       = 304,
-  EQ           = 305,
-  LT           = 306,
-  GT           = 307,
-  LE           = 308,
-  GE           = 309,
-  NE           = 310,
-  NOT          = 311,
-  LIKE         = 312,
-  UNIQUE       = 313,
-  AGGR_MAX     = 314,
-  AGGR_MIN     = 315,
-  AGGR_SUM     = 316,
-  AGGR_AVG     = 317,
-  AGGR_COUNT   = 318,
-  LENGTH       = 319,
-  ROUND        = 320,
-  DATE_FORMAT  = 321,
-  ORDER        = 322,
-  GROUP        = 323,
-  BY           = 324,
-  ASC          = 325,
-  HAVING       = 326,
-  NUMBER       = 327,
-  FLOAT        = 328,
-  ID           = 329,
-  SSS          = 330,
-  DATE_STR     = 331,
-  UMINUS       = 332
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SEMICOLON = 3,                  /* SEMICOLON  */
+  YYSYMBOL_CREATE = 4,                     /* CREATE  */
+  YYSYMBOL_DROP = 5,                       /* DROP  */
+  YYSYMBOL_TABLE = 6,                      /* TABLE  */
+  YYSYMBOL_TABLES = 7,                     /* TABLES  */
+  YYSYMBOL_INDEX = 8,                      /* INDEX  */
+  YYSYMBOL_CALC = 9,                       /* CALC  */
+  YYSYMBOL_SELECT = 10,                    /* SELECT  */
+  YYSYMBOL_DESC = 11,                      /* DESC  */
+  YYSYMBOL_SHOW = 12,                      /* SHOW  */
+  YYSYMBOL_SYNC = 13,                      /* SYNC  */
+  YYSYMBOL_INSERT = 14,                    /* INSERT  */
+  YYSYMBOL_DELETE = 15,                    /* DELETE  */
+  YYSYMBOL_UPDATE = 16,                    /* UPDATE  */
+  YYSYMBOL_LBRACE = 17,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 18,                    /* RBRACE  */
+  YYSYMBOL_COMMA = 19,                     /* COMMA  */
+  YYSYMBOL_TRX_BEGIN = 20,                 /* TRX_BEGIN  */
+  YYSYMBOL_TRX_COMMIT = 21,                /* TRX_COMMIT  */
+  YYSYMBOL_TRX_ROLLBACK = 22,              /* TRX_ROLLBACK  */
+  YYSYMBOL_INT_T = 23,                     /* INT_T  */
+  YYSYMBOL_STRING_T = 24,                  /* STRING_T  */
+  YYSYMBOL_FLOAT_T = 25,                   /* FLOAT_T  */
+  YYSYMBOL_DATE_T = 26,                    /* DATE_T  */
+  YYSYMBOL_TEXT_T = 27,                    /* TEXT_T  */
+  YYSYMBOL_HELP = 28,                      /* HELP  */
+  YYSYMBOL_EXIT = 29,                      /* EXIT  */
+  YYSYMBOL_DOT = 30,                       /* DOT  */
+  YYSYMBOL_INTO = 31,                      /* INTO  */
+  YYSYMBOL_VALUES = 32,                    /* VALUES  */
+  YYSYMBOL_FROM = 33,                      /* FROM  */
+  YYSYMBOL_WHERE = 34,                     /* WHERE  */
+  YYSYMBOL_AND = 35,                       /* AND  */
+  YYSYMBOL_OR = 36,                        /* OR  */
+  YYSYMBOL_SET = 37,                       /* SET  */
+  YYSYMBOL_ON = 38,                        /* ON  */
+  YYSYMBOL_LOAD = 39,                      /* LOAD  */
+  YYSYMBOL_DATA = 40,                      /* DATA  */
+  YYSYMBOL_INFILE = 41,                    /* INFILE  */
+  YYSYMBOL_EXPLAIN = 42,                   /* EXPLAIN  */
+  YYSYMBOL_IS = 43,                        /* IS  */
+  YYSYMBOL_NULL_T = 44,                    /* NULL_T  */
+  YYSYMBOL_INNER = 45,                     /* INNER  */
+  YYSYMBOL_JOIN = 46,                      /* JOIN  */
+  YYSYMBOL_AS = 47,                        /* AS  */
+  YYSYMBOL_IN = 48,                        /* IN  */
+  YYSYMBOL_EXISTS = 49,                    /* EXISTS  */
+  YYSYMBOL_EQ = 50,                        /* EQ  */
+  YYSYMBOL_LT = 51,                        /* LT  */
+  YYSYMBOL_GT = 52,                        /* GT  */
+  YYSYMBOL_LE = 53,                        /* LE  */
+  YYSYMBOL_GE = 54,                        /* GE  */
+  YYSYMBOL_NE = 55,                        /* NE  */
+  YYSYMBOL_NOT = 56,                       /* NOT  */
+  YYSYMBOL_LIKE = 57,                      /* LIKE  */
+  YYSYMBOL_UNIQUE = 58,                    /* UNIQUE  */
+  YYSYMBOL_AGGR_MAX = 59,                  /* AGGR_MAX  */
+  YYSYMBOL_AGGR_MIN = 60,                  /* AGGR_MIN  */
+  YYSYMBOL_AGGR_SUM = 61,                  /* AGGR_SUM  */
+  YYSYMBOL_AGGR_AVG = 62,                  /* AGGR_AVG  */
+  YYSYMBOL_AGGR_COUNT = 63,                /* AGGR_COUNT  */
+  YYSYMBOL_LENGTH = 64,                    /* LENGTH  */
+  YYSYMBOL_ROUND = 65,                     /* ROUND  */
+  YYSYMBOL_DATE_FORMAT = 66,               /* DATE_FORMAT  */
+  YYSYMBOL_ORDER = 67,                     /* ORDER  */
+  YYSYMBOL_GROUP = 68,                     /* GROUP  */
+  YYSYMBOL_BY = 69,                        /* BY  */
+  YYSYMBOL_ASC = 70,                       /* ASC  */
+  YYSYMBOL_HAVING = 71,                    /* HAVING  */
+  YYSYMBOL_NUMBER = 72,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 73,                     /* FLOAT  */
+  YYSYMBOL_ID = 74,                        /* ID  */
+  YYSYMBOL_SSS = 75,                       /* SSS  */
+  YYSYMBOL_DATE_STR = 76,                  /* DATE_STR  */
+  YYSYMBOL_77_ = 77,                       /* '+'  */
+  YYSYMBOL_78_ = 78,                       /* '-'  */
+  YYSYMBOL_79_ = 79,                       /* '*'  */
+  YYSYMBOL_80_ = 80,                       /* '/'  */
+  YYSYMBOL_UMINUS = 81,                    /* UMINUS  */
+  YYSYMBOL_YYACCEPT = 82,                  /* $accept  */
+  YYSYMBOL_commands = 83,                  /* commands  */
+  YYSYMBOL_command_wrapper = 84,           /* command_wrapper  */
+  YYSYMBOL_exit_stmt = 85,                 /* exit_stmt  */
+  YYSYMBOL_help_stmt = 86,                 /* help_stmt  */
+  YYSYMBOL_sync_stmt = 87,                 /* sync_stmt  */
+  YYSYMBOL_begin_stmt = 88,                /* begin_stmt  */
+  YYSYMBOL_commit_stmt = 89,               /* commit_stmt  */
+  YYSYMBOL_rollback_stmt = 90,             /* rollback_stmt  */
+  YYSYMBOL_drop_table_stmt = 91,           /* drop_table_stmt  */
+  YYSYMBOL_show_tables_stmt = 92,          /* show_tables_stmt  */
+  YYSYMBOL_desc_table_stmt = 93,           /* desc_table_stmt  */
+  YYSYMBOL_create_index_stmt = 94,         /* create_index_stmt  */
+  YYSYMBOL_unique_option = 95,             /* unique_option  */
+  YYSYMBOL_index_type_option = 96,         /* index_type_option  */
+  YYSYMBOL_idx_col_list = 97,              /* idx_col_list  */
+  YYSYMBOL_drop_index_stmt = 98,           /* drop_index_stmt  */
+  YYSYMBOL_show_index_stmt = 99,           /* show_index_stmt  */
+  YYSYMBOL_create_table_stmt = 100,        /* create_table_stmt  */
+  YYSYMBOL_attr_def_list = 101,            /* attr_def_list  */
+  YYSYMBOL_attr_def = 102,                 /* attr_def  */
+  YYSYMBOL_primary_key_option = 103,       /* primary_key_option  */
+  YYSYMBOL_storage_format_option = 104,    /* storage_format_option  */
+  YYSYMBOL_null_option = 105,              /* null_option  */
+  YYSYMBOL_as_option = 106,                /* as_option  */
+  YYSYMBOL_number = 107,                   /* number  */
+  YYSYMBOL_type = 108,                     /* type  */
+  YYSYMBOL_insert_stmt = 109,              /* insert_stmt  */
+  YYSYMBOL_insert_col_list = 110,          /* insert_col_list  */
+  YYSYMBOL_insert_value_list = 111,        /* insert_value_list  */
+  YYSYMBOL_insert_value = 112,             /* insert_value  */
+  YYSYMBOL_value_list = 113,               /* value_list  */
+  YYSYMBOL_value = 114,                    /* value  */
+  YYSYMBOL_delete_stmt = 115,              /* delete_stmt  */
+  YYSYMBOL_update_stmt = 116,              /* update_stmt  */
+  YYSYMBOL_update_kv_list = 117,           /* update_kv_list  */
+  YYSYMBOL_update_kv = 118,                /* update_kv  */
+  YYSYMBOL_from_list = 119,                /* from_list  */
+  YYSYMBOL_alias = 120,                    /* alias  */
+  YYSYMBOL_from_node = 121,                /* from_node  */
+  YYSYMBOL_join_list = 122,                /* join_list  */
+  YYSYMBOL_sub_query_expr = 123,           /* sub_query_expr  */
+  YYSYMBOL_select_stmt = 124,              /* select_stmt  */
+  YYSYMBOL_calc_stmt = 125,                /* calc_stmt  */
+  YYSYMBOL_expression_list = 126,          /* expression_list  */
+  YYSYMBOL_expression = 127,               /* expression  */
+  YYSYMBOL_aggr_func_expr = 128,           /* aggr_func_expr  */
+  YYSYMBOL_sys_func_type = 129,            /* sys_func_type  */
+  YYSYMBOL_func_expr = 130,                /* func_expr  */
+  YYSYMBOL_rel_attr = 131,                 /* rel_attr  */
+  YYSYMBOL_where = 132,                    /* where  */
+  YYSYMBOL_is_null_comp = 133,             /* is_null_comp  */
+  YYSYMBOL_condition = 134,                /* condition  */
+  YYSYMBOL_sort_unit = 135,                /* sort_unit  */
+  YYSYMBOL_sort_list = 136,                /* sort_list  */
+  YYSYMBOL_opt_order_by = 137,             /* opt_order_by  */
+  YYSYMBOL_opt_group_by = 138,             /* opt_group_by  */
+  YYSYMBOL_opt_having = 139,               /* opt_having  */
+  YYSYMBOL_comp_op = 140,                  /* comp_op  */
+  YYSYMBOL_exists_op = 141,                /* exists_op  */
+  YYSYMBOL_load_data_stmt = 142,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 143,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 144,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 145             /* opt_semicolon  */
 };
-#endif
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Value type.  */
-#if !defined YYSTYPE && !defined YYSTYPE_IS_DECLARED
-union YYSTYPE
-{
-#line 151 "yacc_sql.y"
-
-  ParsedSqlNode                   *sql_node;
-  Value                           *value;
-  enum CompOp                      comp;
-  RelAttrSqlNode                  *rel_attr;
-  std::vector<AttrInfoSqlNode>    *attr_infos;
-  AttrInfoSqlNode                 *attr_info;
-  Expression                      *expression;
-  UpdateKV                        *update_kv;
-  std::vector<UpdateKV>           *update_kv_list;
-  std::vector<Expression *>       *expression_list;
-  std::vector<Value>              *value_list;
-  std::vector<std::string>        *relation_list;
-  std::vector<std::vector<Value>> *insert_value_list;
-  std::vector<RelAttrSqlNode>     *rel_attr_list;
-  InnerJoinSqlNode                *inner_joins;
-  std::vector<InnerJoinSqlNode>   *inner_joins_list;
-  OrderBySqlNode                  *orderby_unit;
-  std::vector<OrderBySqlNode>     *orderby_unit_list;
-  char                            *string;
-  int                              number;
-  float                            floats;
-  bool                             boolean;
-
-#line 283 "yacc_sql.cpp"
-};
-typedef union YYSTYPE YYSTYPE;
-#define YYSTYPE_IS_TRIVIAL 1
-#define YYSTYPE_IS_DECLARED 1
-#endif
-
-/* Location type.  */
-#if !defined YYLTYPE && !defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE           YYLTYPE;
-struct YYLTYPE
-{
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
-};
-#define YYLTYPE_IS_DECLARED 1
-#define YYLTYPE_IS_TRIVIAL 1
-#endif
 
-int yyparse(const char *sql_string, ParsedSqlResult *sql_result, void *scanner);
 
-#endif /* !YY_YY_YACC_SQL_HPP_INCLUDED  */
 
 #ifdef short
-#undef short
+# undef short
 #endif
 
 /* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
@@ -313,11 +322,11 @@ int yyparse(const char *sql_string, ParsedSqlResult *sql_result, void *scanner);
    so that the code can choose integer types of a good width.  */
 
 #ifndef __PTRDIFF_MAX__
-#include <limits.h> /* INFRINGES ON USER NAME SPACE */
-#if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
-#include <stdint.h> /* INFRINGES ON USER NAME SPACE */
-#define YY_STDINT_H
-#endif
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
 /* Narrow types that promote to a signed type and that can represent a
@@ -327,73 +336,91 @@ int yyparse(const char *sql_string, ParsedSqlResult *sql_result, void *scanner);
 
 #ifdef __INT_LEAST8_MAX__
 typedef __INT_LEAST8_TYPE__ yytype_int8;
-#elif defined               YY_STDINT_H
-typedef int_least8_t   yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
 #else
-typedef signed char    yytype_int8;
+typedef signed char yytype_int8;
 #endif
 
 #ifdef __INT_LEAST16_MAX__
 typedef __INT_LEAST16_TYPE__ yytype_int16;
-#elif defined                YY_STDINT_H
-typedef int_least16_t  yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short          yytype_int16;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#if defined                  __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
-#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H && UINT_LEAST8_MAX <= INT_MAX)
-typedef uint_least8_t  yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
 #elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
-typedef unsigned char  yytype_uint8;
+typedef unsigned char yytype_uint8;
 #else
 typedef short yytype_uint8;
 #endif
 
-#if defined                   __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST16_TYPE__ yytype_uint16;
-#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H && UINT_LEAST16_MAX <= INT_MAX)
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
 typedef uint_least16_t yytype_uint16;
 #elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
 typedef unsigned short yytype_uint16;
 #else
-typedef int   yytype_uint16;
+typedef int yytype_uint16;
 #endif
 
 #ifndef YYPTRDIFF_T
-#if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
-#define YYPTRDIFF_T __PTRDIFF_TYPE__
-#define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
-#elif defined PTRDIFF_MAX
-#ifndef ptrdiff_t
-#include <stddef.h> /* INFRINGES ON USER NAME SPACE */
-#endif
-#define YYPTRDIFF_T ptrdiff_t
-#define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
-#else
-#define YYPTRDIFF_T long
-#define YYPTRDIFF_MAXIMUM LONG_MAX
-#endif
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
-#ifdef __SIZE_TYPE__
-#define YYSIZE_T __SIZE_TYPE__
-#elif defined size_t
-#define YYSIZE_T size_t
-#elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
-#include <stddef.h> /* INFRINGES ON USER NAME SPACE */
-#define YYSIZE_T size_t
-#else
-#define YYSIZE_T unsigned
-#endif
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
 #endif
 
-#define YYSIZE_MAXIMUM \
-  YY_CAST(YYPTRDIFF_T, (YYPTRDIFF_MAXIMUM < YY_CAST(YYSIZE_T, -1) ? YYPTRDIFF_MAXIMUM : YY_CAST(YYSIZE_T, -1)))
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
-#define YYSIZEOF(X) YY_CAST(YYPTRDIFF_T, sizeof(X))
 
 /* Stored state numbers (used for stacks). */
 typedef yytype_int16 yy_state_t;
@@ -402,2838 +429,774 @@ typedef yytype_int16 yy_state_t;
 typedef int yy_state_fast_t;
 
 #ifndef YY_
-#if defined YYENABLE_NLS && YYENABLE_NLS
-#if ENABLE_NLS
-#include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#define YY_(Msgid) dgettext("bison-runtime", Msgid)
-#endif
-#endif
-#ifndef YY_
-#define YY_(Msgid) Msgid
-#endif
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
-#if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
-#define YY_ATTRIBUTE_PURE __attribute__((__pure__))
-#else
-#define YY_ATTRIBUTE_PURE
-#endif
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-#if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
-#define YY_ATTRIBUTE_UNUSED __attribute__((__unused__))
-#else
-#define YY_ATTRIBUTE_UNUSED
-#endif
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
-#if !defined lint || defined __GNUC__
-#define YYUSE(E) ((void)(E))
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
 #else
-#define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && !defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-#define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                                            \
-  _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wuninitialized\"") \
-      _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-#define YY_IGNORE_MAYBE_UNINITIALIZED_END _Pragma("GCC diagnostic pop")
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-#define YY_INITIAL_VALUE(Value) Value
+# define YY_INITIAL_VALUE(Value) Value
 #endif
 #ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-#define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-#define YY_IGNORE_MAYBE_UNINITIALIZED_END
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
 #endif
 #ifndef YY_INITIAL_VALUE
-#define YY_INITIAL_VALUE(Value) /* Nothing. */
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
-#if defined __cplusplus && defined __GNUC__ && !defined __ICC && 6 <= __GNUC__
-#define YY_IGNORE_USELESS_CAST_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wuseless-cast\"")
-#define YY_IGNORE_USELESS_CAST_END _Pragma("GCC diagnostic pop")
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
 #endif
 #ifndef YY_IGNORE_USELESS_CAST_BEGIN
-#define YY_IGNORE_USELESS_CAST_BEGIN
-#define YY_IGNORE_USELESS_CAST_END
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
 #endif
 
-#define YY_ASSERT(E) ((void)(0 && (E)))
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-
-/* The parser invokes alloca or malloc; define the necessary symbols.  */
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-#ifdef YYSTACK_USE_ALLOCA
-#if YYSTACK_USE_ALLOCA
-#ifdef __GNUC__
-#define YYSTACK_ALLOC __builtin_alloca
-#elif defined __BUILTIN_VA_ARG_INCR
-#include <alloca.h> /* INFRINGES ON USER NAME SPACE */
-#elif defined _AIX
-#define YYSTACK_ALLOC __alloca
-#elif defined _MSC_VER
-#include <malloc.h> /* INFRINGES ON USER NAME SPACE */
-#define alloca _alloca
-#else
-#define YYSTACK_ALLOC alloca
-#if !defined _ALLOCA_H && !defined EXIT_SUCCESS
-#include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-/* Use EXIT_SUCCESS as a witness for stdlib.h.  */
-#ifndef EXIT_SUCCESS
-#define EXIT_SUCCESS 0
-#endif
-#endif
-#endif
-#endif
-#endif
+#if 1
 
-#ifdef YYSTACK_ALLOC
-/* Pacify GCC's 'empty if-body' warning.  */
-#define YYSTACK_FREE(Ptr) \
-  do { /* empty */        \
-    ;                     \
-  } while (0)
-#ifndef YYSTACK_ALLOC_MAXIMUM
-/* The OS might guarantee only one guard page at the bottom of the stack,
-   and a page size can be as small as 4096 bytes.  So we cannot safely
-   invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
-   to allow for a few compiler-allocated temporary stack slots.  */
-#define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
-#endif
-#else
-#define YYSTACK_ALLOC YYMALLOC
-#define YYSTACK_FREE YYFREE
-#ifndef YYSTACK_ALLOC_MAXIMUM
-#define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
-#endif
-#if (defined __cplusplus && !defined EXIT_SUCCESS && \
-     !((defined YYMALLOC || defined malloc) && (defined YYFREE || defined free)))
-#include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#ifndef EXIT_SUCCESS
-#define EXIT_SUCCESS 0
-#endif
-#endif
-#ifndef YYMALLOC
-#define YYMALLOC malloc
-#if !defined malloc && !defined EXIT_SUCCESS
-void *malloc(YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
-#endif
-#endif
-#ifndef YYFREE
-#define YYFREE free
-#if !defined free && !defined EXIT_SUCCESS
-void  free(void *);     /* INFRINGES ON USER NAME SPACE */
-#endif
-#endif
-#endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
 
-#if (!defined yyoverflow && (!defined __cplusplus || (defined    YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL && \
-                                                         defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
+             && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
   yy_state_t yyss_alloc;
-  YYSTYPE    yyvs_alloc;
-  YYLTYPE    yyls_alloc;
+  YYSTYPE yyvs_alloc;
+  YYLTYPE yyls_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-#define YYSTACK_GAP_MAXIMUM (YYSIZEOF(union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
-#define YYSTACK_BYTES(N) \
-  ((N) * (YYSIZEOF(yy_state_t) + YYSIZEOF(YYSTYPE) + YYSIZEOF(YYLTYPE)) + 2 * YYSTACK_GAP_MAXIMUM)
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
+      + 2 * YYSTACK_GAP_MAXIMUM)
 
-#define YYCOPY_NEEDED 1
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-#define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
-  do {                                                                 \
-    YYPTRDIFF_T yynewbytes;                                            \
-    YYCOPY(&yyptr->Stack_alloc, Stack, yysize);                        \
-    Stack      = &yyptr->Stack_alloc;                                  \
-    yynewbytes = yystacksize * YYSIZEOF(*Stack) + YYSTACK_GAP_MAXIMUM; \
-    yyptr += yynewbytes / YYSIZEOF(*yyptr);                            \
-  } while (0)
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
 #if defined YYCOPY_NEEDED && YYCOPY_NEEDED
 /* Copy COUNT objects from SRC to DST.  The source and destination do
    not overlap.  */
-#ifndef YYCOPY
-#if defined __GNUC__ && 1 < __GNUC__
-#define YYCOPY(Dst, Src, Count) __builtin_memcpy(Dst, Src, YY_CAST(YYSIZE_T, (Count)) * sizeof(*(Src)))
-#else
-#define YYCOPY(Dst, Src, Count)         \
-  do {                                  \
-    YYPTRDIFF_T yyi;                    \
-    for (yyi = 0; yyi < (Count); yyi++) \
-      (Dst)[yyi] = (Src)[yyi];          \
-  } while (0)
-#endif
-#endif
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL 77
+#define YYFINAL  77
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST 265
+#define YYLAST   275
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS 82
+#define YYNTOKENS  82
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS 61
+#define YYNNTS  64
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES 147
+#define YYNRULES  153
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES 258
+#define YYNSTATES  270
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   332
 
-#define YYUNDEFTOK 2
-#define YYMAXUTOK 332
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX) (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
-static const yytype_int8 yytranslate[] = {0,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    79,
-    77,
-    2,
-    78,
-    2,
-    80,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    2,
-    1,
-    2,
-    3,
-    4,
-    5,
-    6,
-    7,
-    8,
-    9,
-    10,
-    11,
-    12,
-    13,
-    14,
-    15,
-    16,
-    17,
-    18,
-    19,
-    20,
-    21,
-    22,
-    23,
-    24,
-    25,
-    26,
-    27,
-    28,
-    29,
-    30,
-    31,
-    32,
-    33,
-    34,
-    35,
-    36,
-    37,
-    38,
-    39,
-    40,
-    41,
-    42,
-    43,
-    44,
-    45,
-    46,
-    47,
-    48,
-    49,
-    50,
-    51,
-    52,
-    53,
-    54,
-    55,
-    56,
-    57,
-    58,
-    59,
-    60,
-    61,
-    62,
-    63,
-    64,
-    65,
-    66,
-    67,
-    68,
-    69,
-    70,
-    71,
-    72,
-    73,
-    74,
-    75,
-    76,
-    81};
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,    79,    77,     2,    78,     2,    80,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    81
+};
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_int16 yyrline[] = {0,
-    253,
-    253,
-    261,
-    262,
-    263,
-    264,
-    265,
-    266,
-    267,
-    268,
-    269,
-    270,
-    271,
-    272,
-    273,
-    274,
-    275,
-    276,
-    277,
-    278,
-    279,
-    280,
-    281,
-    285,
-    291,
-    296,
-    302,
-    308,
-    314,
-    320,
-    327,
-    333,
-    341,
-    363,
-    366,
-    372,
-    375,
-    388,
-    399,
-    408,
-    424,
-    440,
-    451,
-    454,
-    467,
-    476,
-    488,
-    491,
-    495,
-    502,
-    505,
-    512,
-    515,
-    516,
-    517,
-    518,
-    519,
-    522,
-    543,
-    546,
-    560,
-    563,
-    576,
-    596,
-    599,
-    615,
-    619,
-    623,
-    639,
-    644,
-    651,
-    663,
-    686,
-    689,
-    702,
-    712,
-    715,
-    727,
-    730,
-    733,
-    738,
-    754,
-    757,
-    775,
-    783,
-    792,
-    829,
-    839,
-    848,
-    863,
-    866,
-    869,
-    872,
-    875,
-    884,
-    887,
-    892,
-    897,
-    900,
-    903,
-    909,
-    929,
-    932,
-    935,
-    941,
-    951,
-    956,
-    963,
-    968,
-    974,
-    983,
-    986,
-    992,
-    996,
-    1003,
-    1007,
-    1014,
-    1021,
-    1025,
-    1032,
-    1039,
-    1046,
-    1054,
-    1061,
-    1069,
-    1072,
-    1079,
-    1082,
-    1089,
-    1092,
-    1099,
-    1100,
-    1101,
-    1102,
-    1103,
-    1104,
-    1105,
-    1106,
-    1107,
-    1108,
-    1112,
-    1113,
-    1117,
-    1130,
-    1138,
-    1148,
-    1149};
+static const yytype_int16 yyrline[] =
+{
+       0,   256,   256,   264,   265,   266,   267,   268,   269,   270,
+     271,   272,   273,   274,   275,   276,   277,   278,   279,   280,
+     281,   282,   283,   284,   288,   294,   299,   305,   311,   317,
+     323,   330,   336,   344,   367,   370,   378,   381,   401,   404,
+     417,   428,   437,   457,   473,   484,   487,   500,   510,   524,
+     527,   541,   544,   559,   562,   566,   573,   576,   583,   586,
+     587,   588,   589,   590,   593,   614,   617,   631,   634,   647,
+     667,   670,   686,   690,   694,   710,   715,   722,   734,   757,
+     760,   773,   783,   786,   798,   801,   804,   809,   825,   828,
+     846,   854,   863,   900,   910,   919,   934,   937,   940,   943,
+     946,   955,   958,   963,   968,   971,   974,   980,  1000,  1003,
+    1006,  1012,  1022,  1027,  1034,  1039,  1045,  1054,  1057,  1063,
+    1067,  1074,  1078,  1085,  1092,  1096,  1103,  1110,  1117,  1125,
+    1132,  1140,  1143,  1150,  1153,  1160,  1163,  1170,  1171,  1172,
+    1173,  1174,  1175,  1176,  1177,  1178,  1179,  1183,  1184,  1188,
+    1201,  1209,  1219,  1220
+};
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
-static const char *const yytname[] = {"$end",
-    "error",
-    "$undefined",
-    "SEMICOLON",
-    "CREATE",
-    "DROP",
-    "TABLE",
-    "TABLES",
-    "INDEX",
-    "CALC",
-    "SELECT",
-    "DESC",
-    "SHOW",
-    "SYNC",
-    "INSERT",
-    "DELETE",
-    "UPDATE",
-    "LBRACE",
-    "RBRACE",
-    "COMMA",
-    "TRX_BEGIN",
-    "TRX_COMMIT",
-    "TRX_ROLLBACK",
-    "INT_T",
-    "STRING_T",
-    "FLOAT_T",
-    "DATE_T",
-    "TEXT_T",
-    "HELP",
-    "EXIT",
-    "DOT",
-    "INTO",
-    "VALUES",
-    "FROM",
-    "WHERE",
-    "AND",
-    "OR",
-    "SET",
-    "ON",
-    "LOAD",
-    "DATA",
-    "INFILE",
-    "EXPLAIN",
-    "IS",
-    "NULL_T",
-    "INNER",
-    "JOIN",
-    "AS",
-    "IN",
-    "EXISTS",
-    "EQ",
-    "LT",
-    "GT",
-    "LE",
-    "GE",
-    "NE",
-    "NOT",
-    "LIKE",
-    "UNIQUE",
-    "AGGR_MAX",
-    "AGGR_MIN",
-    "AGGR_SUM",
-    "AGGR_AVG",
-    "AGGR_COUNT",
-    "LENGTH",
-    "ROUND",
-    "DATE_FORMAT",
-    "ORDER",
-    "GROUP",
-    "BY",
-    "ASC",
-    "HAVING",
-    "NUMBER",
-    "FLOAT",
-    "ID",
-    "SSS",
-    "DATE_STR",
-    "'+'",
-    "'-'",
-    "'*'",
-    "'/'",
-    "UMINUS",
-    "$accept",
-    "commands",
-    "command_wrapper",
-    "exit_stmt",
-    "help_stmt",
-    "sync_stmt",
-    "begin_stmt",
-    "commit_stmt",
-    "rollback_stmt",
-    "drop_table_stmt",
-    "show_tables_stmt",
-    "desc_table_stmt",
-    "create_index_stmt",
-    "unique_option",
-    "idx_col_list",
-    "drop_index_stmt",
-    "show_index_stmt",
-    "create_table_stmt",
-    "attr_def_list",
-    "attr_def",
-    "null_option",
-    "as_option",
-    "number",
-    "type",
-    "insert_stmt",
-    "insert_col_list",
-    "insert_value_list",
-    "insert_value",
-    "value_list",
-    "value",
-    "delete_stmt",
-    "update_stmt",
-    "update_kv_list",
-    "update_kv",
-    "from_list",
-    "alias",
-    "from_node",
-    "join_list",
-    "sub_query_expr",
-    "select_stmt",
-    "calc_stmt",
-    "expression_list",
-    "expression",
-    "aggr_func_expr",
-    "sys_func_type",
-    "func_expr",
-    "rel_attr",
-    "where",
-    "is_null_comp",
-    "condition",
-    "sort_unit",
-    "sort_list",
-    "opt_order_by",
-    "opt_group_by",
-    "opt_having",
-    "comp_op",
-    "exists_op",
-    "load_data_stmt",
-    "explain_stmt",
-    "set_variable_stmt",
-    "opt_semicolon",
-    YY_NULLPTR};
-#endif
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "SEMICOLON", "CREATE",
+  "DROP", "TABLE", "TABLES", "INDEX", "CALC", "SELECT", "DESC", "SHOW",
+  "SYNC", "INSERT", "DELETE", "UPDATE", "LBRACE", "RBRACE", "COMMA",
+  "TRX_BEGIN", "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T",
+  "FLOAT_T", "DATE_T", "TEXT_T", "HELP", "EXIT", "DOT", "INTO", "VALUES",
+  "FROM", "WHERE", "AND", "OR", "SET", "ON", "LOAD", "DATA", "INFILE",
+  "EXPLAIN", "IS", "NULL_T", "INNER", "JOIN", "AS", "IN", "EXISTS", "EQ",
+  "LT", "GT", "LE", "GE", "NE", "NOT", "LIKE", "UNIQUE", "AGGR_MAX",
+  "AGGR_MIN", "AGGR_SUM", "AGGR_AVG", "AGGR_COUNT", "LENGTH", "ROUND",
+  "DATE_FORMAT", "ORDER", "GROUP", "BY", "ASC", "HAVING", "NUMBER",
+  "FLOAT", "ID", "SSS", "DATE_STR", "'+'", "'-'", "'*'", "'/'", "UMINUS",
+  "$accept", "commands", "command_wrapper", "exit_stmt", "help_stmt",
+  "sync_stmt", "begin_stmt", "commit_stmt", "rollback_stmt",
+  "drop_table_stmt", "show_tables_stmt", "desc_table_stmt",
+  "create_index_stmt", "unique_option", "index_type_option",
+  "idx_col_list", "drop_index_stmt", "show_index_stmt",
+  "create_table_stmt", "attr_def_list", "attr_def", "primary_key_option",
+  "storage_format_option", "null_option", "as_option", "number", "type",
+  "insert_stmt", "insert_col_list", "insert_value_list", "insert_value",
+  "value_list", "value", "delete_stmt", "update_stmt", "update_kv_list",
+  "update_kv", "from_list", "alias", "from_node", "join_list",
+  "sub_query_expr", "select_stmt", "calc_stmt", "expression_list",
+  "expression", "aggr_func_expr", "sys_func_type", "func_expr", "rel_attr",
+  "where", "is_null_comp", "condition", "sort_unit", "sort_list",
+  "opt_order_by", "opt_group_by", "opt_having", "comp_op", "exists_op",
+  "load_data_stmt", "explain_stmt", "set_variable_stmt", "opt_semicolon", YY_NULLPTR
+};
 
-#ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] = {0,
-    256,
-    257,
-    258,
-    259,
-    260,
-    261,
-    262,
-    263,
-    264,
-    265,
-    266,
-    267,
-    268,
-    269,
-    270,
-    271,
-    272,
-    273,
-    274,
-    275,
-    276,
-    277,
-    278,
-    279,
-    280,
-    281,
-    282,
-    283,
-    284,
-    285,
-    286,
-    287,
-    288,
-    289,
-    290,
-    291,
-    292,
-    293,
-    294,
-    295,
-    296,
-    297,
-    298,
-    299,
-    300,
-    301,
-    302,
-    303,
-    304,
-    305,
-    306,
-    307,
-    308,
-    309,
-    310,
-    311,
-    312,
-    313,
-    314,
-    315,
-    316,
-    317,
-    318,
-    319,
-    320,
-    321,
-    322,
-    323,
-    324,
-    325,
-    326,
-    327,
-    328,
-    329,
-    330,
-    331,
-    43,
-    45,
-    42,
-    47,
-    332};
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
 #endif
 
-#define YYPACT_NINF (-192)
+#define YYPACT_NINF (-196)
 
-#define yypact_value_is_default(Yyn) ((Yyn) == YYPACT_NINF)
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-51)
+#define YYTABLE_NINF (-57)
 
-#define yytable_value_is_error(Yyn) 0
+#define yytable_value_is_error(Yyn) \
+  0
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-static const yytype_int16 yypact[] = {183,
-    0,
-    16,
-    88,
-    88,
-    -43,
-    47,
-    -192,
-    11,
-    15,
-    -13,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -11,
-    51,
-    183,
-    94,
-    100,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    44,
-    -192,
-    111,
-    46,
-    48,
-    1,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -3,
-    -192,
-    -192,
-    88,
-    93,
-    -192,
-    -192,
-    -192,
-    -27,
-    -192,
-    107,
-    -192,
-    -192,
-    92,
-    -192,
-    -192,
-    101,
-    52,
-    53,
-    96,
-    85,
-    98,
-    -192,
-    -192,
-    -192,
-    -192,
-    -7,
-    67,
-    -192,
-    102,
-    124,
-    125,
-    88,
-    18,
-    -192,
-    70,
-    81,
-    -192,
-    88,
-    88,
-    88,
-    88,
-    137,
-    88,
-    84,
-    91,
-    140,
-    134,
-    95,
-    -16,
-    97,
-    104,
-    -192,
-    149,
-    133,
-    105,
-    -192,
-    -192,
-    -9,
-    -192,
-    -192,
-    -192,
-    -192,
-    19,
-    19,
-    -192,
-    -192,
-    88,
-    156,
-    -39,
-    157,
-    -192,
-    106,
-    143,
-    72,
-    -192,
-    131,
-    163,
-    -192,
-    152,
-    83,
-    165,
-    -192,
-    112,
-    -192,
-    -192,
-    -192,
-    -192,
-    144,
-    84,
-    134,
-    166,
-    184,
-    -192,
-    153,
-    176,
-    66,
-    88,
-    88,
-    95,
-    134,
-    200,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -10,
-    104,
-    189,
-    191,
-    164,
-    -192,
-    157,
-    141,
-    139,
-    196,
-    88,
-    197,
-    -192,
-    -23,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -31,
-    -192,
-    -192,
-    88,
-    72,
-    72,
-    34,
-    34,
-    163,
-    -192,
-    160,
-    145,
-    -192,
-    171,
-    -192,
-    165,
-    2,
-    161,
-    162,
-    -192,
-    154,
-    147,
-    166,
-    -192,
-    4,
-    184,
-    -192,
-    -192,
-    193,
-    -192,
-    -192,
-    34,
-    -192,
-    203,
-    -192,
-    -192,
-    -192,
-    221,
-    -192,
-    -192,
-    149,
-    166,
-    -39,
-    88,
-    72,
-    173,
-    -192,
-    88,
-    223,
-    197,
-    -192,
-    -15,
-    -192,
-    224,
-    205,
-    -192,
-    66,
-    175,
-    -192,
-    4,
-    -192,
-    -192,
-    -192,
-    -192,
-    72,
-    88,
-    -192,
-    -20,
-    8,
-    226,
-    -192,
-    -192,
-    -192,
-    -192,
-    88,
-    -192};
+static const yytype_int16 yypact[] =
+{
+     174,     0,    49,    88,    88,   -58,    21,  -196,   -11,    11,
+     -41,  -196,  -196,  -196,  -196,  -196,   -27,    16,   174,    61,
+      65,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,
+    -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,
+    -196,  -196,    10,  -196,    62,    17,    20,     1,  -196,  -196,
+    -196,  -196,  -196,  -196,    -7,  -196,  -196,    88,    60,  -196,
+    -196,  -196,    45,  -196,    80,  -196,  -196,    70,  -196,  -196,
+      71,    33,    39,    69,    48,    73,  -196,  -196,  -196,  -196,
+      -5,    44,  -196,    82,   108,   109,    88,   -52,  -196,    54,
+      75,  -196,    88,    88,    88,    88,   115,    88,    85,    91,
+     118,   134,    95,   -23,    96,    98,  -196,   160,   135,   101,
+    -196,  -196,    22,  -196,  -196,  -196,  -196,   -16,   -16,  -196,
+    -196,    88,   158,   -39,   161,  -196,   117,   150,    72,  -196,
+     142,   180,  -196,   162,   116,   181,  -196,   127,  -196,  -196,
+    -196,  -196,   159,    85,   134,   186,   189,  -196,   165,   167,
+      47,    88,    88,    95,   134,   201,  -196,  -196,  -196,  -196,
+    -196,   -10,    98,   190,   192,   182,  -196,   161,   163,   152,
+     209,    88,   210,  -196,   -31,  -196,  -196,  -196,  -196,  -196,
+    -196,  -196,   -33,  -196,  -196,    88,    72,    72,    78,    78,
+     180,  -196,   156,   164,  -196,   188,   166,   181,     7,   168,
+     169,  -196,   170,   177,   186,  -196,    32,   189,  -196,  -196,
+     191,  -196,  -196,    78,  -196,   198,  -196,  -196,  -196,   216,
+    -196,   175,  -196,  -196,   176,  -196,   160,   186,   -39,    88,
+      72,   171,  -196,    88,   219,   210,  -196,   -30,  -196,   202,
+    -196,   223,   213,  -196,    47,   184,  -196,    32,  -196,  -196,
+     166,   183,   185,    72,    88,  -196,  -196,  -196,   187,  -196,
+      24,     8,   235,  -196,  -196,  -196,  -196,  -196,    88,  -196
+};
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
    Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_uint8 yydefact[] = {0,
-    34,
-    0,
-    0,
-    0,
-    0,
-    0,
-    26,
-    0,
-    0,
-    0,
-    27,
-    28,
-    29,
-    25,
-    24,
-    0,
-    0,
-    0,
-    0,
-    146,
-    23,
-    22,
-    15,
-    16,
-    17,
-    18,
-    9,
-    10,
-    11,
-    12,
-    13,
-    14,
-    8,
-    5,
-    7,
-    6,
-    4,
-    3,
-    19,
-    20,
-    21,
-    0,
-    35,
-    0,
-    0,
-    0,
-    0,
-    70,
-    102,
-    103,
-    104,
-    66,
-    67,
-    106,
-    69,
-    68,
-    0,
-    110,
-    96,
-    100,
-    87,
-    78,
-    98,
-    0,
-    99,
-    97,
-    85,
-    32,
-    31,
-    0,
-    0,
-    0,
-    0,
-    0,
-    0,
-    144,
-    1,
-    147,
-    2,
-    50,
-    0,
-    30,
-    0,
-    0,
-    0,
-    0,
-    0,
-    95,
-    0,
-    0,
-    79,
-    0,
-    0,
-    0,
-    0,
-    88,
-    0,
-    0,
-    0,
-    59,
-    111,
-    0,
-    0,
-    0,
-    0,
-    51,
-    0,
-    0,
-    0,
-    84,
-    94,
-    0,
-    107,
-    109,
-    108,
-    80,
-    90,
-    91,
-    92,
-    93,
-    0,
-    0,
-    78,
-    76,
-    39,
-    0,
-    0,
-    0,
-    71,
-    0,
-    73,
-    145,
-    0,
-    0,
-    43,
-    42,
-    0,
-    38,
-    101,
-    89,
-    105,
-    82,
-    0,
-    111,
-    36,
-    0,
-    141,
-    0,
-    0,
-    112,
-    0,
-    0,
-    0,
-    111,
-    0,
-    53,
-    54,
-    55,
-    56,
-    57,
-    47,
-    0,
-    0,
-    0,
-    0,
-    81,
-    76,
-    127,
-    0,
-    0,
-    0,
-    61,
-    142,
-    0,
-    139,
-    131,
-    132,
-    133,
-    134,
-    135,
-    136,
-    0,
-    137,
-    116,
-    0,
-    0,
-    0,
-    117,
-    75,
-    73,
-    72,
-    0,
-    0,
-    48,
-    0,
-    46,
-    43,
-    40,
-    0,
-    0,
-    77,
-    0,
-    129,
-    36,
-    60,
-    64,
-    0,
-    58,
-    113,
-    0,
-    140,
-    138,
-    115,
-    118,
-    119,
-    74,
-    143,
-    52,
-    0,
-    49,
-    44,
-    0,
-    36,
-    78,
-    0,
-    0,
-    125,
-    37,
-    0,
-    0,
-    61,
-    114,
-    47,
-    41,
-    0,
-    0,
-    128,
-    130,
-    0,
-    86,
-    64,
-    63,
-    62,
-    45,
-    33,
-    0,
-    0,
-    65,
-    82,
-    120,
-    123,
-    126,
-    83,
-    121,
-    122,
-    0,
-    124};
+static const yytype_uint8 yydefact[] =
+{
+       0,    34,     0,     0,     0,     0,     0,    26,     0,     0,
+       0,    27,    28,    29,    25,    24,     0,     0,     0,     0,
+     152,    23,    22,    15,    16,    17,    18,     9,    10,    11,
+      12,    13,    14,     8,     5,     7,     6,     4,     3,    19,
+      20,    21,     0,    35,     0,     0,     0,     0,    76,   108,
+     109,   110,    72,    73,   112,    75,    74,     0,   116,   102,
+     106,    93,    84,   104,     0,   105,   103,    91,    32,    31,
+       0,     0,     0,     0,     0,     0,   150,     1,   153,     2,
+      56,     0,    30,     0,     0,     0,     0,     0,   101,     0,
+       0,    85,     0,     0,     0,     0,    94,     0,     0,     0,
+      65,   117,     0,     0,     0,     0,    57,     0,     0,     0,
+      90,   100,     0,   113,   115,   114,    86,    96,    97,    98,
+      99,     0,     0,    84,    82,    41,     0,     0,     0,    77,
+       0,    79,   151,     0,     0,    45,    44,     0,    40,   107,
+      95,   111,    88,     0,   117,    38,     0,   147,     0,     0,
+     118,     0,     0,     0,   117,     0,    59,    60,    61,    62,
+      63,    53,     0,     0,     0,     0,    87,    82,   133,     0,
+       0,     0,    67,   148,     0,   145,   137,   138,   139,   140,
+     141,   142,     0,   143,   122,     0,     0,     0,   123,    81,
+      79,    78,     0,     0,    54,     0,    49,    45,    51,     0,
+       0,    83,     0,   135,    38,    66,    70,     0,    64,   119,
+       0,   146,   144,   121,   124,   125,    80,   149,    58,     0,
+      55,     0,    48,    46,     0,    42,     0,    38,    84,     0,
+       0,   131,    39,     0,     0,    67,   120,    53,    50,     0,
+      43,     0,     0,   134,   136,     0,    92,    70,    69,    68,
+      49,     0,    36,     0,     0,    71,    47,    52,     0,    33,
+      88,   126,   129,   132,    37,    89,   127,   128,     0,   130
+};
 
 /* YYPGOTO[NTERM-NUM].  */
-static const yytype_int16 yypgoto[] = {-192,
-    -192,
-    228,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -191,
-    -192,
-    -192,
-    -192,
-    50,
-    86,
-    17,
-    54,
-    -192,
-    -192,
-    -192,
-    -192,
-    20,
-    42,
-    21,
-    155,
-    -192,
-    -192,
-    69,
-    108,
-    90,
-    -120,
-    117,
-    14,
-    -192,
-    -45,
-    -192,
-    -4,
-    -56,
-    -192,
-    -192,
-    -192,
-    -192,
-    -54,
-    -192,
-    -182,
-    -192,
-    9,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192,
-    -192};
+static const yytype_int16 yypgoto[] =
+{
+    -196,  -196,   237,  -196,  -196,  -196,  -196,  -196,  -196,  -196,
+    -196,  -196,  -196,  -196,  -196,  -195,  -196,  -196,  -196,    59,
+     100,    13,  -196,    23,    66,  -196,  -196,  -196,  -196,    30,
+      51,    19,   172,  -196,  -196,    77,   119,   102,  -120,   125,
+      14,  -196,   -45,  -196,    -4,   -56,  -196,  -196,  -196,  -196,
+    -113,  -196,  -182,  -196,     2,  -196,  -196,  -196,  -196,  -196,
+    -196,  -196,  -196,  -196
+};
 
 /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] = {-1,
-    19,
-    20,
-    21,
-    22,
-    23,
-    24,
-    25,
-    26,
-    27,
-    28,
-    29,
-    30,
-    44,
-    170,
-    31,
-    32,
-    33,
-    163,
-    135,
-    196,
-    107,
-    219,
-    161,
-    34,
-    127,
-    208,
-    172,
-    230,
-    59,
-    35,
-    36,
-    154,
-    131,
-    144,
-    96,
-    124,
-    166,
-    60,
-    37,
-    38,
-    61,
-    62,
-    63,
-    64,
-    65,
-    66,
-    129,
-    184,
-    150,
-    251,
-    252,
-    240,
-    203,
-    227,
-    185,
-    151,
-    39,
-    40,
-    41,
-    79};
+static const yytype_int16 yydefgoto[] =
+{
+       0,    19,    20,    21,    22,    23,    24,    25,    26,    27,
+      28,    29,    30,    44,   259,   170,    31,    32,    33,   163,
+     135,   222,   225,   196,   107,   219,   161,    34,   127,   208,
+     172,   234,    59,    35,    36,   154,   131,   144,    96,   124,
+     166,    60,    37,    38,    61,    62,    63,    64,    65,    66,
+     129,   184,   150,   262,   263,   246,   203,   231,   185,   151,
+      39,    40,    41,    79
+};
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
    positive, shift that token.  If negative, reduce the rule whose
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int16 yytable[] = {67,
-    88,
-    84,
-    142,
-    214,
-    215,
-    42,
-    193,
-    90,
-    139,
-    105,
-    4,
-    -50,
-    228,
-    86,
-    186,
-    187,
-    211,
-    47,
-    254,
-    90,
-    209,
-    45,
-    229,
-    46,
-    165,
-    212,
-    87,
-    48,
-    194,
-    112,
-    68,
-    235,
-    210,
-    194,
-    91,
-    117,
-    118,
-    119,
-    120,
-    106,
-    195,
-    71,
-    85,
-    238,
-    48,
-    195,
-    91,
-    72,
-    106,
-    92,
-    93,
-    94,
-    95,
-    69,
-    70,
-    52,
-    53,
-    43,
-    55,
-    56,
-    73,
-    136,
-    74,
-    249,
-    49,
-    50,
-    51,
-    92,
-    93,
-    94,
-    95,
-    149,
-    52,
-    53,
-    54,
-    55,
-    56,
-    255,
-    57,
-    58,
-    92,
-    93,
-    94,
-    95,
-    92,
-    93,
-    94,
-    95,
-    47,
-    168,
-    75,
-    113,
-    122,
-    77,
-    188,
-    189,
-    114,
-    94,
-    95,
-    191,
-    186,
-    187,
-    78,
-    236,
-    47,
-    156,
-    157,
-    158,
-    159,
-    160,
-    92,
-    93,
-    94,
-    95,
-    206,
-    48,
-    140,
-    80,
-    81,
-    82,
-    147,
-    83,
-    89,
-    97,
-    98,
-    100,
-    101,
-    148,
-    213,
-    149,
-    149,
-    48,
-    102,
-    99,
-    103,
-    49,
-    50,
-    51,
-    104,
-    109,
-    108,
-    110,
-    111,
-    52,
-    53,
-    54,
-    55,
-    56,
-    115,
-    57,
-    58,
-    49,
-    50,
-    51,
-    116,
-    121,
-    126,
-    123,
-    4,
-    52,
-    53,
-    54,
-    55,
-    56,
-    125,
-    57,
-    58,
-    128,
-    130,
-    149,
-    137,
-    133,
-    241,
-    141,
-    146,
-    143,
-    234,
-    134,
-    138,
-    145,
-    152,
-    153,
-    155,
-    162,
-    169,
-    164,
-    1,
-    2,
-    165,
-    149,
-    250,
-    3,
-    4,
-    5,
-    6,
-    7,
-    8,
-    9,
-    10,
-    250,
-    171,
-    173,
-    11,
-    12,
-    13,
-    192,
-    198,
-    199,
-    202,
-    200,
-    14,
-    15,
-    204,
-    205,
-    220,
-    207,
-    218,
-    226,
-    174,
-    16,
-    237,
-    17,
-    225,
-    175,
-    18,
-    176,
-    177,
-    178,
-    179,
-    180,
-    181,
-    182,
-    183,
-    217,
-    223,
-    224,
-    232,
-    186,
-    233,
-    239,
-    242,
-    245,
-    246,
-    247,
-    256,
-    76,
-    221,
-    197,
-    231,
-    244,
-    243,
-    222,
-    92,
-    93,
-    94,
-    95,
-    201,
-    132,
-    216,
-    167,
-    190,
-    248,
-    253,
-    0,
-    257};
-
-static const yytype_int16 yycheck[] = {4,
-    57,
-    47,
-    123,
-    186,
-    187,
-    6,
-    17,
-    47,
-    18,
-    17,
-    10,
-    10,
-    204,
-    17,
-    35,
-    36,
-    48,
-    17,
-    11,
-    47,
-    44,
-    6,
-    19,
-    8,
-    45,
-    57,
-    30,
-    44,
-    44,
-    86,
-    74,
-    223,
-    56,
-    44,
-    74,
-    92,
-    93,
-    94,
-    95,
-    47,
-    56,
-    31,
-    47,
-    226,
-    44,
-    56,
-    74,
-    33,
-    47,
-    77,
-    78,
-    79,
-    80,
-    7,
-    8,
-    72,
-    73,
-    58,
-    75,
-    76,
-    74,
-    107,
-    74,
-    246,
-    64,
-    65,
-    66,
-    77,
-    78,
-    79,
-    80,
-    128,
-    72,
-    73,
-    74,
-    75,
-    76,
-    70,
-    78,
-    79,
-    77,
-    78,
-    79,
-    80,
-    77,
-    78,
-    79,
-    80,
-    17,
-    144,
-    40,
-    74,
-    97,
-    0,
-    151,
-    152,
-    79,
-    79,
-    80,
-    154,
-    35,
-    36,
-    3,
-    224,
-    17,
-    23,
-    24,
-    25,
-    26,
-    27,
-    77,
-    78,
-    79,
-    80,
-    171,
-    44,
-    121,
-    74,
-    8,
-    74,
-    49,
-    74,
-    30,
-    17,
-    33,
-    74,
-    74,
-    56,
-    185,
-    186,
-    187,
-    44,
-    37,
-    33,
-    50,
-    64,
-    65,
-    66,
-    41,
-    38,
-    74,
-    18,
-    18,
-    72,
-    73,
-    74,
-    75,
-    76,
-    79,
-    78,
-    79,
-    64,
-    65,
-    66,
-    74,
-    19,
-    17,
-    74,
-    10,
-    72,
-    73,
-    74,
-    75,
-    76,
-    74,
-    78,
-    79,
-    34,
-    74,
-    226,
-    38,
-    75,
-    229,
-    18,
-    32,
-    19,
-    222,
-    74,
-    74,
-    74,
-    50,
-    19,
-    31,
-    19,
-    19,
-    74,
-    4,
-    5,
-    45,
-    246,
-    247,
-    9,
-    10,
-    11,
-    12,
-    13,
-    14,
-    15,
-    16,
-    256,
-    17,
-    49,
-    20,
-    21,
-    22,
-    6,
-    18,
-    17,
-    68,
-    46,
-    28,
-    29,
-    74,
-    18,
-    44,
-    19,
-    72,
-    71,
-    43,
-    37,
-    225,
-    39,
-    69,
-    48,
-    42,
-    50,
-    51,
-    52,
-    53,
-    54,
-    55,
-    56,
-    57,
-    74,
-    74,
-    74,
-    44,
-    35,
-    18,
-    67,
-    18,
-    18,
-    38,
-    69,
-    19,
-    18,
-    197,
-    162,
-    207,
-    233,
-    231,
-    198,
-    77,
-    78,
-    79,
-    80,
-    167,
-    103,
-    190,
-    143,
-    153,
-    241,
-    249,
-    -1,
-    256};
-
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] = {0,
-    4,
-    5,
-    9,
-    10,
-    11,
-    12,
-    13,
-    14,
-    15,
-    16,
-    20,
-    21,
-    22,
-    28,
-    29,
-    37,
-    39,
-    42,
-    83,
-    84,
-    85,
-    86,
-    87,
-    88,
-    89,
-    90,
-    91,
-    92,
-    93,
-    94,
-    97,
-    98,
-    99,
-    106,
-    112,
-    113,
-    121,
-    122,
-    139,
-    140,
-    141,
-    6,
-    58,
-    95,
-    6,
-    8,
-    17,
-    44,
-    64,
-    65,
-    66,
-    72,
-    73,
-    74,
-    75,
-    76,
-    78,
-    79,
-    111,
-    120,
-    123,
-    124,
-    125,
-    126,
-    127,
-    128,
-    123,
-    74,
-    7,
-    8,
-    31,
-    33,
-    74,
-    74,
-    40,
-    84,
-    0,
-    3,
-    142,
-    74,
-    8,
-    74,
-    74,
-    121,
-    123,
-    17,
-    30,
-    124,
-    30,
-    47,
-    74,
-    77,
-    78,
-    79,
-    80,
-    117,
-    17,
-    33,
-    33,
-    74,
-    74,
-    37,
-    50,
-    41,
-    17,
-    47,
-    103,
-    74,
-    38,
-    18,
-    18,
-    124,
-    74,
-    79,
-    79,
-    74,
-    124,
-    124,
-    124,
-    124,
-    19,
-    123,
-    74,
-    118,
-    74,
-    17,
-    107,
-    34,
-    129,
-    74,
-    115,
-    111,
-    75,
-    74,
-    101,
-    121,
-    38,
-    74,
-    18,
-    123,
-    18,
-    117,
-    19,
-    116,
-    74,
-    32,
-    49,
-    56,
-    124,
-    131,
-    138,
-    50,
-    19,
-    114,
-    31,
-    23,
-    24,
-    25,
-    26,
-    27,
-    105,
-    19,
-    100,
-    74,
-    45,
-    119,
-    118,
-    129,
-    19,
-    96,
-    17,
-    109,
-    49,
-    43,
-    48,
-    50,
-    51,
-    52,
-    53,
-    54,
-    55,
-    56,
-    57,
-    130,
-    137,
-    35,
-    36,
-    124,
-    124,
-    115,
-    129,
-    6,
-    17,
-    44,
-    56,
-    102,
-    101,
-    18,
-    17,
-    46,
-    116,
-    68,
-    135,
-    74,
-    18,
-    124,
-    19,
-    108,
-    44,
-    56,
-    48,
-    57,
-    124,
-    131,
-    131,
-    114,
-    74,
-    72,
-    104,
-    44,
-    100,
-    103,
-    74,
-    74,
-    69,
-    71,
-    136,
-    96,
-    19,
-    110,
-    109,
-    44,
-    18,
-    121,
-    96,
-    117,
-    123,
-    131,
-    67,
-    134,
-    124,
-    18,
-    108,
-    102,
-    18,
-    38,
-    69,
-    110,
-    131,
-    124,
-    132,
-    133,
-    119,
-    11,
-    70,
-    19,
-    133};
-
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] = {0,
-    82,
-    83,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    84,
-    85,
-    86,
-    87,
-    88,
-    89,
-    90,
-    91,
-    92,
-    93,
-    94,
-    95,
-    95,
-    96,
-    96,
-    97,
-    98,
-    99,
-    99,
-    99,
-    100,
-    100,
-    101,
-    101,
-    102,
-    102,
-    102,
-    103,
-    103,
-    104,
-    105,
-    105,
-    105,
-    105,
-    105,
-    106,
-    107,
-    107,
-    108,
-    108,
-    109,
-    110,
-    110,
-    111,
-    111,
-    111,
-    111,
-    111,
-    112,
-    113,
-    114,
-    114,
-    115,
-    116,
-    116,
-    117,
-    117,
-    117,
-    118,
-    119,
-    119,
-    120,
-    121,
-    121,
-    122,
-    123,
-    123,
-    124,
-    124,
-    124,
-    124,
-    124,
-    124,
-    124,
-    124,
-    124,
-    124,
-    124,
-    125,
-    126,
-    126,
-    126,
-    127,
-    128,
-    128,
-    128,
-    128,
-    128,
-    129,
-    129,
-    130,
-    130,
-    131,
-    131,
-    131,
-    131,
-    131,
-    132,
-    132,
-    132,
-    133,
-    133,
-    134,
-    134,
-    135,
-    135,
-    136,
-    136,
-    137,
-    137,
-    137,
-    137,
-    137,
-    137,
-    137,
-    137,
-    137,
-    137,
-    138,
-    138,
-    139,
-    140,
-    141,
-    142,
-    142};
-
-/* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_int8 yyr2[] = {0,
-    2,
-    2,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    3,
-    2,
-    2,
-    10,
-    0,
-    1,
-    0,
-    3,
-    5,
-    4,
-    7,
-    9,
-    5,
-    0,
-    3,
-    6,
-    3,
-    0,
-    1,
-    2,
-    0,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    7,
-    0,
-    4,
-    0,
-    3,
-    4,
-    0,
-    3,
-    1,
-    1,
-    1,
-    1,
-    1,
-    4,
-    6,
-    0,
-    3,
-    3,
-    0,
-    3,
-    0,
-    1,
-    2,
-    3,
-    0,
-    7,
-    3,
-    2,
-    9,
-    2,
-    2,
-    4,
-    3,
-    3,
-    3,
-    3,
-    3,
-    2,
-    1,
-    1,
-    1,
-    1,
-    1,
-    4,
-    1,
-    1,
-    1,
-    4,
-    1,
-    3,
-    3,
-    3,
-    1,
-    0,
-    2,
-    2,
-    3,
-    3,
-    2,
-    2,
-    3,
-    3,
-    1,
-    2,
-    2,
-    1,
-    3,
-    0,
-    3,
-    0,
-    3,
-    0,
-    2,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    1,
-    2,
-    1,
-    2,
-    1,
-    2,
-    7,
-    2,
-    4,
-    0,
-    1};
-
-#define yyerrok (yyerrstatus = 0)
-#define yyclearin (yychar = YYEMPTY)
-#define YYEMPTY (-2)
-#define YYEOF 0
-
-#define YYACCEPT goto yyacceptlab
-#define YYABORT goto yyabortlab
-#define YYERROR goto yyerrorlab
-
-#define YYRECOVERING() (!!yyerrstatus)
-
-#define YYBACKUP(Token, Value)                                                                \
-  do                                                                                          \
-    if (yychar == YYEMPTY) {                                                                  \
-      yychar = (Token);                                                                       \
-      yylval = (Value);                                                                       \
-      YYPOPSTACK(yylen);                                                                      \
-      yystate = *yyssp;                                                                       \
-      goto yybackup;                                                                          \
-    } else {                                                                                  \
-      yyerror(&yylloc, sql_string, sql_result, scanner, YY_("syntax error: cannot back up")); \
-      YYERROR;                                                                                \
-    }                                                                                         \
+static const yytype_int16 yytable[] =
+{
+      67,    88,    84,   142,   214,   215,    42,   193,    90,   232,
+      86,     4,   105,   209,   194,   211,    68,   -56,    47,   266,
+      71,    48,   113,    87,   212,   210,   195,   114,    69,    70,
+     112,   168,   241,    73,   194,    91,   117,   118,   119,   120,
+     139,   191,   106,    85,    72,    48,   195,    74,   244,    52,
+      53,   233,    55,    56,   106,    45,    75,    46,    43,   186,
+     187,    77,   136,    94,    95,    49,    50,    51,    78,   165,
+      81,   260,   149,    52,    53,    54,    55,    56,   267,    57,
+      58,   224,   186,   187,    80,    92,    93,    94,    95,    47,
+      89,    82,    90,   122,    83,   188,   189,    97,   103,    92,
+      93,    94,    95,    98,    99,    47,   102,   100,   242,    92,
+      93,    94,    95,   101,   104,   206,    48,   140,   108,    91,
+     109,   147,    92,    93,    94,    95,   110,   111,   148,   213,
+     149,   149,    48,   115,   121,   126,    49,    50,    51,   156,
+     157,   158,   159,   160,    52,    53,    54,    55,    56,   116,
+      57,    58,    49,    50,    51,    92,    93,    94,    95,   123,
+      52,    53,    54,    55,    56,   125,    57,    58,   128,   130,
+       4,   133,   134,   137,   149,   138,   141,   247,     1,     2,
+     143,   240,   146,     3,     4,     5,     6,     7,     8,     9,
+      10,   145,   152,   155,    11,    12,    13,   149,   261,   153,
+     162,   164,    14,    15,   165,   169,   171,   192,   198,   199,
+     174,    16,   261,    17,   173,   175,    18,   176,   177,   178,
+     179,   180,   181,   182,   183,   243,   204,   205,   200,   207,
+     217,   202,   220,   186,   237,   236,   218,   248,   245,   229,
+     221,   252,   227,   228,    92,    93,    94,    95,   230,   238,
+     239,   253,   251,   254,   268,    76,   223,   257,   235,   258,
+     250,   264,   197,   256,   226,   249,   255,   216,   167,   201,
+     269,     0,   190,     0,   265,   132
+};
+
+static const yytype_int16 yycheck[] =
+{
+       4,    57,    47,   123,   186,   187,     6,    17,    47,   204,
+      17,    10,    17,    44,    44,    48,    74,    10,    17,    11,
+      31,    44,    74,    30,    57,    56,    56,    79,     7,     8,
+      86,   144,   227,    74,    44,    74,    92,    93,    94,    95,
+      18,   154,    47,    47,    33,    44,    56,    74,   230,    72,
+      73,    19,    75,    76,    47,     6,    40,     8,    58,    35,
+      36,     0,   107,    79,    80,    64,    65,    66,     3,    45,
+       8,   253,   128,    72,    73,    74,    75,    76,    70,    78,
+      79,    74,    35,    36,    74,    77,    78,    79,    80,    17,
+      30,    74,    47,    97,    74,   151,   152,    17,    50,    77,
+      78,    79,    80,    33,    33,    17,    37,    74,   228,    77,
+      78,    79,    80,    74,    41,   171,    44,   121,    74,    74,
+      38,    49,    77,    78,    79,    80,    18,    18,    56,   185,
+     186,   187,    44,    79,    19,    17,    64,    65,    66,    23,
+      24,    25,    26,    27,    72,    73,    74,    75,    76,    74,
+      78,    79,    64,    65,    66,    77,    78,    79,    80,    74,
+      72,    73,    74,    75,    76,    74,    78,    79,    34,    74,
+      10,    75,    74,    38,   230,    74,    18,   233,     4,     5,
+      19,   226,    32,     9,    10,    11,    12,    13,    14,    15,
+      16,    74,    50,    31,    20,    21,    22,   253,   254,    19,
+      19,    74,    28,    29,    45,    19,    17,     6,    18,    17,
+      43,    37,   268,    39,    49,    48,    42,    50,    51,    52,
+      53,    54,    55,    56,    57,   229,    74,    18,    46,    19,
+      74,    68,    44,    35,    18,    44,    72,    18,    67,    69,
+      74,    18,    74,    74,    77,    78,    79,    80,    71,    74,
+      74,    38,    50,    69,    19,    18,   197,    74,   207,    74,
+     237,    74,   162,   250,   198,   235,   247,   190,   143,   167,
+     268,    -1,   153,    -1,   260,   103
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_uint8 yystos[] =
+{
+       0,     4,     5,     9,    10,    11,    12,    13,    14,    15,
+      16,    20,    21,    22,    28,    29,    37,    39,    42,    83,
+      84,    85,    86,    87,    88,    89,    90,    91,    92,    93,
+      94,    98,    99,   100,   109,   115,   116,   124,   125,   142,
+     143,   144,     6,    58,    95,     6,     8,    17,    44,    64,
+      65,    66,    72,    73,    74,    75,    76,    78,    79,   114,
+     123,   126,   127,   128,   129,   130,   131,   126,    74,     7,
+       8,    31,    33,    74,    74,    40,    84,     0,     3,   145,
+      74,     8,    74,    74,   124,   126,    17,    30,   127,    30,
+      47,    74,    77,    78,    79,    80,   120,    17,    33,    33,
+      74,    74,    37,    50,    41,    17,    47,   106,    74,    38,
+      18,    18,   127,    74,    79,    79,    74,   127,   127,   127,
+     127,    19,   126,    74,   121,    74,    17,   110,    34,   132,
+      74,   118,   114,    75,    74,   102,   124,    38,    74,    18,
+     126,    18,   120,    19,   119,    74,    32,    49,    56,   127,
+     134,   141,    50,    19,   117,    31,    23,    24,    25,    26,
+      27,   108,    19,   101,    74,    45,   122,   121,   132,    19,
+      97,    17,   112,    49,    43,    48,    50,    51,    52,    53,
+      54,    55,    56,    57,   133,   140,    35,    36,   127,   127,
+     118,   132,     6,    17,    44,    56,   105,   102,    18,    17,
+      46,   119,    68,   138,    74,    18,   127,    19,   111,    44,
+      56,    48,    57,   127,   134,   134,   117,    74,    72,   107,
+      44,    74,   103,   101,    74,   104,   106,    74,    74,    69,
+      71,   139,    97,    19,   113,   112,    44,    18,    74,    74,
+     124,    97,   120,   126,   134,    67,   137,   127,    18,   111,
+     105,    50,    18,    38,    69,   113,   103,    74,    74,    96,
+     134,   127,   135,   136,    74,   122,    11,    70,    19,   136
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_uint8 yyr1[] =
+{
+       0,    82,    83,    84,    84,    84,    84,    84,    84,    84,
+      84,    84,    84,    84,    84,    84,    84,    84,    84,    84,
+      84,    84,    84,    84,    85,    86,    87,    88,    89,    90,
+      91,    92,    93,    94,    95,    95,    96,    96,    97,    97,
+      98,    99,   100,   100,   100,   101,   101,   102,   102,   103,
+     103,   104,   104,   105,   105,   105,   106,   106,   107,   108,
+     108,   108,   108,   108,   109,   110,   110,   111,   111,   112,
+     113,   113,   114,   114,   114,   114,   114,   115,   116,   117,
+     117,   118,   119,   119,   120,   120,   120,   121,   122,   122,
+     123,   124,   124,   125,   126,   126,   127,   127,   127,   127,
+     127,   127,   127,   127,   127,   127,   127,   128,   129,   129,
+     129,   130,   131,   131,   131,   131,   131,   132,   132,   133,
+     133,   134,   134,   134,   134,   134,   135,   135,   135,   136,
+     136,   137,   137,   138,   138,   139,   139,   140,   140,   140,
+     140,   140,   140,   140,   140,   140,   140,   141,   141,   142,
+     143,   144,   145,   145
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       3,     2,     2,    11,     0,     1,     0,     2,     0,     3,
+       5,     4,     8,     9,     5,     0,     3,     7,     4,     0,
+       2,     0,     4,     0,     1,     2,     0,     1,     1,     1,
+       1,     1,     1,     1,     7,     0,     4,     0,     3,     4,
+       0,     3,     1,     1,     1,     1,     1,     4,     6,     0,
+       3,     3,     0,     3,     0,     1,     2,     3,     0,     7,
+       3,     2,     9,     2,     2,     4,     3,     3,     3,     3,
+       3,     2,     1,     1,     1,     1,     1,     4,     1,     1,
+       1,     4,     1,     3,     3,     3,     1,     0,     2,     2,
+       3,     3,     2,     2,     3,     3,     1,     2,     2,     1,
+       3,     0,     3,     0,     3,     0,     2,     1,     1,     1,
+       1,     1,     1,     1,     2,     1,     2,     1,     2,     7,
+       2,     4,     0,     1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (&yylloc, sql_string, sql_result, scanner, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR 1
-#define YYERRCODE 256
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
    the previous symbol: RHS[0] (always defined).  */
 
 #ifndef YYLLOC_DEFAULT
-#define YYLLOC_DEFAULT(Current, Rhs, N)                                              \
-  do                                                                                 \
-    if (N) {                                                                         \
-      (Current).first_line   = YYRHSLOC(Rhs, 1).first_line;                          \
-      (Current).first_column = YYRHSLOC(Rhs, 1).first_column;                        \
-      (Current).last_line    = YYRHSLOC(Rhs, N).last_line;                           \
-      (Current).last_column  = YYRHSLOC(Rhs, N).last_column;                         \
-    } else {                                                                         \
-      (Current).first_line = (Current).last_line = YYRHSLOC(Rhs, 0).last_line;       \
-      (Current).first_column = (Current).last_column = YYRHSLOC(Rhs, 0).last_column; \
-    }                                                                                \
-  while (0)
+# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
+          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
+          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
+          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).first_line   = (Current).last_line   =              \
+            YYRHSLOC (Rhs, 0).last_line;                                \
+          (Current).first_column = (Current).last_column =              \
+            YYRHSLOC (Rhs, 0).last_column;                              \
+        }                                                               \
+    while (0)
 #endif
 
 #define YYRHSLOC(Rhs, K) ((Rhs)[K])
 
+
 /* Enable debugging if requested.  */
 #if YYDEBUG
 
-#ifndef YYFPRINTF
-#include <stdio.h> /* INFRINGES ON USER NAME SPACE */
-#define YYFPRINTF fprintf
-#endif
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
 
-#define YYDPRINTF(Args) \
-  do {                  \
-    if (yydebug)        \
-      YYFPRINTF Args;   \
-  } while (0)
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-#if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
 YY_ATTRIBUTE_UNUSED
-static int yy_location_print_(FILE *yyo, YYLTYPE const *const yylocp)
+static int
+yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
 {
-  int res     = 0;
+  int res = 0;
   int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
-  if (0 <= yylocp->first_line) {
-    res += YYFPRINTF(yyo, "%d", yylocp->first_line);
-    if (0 <= yylocp->first_column)
-      res += YYFPRINTF(yyo, ".%d", yylocp->first_column);
-  }
-  if (0 <= yylocp->last_line) {
-    if (yylocp->first_line < yylocp->last_line) {
-      res += YYFPRINTF(yyo, "-%d", yylocp->last_line);
-      if (0 <= end_col)
-        res += YYFPRINTF(yyo, ".%d", end_col);
-    } else if (0 <= end_col && yylocp->first_column < end_col)
-      res += YYFPRINTF(yyo, "-%d", end_col);
-  }
+  if (0 <= yylocp->first_line)
+    {
+      res += YYFPRINTF (yyo, "%d", yylocp->first_line);
+      if (0 <= yylocp->first_column)
+        res += YYFPRINTF (yyo, ".%d", yylocp->first_column);
+    }
+  if (0 <= yylocp->last_line)
+    {
+      if (yylocp->first_line < yylocp->last_line)
+        {
+          res += YYFPRINTF (yyo, "-%d", yylocp->last_line);
+          if (0 <= end_col)
+            res += YYFPRINTF (yyo, ".%d", end_col);
+        }
+      else if (0 <= end_col && yylocp->first_column < end_col)
+        res += YYFPRINTF (yyo, "-%d", end_col);
+    }
   return res;
 }
 
-#define YY_LOCATION_PRINT(File, Loc) yy_location_print_(File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-#else
-#define YY_LOCATION_PRINT(File, Loc) ((void)0)
-#endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, Location, sql_string, sql_result, scanner); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
 
-#define YY_SYMBOL_PRINT(Title, Type, Value, Location)                                  \
-  do {                                                                                 \
-    if (yydebug) {                                                                     \
-      YYFPRINTF(stderr, "%s ", Title);                                                 \
-      yy_symbol_print(stderr, Type, Value, Location, sql_string, sql_result, scanner); \
-      YYFPRINTF(stderr, "\n");                                                         \
-    }                                                                                  \
-  } while (0)
 
 /*-----------------------------------.
 | Print this symbol's value on YYO.  |
 `-----------------------------------*/
 
-static void yy_symbol_value_print(FILE *yyo, int yytype, YYSTYPE const *const yyvaluep,
-    YYLTYPE const *const yylocationp, const char *sql_string, ParsedSqlResult *sql_result, void *scanner)
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
   FILE *yyoutput = yyo;
-  YYUSE(yyoutput);
-  YYUSE(yylocationp);
-  YYUSE(sql_string);
-  YYUSE(sql_result);
-  YYUSE(scanner);
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (sql_string);
+  YY_USE (sql_result);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-#ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT(yyo, yytoknum[yytype], *yyvaluep);
-#endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE(yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
+
 /*---------------------------.
 | Print this symbol on YYO.  |
 `---------------------------*/
 
-static void yy_symbol_print(FILE *yyo, int yytype, YYSTYPE const *const yyvaluep, YYLTYPE const *const yylocationp,
-    const char *sql_string, ParsedSqlResult *sql_result, void *scanner)
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-  YYFPRINTF(yyo, "%s %s (", yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT(yyo, *yylocationp);
-  YYFPRINTF(yyo, ": ");
-  yy_symbol_value_print(yyo, yytype, yyvaluep, yylocationp, sql_string, sql_result, scanner);
-  YYFPRINTF(yyo, ")");
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, sql_string, sql_result, scanner);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -3241,66 +1204,70 @@ static void yy_symbol_print(FILE *yyo, int yytype, YYSTYPE const *const yyvaluep
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-static void yy_stack_print(yy_state_t *yybottom, yy_state_t *yytop)
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
-  YYFPRINTF(stderr, "Stack now");
-  for (; yybottom <= yytop; yybottom++) {
-    int yybot = *yybottom;
-    YYFPRINTF(stderr, " %d", yybot);
-  }
-  YYFPRINTF(stderr, "\n");
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
 }
 
-#define YY_STACK_PRINT(Bottom, Top)    \
-  do {                                 \
-    if (yydebug)                       \
-      yy_stack_print((Bottom), (Top)); \
-  } while (0)
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-static void yy_reduce_print(yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, const char *sql_string,
-    ParsedSqlResult *sql_result, void *scanner)
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-  int yylno  = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF(stderr, "Reducing stack by rule %d (line %d):\n", yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
-  for (yyi = 0; yyi < yynrhs; yyi++) {
-    YYFPRINTF(stderr, "   $%d = ", yyi + 1);
-    yy_symbol_print(stderr,
-        yystos[+yyssp[yyi + 1 - yynrhs]],
-        &yyvsp[(yyi + 1) - (yynrhs)],
-        &(yylsp[(yyi + 1) - (yynrhs)]),
-        sql_string,
-        sql_result,
-        scanner);
-    YYFPRINTF(stderr, "\n");
-  }
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), sql_string, sql_result, scanner);
+      YYFPRINTF (stderr, "\n");
+    }
 }
 
-#define YY_REDUCE_PRINT(Rule)                                                      \
-  do {                                                                             \
-    if (yydebug)                                                                   \
-      yy_reduce_print(yyssp, yyvsp, yylsp, Rule, sql_string, sql_result, scanner); \
-  } while (0)
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, sql_string, sql_result, scanner); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-#define YYDPRINTF(Args)
-#define YY_SYMBOL_PRINT(Title, Type, Value, Location)
-#define YY_STACK_PRINT(Bottom, Top)
-#define YY_REDUCE_PRINT(Rule)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
+
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
 #ifndef YYINITDEPTH
-#define YYINITDEPTH 200
+# define YYINITDEPTH 200
 #endif
 
 /* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
@@ -3311,35 +1278,87 @@ int yydebug;
    evaluated with infinite-precision integer arithmetic.  */
 
 #ifndef YYMAXDEPTH
-#define YYMAXDEPTH 10000
+# define YYMAXDEPTH 10000
 #endif
 
-#if YYERROR_VERBOSE
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
 
 #ifndef yystrlen
-#if defined __GLIBC__ && defined _STRING_H
-#define yystrlen(S) (YY_CAST(YYPTRDIFF_T, strlen(S)))
-#else
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
-static YYPTRDIFF_T yystrlen(const char *yystr)
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
 {
   YYPTRDIFF_T yylen;
   for (yylen = 0; yystr[yylen]; yylen++)
     continue;
   return yylen;
 }
-#endif
+# endif
 #endif
 
 #ifndef yystpcpy
-#if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#define yystpcpy stpcpy
-#else
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
-static char *yystpcpy(char *yydest, const char *yysrc)
+static char *
+yystpcpy (char *yydest, const char *yysrc)
 {
-  char       *yyd = yydest;
+  char *yyd = yydest;
   const char *yys = yysrc;
 
   while ((*yyd++ = *yys++) != '\0')
@@ -3347,7 +1366,7 @@ static char *yystpcpy(char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#endif
+# endif
 #endif
 
 #ifndef yytnamerr
@@ -3358,69 +1377,55 @@ static char *yystpcpy(char *yydest, const char *yysrc)
    backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
    null, do not copy; instead, return the length of what the result
    would have been.  */
-static YYPTRDIFF_T yytnamerr(char *yyres, const char *yystr)
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
 {
-  if (*yystr == '"') {
-    YYPTRDIFF_T yyn = 0;
-    char const *yyp = yystr;
+  if (*yystr == '"')
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
 
-    for (;;)
-      switch (*++yyp) {
-        case '\'':
-        case ',': goto do_not_strip_quotes;
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
 
-        case '\\':
-          if (*++yyp != '\\')
-            goto do_not_strip_quotes;
-          else
-            goto append;
-
-        append:
-        default:
-          if (yyres)
-            yyres[yyn] = *yyp;
-          yyn++;
-          break;
-
-        case '"':
-          if (yyres)
-            yyres[yyn] = '\0';
-          return yyn;
-      }
-  do_not_strip_quotes:;
-  }
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
+    }
 
   if (yyres)
-    return yystpcpy(yyres, yystr) - yyres;
+    return yystpcpy (yyres, yystr) - yyres;
   else
-    return yystrlen(yystr);
+    return yystrlen (yystr);
 }
 #endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int yysyntax_error(YYPTRDIFF_T *yymsg_alloc, char **yymsg, yy_state_t *yyssp, int yytoken)
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  enum
-  {
-    YYERROR_VERBOSE_ARGS_MAXIMUM = 5
-  };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
   /* Actual size of YYARG. */
   int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -3444,43 +1449,54 @@ static int yysyntax_error(YYPTRDIFF_T *yymsg_alloc, char **yymsg, yy_state_t *yy
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY) {
-    int         yyn     = yypact[+*yyssp];
-    YYPTRDIFF_T yysize0 = yytnamerr(YY_NULLPTR, yytname[yytoken]);
-    yysize              = yysize0;
-    yyarg[yycount++]    = yytname[yytoken];
-    if (!yypact_value_is_default(yyn)) {
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-         YYCHECK.  In other words, skip the first -YYN actions for
-         this state because they are default actions.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend     = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yyx;
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
 
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-        if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR && !yytable_value_is_error(yytable[yyx + yyn])) {
-          if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM) {
-            yycount = 1;
-            yysize  = yysize0;
-            break;
-          }
-          yyarg[yycount++] = yytname[yyx];
-          {
-            YYPTRDIFF_T yysize1 = yysize + yytnamerr(YY_NULLPTR, yytname[yyx]);
-            if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-              yysize = yysize1;
-            else
-              return 2;
-          }
-        }
-    }
-  }
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
 
-  switch (yycount) {
-#define YYCASE_(N, S) \
-  case N: yyformat = S; break
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
     default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
@@ -3489,159 +1505,167 @@ static int yysyntax_error(YYPTRDIFF_T *yymsg_alloc, char **yymsg, yy_state_t *yy
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
 #undef YYCASE_
-  }
+    }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen(yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
-  if (*yymsg_alloc < yysize) {
-    *yymsg_alloc = 2 * yysize;
-    if (!(yysize <= *yymsg_alloc && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-      *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-    return 1;
-  }
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
 
   /* Avoid sprintf, as that infringes on the user's name space.
      Don't have undefined behavior even if the translation
      produced a string with the wrong number of "%s"s.  */
   {
     char *yyp = *yymsg;
-    int   yyi = 0;
+    int yyi = 0;
     while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount) {
-        yyp += yytnamerr(yyp, yyarg[yyi++]);
-        yyformat += 2;
-      } else {
-        ++yyp;
-        ++yyformat;
-      }
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-static void yydestruct(const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, const char *sql_string,
-    ParsedSqlResult *sql_result, void *scanner)
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-  YYUSE(yyvaluep);
-  YYUSE(yylocationp);
-  YYUSE(sql_string);
-  YYUSE(sql_result);
-  YYUSE(scanner);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (sql_string);
+  YY_USE (sql_result);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT(yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE(yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
+
+
+
+
+
 /*----------.
 | yyparse.  |
 `----------*/
 
-int yyparse(const char *sql_string, ParsedSqlResult *sql_result, void *scanner)
+int
+yyparse (const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-  /* The lookahead symbol.  */
-  int yychar;
-
-  /* The semantic value of the lookahead symbol.  */
-  /* Default value used for initialization, for pacifying older GCCs
-     or non-GCC compilers.  */
-  YY_INITIAL_VALUE(static YYSTYPE yyval_default;)
-  YYSTYPE yylval YY_INITIAL_VALUE(= yyval_default);
-
-  /* Location data for the lookahead symbol.  */
-  static YYLTYPE yyloc_default
-#if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
-      = {1, 1, 1, 1}
-#endif
-  ;
-  YYLTYPE yylloc = yyloc_default;
+/* Lookahead token kind.  */
+int yychar;
 
-  /* Number of syntax errors so far.  */
-  int yynerrs;
 
-  yy_state_fast_t yystate;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
 
-  /* The stacks and their tools:
-     'yyss': related to states.
-     'yyvs': related to semantic values.
-     'yyls': related to locations.
+/* Location data for the lookahead symbol.  */
+static YYLTYPE yyloc_default
+# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+  = { 1, 1, 1, 1 }
+# endif
+;
+YYLTYPE yylloc = yyloc_default;
 
-     Refer to the stacks through separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-  /* The state stack.  */
-  yy_state_t  yyssa[YYINITDEPTH];
-  yy_state_t *yyss;
-  yy_state_t *yyssp;
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-  /* The semantic value stack.  */
-  YYSTYPE  yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs;
-  YYSTYPE *yyvsp;
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
-  /* The location stack.  */
-  YYLTYPE  yylsa[YYINITDEPTH];
-  YYLTYPE *yyls;
-  YYLTYPE *yylsp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-  /* The locations where the error started and ended.  */
-  YYLTYPE yyerror_range[3];
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-  YYPTRDIFF_T yystacksize;
+    /* The location stack: array, bottom, top.  */
+    YYLTYPE yylsa[YYINITDEPTH];
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
-  char        yymsgbuf[128];
-  char       *yymsg       = yymsgbuf;
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
   YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
-#define YYPOPSTACK(N) (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize  = YYINITDEPTH;
+  YYDPRINTF ((stderr, "Starting parse\n"));
 
-  YYDPRINTF((stderr, "Starting parse\n"));
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
-  yystate     = 0;
-  yyerrstatus = 0;
-  yynerrs     = 0;
-  yychar      = YYEMPTY; /* Cause a token to be read.  */
-  yylsp[0]    = yylloc;
+  yylsp[0] = yylloc;
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
 | yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
@@ -3650,89 +1674,93 @@ yynewstate:
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
+
 /*--------------------------------------------------------------------.
 | yysetstate -- set current state (the top of the stack) to yystate.  |
 `--------------------------------------------------------------------*/
 yysetstate:
-  YYDPRINTF((stderr, "Entering state %d\n", yystate));
-  YY_ASSERT(0 <= yystate && yystate < YYNSTATES);
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
   YY_IGNORE_USELESS_CAST_BEGIN
-  *yyssp = YY_CAST(yy_state_t, yystate);
+  *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
-  {
-    /* Get the current used size of the three stacks, in elements.  */
-    YYPTRDIFF_T yysize = yyssp - yyss + 1;
-
-#if defined yyoverflow
-    {
-      /* Give user a chance to reallocate the stack.  Use copies of
-         these so that the &'s don't force the real ones into
-         memory.  */
-      yy_state_t *yyss1 = yyss;
-      YYSTYPE    *yyvs1 = yyvs;
-      YYLTYPE    *yyls1 = yyls;
-
-      /* Each stack pointer address is followed by the size of the
-         data in use in that stack, in bytes.  This used to be a
-         conditional around just the two extra args, but that might
-         be undefined if yyoverflow is a macro.  */
-      yyoverflow(YY_("memory exhausted"),
-          &yyss1,
-          yysize * YYSIZEOF(*yyssp),
-          &yyvs1,
-          yysize * YYSIZEOF(*yyvsp),
-          &yyls1,
-          yysize * YYSIZEOF(*yylsp),
-          &yystacksize);
-      yyss = yyss1;
-      yyvs = yyvs1;
-      yyls = yyls1;
-    }
-#else /* defined YYSTACK_RELOCATE */
-    /* Extend the stack our own way.  */
-    if (YYMAXDEPTH <= yystacksize)
-      goto yyexhaustedlab;
-    yystacksize *= 2;
-    if (YYMAXDEPTH < yystacksize)
-      yystacksize = YYMAXDEPTH;
-
     {
-      yy_state_t    *yyss1 = yyss;
-      union yyalloc *yyptr = YY_CAST(union yyalloc *, YYSTACK_ALLOC(YY_CAST(YYSIZE_T, YYSTACK_BYTES(yystacksize))));
-      if (!yyptr)
-        goto yyexhaustedlab;
-      YYSTACK_RELOCATE(yyss_alloc, yyss);
-      YYSTACK_RELOCATE(yyvs_alloc, yyvs);
-      YYSTACK_RELOCATE(yyls_alloc, yyls);
-#undef YYSTACK_RELOCATE
-      if (yyss1 != yyssa)
-        YYSTACK_FREE(yyss1);
-    }
-#endif
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+        YYLTYPE *yyls1 = yyls;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+        yyls = yyls1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        YYSTACK_RELOCATE (yyls_alloc, yyls);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
 
-    yyssp = yyss + yysize - 1;
-    yyvsp = yyvs + yysize - 1;
-    yylsp = yyls + yysize - 1;
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+      yylsp = yyls + yysize - 1;
 
-    YY_IGNORE_USELESS_CAST_BEGIN
-    YYDPRINTF((stderr, "Stack size increased to %ld\n", YY_CAST(long, yystacksize)));
-    YY_IGNORE_USELESS_CAST_END
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
-    if (yyss + yystacksize - 1 <= yyssp)
-      YYABORT;
-  }
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
@@ -3742,24 +1770,40 @@ yybackup:
 
   /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yypact_value_is_default(yyn))
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
-  if (yychar == YYEMPTY) {
-    YYDPRINTF((stderr, "Reading a token: "));
-    yychar = yylex(&yylval, &yylloc, scanner);
-  }
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, &yylloc, scanner);
+    }
 
-  if (yychar <= YYEOF) {
-    yychar = yytoken = YYEOF;
-    YYDPRINTF((stderr, "Now at end of input.\n"));
-  } else {
-    yytoken = YYTRANSLATE(yychar);
-    YY_SYMBOL_PRINT("Next token is", yytoken, &yylval, &yylloc);
-  }
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
 
   /* If the proper action on seeing token YYTOKEN is to reduce or to
      detect an error, take that action.  */
@@ -3767,12 +1811,13 @@ yybackup:
   if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
     goto yydefault;
   yyn = yytable[yyn];
-  if (yyn <= 0) {
-    if (yytable_value_is_error(yyn))
-      goto yyerrlab;
-    yyn = -yyn;
-    goto yyreduce;
-  }
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
 
   /* Count tokens shifted since error; after three, turn off error
      status.  */
@@ -3780,7 +1825,7 @@ yybackup:
     yyerrstatus--;
 
   /* Shift the lookahead token.  */
-  YY_SYMBOL_PRINT("Shifting", yytoken, &yylval, &yylloc);
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
@@ -3791,6 +1836,7 @@ yybackup:
   yychar = YYEMPTY;
   goto yynewstate;
 
+
 /*-----------------------------------------------------------.
 | yydefault -- do the default action for the current state.  |
 `-----------------------------------------------------------*/
@@ -3800,6 +1846,7 @@ yydefault:
     goto yyerrlab;
   goto yyreduce;
 
+
 /*-----------------------------.
 | yyreduce -- do a reduction.  |
 `-----------------------------*/
@@ -3815,148 +1862,179 @@ yyreduce:
      users should not rely upon it.  Assigning to YYVAL
      unconditionally makes the parser a bit smaller, and it avoids a
      GCC warning that YYVAL may be used uninitialized.  */
-  yyval = yyvsp[1 - yylen];
+  yyval = yyvsp[1-yylen];
 
   /* Default location. */
-  YYLLOC_DEFAULT(yyloc, (yylsp - yylen), yylen);
+  YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
   yyerror_range[1] = yyloc;
-  YY_REDUCE_PRINT(yyn);
-  switch (yyn) {
-    case 2:
-#line 254 "yacc_sql.y"
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
     {
-      std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
-      sql_result->add_sql_node(std::move(sql_node));
-    }
-#line 3832 "yacc_sql.cpp"
+  case 2: /* commands: command_wrapper opt_semicolon  */
+#line 257 "yacc_sql.y"
+  {
+    std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
+    sql_result->add_sql_node(std::move(sql_node));
+  }
+#line 1880 "yacc_sql.cpp"
     break;
 
-    case 24:
-#line 285 "yacc_sql.y"
-    {
+  case 24: /* exit_stmt: EXIT  */
+#line 288 "yacc_sql.y"
+         {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 3841 "yacc_sql.cpp"
+#line 1889 "yacc_sql.cpp"
     break;
 
-    case 25:
-#line 291 "yacc_sql.y"
-    {
+  case 25: /* help_stmt: HELP  */
+#line 294 "yacc_sql.y"
+         {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 3849 "yacc_sql.cpp"
+#line 1897 "yacc_sql.cpp"
     break;
 
-    case 26:
-#line 296 "yacc_sql.y"
-    {
+  case 26: /* sync_stmt: SYNC  */
+#line 299 "yacc_sql.y"
+         {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 3857 "yacc_sql.cpp"
+#line 1905 "yacc_sql.cpp"
     break;
 
-    case 27:
-#line 302 "yacc_sql.y"
-    {
+  case 27: /* begin_stmt: TRX_BEGIN  */
+#line 305 "yacc_sql.y"
+               {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 3865 "yacc_sql.cpp"
+#line 1913 "yacc_sql.cpp"
     break;
 
-    case 28:
-#line 308 "yacc_sql.y"
-    {
+  case 28: /* commit_stmt: TRX_COMMIT  */
+#line 311 "yacc_sql.y"
+               {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 3873 "yacc_sql.cpp"
+#line 1921 "yacc_sql.cpp"
     break;
 
-    case 29:
-#line 314 "yacc_sql.y"
-    {
+  case 29: /* rollback_stmt: TRX_ROLLBACK  */
+#line 317 "yacc_sql.y"
+                  {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 3881 "yacc_sql.cpp"
+#line 1929 "yacc_sql.cpp"
     break;
 
-    case 30:
-#line 320 "yacc_sql.y"
-    {
-      (yyval.sql_node)                           = new ParsedSqlNode(SCF_DROP_TABLE);
+  case 30: /* drop_table_stmt: DROP TABLE ID  */
+#line 323 "yacc_sql.y"
+                  {
+      (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 3891 "yacc_sql.cpp"
+#line 1939 "yacc_sql.cpp"
     break;
 
-    case 31:
-#line 327 "yacc_sql.y"
-    {
+  case 31: /* show_tables_stmt: SHOW TABLES  */
+#line 330 "yacc_sql.y"
+                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 3899 "yacc_sql.cpp"
+#line 1947 "yacc_sql.cpp"
     break;
 
-    case 32:
-#line 333 "yacc_sql.y"
-    {
-      (yyval.sql_node)                           = new ParsedSqlNode(SCF_DESC_TABLE);
+  case 32: /* desc_table_stmt: DESC ID  */
+#line 336 "yacc_sql.y"
+             {
+      (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
       (yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 3909 "yacc_sql.cpp"
+#line 1957 "yacc_sql.cpp"
     break;
 
-    case 33:
-#line 342 "yacc_sql.y"
+  case 33: /* create_index_stmt: CREATE unique_option INDEX ID ON ID LBRACE ID idx_col_list RBRACE index_type_option  */
+#line 345 "yacc_sql.y"
     {
-      (yyval.sql_node)                 = new ParsedSqlNode(SCF_CREATE_INDEX);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
-      create_index.unique              = (yyvsp[-8].boolean);
-      create_index.index_name          = (yyvsp[-6].string);
-      create_index.relation_name       = (yyvsp[-4].string);
-
-      std::vector<std::string> *idx_cols = (yyvsp[-1].relation_list);
+      create_index.unique = (yyvsp[-9].boolean);
+      create_index.index_type = static_cast<IndexType>((yyvsp[0].number));
+      create_index.index_name = (yyvsp[-7].string);
+      create_index.relation_name = (yyvsp[-5].string);
+      
+      std::vector<std::string> *idx_cols = (yyvsp[-2].relation_list);
       if (nullptr != idx_cols) {
         create_index.attr_names.swap(*idx_cols);
-        delete (yyvsp[-1].relation_list);
+        delete (yyvsp[-2].relation_list);
       }
-      create_index.attr_names.emplace_back((yyvsp[-2].string));
+      create_index.attr_names.emplace_back((yyvsp[-3].string));
       std::reverse(create_index.attr_names.begin(), create_index.attr_names.end());
-      free((yyvsp[-6].string));
-      free((yyvsp[-4].string));
-      free((yyvsp[-2].string));
+      free((yyvsp[-7].string));
+      free((yyvsp[-5].string));
+      free((yyvsp[-3].string));
     }
-#line 3932 "yacc_sql.cpp"
+#line 1981 "yacc_sql.cpp"
     break;
 
-    case 34:
-#line 363 "yacc_sql.y"
+  case 34: /* unique_option: %empty  */
+#line 367 "yacc_sql.y"
     {
       (yyval.boolean) = false;
     }
-#line 3940 "yacc_sql.cpp"
+#line 1989 "yacc_sql.cpp"
     break;
 
-    case 35:
-#line 367 "yacc_sql.y"
+  case 35: /* unique_option: UNIQUE  */
+#line 371 "yacc_sql.y"
     {
       (yyval.boolean) = true;
     }
-#line 3948 "yacc_sql.cpp"
+#line 1997 "yacc_sql.cpp"
+    break;
+
+  case 36: /* index_type_option: %empty  */
+#line 378 "yacc_sql.y"
+    {
+      (yyval.number) = static_cast<int>(IndexType::BPLUS_TREE);
+    }
+#line 2005 "yacc_sql.cpp"
+    break;
+
+  case 37: /* index_type_option: ID ID  */
+#line 382 "yacc_sql.y"
+    {
+      bool valid = (0 == strcasecmp((yyvsp[-1].string), "using"));
+      if (valid && 0 == strcasecmp((yyvsp[0].string), "hash")) {
+        (yyval.number) = static_cast<int>(IndexType::HASH);
+      } else if (valid && (0 == strcasecmp((yyvsp[0].string), "btree") || 0 == strcasecmp((yyvsp[0].string), "bplus_tree"))) {
+        (yyval.number) = static_cast<int>(IndexType::BPLUS_TREE);
+      } else {
+        valid = false;
+      }
+      free((yyvsp[-1].string));
+      free((yyvsp[0].string));
+      if (!valid) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "unsupported index type");
+        YYERROR;
+      }
+    }
+#line 2026 "yacc_sql.cpp"
     break;
 
-    case 36:
-#line 372 "yacc_sql.y"
+  case 38: /* idx_col_list: %empty  */
+#line 401 "yacc_sql.y"
     {
       (yyval.relation_list) = nullptr;
     }
-#line 3956 "yacc_sql.cpp"
+#line 2034 "yacc_sql.cpp"
     break;
 
-    case 37:
-#line 376 "yacc_sql.y"
+  case 39: /* idx_col_list: COMMA ID idx_col_list  */
+#line 405 "yacc_sql.y"
     {
       if ((yyvsp[0].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[0].relation_list);
@@ -3966,58 +2044,62 @@ yyreduce:
       (yyval.relation_list)->emplace_back((yyvsp[-1].string));
       free((yyvsp[-1].string));
     }
-#line 3970 "yacc_sql.cpp"
+#line 2048 "yacc_sql.cpp"
     break;
 
-    case 38:
-#line 389 "yacc_sql.y"
+  case 40: /* drop_index_stmt: DROP INDEX ID ON ID  */
+#line 418 "yacc_sql.y"
     {
-      (yyval.sql_node)                           = new ParsedSqlNode(SCF_DROP_INDEX);
-      (yyval.sql_node)->drop_index.index_name    = (yyvsp[-2].string);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
+      (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
       (yyval.sql_node)->drop_index.relation_name = (yyvsp[0].string);
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 3982 "yacc_sql.cpp"
+#line 2060 "yacc_sql.cpp"
     break;
 
-    case 39:
-#line 400 "yacc_sql.y"
+  case 41: /* show_index_stmt: SHOW INDEX FROM ID  */
+#line 429 "yacc_sql.y"
     {
-      (yyval.sql_node)                           = new ParsedSqlNode(SCF_SHOW_INDEX);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_INDEX);
       (yyval.sql_node)->show_index.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 3992 "yacc_sql.cpp"
+#line 2070 "yacc_sql.cpp"
     break;
 
-    case 40:
-#line 409 "yacc_sql.y"
+  case 42: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format_option  */
+#line 438 "yacc_sql.y"
     {
-      (yyval.sql_node)                 = new ParsedSqlNode(SCF_CREATE_TABLE);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
-      create_table.relation_name       = (yyvsp[-4].string);
-      free((yyvsp[-4].string));
+      create_table.relation_name = (yyvsp[-5].string);
+      free((yyvsp[-5].string));
 
-      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-1].attr_infos);
+      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-2].attr_infos);
 
       if (src_attrs != nullptr) {
         create_table.attr_infos.swap(*src_attrs);
       }
-      create_table.attr_infos.emplace_back(*(yyvsp[-2].attr_info));
+      create_table.attr_infos.emplace_back(*(yyvsp[-3].attr_info));
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
-      delete (yyvsp[-2].attr_info);
+      delete (yyvsp[-3].attr_info);
+      if ((yyvsp[0].string) != nullptr) {
+        create_table.storage_format = (yyvsp[0].string);
+        free((yyvsp[0].string));
+      }
     }
-#line 4012 "yacc_sql.cpp"
+#line 2094 "yacc_sql.cpp"
     break;
 
-    case 41:
-#line 425 "yacc_sql.y"
+  case 43: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE as_option select_stmt  */
+#line 458 "yacc_sql.y"
     {
-      (yyval.sql_node)                 = (yyvsp[0].sql_node);
-      (yyval.sql_node)->flag           = SCF_CREATE_TABLE;
+      (yyval.sql_node) = (yyvsp[0].sql_node);
+      (yyval.sql_node)->flag = SCF_CREATE_TABLE;
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
-      create_table.relation_name       = (yyvsp[-6].string);
+      create_table.relation_name = (yyvsp[-6].string);
       free((yyvsp[-6].string));
 
       std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-3].attr_infos);
@@ -4028,31 +2110,31 @@ yyreduce:
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
       delete (yyvsp[-4].attr_info);
     }
-#line 4032 "yacc_sql.cpp"
+#line 2114 "yacc_sql.cpp"
     break;
 
-    case 42:
-#line 441 "yacc_sql.y"
+  case 44: /* create_table_stmt: CREATE TABLE ID as_option select_stmt  */
+#line 474 "yacc_sql.y"
     {
-      (yyval.sql_node)                 = (yyvsp[0].sql_node);
-      (yyval.sql_node)->flag           = SCF_CREATE_TABLE;
+      (yyval.sql_node) = (yyvsp[0].sql_node);
+      (yyval.sql_node)->flag = SCF_CREATE_TABLE;
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
-      create_table.relation_name       = (yyvsp[-2].string);
+      create_table.relation_name = (yyvsp[-2].string);
       free((yyvsp[-2].string));
     }
-#line 4044 "yacc_sql.cpp"
+#line 2126 "yacc_sql.cpp"
     break;
 
-    case 43:
-#line 451 "yacc_sql.y"
+  case 45: /* attr_def_list: %empty  */
+#line 484 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 4052 "yacc_sql.cpp"
+#line 2134 "yacc_sql.cpp"
     break;
 
-    case 44:
-#line 455 "yacc_sql.y"
+  case 46: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 488 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -4062,127 +2144,164 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 4066 "yacc_sql.cpp"
+#line 2148 "yacc_sql.cpp"
     break;
 
-    case 45:
-#line 468 "yacc_sql.y"
+  case 47: /* attr_def: ID type LBRACE number RBRACE null_option primary_key_option  */
+#line 501 "yacc_sql.y"
     {
-      (yyval.attr_info)           = new AttrInfoSqlNode;
-      (yyval.attr_info)->type     = (AttrType)(yyvsp[-4].number);
-      (yyval.attr_info)->name     = (yyvsp[-5].string);
-      (yyval.attr_info)->length   = (yyvsp[-2].number);
-      (yyval.attr_info)->nullable = (yyvsp[0].boolean);
-      free((yyvsp[-5].string));
+      (yyval.attr_info) = new AttrInfoSqlNode;
+      (yyval.attr_info)->type = (AttrType)(yyvsp[-5].number);
+      (yyval.attr_info)->name = (yyvsp[-6].string);
+      (yyval.attr_info)->length = (yyvsp[-3].number);
+      (yyval.attr_info)->nullable = (yyvsp[-1].boolean) && !(yyvsp[0].boolean);
+      (yyval.attr_info)->primary_key = (yyvsp[0].boolean);
+      free((yyvsp[-6].string));
     }
-#line 4079 "yacc_sql.cpp"
+#line 2162 "yacc_sql.cpp"
     break;
 
-    case 46:
-#line 477 "yacc_sql.y"
+  case 48: /* attr_def: ID type null_option primary_key_option  */
+#line 511 "yacc_sql.y"
     {
-      (yyval.attr_info)           = new AttrInfoSqlNode;
-      (yyval.attr_info)->type     = (AttrType)(yyvsp[-1].number);
-      (yyval.attr_info)->name     = (yyvsp[-2].string);
-      (yyval.attr_info)->length   = 4;
-      (yyval.attr_info)->nullable = (yyvsp[0].boolean);
-      free((yyvsp[-2].string));
+      (yyval.attr_info) = new AttrInfoSqlNode;
+      (yyval.attr_info)->type = (AttrType)(yyvsp[-2].number);
+      (yyval.attr_info)->name = (yyvsp[-3].string);
+      (yyval.attr_info)->length = 4;
+      (yyval.attr_info)->nullable = (yyvsp[-1].boolean) && !(yyvsp[0].boolean);
+      (yyval.attr_info)->primary_key = (yyvsp[0].boolean);
+      free((yyvsp[-3].string));
     }
-#line 4092 "yacc_sql.cpp"
+#line 2176 "yacc_sql.cpp"
     break;
 
-    case 47:
-#line 488 "yacc_sql.y"
+  case 49: /* primary_key_option: %empty  */
+#line 524 "yacc_sql.y"
     {
-      (yyval.boolean) = true;
+      (yyval.boolean) = false;
     }
-#line 4100 "yacc_sql.cpp"
+#line 2184 "yacc_sql.cpp"
     break;
 
-    case 48:
-#line 492 "yacc_sql.y"
+  case 50: /* primary_key_option: ID ID  */
+#line 528 "yacc_sql.y"
     {
+      bool valid = (0 == strcasecmp((yyvsp[-1].string), "primary") && 0 == strcasecmp((yyvsp[0].string), "key"));
+      free((yyvsp[-1].string));
+      free((yyvsp[0].string));
+      if (!valid) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "expect primary key");
+        YYERROR;
+      }
       (yyval.boolean) = true;
     }
-#line 4108 "yacc_sql.cpp"
+#line 2199 "yacc_sql.cpp"
     break;
 
-    case 49:
-#line 496 "yacc_sql.y"
+  case 51: /* storage_format_option: %empty  */
+#line 541 "yacc_sql.y"
     {
-      (yyval.boolean) = false;
+      (yyval.string) = nullptr;
     }
-#line 4116 "yacc_sql.cpp"
+#line 2207 "yacc_sql.cpp"
     break;
 
-    case 50:
-#line 502 "yacc_sql.y"
+  case 52: /* storage_format_option: ID ID EQ ID  */
+#line 545 "yacc_sql.y"
     {
-      (yyval.boolean) = false;
+      bool valid = (0 == strcasecmp((yyvsp[-3].string), "storage") && 0 == strcasecmp((yyvsp[-2].string), "format"));
+      free((yyvsp[-3].string));
+      free((yyvsp[-2].string));
+      if (!valid) {
+        free((yyvsp[0].string));
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "expect storage format");
+        YYERROR;
+      }
+      (yyval.string) = (yyvsp[0].string);
     }
-#line 4124 "yacc_sql.cpp"
+#line 2223 "yacc_sql.cpp"
     break;
 
-    case 51:
-#line 506 "yacc_sql.y"
+  case 53: /* null_option: %empty  */
+#line 559 "yacc_sql.y"
     {
-      (yyval.boolean) = false;
+      (yyval.boolean) = true;
     }
-#line 4132 "yacc_sql.cpp"
+#line 2231 "yacc_sql.cpp"
     break;
 
-    case 52:
-#line 512 "yacc_sql.y"
+  case 54: /* null_option: NULL_T  */
+#line 563 "yacc_sql.y"
     {
-      (yyval.number) = (yyvsp[0].number);
+      (yyval.boolean) = true;
     }
-#line 4140 "yacc_sql.cpp"
+#line 2239 "yacc_sql.cpp"
     break;
 
-    case 53:
-#line 515 "yacc_sql.y"
+  case 55: /* null_option: NOT NULL_T  */
+#line 567 "yacc_sql.y"
     {
-      (yyval.number) = INTS;
+      (yyval.boolean) = false;
     }
-#line 4148 "yacc_sql.cpp"
+#line 2247 "yacc_sql.cpp"
     break;
 
-    case 54:
-#line 516 "yacc_sql.y"
+  case 56: /* as_option: %empty  */
+#line 573 "yacc_sql.y"
     {
-      (yyval.number) = CHARS;
+      (yyval.boolean) = false;
     }
-#line 4156 "yacc_sql.cpp"
+#line 2255 "yacc_sql.cpp"
     break;
 
-    case 55:
-#line 517 "yacc_sql.y"
+  case 57: /* as_option: AS  */
+#line 577 "yacc_sql.y"
     {
-      (yyval.number) = FLOATS;
+      (yyval.boolean) = false;
     }
-#line 4164 "yacc_sql.cpp"
+#line 2263 "yacc_sql.cpp"
     break;
 
-    case 56:
-#line 518 "yacc_sql.y"
-    {
-      (yyval.number) = DATES;
-    }
-#line 4172 "yacc_sql.cpp"
+  case 58: /* number: NUMBER  */
+#line 583 "yacc_sql.y"
+           {(yyval.number) = (yyvsp[0].number);}
+#line 2269 "yacc_sql.cpp"
     break;
 
-    case 57:
-#line 519 "yacc_sql.y"
-    {
-      (yyval.number) = TEXTS;
-    }
-#line 4180 "yacc_sql.cpp"
+  case 59: /* type: INT_T  */
+#line 586 "yacc_sql.y"
+               { (yyval.number)=INTS; }
+#line 2275 "yacc_sql.cpp"
+    break;
+
+  case 60: /* type: STRING_T  */
+#line 587 "yacc_sql.y"
+               { (yyval.number)=CHARS; }
+#line 2281 "yacc_sql.cpp"
+    break;
+
+  case 61: /* type: FLOAT_T  */
+#line 588 "yacc_sql.y"
+               { (yyval.number)=FLOATS; }
+#line 2287 "yacc_sql.cpp"
+    break;
+
+  case 62: /* type: DATE_T  */
+#line 589 "yacc_sql.y"
+               { (yyval.number)=DATES;}
+#line 2293 "yacc_sql.cpp"
+    break;
+
+  case 63: /* type: TEXT_T  */
+#line 590 "yacc_sql.y"
+               { (yyval.number)=TEXTS; }
+#line 2299 "yacc_sql.cpp"
     break;
 
-    case 58:
-#line 523 "yacc_sql.y"
+  case 64: /* insert_stmt: INSERT INTO ID insert_col_list VALUES insert_value insert_value_list  */
+#line 594 "yacc_sql.y"
     {
-      (yyval.sql_node)                          = new ParsedSqlNode(SCF_INSERT);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       (yyval.sql_node)->insertion.relation_name = (yyvsp[-4].string);
       if ((yyvsp[0].insert_value_list) != nullptr) {
         (yyval.sql_node)->insertion.values.swap(*(yyvsp[0].insert_value_list));
@@ -4198,19 +2317,19 @@ yyreduce:
       delete (yyvsp[-1].value_list);
       free((yyvsp[-4].string));
     }
-#line 4202 "yacc_sql.cpp"
+#line 2321 "yacc_sql.cpp"
     break;
 
-    case 59:
-#line 543 "yacc_sql.y"
+  case 65: /* insert_col_list: %empty  */
+#line 614 "yacc_sql.y"
     {
       (yyval.relation_list) = nullptr;
     }
-#line 4210 "yacc_sql.cpp"
+#line 2329 "yacc_sql.cpp"
     break;
 
-    case 60:
-#line 547 "yacc_sql.y"
+  case 66: /* insert_col_list: LBRACE ID idx_col_list RBRACE  */
+#line 618 "yacc_sql.y"
     {
       if ((yyvsp[-1].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[-1].relation_list);
@@ -4218,21 +2337,21 @@ yyreduce:
         (yyval.relation_list) = new std::vector<std::string>;
       }
       (yyval.relation_list)->emplace_back((yyvsp[-2].string));
-      free((yyvsp[-2].string));
+      free((yyvsp[-2].string));      
     }
-#line 4224 "yacc_sql.cpp"
+#line 2343 "yacc_sql.cpp"
     break;
 
-    case 61:
-#line 560 "yacc_sql.y"
+  case 67: /* insert_value_list: %empty  */
+#line 631 "yacc_sql.y"
     {
       (yyval.insert_value_list) = nullptr;
     }
-#line 4232 "yacc_sql.cpp"
+#line 2351 "yacc_sql.cpp"
     break;
 
-    case 62:
-#line 564 "yacc_sql.y"
+  case 68: /* insert_value_list: COMMA insert_value insert_value_list  */
+#line 635 "yacc_sql.y"
     {
       if ((yyvsp[0].insert_value_list) != nullptr) {
         (yyval.insert_value_list) = (yyvsp[0].insert_value_list);
@@ -4242,14 +2361,14 @@ yyreduce:
       (yyval.insert_value_list)->emplace_back(*(yyvsp[-1].value_list));
       delete (yyvsp[-1].value_list);
     }
-#line 4246 "yacc_sql.cpp"
+#line 2365 "yacc_sql.cpp"
     break;
 
-    case 63:
-#line 577 "yacc_sql.y"
+  case 69: /* insert_value: LBRACE expression value_list RBRACE  */
+#line 648 "yacc_sql.y"
     {
       Value tmp;
-      if (!exp2value((yyvsp[-2].expression), tmp)) {
+      if(!exp2value((yyvsp[-2].expression), tmp)) {
         yyerror(&(yyloc), sql_string, sql_result, scanner, "error");
         YYERROR;
       }
@@ -4262,22 +2381,22 @@ yyreduce:
       std::reverse((yyval.value_list)->begin(), (yyval.value_list)->end());
       delete (yyvsp[-2].expression);
     }
-#line 4266 "yacc_sql.cpp"
+#line 2385 "yacc_sql.cpp"
     break;
 
-    case 64:
-#line 596 "yacc_sql.y"
+  case 70: /* value_list: %empty  */
+#line 667 "yacc_sql.y"
     {
       (yyval.value_list) = nullptr;
     }
-#line 4274 "yacc_sql.cpp"
+#line 2393 "yacc_sql.cpp"
     break;
 
-    case 65:
-#line 599 "yacc_sql.y"
-    {
+  case 71: /* value_list: COMMA expression value_list  */
+#line 670 "yacc_sql.y"
+                                   { 
       Value tmp;
-      if (!exp2value((yyvsp[-1].expression), tmp)) {
+      if(!exp2value((yyvsp[-1].expression),tmp)) {
         yyerror(&(yyloc), sql_string, sql_result, scanner, "error");
         YYERROR;
       }
@@ -4289,83 +2408,85 @@ yyreduce:
       (yyval.value_list)->emplace_back(tmp);
       delete (yyvsp[-1].expression);
     }
-#line 4293 "yacc_sql.cpp"
+#line 2412 "yacc_sql.cpp"
     break;
 
-    case 66:
-#line 615 "yacc_sql.y"
-    {
+  case 72: /* value: NUMBER  */
+#line 686 "yacc_sql.y"
+           {
       (yyval.value) = new Value((int)(yyvsp[0].number));
-      (yyloc)       = (yylsp[0]);  // useless
+      (yyloc) = (yylsp[0]); // useless
     }
-#line 4302 "yacc_sql.cpp"
+#line 2421 "yacc_sql.cpp"
     break;
 
-    case 67:
-#line 619 "yacc_sql.y"
-    {
+  case 73: /* value: FLOAT  */
+#line 690 "yacc_sql.y"
+           {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
-      (yyloc)       = (yylsp[0]);  // useless
+      (yyloc) = (yylsp[0]); // useless
     }
-#line 4311 "yacc_sql.cpp"
+#line 2430 "yacc_sql.cpp"
     break;
 
-    case 68:
-#line 623 "yacc_sql.y"
-    {
-      char       *tmp = common::substr((yyvsp[0].string), 1, strlen((yyvsp[0].string)) - 2);
+  case 74: /* value: DATE_STR  */
+#line 694 "yacc_sql.y"
+              {
+      char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       std::string str(tmp);
-      Value      *value = new Value();
-      int         date;
-      if (string_to_date(str, date) < 0) {
-        yyerror(&(yyloc), sql_string, sql_result, scanner, "date invaid", true);
+      Value * value = new Value();
+      int date;
+      if(string_to_date(str,date) < 0) {
+        yyerror(&(yyloc),sql_string,sql_result,scanner,"date invaid",true);
         YYERROR;
-      } else {
+      }
+      else
+      {
         value->set_date(date);
       }
       (yyval.value) = value;
       free(tmp);
     }
-#line 4330 "yacc_sql.cpp"
+#line 2451 "yacc_sql.cpp"
     break;
 
-    case 69:
-#line 639 "yacc_sql.y"
-    {
-      char *tmp     = common::substr((yyvsp[0].string), 1, strlen((yyvsp[0].string)) - 2);
+  case 75: /* value: SSS  */
+#line 710 "yacc_sql.y"
+         {
+      char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
     }
-#line 4340 "yacc_sql.cpp"
+#line 2461 "yacc_sql.cpp"
     break;
 
-    case 70:
-#line 644 "yacc_sql.y"
-    {
+  case 76: /* value: NULL_T  */
+#line 715 "yacc_sql.y"
+             {
       (yyval.value) = new Value();
       (yyval.value)->set_null();
     }
-#line 4349 "yacc_sql.cpp"
+#line 2470 "yacc_sql.cpp"
     break;
 
-    case 71:
-#line 652 "yacc_sql.y"
+  case 77: /* delete_stmt: DELETE FROM ID where  */
+#line 723 "yacc_sql.y"
     {
-      (yyval.sql_node)                         = new ParsedSqlNode(SCF_DELETE);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
-      (yyval.sql_node)->deletion.conditions    = nullptr;
+      (yyval.sql_node)->deletion.conditions = nullptr;
       if ((yyvsp[0].expression) != nullptr) {
         (yyval.sql_node)->deletion.conditions = (yyvsp[0].expression);
       }
       free((yyvsp[-1].string));
     }
-#line 4363 "yacc_sql.cpp"
+#line 2484 "yacc_sql.cpp"
     break;
 
-    case 72:
-#line 664 "yacc_sql.y"
+  case 78: /* update_stmt: UPDATE ID SET update_kv update_kv_list where  */
+#line 735 "yacc_sql.y"
     {
-      (yyval.sql_node)                       = new ParsedSqlNode(SCF_UPDATE);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-4].string);
       (yyval.sql_node)->update.attribute_names.emplace_back((yyvsp[-2].update_kv)->attr_name);
       (yyval.sql_node)->update.values.emplace_back((yyvsp[-2].update_kv)->value);
@@ -4383,19 +2504,19 @@ yyreduce:
       free((yyvsp[-4].string));
       delete (yyvsp[-2].update_kv);
     }
-#line 4387 "yacc_sql.cpp"
+#line 2508 "yacc_sql.cpp"
     break;
 
-    case 73:
-#line 686 "yacc_sql.y"
+  case 79: /* update_kv_list: %empty  */
+#line 757 "yacc_sql.y"
     {
       (yyval.update_kv_list) = nullptr;
     }
-#line 4395 "yacc_sql.cpp"
+#line 2516 "yacc_sql.cpp"
     break;
 
-    case 74:
-#line 690 "yacc_sql.y"
+  case 80: /* update_kv_list: COMMA update_kv update_kv_list  */
+#line 761 "yacc_sql.y"
     {
       if ((yyvsp[0].update_kv_list) != nullptr) {
         (yyval.update_kv_list) = (yyvsp[0].update_kv_list);
@@ -4405,31 +2526,31 @@ yyreduce:
       (yyval.update_kv_list)->emplace_back(*(yyvsp[-1].update_kv));
       delete (yyvsp[-1].update_kv);
     }
-#line 4409 "yacc_sql.cpp"
+#line 2530 "yacc_sql.cpp"
     break;
 
-    case 75:
-#line 703 "yacc_sql.y"
+  case 81: /* update_kv: ID EQ expression  */
+#line 774 "yacc_sql.y"
     {
-      (yyval.update_kv)            = new UpdateKV;
+      (yyval.update_kv) = new UpdateKV;
       (yyval.update_kv)->attr_name = (yyvsp[-2].string);
-      (yyval.update_kv)->value     = (yyvsp[0].expression);
+      (yyval.update_kv)->value = (yyvsp[0].expression);
       free((yyvsp[-2].string));
     }
-#line 4420 "yacc_sql.cpp"
+#line 2541 "yacc_sql.cpp"
     break;
 
-    case 76:
-#line 712 "yacc_sql.y"
-    {
+  case 82: /* from_list: %empty  */
+#line 783 "yacc_sql.y"
+                {
       (yyval.inner_joins_list) = nullptr;
     }
-#line 4428 "yacc_sql.cpp"
+#line 2549 "yacc_sql.cpp"
     break;
 
-    case 77:
-#line 715 "yacc_sql.y"
-    {
+  case 83: /* from_list: COMMA from_node from_list  */
+#line 786 "yacc_sql.y"
+                                {
       if (nullptr != (yyvsp[0].inner_joins_list)) {
         (yyval.inner_joins_list) = (yyvsp[0].inner_joins_list);
       } else {
@@ -4438,62 +2559,62 @@ yyreduce:
       (yyval.inner_joins_list)->emplace_back(*(yyvsp[-1].inner_joins));
       delete (yyvsp[-1].inner_joins);
     }
-#line 4442 "yacc_sql.cpp"
+#line 2563 "yacc_sql.cpp"
     break;
 
-    case 78:
-#line 727 "yacc_sql.y"
-    {
+  case 84: /* alias: %empty  */
+#line 798 "yacc_sql.y"
+                {
       (yyval.string) = nullptr;
     }
-#line 4450 "yacc_sql.cpp"
+#line 2571 "yacc_sql.cpp"
     break;
 
-    case 79:
-#line 730 "yacc_sql.y"
-    {
+  case 85: /* alias: ID  */
+#line 801 "yacc_sql.y"
+         {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 4458 "yacc_sql.cpp"
+#line 2579 "yacc_sql.cpp"
     break;
 
-    case 80:
-#line 733 "yacc_sql.y"
-    {
+  case 86: /* alias: AS ID  */
+#line 804 "yacc_sql.y"
+            {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 4466 "yacc_sql.cpp"
+#line 2587 "yacc_sql.cpp"
     break;
 
-    case 81:
-#line 738 "yacc_sql.y"
-    {
+  case 87: /* from_node: ID alias join_list  */
+#line 809 "yacc_sql.y"
+                       {
       if (nullptr != (yyvsp[0].inner_joins)) {
         (yyval.inner_joins) = (yyvsp[0].inner_joins);
       } else {
         (yyval.inner_joins) = new InnerJoinSqlNode;
       }
-      (yyval.inner_joins)->base_relation.first  = (yyvsp[-2].string);
+      (yyval.inner_joins)->base_relation.first = (yyvsp[-2].string);
       (yyval.inner_joins)->base_relation.second = nullptr == (yyvsp[-1].string) ? "" : std::string((yyvsp[-1].string));
       std::reverse((yyval.inner_joins)->join_relations.begin(), (yyval.inner_joins)->join_relations.end());
       std::reverse((yyval.inner_joins)->conditions.begin(), (yyval.inner_joins)->conditions.end());
       free((yyvsp[-2].string));
       free((yyvsp[-1].string));
     }
-#line 4484 "yacc_sql.cpp"
+#line 2605 "yacc_sql.cpp"
     break;
 
-    case 82:
-#line 754 "yacc_sql.y"
-    {
+  case 88: /* join_list: %empty  */
+#line 825 "yacc_sql.y"
+                {
       (yyval.inner_joins) = nullptr;
     }
-#line 4492 "yacc_sql.cpp"
+#line 2613 "yacc_sql.cpp"
     break;
 
-    case 83:
-#line 757 "yacc_sql.y"
-    {
+  case 89: /* join_list: INNER JOIN ID alias ON condition join_list  */
+#line 828 "yacc_sql.y"
+                                                 {
       if (nullptr != (yyvsp[0].inner_joins)) {
         (yyval.inner_joins) = (yyvsp[0].inner_joins);
       } else {
@@ -4508,21 +2629,20 @@ yyreduce:
       free((yyvsp[-4].string));
       free((yyvsp[-3].string));
     }
-#line 4512 "yacc_sql.cpp"
+#line 2633 "yacc_sql.cpp"
     break;
 
-    case 84:
-#line 776 "yacc_sql.y"
+  case 90: /* sub_query_expr: LBRACE select_stmt RBRACE  */
+#line 847 "yacc_sql.y"
     {
-      (yyval.expression) =
-          new SubQueryExpr((yyvsp[-1].sql_node)->selection);  // 子查询中所有的 Expression 都交给 SubQueryExpr 来管理了
+      (yyval.expression) = new SubQueryExpr((yyvsp[-1].sql_node)->selection); // 子查询中所有的 Expression 都交给 SubQueryExpr 来管理了
       delete (yyvsp[-1].sql_node);
     }
-#line 4522 "yacc_sql.cpp"
+#line 2642 "yacc_sql.cpp"
     break;
 
-    case 85:
-#line 784 "yacc_sql.y"
+  case 91: /* select_stmt: SELECT expression_list  */
+#line 855 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       if ((yyvsp[0].expression_list) != nullptr) {
@@ -4531,11 +2651,11 @@ yyreduce:
         delete (yyvsp[0].expression_list);
       }
     }
-#line 4535 "yacc_sql.cpp"
+#line 2655 "yacc_sql.cpp"
     break;
 
-    case 86:
-#line 793 "yacc_sql.y"
+  case 92: /* select_stmt: SELECT expression_list FROM from_node from_list where opt_group_by opt_having opt_order_by  */
+#line 864 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       if ((yyvsp[-7].expression_list) != nullptr) {
@@ -4570,35 +2690,35 @@ yyreduce:
       }
       delete (yyvsp[-5].inner_joins);
     }
-#line 4575 "yacc_sql.cpp"
+#line 2694 "yacc_sql.cpp"
     break;
 
-    case 87:
-#line 830 "yacc_sql.y"
+  case 93: /* calc_stmt: CALC expression_list  */
+#line 901 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
       std::reverse((yyvsp[0].expression_list)->begin(), (yyvsp[0].expression_list)->end());
       (yyval.sql_node)->calc.expressions.swap(*(yyvsp[0].expression_list));
       delete (yyvsp[0].expression_list);
     }
-#line 4586 "yacc_sql.cpp"
+#line 2705 "yacc_sql.cpp"
     break;
 
-    case 88:
-#line 840 "yacc_sql.y"
+  case 94: /* expression_list: expression alias  */
+#line 911 "yacc_sql.y"
     {
-      (yyval.expression_list) = new std::vector<Expression *>;
+      (yyval.expression_list) = new std::vector<Expression*>;
       if (nullptr != (yyvsp[0].string)) {
         (yyvsp[-1].expression)->set_alias((yyvsp[0].string));
       }
       (yyval.expression_list)->emplace_back((yyvsp[-1].expression));
       free((yyvsp[0].string));
     }
-#line 4599 "yacc_sql.cpp"
+#line 2718 "yacc_sql.cpp"
     break;
 
-    case 89:
-#line 849 "yacc_sql.y"
+  case 95: /* expression_list: expression alias COMMA expression_list  */
+#line 920 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -4611,48 +2731,44 @@ yyreduce:
       (yyval.expression_list)->emplace_back((yyvsp[-3].expression));
       free((yyvsp[-2].string));
     }
-#line 4616 "yacc_sql.cpp"
+#line 2735 "yacc_sql.cpp"
     break;
 
-    case 90:
-#line 863 "yacc_sql.y"
-    {
-      (yyval.expression) = create_arithmetic_expression(
-          ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
+  case 96: /* expression: expression '+' expression  */
+#line 934 "yacc_sql.y"
+                              {
+      (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 4625 "yacc_sql.cpp"
+#line 2743 "yacc_sql.cpp"
     break;
 
-    case 91:
-#line 866 "yacc_sql.y"
-    {
-      (yyval.expression) = create_arithmetic_expression(
-          ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
+  case 97: /* expression: expression '-' expression  */
+#line 937 "yacc_sql.y"
+                                {
+      (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 4634 "yacc_sql.cpp"
+#line 2751 "yacc_sql.cpp"
     break;
 
-    case 92:
-#line 869 "yacc_sql.y"
-    {
-      (yyval.expression) = create_arithmetic_expression(
-          ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
+  case 98: /* expression: expression '*' expression  */
+#line 940 "yacc_sql.y"
+                                {
+      (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 4643 "yacc_sql.cpp"
+#line 2759 "yacc_sql.cpp"
     break;
 
-    case 93:
-#line 872 "yacc_sql.y"
-    {
-      (yyval.expression) = create_arithmetic_expression(
-          ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
+  case 99: /* expression: expression '/' expression  */
+#line 943 "yacc_sql.y"
+                                {
+      (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 4652 "yacc_sql.cpp"
+#line 2767 "yacc_sql.cpp"
     break;
 
-    case 94:
-#line 875 "yacc_sql.y"
-    {
+  case 100: /* expression: LBRACE expression_list RBRACE  */
+#line 946 "yacc_sql.y"
+                                    {
       if ((yyvsp[-1].expression_list)->size() == 1) {
         (yyval.expression) = (yyvsp[-1].expression_list)->front();
       } else {
@@ -4661,70 +2777,69 @@ yyreduce:
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[-1].expression_list);
     }
-#line 4666 "yacc_sql.cpp"
+#line 2781 "yacc_sql.cpp"
     break;
 
-    case 95:
-#line 884 "yacc_sql.y"
-    {
-      (yyval.expression) = create_arithmetic_expression(
-          ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
+  case 101: /* expression: '-' expression  */
+#line 955 "yacc_sql.y"
+                                  {
+      (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 4675 "yacc_sql.cpp"
+#line 2789 "yacc_sql.cpp"
     break;
 
-    case 96:
-#line 887 "yacc_sql.y"
-    {
+  case 102: /* expression: value  */
+#line 958 "yacc_sql.y"
+            {
       (yyval.expression) = new ValueExpr(*(yyvsp[0].value));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].value);
     }
-#line 4685 "yacc_sql.cpp"
+#line 2799 "yacc_sql.cpp"
     break;
 
-    case 97:
-#line 892 "yacc_sql.y"
-    {
+  case 103: /* expression: rel_attr  */
+#line 963 "yacc_sql.y"
+               {
       (yyval.expression) = new FieldExpr((yyvsp[0].rel_attr)->relation_name, (yyvsp[0].rel_attr)->attribute_name);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].rel_attr);
     }
-#line 4695 "yacc_sql.cpp"
+#line 2809 "yacc_sql.cpp"
     break;
 
-    case 98:
-#line 897 "yacc_sql.y"
-    {
-      (yyval.expression) = (yyvsp[0].expression);  // AggrFuncExpr
+  case 104: /* expression: aggr_func_expr  */
+#line 968 "yacc_sql.y"
+                     {
+      (yyval.expression) = (yyvsp[0].expression); // AggrFuncExpr
     }
-#line 4703 "yacc_sql.cpp"
+#line 2817 "yacc_sql.cpp"
     break;
 
-    case 99:
-#line 900 "yacc_sql.y"
-    {
-      (yyval.expression) = (yyvsp[0].expression);  // SysFuncExpr
+  case 105: /* expression: func_expr  */
+#line 971 "yacc_sql.y"
+                {
+      (yyval.expression) = (yyvsp[0].expression); // SysFuncExpr
     }
-#line 4711 "yacc_sql.cpp"
+#line 2825 "yacc_sql.cpp"
     break;
 
-    case 100:
-#line 903 "yacc_sql.y"
-    {
-      (yyval.expression) = (yyvsp[0].expression);  // SubQueryExpr
+  case 106: /* expression: sub_query_expr  */
+#line 974 "yacc_sql.y"
+                     {
+      (yyval.expression) = (yyvsp[0].expression); // SubQueryExpr
     }
-#line 4719 "yacc_sql.cpp"
+#line 2833 "yacc_sql.cpp"
     break;
 
-    case 101:
-#line 910 "yacc_sql.y"
+  case 107: /* aggr_func_expr: ID LBRACE expression RBRACE  */
+#line 981 "yacc_sql.y"
     {
-      Expression *rhs = (yyvsp[-1].expression);
+      Expression* rhs = (yyvsp[-1].expression);
       if ((yyvsp[-1].expression)->type() == ExprType::FIELD) {
-        FieldExpr *field_expr = static_cast<FieldExpr *>((yyvsp[-1].expression));
+        FieldExpr* field_expr = static_cast<FieldExpr*>((yyvsp[-1].expression));
         if (field_expr->get_field_name() == "*") {
-          if (get_aggr_func_type((yyvsp[-3].string)) != AggrFuncType::COUNT) {
+          if(get_aggr_func_type((yyvsp[-3].string)) != AggrFuncType::COUNT) {
             delete (yyvsp[-1].expression);
             yyerror(&(yyloc), sql_string, sql_result, scanner, "only support count(*)");
             YYERROR;
@@ -4736,413 +2851,387 @@ yyreduce:
       (yyval.expression) = new AggrFuncExpr(get_aggr_func_type((yyvsp[-3].string)), rhs);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 4741 "yacc_sql.cpp"
+#line 2855 "yacc_sql.cpp"
     break;
 
-    case 102:
-#line 929 "yacc_sql.y"
-    {
+  case 108: /* sys_func_type: LENGTH  */
+#line 1000 "yacc_sql.y"
+           {
       (yyval.number) = SysFuncType::SYS_FUNC_LENGTH;
     }
-#line 4749 "yacc_sql.cpp"
+#line 2863 "yacc_sql.cpp"
     break;
 
-    case 103:
-#line 932 "yacc_sql.y"
-    {
+  case 109: /* sys_func_type: ROUND  */
+#line 1003 "yacc_sql.y"
+            {
       (yyval.number) = SysFuncType::SYS_FUNC_ROUND;
     }
-#line 4757 "yacc_sql.cpp"
+#line 2871 "yacc_sql.cpp"
     break;
 
-    case 104:
-#line 935 "yacc_sql.y"
-    {
+  case 110: /* sys_func_type: DATE_FORMAT  */
+#line 1006 "yacc_sql.y"
+                  {
       (yyval.number) = SysFuncType::SYS_FUNC_DATE_FORMAT;
     }
-#line 4765 "yacc_sql.cpp"
+#line 2879 "yacc_sql.cpp"
     break;
 
-    case 105:
-#line 942 "yacc_sql.y"
+  case 111: /* func_expr: sys_func_type LBRACE expression_list RBRACE  */
+#line 1013 "yacc_sql.y"
     {
-      std::reverse((yyvsp[-1].expression_list)->begin(), (yyvsp[-1].expression_list)->end());
-      (yyval.expression) = new SysFuncExpr((SysFuncType)(yyvsp[-3].number), *(yyvsp[-1].expression_list));
+      std::reverse((yyvsp[-1].expression_list)->begin(),(yyvsp[-1].expression_list)->end());
+      (yyval.expression) = new SysFuncExpr((SysFuncType)(yyvsp[-3].number),*(yyvsp[-1].expression_list));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[-1].expression_list);
     }
-#line 4776 "yacc_sql.cpp"
+#line 2890 "yacc_sql.cpp"
     break;
 
-    case 106:
-#line 951 "yacc_sql.y"
-    {
-      (yyval.rel_attr)                 = new RelAttrSqlNode;
+  case 112: /* rel_attr: ID  */
+#line 1022 "yacc_sql.y"
+       {
+      (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 4786 "yacc_sql.cpp"
+#line 2900 "yacc_sql.cpp"
     break;
 
-    case 107:
-#line 956 "yacc_sql.y"
-    {
-      (yyval.rel_attr)                 = new RelAttrSqlNode;
+  case 113: /* rel_attr: ID DOT ID  */
+#line 1027 "yacc_sql.y"
+                {
+      (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 4798 "yacc_sql.cpp"
+#line 2912 "yacc_sql.cpp"
     break;
 
-    case 108:
-#line 963 "yacc_sql.y"
-    {
-      (yyval.rel_attr)                 = new RelAttrSqlNode;
+  case 114: /* rel_attr: '*' DOT '*'  */
+#line 1034 "yacc_sql.y"
+                  {
+      (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = "*";
       (yyval.rel_attr)->attribute_name = "*";
     }
-#line 4808 "yacc_sql.cpp"
+#line 2922 "yacc_sql.cpp"
     break;
 
-    case 109:
-#line 968 "yacc_sql.y"
-    {
-      (yyval.rel_attr)                 = new RelAttrSqlNode;
+  case 115: /* rel_attr: ID DOT '*'  */
+#line 1039 "yacc_sql.y"
+                 {
+      (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
       (yyval.rel_attr)->attribute_name = "*";
       free((yyvsp[-2].string));
     }
-#line 4819 "yacc_sql.cpp"
+#line 2933 "yacc_sql.cpp"
     break;
 
-    case 110:
-#line 974 "yacc_sql.y"
-    {
-      (yyval.rel_attr)                 = new RelAttrSqlNode;
+  case 116: /* rel_attr: '*'  */
+#line 1045 "yacc_sql.y"
+          {
+      (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = "*";
       (yyval.rel_attr)->attribute_name = "*";
     }
-#line 4829 "yacc_sql.cpp"
+#line 2943 "yacc_sql.cpp"
     break;
 
-    case 111:
-#line 983 "yacc_sql.y"
+  case 117: /* where: %empty  */
+#line 1054 "yacc_sql.y"
     {
       (yyval.expression) = nullptr;
     }
-#line 4837 "yacc_sql.cpp"
+#line 2951 "yacc_sql.cpp"
     break;
 
-    case 112:
-#line 986 "yacc_sql.y"
-    {
-      (yyval.expression) = (yyvsp[0].expression);
+  case 118: /* where: WHERE condition  */
+#line 1057 "yacc_sql.y"
+                      {
+      (yyval.expression) = (yyvsp[0].expression);  
     }
-#line 4845 "yacc_sql.cpp"
+#line 2959 "yacc_sql.cpp"
     break;
 
-    case 113:
-#line 993 "yacc_sql.y"
+  case 119: /* is_null_comp: IS NULL_T  */
+#line 1064 "yacc_sql.y"
     {
       (yyval.boolean) = true;
     }
-#line 4853 "yacc_sql.cpp"
+#line 2967 "yacc_sql.cpp"
     break;
 
-    case 114:
-#line 997 "yacc_sql.y"
+  case 120: /* is_null_comp: IS NOT NULL_T  */
+#line 1068 "yacc_sql.y"
     {
       (yyval.boolean) = false;
     }
-#line 4861 "yacc_sql.cpp"
+#line 2975 "yacc_sql.cpp"
     break;
 
-    case 115:
-#line 1004 "yacc_sql.y"
+  case 121: /* condition: expression comp_op expression  */
+#line 1075 "yacc_sql.y"
     {
       (yyval.expression) = new ComparisonExpr((yyvsp[-1].comp), (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 4869 "yacc_sql.cpp"
+#line 2983 "yacc_sql.cpp"
     break;
 
-    case 116:
-#line 1008 "yacc_sql.y"
+  case 122: /* condition: expression is_null_comp  */
+#line 1079 "yacc_sql.y"
     {
       Value val;
       val.set_null();
       ValueExpr *value_expr = new ValueExpr(val);
-      (yyval.expression) =
-          new ComparisonExpr((yyvsp[0].boolean) ? IS_NULL : IS_NOT_NULL, (yyvsp[-1].expression), value_expr);
+      (yyval.expression) = new ComparisonExpr((yyvsp[0].boolean) ? IS_NULL : IS_NOT_NULL, (yyvsp[-1].expression), value_expr);
     }
-#line 4881 "yacc_sql.cpp"
+#line 2994 "yacc_sql.cpp"
     break;
 
-    case 117:
-#line 1015 "yacc_sql.y"
+  case 123: /* condition: exists_op expression  */
+#line 1086 "yacc_sql.y"
     {
       Value val;
       val.set_null();
       ValueExpr *value_expr = new ValueExpr(val);
-      (yyval.expression)    = new ComparisonExpr((yyvsp[-1].comp), value_expr, (yyvsp[0].expression));
-    }
-#line 4892 "yacc_sql.cpp"
-    break;
-
-    case 118:
-#line 1022 "yacc_sql.y"
-    {
-      (yyval.expression) =
-          new ConjunctionExpr(ConjunctionExpr::Type::AND, (yyvsp[-2].expression), (yyvsp[0].expression));
-    }
-#line 4901 "yacc_sql.cpp"
-    break;
-
-    case 119:
-#line 1026 "yacc_sql.y"
-    {
-      (yyval.expression) =
-          new ConjunctionExpr(ConjunctionExpr::Type::OR, (yyvsp[-2].expression), (yyvsp[0].expression));
-    }
-#line 4910 "yacc_sql.cpp"
-    break;
-
-    case 120:
-#line 1033 "yacc_sql.y"
-    {
-      (yyval.orderby_unit)         = new OrderBySqlNode();  // 默认是升序
-      (yyval.orderby_unit)->expr   = (yyvsp[0].expression);
-      (yyval.orderby_unit)->is_asc = true;
+      (yyval.expression) = new ComparisonExpr((yyvsp[-1].comp), value_expr, (yyvsp[0].expression));
     }
-#line 4920 "yacc_sql.cpp"
+#line 3005 "yacc_sql.cpp"
     break;
 
-    case 121:
-#line 1040 "yacc_sql.y"
+  case 124: /* condition: condition AND condition  */
+#line 1093 "yacc_sql.y"
     {
-      (yyval.orderby_unit)         = new OrderBySqlNode();
-      (yyval.orderby_unit)->expr   = (yyvsp[-1].expression);
-      (yyval.orderby_unit)->is_asc = false;
+      (yyval.expression) = new ConjunctionExpr(ConjunctionExpr::Type::AND, (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 4930 "yacc_sql.cpp"
+#line 3013 "yacc_sql.cpp"
     break;
 
-    case 122:
-#line 1047 "yacc_sql.y"
+  case 125: /* condition: condition OR condition  */
+#line 1097 "yacc_sql.y"
     {
-      (yyval.orderby_unit)         = new OrderBySqlNode();  // 默认是升序
-      (yyval.orderby_unit)->expr   = (yyvsp[-1].expression);
-      (yyval.orderby_unit)->is_asc = true;
+      (yyval.expression) = new ConjunctionExpr(ConjunctionExpr::Type::OR, (yyvsp[-2].expression), (yyvsp[0].expression));
     }
-#line 4940 "yacc_sql.cpp"
+#line 3021 "yacc_sql.cpp"
     break;
 
-    case 123:
-#line 1055 "yacc_sql.y"
-    {
-      (yyval.orderby_unit_list) = new std::vector<OrderBySqlNode>;
-      (yyval.orderby_unit_list)->emplace_back(*(yyvsp[0].orderby_unit));
-      delete (yyvsp[0].orderby_unit);
-    }
-#line 4950 "yacc_sql.cpp"
+  case 126: /* sort_unit: expression  */
+#line 1104 "yacc_sql.y"
+        {
+    (yyval.orderby_unit) = new OrderBySqlNode();//默认是升序
+    (yyval.orderby_unit)->expr = (yyvsp[0].expression);
+    (yyval.orderby_unit)->is_asc = true;
+	}
+#line 3031 "yacc_sql.cpp"
     break;
 
-    case 124:
-#line 1062 "yacc_sql.y"
-    {
-      (yyvsp[0].orderby_unit_list)->emplace_back(*(yyvsp[-2].orderby_unit));
-      (yyval.orderby_unit_list) = (yyvsp[0].orderby_unit_list);
-      delete (yyvsp[-2].orderby_unit);
-    }
-#line 4960 "yacc_sql.cpp"
+  case 127: /* sort_unit: expression DESC  */
+#line 1111 "yacc_sql.y"
+        {
+    (yyval.orderby_unit) = new OrderBySqlNode();
+    (yyval.orderby_unit)->expr = (yyvsp[-1].expression);
+    (yyval.orderby_unit)->is_asc = false;
+	}
+#line 3041 "yacc_sql.cpp"
     break;
 
-    case 125:
-#line 1069 "yacc_sql.y"
-    {
-      (yyval.orderby_unit_list) = nullptr;
-    }
-#line 4968 "yacc_sql.cpp"
+  case 128: /* sort_unit: expression ASC  */
+#line 1118 "yacc_sql.y"
+        {
+    (yyval.orderby_unit) = new OrderBySqlNode();//默认是升序
+    (yyval.orderby_unit)->expr = (yyvsp[-1].expression);
+    (yyval.orderby_unit)->is_asc = true;
+	}
+#line 3051 "yacc_sql.cpp"
+    break;
+
+  case 129: /* sort_list: sort_unit  */
+#line 1126 "yacc_sql.y"
+        {
+    (yyval.orderby_unit_list) = new std::vector<OrderBySqlNode>;
+    (yyval.orderby_unit_list)->emplace_back(*(yyvsp[0].orderby_unit));
+    delete (yyvsp[0].orderby_unit);
+	}
+#line 3061 "yacc_sql.cpp"
+    break;
+
+  case 130: /* sort_list: sort_unit COMMA sort_list  */
+#line 1133 "yacc_sql.y"
+        {
+    (yyvsp[0].orderby_unit_list)->emplace_back(*(yyvsp[-2].orderby_unit));
+    (yyval.orderby_unit_list) = (yyvsp[0].orderby_unit_list);
+    delete (yyvsp[-2].orderby_unit);
+	}
+#line 3071 "yacc_sql.cpp"
+    break;
+
+  case 131: /* opt_order_by: %empty  */
+#line 1140 "yacc_sql.y"
+                    {
+   (yyval.orderby_unit_list) = nullptr;
+  }
+#line 3079 "yacc_sql.cpp"
     break;
 
-    case 126:
-#line 1073 "yacc_sql.y"
-    {
+  case 132: /* opt_order_by: ORDER BY sort_list  */
+#line 1144 "yacc_sql.y"
+        {
       (yyval.orderby_unit_list) = (yyvsp[0].orderby_unit_list);
-      std::reverse((yyval.orderby_unit_list)->begin(), (yyval.orderby_unit_list)->end());
-    }
-#line 4977 "yacc_sql.cpp"
+      std::reverse((yyval.orderby_unit_list)->begin(),(yyval.orderby_unit_list)->end());
+	}
+#line 3088 "yacc_sql.cpp"
     break;
 
-    case 127:
-#line 1079 "yacc_sql.y"
-    {
-      (yyval.expression_list) = nullptr;
-    }
-#line 4985 "yacc_sql.cpp"
+  case 133: /* opt_group_by: %empty  */
+#line 1150 "yacc_sql.y"
+                    {
+   (yyval.expression_list) = nullptr;
+  }
+#line 3096 "yacc_sql.cpp"
     break;
 
-    case 128:
-#line 1083 "yacc_sql.y"
-    {
+  case 134: /* opt_group_by: GROUP BY expression_list  */
+#line 1154 "yacc_sql.y"
+        {
       (yyval.expression_list) = (yyvsp[0].expression_list);
-      std::reverse((yyval.expression_list)->begin(), (yyval.expression_list)->end());
-    }
-#line 4994 "yacc_sql.cpp"
+      std::reverse((yyval.expression_list)->begin(),(yyval.expression_list)->end());
+	}
+#line 3105 "yacc_sql.cpp"
     break;
 
-    case 129:
-#line 1089 "yacc_sql.y"
-    {
-      (yyval.expression) = nullptr;
-    }
-#line 5002 "yacc_sql.cpp"
+  case 135: /* opt_having: %empty  */
+#line 1160 "yacc_sql.y"
+              {
+   (yyval.expression) = nullptr;
+  }
+#line 3113 "yacc_sql.cpp"
     break;
 
-    case 130:
-#line 1093 "yacc_sql.y"
-    {
+  case 136: /* opt_having: HAVING condition  */
+#line 1164 "yacc_sql.y"
+        {
       (yyval.expression) = (yyvsp[0].expression);
-    }
-#line 5010 "yacc_sql.cpp"
+	}
+#line 3121 "yacc_sql.cpp"
     break;
 
-    case 131:
-#line 1099 "yacc_sql.y"
-    {
-      (yyval.comp) = EQUAL_TO;
-    }
-#line 5018 "yacc_sql.cpp"
+  case 137: /* comp_op: EQ  */
+#line 1170 "yacc_sql.y"
+         { (yyval.comp) = EQUAL_TO; }
+#line 3127 "yacc_sql.cpp"
     break;
 
-    case 132:
-#line 1100 "yacc_sql.y"
-    {
-      (yyval.comp) = LESS_THAN;
-    }
-#line 5026 "yacc_sql.cpp"
+  case 138: /* comp_op: LT  */
+#line 1171 "yacc_sql.y"
+         { (yyval.comp) = LESS_THAN; }
+#line 3133 "yacc_sql.cpp"
     break;
 
-    case 133:
-#line 1101 "yacc_sql.y"
-    {
-      (yyval.comp) = GREAT_THAN;
-    }
-#line 5034 "yacc_sql.cpp"
+  case 139: /* comp_op: GT  */
+#line 1172 "yacc_sql.y"
+         { (yyval.comp) = GREAT_THAN; }
+#line 3139 "yacc_sql.cpp"
     break;
 
-    case 134:
-#line 1102 "yacc_sql.y"
-    {
-      (yyval.comp) = LESS_EQUAL;
-    }
-#line 5042 "yacc_sql.cpp"
+  case 140: /* comp_op: LE  */
+#line 1173 "yacc_sql.y"
+         { (yyval.comp) = LESS_EQUAL; }
+#line 3145 "yacc_sql.cpp"
     break;
 
-    case 135:
-#line 1103 "yacc_sql.y"
-    {
-      (yyval.comp) = GREAT_EQUAL;
-    }
-#line 5050 "yacc_sql.cpp"
+  case 141: /* comp_op: GE  */
+#line 1174 "yacc_sql.y"
+         { (yyval.comp) = GREAT_EQUAL; }
+#line 3151 "yacc_sql.cpp"
     break;
 
-    case 136:
-#line 1104 "yacc_sql.y"
-    {
-      (yyval.comp) = NOT_EQUAL;
-    }
-#line 5058 "yacc_sql.cpp"
+  case 142: /* comp_op: NE  */
+#line 1175 "yacc_sql.y"
+         { (yyval.comp) = NOT_EQUAL; }
+#line 3157 "yacc_sql.cpp"
     break;
 
-    case 137:
-#line 1105 "yacc_sql.y"
-    {
-      (yyval.comp) = LIKE_OP;
-    }
-#line 5066 "yacc_sql.cpp"
+  case 143: /* comp_op: LIKE  */
+#line 1176 "yacc_sql.y"
+           { (yyval.comp) = LIKE_OP;}
+#line 3163 "yacc_sql.cpp"
     break;
 
-    case 138:
-#line 1106 "yacc_sql.y"
-    {
-      (yyval.comp) = NOT_LIKE_OP;
-    }
-#line 5074 "yacc_sql.cpp"
+  case 144: /* comp_op: NOT LIKE  */
+#line 1177 "yacc_sql.y"
+               {(yyval.comp) = NOT_LIKE_OP;}
+#line 3169 "yacc_sql.cpp"
     break;
 
-    case 139:
-#line 1107 "yacc_sql.y"
-    {
-      (yyval.comp) = IN_OP;
-    }
-#line 5082 "yacc_sql.cpp"
+  case 145: /* comp_op: IN  */
+#line 1178 "yacc_sql.y"
+         { (yyval.comp) = IN_OP; }
+#line 3175 "yacc_sql.cpp"
     break;
 
-    case 140:
-#line 1108 "yacc_sql.y"
-    {
-      (yyval.comp) = NOT_IN_OP;
-    }
-#line 5090 "yacc_sql.cpp"
+  case 146: /* comp_op: NOT IN  */
+#line 1179 "yacc_sql.y"
+             { (yyval.comp) = NOT_IN_OP; }
+#line 3181 "yacc_sql.cpp"
     break;
 
-    case 141:
-#line 1112 "yacc_sql.y"
-    {
-      (yyval.comp) = EXISTS_OP;
-    }
-#line 5098 "yacc_sql.cpp"
+  case 147: /* exists_op: EXISTS  */
+#line 1183 "yacc_sql.y"
+           { (yyval.comp) = EXISTS_OP; }
+#line 3187 "yacc_sql.cpp"
     break;
 
-    case 142:
-#line 1113 "yacc_sql.y"
-    {
-      (yyval.comp) = NOT_EXISTS_OP;
-    }
-#line 5106 "yacc_sql.cpp"
+  case 148: /* exists_op: NOT EXISTS  */
+#line 1184 "yacc_sql.y"
+                 { (yyval.comp) = NOT_EXISTS_OP; }
+#line 3193 "yacc_sql.cpp"
     break;
 
-    case 143:
-#line 1118 "yacc_sql.y"
+  case 149: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
+#line 1189 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
-
-      (yyval.sql_node)                          = new ParsedSqlNode(SCF_LOAD_DATA);
+      
+      (yyval.sql_node) = new ParsedSqlNode(SCF_LOAD_DATA);
       (yyval.sql_node)->load_data.relation_name = (yyvsp[0].string);
-      (yyval.sql_node)->load_data.file_name     = tmp_file_name;
+      (yyval.sql_node)->load_data.file_name = tmp_file_name;
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 5120 "yacc_sql.cpp"
+#line 3207 "yacc_sql.cpp"
     break;
 
-    case 144:
-#line 1131 "yacc_sql.y"
+  case 150: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 1202 "yacc_sql.y"
     {
-      (yyval.sql_node)                   = new ParsedSqlNode(SCF_EXPLAIN);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
       (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 5129 "yacc_sql.cpp"
+#line 3216 "yacc_sql.cpp"
     break;
 
-    case 145:
-#line 1139 "yacc_sql.y"
+  case 151: /* set_variable_stmt: SET ID EQ value  */
+#line 1210 "yacc_sql.y"
     {
-      (yyval.sql_node)                     = new ParsedSqlNode(SCF_SET_VARIABLE);
+      (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
       (yyval.sql_node)->set_variable.value = *(yyvsp[0].value);
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 5141 "yacc_sql.cpp"
+#line 3228 "yacc_sql.cpp"
     break;
 
-#line 5144 "yacc_sql.cpp"
 
-    default: break;
-  }
+#line 3232 "yacc_sql.cpp"
+
+      default: break;
+    }
   /* User semantic actions sometimes alter yychar, and that requires
      that yytoken be updated with the new translation.  We take the
      approach of translating immediately before every use of yytoken.
@@ -5154,11 +3243,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
-  YYPOPSTACK(yylen);
+  YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT(yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -5168,74 +3256,84 @@ yyreduce:
      number reduced by.  */
   {
     const int yylhs = yyr1[yyn] - YYNTOKENS;
-    const int yyi   = yypgoto[yylhs] + *yyssp;
-    yystate         = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp ? yytable[yyi] : yydefgoto[yylhs]);
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
   }
 
   goto yynewstate;
 
+
 /*--------------------------------------.
 | yyerrlab -- here on detecting error.  |
 `--------------------------------------*/
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE(yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
-  if (!yyerrstatus) {
-    ++yynerrs;
-#if !YYERROR_VERBOSE
-    yyerror(&yylloc, sql_string, sql_result, scanner, YY_("syntax error"));
-#else
-#define YYSYNTAX_ERROR yysyntax_error(&yymsg_alloc, &yymsg, yyssp, yytoken)
-    {
-      char const *yymsgp = YY_("syntax error");
-      int         yysyntax_error_status;
-      yysyntax_error_status = YYSYNTAX_ERROR;
-      if (yysyntax_error_status == 0)
-        yymsgp = yymsg;
-      else if (yysyntax_error_status == 1) {
-        if (yymsg != yymsgbuf)
-          YYSTACK_FREE(yymsg);
-        yymsg = YY_CAST(char *, YYSTACK_ALLOC(YY_CAST(YYSIZE_T, yymsg_alloc)));
-        if (!yymsg) {
-          yymsg                 = yymsgbuf;
-          yymsg_alloc           = sizeof yymsgbuf;
-          yysyntax_error_status = 2;
-        } else {
-          yysyntax_error_status = YYSYNTAX_ERROR;
-          yymsgp                = yymsg;
-        }
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (&yylloc, sql_string, sql_result, scanner, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-      yyerror(&yylloc, sql_string, sql_result, scanner, yymsgp);
-      if (yysyntax_error_status == 2)
-        goto yyexhaustedlab;
     }
-#undef YYSYNTAX_ERROR
-#endif
-  }
 
   yyerror_range[1] = yylloc;
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
 
-  if (yyerrstatus == 3) {
-    /* If just tried and failed to reuse lookahead token after an
-       error, discard it.  */
-
-    if (yychar <= YYEOF) {
-      /* Return failure if at end of input.  */
-      if (yychar == YYEOF)
-        YYABORT;
-    } else {
-      yydestruct("Error: discarding", yytoken, &yylval, &yylloc, sql_string, sql_result, scanner);
-      yychar = YYEMPTY;
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, &yylloc, sql_string, sql_result, scanner);
+          yychar = YYEMPTY;
+        }
     }
-  }
 
   /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
+
 /*---------------------------------------------------.
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
@@ -5244,122 +3342,131 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
-  YYPOPSTACK(yylen);
+  YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT(yyss, yyssp);
+  YY_STACK_PRINT (yyss, yyssp);
   yystate = *yyssp;
   goto yyerrlab1;
 
+
 /*-------------------------------------------------------------.
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3; /* Each real token shifted decrements this.  */
-
-  for (;;) {
-    yyn = yypact[yystate];
-    if (!yypact_value_is_default(yyn)) {
-      yyn += YYTERROR;
-      if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR) {
-        yyn = yytable[yyn];
-        if (0 < yyn)
-          break;
-      }
-    }
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
-    /* Pop the current state because it cannot handle the error token.  */
-    if (yyssp == yyss)
-      YYABORT;
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
 
-    yyerror_range[1] = *yylsp;
-    yydestruct("Error: popping", yystos[yystate], yyvsp, yylsp, sql_string, sql_result, scanner);
-    YYPOPSTACK(1);
-    yystate = *yyssp;
-    YY_STACK_PRINT(yyss, yyssp);
-  }
+      yyerror_range[1] = *yylsp;
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, sql_string, sql_result, scanner);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT(yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
 
+
 /*-------------------------------------.
 | yyacceptlab -- YYACCEPT comes here.  |
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror(&yylloc, sql_string, sql_result, scanner, YY_("memory exhausted"));
+  yyerror (&yylloc, sql_string, sql_result, scanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
-  if (yychar != YYEMPTY) {
-    /* Make sure we have latest lookahead translation.  See comments at
-       user semantic actions for why this is necessary.  */
-    yytoken = YYTRANSLATE(yychar);
-    yydestruct("Cleanup: discarding lookahead", yytoken, &yylval, &yylloc, sql_string, sql_result, scanner);
-  }
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, &yylloc, sql_string, sql_result, scanner);
+    }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
-  YYPOPSTACK(yylen);
-  YY_STACK_PRINT(yyss, yyssp);
-  while (yyssp != yyss) {
-    yydestruct("Cleanup: popping", yystos[+*yyssp], yyvsp, yylsp, sql_string, sql_result, scanner);
-    YYPOPSTACK(1);
-  }
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, sql_string, sql_result, scanner);
+      YYPOPSTACK (1);
+    }
 #ifndef yyoverflow
   if (yyss != yyssa)
-    YYSTACK_FREE(yyss);
+    YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
-    YYSTACK_FREE(yymsg);
-#endif
+    YYSTACK_FREE (yymsg);
   return yyresult;
 }
-#line 1151 "yacc_sql.y"
+
+#line 1222 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
 
-int sql_parse(const char *s, ParsedSqlResult *sql_result)
-{
+int sql_parse(const char *s, ParsedSqlResult *sql_result) {
   yyscan_t scanner;
   yylex_init(&scanner);
   scan_string(s, scanner);
   int result = yyparse(s, sql_result, scanner);
   yylex_destroy(scanner);
   return result;
-}
\ No newline at end of file
+}
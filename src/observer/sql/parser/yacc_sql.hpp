@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -31,141 +31,148 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
 
 #ifndef YY_YY_YACC_SQL_HPP_INCLUDED
-#define YY_YY_YACC_SQL_HPP_INCLUDED
+# define YY_YY_YACC_SQL_HPP_INCLUDED
 /* Debug traces.  */
 #ifndef YYDEBUG
-#define YYDEBUG 0
+# define YYDEBUG 0
 #endif
 #if YYDEBUG
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
-#define YYTOKENTYPE
-enum yytokentype
-{
-  SEMICOLON    = 258,
-  CREATE       = 259,
-  DROP         = 260,
-  TABLE        = 261,
-  TABLES       = 262,
-  INDEX        = 263,
-  CALC         = 264,
-  SELECT       = 265,
-  DESC         = 266,
-  SHOW         = 267,
-  SYNC         = 268,
-  INSERT       = 269,
-  DELETE       = 270,
-  UPDATE       = 271,
-  LBRACE       = 272,
-  RBRACE       = 273,
-  COMMA        = 274,
-  TRX_BEGIN    = 275,
-  TRX_COMMIT   = 276,
-  TRX_ROLLBACK = 277,
-  INT_T        = 278,
-  STRING_T     = 279,
-  FLOAT_T      = 280,
-  DATE_T       = 281,
-  TEXT_T       = 282,
-  HELP         = 283,
-  EXIT         = 284,
-  DOT          = 285,
-  INTO         = 286,
-  VALUES       = 287,
-  FROM         = 288,
-  WHERE        = 289,
-  AND          = 290,
-  OR           = 291,
-  SET          = 292,
-  ON           = 293,
-  LOAD         = 294,
-  DATA         = 295,
-  INFILE       = 296,
-  EXPLAIN      = 297,
-  IS           = 298,
-  NULL_T       = 299,
-  INNER        = 300,
-  JOIN         = 301,
-  AS           = 302,
-  IN           = 303,
-  EXISTS       = 304,
-  EQ           = 305,
-  LT           = 306,
-  GT           = 307,
-  LE           = 308,
-  GE           = 309,
-  NE           = 310,
-  NOT          = 311,
-  LIKE         = 312,
-  UNIQUE       = 313,
-  AGGR_MAX     = 314,
-  AGGR_MIN     = 315,
-  AGGR_SUM     = 316,
-  AGGR_AVG     = 317,
-  AGGR_COUNT   = 318,
-  LENGTH       = 319,
-  ROUND        = 320,
-  DATE_FORMAT  = 321,
-  ORDER        = 322,
-  GROUP        = 323,
-  BY           = 324,
-  ASC          = 325,
-  HAVING       = 326,
-  NUMBER       = 327,
-  FLOAT        = 328,
-  ID           = 329,
-  SSS          = 330,
-  DATE_STR     = 331,
-  UMINUS       = 332
-};
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    SEMICOLON = 258,               /* SEMICOLON  */
+    CREATE = 259,                  /* CREATE  */
+    DROP = 260,                    /* DROP  */
+    TABLE = 261,                   /* TABLE  */
+    TABLES = 262,                  /* TABLES  */
+    INDEX = 263,                   /* INDEX  */
+    CALC = 264,                    /* CALC  */
+    SELECT = 265,                  /* SELECT  */
+    DESC = 266,                    /* DESC  */
+    SHOW = 267,                    /* SHOW  */
+    SYNC = 268,                    /* SYNC  */
+    INSERT = 269,                  /* INSERT  */
+    DELETE = 270,                  /* DELETE  */
+    UPDATE = 271,                  /* UPDATE  */
+    LBRACE = 272,                  /* LBRACE  */
+    RBRACE = 273,                  /* RBRACE  */
+    COMMA = 274,                   /* COMMA  */
+    TRX_BEGIN = 275,               /* TRX_BEGIN  */
+    TRX_COMMIT = 276,              /* TRX_COMMIT  */
+    TRX_ROLLBACK = 277,            /* TRX_ROLLBACK  */
+    INT_T = 278,                   /* INT_T  */
+    STRING_T = 279,                /* STRING_T  */
+    FLOAT_T = 280,                 /* FLOAT_T  */
+    DATE_T = 281,                  /* DATE_T  */
+    TEXT_T = 282,                  /* TEXT_T  */
+    HELP = 283,                    /* HELP  */
+    EXIT = 284,                    /* EXIT  */
+    DOT = 285,                     /* DOT  */
+    INTO = 286,                    /* INTO  */
+    VALUES = 287,                  /* VALUES  */
+    FROM = 288,                    /* FROM  */
+    WHERE = 289,                   /* WHERE  */
+    AND = 290,                     /* AND  */
+    OR = 291,                      /* OR  */
+    SET = 292,                     /* SET  */
+    ON = 293,                      /* ON  */
+    LOAD = 294,                    /* LOAD  */
+    DATA = 295,                    /* DATA  */
+    INFILE = 296,                  /* INFILE  */
+    EXPLAIN = 297,                 /* EXPLAIN  */
+    IS = 298,                      /* IS  */
+    NULL_T = 299,                  /* NULL_T  */
+    INNER = 300,                   /* INNER  */
+    JOIN = 301,                    /* JOIN  */
+    AS = 302,                      /* AS  */
+    IN = 303,                      /* IN  */
+    EXISTS = 304,                  /* EXISTS  */
+    EQ = 305,                      /* EQ  */
+    LT = 306,                      /* LT  */
+    GT = 307,                      /* GT  */
+    LE = 308,                      /* LE  */
+    GE = 309,                      /* GE  */
+    NE = 310,                      /* NE  */
+    NOT = 311,                     /* NOT  */
+    LIKE = 312,                    /* LIKE  */
+    UNIQUE = 313,                  /* UNIQUE  */
+    AGGR_MAX = 314,                /* AGGR_MAX  */
+    AGGR_MIN = 315,                /* AGGR_MIN  */
+    AGGR_SUM = 316,                /* AGGR_SUM  */
+    AGGR_AVG = 317,                /* AGGR_AVG  */
+    AGGR_COUNT = 318,              /* AGGR_COUNT  */
+    LENGTH = 319,                  /* LENGTH  */
+    ROUND = 320,                   /* ROUND  */
+    DATE_FORMAT = 321,             /* DATE_FORMAT  */
+    ORDER = 322,                   /* ORDER  */
+    GROUP = 323,                   /* GROUP  */
+    BY = 324,                      /* BY  */
+    ASC = 325,                     /* ASC  */
+    HAVING = 326,                  /* HAVING  */
+    NUMBER = 327,                  /* NUMBER  */
+    FLOAT = 328,                   /* FLOAT  */
+    ID = 329,                      /* ID  */
+    SSS = 330,                     /* SSS  */
+    DATE_STR = 331,                /* DATE_STR  */
+    UMINUS = 332                   /* UMINUS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
-#if !defined YYSTYPE && !defined YYSTYPE_IS_DECLARED
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
 #line 151 "yacc_sql.y"
 
-  ParsedSqlNode                   *sql_node;
-  Value                           *value;
-  enum CompOp                      comp;
-  RelAttrSqlNode                  *rel_attr;
-  std::vector<AttrInfoSqlNode>    *attr_infos;
-  AttrInfoSqlNode                 *attr_info;
-  Expression                      *expression;
-  UpdateKV                        *update_kv;
-  std::vector<UpdateKV>           *update_kv_list;
-  std::vector<Expression *>       *expression_list;
-  std::vector<Value>              *value_list;
-  std::vector<std::string>        *relation_list;
-  std::vector<std::vector<Value>> *insert_value_list;
-  std::vector<RelAttrSqlNode>     *rel_attr_list;
-  InnerJoinSqlNode                *inner_joins;
-  std::vector<InnerJoinSqlNode>   *inner_joins_list;
-  OrderBySqlNode                  *orderby_unit;
-  std::vector<OrderBySqlNode>     *orderby_unit_list;
-  char                            *string;
-  int                              number;
-  float                            floats;
-  bool                             boolean;
-
-#line 160 "yacc_sql.hpp"
+  ParsedSqlNode *                   sql_node;
+  Value *                           value;
+  enum CompOp                       comp;
+  RelAttrSqlNode *                  rel_attr;
+  std::vector<AttrInfoSqlNode> *    attr_infos;
+  AttrInfoSqlNode *                 attr_info;
+  Expression *                      expression;
+  UpdateKV *                        update_kv;
+  std::vector<UpdateKV> *           update_kv_list;
+  std::vector<Expression *> *       expression_list;
+  std::vector<Value> *              value_list;
+  std::vector<std::string> *        relation_list;
+  std::vector<std::vector<Value>> * insert_value_list;
+  std::vector<RelAttrSqlNode> *     rel_attr_list;
+  InnerJoinSqlNode *                inner_joins;
+  std::vector<InnerJoinSqlNode> *   inner_joins_list;
+  OrderBySqlNode*                   orderby_unit;
+  std::vector<OrderBySqlNode> *     orderby_unit_list;
+  char *                            string;
+  int                               number;
+  float                             floats;
+  bool                              boolean;
+
+#line 166 "yacc_sql.hpp"
+
 };
 typedef union YYSTYPE YYSTYPE;
-#define YYSTYPE_IS_TRIVIAL 1
-#define YYSTYPE_IS_DECLARED 1
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
 /* Location type.  */
-#if !defined YYLTYPE && !defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE           YYLTYPE;
+#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
+typedef struct YYLTYPE YYLTYPE;
 struct YYLTYPE
 {
   int first_line;
@@ -173,10 +180,14 @@ struct YYLTYPE
   int last_line;
   int last_column;
 };
-#define YYLTYPE_IS_DECLARED 1
-#define YYLTYPE_IS_TRIVIAL 1
+# define YYLTYPE_IS_DECLARED 1
+# define YYLTYPE_IS_TRIVIAL 1
 #endif
 
-int yyparse(const char *sql_string, ParsedSqlResult *sql_result, void *scanner);
 
-#endif /* !YY_YY_YACC_SQL_HPP_INCLUDED  */
\ No newline at end of file
+
+
+int yyparse (const char * sql_string, ParsedSqlResult * sql_result, void * scanner);
+
+
+#endif /* !YY_YY_YACC_SQL_HPP_INCLUDED  */
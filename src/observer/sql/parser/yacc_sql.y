@@ -191,7 +191,10 @@ AggrFuncType get_aggr_func_type(char *func_name)
 %type <number>              number
 %type <boolean>             is_null_comp
 %type <boolean>             null_option
+%type <boolean>             primary_key_option
+%type <string>              storage_format_option
 %type <boolean>             unique_option
+%type <number>              index_type_option
 %type <boolean>             as_option
 %type <comp>                comp_op
 %type <comp>                exists_op
@@ -338,11 +341,12 @@ desc_table_stmt:
     ;
 
 create_index_stmt:    /*create index 语句的语法解析树*/
-    CREATE unique_option INDEX ID ON ID LBRACE ID idx_col_list RBRACE
+    CREATE unique_option INDEX ID ON ID LBRACE ID idx_col_list RBRACE index_type_option
     {
       $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = $$->create_index;
       create_index.unique = $2;
+      create_index.index_type = static_cast<IndexType>($11);
       create_index.index_name = $4;
       create_index.relation_name = $6;
       
@@ -367,6 +371,31 @@ unique_option:
     {
       $$ = true;
     }
+    ;
+/* USING 和 HASH 没有作为关键字，避免影响使用这两个名字的表和字段 */
+index_type_option:
+    /* empty */
+    {
+      $$ = static_cast<int>(IndexType::BPLUS_TREE);
+    }
+    | ID ID
+    {
+      bool valid = (0 == strcasecmp($1, "using"));
+      if (valid && 0 == strcasecmp($2, "hash")) {
+        $$ = static_cast<int>(IndexType::HASH);
+      } else if (valid && (0 == strcasecmp($2, "btree") || 0 == strcasecmp($2, "bplus_tree"))) {
+        $$ = static_cast<int>(IndexType::BPLUS_TREE);
+      } else {
+        valid = false;
+      }
+      free($1);
+      free($2);
+      if (!valid) {
+        yyerror(&@$, sql_string, sql_result, scanner, "unsupported index type");
+        YYERROR;
+      }
+    }
+    ;
 idx_col_list:
     /* empty */
     {
@@ -405,7 +434,7 @@ show_index_stmt:      /*show index 语句的语法解析树*/
     ;
 
 create_table_stmt:    /*create table 语句的语法解析树*/
-    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE
+    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format_option
     {
       $$ = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = $$->create_table;
@@ -420,6 +449,10 @@ create_table_stmt:    /*create table 语句的语法解析树*/
       create_table.attr_infos.emplace_back(*$5);
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
       delete $5;
+      if ($8 != nullptr) {
+        create_table.storage_format = $8;
+        free($8);
+      }
     }
     | CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE as_option select_stmt
     {
@@ -464,23 +497,61 @@ attr_def_list:
     ;
 
 attr_def:
-    ID type LBRACE number RBRACE null_option
+    ID type LBRACE number RBRACE null_option primary_key_option
     {
       $$ = new AttrInfoSqlNode;
       $$->type = (AttrType)$2;
       $$->name = $1;
       $$->length = $4;
-      $$->nullable = $6;
+      $$->nullable = $6 && !$7;
+      $$->primary_key = $7;
       free($1);
     }
-    | ID type null_option
+    | ID type null_option primary_key_option
     {
       $$ = new AttrInfoSqlNode;
       $$->type = (AttrType)$2;
       $$->name = $1;
       $$->length = 4;
-      $$->nullable = $3;
+      $$->nullable = $3 && !$4;
+      $$->primary_key = $4;
+      free($1);
+    }
+    ;
+/* PRIMARY KEY、STORAGE FORMAT 没有作为关键字，避免影响使用这些名字的表和字段 */
+primary_key_option:
+    /* empty */
+    {
+      $$ = false;
+    }
+    | ID ID
+    {
+      bool valid = (0 == strcasecmp($1, "primary") && 0 == strcasecmp($2, "key"));
       free($1);
+      free($2);
+      if (!valid) {
+        yyerror(&@$, sql_string, sql_result, scanner, "expect primary key");
+        YYERROR;
+      }
+      $$ = true;
+    }
+    ;
+storage_format_option:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | ID ID EQ ID
+    {
+      bool valid = (0 == strcasecmp($1, "storage") && 0 == strcasecmp($2, "format"));
+      free($1);
+      free($2);
+      if (!valid) {
+        free($4);
+        yyerror(&@$, sql_string, sql_result, scanner, "expect storage format");
+        YYERROR;
+      }
+      $$ = $4;
     }
     ;
 null_option:
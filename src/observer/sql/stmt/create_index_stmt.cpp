@@ -57,6 +57,7 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_INDEX_NAME_REPEAT;
   }
 
-  stmt = new CreateIndexStmt(table, field_metas, create_index.index_name, create_index.unique);
+  stmt = new CreateIndexStmt(
+      table, field_metas, create_index.index_name, create_index.unique, create_index.index_type);
   return RC::SUCCESS;
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <string>
 
+#include "common/types.h"
 #include "sql/stmt/stmt.h"
 
 struct CreateIndexSqlNode;
@@ -29,8 +30,9 @@ class FieldMeta;
 class CreateIndexStmt : public Stmt
 {
 public:
-  CreateIndexStmt(Table *table, std::vector<const FieldMeta *> &field_meta, const std::string &index_name, bool unique)
-      : table_(table), field_meta_(field_meta), index_name_(index_name), unique_(unique)
+  CreateIndexStmt(Table *table, std::vector<const FieldMeta *> &field_meta, const std::string &index_name, bool unique,
+      IndexType index_type)
+      : table_(table), field_meta_(field_meta), index_name_(index_name), unique_(unique), index_type_(index_type)
   {}
 
   virtual ~CreateIndexStmt() = default;
@@ -41,6 +43,7 @@ public:
   const std::vector<const FieldMeta *> &field_meta() const { return field_meta_; }
   const std::string                    &index_name() const { return index_name_; }
   bool                                  unique() { return unique_; }
+  IndexType                             index_type() const { return index_type_; }
 
 public:
   static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
@@ -50,4 +53,5 @@ private:
   std::vector<const FieldMeta *> field_meta_;
   std::string                    index_name_;
   bool                           unique_;
+  IndexType                      index_type_ = IndexType::BPLUS_TREE;
 };
\ No newline at end of file
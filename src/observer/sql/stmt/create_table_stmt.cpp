@@ -39,6 +39,8 @@ StorageFormat CreateTableStmt::get_storage_format(const char *format_str) {
     format = StorageFormat::ROW_FORMAT;
   } else if (0 == strcasecmp(format_str, "PAX")) {
     format = StorageFormat::PAX_FORMAT;
+  } else if (0 == strcasecmp(format_str, "CLUSTERED")) {
+    format = StorageFormat::CLUSTERED_FORMAT;
   } else {
     format = StorageFormat::UNKNOWN_FORMAT;
   }
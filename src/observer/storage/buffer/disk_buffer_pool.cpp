@@ -14,11 +14,15 @@ See the Mulan PSL v2 for more details. */
 #include <errno.h>
 #include <string.h>
 
+#include "common/conf/ini.h"
 #include "common/io/io.h"
-#include "common/lang/mutex.h"
 #include "common/lang/algorithm.h"
+#include "common/lang/chrono.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/math/crc.h"
+#include "common/thread/thread_util.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/db/db.h"
@@ -38,6 +42,23 @@ string BPFileHeader::to_string() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double BPFrameStat::hit_ratio() const
+{
+  const uint64_t total = hit_count + miss_count;
+  return total == 0 ? 0.0 : static_cast<double>(hit_count) / total;
+}
+
+string BPFrameStat::to_string() const
+{
+  stringstream ss;
+  ss << "hit:" << hit_count << ", miss:" << miss_count << ", hit ratio:" << hit_ratio() << ", evict:" << evict_count
+     << ", stall:" << stall_count << ", stall time(us):" << stall_time_us << ", cleaner flush:" << cleaner_flush_count
+     << ", read ahead:" << read_ahead_count;
+  return ss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BPFrameManager::BPFrameManager(const char *name) : allocator_(name) {}
 
 RC BPFrameManager::init(int pool_num)
@@ -51,81 +72,166 @@ RC BPFrameManager::init(int pool_num)
 
 RC BPFrameManager::cleanup()
 {
-  if (frames_.count() > 0) {
+  if (frame_num_.load() > 0) {
     return RC::INTERNAL;
   }
 
-  frames_.destroy();
+  for (Shard &shard : shards_) {
+    lock_guard guard(shard.lock);
+    shard.frames.clear();
+  }
   return RC::SUCCESS;
 }
 
 int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
 {
-  lock_guard<mutex> lock_guard(lock_);
-
-  vector<Frame *> frames_can_purge;
   if (count <= 0) {
     count = 1;
   }
-  frames_can_purge.reserve(count);
 
-  auto purge_finder = [&frames_can_purge, count](const FrameId &frame_id, Frame *const frame) {
-    if (frame->can_purge()) {
-      frame->pin();
-      frames_can_purge.push_back(frame);
-      if (frames_can_purge.size() >= static_cast<size_t>(count)) {
-        return false;  // false to break the progress
+  // 先加共享锁收集可以淘汰的页面，不会阻塞其它线程获取页面
+  vector<pair<pair<unsigned long, unsigned long>, FrameId>> candidates;
+  for (Shard &shard : shards_) {
+    shared_lock guard(shard.lock);
+    for (auto &[frame_id, frame] : shard.frames) {
+      if (frame->can_purge()) {
+        candidates.emplace_back(evict_key(*frame), frame_id);
       }
     }
-    return true;  // true continue to look up
-  };
+  }
 
-  frames_.foreach_reverse(purge_finder);
-  LOG_INFO("purge frames find %ld pages total", frames_can_purge.size());
+  // 多排序一些，有些页面在淘汰之前可能又被访问了
+  const size_t sort_num = min(candidates.size(), static_cast<size_t>(count) * 2 + 8);
+  partial_sort(candidates.begin(), candidates.begin() + sort_num, candidates.end(),
+      [](const auto &left, const auto &right) { return left.first < right.first; });
 
-  /// 当前还在frameManager的锁内，而 purger 是一个非常耗时的操作
-  /// 他需要把脏页数据刷新到磁盘上去，所以这里会极大地降低并发度
   int freed_count = 0;
-  for (Frame *frame : frames_can_purge) {
-    RC rc = purger(frame);
-    if (RC::SUCCESS == rc) {
-      free_internal(frame->frame_id(), frame);
+  for (size_t i = 0; i < sort_num && freed_count < count; i++) {
+    if (evict(candidates[i].second, purger)) {
       freed_count++;
-    } else {
-      frame->unpin();
-      LOG_WARN("failed to purge frame. frame_id=%s, rc=%s", 
-               frame->frame_id().to_string().c_str(), strrc(rc));
     }
   }
-  LOG_INFO("purge frame done. number=%d", freed_count);
+
+  evict_count_ += freed_count;
+  LOG_DEBUG("purge frame done. number=%d", freed_count);
   return freed_count;
 }
 
-Frame *BPFrameManager::get(int buffer_pool_id, PageNum page_num)
+bool BPFrameManager::evict(const FrameId &frame_id, function<RC(Frame *frame)> &purger)
+{
+  Shard      &shard = shard_of(frame_id);
+  unique_lock guard(shard.lock);
+
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end() || !iter->second->can_purge()) {
+    return false;
+  }
+
+  Frame *frame = iter->second;
+  frame->pin();
+
+  if (frame->dirty()) {
+    // 刷盘比较耗时，先释放分片的锁。页面已经pin住了，其它线程不会释放它
+    guard.unlock();
+    RC rc = purger(frame);
+    guard.lock();
+
+    // 刷盘期间页面可能又被访问或者修改了，这时就不再淘汰它
+    if (OB_FAIL(rc) || frame->pin_count() != 1 || frame->dirty()) {
+      if (OB_FAIL(rc) && rc != RC::LOCKED_CONCURRENCY_CONFLICT) {
+        LOG_WARN("failed to purge frame. frame_id=%s, rc=%s", frame_id.to_string().c_str(), strrc(rc));
+      }
+      frame->unpin();
+      return false;
+    }
+  }
+
+  free_internal(shard, frame_id, frame);
+  return true;
+}
+
+pair<unsigned long, unsigned long> BPFrameManager::evict_key(const Frame &frame) const
+{
+  if (replace_policy_ == BPReplacePolicy::LRU_K) {
+    // 只访问过一次的页面，倒数第二次访问时间是0，会最先被淘汰
+    return {frame.prev_ref_time(), frame.acc_time()};
+  }
+  return {frame.acc_time(), 0};
+}
+
+size_t BPFrameManager::free_frame_num() const
+{
+  const size_t total = allocator_.get_size();
+  const size_t used  = frame_num_.load();
+  return total > used ? total - used : 0;
+}
+
+void BPFrameManager::add_stall(uint64_t time_us)
+{
+  stall_count_++;
+  stall_time_us_ += time_us;
+}
+
+BPFrameStat BPFrameManager::stat() const
 {
-  FrameId                     frame_id(buffer_pool_id, page_num);
+  BPFrameStat stat;
+  for (const Shard &shard : shards_) {
+    stat.hit_count += shard.hit_count.load();
+    stat.miss_count += shard.miss_count.load();
+  }
+  stat.evict_count         = evict_count_.load();
+  stat.stall_count         = stall_count_.load();
+  stat.stall_time_us       = stall_time_us_.load();
+  stat.cleaner_flush_count = cleaner_flush_count_.load();
+  stat.read_ahead_count    = read_ahead_count_.load();
+  return stat;
+}
 
-  lock_guard<mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+bool BPFrameManager::contains(int buffer_pool_id, PageNum page_num)
+{
+  FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
+
+  shared_lock guard(shard.lock);
+  return shard.frames.find(frame_id) != shard.frames.end();
 }
 
-Frame *BPFrameManager::get_internal(const FrameId &frame_id)
+Frame *BPFrameManager::get(int buffer_pool_id, PageNum page_num)
 {
-  Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
+  FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
+
+  shared_lock guard(shard.lock);
+  Frame      *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
-    frame->pin();
+    shard.hit_count++;
+  } else {
+    shard.miss_count++;
+  }
+  return frame;
+}
+
+Frame *BPFrameManager::get_internal(Shard &shard, const FrameId &frame_id)
+{
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return nullptr;
   }
+
+  // pin count 是原子变量，持有共享锁就可以修改。淘汰页面时会加排他锁，所以这里pin过的页面不会被淘汰
+  Frame *frame = iter->second;
+  frame->pin();
   return frame;
 }
 
 Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
 {
   FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
+  lock_guard guard(shard.lock);
 
-  Frame                      *frame = get_internal(frame_id);
+  Frame *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
     return frame;
   }
@@ -137,7 +243,9 @@ Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
     frame->set_buffer_pool_id(buffer_pool_id);
     frame->set_page_num(page_num);
     frame->pin();
-    frames_.put(frame_id, frame);
+    frame->access();
+    shard.frames.emplace(frame_id, frame);
+    frame_num_++;
   }
   return frame;
 }
@@ -145,46 +253,53 @@ Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
 RC BPFrameManager::free(int buffer_pool_id, PageNum page_num, Frame *frame)
 {
   FrameId frame_id(buffer_pool_id, page_num);
+  Shard  &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  lock_guard guard(shard.lock);
+  return free_internal(shard, frame_id, frame);
 }
 
-RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
+RC BPFrameManager::free_internal(Shard &shard, const FrameId &frame_id, Frame *frame)
 {
-  Frame                *frame_source = nullptr;
-  [[maybe_unused]] bool found        = frames_.get(frame_id, frame_source);
-  ASSERT(found && frame == frame_source && frame->pin_count() == 1,
+  auto                  iter  = shard.frames.find(frame_id);
+  [[maybe_unused]] bool found = iter != shard.frames.end();
+  ASSERT(found && frame == iter->second,
       "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s",
-      found, frame_id.to_string().c_str(), frame_source, frame, frame->pin_count(), lbt());
+      found, frame_id.to_string().c_str(), found ? iter->second : nullptr, frame, frame->pin_count(), lbt());
+
+  // 后台清理线程可能正pin着这个页面在刷盘
+  if (frame->pin_count() != 1) {
+    LOG_INFO("frame is in use, can not free it. frame=%s", frame->to_string().c_str());
+    return RC::LOCKED_UNLOCK;
+  }
 
   frame->set_page_num(-1);
   frame->unpin();
-  frames_.remove(frame_id);
+  shard.frames.erase(iter);
+  frame_num_--;
   allocator_.free(frame);
   return RC::SUCCESS;
 }
 
 list<Frame *> BPFrameManager::find_list(int buffer_pool_id)
 {
-  lock_guard<mutex> lock_guard(lock_);
-
   list<Frame *> frames;
-  auto               fetcher = [&frames, buffer_pool_id](const FrameId &frame_id, Frame *const frame) -> bool {
-    if (buffer_pool_id == frame_id.buffer_pool_id()) {
-      frame->pin();
-      frames.push_back(frame);
+  for (Shard &shard : shards_) {
+    shared_lock guard(shard.lock);
+    for (auto &[frame_id, frame] : shard.frames) {
+      if (buffer_pool_id == frame_id.buffer_pool_id()) {
+        frame->pin();
+        frames.push_back(frame);
+      }
     }
-    return true;
-  };
-  frames_.foreach (fetcher);
+  }
   return frames;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 BufferPoolIterator::BufferPoolIterator() {}
 BufferPoolIterator::~BufferPoolIterator() {}
-RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
+RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */, PageNum end_page /* = -1 */)
 {
   bitmap_.init(bp.file_header_->bitmap, bp.file_header_->page_count);
   if (start_page <= 0) {
@@ -192,14 +307,22 @@ RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
   } else {
     current_page_num_ = start_page - 1;
   }
+  end_page_num_ = end_page;
   return RC::SUCCESS;
 }
 
-bool BufferPoolIterator::has_next() { return bitmap_.next_setted_bit(current_page_num_ + 1) != -1; }
+bool BufferPoolIterator::has_next()
+{
+  PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
+  return next_page != -1 && (end_page_num_ < 0 || next_page < end_page_num_);
+}
 
 PageNum BufferPoolIterator::next()
 {
   PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
+  if (next_page != -1 && end_page_num_ >= 0 && next_page >= end_page_num_) {
+    next_page = -1;
+  }
   if (next_page != -1) {
     current_page_num_ = next_page;
   }
@@ -283,17 +406,22 @@ RC DiskBufferPool::close_file()
 
   hdr_frame_->unpin();
 
-  // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
-  rc = purge_all_pages();
-  if (rc != RC::SUCCESS) {
-    LOG_ERROR("failed to close %s, due to failed to purge pages. rc=%s", file_name_.c_str(), strrc(rc));
-    return rc;
-  }
+  {
+    // 等待后台清理线程刷完手上的页面，否则这些页面会因为被pin住而无法释放
+    unique_lock close_guard(bp_manager_.close_lock_);
 
-  rc = dblwr_manager_.clear_pages(this);
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to clear pages in double write buffer. filename=%s, rc=%s", file_name_.c_str(), strrc(rc));
-    return rc;
+    // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
+    rc = purge_all_pages();
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("failed to close %s, due to failed to purge pages. rc=%s", file_name_.c_str(), strrc(rc));
+      return rc;
+    }
+
+    rc = dblwr_manager_.clear_pages(this);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to clear pages in double write buffer. filename=%s, rc=%s", file_name_.c_str(), strrc(rc));
+      return rc;
+    }
   }
 
   disposed_pages_.clear();
@@ -314,6 +442,8 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   RC rc  = RC::SUCCESS;
   *frame = nullptr;
 
+  check_sequential_access(page_num);
+
   Frame *used_match_frame = frame_manager_.get(id(), page_num);
   if (used_match_frame != nullptr) {
     used_match_frame->access();
@@ -346,6 +476,185 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   return RC::SUCCESS;
 }
 
+int DiskBufferPool::read_ahead_window() const
+{
+  // 内存比较小时，一次预读太多页面会把前面预读还没有访问的页面淘汰掉
+  const int max_window = max(static_cast<int>(frame_manager_.total_frame_num() / 4), 1);
+  return min(bp_manager_.read_ahead_pages(), max_window);
+}
+
+void DiskBufferPool::check_sequential_access(PageNum page_num)
+{
+  const int window = read_ahead_window();
+  if (window <= 0) {
+    return;
+  }
+
+  const PageNum last_page = last_access_page_.exchange(page_num);
+  if (page_num == last_page) {
+    return;  // 反复访问同一个页面
+  }
+
+  if (page_num < last_page || page_num - last_page > READ_AHEAD_MAX_GAP) {
+    sequential_count_ = 0;
+    read_ahead_end_   = 0;
+    return;
+  }
+
+  if (++sequential_count_ < READ_AHEAD_THRESHOLD) {
+    return;
+  }
+
+  // 已经预读的页面还有一半以上没有访问到，就先不预读
+  const PageNum start_page = max(read_ahead_end_.load(), page_num + 1);
+  if (start_page - page_num > window / 2) {
+    return;
+  }
+
+  read_ahead_end_ = start_page + window;
+  bp_manager_.read_ahead(*this, start_page, window);
+}
+
+void DiskBufferPool::prefetch(PageNum start_page, int page_count)
+{
+  if (page_count <= 0) {
+    page_count = read_ahead_window();
+  }
+  if (page_count <= 0) {
+    return;
+  }
+
+  // 调用者明确要顺序访问，接下来的访问直接当作顺序访问，不需要再等待 READ_AHEAD_THRESHOLD 个页面
+  last_access_page_ = start_page - 1;
+  sequential_count_ = READ_AHEAD_THRESHOLD;
+  read_ahead_end_   = start_page + page_count;
+  bp_manager_.read_ahead(*this, start_page, page_count);
+}
+
+RC DiskBufferPool::read_ahead(PageNum start_page, int page_count)
+{
+  // 预读线程跟不上时，扫描线程已经自己读过的页面就不用再预读了
+  const PageNum last_access_page = last_access_page_.load();
+  if (start_page <= last_access_page) {
+    page_count -= last_access_page + 1 - start_page;
+    start_page = last_access_page + 1;
+  }
+
+  // 找到已经分配但是不在内存中的页面
+  vector<PageNum>  page_nums;
+  vector<uint32_t> flush_versions;
+  {
+    scoped_lock lock_guard(lock_);
+    if (file_desc_ < 0) {
+      return RC::SUCCESS;
+    }
+
+    const PageNum end_page = min(start_page + page_count, file_header_->page_count);
+    for (PageNum page_num = max(start_page, BP_HEADER_PAGE + 1); page_num < end_page; page_num++) {
+      // 要先记录版本再检查页面是否在内存中，参考 flush_versions_
+      const uint32_t flush_version = flush_version_of(page_num).load();
+      if ((file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) != 0 &&
+          !frame_manager_.contains(id(), page_num)) {
+        page_nums.push_back(page_num);
+        flush_versions.push_back(flush_version);
+      }
+    }
+  }
+
+  if (page_nums.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 读取时不加锁。double write buffer中的页面比磁盘上的新，优先使用
+  const size_t       page_num_count = page_nums.size();
+  unique_ptr<Page[]> pages(new Page[page_num_count]);
+  vector<bool>       loaded(page_num_count, false);
+  for (size_t i = 0; i < page_num_count; i++) {
+    loaded[i] = OB_SUCC(dblwr_manager_.read_page(this, page_nums[i], pages[i]));
+  }
+
+  // 连续的页面合并成一个请求
+  vector<PageIORequest>      requests;
+  vector<pair<size_t, size_t>> request_pages;  // 每个请求对应的页面在 page_nums 中的范围
+  for (size_t i = 0; i < page_num_count;) {
+    if (loaded[i]) {
+      i++;
+      continue;
+    }
+
+    size_t end = i + 1;
+    while (end < page_num_count && !loaded[end] && page_nums[end] == page_nums[end - 1] + 1) {
+      end++;
+    }
+
+    PageIORequest request;
+    request.fd     = file_desc_;
+    request.offset = ((int64_t)page_nums[i]) * BP_PAGE_SIZE;
+    request.buf    = &pages[i];
+    request.size   = ((int64_t)(end - i)) * BP_PAGE_SIZE;
+    requests.push_back(request);
+    request_pages.emplace_back(i, end);
+    i = end;
+  }
+
+  // 有的页面刚刚分配，还没有写到磁盘上，读取会失败，这些页面不预读就可以了
+  (void)bp_manager_.page_io().read_pages(requests);
+  for (size_t i = 0; i < requests.size(); i++) {
+    if (OB_SUCC(requests[i].rc)) {
+      for (size_t j = request_pages[i].first; j < request_pages[i].second; j++) {
+        loaded[j] = true;
+      }
+    }
+  }
+
+  // 每个页面单独加锁，不要让扫描线程等待整批页面
+  int installed = 0;
+  for (size_t i = 0; i < page_num_count; i++) {
+    if (!loaded[i]) {
+      continue;
+    }
+
+    scoped_lock   lock_guard(lock_);
+    const PageNum page_num = page_nums[i];
+
+    // 读取期间页面可能被加载、修改后又淘汰了，这时读到的数据是旧的
+    if (flush_version_of(page_num).load() != flush_versions[i]) {
+      LOG_TRACE("page flushed while reading ahead, skip it. file=%s, page num=%d", file_name_.c_str(), page_num);
+      continue;
+    }
+
+    if ((file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) == 0 || frame_manager_.contains(id(), page_num)) {
+      continue;
+    }
+
+    Frame *frame = nullptr;
+    RC     rc    = allocate_frame(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate frame for read ahead. file=%s, page num=%d, rc=%s",
+               file_name_.c_str(), page_num, strrc(rc));
+      break;
+    }
+
+    // 分配页帧时可能淘汰了这个页面
+    if (flush_version_of(page_num).load() != flush_versions[i]) {
+      (void)frame_manager_.free(id(), page_num, frame);
+      continue;
+    }
+
+    frame->set_buffer_pool_id(id());
+    frame->page() = pages[i];
+    frame->set_page_num(page_num);
+    frame->touch();
+    frame->unpin();
+    installed++;
+  }
+
+  frame_manager_.add_read_ahead(installed);
+  LOG_DEBUG("read ahead done. file=%s, start page=%d, page count=%d, read=%d",
+            file_name_.c_str(), start_page, page_count, installed);
+  return RC::SUCCESS;
+}
+
 RC DiskBufferPool::allocate_page(Frame **frame)
 {
   RC rc = RC::SUCCESS;
@@ -441,7 +750,10 @@ RC DiskBufferPool::dispose_page(PageNum page_num)
   Frame           *used_frame = frame_manager_.get(id(), page_num);
   if (used_frame != nullptr) {
     ASSERT("the page try to dispose is in use. frame:%s", used_frame->to_string().c_str());
-    frame_manager_.free(id(), page_num, used_frame);
+    if (OB_FAIL(frame_manager_.free(id(), page_num, used_frame))) {
+      // 后台清理线程正在刷这个页面，页帧留在内存中，之后会被正常淘汰
+      used_frame->unpin();
+    }
   } else {
     LOG_DEBUG("page not found in memory while disposing it. pageNum=%d", page_num);
   }
@@ -484,8 +796,7 @@ RC DiskBufferPool::purge_frame(PageNum page_num, Frame *buf)
   }
 
   LOG_DEBUG("Successfully purge frame =%p, page %d frame_id=%s", buf, buf->page_num(), buf->frame_id().to_string().c_str());
-  frame_manager_.free(id(), page_num, buf);
-  return RC::SUCCESS;
+  return frame_manager_.free(id(), page_num, buf);
 }
 
 RC DiskBufferPool::purge_page(PageNum page_num)
@@ -543,6 +854,11 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
   // The better way is use mmap the block into memory,
   // so it is easier to flush data to file.
 
+  flush_version_of(frame.page_num())++;
+
+  // 调用者没有持有页面的锁时，刷盘期间页面可能被修改，这时不能清除脏标记
+  const uint64_t version = frame.version();
+
   RC rc = log_handler_.flush_page(frame.page());
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to log flush frame= %s, rc=%s", frame.to_string().c_str(), strrc(rc));
@@ -556,7 +872,9 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
     return rc;
   }
 
-  frame.clear_dirty();
+  if (!Frame::is_version_locked(version) && frame.validate_version(version)) {
+    frame.clear_dirty();
+  }
   LOG_DEBUG("Flush block. file desc=%d, frame=%s", file_desc_, frame.to_string().c_str());
 
   return RC::SUCCESS;
@@ -576,6 +894,72 @@ RC DiskBufferPool::flush_all_pages()
   return RC::SUCCESS;
 }
 
+RC DiskBufferPool::flush_all_pages_to_disk()
+{
+  RC rc = flush_all_pages();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = dblwr_manager_.flush_page();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush double write buffer. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+  }
+  return rc;
+}
+
+RC DiskBufferPool::dirty_page_table(vector<DirtyPage> &dirty_pages)
+{
+  list<Frame *> used = frame_manager_.find_list(id());
+  for (Frame *frame : used) {
+    LSN  rec_lsn = 0;
+    bool dirty   = false;
+    if (frame == hdr_frame_) {
+      // 文件头页面是在 lock_ 的保护下修改的
+      scoped_lock lock_guard(lock_);
+      dirty   = frame->dirty();
+      rec_lsn = frame->rec_lsn();
+    } else {
+      frame->read_latch();
+      dirty   = frame->dirty();
+      rec_lsn = frame->rec_lsn();
+      frame->read_unlatch();
+    }
+
+    if (dirty) {
+      // 没有记录recLSN的脏页，修改时没有写日志，用页面的LSN代替，让它尽早被刷新
+      dirty_pages.push_back(DirtyPage{id(), frame->page_num(), rec_lsn > 0 ? rec_lsn : frame->lsn()});
+    }
+    frame->unpin();
+  }
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::flush_dirty_page(PageNum page_num)
+{
+  Frame *frame = frame_manager_.get(id(), page_num);
+  if (frame == nullptr) {
+    return RC::SUCCESS;  // 已经被淘汰了，淘汰时已经刷新过
+  }
+
+  RC rc = RC::SUCCESS;
+  if (frame == hdr_frame_) {
+    scoped_lock lock_guard(lock_);
+    if (frame->dirty()) {
+      rc = flush_page_internal(*frame);
+    }
+  } else {
+    frame->read_latch();
+    if (frame->dirty()) {
+      rc = flush_page(*frame);
+    }
+    frame->read_unlatch();
+  }
+
+  frame->unpin();
+  return rc;
+}
+
 RC DiskBufferPool::recover_page(PageNum page_num)
 {
   int byte = 0, bit = 0;
@@ -594,15 +978,11 @@ RC DiskBufferPool::recover_page(PageNum page_num)
 
 RC DiskBufferPool::write_page(PageNum page_num, Page &page)
 {
-  scoped_lock lock_guard(wr_lock_);
-  int64_t     offset = ((int64_t)page_num) * sizeof(Page);
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to write page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(file_desc_, &page, sizeof(Page)) != 0) {
-    LOG_ERROR("Failed to write page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
+  // 使用pwrite，不依赖文件偏移量，不需要加锁
+  int64_t offset = ((int64_t)page_num) * sizeof(Page);
+  int     ret    = pwriten(file_desc_, &page, sizeof(Page), offset);
+  if (ret != 0) {
+    LOG_ERROR("Failed to write page %lld of %d due to %s.", offset, file_desc_, strerror(ret));
     return RC::IOERR_WRITE;
   }
 
@@ -612,11 +992,11 @@ RC DiskBufferPool::write_page(PageNum page_num, Page &page)
 
 RC DiskBufferPool::redo_allocate_page(LSN lsn, PageNum page_num)
 {
+  // 并行回放时，回放线程会同时读取页面，加载页面时会检查文件头中的bitmap
+  scoped_lock lock_guard(lock_);
   if (hdr_frame_->lsn() >= lsn) {
     return RC::SUCCESS;
   }
-
-  // scoped_lock lock_guard(lock_); // redo 过程中可以不加锁
   if (page_num < file_header_->page_count) {
     Bitmap bitmap(file_header_->bitmap, file_header_->page_count);
     if (bitmap.get_bit(page_num)) {
@@ -658,6 +1038,7 @@ RC DiskBufferPool::redo_allocate_page(LSN lsn, PageNum page_num)
 
 RC DiskBufferPool::redo_deallocate_page(LSN lsn, PageNum page_num)
 {
+  scoped_lock lock_guard(lock_);
   if (hdr_frame_->lsn() >= lsn) {
     return RC::SUCCESS;
   }
@@ -688,12 +1069,19 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
       return RC::SUCCESS;
     }
 
+    // 淘汰时已经释放了分片的锁，其它线程可能正在获取并修改这个页面，加读锁防止刷出不完整的页面。
+    // 不等待，跳过这个页面，淘汰其它页面
+    if (!frame->try_read_latch()) {
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+
     RC rc = RC::SUCCESS;
     if (frame->buffer_pool_id() == id()) {
       rc = this->flush_page_internal(*frame);
     } else {
       rc = bp_manager_.flush_page(*frame);
     }
+    frame->read_unlatch();
 
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to aclloc block due to failed to flush old block. rc=%s", strrc(rc));
@@ -706,11 +1094,16 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
     if (frame != nullptr) {
       *buffer = frame;
       LOG_DEBUG("allocate frame %p, page num %d", frame, page_num);
+      bp_manager_.notify_cleaner_if_needed();
       return RC::SUCCESS;
     }
 
+    // 后台清理线程没有跟上，只能自己淘汰页面，记录下花费的时间
     LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
+    auto begin_time = chrono::steady_clock::now();
     (void)frame_manager_.purge_frames(1 /*count*/, purger);
+    frame_manager_.add_stall(
+        chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - begin_time).count());
   }
   return RC::BUFFERPOOL_NOBUF;
 }
@@ -736,15 +1129,8 @@ RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
     return rc;
   }
 
-  scoped_lock lock_guard(wr_lock_);
-  int64_t          offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
-
-    return RC::IOERR_SEEK;
-  }
-
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
+  int64_t offset = ((int64_t)page_num) * BP_PAGE_SIZE;
+  int     ret    = preadn(file_desc_, &page, BP_PAGE_SIZE, offset);
   if (ret != 0) {
     LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
               file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
@@ -763,13 +1149,9 @@ RC DiskBufferPool::append_data(int64_t &offset, int64_t length, const char *data
 
   // 查看file_header中记录的文件末尾位置信息
   offset = BP_PAGE_SIZE * file_header_->page_count;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to lseek %s at offset %d :%s.", file_name_.c_str(), offset, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (0 != writen(file_desc_, data, length)) {
-    LOG_ERROR("Failed to write text into file due to %s.", offset, file_desc_, strerror(errno));
+  int ret = pwriten(file_desc_, data, length, offset);
+  if (0 != ret) {
+    LOG_ERROR("Failed to write text into file %s at offset %ld due to %s.", file_name_.c_str(), offset, strerror(ret));
     return RC::IOERR_WRITE;
   }
   file_header_->page_count += (length + BP_PAGE_SIZE - 1) / BP_PAGE_SIZE;
@@ -779,12 +1161,7 @@ RC DiskBufferPool::append_data(int64_t &offset, int64_t length, const char *data
 
 RC DiskBufferPool::get_data(int64_t offset, int64_t length, char *data)
 {
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to lseek %s at offset %d :%s.", file_name_.c_str(), offset, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  int ret = readn(file_desc_, data, length);
+  int ret = preadn(file_desc_, data, length, offset);
   if (ret != 0) {
     LOG_ERROR("Failed to load text from %s, file_desc:%d, due to failed to read data:%s, ret=%d, page count=%d",
               file_name_.c_str(), file_desc_, strerror(errno), ret, file_header_->allocated_pages);
@@ -809,6 +1186,14 @@ BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
 
 BufferPoolManager::~BufferPoolManager()
 {
+  if (cleaner_thread_) {
+    stop_cleaner();
+  }
+  if (read_ahead_thread_) {
+    stop_read_ahead();
+  }
+  LOG_INFO("buffer pool manager exit. stat: %s", frame_manager_.stat().to_string().c_str());
+
   unordered_map<string, DiskBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
 
@@ -817,9 +1202,288 @@ BufferPoolManager::~BufferPoolManager()
   }
 }
 
+static const char *replace_policy_name(BPReplacePolicy policy)
+{
+  switch (policy) {
+    case BPReplacePolicy::LRU: return "lru";
+    case BPReplacePolicy::LRU_K: return "lru_k";
+  }
+  return "unknown";
+}
+
 RC BufferPoolManager::init(unique_ptr<DoubleWriteBuffer> dblwr_buffer)
 {
   dblwr_buffer_ = std::move(dblwr_buffer);
+
+  // 从配置文件中读取淘汰策略和清理线程的参数，没有配置时使用默认值
+  const string section     = "BUFFER_POOL";
+  string       policy_name = get_properties()->get("REPLACE_POLICY", "", section);
+  string       free_frames = get_properties()->get("CLEANER_FREE_FRAMES", "", section);
+  string       interval_ms = get_properties()->get("CLEANER_INTERVAL_MS", "", section);
+  string       io_backend  = get_properties()->get("IO_BACKEND", "", section);
+  string       read_ahead  = get_properties()->get("READ_AHEAD_PAGES", "", section);
+  if (!policy_name.empty()) {
+    if (0 == strcasecmp(policy_name.c_str(), replace_policy_name(BPReplacePolicy::LRU))) {
+      set_replace_policy(BPReplacePolicy::LRU);
+    } else if (0 == strcasecmp(policy_name.c_str(), replace_policy_name(BPReplacePolicy::LRU_K))) {
+      set_replace_policy(BPReplacePolicy::LRU_K);
+    } else {
+      LOG_WARN("invalid buffer pool replace policy. policy=%s", policy_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+  if (!free_frames.empty()) {
+    str_to_val(free_frames, cleaner_free_frames_);
+  }
+  if (!interval_ms.empty()) {
+    str_to_val(interval_ms, cleaner_interval_ms_);
+  }
+  if (!read_ahead.empty()) {
+    str_to_val(read_ahead, read_ahead_pages_);
+  }
+
+  PageIOBackend backend = PageIOBackend::SYNC;
+  if (!io_backend.empty()) {
+    bool valid = false;
+    backend    = PageIO::backend_from_name(io_backend.c_str(), valid);
+    if (!valid) {
+      LOG_WARN("invalid buffer pool io backend. backend=%s", io_backend.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+  page_io_ = PageIO::create(backend);
+
+  LOG_INFO("buffer pool manager replace policy=%s, cleaner free frames=%d, cleaner interval=%dms, io backend=%s, "
+           "read ahead pages=%d",
+           replace_policy_name(frame_manager_.replace_policy()), cleaner_free_frames_, cleaner_interval_ms_,
+           PageIO::backend_name(page_io_->backend()), read_ahead_pages_);
+  return RC::SUCCESS;
+}
+
+void BufferPoolManager::set_cleaner_options(int free_frames, int interval_ms)
+{
+  cleaner_free_frames_ = free_frames;
+  if (interval_ms > 0) {
+    cleaner_interval_ms_ = interval_ms;
+  }
+}
+
+RC BufferPoolManager::start_cleaner()
+{
+  if (cleaner_thread_) {
+    LOG_ERROR("buffer pool cleaner has been started");
+    return RC::INTERNAL;
+  }
+
+  if (cleaner_free_frames_ <= 0) {
+    LOG_INFO("buffer pool cleaner is disabled");
+    return RC::SUCCESS;
+  }
+
+#ifdef CONCURRENCY
+  cleaner_running_.store(true);
+  cleaner_thread_ = make_unique<thread>(&BufferPoolManager::cleaner_func, this);
+  LOG_INFO("buffer pool cleaner started");
+#else
+  // 非并发编译时很多锁什么都不做，不能有其它线程访问页面
+  LOG_INFO("buffer pool cleaner is not supported without CONCURRENCY");
+#endif
+  return RC::SUCCESS;
+}
+
+RC BufferPoolManager::stop_cleaner()
+{
+  if (!cleaner_thread_) {
+    return RC::SUCCESS;
+  }
+
+  {
+    lock_guard guard(cleaner_mutex_);
+    cleaner_running_.store(false);
+    cleaner_cond_.notify_all();
+  }
+
+  cleaner_thread_->join();
+  cleaner_thread_.reset();
+  LOG_INFO("buffer pool cleaner stopped");
+  return RC::SUCCESS;
+}
+
+void BufferPoolManager::notify_cleaner_if_needed()
+{
+  if (cleaner_running_.load() && frame_manager_.free_frame_num() < static_cast<size_t>(cleaner_free_frames_)) {
+    cleaner_cond_.notify_one();
+  }
+}
+
+void BufferPoolManager::cleaner_func()
+{
+  thread_set_name("BPCleaner");
+  LOG_INFO("buffer pool cleaner thread started. free frames=%d", cleaner_free_frames_);
+
+  // 清理线程不持有任何 DiskBufferPool 的锁，所以刷盘时需要自己加锁
+  auto purger = [this](Frame *frame) {
+    DiskBufferPool *bp = nullptr;
+    RC              rc = get_buffer_pool(frame->buffer_pool_id(), bp);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    // 页面正在被修改，不等待，下次再刷
+    if (!frame->try_read_latch()) {
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+
+    rc = bp->flush_page(*frame);
+    frame->read_unlatch();
+    if (OB_SUCC(rc)) {
+      frame_manager_.add_cleaner_flush();
+    }
+    return rc;
+  };
+
+  while (cleaner_running_.load()) {
+    {
+      unique_lock lock(cleaner_mutex_);
+      cleaner_cond_.wait_for(lock, chrono::milliseconds(cleaner_interval_ms_));
+    }
+
+    const size_t free_frame_num = frame_manager_.free_frame_num();
+    if (!cleaner_running_.load() || free_frame_num >= static_cast<size_t>(cleaner_free_frames_)) {
+      continue;
+    }
+
+    shared_lock close_guard(close_lock_);
+    int         count = cleaner_free_frames_ - static_cast<int>(free_frame_num);
+    (void)frame_manager_.purge_frames(count, purger);
+  }
+
+  LOG_INFO("buffer pool cleaner thread stopped");
+}
+
+RC BufferPoolManager::start_read_ahead()
+{
+  if (read_ahead_thread_ || read_ahead_pages_ <= 0) {
+    return RC::SUCCESS;
+  }
+
+#ifdef CONCURRENCY
+  read_ahead_running_.store(true);
+  read_ahead_thread_ = make_unique<thread>(&BufferPoolManager::read_ahead_func, this);
+  LOG_INFO("buffer pool read ahead started");
+#else
+  LOG_INFO("buffer pool read ahead thread is not supported without CONCURRENCY, read ahead synchronously");
+#endif
+  return RC::SUCCESS;
+}
+
+RC BufferPoolManager::stop_read_ahead()
+{
+  if (!read_ahead_thread_) {
+    return RC::SUCCESS;
+  }
+
+  {
+    lock_guard guard(read_ahead_mutex_);
+    read_ahead_running_.store(false);
+    read_ahead_queue_.clear();
+    read_ahead_cond_.notify_all();
+  }
+
+  read_ahead_thread_->join();
+  read_ahead_thread_.reset();
+  LOG_INFO("buffer pool read ahead stopped");
+  return RC::SUCCESS;
+}
+
+void BufferPoolManager::read_ahead(DiskBufferPool &bp, PageNum start_page, int page_count)
+{
+  // 预读只是优化，预读线程忙不过来时直接丢弃请求
+  static constexpr size_t MAX_QUEUED_REQUESTS = 64;
+
+  if (read_ahead_running_.load()) {
+    lock_guard guard(read_ahead_mutex_);
+    if (read_ahead_queue_.size() < MAX_QUEUED_REQUESTS) {
+      read_ahead_queue_.push_back(ReadAheadRequest{bp.id(), start_page, page_count});
+      read_ahead_cond_.notify_one();
+    }
+    return;
+  }
+
+  (void)bp.read_ahead(start_page, page_count);
+}
+
+void BufferPoolManager::read_ahead_func()
+{
+  thread_set_name("BPReadAhead");
+  LOG_INFO("buffer pool read ahead thread started. read ahead pages=%d", read_ahead_pages_);
+
+  while (true) {
+    ReadAheadRequest request;
+    {
+      unique_lock lock(read_ahead_mutex_);
+      read_ahead_cond_.wait(lock, [this]() { return !read_ahead_running_.load() || !read_ahead_queue_.empty(); });
+      if (!read_ahead_running_.load()) {
+        break;
+      }
+      request = read_ahead_queue_.front();
+      read_ahead_queue_.pop_front();
+    }
+
+    // 与清理线程一样，持有共享锁期间文件不会被关闭
+    shared_lock     close_guard(close_lock_);
+    DiskBufferPool *bp = nullptr;
+    if (OB_FAIL(get_buffer_pool(request.buffer_pool_id, bp))) {
+      continue;
+    }
+    (void)bp->read_ahead(request.start_page, request.page_count);
+  }
+
+  LOG_INFO("buffer pool read ahead thread stopped");
+}
+
+RC BufferPoolManager::checkpoint(int max_flush_pages, LSN &min_rec_lsn)
+{
+  // 与清理线程一样，持有共享锁期间文件不会被关闭
+  shared_lock close_guard(close_lock_);
+
+  // 刷新页面时 double write buffer 会访问 BufferPoolManager，所以不能一直持有 lock_
+  lock_.lock();
+  unordered_map<int32_t, DiskBufferPool *> bps = id_to_buffer_pools_;
+  lock_.unlock();
+
+  vector<DirtyPage> dirty_pages;
+  for (auto &[id, bp] : bps) {
+    RC rc = bp->dirty_page_table(dirty_pages);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get dirty page table. file=%s, rc=%s", bp->filename(), strrc(rc));
+      return rc;
+    }
+  }
+
+  sort(dirty_pages.begin(), dirty_pages.end(), [](const DirtyPage &a, const DirtyPage &b) {
+    return a.rec_lsn < b.rec_lsn;
+  });
+
+  const size_t flush_count =
+      max_flush_pages < 0 ? dirty_pages.size() : min(dirty_pages.size(), static_cast<size_t>(max_flush_pages));
+  for (size_t i = 0; i < flush_count; i++) {
+    const DirtyPage &dirty_page = dirty_pages[i];
+    DiskBufferPool  *bp         = bps[dirty_page.buffer_pool_id];
+    RC               rc         = bp->flush_dirty_page(dirty_page.page_num);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to flush dirty page. file=%s, page num=%d, rc=%s", bp->filename(), dirty_page.page_num, strrc(rc));
+      return rc;
+    }
+  }
+
+  // 刷新之后页面又被修改的话，新的recLSN一定比开始做检查点时的LSN大，不影响检查点
+  if (flush_count < dirty_pages.size()) {
+    min_rec_lsn = min(min_rec_lsn, dirty_pages[flush_count].rec_lsn);
+  }
+
+  LOG_DEBUG("buffer pool checkpoint. dirty pages=%d, flushed=%d, min rec lsn=%ld",
+            static_cast<int>(dirty_pages.size()), static_cast<int>(flush_count), min_rec_lsn);
   return RC::SUCCESS;
 }
 
@@ -852,13 +1516,7 @@ RC BufferPoolManager::create_file(const char *file_name)
 
   char *bitmap = file_header->bitmap;
   bitmap[0] |= 0x01;
-  if (lseek(fd, 0, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to seek file %s to position 0, due to %s .", file_name, strerror(errno));
-    close(fd);
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(fd, (char *)&page, BP_PAGE_SIZE) != 0) {
+  if (pwriten(fd, (char *)&page, BP_PAGE_SIZE, 0 /*offset*/) != 0) {
     LOG_ERROR("Failed to write header to file %s, due to %s.", file_name, strerror(errno));
     close(fd);
     return RC::IOERR_WRITE;
@@ -902,6 +1560,8 @@ RC BufferPoolManager::close_file(const char *_file_name)
 {
   string file_name(_file_name);
 
+  // 后台线程持有共享锁时可能正在访问这个 DiskBufferPool，等它们结束之后再移除
+  unique_lock close_guard(close_lock_);
   lock_.lock();
 
   auto iter = buffer_pools_.find(file_name);
@@ -916,6 +1576,7 @@ RC BufferPoolManager::close_file(const char *_file_name)
   DiskBufferPool *bp = iter->second;
   buffer_pools_.erase(iter);
   lock_.unlock();
+  close_guard.unlock();
 
   delete bp;
   return RC::SUCCESS;
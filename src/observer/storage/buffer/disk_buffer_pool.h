@@ -26,15 +26,20 @@ See the Mulan PSL v2 for more details. */
 #include <optional>
 
 #include "common/lang/bitmap.h"
-#include "common/lang/lru_cache.h"
+#include "common/lang/atomic.h"
+#include "common/lang/deque.h"
+#include "common/lang/list.h"
 #include "common/lang/mutex.h"
 #include "common/lang/memory.h"
+#include "common/lang/thread.h"
 #include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
 #include "common/mm/mem_pool.h"
 #include "common/rc.h"
 #include "common/types.h"
 #include "storage/buffer/frame.h"
 #include "storage/buffer/page.h"
+#include "storage/buffer/page_io.h"
 #include "storage/buffer/buffer_pool_log.h"
 
 class BufferPoolManager;
@@ -76,6 +81,46 @@ struct BPFileHeader
   string to_string() const;
 };
 
+/**
+ * @brief 页面淘汰策略
+ * @ingroup BufferPool
+ */
+enum class BPReplacePolicy
+{
+  LRU,    ///< 淘汰最近一次访问时间最早的页面
+  LRU_K,  ///< LRU-2，淘汰倒数第二次访问时间最早的页面，只访问过一次的页面优先淘汰，可以抵抗大范围扫描
+};
+
+/**
+ * @brief BufferPool 的统计信息
+ * @ingroup BufferPool
+ */
+struct BPFrameStat
+{
+  uint64_t hit_count           = 0;  ///< 获取页面时，页面已经在内存中的次数
+  uint64_t miss_count          = 0;  ///< 获取页面时，页面不在内存中的次数
+  uint64_t evict_count         = 0;  ///< 淘汰的页面个数
+  uint64_t stall_count         = 0;  ///< 分配页帧时没有空闲页帧，前台线程不得不自己淘汰页面的次数
+  uint64_t stall_time_us       = 0;  ///< 前台线程自己淘汰页面花费的时间
+  uint64_t cleaner_flush_count = 0;  ///< 后台清理线程刷新的脏页个数
+  uint64_t read_ahead_count    = 0;  ///< 预读到内存中的页面个数
+
+  double hit_ratio() const;
+  string to_string() const;
+};
+
+/**
+ * @brief 脏页表中的一项
+ * @ingroup BufferPool
+ * @details 做模糊检查点时，收集所有脏页以及它们的recLSN，参考 Frame::rec_lsn
+ */
+struct DirtyPage
+{
+  int32_t buffer_pool_id = -1;
+  PageNum page_num       = -1;
+  LSN     rec_lsn        = 0;
+};
+
 /**
  * @brief 管理页面Frame
  * @ingroup BufferPool
@@ -94,6 +139,7 @@ public:
 
   /**
    * @brief 获取指定的页面
+   * @details 只加分片的共享锁，命中之后只需要原子地增加pin count
    *
    * @param buffer_pool_id buffer Pool标识
    * @param page_num  页面号
@@ -101,6 +147,12 @@ public:
    */
   Frame *get(int buffer_pool_id, PageNum page_num);
 
+  /**
+   * @brief 页面是否在内存中
+   * @details 不会pin页面，也不计入命中统计。预读时用来跳过已经在内存中的页面
+   */
+  bool contains(int buffer_pool_id, PageNum page_num);
+
   /**
    * @brief 列出所有指定文件的页面
    *
@@ -127,22 +179,36 @@ public:
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
    * 尝试从pin count=0的页面中淘汰一些
+   * @details 先加共享锁收集所有可以淘汰的页面，按照淘汰策略排序，再逐个加排他锁淘汰。
+   * 如果页面是脏的，会先pin住页面，释放分片的锁之后再调用purger刷盘，避免刷盘时阻塞其它访问。
+   * 刷盘期间如果页面又被访问或修改了，就不再淘汰这个页面。
    * @param count 想要purge多少个页面
-   * @param purger 需要在释放frame之前，对页面做些什么操作。当前是刷新脏数据到磁盘
+   * @param purger 在释放脏页之前，对页面做些什么操作。当前是刷新脏数据到磁盘
    * @return 返回本次清理了多少个页面
    */
   int purge_frames(int count, function<RC(Frame *frame)> purger);
 
-  size_t frame_num() const { return frames_.count(); }
+  size_t frame_num() const { return frame_num_.load(); }
 
   /**
    * 测试使用。返回已经从内存申请的个数
    */
   size_t total_frame_num() const { return allocator_.get_size(); }
 
-private:
-  Frame *get_internal(const FrameId &frame_id);
-  RC     free_internal(const FrameId &frame_id, Frame *frame);
+  /// @brief 还可以分配多少个页帧
+  size_t free_frame_num() const;
+
+  void            set_replace_policy(BPReplacePolicy policy) { replace_policy_ = policy; }
+  BPReplacePolicy replace_policy() const { return replace_policy_; }
+
+  /// @brief 记录一次前台线程因为没有空闲页帧而自己淘汰页面
+  void add_stall(uint64_t time_us);
+  /// @brief 记录后台清理线程刷新了一个脏页
+  void add_cleaner_flush() { cleaner_flush_count_++; }
+  /// @brief 记录预读了多少个页面
+  void add_read_ahead(int page_count) { read_ahead_count_ += page_count; }
+
+  BPFrameStat stat() const;
 
 private:
   class BPFrameIdHasher
@@ -151,12 +217,48 @@ private:
     size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
   };
 
-  using FrameLruCache  = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
+  /**
+   * @brief 页表的一个分片
+   * @details 页表按照 FrameId 的哈希值分成多个分片，每个分片有自己的锁，
+   * 访问不同分片的页面时不会互相阻塞。
+   */
+  struct alignas(64) Shard
+  {
+    shared_mutex                                 lock;
+    unordered_map<FrameId, Frame *, BPFrameIdHasher> frames;
+
+    /// 命中统计放在分片里，避免所有线程都修改同一个计数器
+    atomic<uint64_t> hit_count{0};
+    atomic<uint64_t> miss_count{0};
+  };
+
+  static constexpr int SHARD_NUM = 16;
+
+  Shard &shard_of(const FrameId &frame_id) { return shards_[frame_id.hash() % SHARD_NUM]; }
+
+  /// 下面两个函数都需要调用者持有分片的锁
+  Frame *get_internal(Shard &shard, const FrameId &frame_id);
+  RC     free_internal(Shard &shard, const FrameId &frame_id, Frame *frame);
+
+  /// @brief 淘汰一个页面，会自己加分片的锁。返回是否淘汰成功
+  bool evict(const FrameId &frame_id, function<RC(Frame *frame)> &purger);
+
+  /// @brief 淘汰页面时排序用的关键字，越小越先淘汰
+  pair<unsigned long, unsigned long> evict_key(const Frame &frame) const;
+
+private:
   using FrameAllocator = common::MemPoolSimple<Frame>;
 
-  mutex          lock_;
-  FrameLruCache  frames_;
-  FrameAllocator allocator_;
+  Shard           shards_[SHARD_NUM];
+  atomic<size_t>  frame_num_{0};  /// 所有分片中页面的个数
+  FrameAllocator  allocator_;     /// 自己有锁保护
+  BPReplacePolicy replace_policy_ = BPReplacePolicy::LRU_K;
+
+  atomic<uint64_t> evict_count_{0};
+  atomic<uint64_t> stall_count_{0};
+  atomic<uint64_t> stall_time_us_{0};
+  atomic<uint64_t> cleaner_flush_count_{0};
+  atomic<uint64_t> read_ahead_count_{0};
 };
 
 /**
@@ -169,7 +271,10 @@ public:
   BufferPoolIterator();
   ~BufferPoolIterator();
 
-  RC      init(DiskBufferPool &bp, PageNum start_page = 0);
+  /**
+   * @param end_page 遍历到哪个页面为止(不包含)，小于0表示遍历到文件结尾
+   */
+  RC      init(DiskBufferPool &bp, PageNum start_page = 0, PageNum end_page = -1);
   bool    has_next();
   PageNum next();
   RC      reset();
@@ -177,6 +282,7 @@ public:
 private:
   common::Bitmap bitmap_;
   PageNum        current_page_num_ = -1;
+  PageNum        end_page_num_     = -1;
 };
 
 /**
@@ -207,6 +313,21 @@ public:
    */
   RC get_this_page(PageNum page_num, Frame **frame);
 
+  /**
+   * @brief 提示接下来会顺序访问这些页面
+   * @details 扫描全表之类的操作在开始之前调用，页面会在后台被一次性读入内存。
+   * 不调用也可以，get_this_page 发现连续访问相邻的页面时，也会自动预读。
+   * @param start_page 从这个页面开始预读
+   * @param page_count 预读多少个页面，小于等于0时使用 read_ahead_window
+   */
+  void prefetch(PageNum start_page, int page_count = 0);
+
+  /**
+   * @brief 把指定范围内已经分配但是不在内存中的页面读到内存中
+   * @details 连续的页面合并成一个IO请求。由预读线程调用，也可以直接调用。
+   */
+  RC read_ahead(PageNum start_page, int page_count);
+
   /**
    * @brief 在指定文件中分配一个新的页面，并将其放入缓冲区，返回页面句柄指针。
    * @details 分配页面时，如果文件中有空闲页，就直接分配一个空闲页；
@@ -255,6 +376,25 @@ public:
    */
   RC flush_all_pages();
 
+  /**
+   * @brief 刷新所有页面，并且等double write buffer把它们写回数据文件
+   * @details 没有记录修改日志的页面(比如批量构建的索引页面)，只能这样直接落盘来保证持久化
+   */
+  RC flush_all_pages_to_disk();
+
+  /**
+   * @brief 收集当前文件的所有脏页以及它们的recLSN
+   * @details 做模糊检查点时使用。读取页面状态时会加读锁，正在修改的页面会等修改完成，
+   * 也就是日志已经写入并且记录到页面上之后再读取，所以不会漏掉刚刚写了日志的页面。
+   */
+  RC dirty_page_table(vector<DirtyPage> &dirty_pages);
+
+  /**
+   * @brief 如果页面在内存中并且是脏页，就刷新到double write buffer
+   * @details 检查点线程使用。刷新时加读锁，不会刷新修改了一半的页面
+   */
+  RC flush_dirty_page(PageNum page_num);
+
   /**
    * 回放日志时处理page0中已被认定为不存在的page
    */
@@ -274,6 +414,9 @@ public:
 public:
   int32_t id() const { return buffer_pool_id_; }
 
+  /// 文件中页面的个数，包括已经释放的页面
+  int32_t page_count() const { return file_header_->page_count; }
+
   const char *filename() const { return file_name_.c_str(); }
 
 protected:
@@ -295,6 +438,16 @@ protected:
    */
   RC flush_page_internal(Frame &frame);
 
+  /**
+   * @brief 检查是否在顺序访问页面，如果是就预读后面的页面
+   * @details 参考了InnoDB的线性预读。连续访问了 READ_AHEAD_THRESHOLD 个递增的页面之后，
+   * 在已经预读的页面快用完时，预读下一批页面，这样扫描线程总是访问已经在内存中的页面。
+   */
+  void check_sequential_access(PageNum page_num);
+
+  /// @brief 每次预读多少个页面。取配置的预读页面数，但是不超过内存中页帧数的1/4
+  int read_ahead_window() const;
+
 private:
   BufferPoolManager   &bp_manager_;     /// BufferPool 管理器
   BPFrameManager      &frame_manager_;  /// Frame 管理器
@@ -311,7 +464,21 @@ private:
   string file_name_;  /// 文件名
 
   common::Mutex lock_;
-  common::Mutex wr_lock_;
+
+  /// 顺序访问检测。只是用来做预读的提示，多个线程同时访问时不需要特别精确
+  static constexpr int READ_AHEAD_THRESHOLD = 4;  ///< 连续访问多少个递增的页面之后开始预读
+  static constexpr int READ_AHEAD_MAX_GAP   = 4;  ///< 两次访问的页面相差多少以内算作顺序访问(中间可能有未分配的页面)
+  atomic<PageNum> last_access_page_{-1};
+  atomic<int>     sequential_count_{0};
+  atomic<PageNum> read_ahead_end_{0};  ///< 这个页面之前的页面已经提交过预读
+
+  /// 页面每次写到double write buffer时，对应槽位的版本加1，多个页面可能共用一个槽位。
+  /// 预读不持有锁读取磁盘，读完后如果页面对应的版本变了，说明页面在这期间被修改过又淘汰了，
+  /// 读到的数据可能已经过时，就丢弃这个页面
+  static constexpr int FLUSH_VERSION_SLOTS = 1024;
+  atomic<uint32_t>     flush_versions_[FLUSH_VERSION_SLOTS];
+
+  atomic<uint32_t> &flush_version_of(PageNum page_num) { return flush_versions_[page_num % FLUSH_VERSION_SLOTS]; }
 
 private:
   friend class BufferPoolIterator;
@@ -327,8 +494,72 @@ public:
   BufferPoolManager(int memory_size = 0);
   ~BufferPoolManager();
 
+  /**
+   * @brief 初始化
+   * @details 会从配置文件的 BUFFER_POOL 中读取淘汰策略和后台清理线程的参数
+   */
   RC init(unique_ptr<DoubleWriteBuffer> dblwr_buffer);
 
+  /**
+   * @brief 启动后台清理线程
+   * @details 清理线程会提前把要淘汰的脏页刷到磁盘并释放页帧，让空闲页帧的个数维持在
+   * cleaner_free_frames 以上，这样前台分配页帧时基本不需要自己淘汰页面和做IO。
+   * 清理线程与其它线程并发访问页面，需要编译时打开 CONCURRENCY，否则不会启动。
+   */
+  RC start_cleaner();
+  RC stop_cleaner();
+
+  void set_replace_policy(BPReplacePolicy policy) { frame_manager_.set_replace_policy(policy); }
+
+  /**
+   * @brief 批量读写页面使用的IO接口
+   * @details 在配置文件 BUFFER_POOL 的 IO_BACKEND 中指定使用 pread/pwrite 还是 io_uring
+   */
+  PageIO &page_io() { return *page_io_; }
+
+  /**
+   * @brief 设置后台清理线程的参数，需要在 start_cleaner 之前调用
+   * @param free_frames 希望保持的空闲页帧个数，0表示不启动清理线程
+   * @param interval_ms 清理线程没有被唤醒时，多久检查一次
+   */
+  void set_cleaner_options(int free_frames, int interval_ms);
+
+  /**
+   * @brief 分配页帧之后调用，空闲页帧不够时唤醒清理线程
+   */
+  void notify_cleaner_if_needed();
+
+  /**
+   * @brief 启动后台预读线程
+   * @details 顺序扫描时，预读线程一次读取多个连续的页面，扫描线程就不需要每个页面都等待一次磁盘IO。
+   * 与清理线程一样，需要编译时打开 CONCURRENCY，否则预读在请求预读的线程中同步执行。
+   */
+  RC start_read_ahead();
+  RC stop_read_ahead();
+
+  /**
+   * @brief 每次预读多少个页面，0表示不预读
+   * @details 在配置文件 BUFFER_POOL 的 READ_AHEAD_PAGES 中配置
+   */
+  int  read_ahead_pages() const { return read_ahead_pages_; }
+  void set_read_ahead_pages(int page_count) { read_ahead_pages_ = page_count; }
+
+  /**
+   * @brief 提交一个预读请求
+   * @details 如果预读线程没有启动，就直接在当前线程中预读
+   */
+  void read_ahead(DiskBufferPool &bp, PageNum start_page, int page_count);
+
+  /**
+   * @brief 做模糊检查点时刷新脏页
+   * @details 收集所有文件的脏页表，按照recLSN从小到大刷新最多 max_flush_pages 个脏页，
+   * 这样检查点每次都可以向前推进，又不会一次刷新太多页面影响前台。刷新期间不阻塞其它线程修改页面。
+   * 刷新的页面只是写入了 double write buffer，调用者需要自己刷新 double write buffer。
+   * @param max_flush_pages 最多刷新多少个页面，小于0表示刷新所有脏页
+   * @param[out] min_rec_lsn 剩下的脏页中最小的recLSN，没有脏页时不修改
+   */
+  RC checkpoint(int max_flush_pages, LSN &min_rec_lsn);
+
   RC create_file(const char *file_name);
   RC open_file(LogHandler &log_handler, const char *file_name, DiskBufferPool *&bp);
   RC close_file(const char *file_name);
@@ -348,8 +579,40 @@ public:
   RC get_buffer_pool(int32_t id, DiskBufferPool *&bp);
 
 private:
+  void cleaner_func();
+  void read_ahead_func();
+
+  struct ReadAheadRequest
+  {
+    int32_t buffer_pool_id;
+    PageNum start_page;
+    int     page_count;
+  };
+
+private:
+  friend class DiskBufferPool;
+
   BPFrameManager frame_manager_{"BufPool"};
 
+  /// 后台清理线程
+  int                cleaner_free_frames_ = 0;    /// 希望保持的空闲页帧个数
+  int                cleaner_interval_ms_ = 100;  /// 清理线程检查的间隔
+  unique_ptr<thread> cleaner_thread_;
+  atomic<bool>       cleaner_running_{false};
+  mutex              cleaner_mutex_;
+  condition_variable cleaner_cond_;
+  /// 后台线程(清理、预读、检查点)访问页面时加共享锁，关闭文件时加排他锁，防止后台线程访问已经关闭的 DiskBufferPool
+  shared_mutex       close_lock_;
+
+  /// 后台预读线程
+  int                      read_ahead_pages_ = 64;
+  unique_ptr<thread>       read_ahead_thread_;
+  atomic<bool>             read_ahead_running_{false};
+  mutex                    read_ahead_mutex_;
+  condition_variable       read_ahead_cond_;
+  deque<ReadAheadRequest>  read_ahead_queue_;
+
+  unique_ptr<PageIO>            page_io_ = make_unique<SyncPageIO>();  ///< 要在dblwr_buffer_之后析构
   unique_ptr<DoubleWriteBuffer> dblwr_buffer_;
 
   common::Mutex                            lock_;
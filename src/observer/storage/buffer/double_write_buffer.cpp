@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Wenbin1002 on 2024/04/16
 //
 #include <fcntl.h>
+#include <unistd.h>
 
 #include <mutex>
 #include <algorithm>
@@ -19,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/buffer/double_write_buffer.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "common/io/io.h"
+#include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "common/math/crc.h"
 
@@ -33,6 +35,7 @@ public:
 public:
   DoubleWritePageKey key;
   int32_t            page_index = -1; /// 页面在double write buffer文件中的页索引
+  int64_t            batch_id   = 0;  /// 页面最后一次写入double write buffer文件时的批次编号
   Page               page;
 
   static const int32_t SIZE;
@@ -46,8 +49,8 @@ const int32_t DoubleWritePage::SIZE = sizeof(DoubleWritePage);
 
 const int32_t DoubleWriteBufferHeader::SIZE = sizeof(DoubleWriteBufferHeader);
 
-DiskDoubleWriteBuffer::DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages /*=16*/) 
-  : max_pages_(max_pages), bp_manager_(bp_manager)
+DiskDoubleWriteBuffer::DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages /*=DEFAULT_MAX_PAGES*/)
+  : max_pages_(max(max_pages, 1)), bp_manager_(bp_manager)
 {
 }
 
@@ -80,19 +83,91 @@ RC DiskDoubleWriteBuffer::open_file(const char *filename)
 
 RC DiskDoubleWriteBuffer::flush_page()
 {
-  sync();
+  scoped_lock lock_guard(lock_);
+  return flush_all_pages();
+}
+
+RC DiskDoubleWriteBuffer::flush_all_pages(DiskBufferPool *closing_bp /*=nullptr*/)
+{
+  if (dblwr_pages_.empty()) {
+    return RC::SUCCESS;
+  }
 
+  // 按照文件和页号排序，写回数据文件时尽量顺序访问
+  vector<DoubleWritePage *> pages;
+  pages.reserve(dblwr_pages_.size());
   for (const auto &pair : dblwr_pages_) {
-    RC rc = write_page(pair.second);
-    if (rc != RC::SUCCESS) {
+    pages.push_back(pair.second);
+  }
+  sort(pages.begin(), pages.end(), [](const DoubleWritePage *a, const DoubleWritePage *b) {
+    if (a->key.buffer_pool_id != b->key.buffer_pool_id) {
+      return a->key.buffer_pool_id < b->key.buffer_pool_id;
+    }
+    return a->key.page_num < b->key.page_num;
+  });
+
+  // 文件头和整批页面拼接在一起，一次顺序写入共享文件，只同步一次
+  DoubleWriteBufferHeader header;
+  header.page_cnt = static_cast<int32_t>(pages.size());
+  header.batch_id = header_.batch_id + 1;
+
+  const size_t batch_size = DoubleWriteBufferHeader::SIZE + pages.size() * DoubleWritePage::SIZE;
+  batch_buffer_.resize(batch_size);
+  memcpy(batch_buffer_.data(), &header, DoubleWriteBufferHeader::SIZE);
+  for (size_t i = 0; i < pages.size(); i++) {
+    pages[i]->page_index = static_cast<int32_t>(i);
+    pages[i]->batch_id   = header.batch_id;
+    memcpy(batch_buffer_.data() + DoubleWriteBufferHeader::SIZE + i * DoubleWritePage::SIZE, pages[i],
+           DoubleWritePage::SIZE);
+  }
+
+  int ret = pwriten(file_desc_, batch_buffer_.data(), batch_size, 0 /*offset*/);
+  if (ret != 0) {
+    LOG_ERROR("Failed to write double write buffer batch. page count=%d, due to %s.", header.page_cnt, strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+
+  if (fdatasync(file_desc_) != 0) {
+    LOG_ERROR("Failed to sync double write buffer file. due to %s.", strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  header_ = header;
+
+  // 共享文件落盘之后，再把整批页面同时写回各自的数据文件
+  vector<PageIORequest> requests(pages.size());
+  vector<int>           fds;
+  for (size_t i = 0; i < pages.size(); i++) {
+    RC rc = make_request(pages[i], closing_bp, requests[i]);
+    if (OB_FAIL(rc)) {
       return rc;
     }
-    delete pair.second;
+    if (fds.empty() || fds.back() != requests[i].fd) {
+      fds.push_back(requests[i].fd);
+    }
   }
 
-  dblwr_pages_.clear();
-  header_.page_cnt = 0;
+  RC rc = bp_manager_.page_io().write_pages(requests);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write pages of double write buffer. page count=%d, rc=%s",
+             static_cast<int>(requests.size()), strrc(rc));
+    return rc;
+  }
+
+  // 数据文件同步之后，共享文件中的这批页面才可以被下一批覆盖
+  for (int fd : fds) {
+    if (fdatasync(fd) != 0) {
+      LOG_ERROR("Failed to sync data file. fd=%d, due to %s.", fd, strerror(errno));
+      return RC::IOERR_SYNC;
+    }
+  }
 
+  LOG_TRACE("double write buffer flush batch done. batch id=%ld, page count=%d, file count=%d",
+            header_.batch_id, header_.page_cnt, static_cast<int>(fds.size()));
+
+  for (DoubleWritePage *page : pages) {
+    delete page;
+  }
+  dblwr_pages_.clear();
   return RC::SUCCESS;
 }
 
@@ -110,6 +185,7 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
 
   int64_t          page_cnt   = dblwr_pages_.size();
   DoubleWritePage *dblwr_page = new DoubleWritePage(bp->id(), page_num, page_cnt, page);
+  dblwr_page->batch_id        = header_.batch_id + 1;
   dblwr_pages_.insert(std::pair<DoubleWritePageKey, DoubleWritePage *>(key, dblwr_page));
   LOG_TRACE("insert page into double write buffer. buffer_pool_id:%d,page_num:%d,lsn=%d, dwb size:%d",
             bp->id(), page_num, page.lsn, static_cast<int>(dblwr_pages_.size()));
@@ -121,21 +197,8 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
     return rc;
   }
 
-  if (page_cnt + 1 > header_.page_cnt) {
-    header_.page_cnt = page_cnt + 1;
-    if (lseek(file_desc_, 0, SEEK_SET) == -1) {
-      LOG_ERROR("Failed to add page header due to failed to seek %s.", strerror(errno));
-      return RC::IOERR_SEEK;
-    }
-
-    if (writen(file_desc_, &header_, sizeof(header_)) != 0) {
-      LOG_ERROR("Failed to add page header due to %s.", strerror(errno));
-      return RC::IOERR_WRITE;
-    }
-  }
-
   if (static_cast<int>(dblwr_pages_.size()) >= max_pages_) {
-    RC rc = flush_page();
+    RC rc = flush_all_pages();
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to flush pages in double write buffer");
       return rc;
@@ -148,30 +211,33 @@ RC DiskDoubleWriteBuffer::add_page(DiskBufferPool *bp, PageNum page_num, Page &p
 RC DiskDoubleWriteBuffer::write_page_internal(DoubleWritePage *page)
 {
   int32_t page_index = page->page_index;
-  int64_t offset = page_index * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to add page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(file_desc_, page, DoubleWritePage::SIZE) != 0) {
-    LOG_ERROR("Failed to add page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
+  int64_t offset = ((int64_t)page_index) * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
+  int     ret    = pwriten(file_desc_, page, DoubleWritePage::SIZE, offset);
+  if (ret != 0) {
+    LOG_ERROR("Failed to add page %lld of %d due to %s.", offset, file_desc_, strerror(ret));
     return RC::IOERR_WRITE;
   }
 
   return RC::SUCCESS;
 }
 
-RC DiskDoubleWriteBuffer::write_page(DoubleWritePage *dblwr_page)
+RC DiskDoubleWriteBuffer::make_request(DoubleWritePage *dblwr_page, DiskBufferPool *closing_bp, PageIORequest &request)
 {
-  DiskBufferPool *disk_buffer = nullptr;
-  RC rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
+  DiskBufferPool *disk_buffer = closing_bp;
+  RC              rc          = RC::SUCCESS;
+  if (disk_buffer == nullptr || disk_buffer->id() != dblwr_page->key.buffer_pool_id) {
+    rc = bp_manager_.get_buffer_pool(dblwr_page->key.buffer_pool_id, disk_buffer);
+  }
   ASSERT(OB_SUCC(rc) && disk_buffer != nullptr, "failed to get disk buffer pool of %d", dblwr_page->key.buffer_pool_id);
 
   LOG_TRACE("double write buffer write page. buffer_pool_id:%d,page_num:%d,lsn=%d",
             dblwr_page->key.buffer_pool_id, dblwr_page->key.page_num, dblwr_page->page.lsn);
 
-  return disk_buffer->write_page(dblwr_page->key.page_num, dblwr_page->page);
+  request.fd     = disk_buffer->file_desc();
+  request.offset = ((int64_t)dblwr_page->key.page_num) * BP_PAGE_SIZE;
+  request.buf    = &dblwr_page->page;
+  request.size   = BP_PAGE_SIZE;
+  return rc;
 }
 
 RC DiskDoubleWriteBuffer::read_page(DiskBufferPool *bp, PageNum page_num, Page &page)
@@ -190,41 +256,18 @@ RC DiskDoubleWriteBuffer::read_page(DiskBufferPool *bp, PageNum page_num, Page &
 
 RC DiskDoubleWriteBuffer::clear_pages(DiskBufferPool *buffer_pool)
 {
-  vector<DoubleWritePage *> spec_pages;
-  
-  auto remove_pred = [&spec_pages, buffer_pool](const pair<DoubleWritePageKey, DoubleWritePage *> &pair) {
-    DoubleWritePage *dbl_page = pair.second;
-    if (buffer_pool->id() == dbl_page->key.buffer_pool_id) {
-      spec_pages.push_back(dbl_page);
-      return true;
-    }
-    return false;
-  };
-
-  lock_.lock();
-  erase_if(dblwr_pages_, remove_pred);
-  lock_.unlock();
-
-  LOG_INFO("clear pages in double write buffer. file name=%s, page count=%d",
-           buffer_pool->filename(), spec_pages.size());
+  scoped_lock lock_guard(lock_);
 
-  // 页面从小到大排序，防止出现小页面还没有写入，而页面编号更大的seek失败的情况
-  sort(spec_pages.begin(), spec_pages.end(), [](DoubleWritePage *a, DoubleWritePage *b) {
-    return a->key.page_num < b->key.page_num;
-  });
+  const int page_count = static_cast<int>(dblwr_pages_.size());
 
-  RC rc = RC::SUCCESS;
-  for (DoubleWritePage *dbl_page : spec_pages) {
-    rc = buffer_pool->write_page(dbl_page->key.page_num, dbl_page->page);
-    if (OB_FAIL(rc)) {
-      LOG_WARN("Failed to write page %s:%d to disk buffer pool. rc=%s",
-               buffer_pool->filename(), dbl_page->key.page_num, strrc(rc));
-      break;
-    }
+  // 共享文件中的页面是整批写入的，不能只写回一个文件的页面，所以直接把当前这一批都写回去
+  RC rc = flush_all_pages(buffer_pool);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to write pages to disk buffer pool %s. rc=%s", buffer_pool->filename(), strrc(rc));
+    return rc;
   }
 
-  for_each(spec_pages.begin(), spec_pages.end(), [](DoubleWritePage *dbl_page) { delete dbl_page; });
-
+  LOG_INFO("clear pages in double write buffer. file name=%s, page count=%d", buffer_pool->filename(), page_count);
   return RC::SUCCESS;
 }
 
@@ -240,47 +283,63 @@ RC DiskDoubleWriteBuffer::load_pages()
     return RC::BUFFERPOOL_OPEN;
   }
 
-  if (lseek(file_desc_, 0, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page header, due to failed to lseek:%s.", strerror(errno));
-    return RC::IOERR_SEEK;
+  int ret = preadn(file_desc_, &header_, sizeof(header_), 0 /*offset*/);
+  if (ret == -1) {
+    header_ = DoubleWriteBufferHeader();  // 新创建的文件
+    return RC::SUCCESS;
   }
-
-  int ret = readn(file_desc_, &header_, sizeof(header_));
-  if (ret != 0 && ret != -1) {
+  if (ret != 0) {
     LOG_ERROR("Failed to load page header, file_desc:%d, due to failed to read data:%s, ret=%d",
-                file_desc_, strerror(errno), ret);
+                file_desc_, strerror(ret), ret);
     return RC::IOERR_READ;
   }
 
-  for (int page_num = 0; page_num < header_.page_cnt; page_num++) {
-    int64_t offset = ((int64_t)page_num) * DoubleWritePage::SIZE + DoubleWriteBufferHeader::SIZE;
-
-    if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-      LOG_ERROR("Failed to load page %d, offset=%ld, due to failed to lseek:%s.", page_num, offset, strerror(errno));
-      return RC::IOERR_SEEK;
-    }
+  // 除了最后一批页面，后面还可能有还没有凑成一批的页面，文件中所有的页面都要检查
+  const off_t file_size = lseek(file_desc_, 0, SEEK_END);
+  if (file_size < 0) {
+    LOG_ERROR("Failed to get size of double write buffer file. due to %s", strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  const int64_t max_page_cnt = max<int64_t>((file_size - DoubleWriteBufferHeader::SIZE) / DoubleWritePage::SIZE, 0);
+  const int32_t page_cnt     = static_cast<int32_t>(max_page_cnt);
+  if (page_cnt == 0) {
+    LOG_INFO("double write buffer load pages done. page num=0");
+    return RC::SUCCESS;
+  }
 
-    auto dblwr_page = make_unique<DoubleWritePage>();
-    Page &page     = dblwr_page->page;
-    page.check_sum = (CheckSum)-1;
+  unique_ptr<DoubleWritePage[]> pages(new DoubleWritePage[page_cnt]);
+  ret = preadn(file_desc_, pages.get(), static_cast<int64_t>(page_cnt) * DoubleWritePage::SIZE,
+               DoubleWriteBufferHeader::SIZE);
+  if (ret != 0) {
+    LOG_ERROR("Failed to load pages, file_desc:%d, due to failed to read data:%s, ret=%d, page count=%d",
+              file_desc_, ret == -1 ? "end of file" : strerror(ret), ret, page_cnt);
+    return RC::IOERR_READ;
+  }
 
-    ret = readn(file_desc_, dblwr_page.get(), DoubleWritePage::SIZE);
-    if (ret != 0) {
-      LOG_ERROR("Failed to load page, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
-                file_desc_, page_num, strerror(errno), ret, page_num);
-      return RC::IOERR_READ;
+  // 只有属于最后一批或者还没有写完的一批，并且checksum正确的页面才是有效的，其它页面可能写了一半，
+  // 也可能是之前批次留下的。同一个页面出现两次时，使用批次编号大的
+  int invalid_count = 0;
+  for (int32_t i = 0; i < page_cnt; i++) {
+    DoubleWritePage &dblwr_page = pages[i];
+    const Page      &page       = dblwr_page.page;
+    if ((dblwr_page.batch_id != header_.batch_id && dblwr_page.batch_id != header_.batch_id + 1) ||
+        dblwr_page.page_index != i || crc32(page.data, BP_PAGE_DATA_SIZE) != page.check_sum) {
+      LOG_TRACE("got an invalid page in double write buffer. index=%d, batch id=%ld, last batch id=%ld",
+                i, dblwr_page.batch_id, header_.batch_id);
+      invalid_count++;
+      continue;
     }
 
-    const CheckSum check_sum = crc32(page.data, BP_PAGE_DATA_SIZE);
-    if (check_sum == page.check_sum) {
-      DoubleWritePageKey key = dblwr_page->key;
-      dblwr_pages_.insert(pair<DoubleWritePageKey, DoubleWritePage *>(key, dblwr_page.release()));
-    } else {
-      LOG_TRACE("got a page with an invalid checksum. on disk:%d, in memory:%d", page.check_sum, check_sum);
+    auto iter = dblwr_pages_.find(dblwr_page.key);
+    if (iter == dblwr_pages_.end()) {
+      dblwr_pages_.insert(pair<DoubleWritePageKey, DoubleWritePage *>(dblwr_page.key, new DoubleWritePage(dblwr_page)));
+    } else if (iter->second->batch_id < dblwr_page.batch_id) {
+      *iter->second = dblwr_page;
     }
   }
 
-  LOG_INFO("double write buffer load pages done. page num=%d", dblwr_pages_.size());
+  LOG_INFO("double write buffer load pages done. batch id=%ld, page num=%d, invalid page num=%d",
+           header_.batch_id, dblwr_pages_.size(), invalid_count);
   return RC::SUCCESS;
 }
 
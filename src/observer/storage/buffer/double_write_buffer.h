@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/mutex.h"
 #include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
 #include "common/types.h"
 #include "common/rc.h"
 #include "storage/buffer/page.h"
@@ -23,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 class DiskBufferPool;
 struct DoubleWritePage;
 class BufferPoolManager;
+struct PageIORequest;
 
 class DoubleWriteBuffer
 {
@@ -41,11 +43,17 @@ public:
    * @brief 清空所有与指定buffer pool关联的页面
    */
   virtual RC clear_pages(DiskBufferPool *bp) = 0;
+
+  /**
+   * @brief 将buffer中的页面全部写回数据文件
+   */
+  virtual RC flush_page() = 0;
 };
 
 struct DoubleWriteBufferHeader
 {
-  int32_t page_cnt = 0;
+  int32_t page_cnt = 0;  ///< 文件中最后一批页面的数量
+  int64_t batch_id = 0;  ///< 文件中最后一批页面的编号，每刷新一批加1
 
   static const int32_t SIZE;
 };
@@ -80,6 +88,12 @@ struct DoubleWritePageKeyHash
  * 当我们从磁盘中读取页面时，会校验页面的checksum，如果校验失败，则说明页面写入不完整，这时候可以从
  * DoubleWriteBuffer中读取数据。
  *
+ * 页面先在内存中攒成一批，加入时只写入共享文件中对应的位置(不同步，进程异常退出时不会丢失)。
+ * 凑满一批后，整批页面连同文件头一次顺序写入共享文件，只调用一次fdatasync，然后再把这批页面
+ * 一起提交给 PageIO 写回各自的数据文件，最后每个数据文件调用一次fdatasync。
+ * 共享文件中的每个页面都带有批次编号，恢复时只使用最后一批以及还没有写完的一批中checksum正确的页面。
+ * 数据文件只会在整批页面同步到共享文件之后才写，所以共享文件中写坏的页面，在数据文件中一定是完整的。
+ *
  * @note 每次都要保证，不管在内存中还是在文件中，这里的数据都是最新的，都比Buffer pool中的数据要新
  */
 class DiskDoubleWriteBuffer : public DoubleWriteBuffer
@@ -89,11 +103,15 @@ public:
    * @brief 构造函数
    *
    * @param bp_manager 关联的buffer pool manager
-   * @param max_pages  内存中保存的最大页面数
+   * @param max_pages  内存中保存的最大页面数，也就是一批页面的数量
    */
-  DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages = 16);
+  DiskDoubleWriteBuffer(BufferPoolManager &bp_manager, int max_pages = DEFAULT_MAX_PAGES);
   virtual ~DiskDoubleWriteBuffer();
 
+  static constexpr int DEFAULT_MAX_PAGES = 128;
+
+  int max_pages() const { return max_pages_; }
+
   /**
    * 打开磁盘中的共享表空间文件
    */
@@ -103,10 +121,10 @@ public:
    * 将buffer中的页全部写入磁盘，并且清空buffer
    * TODO 目前的解决方案是等buffer装满后再刷盘，可能会导致程序卡住一段时间
    */
-  RC flush_page();
+  RC flush_page() override;
 
   /**
-   * 将页面加入buffer，并且写入磁盘中的共享表空间
+   * 将页面加入buffer，并且写入磁盘中的共享表空间。buffer满了之后整批写入磁盘
    */
   RC add_page(DiskBufferPool *bp, PageNum page_num, Page &page) override;
 
@@ -118,15 +136,24 @@ public:
   RC clear_pages(DiskBufferPool *bp) override;
 
   /**
-   * 将共享表空间的页读入buffer
+   * 将共享表空间的页写回数据文件
+   * @details 文件中的页面在 open_file 时已经加载并校验过了
    */
   RC recover();
 
 private:
   /**
-   * 将buffer中的页面写入对应的磁盘
+   * @brief 生成把buffer中的页面写回对应数据文件的IO请求
+   * @param closing_bp 正在关闭的buffer pool，已经不能从 BufferPoolManager 中找到了
    */
-  RC write_page(DoubleWritePage *page);
+  RC make_request(DoubleWritePage *page, DiskBufferPool *closing_bp, PageIORequest &request);
+
+  /**
+   * @brief 把buffer中的页面作为一批全部写入磁盘。调用者需要持有锁
+   * @details 先把整批页面顺序写入共享文件并fdatasync，然后写回各自的数据文件并fdatasync。
+   * 数据文件同步完成之后，共享文件中的这批页面才可以被下一批覆盖。
+   */
+  RC flush_all_pages(DiskBufferPool *closing_bp = nullptr);
 
   /**
    * 将页面写到当前double write buffer文件中
@@ -137,6 +164,7 @@ private:
 
   /**
    * @brief 将磁盘文件中的内容加载到内存中。在启动时调用
+   * @details 整个文件一次读入，然后统一校验每个页面的批次编号和checksum
    */
   RC load_pages();
 
@@ -146,6 +174,7 @@ private:
   common::Mutex           lock_;
   BufferPoolManager      &bp_manager_;
   DoubleWriteBufferHeader header_;
+  vector<char>            batch_buffer_;  ///< 写共享文件时拼接文件头和页面，避免每次刷新都申请内存
 
   unordered_map<DoubleWritePageKey, DoubleWritePage *, DoubleWritePageKeyHash> dblwr_pages_;
 };
@@ -166,4 +195,9 @@ public:
    * @brief 清空所有与指定buffer pool关联的页面
    */
   RC clear_pages(DiskBufferPool *bp) override { return RC::SUCCESS; }
+
+  /**
+   * @brief 页面在 add_page 时已经直接写入数据文件了
+   */
+  RC flush_page() override { return RC::SUCCESS; }
 };
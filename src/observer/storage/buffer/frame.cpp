@@ -76,6 +76,11 @@ void Frame::write_latch(intptr_t xid)
 
   lock_.lock();
 
+  if (write_depth_++ == 0) {
+    version_.store(version_.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+  }
+
 #ifdef DEBUG
   write_locker_ = xid;
   ++write_recursive_count_;
@@ -110,6 +115,10 @@ void Frame::write_unlatch(intptr_t xid)
   }
   debug_lock_.unlock();
 
+  if (--write_depth_ == 0) {
+    version_.store(version_.load(memory_order_relaxed) + 1, memory_order_release);
+  }
+
   lock_.unlock();
 }
 
@@ -254,7 +263,31 @@ unsigned long current_time()
   return tp.tv_sec * 1000 * 1000 * 1000UL + tp.tv_nsec;
 }
 
-void Frame::access() { acc_time_ = current_time(); }
+void Frame::access()
+{
+  // 在这个时间之内对同一个页面的多次访问只算作一次，单位纳秒
+  static constexpr unsigned long CORRELATED_REFERENCE_PERIOD = 1000 * 1000UL;
+
+  const unsigned long now      = current_time();
+  const unsigned long ref_time = ref_time_.load();
+  if (now - ref_time > CORRELATED_REFERENCE_PERIOD) {
+    prev_ref_time_ = ref_time;
+    ref_time_      = now;
+  }
+  acc_time_ = now;
+}
+
+void Frame::touch()
+{
+  // 预读的页面在被访问之前，比刚刚访问过的页面更应该留在内存中，所以访问时间往后推一点。
+  // 真正访问时会更新为当前时间
+  static constexpr unsigned long READ_AHEAD_GRACE_PERIOD = 100 * 1000 * 1000UL;
+
+  // 分配页帧时已经记录了一次访问，这里清除掉
+  prev_ref_time_ = 0;
+  ref_time_      = 0;
+  acc_time_      = current_time() + READ_AHEAD_GRACE_PERIOD;
+}
 
 string Frame::to_string() const
 {
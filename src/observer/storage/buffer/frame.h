@@ -75,7 +75,13 @@ public:
    * @details 在 MemPoolSimple 分配和释放一个Frame对象时，不会调用构造函数和析构函数，
    * 而是调用reinit和reset。
    */
-  void reinit() {}
+  void reinit()
+  {
+    acc_time_      = 0;
+    ref_time_      = 0;
+    prev_ref_time_ = 0;
+    rec_lsn_       = 0;
+  }
   void reset() {}
 
   void clear_page() { memset(&page_, 0, sizeof(page_)); }
@@ -104,7 +110,19 @@ public:
    * 序列号要小，那就可以从日志中读取这些更大序列号的日志，做重做操作，将页面恢复到最新状态，也就是redo。
    */
   LSN  lsn() const { return page_.lsn; }
-  void set_lsn(LSN lsn) { page_.lsn = lsn; }
+  void set_lsn(LSN lsn)
+  {
+    page_.lsn    = lsn;
+    LSN expected = 0;
+    rec_lsn_.compare_exchange_strong(expected, lsn);
+  }
+
+  /**
+   * @brief 页面上次刷盘之后第一次修改的日志序列号，即ARIES中的recLSN
+   * @details 小于这个序列号的日志，修改的内容都已经在磁盘上了。所有脏页中最小的recLSN，
+   * 就是做检查点时可以跳过的日志的上限。页面刷盘后(clear_dirty)清零。
+   */
+  LSN rec_lsn() const { return rec_lsn_.load(); }
 
   /**
    * @brief 页面校验和
@@ -118,9 +136,28 @@ public:
    * @details 由于内存是有限的，比磁盘要小很多。那当我们访问某些文件页面时，可能由于内存不足
    * 而要淘汰一些页面。我们选择淘汰哪些页面呢？这里使用了LRU算法，即最近最少使用的页面被淘汰。
    * 最近最少使用，采用的依据就是访问时间。所以每次访问某个页面时，我们都要刷新一下访问时间。
+   * 为了支持LRU-K(K=2)，这里还会记录最近两次"不相关"的访问时间。在很短时间内对同一个页面的多次访问，
+   * 比如一个操作中反复获取同一个页面，只算作一次访问(参考LRU-K中的 correlated reference period)。
    */
   void access();
 
+  /**
+   * @brief 预读页面时使用，只刷新访问时间，不算作一次引用
+   * @details 预读的页面还没有被真正访问过，不能让它因为预读而看起来被访问了两次。
+   * 访问时间会设置得比当前时间稍晚，防止还没有被访问就先于已经访问过的页面被淘汰。
+   */
+  void touch();
+
+  /// @brief 最近一次访问的时间，淘汰页面时使用
+  unsigned long acc_time() const { return acc_time_.load(); }
+
+  /**
+   * @brief 倒数第二次不相关访问的时间
+   * @details 如果页面从加载到现在只被访问过一次，这个值就是0。LRU-K 会优先淘汰这种页面，
+   * 这样一次全表扫描加载的大量页面就不会把经常访问的页面挤出内存。
+   */
+  unsigned long prev_ref_time() const { return prev_ref_time_.load(); }
+
   /**
    * @brief 标记指定页面为“脏”页。
    * @details 如果修改了页面的内容，则应调用此函数，
@@ -132,8 +169,12 @@ public:
    * @brief 重置“脏”标记
    * @details 如果页面已经被写入磁盘文件，则应调用此函数。
    */
-  void clear_dirty() { dirty_ = false; }
-  bool dirty() const { return dirty_; }
+  void clear_dirty()
+  {
+    dirty_   = false;
+    rec_lsn_ = 0;
+  }
+  bool dirty() const { return dirty_.load(); }
 
   char *data() { return page_.data; }
 
@@ -166,16 +207,40 @@ public:
   void read_unlatch();
   void read_unlatch(intptr_t xid);
 
+  /**
+   * @brief 页面的版本号，乐观读使用
+   * @details 每次加写锁和释放写锁时，版本号都会加一，所以版本号是奇数时表示有线程正在修改页面。
+   * 读者不加锁，先读取版本号，再读取页面内容，最后调用 validate_version 检查版本号有没有变化，
+   * 如果没有变化，说明读取期间没有人修改过页面，读到的内容是一致的。
+   * 加读锁不会修改版本号。
+   */
+  uint64_t version() const { return version_.load(memory_order_acquire); }
+
+  /// @brief 检查从读取版本号到现在，页面有没有被修改过或者正在被修改
+  bool validate_version(uint64_t version) const
+  {
+    atomic_thread_fence(memory_order_acquire);
+    return version_.load(memory_order_relaxed) == version;
+  }
+
+  static bool is_version_locked(uint64_t version) { return (version & 1) != 0; }
+
   string to_string() const;
 
 private:
   friend class BufferPool;
 
-  bool          dirty_ = false;
-  atomic<int>   pin_count_{0};
-  unsigned long acc_time_ = 0;
-  FrameId       frame_id_;
-  Page          page_;
+  /// 后台清理线程会并发地检查和刷新脏页，所以使用原子变量
+  atomic<bool>          dirty_{false};
+  atomic<int>           pin_count_{0};
+  atomic<unsigned long> acc_time_{0};       /// 多个线程可能同时访问同一个页面，所以使用原子变量
+  atomic<unsigned long> ref_time_{0};       /// 最近一次不相关访问的时间
+  atomic<unsigned long> prev_ref_time_{0};  /// 倒数第二次不相关访问的时间
+  atomic<LSN>           rec_lsn_{0};        /// 参考 rec_lsn，检查点线程会并发地读取
+  atomic<uint64_t>      version_{0};        /// 乐观读使用的版本号，参考 version()
+  int                   write_depth_ = 0;   /// 写锁递归加锁的次数，只有持有写锁的线程会访问
+  FrameId               frame_id_;
+  Page                  page_;
 
   /// 在非并发编译时，加锁解锁动作将什么都不做
   common::RecursiveSharedMutex lock_;
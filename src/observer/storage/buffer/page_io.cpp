@@ -0,0 +1,405 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+
+#include "storage/buffer/page_io.h"
+#include "common/io/io.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/deque.h"
+#include "common/lang/mutex.h"
+#include "common/lang/vector.h"
+#include "common/log/log.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define MINIOB_HAVE_IO_URING 1
+#include <atomic>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace common;
+
+const char *PageIO::backend_name(PageIOBackend backend)
+{
+  switch (backend) {
+    case PageIOBackend::SYNC: return "sync";
+    case PageIOBackend::IO_URING: return "io_uring";
+  }
+  return "unknown";
+}
+
+PageIOBackend PageIO::backend_from_name(const char *name, bool &valid)
+{
+  valid = true;
+  if (0 == strcasecmp(name, backend_name(PageIOBackend::SYNC))) {
+    return PageIOBackend::SYNC;
+  }
+  if (0 == strcasecmp(name, backend_name(PageIOBackend::IO_URING))) {
+    return PageIOBackend::IO_URING;
+  }
+  valid = false;
+  return PageIOBackend::SYNC;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RC SyncPageIO::read_pages(span<PageIORequest> requests)
+{
+  RC rc = RC::SUCCESS;
+  for (PageIORequest &request : requests) {
+    int ret = preadn(request.fd, request.buf, request.size, request.offset);
+    if (ret != 0) {
+      LOG_WARN("failed to read page. fd=%d, offset=%ld, size=%ld, ret=%d, error=%s",
+               request.fd, request.offset, request.size, ret, ret == -1 ? "end of file" : strerror(ret));
+      request.rc = RC::IOERR_READ;
+      rc         = request.rc;
+    } else {
+      request.rc = RC::SUCCESS;
+    }
+  }
+  return rc;
+}
+
+RC SyncPageIO::write_pages(span<PageIORequest> requests)
+{
+  RC rc = RC::SUCCESS;
+  for (PageIORequest &request : requests) {
+    int ret = pwriten(request.fd, request.buf, request.size, request.offset);
+    if (ret != 0) {
+      LOG_WARN("failed to write page. fd=%d, offset=%ld, size=%ld, error=%s",
+               request.fd, request.offset, request.size, strerror(ret));
+      request.rc = RC::IOERR_WRITE;
+      rc         = request.rc;
+    } else {
+      request.rc = RC::SUCCESS;
+    }
+  }
+  return rc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef MINIOB_HAVE_IO_URING
+
+/**
+ * @brief 使用io_uring批量读写页面
+ * @details 没有依赖liburing，直接使用系统调用。所有请求共用一个ring，一批请求会一直保持
+ * 最多 QUEUE_DEPTH 个在内核中执行，完成一个就补充一个，直到所有请求都完成。
+ * 有多个线程同时提交时，一个线程执行完自己的一批请求，另一个线程才能开始。
+ * io_uring_enter 出错时，先等内核中的请求都完成再返回，避免调用者释放了内核还在使用的缓冲区。
+ * 如果等待也失败了，ring 的状态就无法确定，之后改用 pread/pwrite。
+ */
+class UringPageIO : public PageIO
+{
+public:
+  UringPageIO() = default;
+  ~UringPageIO() override;
+
+  RC init();
+
+  PageIOBackend backend() const override { return broken_ ? PageIOBackend::SYNC : PageIOBackend::IO_URING; }
+
+  RC read_pages(span<PageIORequest> requests) override
+  {
+    return broken_ ? fallback_.read_pages(requests) : submit(requests, IORING_OP_READ);
+  }
+  RC write_pages(span<PageIORequest> requests) override
+  {
+    return broken_ ? fallback_.write_pages(requests) : submit(requests, IORING_OP_WRITE);
+  }
+
+private:
+  RC submit(span<PageIORequest> requests, uint8_t opcode);
+
+  /// 把一个请求剩下没有完成的部分放到提交队列中
+  void prepare(PageIORequest &request, int64_t done, uint64_t index, uint8_t opcode);
+
+  /// 提交已经放到队列中的请求，并等待至少 min_complete 个请求完成
+  int enter(unsigned to_submit, unsigned min_complete);
+
+  /**
+   * @brief 提交出错之后，撤回还没有提交给内核的请求，并等待内核中的请求全部完成
+   * @return 没有办法等到请求完成时返回false，这时 ring 不能再使用
+   */
+  bool drain(span<PageIORequest> requests, vector<int64_t> &done, unsigned &in_flight, unsigned unsubmitted,
+      uint8_t opcode);
+
+  /**
+   * @brief 处理完成队列中的请求
+   * @param pending 不为空时，需要重新提交的请求放到这里，否则认为请求失败
+   */
+  RC reap(span<PageIORequest> requests, vector<int64_t> &done, deque<uint64_t> *pending, unsigned &in_flight,
+      uint8_t opcode);
+
+private:
+  static constexpr unsigned QUEUE_DEPTH = 64;
+
+  Mutex lock_;
+
+  int    ring_fd_     = -1;
+  void  *sq_ptr_      = nullptr;
+  size_t sq_ring_size_ = 0;
+  void  *cq_ptr_      = nullptr;
+  size_t cq_ring_size_ = 0;
+
+  io_uring_sqe *sqes_      = nullptr;
+  size_t        sqes_size_ = 0;
+
+  unsigned *sq_head_  = nullptr;
+  unsigned *sq_tail_  = nullptr;
+  unsigned *sq_mask_  = nullptr;
+  unsigned *sq_array_ = nullptr;
+  unsigned *cq_head_  = nullptr;
+  unsigned *cq_tail_  = nullptr;
+  unsigned *cq_mask_  = nullptr;
+
+  io_uring_cqe *cqes_ = nullptr;
+
+  unsigned sq_entries_ = 0;
+
+  std::atomic<bool> broken_{false};  ///< ring 的状态无法确定，改用 fallback_
+  SyncPageIO        fallback_;
+};
+
+UringPageIO::~UringPageIO()
+{
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+    munmap(cq_ptr_, cq_ring_size_);
+  }
+  if (sq_ptr_ != nullptr) {
+    munmap(sq_ptr_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+RC UringPageIO::init()
+{
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, QUEUE_DEPTH, &params));
+  if (ring_fd_ < 0) {
+    LOG_WARN("failed to setup io_uring. error=%s", strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    sq_ring_size_ = cq_ring_size_ = max(sq_ring_size_, cq_ring_size_);
+  }
+
+  sq_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ptr_ == MAP_FAILED) {
+    sq_ptr_ = nullptr;
+    LOG_WARN("failed to mmap io_uring submission queue. error=%s", strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    cq_ptr_ = sq_ptr_;
+  } else {
+    cq_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ptr_ == MAP_FAILED) {
+      cq_ptr_ = nullptr;
+      LOG_WARN("failed to mmap io_uring completion queue. error=%s", strerror(errno));
+      return RC::IOERR_OPEN;
+    }
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    LOG_WARN("failed to mmap io_uring submission queue entries. error=%s", strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  char *sq_ptr = static_cast<char *>(sq_ptr_);
+  char *cq_ptr = static_cast<char *>(cq_ptr_);
+  sq_head_     = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.head);
+  sq_tail_     = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.tail);
+  sq_mask_     = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.ring_mask);
+  sq_array_    = reinterpret_cast<unsigned *>(sq_ptr + params.sq_off.array);
+  cq_head_     = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.head);
+  cq_tail_     = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.tail);
+  cq_mask_     = reinterpret_cast<unsigned *>(cq_ptr + params.cq_off.ring_mask);
+  cqes_        = reinterpret_cast<io_uring_cqe *>(cq_ptr + params.cq_off.cqes);
+  sq_entries_  = params.sq_entries;
+
+  LOG_INFO("io_uring page io initialized. sq entries=%u, cq entries=%u", params.sq_entries, params.cq_entries);
+  return RC::SUCCESS;
+}
+
+void UringPageIO::prepare(PageIORequest &request, int64_t done, uint64_t index, uint8_t opcode)
+{
+  // 提交队列的尾部只有当前线程修改，头部由内核修改
+  const unsigned tail = *sq_tail_;
+  const unsigned slot = tail & *sq_mask_;
+
+  io_uring_sqe &sqe = sqes_[slot];
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode    = opcode;
+  sqe.fd        = request.fd;
+  sqe.addr      = reinterpret_cast<uint64_t>(static_cast<char *>(request.buf) + done);
+  sqe.len       = static_cast<uint32_t>(request.size - done);
+  sqe.off       = static_cast<uint64_t>(request.offset + done);
+  sqe.user_data = index;
+
+  sq_array_[slot] = slot;
+  std::atomic_ref<unsigned>(*sq_tail_).store(tail + 1, std::memory_order_release);
+}
+
+int UringPageIO::enter(unsigned to_submit, unsigned min_complete)
+{
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0));
+}
+
+RC UringPageIO::submit(span<PageIORequest> requests, uint8_t opcode)
+{
+  scoped_lock guard(lock_);
+  if (broken_) {
+    return opcode == IORING_OP_READ ? fallback_.read_pages(requests) : fallback_.write_pages(requests);
+  }
+
+  // 每个请求已经完成了多少字节。请求可能只完成一部分，这时需要把剩下的部分重新提交
+  vector<int64_t> done(requests.size(), 0);
+  deque<uint64_t> pending;
+  for (uint64_t i = 0; i < requests.size(); i++) {
+    requests[i].rc = RC::SUCCESS;
+    pending.push_back(i);
+  }
+
+  RC       rc          = RC::SUCCESS;
+  unsigned in_flight   = 0;  // 已经放到提交队列中，还没有完成的请求
+  unsigned unsubmitted = 0;  // 放到提交队列中，还没有提交给内核的请求
+  while (!pending.empty() || in_flight > 0) {
+    while (!pending.empty() && in_flight < sq_entries_) {
+      uint64_t index = pending.front();
+      pending.pop_front();
+      prepare(requests[index], done[index], index, opcode);
+      in_flight++;
+      unsubmitted++;
+    }
+
+    int ret = enter(unsubmitted, 1 /*min_complete*/);
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        // 没有提交成功的请求还在队列中，先处理已经完成的请求
+        ret = 0;
+      } else {
+        LOG_ERROR("failed to submit io_uring requests. error=%s", strerror(errno));
+        if (!drain(requests, done, in_flight, unsubmitted, opcode)) {
+          broken_ = true;
+          LOG_ERROR("failed to wait for in-flight io_uring requests, use pread/pwrite instead");
+        }
+
+        // 没有完成的请求都认为失败了
+        for (uint64_t i = 0; i < requests.size(); i++) {
+          if (done[i] < requests[i].size && OB_SUCC(requests[i].rc)) {
+            requests[i].rc = opcode == IORING_OP_READ ? RC::IOERR_READ : RC::IOERR_WRITE;
+          }
+        }
+        return opcode == IORING_OP_READ ? RC::IOERR_READ : RC::IOERR_WRITE;
+      }
+    }
+    unsubmitted -= static_cast<unsigned>(ret);
+
+    RC reap_rc = reap(requests, done, &pending, in_flight, opcode);
+    if (OB_FAIL(reap_rc)) {
+      rc = reap_rc;
+    }
+  }
+  return rc;
+}
+
+bool UringPageIO::drain(
+    span<PageIORequest> requests, vector<int64_t> &done, unsigned &in_flight, unsigned unsubmitted, uint8_t opcode)
+{
+  // 没有使用 SQPOLL，内核只在 io_uring_enter 中读取提交队列，还没有提交的请求可以直接撤回
+  if (unsubmitted > 0) {
+    const unsigned tail = *sq_tail_;
+    std::atomic_ref<unsigned>(*sq_tail_).store(tail - unsubmitted, std::memory_order_release);
+    in_flight -= unsubmitted;
+  }
+
+  while (in_flight > 0) {
+    int ret = enter(0 /*to_submit*/, in_flight /*min_complete*/);
+    if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      LOG_ERROR("failed to wait for io_uring completions. in flight=%u, error=%s", in_flight, strerror(errno));
+      return false;
+    }
+    reap(requests, done, nullptr /*pending*/, in_flight, opcode);
+  }
+  return true;
+}
+
+RC UringPageIO::reap(
+    span<PageIORequest> requests, vector<int64_t> &done, deque<uint64_t> *pending, unsigned &in_flight, uint8_t opcode)
+{
+  RC             rc   = RC::SUCCESS;
+  unsigned       head = *cq_head_;
+  const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+  for (; head != tail; head++) {
+    const io_uring_cqe &cqe     = cqes_[head & *cq_mask_];
+    const uint64_t      index   = cqe.user_data;
+    PageIORequest      &request = requests[index];
+    in_flight--;
+
+    if (pending != nullptr && cqe.res < 0 && (-cqe.res == EINTR || -cqe.res == EAGAIN)) {
+      pending->push_back(index);
+      continue;
+    }
+
+    if (cqe.res <= 0) {
+      LOG_WARN("failed to %s page. fd=%d, offset=%ld, size=%ld, error=%s",
+               opcode == IORING_OP_READ ? "read" : "write", request.fd, request.offset, request.size,
+               cqe.res < 0 ? strerror(-cqe.res) : "end of file");
+      request.rc = opcode == IORING_OP_READ ? RC::IOERR_READ : RC::IOERR_WRITE;
+      rc         = request.rc;
+      continue;
+    }
+
+    done[index] += cqe.res;
+    if (pending != nullptr && done[index] < request.size) {
+      pending->push_back(index);
+    }
+  }
+  std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+  return rc;
+}
+
+#endif  // MINIOB_HAVE_IO_URING
+
+unique_ptr<PageIO> PageIO::create(PageIOBackend backend)
+{
+  if (backend == PageIOBackend::IO_URING) {
+#ifdef MINIOB_HAVE_IO_URING
+    auto page_io = make_unique<UringPageIO>();
+    if (OB_SUCC(page_io->init())) {
+      return page_io;
+    }
+    LOG_WARN("io_uring is not available, use pread/pwrite instead");
+#else
+    LOG_WARN("io_uring is not supported on this platform, use pread/pwrite instead");
+#endif
+  }
+  return make_unique<SyncPageIO>();
+}
@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/memory.h"
+#include "common/lang/span.h"
+#include "common/rc.h"
+
+/**
+ * @brief 一次页面读写请求
+ * @ingroup BufferPool
+ */
+struct PageIORequest
+{
+  int     fd     = -1;       ///< 文件描述符
+  int64_t offset = 0;        ///< 在文件中的位置
+  void   *buf    = nullptr;  ///< 读到哪里或者从哪里写
+  int64_t size   = 0;        ///< 读写多少字节
+  RC      rc     = RC::SUCCESS;  ///< 这个请求的执行结果
+};
+
+/**
+ * @brief 页面IO的实现方式
+ * @ingroup BufferPool
+ */
+enum class PageIOBackend
+{
+  SYNC,      ///< 使用pread/pwrite，一个请求一个请求地执行
+  IO_URING,  ///< 使用io_uring，一批请求同时提交给内核，异步完成
+};
+
+/**
+ * @brief 批量读写页面
+ * @ingroup BufferPool
+ * @details 单个页面的读写直接使用 pread/pwrite 就可以了。刷新很多页面(比如 double write buffer
+ * 把页面写回数据文件)或者预读很多页面时，使用这个接口一次提交一批请求，有些实现(io_uring)
+ * 可以让这些请求同时在磁盘上执行，而不是一个一个地等待。
+ * 所有实现都是线程安全的。
+ */
+class PageIO
+{
+public:
+  virtual ~PageIO() = default;
+
+  virtual PageIOBackend backend() const = 0;
+
+  /**
+   * @brief 执行一批读请求
+   * @details 所有请求都执行完才返回，每个请求的结果保存在请求的rc中。
+   * 读到文件尾但是没有读够数据，也认为是失败。
+   * @return 有任何一个请求失败就返回失败
+   */
+  virtual RC read_pages(span<PageIORequest> requests) = 0;
+
+  /**
+   * @brief 执行一批写请求
+   * @see read_pages
+   */
+  virtual RC write_pages(span<PageIORequest> requests) = 0;
+
+  /**
+   * @brief 创建指定类型的PageIO
+   * @details 如果当前系统不支持io_uring，会使用pread/pwrite代替
+   */
+  static unique_ptr<PageIO> create(PageIOBackend backend);
+
+  static const char   *backend_name(PageIOBackend backend);
+  static PageIOBackend backend_from_name(const char *name, bool &valid);
+};
+
+/**
+ * @brief 使用 pread/pwrite 读写页面
+ * @ingroup BufferPool
+ */
+class SyncPageIO : public PageIO
+{
+public:
+  PageIOBackend backend() const override { return PageIOBackend::SYNC; }
+
+  RC read_pages(span<PageIORequest> requests) override;
+  RC write_pages(span<PageIORequest> requests) override;
+};
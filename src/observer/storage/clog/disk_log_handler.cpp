@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/01/30
 //
 
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
 #include "common/thread/thread_util.h"
 #include "storage/clog/disk_log_handler.h"
 #include "storage/clog/log_file.h"
@@ -23,12 +26,58 @@ using namespace common;
 ////////////////////////////////////////////////////////////////////////////////
 // LogHandler
 
+static const char *commit_policy_name(LogCommitPolicy policy)
+{
+  switch (policy) {
+    case LogCommitPolicy::SYNC_PER_GROUP: return "sync_per_group";
+    case LogCommitPolicy::SYNC_INTERVAL: return "sync_interval";
+    case LogCommitPolicy::NO_SYNC: return "no_sync";
+  }
+  return "unknown";
+}
+
 RC DiskLogHandler::init(const char *path)
 {
+  // 从配置文件中读取提交策略，没有配置时使用默认值
+  const string section          = "CLOG";
+  string       policy_name      = get_properties()->get("COMMIT_POLICY", "", section);
+  string       sync_interval_ms = get_properties()->get("SYNC_INTERVAL_MS", "", section);
+  if (!policy_name.empty()) {
+    if (0 == strcasecmp(policy_name.c_str(), commit_policy_name(LogCommitPolicy::SYNC_PER_GROUP))) {
+      commit_policy_ = LogCommitPolicy::SYNC_PER_GROUP;
+    } else if (0 == strcasecmp(policy_name.c_str(), commit_policy_name(LogCommitPolicy::SYNC_INTERVAL))) {
+      commit_policy_ = LogCommitPolicy::SYNC_INTERVAL;
+    } else if (0 == strcasecmp(policy_name.c_str(), commit_policy_name(LogCommitPolicy::NO_SYNC))) {
+      commit_policy_ = LogCommitPolicy::NO_SYNC;
+    } else {
+      LOG_WARN("invalid clog commit policy. policy=%s", policy_name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+  if (!sync_interval_ms.empty()) {
+    str_to_val(sync_interval_ms, sync_interval_ms_);
+  }
+  LOG_INFO("clog commit policy=%s, sync interval=%dms", commit_policy_name(commit_policy_), sync_interval_ms_);
+
+  // 回放日志之后会使用最大的LSN重新初始化缓冲区。这里先初始化一次，没有回放日志也可以直接写日志
+  RC rc = entry_buffer_.init(0 /*lsn*/);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init log entry buffer. rc=%s", strrc(rc));
+    return rc;
+  }
+
   const int max_entry_number_per_file = 1000;
   return file_manager_.init(path, max_entry_number_per_file);
 }
 
+void DiskLogHandler::set_commit_policy(LogCommitPolicy policy, int sync_interval_ms /*= 0*/)
+{
+  commit_policy_ = policy;
+  if (sync_interval_ms > 0) {
+    sync_interval_ms_ = sync_interval_ms;
+  }
+}
+
 RC DiskLogHandler::start()
 {
   if (thread_) {
@@ -51,6 +100,13 @@ RC DiskLogHandler::stop()
 
   running_.store(false);
 
+  {
+    // 唤醒刷盘线程和等待日志的调用者
+    lock_guard guard(mutex_);
+    flush_cond_.notify_all();
+    commit_cond_.notify_all();
+  }
+
   LOG_INFO("log handler stopped");
   return RC::SUCCESS;
 }
@@ -83,7 +139,7 @@ RC DiskLogHandler::replay(LogReplayer &replayer, LSN start_lsn)
     return replayer.replay(entry);
   };
 
-  RC rc = iterate(replay_callback, start_lsn);
+  RC rc = iterate_files(replay_callback, start_lsn, true /*truncate_torn_tail*/);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to iterate log entries. rc=%s", strrc(rc));
     return rc;
@@ -95,11 +151,20 @@ RC DiskLogHandler::replay(LogReplayer &replayer, LSN start_lsn)
     return rc;
   }
 
+  // 已经在文件中的日志，都认为是提交了的
+  synced_lsn_ = max_lsn;
+  committed_lsn_.store(max_lsn);
+
   LOG_INFO("replay clog files done. start lsn=%ld, max_lsn=%ld", start_lsn, max_lsn);
   return rc;
 }
 
 RC DiskLogHandler::iterate(function<RC(LogEntry&)> consumer, LSN start_lsn)
+{
+  return iterate_files(consumer, start_lsn, false /*truncate_torn_tail*/);
+}
+
+RC DiskLogHandler::iterate_files(function<RC(LogEntry &)> consumer, LSN start_lsn, bool truncate_torn_tail)
 {
   vector<string> log_files;
   RC rc = file_manager_.list_files(log_files, start_lsn);
@@ -108,7 +173,8 @@ RC DiskLogHandler::iterate(function<RC(LogEntry&)> consumer, LSN start_lsn)
     return rc;
   }
 
-  for (auto &file : log_files) {
+  for (size_t i = 0; i < log_files.size(); i++) {
+    const string &file = log_files[i];
     LogFileReader file_handle;
     rc = file_handle.open(file.c_str());
     if (OB_FAIL(rc)) {
@@ -122,61 +188,158 @@ RC DiskLogHandler::iterate(function<RC(LogEntry&)> consumer, LSN start_lsn)
       return rc;
     }
 
+    const bool    torn       = file_handle.torn();
+    const int64_t valid_size = file_handle.valid_size();
     rc = file_handle.close();
     if (OB_FAIL(rc)) {
       LOG_WARN("failed to close clog file. rc=%s, file=%s", strrc(rc), file.c_str());
       return rc;
     }
+
+    if (!torn) {
+      continue;
+    }
+
+    // 只有最后写入的日志可能因为崩溃而不完整，前面的文件已经写完了，出现这种情况说明文件损坏了
+    if (i + 1 != log_files.size()) {
+      LOG_ERROR("found torn log entry in the middle of clog files. file=%s, valid size=%ld", file.c_str(), valid_size);
+      return RC::IOERR_READ;
+    }
+
+    if (truncate_torn_tail) {
+      error_code ec;
+      filesystem::resize_file(file, valid_size, ec);
+      if (ec) {
+        LOG_WARN("failed to truncate torn clog file. file=%s, size=%ld, error=%s",
+                 file.c_str(), valid_size, ec.message().c_str());
+        return RC::IOERR_WRITE;
+      }
+      LOG_INFO("truncate torn clog file. file=%s, size=%ld", file.c_str(), valid_size);
+    }
   }
 
   LOG_INFO("iterate clog files done. rc=%s", strrc(rc));
   return RC::SUCCESS;
 }
 
-RC DiskLogHandler::_append(LSN &lsn, LogModule module, vector<char> &&data)
+RC DiskLogHandler::_append(LSN &lsn, LogModule module, span<const char> data)
 {
   ASSERT(running_.load(), "log handler is not running. lsn=%ld, module=%s, size=%d", 
         lsn, module.name(), data.size());
 
-  RC rc = entry_buffer_.append(lsn, module, std::move(data));
+  RC rc = entry_buffer_.append(lsn, module, data);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to append log entry to buffer. rc=%s", strrc(rc));
     return rc;
   }
 
+  // 刷盘线程在等待新日志时才需要唤醒它，避免每次写日志都加锁
+  if (flusher_waiting_.load()) {
+    lock_guard guard(mutex_);
+    flush_cond_.notify_one();
+  }
   return RC::SUCCESS;
 }
 
+RC DiskLogHandler::recycle(LSN lsn)
+{
+  int recycled_count = 0;
+  return file_manager_.recycle(lsn, recycled_count);
+}
+
 RC DiskLogHandler::wait_lsn(LSN lsn)
 {
-  // 直接强制等待。在生产系统中，我们可能会使用条件变量来等待。
-  while (running_.load() && current_flushed_lsn() < lsn) {
-    this_thread::sleep_for(chrono::milliseconds(100));
+  if (committed_lsn_.load() >= lsn) {
+    return RC::SUCCESS;
   }
 
-  if (current_flushed_lsn() >= lsn) {
+  unique_lock lock(mutex_);
+  commit_cond_.wait(lock, [this, lsn]() { return !running_.load() || committed_lsn_.load() >= lsn; });
+
+  if (committed_lsn_.load() >= lsn) {
     return RC::SUCCESS;
   } else {
     return RC::INTERNAL;
   }
 }
 
+RC DiskLogHandler::sync_and_commit(LogFileWriter &writer, bool force)
+{
+  const LSN written_lsn = entry_buffer_.flushed_lsn();
+  const auto now        = chrono::steady_clock::now();
+
+  bool need_sync = false;
+  switch (commit_policy_) {
+    case LogCommitPolicy::SYNC_PER_GROUP: {
+      need_sync = written_lsn > synced_lsn_;
+    } break;
+    case LogCommitPolicy::SYNC_INTERVAL: {
+      need_sync = written_lsn > synced_lsn_ &&
+                  (force || now - last_sync_time_ >= chrono::milliseconds(sync_interval_ms_));
+    } break;
+    case LogCommitPolicy::NO_SYNC: {
+      need_sync = false;
+    } break;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (need_sync) {
+    rc = writer.sync();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to sync log file. file=%s, rc=%s", writer.to_string().c_str(), strrc(rc));
+    } else {
+      synced_lsn_     = written_lsn;
+      last_sync_time_ = now;
+    }
+  }
+
+  // 只有 SYNC_PER_GROUP 策略要求日志持久化之后才能提交
+  LSN commit_lsn = (commit_policy_ == LogCommitPolicy::SYNC_PER_GROUP) ? synced_lsn_ : written_lsn;
+  if (commit_lsn > committed_lsn_.load()) {
+    lock_guard guard(mutex_);
+    committed_lsn_.store(commit_lsn);
+    commit_cond_.notify_all();
+  }
+  return rc;
+}
+
+void DiskLogHandler::wait_for_entries()
+{
+  // SYNC_INTERVAL 策略下，即使没有新的日志也要按时醒来刷盘
+  auto timeout = chrono::milliseconds(100);
+  if (commit_policy_ == LogCommitPolicy::SYNC_INTERVAL) {
+    timeout = min(timeout, chrono::milliseconds(sync_interval_ms_));
+  }
+
+  unique_lock lock(mutex_);
+  flusher_waiting_.store(true);
+  flush_cond_.wait_for(lock, timeout, [this]() {
+    return !running_.load() || entry_buffer_.current_lsn() > entry_buffer_.flushed_lsn();
+  });
+  flusher_waiting_.store(false);
+}
+
 void DiskLogHandler::thread_func()
 {
   /*
   这个线程一直不停的循环，检查日志缓冲区中是否有日志在内存中，如果在内存中就刷新到磁盘。
-  这种做法很粗暴简单，与生产数据库的做法不同。生产数据库通常会在内存达到一定量，或者一定时间
-  之后，会刷新一下磁盘。这样做的好处是减少磁盘的IO次数，提高性能。
+  每次循环会把缓冲区中当前所有的日志作为一组，通过一次writev写入文件，再根据提交策略决定
+  是否调用fdatasync，最后唤醒所有等待这组日志的调用者。在上一组日志刷盘的过程中，新产生的
+  日志会在缓冲区中积累起来，在下一次循环中作为新的一组写入，这样多个事务可以共享一次刷盘。
+  缓冲区中没有日志时，线程会在条件变量上等待，写入日志时再唤醒它。
   */
   thread_set_name("LogHandler");
-  LOG_INFO("log handler thread started");
+  LOG_INFO("log handler thread started. commit policy=%s", commit_policy_name(commit_policy_));
 
   LogFileWriter file_writer;
-  
+  last_sync_time_ = chrono::steady_clock::now();
+
   RC rc = RC::SUCCESS;
   while (running_.load() || entry_buffer_.entry_number() > 0) {
     if (!file_writer.valid() || rc == RC::LOG_FILE_FULL) {
       if (rc == RC::LOG_FILE_FULL) {
+        // 切换文件之前，先保证旧文件中的日志都已经持久化了
+        (void)sync_and_commit(file_writer, true /*force*/);
         // 我们在这里判断日志文件是否写满了。
         rc = file_manager_.next_file(file_writer);
       } else {
@@ -198,11 +361,20 @@ void DiskLogHandler::thread_func()
       LOG_WARN("failed to flush log entry buffer. rc=%s", strrc(rc));
     }
 
+    if (flush_count > 0) {
+      (void)sync_and_commit(file_writer, false /*force*/);
+    }
+
     if (flush_count == 0 && rc == RC::SUCCESS) {
-      this_thread::sleep_for(chrono::milliseconds(100));
+      (void)sync_and_commit(file_writer, false /*force*/);
+      wait_for_entries();
       continue;
     }
   }
 
+  if (file_writer.valid()) {
+    (void)sync_and_commit(file_writer, true /*force*/);
+  }
+
   LOG_INFO("log handler thread stopped");
 }
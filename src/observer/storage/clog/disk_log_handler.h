@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/deque.h"
 #include "common/lang/memory.h"
 #include "common/lang/thread.h"
+#include "common/lang/mutex.h"
+#include "common/lang/chrono.h"
 #include "storage/clog/log_module.h"
 #include "storage/clog/log_file.h"
 #include "storage/clog/log_buffer.h"
@@ -27,6 +29,19 @@ See the Mulan PSL v2 for more details. */
 
 class LogReplayer;
 
+/**
+ * @brief 日志提交策略
+ * @ingroup CLog
+ * @details 决定日志写入文件后什么时候调用fdatasync，以及提交者(wait_lsn)什么时候可以返回。
+ * 可以在配置文件的 [CLOG] 中使用 COMMIT_POLICY 和 SYNC_INTERVAL_MS 来设置。
+ */
+enum class LogCommitPolicy
+{
+  SYNC_PER_GROUP,  ///< 每写入一组日志就调用一次fdatasync，日志持久化后提交者才返回。配置值 sync_per_group
+  SYNC_INTERVAL,   ///< 每隔固定时间调用一次fdatasync，日志写入文件后提交者就返回。配置值 sync_interval
+  NO_SYNC,         ///< 从不主动调用fdatasync，由操作系统决定什么时候落盘。配置值 no_sync
+};
+
 /**
  * @brief 对外提供服务的CLog模块
  * @ingroup CLog
@@ -85,6 +100,8 @@ public:
   /**
    * @brief 迭代日志
    * @details 从start_lsn开始，迭代所有的日志。这仅仅是一个辅助函数。
+   * 日志数据直接引用映射到内存中的日志文件，只在回调期间有效。
+   * 只有最后一个日志文件的末尾允许有不完整的日志，其它文件中出现这种情况会返回错误。
    * @param consumer 消费者
    * @param start_lsn 从哪个位置开始迭代
    */
@@ -92,15 +109,34 @@ public:
 
   /**
    * @brief 等待指定的日志刷盘
-   *
+   * @details 调用者会在条件变量上等待，刷盘线程每完成一组日志的提交，就会唤醒所有等待者。
+   * 日志什么时候算是提交了，由提交策略决定，参考 LogCommitPolicy。
    * @param lsn 想要等待的日志
    */
   RC wait_lsn(LSN lsn) override;
 
+  /**
+   * @brief 删除检查点之前的日志文件
+   * @details 正在写入的日志文件不会删除
+   */
+  RC recycle(LSN lsn) override;
+
+  /**
+   * @brief 设置提交策略
+   * @details 需要在 start 之前调用。init 时会从配置文件中读取提交策略。
+   * @param policy 提交策略
+   * @param sync_interval_ms 使用 SYNC_INTERVAL 策略时，两次fdatasync之间的间隔
+   */
+  void set_commit_policy(LogCommitPolicy policy, int sync_interval_ms = 0);
+
+  LogCommitPolicy commit_policy() const { return commit_policy_; }
+
   /// @brief 当前的LSN
   LSN current_lsn() const override { return entry_buffer_.current_lsn(); }
   /// @brief 当前刷新到哪个日志
   LSN current_flushed_lsn() const { return entry_buffer_.flushed_lsn(); }
+  /// @brief 当前已经提交的日志，等待这些日志的调用者可以返回了
+  LSN current_committed_lsn() const { return committed_lsn_.load(); }
 
 private:
   /**
@@ -110,18 +146,51 @@ private:
    * @param[in] module  日志模块
    * @param[in] data    日志数据。具体的数据由各个模块自己定义
    */
-  RC _append(LSN &lsn, LogModule module, vector<char> &&data) override;
+  RC _append(LSN &lsn, LogModule module, span<const char> data) override;
 
 private:
+  /**
+   * @brief 迭代日志文件
+   * @param truncate_torn_tail 如果最后一个日志文件末尾有不完整的日志，是否截断掉。
+   * 回放时需要截断，否则新的日志会追加在这些不完整的数据后面，下次启动时就读不到了
+   */
+  RC iterate_files(function<RC(LogEntry &)> consumer, LSN start_lsn, bool truncate_torn_tail);
+
   /**
    * @brief 刷新日志的线程函数
    */
   void thread_func();
 
+  /**
+   * @brief 按照提交策略将日志文件持久化，并唤醒等待日志提交的调用者
+   * @details 只在刷盘线程中调用
+   * @param writer 当前正在写的日志文件
+   * @param force 是否忽略时间间隔，只要有未持久化的日志就强制调用fdatasync。切换文件或停止时使用
+   */
+  RC sync_and_commit(LogFileWriter &writer, bool force);
+
+  /**
+   * @brief 缓冲区中没有日志时，刷盘线程在这里等待新的日志
+   */
+  void wait_for_entries();
+
 private:
   unique_ptr<thread> thread_;          /// 刷新日志的线程
   atomic_bool        running_{false};  /// 是否还要继续运行
 
+  LogCommitPolicy commit_policy_    = LogCommitPolicy::SYNC_PER_GROUP;  /// 提交策略
+  int             sync_interval_ms_ = 1000;                             /// SYNC_INTERVAL 策略下的刷盘间隔
+
+  mutex              mutex_;                   /// 配合条件变量使用
+  condition_variable flush_cond_;              /// 唤醒刷盘线程
+  condition_variable commit_cond_;             /// 唤醒等待日志提交的调用者
+  atomic_bool        flusher_waiting_{false};  /// 刷盘线程是否在等待新的日志
+  atomic<LSN>        committed_lsn_{0};        /// 已经提交的日志
+
+  /// 下面两个字段只在刷盘线程中访问
+  LSN                              synced_lsn_ = 0;  /// 已经调用过fdatasync的最大LSN
+  chrono::steady_clock::time_point last_sync_time_;  /// 上次调用fdatasync的时间
+
   LogFileManager file_manager_;  /// 管理所有的日志文件
   LogEntryBuffer entry_buffer_;  /// 缓存日志
 
@@ -13,12 +13,16 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/clog/integrated_log_replayer.h"
+#include "common/thread/thread_util.h"
 #include "storage/clog/log_entry.h"
 
+using namespace common;
+
 IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm)
     : buffer_pool_log_replayer_(bpm),
       record_log_replayer_(bpm),
       bplus_tree_log_replayer_(bpm),
+      hash_index_log_replayer_(bpm),
       trx_log_replayer_(nullptr)
 {}
 
@@ -26,23 +30,195 @@ IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm, unique_ptr<
     : buffer_pool_log_replayer_(bpm),
       record_log_replayer_(bpm),
       bplus_tree_log_replayer_(bpm),
+      hash_index_log_replayer_(bpm),
       trx_log_replayer_(std::move(trx_log_replayer))
 {}
 
+IntegratedLogReplayer::~IntegratedLogReplayer() { stop_workers(); }
+
 RC IntegratedLogReplayer::replay(const LogEntry &entry)
+{
+  if (workers_.empty()) {
+    switch (entry.module().id()) {
+      case LogModule::Id::BUFFER_POOL: return buffer_pool_log_replayer_.replay(entry);
+      case LogModule::Id::RECORD_MANAGER: return record_log_replayer_.replay(entry);
+      case LogModule::Id::BPLUS_TREE: return bplus_tree_log_replayer_.replay(entry);
+      case LogModule::Id::HASH_INDEX: return hash_index_log_replayer_.replay(entry);
+      case LogModule::Id::TRANSACTION: return trx_log_replayer_->replay(entry);
+      default: return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  RC rc = worker_error_.load();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const int worker_num = static_cast<int>(workers_.size());
+  switch (entry.module().id()) {
+    case LogModule::Id::BUFFER_POOL: {
+      if (entry.payload_size() == sizeof(BufferPoolLogEntry)) {
+        auto log = reinterpret_cast<const BufferPoolLogEntry *>(entry.data());
+        if (BufferPoolOperation(log->operation_type).type() == BufferPoolOperation::Type::DEALLOCATE) {
+          // 页面释放之后就不能再读取了，要先把这个页面前面的日志都回放完
+          rc = wait_workers_idle();
+          if (OB_FAIL(rc)) {
+            return rc;
+          }
+        }
+      }
+      return buffer_pool_log_replayer_.replay(entry);
+    }
+
+    case LogModule::Id::RECORD_MANAGER: {
+      if (entry.payload_size() < RecordLogHeader::SIZE) {
+        return record_log_replayer_.replay(entry);  // 让 record manager 自己报告错误
+      }
+      auto   *header = reinterpret_cast<const RecordLogHeader *>(entry.data());
+      uint64_t key = (static_cast<uint64_t>(header->buffer_pool_id) << 32) | static_cast<uint32_t>(header->page_num);
+      return dispatch(static_cast<int>(hash<uint64_t>()(key) % worker_num), entry);
+    }
+
+    case LogModule::Id::BPLUS_TREE:
+    case LogModule::Id::HASH_INDEX: {
+      // 两种索引日志的开头都是 buffer pool id，同一个索引文件的日志由同一个线程按顺序回放
+      int32_t buffer_pool_id = 0;
+      if (entry.payload_size() >= static_cast<int>(sizeof(buffer_pool_id))) {
+        memcpy(&buffer_pool_id, entry.data(), sizeof(buffer_pool_id));
+      }
+      return dispatch(static_cast<int>(hash<int32_t>()(buffer_pool_id) % worker_num), entry);
+    }
+
+    case LogModule::Id::TRANSACTION: return trx_log_replayer_->replay(entry);
+    default: return RC::INVALID_ARGUMENT;
+  }
+}
+
+RC IntegratedLogReplayer::replay_page_entry(const LogEntry &entry)
 {
   switch (entry.module().id()) {
-    case LogModule::Id::BUFFER_POOL: return buffer_pool_log_replayer_.replay(entry);
     case LogModule::Id::RECORD_MANAGER: return record_log_replayer_.replay(entry);
     case LogModule::Id::BPLUS_TREE: return bplus_tree_log_replayer_.replay(entry);
-    case LogModule::Id::TRANSACTION: return trx_log_replayer_->replay(entry);
+    case LogModule::Id::HASH_INDEX: return hash_index_log_replayer_.replay(entry);
     default: return RC::INVALID_ARGUMENT;
   }
 }
 
+RC IntegratedLogReplayer::start_parallel_redo(int worker_num)
+{
+  if (!workers_.empty()) {
+    LOG_WARN("parallel redo has been started");
+    return RC::INTERNAL;
+  }
+
+  if (worker_num <= 1) {
+    return RC::SUCCESS;
+  }
+
+#ifdef CONCURRENCY
+  for (int i = 0; i < worker_num; i++) {
+    auto worker           = make_unique<RedoWorker>();
+    worker->thread_handle = make_unique<thread>(&IntegratedLogReplayer::worker_func, this, std::ref(*worker));
+    workers_.push_back(std::move(worker));
+  }
+  LOG_INFO("parallel redo started. worker num=%d", worker_num);
+#else
+  // 非并发编译时很多锁什么都不做，buffer pool 不能被多个线程同时访问
+  LOG_INFO("parallel redo is not supported without CONCURRENCY");
+#endif
+  return RC::SUCCESS;
+}
+
+RC IntegratedLogReplayer::dispatch(int worker_index, const LogEntry &entry)
+{
+  // 日志文件迭代时日志数据直接引用映射的文件内存，回调返回后就失效了，这里需要复制一份
+  LogEntry     copied_entry;
+  vector<char> data(entry.payload().begin(), entry.payload().end());
+  RC           rc = copied_entry.init(entry.lsn(), entry.module(), std::move(data));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  RedoWorker &worker = *workers_[worker_index];
+  unique_lock lock(worker.lock);
+  worker.not_full_cond.wait(lock, [&worker]() { return worker.entries.size() < static_cast<size_t>(MAX_QUEUED_ENTRIES); });
+  worker.entries.push_back(std::move(copied_entry));
+  worker.pending++;
+  worker.not_empty_cond.notify_one();
+  return RC::SUCCESS;
+}
+
+RC IntegratedLogReplayer::wait_workers_idle()
+{
+  for (unique_ptr<RedoWorker> &worker : workers_) {
+    unique_lock lock(worker->lock);
+    worker->not_full_cond.wait(lock, [&worker]() { return worker->pending == 0; });
+  }
+  return worker_error_.load();
+}
+
+void IntegratedLogReplayer::stop_workers()
+{
+  for (unique_ptr<RedoWorker> &worker : workers_) {
+    lock_guard guard(worker->lock);
+    worker->running = false;
+    worker->not_empty_cond.notify_all();
+  }
+
+  for (unique_ptr<RedoWorker> &worker : workers_) {
+    worker->thread_handle->join();
+  }
+  workers_.clear();
+}
+
+void IntegratedLogReplayer::worker_func(RedoWorker &worker)
+{
+  thread_set_name("RedoWorker");
+
+  unique_lock lock(worker.lock);
+  while (true) {
+    worker.not_empty_cond.wait(lock, [&worker]() { return !worker.entries.empty() || !worker.running; });
+    if (worker.entries.empty()) {
+      break;  // 退出前会先把所有日志回放完
+    }
+
+    LogEntry entry = std::move(worker.entries.front());
+    worker.entries.pop_front();
+    lock.unlock();
+
+    // 出错之后剩下的日志就不再回放了，分发线程会在下一次分发时返回错误
+    if (OB_SUCC(worker_error_.load())) {
+      RC rc = replay_page_entry(entry);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to replay log entry. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+        RC expected = RC::SUCCESS;
+        worker_error_.compare_exchange_strong(expected, rc);
+      }
+    }
+
+    lock.lock();
+    worker.pending--;
+    worker.not_full_cond.notify_all();
+  }
+}
+
+RC IntegratedLogReplayer::finish_page_redo()
+{
+  RC rc = wait_workers_idle();
+  stop_workers();
+  return rc;
+}
+
 RC IntegratedLogReplayer::on_done()
 {
-  RC rc = buffer_pool_log_replayer_.on_done();
+  // 事务回滚会修改页面，要等所有页面都回放完成
+  RC rc = finish_page_redo();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to replay page logs in parallel. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = buffer_pool_log_replayer_.on_done();
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to do buffer pool log replay. rc=%s", strrc(rc));
     return rc;
@@ -59,6 +235,12 @@ RC IntegratedLogReplayer::on_done()
     return rc;
   }
 
+  rc = hash_index_log_replayer_.on_done();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to do hash index log replay. rc=%s", strrc(rc));
+    return rc;
+  }
+
   rc = trx_log_replayer_->on_done();
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to do mvcc trx log replay. rc=%s", strrc(rc));
@@ -14,10 +14,17 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/atomic.h"
+#include "common/lang/deque.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
+#include "common/lang/vector.h"
+#include "storage/clog/log_entry.h"
 #include "storage/clog/log_replayer.h"
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/record/record_log.h"
 #include "storage/index/bplus_tree_log.h"
+#include "storage/index/extendible_hash_log.h"
 #include "storage/trx/mvcc_trx_log.h"
 
 class BufferPoolManager;
@@ -25,7 +32,14 @@ class BufferPoolManager;
 /**
  * @brief 整体日志回放类
  * @ingroup Clog
- * @details 负责回放所有日志，是其它各模块日志回放的分发器
+ * @details 负责回放所有日志，是其它各模块日志回放的分发器。
+ * 默认在调用 replay 的线程中逐条回放。调用 start_parallel_redo 之后，页面相关的日志(record manager、
+ * B+树)会按照页面分发给多个回放线程，同一个页面的日志总是由同一个线程按顺序回放：
+ * - record manager 的日志只修改一个页面，按照 (buffer_pool_id, page_num) 分发；
+ * - B+树的一条日志可能修改同一个文件的多个页面，按照 buffer_pool_id 分发；
+ * - buffer pool 的日志修改文件头，在当前线程中回放，后面的页面日志才能看到新分配的页面。
+ *   释放页面之前要等回放线程把前面的日志都回放完；
+ * - 事务日志只修改内存中的事务状态，在当前线程中按顺序回放。
  */
 class IntegratedLogReplayer : public LogReplayer
 {
@@ -44,7 +58,7 @@ public:
    * 区别于另一个构造函数，这个构造函数可以指定不同的事务日志回放器。比如进程启动时可以指定选择使用VacuousTrx还是MvccTrx。
    */
   IntegratedLogReplayer(BufferPoolManager &bpm, unique_ptr<LogReplayer> trx_log_replayer);
-  virtual ~IntegratedLogReplayer() = default;
+  virtual ~IntegratedLogReplayer();
 
   //! @copydoc LogReplayer::replay
   RC replay(const LogEntry &entry) override;
@@ -52,9 +66,57 @@ public:
   //! @copydoc LogReplayer::on_done
   RC on_done() override;
 
+  /**
+   * @brief 启动并行回放
+   * @details 需要在回放第一条日志之前调用。on_done 时会等待所有日志回放完成并停止回放线程。
+   * 只有在 CONCURRENCY 模式下编译才支持，否则仍然串行回放。
+   * @param worker_num 回放线程的个数，小于等于1时串行回放
+   */
+  RC start_parallel_redo(int worker_num);
+
+  /**
+   * @brief 等待页面相关的日志全部回放完成，并停止回放线程
+   * @details on_done 时也会调用，可以重复调用。
+   * 调用者可以在这之后、事务回滚之前刷新内存中缓存的页面内容，比如B+树的文件头
+   */
+  RC finish_page_redo();
+
+private:
+  /**
+   * @brief 一个回放线程，以及分发给它的日志
+   */
+  struct RedoWorker
+  {
+    mutex              lock;
+    condition_variable not_empty_cond;   ///< 有新日志或者需要退出时唤醒回放线程
+    condition_variable not_full_cond;    ///< 队列不满或者回放完成时唤醒分发线程
+    deque<LogEntry>    entries;          ///< 等待回放的日志
+    int                pending = 0;      ///< 还没有回放完成的日志个数，包括正在回放的
+    bool               running = true;
+    unique_ptr<thread> thread_handle;
+  };
+
+  /// 回放一条页面相关的日志
+  RC replay_page_entry(const LogEntry &entry);
+
+  /// 把日志分发给对应的回放线程，队列满时等待
+  RC dispatch(int worker_index, const LogEntry &entry);
+
+  /// 等待所有回放线程把已经分发的日志回放完成
+  RC wait_workers_idle();
+
+  void stop_workers();
+  void worker_func(RedoWorker &worker);
+
+  static constexpr int MAX_QUEUED_ENTRIES = 4096;  ///< 每个回放线程最多排队的日志数，限制内存使用
+
 private:
-  BufferPoolLogReplayer   buffer_pool_log_replayer_;  ///< 缓冲池日志回放器
-  RecordLogReplayer       record_log_replayer_;       ///< record manager 日志回放器
-  BplusTreeLogReplayer    bplus_tree_log_replayer_;   ///< bplus tree 日志回放器
-  unique_ptr<LogReplayer> trx_log_replayer_;          ///< trx 日志回放器
+  BufferPoolLogReplayer     buffer_pool_log_replayer_;  ///< 缓冲池日志回放器
+  RecordLogReplayer         record_log_replayer_;       ///< record manager 日志回放器
+  BplusTreeLogReplayer      bplus_tree_log_replayer_;   ///< bplus tree 日志回放器
+  ExtendibleHashLogReplayer hash_index_log_replayer_;   ///< 哈希索引日志回放器
+  unique_ptr<LogReplayer>   trx_log_replayer_;          ///< trx 日志回放器
+
+  vector<unique_ptr<RedoWorker>> workers_;                     ///< 并行回放的线程，为空时串行回放
+  atomic<RC>                     worker_error_{RC::SUCCESS};  ///< 回放线程遇到的第一个错误
 };
\ No newline at end of file
@@ -14,7 +14,10 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/clog/log_buffer.h"
 #include "storage/clog/log_file.h"
-#include "common/lang/chrono.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
+#include "common/lang/thread.h"
+#include "common/log/log.h"
 
 using namespace common;
 
@@ -26,81 +29,199 @@ RC LogEntryBuffer::init(LSN lsn, int32_t max_bytes /*= 0*/)
   if (max_bytes > 0) {
     max_bytes_ = max_bytes;
   }
+
+  // 至少要能放下一条最大的日志，否则这条日志永远也写不进来
+  int64_t capacity = 1;
+  while (capacity < max(static_cast<int64_t>(max_bytes_), static_cast<int64_t>(LogEntry::max_size()))) {
+    capacity <<= 1;
+  }
+
+  if (nullptr == buffer_ || capacity_ != capacity) {
+    buffer_   = make_unique<char[]>(capacity);
+    capacity_ = capacity;
+  }
+
+  reserved_pos_.store(0);
+  published_pos_.store(0);
+  flushed_pos_.store(0);
   return RC::SUCCESS;
 }
 
+RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, span<const char> data)
+{
+  return append(lsn, LogModule(module_id), data);
+}
+
 RC LogEntryBuffer::append(LSN &lsn, LogModule::Id module_id, vector<char> &&data)
 {
-  return append(lsn, LogModule(module_id), std::move(data));
+  return append(lsn, LogModule(module_id), span<const char>(data.data(), data.size()));
 }
 
 RC LogEntryBuffer::append(LSN &lsn, LogModule module, vector<char> &&data)
 {
-  /// 控制当前buffer使用的内存
-  /// 简单粗暴，强制原地等待
-  /// 但是如果当前想要新插入的日志比较大，不会做控制。所以理论上容纳的最大buffer内存是2*max_bytes_
-  while (bytes_.load() >= max_bytes_) {
-    this_thread::sleep_for(chrono::milliseconds(10));
+  return append(lsn, module, span<const char>(data.data(), data.size()));
+}
+
+RC LogEntryBuffer::append(LSN &lsn, LogModule module, span<const char> data)
+{
+  if (nullptr == buffer_) {
+    LOG_WARN("log entry buffer is not initialized");
+    return RC::INTERNAL;
   }
 
-  LogEntry entry;
-  RC rc = entry.init(lsn, module, std::move(data));
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to init log entry. rc=%s", strrc(rc));
-    return rc;
+  if (static_cast<int64_t>(data.size()) > LogEntry::max_payload_size()) {
+    LOG_DEBUG("log entry size is too large. size=%d, max_payload_size=%d", data.size(), LogEntry::max_payload_size());
+    return RC::INVALID_ARGUMENT;
   }
 
-  lock_guard guard(mutex_);
-  lsn = ++current_lsn_;
-  entry.set_lsn(lsn);
+  // 预留空间。预留之后，这段空间就只属于当前线程
+  const int64_t entry_size = LogHeader::SIZE + static_cast<int64_t>(data.size());
+  const int64_t begin_pos  = reserved_pos_.fetch_add(entry_size);
+  const int64_t end_pos    = begin_pos + entry_size;
 
-  entries_.push_back(std::move(entry));
-  bytes_ += entry.total_size();
+  wait_for_space(end_pos);
+
+  // 先拷贝日志数据并计算数据部分的校验码，这一步多个线程可以并行
+  copy_in(begin_pos + LogHeader::SIZE, data.data(), static_cast<int64_t>(data.size()));
+  const uint32_t payload_checksum = LogHeader::payload_checksum(data);
+
+  // 按照预留的顺序发布，保证LSN与日志在缓冲区中的顺序相同。
+  // 前面的日志通常很快就会发布，先自旋一会儿；如果前面的线程被调度出去了，就在futex上等待，
+  // 避免大量线程空转抢占CPU，反而让前面的线程没有机会运行
+  for (int spin = 0; true; spin++) {
+    const int64_t published_pos = published_pos_.load();
+    if (published_pos == begin_pos) {
+      break;
+    }
+
+    if (spin < 64) {
+      continue;
+    }
+    published_pos_.wait(published_pos);
+  }
+
+  LogHeader header;
+  header.lsn       = current_lsn_.load() + 1;
+  header.size      = static_cast<int32_t>(data.size());
+  header.module_id = module.index();
+  header.set_checksum(payload_checksum);
+  copy_in(begin_pos, &header, LogHeader::SIZE);
+
+  current_lsn_.store(header.lsn);
+  published_pos_.store(end_pos);
+  published_pos_.notify_all();
+
+  lsn = header.lsn;
   return RC::SUCCESS;
 }
 
+void LogEntryBuffer::wait_for_space(int64_t end_pos)
+{
+  auto has_space = [this, end_pos]() { return end_pos - flushed_pos_.load() <= capacity_; };
+  if (has_space()) {
+    return;
+  }
+
+  // 先登记为等待者再检查条件，刷盘线程推进 flushed_pos_ 之后检查等待者，这样不会丢失唤醒
+  unique_lock lock(mutex_);
+  space_waiters_.fetch_add(1);
+  space_cond_.wait(lock, has_space);
+  space_waiters_.fetch_sub(1);
+}
+
+void LogEntryBuffer::copy_in(int64_t pos, const void *data, int64_t size)
+{
+  const int64_t offset = pos & (capacity_ - 1);
+  const int64_t first  = min(size, capacity_ - offset);
+  memcpy(buffer_.get() + offset, data, first);
+  if (first < size) {
+    memcpy(buffer_.get(), static_cast<const char *>(data) + first, size - first);
+  }
+}
+
+void LogEntryBuffer::copy_out(int64_t pos, void *data, int64_t size) const
+{
+  const int64_t offset = pos & (capacity_ - 1);
+  const int64_t first  = min(size, capacity_ - offset);
+  memcpy(data, buffer_.get() + offset, first);
+  if (first < size) {
+    memcpy(static_cast<char *>(data) + first, buffer_.get(), size - first);
+  }
+}
+
 RC LogEntryBuffer::flush(LogFileWriter &writer, int &count)
 {
   count = 0;
+  if (nullptr == buffer_) {
+    return RC::SUCCESS;
+  }
 
-  while (entry_number() > 0) {
-    LogEntry entry;
-    {
-      lock_guard guard(mutex_);
-      if (entries_.empty()) {
-        break;
-      }
-
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      entry = std::move(entries_.front());
-      ASSERT(entry.payload_size() > 0 && entry.lsn() > 0, "invalid log entry");
-      entries_.pop_front();
-      bytes_ -= entry.total_size();
+  // 只有刷盘线程会修改 flushed_pos_ 和 flushed_lsn_
+  const int64_t begin_pos     = flushed_pos_.load();
+  const int64_t published_pos = published_pos_.load();
+
+  // 找出当前文件能够容纳的所有日志，作为一组写入文件
+  LSN     first_lsn = 0;
+  LSN     last_lsn  = flushed_lsn_.load();
+  int64_t end_pos   = begin_pos;
+  bool    file_full = false;
+  while (end_pos < published_pos) {
+    LogHeader header;
+    copy_out(end_pos, &header, LogHeader::SIZE);
+    ASSERT(header.lsn == last_lsn + 1 && header.size >= 0, "invalid log entry. last lsn=%ld, header=%s",
+           last_lsn, header.to_string().c_str());
+    if (header.lsn > writer.end_lsn()) {
+      file_full = true;
+      break;
     }
-    
-    RC rc = writer.write(entry);
-    if (OB_FAIL(rc)) {
-      lock_guard guard(mutex_);
-      entries_.emplace_front(std::move(entry));
-      LogEntry &front_entry = entries_.front();
-      ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      return rc;
-    } else {
-      ++count;
-      flushed_lsn_ = entry.lsn();
+
+    if (0 == first_lsn) {
+      first_lsn = header.lsn;
     }
+    last_lsn = header.lsn;
+    end_pos += LogHeader::SIZE + header.size;
+    count++;
   }
-  
-  return RC::SUCCESS;
+
+  if (0 == count) {
+    return file_full ? RC::LOG_FILE_FULL : RC::SUCCESS;
+  }
+
+  // 这组日志在缓冲区中是连续的，如果回绕了就是两段
+  struct iovec  iovs[2];
+  int           iov_count = 0;
+  const int64_t offset    = begin_pos & (capacity_ - 1);
+  const int64_t size      = end_pos - begin_pos;
+  const int64_t first     = min(size, capacity_ - offset);
+  iovs[iov_count++]       = {buffer_.get() + offset, static_cast<size_t>(first)};
+  if (first < size) {
+    iovs[iov_count++] = {buffer_.get(), static_cast<size_t>(size - first)};
+  }
+
+  RC rc = writer.write(span<struct iovec>(iovs, iov_count), first_lsn, last_lsn);
+  if (OB_FAIL(rc)) {
+    // 写失败了，数据还在缓冲区中，下次再重新写
+    count = 0;
+    return rc;
+  }
+
+  flushed_lsn_.store(last_lsn);
+  flushed_pos_.store(end_pos);
+
+  if (space_waiters_.load() > 0) {
+    lock_guard guard(mutex_);
+    space_cond_.notify_all();
+  }
+
+  return file_full ? RC::LOG_FILE_FULL : RC::SUCCESS;
 }
 
 int64_t LogEntryBuffer::bytes() const
 {
-  return bytes_.load();
+  return published_pos_.load() - flushed_pos_.load();
 }
 
 int32_t LogEntryBuffer::entry_number() const
 {
-  return entries_.size();
+  return static_cast<int32_t>(current_lsn_.load() - flushed_lsn_.load());
 }
@@ -18,7 +18,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/types.h"
 #include "common/lang/mutex.h"
 #include "common/lang/vector.h"
-#include "common/lang/deque.h"
+#include "common/lang/span.h"
+#include "common/lang/memory.h"
 #include "common/lang/atomic.h"
 #include "storage/clog/log_module.h"
 #include "storage/clog/log_entry.h"
@@ -29,8 +30,15 @@ class LogFileWriter;
  * @brief 日志数据缓冲区
  * @ingroup CLog
  * @details 缓存一部分日志在内存中而不是直接写入磁盘。
- * 这里的缓存没有考虑高性能操作，比如使用预分配内存、环形缓冲池等。
- * 在生产数据库中，通常会使用预分配内存形式的缓存来提高性能，并且可以减少内存碎片。
+ * 缓冲区是一块预分配的环形内存，日志按照"日志头+日志数据"的格式连续存放，与日志文件中的格式相同。
+ * 写日志时不加锁：
+ * 1. 使用 fetch_add 在环形缓冲区中预留一段空间；
+ * 2. 将日志数据直接拷贝到预留的空间中并计算数据部分的校验码，多个线程的拷贝可以并行进行；
+ * 3. 按照预留的顺序发布日志：等前面的日志发布之后，分配LSN、填写日志头，再推进 published_pos_。
+ * 由于LSN是按照日志条数递增的，LSN与日志在缓冲区中的位置需要保持相同的顺序，所以发布这一步是按顺序进行的，
+ * 不过它只需要写一个日志头，等待时间很短。
+ * 刷盘时，直接把 [flushed_pos_, published_pos_) 这段连续的内存(环形回绕时是两段)交给一次writev。
+ * 缓冲区写满时，写日志的线程在条件变量上等待刷盘线程释放空间。
  */
 class LogEntryBuffer
 {
@@ -38,17 +46,28 @@ public:
   LogEntryBuffer()  = default;
   ~LogEntryBuffer() = default;
 
+  /**
+   * @brief 初始化
+   * @param lsn 当前最大的LSN，新的日志从lsn+1开始
+   * @param max_bytes 缓冲区大小。会向上取整到2的幂，并且至少能容纳一条最大的日志
+   */
   RC init(LSN lsn, int32_t max_bytes = 0);
 
   /**
    * @brief 在缓冲区中追加一条日志
+   * @details 日志数据会拷贝到缓冲区中。如果缓冲区没有足够的空间，会一直等待刷盘线程释放空间。
    */
+  RC append(LSN &lsn, LogModule::Id module_id, span<const char> data);
+  RC append(LSN &lsn, LogModule module, span<const char> data);
   RC append(LSN &lsn, LogModule::Id module_id, vector<char> &&data);
   RC append(LSN &lsn, LogModule module, vector<char> &&data);
 
   /**
    * @brief 刷新缓冲区中的日志到磁盘
-   *
+   * @details 缓冲区中当前文件能够容纳的日志会作为一组，通过一次写操作写入文件。
+   * 如果还有日志因为当前文件写满而没有写入，返回 LOG_FILE_FULL。
+   * 这里只负责写文件，不负责将文件持久化(fdatasync)。
+   * 同一时间只能有一个线程调用flush。
    * @param file_handle 使用它来写文件
    * @param count 刷了多少条日志
    */
@@ -67,13 +86,39 @@ public:
   LSN current_lsn() const { return current_lsn_.load(); }
   LSN flushed_lsn() const { return flushed_lsn_.load(); }
 
+  /**
+   * @brief 环形缓冲区的容量
+   */
+  int64_t capacity() const { return capacity_; }
+
+private:
+  /**
+   * @brief 等待缓冲区中有足够的空间，可以写入到 end_pos 这个位置
+   */
+  void wait_for_space(int64_t end_pos);
+
+  /// @brief 将数据拷贝到环形缓冲区的逻辑位置 pos 处，处理回绕
+  void copy_in(int64_t pos, const void *data, int64_t size);
+  /// @brief 从环形缓冲区的逻辑位置 pos 处拷贝数据出来，处理回绕
+  void copy_out(int64_t pos, void *data, int64_t size) const;
+
 private:
-  mutex           mutex_;  /// 当前数据结构一定会在多线程中访问，所以强制使用有效的锁，而不是有条件生效的common::Mutex
-  deque<LogEntry> entries_;  /// 日志缓冲区
-  atomic<int64_t> bytes_;    /// 当前缓冲区中的日志数据大小
+  unique_ptr<char[]> buffer_;        /// 环形缓冲区
+  int64_t            capacity_ = 0;  /// 缓冲区大小，2的幂
+
+  /// 下面几个位置都是逻辑位置，只增不减，对 capacity_ 取模之后才是在缓冲区中的位置
+  /// 放在不同的cache line上，避免写日志的线程与刷盘线程之间的伪共享
+  alignas(64) atomic<int64_t> reserved_pos_{0};   /// 已经预留的位置
+  alignas(64) atomic<int64_t> published_pos_{0};  /// 已经发布的位置，这之前的日志都是完整的
+  alignas(64) atomic<int64_t> flushed_pos_{0};    /// 已经写入文件的位置，这之前的空间可以重用
 
-  atomic<LSN> current_lsn_{0};
+  alignas(64) atomic<LSN> current_lsn_{0};
   atomic<LSN> flushed_lsn_{0};
 
+  /// 缓冲区满时等待空间使用。当前数据结构一定会在多线程中访问，所以强制使用有效的锁，而不是有条件生效的common::Mutex
+  mutex              mutex_;
+  condition_variable space_cond_;
+  atomic<int32_t>    space_waiters_{0};  /// 有多少个线程在等待空间，刷盘线程据此判断是否需要唤醒
+
   int32_t max_bytes_ = 4 * 1024 * 1024;  /// 缓冲区最大字节数
 };
@@ -12,21 +12,42 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/01/31
 //
 
+#include <cstddef>
 #include <sstream>
 #include "storage/clog/log_entry.h"
 #include "common/log/log.h"
+#include "common/math/crc.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // struct LogHeader
 
 const int32_t LogHeader::SIZE = sizeof(LogHeader);
 
+uint32_t LogHeader::payload_checksum(span<const char> payload)
+{
+  return crc32(payload.data(), static_cast<unsigned int>(payload.size()));
+}
+
+uint32_t LogHeader::calc_checksum(uint32_t payload_checksum) const
+{
+  // 校验码字段之前的日志头字段
+  return crc32(payload_checksum, reinterpret_cast<const char *>(this), offsetof(LogHeader, checksum));
+}
+
+void LogHeader::set_checksum(uint32_t payload_checksum) { checksum = calc_checksum(payload_checksum); }
+
+bool LogHeader::check(span<const char> payload) const
+{
+  return checksum == calc_checksum(payload_checksum(payload));
+}
+
 string LogHeader::to_string() const
 {
   stringstream ss;
   ss << "lsn=" << lsn 
      << ", size=" << size 
-     << ", module_id=" << module_id << ":" << LogModule(module_id).name();
+     << ", module_id=" << module_id << ":" << LogModule(module_id).name()
+     << ", checksum=" << checksum;
 
   return ss.str();
 }
@@ -43,9 +64,11 @@ LogEntry::LogEntry(LogEntry &&other)
 {
   header_ = other.header_;
   data_ = std::move(other.data_);
+  payload_ = other.payload_;  // vector 移动之后内存地址不变
 
   other.header_.lsn = 0;
   other.header_.size = 0;
+  other.payload_ = nullptr;
 }
 
 LogEntry &LogEntry::operator=(LogEntry &&other)
@@ -56,9 +79,11 @@ LogEntry &LogEntry::operator=(LogEntry &&other)
 
   header_ = other.header_;
   data_ = std::move(other.data_);
+  payload_ = other.payload_;
 
   other.header_.lsn = 0;
   other.header_.size = 0;
+  other.payload_ = nullptr;
 
   return *this;
 }
@@ -79,9 +104,30 @@ RC LogEntry::init(LSN lsn, LogModule module, vector<char> &&data)
   header_.module_id = module.index();
   header_.size = static_cast<int32_t>(data.size());
   data_ = std::move(data);
+  payload_ = data_.data();
+  header_.set_checksum(LogHeader::payload_checksum(payload()));
   return RC::SUCCESS;
 }
 
+RC LogEntry::init_view(const LogHeader &header, span<const char> payload)
+{
+  if (header.size != static_cast<int32_t>(payload.size()) || header.size > max_payload_size()) {
+    LOG_DEBUG("invalid log entry view. header=%s, payload size=%ld", header.to_string().c_str(), payload.size());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  header_ = header;
+  data_.clear();
+  payload_ = payload.data();
+  return RC::SUCCESS;
+}
+
+void LogEntry::set_lsn(LSN lsn)
+{
+  header_.lsn = lsn;
+  header_.set_checksum(LogHeader::payload_checksum(payload()));
+}
+
 string LogEntry::to_string() const
 {
   return header_.to_string();
@@ -20,20 +20,37 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/vector.h"
 #include "common/lang/string.h"
 #include "common/lang/memory.h"
+#include "common/lang/span.h"
 
 /**
  * @brief 描述一条日志头
  * @ingroup CLog
+ * @details 校验码覆盖日志数据和日志头中校验码之前的字段，读日志文件时用来识别写了一半的日志。
+ * 日志数据的校验码可以在分配LSN之前单独计算，见 LogEntryBuffer::append。
  */
 struct LogHeader final
 {
-  LSN     lsn;        /// 日志序列号 log sequence number
-  int32_t size;       /// 日志数据大小，不包含日志头
-  int32_t module_id;  /// 日志模块编号
+  LSN      lsn;           /// 日志序列号 log sequence number
+  int32_t  size;          /// 日志数据大小，不包含日志头
+  int32_t  module_id;     /// 日志模块编号
+  uint32_t checksum = 0;  /// 校验码
+  int32_t  reserved = 0;  /// 保留字段，保持8字节对齐
 
   static const int32_t SIZE;  /// 日志头大小
 
+  /// @brief 计算日志数据部分的校验码
+  static uint32_t payload_checksum(span<const char> payload);
+
+  /// @brief 根据日志数据的校验码，计算并设置整条日志的校验码。需要先设置好其它字段
+  void set_checksum(uint32_t payload_checksum);
+
+  /// @brief 校验日志头和日志数据是否完整
+  bool check(span<const char> payload) const;
+
   string to_string() const;
+
+private:
+  uint32_t calc_checksum(uint32_t payload_checksum) const;
 };
 
 /**
@@ -70,12 +87,23 @@ public:
   RC init(LSN lsn, LogModule::Id module_id, vector<char> &&data);
   RC init(LSN lsn, LogModule module, vector<char> &&data);
 
+  /**
+   * @brief 不拷贝日志数据，直接引用外部的内存
+   * @details 读日志文件时，日志数据直接指向映射到内存中的文件，只在迭代回调期间有效。
+   * 如果需要保存下来，要自己复制一份。
+   */
+  RC init_view(const LogHeader &header, span<const char> payload);
+
   const LogHeader &header() const { return header_; }
-  const char      *data() const { return data_.data(); }
+  const char      *data() const { return payload_; }
+  span<const char> payload() const { return span<const char>(payload_, header_.size); }
   int32_t          payload_size() const { return header_.size; }
   int32_t          total_size() const { return LogHeader::SIZE + header_.size; }
 
-  void set_lsn(LSN lsn) { header_.lsn = lsn; }
+  /// @brief 是否引用的外部内存
+  bool is_view() const { return header_.size > 0 && payload_ != data_.data(); }
+
+  void set_lsn(LSN lsn);
 
   LSN       lsn() const { return header_.lsn; }
   LogModule module() const { return LogModule(header_.module_id); }
@@ -84,6 +112,7 @@ public:
   string to_string() const;
 
 private:
-  LogHeader    header_;  /// 日志头
-  vector<char> data_;    /// 日志数据
+  LogHeader    header_;             /// 日志头
+  vector<char> data_;               /// 日志数据，引用外部内存时为空
+  const char  *payload_ = nullptr;  /// 指向日志数据，可能是 data_ 也可能是外部内存
 };
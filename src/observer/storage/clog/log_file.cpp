@@ -13,6 +13,10 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 
 #include "common/lang/string_view.h"
 #include "common/lang/charconv.h"
@@ -23,8 +27,12 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
+LogFileReader::~LogFileReader() { (void)this->close(); }
+
 RC LogFileReader::open(const char *filename)
 {
+  (void)this->close();
+
   filename_ = filename;
 
   fd_ = ::open(filename, O_RDONLY);
@@ -33,7 +41,28 @@ RC LogFileReader::open(const char *filename)
     return RC::FILE_OPEN;
   }
 
-  LOG_INFO("open file success. filename=%s, fd=%d", filename, fd_);
+  struct stat st;
+  if (0 != fstat(fd_, &st)) {
+    LOG_WARN("stat file failed. filename=%s, error=%s", filename, strerror(errno));
+    (void)this->close();
+    return RC::IOERR_READ;
+  }
+
+  file_size_ = st.st_size;
+  if (file_size_ > 0) {
+    void *data = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (MAP_FAILED == data) {
+      LOG_WARN("mmap file failed. filename=%s, size=%ld, error=%s", filename, file_size_, strerror(errno));
+      (void)this->close();
+      return RC::IOERR_READ;
+    }
+
+    // 日志总是从头到尾顺序读取的
+    (void)madvise(data, file_size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(data);
+  }
+
+  LOG_INFO("open file success. filename=%s, fd=%d, size=%ld", filename, fd_, file_size_);
   return RC::SUCCESS;
 }
 
@@ -43,102 +72,77 @@ RC LogFileReader::close()
     return RC::FILE_NOT_OPENED;
   }
 
+  if (data_ != nullptr) {
+    munmap(const_cast<char *>(data_), file_size_);
+    data_ = nullptr;
+  }
+
   ::close(fd_);
-  fd_ = -1;
+  fd_         = -1;
+  file_size_  = 0;
+  valid_size_ = 0;
+  torn_       = false;
   return RC::SUCCESS;
 }
 
-RC LogFileReader::iterate(function<RC(LogEntry &)> callback, LSN start_lsn /*=0*/)
+bool LogFileReader::parse_entry(int64_t offset, LogHeader &header, span<const char> &payload) const
 {
-  RC rc = skip_to(start_lsn);
-  if (OB_FAIL(rc)) {
-    return rc;
+  if (file_size_ - offset < LogHeader::SIZE) {
+    return false;
   }
 
-  LogHeader header;
-  while (true) {
-    int ret = readn(fd_, reinterpret_cast<char *>(&header), LogHeader::SIZE);
-    if (0 != ret) {
-      if (-1 == ret) {
-        // EOF
-        break;
-      }
-      LOG_WARN("read file failed. filename=%s, ret = %d, error=%s", filename_.c_str(), ret, strerror(errno));
-      return RC::IOERR_READ;
-    }
-
-    if (header.size < 0 || header.size > LogEntry::max_payload_size()) {
-      LOG_WARN("invalid log entry size. filename=%s, size=%d", filename_.c_str(), header.size);
-      return RC::IOERR_READ;
-    }
-
-    vector<char> data(header.size);
-    ret = readn(fd_, data.data(), header.size);
-    if (0 != ret) {
-      LOG_WARN("read file failed. filename=%s, size=%d, ret=%d, error=%s", filename_.c_str(), header.size, ret, strerror(errno));
-      return RC::IOERR_READ;
-    }
-
-    LogEntry entry;
-    entry.init(header.lsn, LogModule(header.module_id), std::move(data));
-    rc = callback(entry);
-    if (OB_FAIL(rc)) {
-      LOG_INFO("iterate log entry failed. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
-      return rc;
-    }
-    LOG_TRACE("redo log iterate entry success. entry=%s", entry.to_string().c_str());
+  // 日志数据的长度是任意的，日志头不一定是对齐的
+  memcpy(&header, data_ + offset, LogHeader::SIZE);
+  if (header.size < 0 || header.size > LogEntry::max_payload_size() ||
+      file_size_ - offset - LogHeader::SIZE < header.size) {
+    return false;
   }
 
-  return RC::SUCCESS;
+  payload = span<const char>(data_ + offset + LogHeader::SIZE, header.size);
+  return header.check(payload);
 }
 
-RC LogFileReader::skip_to(LSN start_lsn)
+RC LogFileReader::iterate(function<RC(LogEntry &)> callback, LSN start_lsn /*=0*/)
 {
   if (fd_ < 0) {
     return RC::FILE_NOT_OPENED;
   }
 
-  off_t pos = lseek(fd_, 0, SEEK_SET);
-  if (off_t(-1) == pos) {
-    LOG_WARN("seek file failed. seek to the beginning. filename=%s, error=%s", filename_.c_str(), strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  LogHeader header;
-  while (true) {
-    int ret = readn(fd_, reinterpret_cast<char *>(&header), LogHeader::SIZE);
-    if (0 != ret) {
-      if (-1 == ret) {
-        // EOF
-        break;
-      }
-      LOG_WARN("read file failed. filename=%s, ret = %d, error=%s", filename_.c_str(), ret, strerror(errno));
-      return RC::IOERR_READ;
-    }
-
-    if (header.lsn >= start_lsn) {
-      off_t pos = lseek(fd_, -LogHeader::SIZE, SEEK_CUR);
-      if (off_t(-1) == pos) {
-        LOG_WARN("seek file failed. skip back log header. filename=%s, error=%s", filename_.c_str(), strerror(errno));
-        return RC::IOERR_SEEK;
-      }
+  RC       rc     = RC::SUCCESS;
+  int64_t  offset = 0;
+  LogEntry entry;
+
+  torn_ = false;
+  while (offset < file_size_) {
+    LogHeader        header;
+    span<const char> payload;
+    if (!parse_entry(offset, header, payload)) {
+      LOG_WARN("found torn log entry at the tail of file, ignore the rest. filename=%s, offset=%ld, file size=%ld",
+               filename_.c_str(), offset, file_size_);
+      torn_ = true;
       break;
     }
 
-    if (header.size < 0 || header.size > LogEntry::max_payload_size()) {
-      LOG_WARN("invalid log entry size. filename=%s, size=%d", filename_.c_str(), header.size);
-      return RC::IOERR_READ;
+    offset += LogHeader::SIZE + header.size;
+    if (header.lsn < start_lsn) {
+      continue;
     }
 
-    pos = lseek(fd_, header.size, SEEK_CUR);
-    if (off_t(-1) == pos) {
-      LOG_WARN("seek file failed. skip log entry payload. filename=%s, error=%s", filename_.c_str(), strerror(errno));
-      return RC::IOERR_SEEK;
+    rc = entry.init_view(header, payload);
+    if (OB_SUCC(rc)) {
+      rc = callback(entry);
+    }
+    if (OB_FAIL(rc)) {
+      LOG_INFO("iterate log entry failed. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+      return rc;
     }
+    LOG_TRACE("redo log iterate entry success. entry=%s", entry.to_string().c_str());
   }
 
+  valid_size_ = offset;
   return RC::SUCCESS;
 }
+
 ////////////////////////////////////////////////////////////////////////////////
 // LogFileWriter
 LogFileWriter::~LogFileWriter()
@@ -155,7 +159,7 @@ RC LogFileWriter::open(const char *filename, int end_lsn)
   filename_ = filename;
   end_lsn_ = end_lsn;
 
-  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT | O_SYNC, 0644);
+  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT, 0644);
   if (fd_ < 0) {
     LOG_WARN("open file failed. filename=%s, error=%s", filename, strerror(errno));
     return RC::FILE_OPEN;
@@ -178,8 +182,34 @@ RC LogFileWriter::close()
 
 RC LogFileWriter::write(LogEntry &entry)
 {
+  return write(span<LogEntry>(&entry, 1));
+}
+
+RC LogFileWriter::write(span<LogEntry> entries)
+{
+  if (entries.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 每条日志有日志头和日志数据两段，一起交给writev，减少系统调用次数
+  vector<struct iovec> iovs;
+  iovs.reserve(entries.size() * 2);
+  for (LogEntry &entry : entries) {
+    iovs.push_back({const_cast<LogHeader *>(&entry.header()), static_cast<size_t>(LogHeader::SIZE)});
+    iovs.push_back({const_cast<char *>(entry.data()), static_cast<size_t>(entry.payload_size())});
+  }
+
+  return write(span<struct iovec>(iovs), entries.front().lsn(), entries.back().lsn());
+}
+
+RC LogFileWriter::write(span<struct iovec> iovs, LSN first_lsn, LSN last_lsn)
+{
+  if (iovs.empty()) {
+    return RC::SUCCESS;
+  }
+
   // 一个日志文件写的日志条数是有限制的
-  if (entry.lsn() > end_lsn_) {
+  if (last_lsn > end_lsn_) {
     return RC::LOG_FILE_FULL;
   }
 
@@ -187,30 +217,38 @@ RC LogFileWriter::write(LogEntry &entry)
     return RC::FILE_NOT_OPENED;
   }
 
-  if (entry.lsn() <= last_lsn_) {
-    LOG_WARN("write log entry failed. lsn is too small. filename=%s, last_lsn=%ld, entry=%s", 
-             filename_.c_str(), last_lsn_, entry.to_string().c_str());
+  if (first_lsn <= last_lsn_) {
+    LOG_WARN("write log entry failed. lsn is too small. filename=%s, last_lsn=%ld, first_lsn=%ld", 
+             filename_.c_str(), last_lsn_, first_lsn);
     return RC::INVALID_ARGUMENT;
   }
 
   /// WARNING 这里需要处理日志写一半的情况
   /// 日志只写成功一部分到文件中非常难处理
-  int ret = writen(fd_, reinterpret_cast<const char *>(&entry.header()), LogHeader::SIZE);
+  int ret = writevn(fd_, iovs.data(), static_cast<int>(iovs.size()));
   if (0 != ret) {
-    LOG_WARN("write log entry header failed. filename=%s, ret = %d, error=%s, entry=%s", 
-             filename_.c_str(), ret, strerror(errno), entry.to_string().c_str());
+    LOG_WARN("write log entries failed. filename=%s, ret = %d, error=%s, first_lsn=%ld, last_lsn=%ld", 
+             filename_.c_str(), ret, strerror(ret), first_lsn, last_lsn);
     return RC::IOERR_WRITE;
   }
 
-  ret = writen(fd_, entry.data(), entry.payload_size());
-  if (0 != ret) {
-    LOG_WARN("write log entry payload failed. filename=%s, ret = %d, error=%s, entry=%s", 
-             filename_.c_str(), ret, strerror(errno), entry.to_string().c_str());
-    return RC::IOERR_WRITE;
+  last_lsn_ = last_lsn;
+  LOG_TRACE("write log entries success. filename=%s, first_lsn=%ld, last_lsn=%ld", 
+            filename_.c_str(), first_lsn, last_lsn);
+  return RC::SUCCESS;
+}
+
+RC LogFileWriter::sync()
+{
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
   }
 
-  last_lsn_ = entry.lsn();
-  LOG_TRACE("write log entry success. filename=%s, entry=%s", filename_.c_str(), entry.to_string().c_str());
+  int ret = fdatasync(fd_);
+  if (0 != ret) {
+    LOG_WARN("sync log file failed. filename=%s, error=%s", filename_.c_str(), strerror(errno));
+    return RC::IOERR_SYNC;
+  }
   return RC::SUCCESS;
 }
 
@@ -300,6 +338,7 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 {
   files.clear();
 
+  lock_guard guard(lock_);
   // 这里的代码是AI自动生成的
   // 其实写的不好，我们只需要找到比start_lsn相等或者小的第一个日志文件就可以了
   for (auto &file : log_files_) {
@@ -313,7 +352,9 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 
 RC LogFileManager::last_file(LogFileWriter &file_writer)
 {
+  unique_lock guard(lock_);
   if (log_files_.empty()) {
+    guard.unlock();
     return next_file(file_writer);
   }
 
@@ -328,6 +369,7 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 {
   file_writer.close();
 
+  lock_guard guard(lock_);
   LSN lsn = 0;
   if (!log_files_.empty()) {
     lsn = log_files_.rbegin()->first + max_entry_number_per_file_;
@@ -339,3 +381,27 @@ RC LogFileManager::next_file(LogFileWriter &file_writer)
 
   return file_writer.open(file_path.c_str(), lsn + max_entry_number_per_file_ - 1);
 }
+
+RC LogFileManager::recycle(LSN lsn, int &recycled_count)
+{
+  recycled_count = 0;
+
+  lock_guard guard(lock_);
+  while (log_files_.size() > 1) {
+    auto iter = log_files_.begin();
+    if (iter->first + max_entry_number_per_file_ - 1 >= lsn) {
+      break;
+    }
+
+    error_code ec;
+    if (!filesystem::remove(iter->second, ec) && ec) {
+      LOG_WARN("failed to remove log file. file=%s, error=%s", iter->second.c_str(), ec.message().c_str());
+      return RC::FILE_REMOVE;
+    }
+
+    LOG_INFO("log file recycled. file=%s, checkpoint lsn=%ld", iter->second.c_str(), lsn);
+    log_files_.erase(iter);
+    recycled_count++;
+  }
+  return RC::SUCCESS;
+}
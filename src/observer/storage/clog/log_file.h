@@ -20,37 +20,60 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/functional.h"
 #include "common/lang/filesystem.h"
 #include "common/lang/fstream.h"
+#include "common/lang/mutex.h"
 #include "common/lang/string.h"
+#include "common/lang/span.h"
+
+#include <sys/uio.h>
 
 class LogEntry;
+struct LogHeader;
 
 /**
- * @brief 负责处理一个日志文件，包括读取和写入
+ * @brief 负责读取一个日志文件
  * @ingroup CLog
- * @details 日志文件中的日志是按照LSN从小到大排列的
+ * @details 日志文件中的日志是按照LSN从小到大排列的。
+ * 打开文件时把整个文件映射到内存中，迭代时直接在映射的内存上解析日志，日志数据不做拷贝。
+ * 每条日志都会检查校验码。系统崩溃时最后一批日志可能只写了一部分，遇到不完整或者校验失败的日志时，
+ * 认为文件到此结束，迭代正常返回，通过 torn 和 valid_size 可以知道是否发生了这种情况。
  */
 class LogFileReader
 {
 public:
-  LogFileReader()  = default;
-  ~LogFileReader() = default;
+  LogFileReader() = default;
+  ~LogFileReader();
 
   RC open(const char *filename);
   RC close();
 
+  /**
+   * @brief 遍历文件中的日志
+   * @details 传给回调函数的日志直接引用映射的文件内存(参考 LogEntry::init_view)，只在回调期间有效
+   * @param callback 处理每条日志
+   * @param start_lsn 从第一条不小于start_lsn的日志开始
+   */
   RC iterate(function<RC(LogEntry &)> callback, LSN start_lsn = 0);
 
+  /// @brief 上次遍历时文件末尾是否有不完整的日志
+  bool torn() const { return torn_; }
+
+  /// @brief 上次遍历时，文件中完整日志的字节数
+  int64_t valid_size() const { return valid_size_; }
+
 private:
   /**
-   * @brief 跳到第一条不小于start_lsn的日志
-   *
-   * @param start_lsn 期望开始的第一条日志的LSN
+   * @brief 解析 offset 处的日志
+   * @return 日志完整并且校验通过返回true
    */
-  RC skip_to(LSN start_lsn);
+  bool parse_entry(int64_t offset, LogHeader &header, span<const char> &payload) const;
 
 private:
-  int    fd_ = -1;
-  string filename_;
+  int         fd_ = -1;
+  string      filename_;
+  const char *data_       = nullptr;  /// 映射到内存中的文件
+  int64_t     file_size_  = 0;        /// 打开文件时的文件大小
+  int64_t     valid_size_ = 0;
+  bool        torn_       = false;
 };
 
 /**
@@ -76,6 +99,27 @@ public:
   /// @brief 写入一条日志
   RC write(LogEntry &entry);
 
+  /**
+   * @brief 使用一次writev写入一批日志
+   * @details 日志的LSN必须是递增的，并且不能超过当前文件允许的最大LSN。
+   * 写入之后数据可能还在操作系统的缓存中，需要调用sync才能保证持久化。
+   */
+  RC write(span<LogEntry> entries);
+
+  /**
+   * @brief 使用一次writev写入一段已经序列化好的日志
+   * @details 日志缓冲区中的日志是连续存放的(日志头+日志数据)，可以不拆分成LogEntry直接写入。
+   * @param iovs 日志数据所在的内存块，拼起来是若干条完整的日志
+   * @param first_lsn 这段数据中第一条日志的LSN
+   * @param last_lsn 这段数据中最后一条日志的LSN
+   */
+  RC write(span<struct iovec> iovs, LSN first_lsn, LSN last_lsn);
+
+  /**
+   * @brief 将已经写入的日志持久化到磁盘
+   */
+  RC sync();
+
   /**
    * @brief 当前文件是否已经打开
    */
@@ -90,6 +134,9 @@ public:
 
   const char *filename() const { return filename_.c_str(); }
 
+  /// @brief 当前文件允许写入的最大LSN
+  LSN end_lsn() const { return end_lsn_; }
+
 private:
   string filename_;       /// 日志文件名
   int    fd_       = -1;  /// 日志文件描述符
@@ -137,6 +184,16 @@ public:
    */
   RC next_file(LogFileWriter &file_writer);
 
+  /**
+   * @brief 删除不再需要的日志文件
+   * @details 检查点之前的日志在重启时不会再重放，所以包含的日志全部小于lsn的文件都可以删除。
+   * 最后一个日志文件可能正在写入，永远不会删除。
+   * 检查点线程调用这个接口，与日志刷新线程并发执行。
+   * @param lsn 这个LSN之前的日志都不再需要了
+   * @param[out] recycled_count 删除了多少个文件
+   */
+  RC recycle(LSN lsn, int &recycled_count);
+
 private:
   /**
    * @brief 从文件名称中获取LSN
@@ -151,5 +208,6 @@ private:
   filesystem::path directory_;                  /// 日志文件存放的目录
   int              max_entry_number_per_file_;  /// 一个文件最大允许存放多少条日志
 
+  mutex                      lock_;       /// 保护 log_files_，日志刷新线程和检查点线程都会访问
   map<LSN, filesystem::path> log_files_;  /// 日志文件名和第一个LSN的映射
 };
@@ -96,12 +96,19 @@ public:
 
   virtual LSN current_lsn() const = 0;
 
+  /**
+   * @brief 回收不再需要的日志
+   * @details 做完检查点之后调用，lsn之前的日志在重启时不会再重放了
+   * @param lsn 检查点的LSN
+   */
+  virtual RC recycle(LSN lsn) { return RC::SUCCESS; }
+
   static RC create(const char *name, LogHandler *&handler);
 
 private:
   /**
    * @brief 写入一条日志
-   * @details 子类应该重现实现这个函数
+   * @details 子类应该重现实现这个函数。日志数据会在函数内部拷贝到日志缓冲区中，调用返回后data就可以释放了
    */
-  virtual RC _append(LSN &lsn, LogModule module, vector<char> &&data) = 0;
+  virtual RC _append(LSN &lsn, LogModule module, span<const char> data) = 0;
 };
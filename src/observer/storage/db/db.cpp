@@ -16,13 +16,18 @@ See the Mulan PSL v2 for more details. */
 
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 #include <filesystem>
 
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/chrono.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/os/path.h"
 #include "common/global_context.h"
+#include "common/thread/thread_util.h"
 #include "storage/common/meta_util.h"
 #include "storage/table/table.h"
 #include "storage/table/table_meta.h"
@@ -34,6 +39,14 @@ using namespace common;
 
 Db::~Db()
 {
+  stop_checkpointer();
+
+  if (buffer_pool_manager_) {
+    // 清理线程刷盘时需要等待日志，所以要在停止日志之前停止
+    buffer_pool_manager_->stop_cleaner();
+    buffer_pool_manager_->stop_read_ahead();
+  }
+
   for (auto &iter : opened_tables_) {
     delete iter.second;
   }
@@ -69,8 +82,15 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
 
   trx_kit_.reset(trx_kit);
 
+  // 一批写入多少个页面，越大每个页面分摊的fdatasync越少，但是内存中保存的页面越多
+  int    dblwr_pages     = DiskDoubleWriteBuffer::DEFAULT_MAX_PAGES;
+  string dblwr_pages_str = get_properties()->get("DOUBLE_WRITE_BUFFER_PAGES", "", "BUFFER_POOL");
+  if (!dblwr_pages_str.empty()) {
+    str_to_val(dblwr_pages_str, dblwr_pages);
+  }
+
   buffer_pool_manager_ = make_unique<BufferPoolManager>();
-  auto dblwr_buffer    = make_unique<DiskDoubleWriteBuffer>(*buffer_pool_manager_);
+  auto dblwr_buffer    = make_unique<DiskDoubleWriteBuffer>(*buffer_pool_manager_, dblwr_pages);
 
   const char      *double_write_buffer_filename  = "dblwr.db";
   filesystem::path double_write_buffer_file_path = filesystem::path(dbpath) / double_write_buffer_filename;
@@ -81,6 +101,9 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     return rc;
   }
 
+  LOG_INFO("double write buffer opened. file=%s, max pages=%d",
+           double_write_buffer_file_path.c_str(), dblwr_buffer->max_pages());
+
   rc = buffer_pool_manager_->init(std::move(dblwr_buffer));
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to init buffer pool manager. dbpath=%s, rc=%s", dbpath, strrc(rc));
@@ -133,6 +156,24 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     return rc;
   }
 
+  rc = buffer_pool_manager_->start_cleaner();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start buffer pool cleaner. dbpath=%s, rc=%s", dbpath, strrc(rc));
+    return rc;
+  }
+
+  rc = buffer_pool_manager_->start_read_ahead();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start buffer pool read ahead. dbpath=%s, rc=%s", dbpath, strrc(rc));
+    return rc;
+  }
+
+  rc = start_checkpointer();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start checkpointer. dbpath=%s, rc=%s", dbpath, strrc(rc));
+    return rc;
+  }
+
   return rc;
 }
 
@@ -216,9 +257,9 @@ RC Db::open_all_tables()
     }
 
     if (opened_tables_.count(table->name()) != 0) {
-      delete table;
       LOG_ERROR("Duplicate table with difference file name. table=%s, the other filename=%s",
           table->name(), filename.c_str());
+      delete table;
       return RC::INTERNAL;
     }
 
@@ -256,28 +297,70 @@ RC Db::sync()
     LOG_INFO("Successfully sync table db:%s, table:%s.", name_.c_str(), table->name());
   }
 
+  // 表的页面已经都刷新过了，这里刷新剩下的页面并推进检查点
+  rc = checkpoint(-1 /*max_flush_pages*/);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to do checkpoint. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
+    return rc;
+  }
+  LOG_INFO("Successfully sync db. db=%s", name_.c_str());
+  return rc;
+}
+
+RC Db::checkpoint(int max_flush_pages)
+{
+  lock_guard guard(checkpoint_lock_);
+
+  // 先确定检查点的上界：当前LSN以及活跃事务的第一条日志。
+  // 之后开始的修改，LSN都比这个大，不需要关心
+  LSN     checkpoint_lsn = 0;
+  int32_t max_trx_id     = 0;
+  trx_kit_->checkpoint_info(*log_handler_, checkpoint_lsn, max_trx_id);
+  const LSN current_lsn = log_handler_->current_lsn();
+
+  // 刷新最老的一批脏页，剩下的脏页中最小的recLSN就是检查点可以推进到的位置
+  RC rc = buffer_pool_manager_->checkpoint(max_flush_pages, checkpoint_lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush dirty pages while doing checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    return rc;
+  }
+
   auto dblwr_buffer = static_cast<DiskDoubleWriteBuffer *>(buffer_pool_manager_->get_dblwr_buffer());
   rc                = dblwr_buffer->flush_page();
-  LOG_INFO("double write buffer flush pages ret=%s", strrc(rc));
-
-  /*
-  在sync期间，不允许有未完成的事务，也不允许开启新的事物。
-  这个约束不是从程序层面处理的，而是认为的约束。
-  */
-  LSN current_lsn = log_handler_->current_lsn();
-  rc              = log_handler_->wait_lsn(current_lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush double write buffer while doing checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    return rc;
+  }
+
+  // 检查点之后的日志都要能够重放，所以要先保证日志已经持久化了
+  rc = log_handler_->wait_lsn(current_lsn);
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to wait lsn. lsn=%ld, rc=%d:%s", current_lsn, rc, strrc(rc));
     return rc;
   }
 
-  check_point_lsn_ = current_lsn;
-  rc               = flush_meta();
+  if (checkpoint_lsn <= check_point_lsn_ && max_trx_id <= check_point_trx_id_) {
+    LOG_DEBUG("checkpoint does not move. db=%s, checkpoint lsn=%ld", name_.c_str(), check_point_lsn_);
+    return RC::SUCCESS;
+  }
+
+  check_point_lsn_    = max(checkpoint_lsn, check_point_lsn_);
+  check_point_trx_id_ = max(max_trx_id, check_point_trx_id_);
+  rc                  = flush_meta();
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to flush meta. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
     return rc;
   }
-  LOG_INFO("Successfully sync db. db=%s", name_.c_str());
+
+  rc = log_handler_->recycle(check_point_lsn_);
+  if (OB_FAIL(rc)) {
+    // 只是多占用一些磁盘空间，下次检查点时再回收
+    LOG_WARN("failed to recycle log. db=%s, checkpoint lsn=%ld, rc=%s", name_.c_str(), check_point_lsn_, strrc(rc));
+    rc = RC::SUCCESS;
+  }
+
+  LOG_INFO("checkpoint done. db=%s, checkpoint lsn=%ld, current lsn=%ld, max trx id=%d",
+           name_.c_str(), check_point_lsn_, current_lsn, check_point_trx_id_);
   return rc;
 }
 
@@ -285,6 +368,9 @@ RC Db::recover()
 {
   LOG_TRACE("db recover begin. check_point_lsn=%d", check_point_lsn_);
 
+  // 检查点之前提交的事务不会再重放，它们的事务ID也不能再分配
+  trx_kit_->update_trx_id(check_point_trx_id_);
+
   LogReplayer *trx_log_replayer = trx_kit_->create_log_replayer(*this, *log_handler_);
   if (trx_log_replayer == nullptr) {
     LOG_ERROR("Failed to create trx log replayer.");
@@ -292,7 +378,20 @@ RC Db::recover()
   }
 
   IntegratedLogReplayer log_replayer(*buffer_pool_manager_, unique_ptr<LogReplayer>(trx_log_replayer));
-  RC                    rc = log_handler_->replay(log_replayer, check_point_lsn_ /*start_lsn*/);
+
+  // 页面相关的日志可以按照页面分发给多个线程回放
+  int    redo_workers     = 0;
+  string redo_workers_str = get_properties()->get("REDO_WORKERS", "", "CLOG");
+  if (!redo_workers_str.empty()) {
+    str_to_val(redo_workers_str, redo_workers);
+  }
+  RC rc = log_replayer.start_parallel_redo(redo_workers);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start parallel redo. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = log_handler_->replay(log_replayer, check_point_lsn_ /*start_lsn*/);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to replay log. rc=%s", strrc(rc));
     return rc;
@@ -304,6 +403,21 @@ RC Db::recover()
     return rc;
   }
 
+  // 事务回滚之前，表要看到重做之后的页面
+  rc = log_replayer.finish_page_redo();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to finish page redo. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  for (auto &iter : opened_tables_) {
+    rc = iter.second->on_redo_done();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to refresh table after redo. table=%s, rc=%s", iter.first.c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
   rc = log_replayer.on_done();
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to on_done. rc=%s", strrc(rc));
@@ -344,10 +458,13 @@ RC Db::init_meta()
       return RC::IOERR_TOO_LONG;
     }
 
+    // 第一行是检查点LSN，第二行是检查点时的最大事务ID。旧版本的元数据文件只有第一行
     buffer[n]        = '\0';
-    check_point_lsn_ = atoll(buffer);  // 当前元数据就这一个数字
-    LOG_INFO("Successfully read db meta file. db=%s, file=%s, check_point_lsn=%ld", 
-             name_.c_str(), db_meta_file_path.c_str(), check_point_lsn_);
+    char *line_end   = nullptr;
+    check_point_lsn_ = strtoll(buffer, &line_end, 10);
+    check_point_trx_id_ = static_cast<int32_t>(strtol(line_end, nullptr, 10));
+    LOG_INFO("Successfully read db meta file. db=%s, file=%s, check_point_lsn=%ld, max trx id=%d", 
+             name_.c_str(), db_meta_file_path.c_str(), check_point_lsn_, check_point_trx_id_);
   }
   close(fd);
 
@@ -372,7 +489,7 @@ RC Db::flush_meta()
     return RC::IOERR_WRITE;
   }
 
-  string buffer = std::to_string(check_point_lsn_);
+  string buffer = std::to_string(check_point_lsn_) + "\n" + std::to_string(check_point_trx_id_);
   int    n      = write(fd, buffer.c_str(), buffer.size());
   if (n < 0) {
     LOG_ERROR("Failed to write db meta file. db=%s, file=%s, errno=%s", 
@@ -382,6 +499,11 @@ RC Db::flush_meta()
     LOG_ERROR("Failed to write db meta file. db=%s, file=%s, buffer size=%ld, write size=%d", 
               name_.c_str(), temp_meta_file_path.c_str(), buffer.size(), n);
     rc = RC::IOERR_WRITE;
+  } else if (fdatasync(fd) != 0) {
+    // 检查点之前的日志会被回收，所以元数据必须先持久化
+    LOG_ERROR("Failed to sync db meta file. db=%s, file=%s, errno=%s", 
+              name_.c_str(), temp_meta_file_path.c_str(), strerror(errno));
+    rc = RC::IOERR_SYNC;
   } else {
     error_code ec;
     filesystem::rename(temp_meta_file_path, meta_file_path, ec);
@@ -396,6 +518,7 @@ RC Db::flush_meta()
     }
   }
 
+  close(fd);
   return rc;
 }
 
@@ -414,3 +537,71 @@ RC Db::init_dblwr_buffer()
 LogHandler        &Db::log_handler() { return *log_handler_; }
 BufferPoolManager &Db::buffer_pool_manager() { return *buffer_pool_manager_; }
 TrxKit            &Db::trx_kit() { return *trx_kit_; }
+
+RC Db::start_checkpointer()
+{
+  string interval_str = get_properties()->get("CHECKPOINT_INTERVAL_MS", "", "CLOG");
+  if (!interval_str.empty()) {
+    str_to_val(interval_str, checkpoint_interval_ms_);
+  }
+  string flush_pages_str = get_properties()->get("CHECKPOINT_FLUSH_PAGES", "", "CLOG");
+  if (!flush_pages_str.empty()) {
+    str_to_val(flush_pages_str, checkpoint_flush_pages_);
+  }
+
+  if (checkpoint_interval_ms_ <= 0) {
+    LOG_INFO("checkpointer is disabled. db=%s", name_.c_str());
+    return RC::SUCCESS;
+  }
+
+#ifdef CONCURRENCY
+  checkpointer_running_.store(true);
+  checkpointer_thread_ = make_unique<thread>(&Db::checkpointer_func, this);
+  LOG_INFO("checkpointer started. db=%s, interval=%dms, flush pages=%d",
+           name_.c_str(), checkpoint_interval_ms_, checkpoint_flush_pages_);
+#else
+  // 非并发编译时很多锁什么都不做，不能有其它线程访问页面
+  LOG_INFO("checkpointer is not supported without CONCURRENCY");
+#endif
+  return RC::SUCCESS;
+}
+
+RC Db::stop_checkpointer()
+{
+  if (!checkpointer_thread_) {
+    return RC::SUCCESS;
+  }
+
+  {
+    lock_guard guard(checkpointer_mutex_);
+    checkpointer_running_.store(false);
+    checkpointer_cond_.notify_all();
+  }
+
+  checkpointer_thread_->join();
+  checkpointer_thread_.reset();
+  LOG_INFO("checkpointer stopped. db=%s", name_.c_str());
+  return RC::SUCCESS;
+}
+
+void Db::checkpointer_func()
+{
+  thread_set_name("Checkpointer");
+
+  while (checkpointer_running_.load()) {
+    {
+      unique_lock lock(checkpointer_mutex_);
+      checkpointer_cond_.wait_for(lock, chrono::milliseconds(checkpoint_interval_ms_),
+                                  [this]() { return !checkpointer_running_.load(); });
+    }
+
+    if (!checkpointer_running_.load()) {
+      break;
+    }
+
+    RC rc = checkpoint(checkpoint_flush_pages_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to do checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+    }
+  }
+}
@@ -17,8 +17,11 @@ See the Mulan PSL v2 for more details. */
 #include "common/rc.h"
 #include "common/lang/vector.h"
 #include "common/lang/string.h"
+#include "common/lang/atomic.h"
 #include "common/lang/unordered_map.h"
 #include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
 #include "common/lang/span.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
@@ -88,11 +91,21 @@ public:
   void all_tables(std::vector<std::string> &table_names) const;
 
   /**
-   * @brief 将所有内存中的数据，刷新到磁盘中。
-   * @details 注意，这里也没有并发控制，需要由上层来保证当前没有正在进行的事务。
+   * @brief 将所有内存中的数据，刷新到磁盘中，然后做一次检查点。
+   * @details 可以有正在进行的事务，检查点不会跨过活跃事务的第一条日志。
    */
   RC sync();
 
+  /**
+   * @brief 做一次模糊检查点
+   * @details 不会阻塞正在执行的事务。按照recLSN从小到大刷新一部分脏页，然后计算检查点LSN:
+   * 当前LSN、剩余脏页最小的recLSN、活跃事务第一条日志的LSN，三者中最小的那个。
+   * 检查点LSN之前的日志在重启时不需要重放，对应的日志文件会被回收。
+   * 后台检查点线程会定期调用，参考配置项 [CLOG] CHECKPOINT_INTERVAL_MS。
+   * @param max_flush_pages 最多刷新多少个脏页，小于0表示刷新所有脏页
+   */
+  RC checkpoint(int max_flush_pages);
+
   /// @brief 获取当前数据库的日志处理器
   LogHandler &log_handler();
 
@@ -116,6 +129,11 @@ private:
   /// @brief 初始化数据库的double buffer pool
   RC init_dblwr_buffer();
 
+  /// @brief 启动后台检查点线程。需要在恢复完成之后调用
+  RC start_checkpointer();
+  RC stop_checkpointer();
+  void checkpointer_func();
+
 private:
   std::string                         name_;                 ///< 数据库名称
   std::string                         path_;                 ///< 数据库文件存放的目录
@@ -127,5 +145,14 @@ private:
   /// 给每个table都分配一个ID，用来记录日志。这里假设所有的DDL都不会并发操作，所以相关的数据都不上锁
   int32_t next_table_id_ = 0;
 
-  LSN check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  LSN     check_point_lsn_    = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  int32_t check_point_trx_id_ = 0;  ///< 做检查点时已经分配的最大事务ID。与检查点LSN一起记录到磁盘中。
+  mutex   checkpoint_lock_;         ///< 检查点线程与sync命令不能同时做检查点
+
+  int                checkpoint_interval_ms_ = 0;    ///< 后台检查点间隔，0表示不启动检查点线程
+  int                checkpoint_flush_pages_ = 256;  ///< 每次检查点最多刷新的脏页个数
+  unique_ptr<thread> checkpointer_thread_;
+  atomic<bool>       checkpointer_running_{false};
+  mutex              checkpointer_mutex_;
+  condition_variable checkpointer_cond_;
 };
@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 #include <span>
 
 #include "storage/index/bplus_tree.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/limits.h"
 #include "common/lang/lower_bound.h"
 #include "common/log/log.h"
 #include "common/global_context.h"
@@ -38,24 +40,43 @@ int calc_internal_page_capacity(int attr_length)
   return capacity;
 }
 
-int calc_leaf_page_capacity(int attr_length)
+int calc_leaf_page_capacity(int attr_length, int value_size = sizeof(RID))
 {
-  int item_size = attr_length + sizeof(RID) + sizeof(RID);
+  int item_size = attr_length + sizeof(RID) + value_size;
   int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
   return capacity;
 }
 
+int BplusTreeHandler::max_leaf_value_size(int attr_length)
+{
+  const int item_size = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / MIN_VALUE_LEAF_SIZE;
+  return item_size - attr_length - static_cast<int>(sizeof(RID));
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 IndexNodeHandler::IndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame)
     : mtr_(mtr), header_(header), frame_(frame), node_((IndexNode *)frame->data())
 {}
 
+IndexNodeHandler::IndexNodeHandler(
+    BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame, char *data)
+    : mtr_(mtr), header_(header), frame_(frame), node_((IndexNode *)data)
+{}
+
 bool IndexNodeHandler::is_leaf() const { return node_->is_leaf; }
 void IndexNodeHandler::init_empty(bool leaf)
 {
   node_->is_leaf = leaf;
   node_->key_num = 0;
   node_->parent  = BP_INVALID_PAGE_NUM;
+  if (is_compact()) {
+    compact_node().init_empty();
+  }
+}
+
+bool IndexNodeHandler::is_compact() const
+{
+  return header_.key_format == static_cast<int32_t>(BplusTreeKeyFormat::COMPACT);
 }
 PageNum IndexNodeHandler::page_num() const { return frame_->page_num(); }
 
@@ -63,8 +84,7 @@ int IndexNodeHandler::key_size() const { return header_.key_length; }
 
 int IndexNodeHandler::value_size() const
 {
-  // return header_.value_size;
-  return sizeof(RID);
+  return header_.leaf_value_size > 0 ? header_.leaf_value_size : static_cast<int>(sizeof(RID));
 }
 
 int IndexNodeHandler::item_size() const { return key_size() + value_size(); }
@@ -109,7 +129,10 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
       return true;
     } break;
     case BplusTreeOperationType::INSERT: {
-      return size() < max_size();
+      return !is_full();
+    } break;
+    case BplusTreeOperationType::UPDATE: {
+      return true;
     } break;
     case BplusTreeOperationType::DELETE: {
       if (is_root_node) {  // 参考adjust_root
@@ -120,6 +143,9 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
         // 根节点还有子节点，但是如果删除一个子节点后，只剩一个子节点，就要把自己删除，把唯一的子节点变更为根节点
         return size() > 2;
       }
+      if (is_compact()) {
+        return compact_node().can_remove_one();
+      }
       return size() > min_size();
     } break;
     default: {
@@ -131,6 +157,112 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
   return false;
 }
 
+bool IndexNodeHandler::is_full() const
+{
+  if (is_compact()) {
+    return compact_node().is_full();
+  }
+  return size() >= max_size();
+}
+
+bool IndexNodeHandler::is_underflow() const
+{
+  if (is_compact()) {
+    return compact_node().is_underflow();
+  }
+  return size() < min_size();
+}
+
+bool IndexNodeHandler::can_insert(const char *key) const
+{
+  if (is_compact()) {
+    return compact_node().can_insert(key);
+  }
+  return size() < max_size();
+}
+
+bool IndexNodeHandler::can_coalesce_with(const IndexNodeHandler &other) const
+{
+  if (is_compact()) {
+    return compact_node().can_merge(other.compact_node());
+  }
+  return size() + other.size() <= max_size();
+}
+
+int IndexNodeHandler::split_index() const
+{
+  if (is_compact()) {
+    return compact_node().split_index();
+  }
+  return size() / 2;
+}
+
+int IndexNodeHandler::used_bytes() const
+{
+  if (is_compact()) {
+    return compact_node().used_bytes();
+  }
+  return size() * item_size();
+}
+
+const char *IndexNodeHandler::item_key(int index) const
+{
+  if (!is_compact()) {
+    return __key_at(index);
+  }
+
+  const int key_size = this->key_size();
+  if (key_buffer_.empty()) {
+    key_buffer_.resize(static_cast<size_t>(key_size) * KEY_BUFFER_NUM);
+  }
+  char *key         = key_buffer_.data() + static_cast<size_t>(key_buffer_index_) * key_size;
+  key_buffer_index_ = (key_buffer_index_ + 1) % KEY_BUFFER_NUM;
+  compact_node().key_at(index, key);
+  return key;
+}
+
+char *IndexNodeHandler::item_value(int index) const
+{
+  if (is_compact()) {
+    return compact_node().value_at(index);
+  }
+  return __value_at(index);
+}
+
+span<const char> IndexNodeHandler::items_at(int index, int num, vector<char> &buffer) const
+{
+  if (!is_compact()) {
+    return span<const char>(__item_at(index), static_cast<size_t>(num) * item_size());
+  }
+
+  CompactNode node = compact_node();
+  buffer.resize(static_cast<size_t>(num) * node.item_size());
+  node.items_at(index, num, buffer.data());
+  return span<const char>(buffer.data(), buffer.size());
+}
+
+int IndexNodeHandler::compact_lower_bound(
+    const KeyComparator &comparator, const char *key, int first, int last, bool *found) const
+{
+  if (found) {
+    *found = false;
+  }
+
+  while (first < last) {
+    const int mid = first + (last - first) / 2;
+    const int cmp = comparator(item_key(mid), key);
+    if (cmp < 0) {
+      first = mid + 1;
+    } else {
+      if (cmp == 0 && found) {
+        *found = true;
+      }
+      last = mid;
+    }
+  }
+  return first;
+}
+
 string to_string(const IndexNodeHandler &handler)
 {
   stringstream ss;
@@ -161,6 +293,15 @@ bool IndexNodeHandler::validate() const
 
 RC IndexNodeHandler::recover_insert_items(int index, const char *items, int num)
 {
+  if (is_compact()) {
+    RC rc = compact_node().insert_items(index, items, num);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("failed to insert items into compact node. page num=%d, index=%d, num=%d, rc=%s",
+                page_num(), index, num, strrc(rc));
+    }
+    return rc;
+  }
+
   const int item_size = this->item_size();
   if (index < size()) {
     memmove(__item_at(index + num), __item_at(index), (static_cast<size_t>(size()) - index) * item_size);
@@ -173,6 +314,11 @@ RC IndexNodeHandler::recover_insert_items(int index, const char *items, int num)
 
 RC IndexNodeHandler::recover_remove_items(int index, int num)
 {
+  if (is_compact()) {
+    compact_node().remove_items(index, num);
+    return RC::SUCCESS;
+  }
+
   const int item_size = this->item_size();
   if (index < size() - num) {
     memmove(__item_at(index), __item_at(index + num), (static_cast<size_t>(size()) - index - num) * item_size);
@@ -216,17 +362,21 @@ PageNum LeafIndexNodeHandler::next_page() const { return leaf_node_->next_brothe
 char *LeafIndexNodeHandler::key_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  return const_cast<char *>(item_key(index));
 }
 
 char *LeafIndexNodeHandler::value_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __value_at(index);
+  return item_value(index);
 }
 
 int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
 {
+  if (is_compact()) {
+    return compact_lower_bound(comparator, key, 0, size(), found);
+  }
+
   const int                    size = this->size();
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
@@ -254,7 +404,8 @@ RC LeafIndexNodeHandler::remove(int index)
 {
   assert(index >= 0 && index < size());
 
-  RC rc = mtr_.logger().node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  vector<char> buffer;
+  RC rc = mtr_.logger().node_remove_items(*this, index, items_at(index, 1, buffer), 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s", strrc(rc));
     return rc;
@@ -278,12 +429,14 @@ int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparato
 RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
 {
   const int size       = this->size();
-  const int move_index = size / 2;
+  const int move_index = split_index();
   const int move_item_num = size - move_index;
 
-  other.append(__item_at(move_index), move_item_num);
+  vector<char>     buffer;
+  span<const char> items = items_at(move_index, move_item_num, buffer);
+  other.append(items.data(), move_item_num);
 
-  RC rc = mtr_.logger().node_remove_items(*this, move_index, span<const char>(__item_at(move_index), move_item_num * item_size()), move_item_num);
+  RC rc = mtr_.logger().node_remove_items(*this, move_index, items, move_item_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
     return rc;
@@ -294,14 +447,16 @@ RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
 }
 RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0));
+  vector<char> buffer;
+  other.append(items_at(0, 1, buffer).data());
 
   return this->remove(0);
 }
 
 RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
 {
-  other.preappend(__item_at(size() - 1));
+  vector<char> buffer;
+  other.preappend(items_at(size() - 1, 1, buffer).data());
 
   this->remove(size() - 1);
   return RC::SUCCESS;
@@ -311,14 +466,16 @@ RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
  */
 RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0), this->size());
+  vector<char>     buffer;
+  span<const char> items = items_at(0, this->size(), buffer);
+  other.append(items.data(), this->size());
   other.set_next_page(this->next_page());
 
-  RC rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), this->size() * item_size()), this->size());
+  RC rc = mtr_.logger().node_remove_items(*this, 0, items, this->size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
   }
-  this->increase_size(-this->size());
+  recover_remove_items(0, this->size());
 
   return RC::SUCCESS;
 }
@@ -351,9 +508,9 @@ string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer)
 {
   stringstream ss;
   ss << to_string((const IndexNodeHandler &)handler) << ",next page:" << handler.next_page();
-  ss << ",values=[" << printer(handler.__key_at(0));
+  ss << ",values=[" << (handler.size() > 0 ? printer(handler.item_key(0)) : "");
   for (int i = 1; i < handler.size(); i++) {
-    ss << "," << printer(handler.__key_at(i));
+    ss << "," << printer(handler.item_key(i));
   }
   ss << "]";
   return ss.str();
@@ -368,7 +525,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
 
   const int node_size = size();
   for (int i = 1; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    if (comparator(item_key(i - 1), item_key(i)) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
                page_num(), i - 1, i, to_string(*this).c_str());
       return false;
@@ -397,7 +554,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(0), parent_node.key_at(index_in_parent));
+    int cmp_result = comparator(item_key(0), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid leaf node. first item should be greate than or equal to parent item. "
                "this page num=%d, parent page num=%d, index in parent=%d",
@@ -408,7 +565,7 @@ bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferP
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    int cmp_result = comparator(item_key(size() - 1), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid leaf node. last item should be less than the item at the first after item in parent."
                "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -426,16 +583,21 @@ InternalIndexNodeHandler::InternalIndexNodeHandler(BplusTreeMiniTransaction &mtr
     : IndexNodeHandler(mtr, header, frame), internal_node_((InternalIndexNode *)frame->data())
 {}
 
+InternalIndexNodeHandler::InternalIndexNodeHandler(
+    BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame, char *data)
+    : IndexNodeHandler(mtr, header, frame, data), internal_node_((InternalIndexNode *)data)
+{}
+
 string to_string(const InternalIndexNodeHandler &node, const KeyPrinter &printer)
 {
   stringstream ss;
   ss << to_string((const IndexNodeHandler &)node);
   ss << ",children:["
-     << "{key:" << printer(node.__key_at(0)) << ","
-     << "value:" << *(PageNum *)node.__value_at(0) << "}";
+     << "{key:" << printer(node.item_key(0)) << ","
+     << "value:" << *(PageNum *)node.item_value(0) << "}";
 
   for (int i = 1; i < node.size(); i++) {
-    ss << ",{key:" << printer(node.__key_at(i)) << ",value:" << *(PageNum *)node.__value_at(i) << "}";
+    ss << ",{key:" << printer(node.item_key(i)) << ",value:" << *(PageNum *)node.item_value(i) << "}";
   }
   ss << "]";
   return ss.str();
@@ -457,6 +619,14 @@ RC InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const char
     LOG_WARN("failed to log create new root. rc=%s", strrc(rc));
   }
 
+  if (is_compact()) {
+    vector<char> items(item_size() * 2, 0);
+    memcpy(items.data() + key_size(), &first_page_num, value_size());
+    memcpy(items.data() + item_size(), key, key_size());
+    memcpy(items.data() + item_size() + key_size(), &page_num, value_size());
+    return recover_insert_items(0, items.data(), 2);
+  }
+
   memset(__key_at(0), 0, key_size());
   memcpy(__value_at(0), &first_page_num, value_size());
   memcpy(__item_at(1), key, key_size());
@@ -493,17 +663,19 @@ RC InternalIndexNodeHandler::insert(const char *key, PageNum page_num, const Key
  */
 RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other)
 {
-  const int size       = this->size();
-  const int move_index = size / 2;
-  const int move_num   = size - move_index;
-  RC        rc         = other.append(this->__item_at(move_index), size - move_index);
+  const int        size       = this->size();
+  const int        move_index = split_index();
+  const int        move_num   = size - move_index;
+  vector<char>     buffer;
+  span<const char> items = items_at(move_index, move_num, buffer);
+  RC               rc    = other.append(items.data(), move_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy item to new node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  mtr_.logger().node_remove_items(*this, move_index, span<const char>(__item_at(move_index), move_num * item_size()), move_num);
-  increase_size(-(size - move_index));
+  mtr_.logger().node_remove_items(*this, move_index, items, move_num);
+  recover_remove_items(move_index, move_num);
   return rc;
 }
 
@@ -526,6 +698,17 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
     return 0;
   }
 
+  if (is_compact()) {
+    const int ret = compact_lower_bound(comparator, key, 1, size, found);
+    if (insert_position) {
+      *insert_position = ret;
+    }
+    if (ret >= size || comparator(key, item_key(ret)) < 0) {
+      return ret - 1;
+    }
+    return ret;
+  }
+
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
   common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
@@ -543,27 +726,42 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
 char *InternalIndexNodeHandler::key_at(int index)
 {
   assert(index >= 0 && index < size());
-  return __key_at(index);
+  return const_cast<char *>(item_key(index));
+}
+
+bool InternalIndexNodeHandler::can_set_key_at(int index, const char *key) const
+{
+  if (is_compact()) {
+    return compact_node().can_set_key_at(index, key);
+  }
+  return true;
 }
 
 void InternalIndexNodeHandler::set_key_at(int index, const char *key)
 {
   assert(index >= 0 && index < size());
 
-  mtr_.logger().internal_update_key(*this, index, span<const char>(key, key_size()), span<const char>(__key_at(index), key_size()));
+  mtr_.logger().internal_update_key(*this, index, span<const char>(key, key_size()), span<const char>(item_key(index), key_size()));
+  if (is_compact()) {
+    RC rc = compact_node().set_key_at(index, key);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("failed to update key of compact node. page num=%d, index=%d, rc=%s", page_num(), index, strrc(rc));
+    }
+    return;
+  }
   memcpy(__key_at(index), key, key_size());
 }
 
 PageNum InternalIndexNodeHandler::value_at(int index)
 {
   assert(index >= 0 && index < size());
-  return *(PageNum *)__value_at(index);
+  return *(PageNum *)item_value(index);
 }
 
 int InternalIndexNodeHandler::value_index(PageNum page_num)
 {
   for (int i = 0; i < size(); i++) {
-    if (page_num == *(PageNum *)__value_at(i)) {
+    if (page_num == *(PageNum *)item_value(i)) {
       return i;
     }
   }
@@ -575,7 +773,8 @@ void InternalIndexNodeHandler::remove(int index)
   assert(index >= 0 && index < size());
 
   BplusTreeLogger &logger = mtr_.logger();
-  RC rc = logger.node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  vector<char>     buffer;
+  RC rc = logger.node_remove_items(*this, index, items_at(index, 1, buffer), 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s. node=%s", strrc(rc), to_string(*this).c_str());
   }
@@ -585,13 +784,15 @@ void InternalIndexNodeHandler::remove(int index)
 
 RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0), size());
+  vector<char>     buffer;
+  span<const char> items = items_at(0, size(), buffer);
+  RC               rc    = other.append(items.data(), size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy items to other node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), size() * item_size()), size());
+  rc = mtr_.logger().node_remove_items(*this, 0, items, size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -602,7 +803,8 @@ RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0));
+  vector<char> buffer;
+  RC           rc = other.append(items_at(0, 1, buffer).data());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to append item to others.");
     return rc;
@@ -614,18 +816,20 @@ RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_last_to_front(InternalIndexNodeHandler &other)
 {
-  RC rc = other.preappend(__item_at(size() - 1));
+  vector<char>     buffer;
+  span<const char> item = items_at(size() - 1, 1, buffer);
+  RC               rc   = other.preappend(item.data());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to preappend to others");
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, size() - 1, span<const char>(__item_at(size() - 1), item_size()), 1);
+  rc = mtr_.logger().node_remove_items(*this, size() - 1, item, 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
-  increase_size(-1);
+  recover_remove_items(size() - 1, 1);
   return rc;
 }
 
@@ -637,7 +841,10 @@ RC InternalIndexNodeHandler::insert_items(int index, const char *items, int num)
     return rc;
   }
 
-  recover_insert_items(index, items, num);
+  rc = recover_insert_items(index, items, num);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
   LatchMemo &latch_memo = mtr_.latch_memo();
   PageNum this_page_num = this->page_num();
@@ -691,7 +898,7 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
 
   const int node_size = size();
   for (int i = 2; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    if (comparator(item_key(i - 1), item_key(i)) >= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
           page_num(), i - 1, i, to_string(*this).c_str());
       return false;
@@ -699,7 +906,7 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
   }
 
   for (int i = 0; result && i < node_size; i++) {
-    PageNum page_num = *(PageNum *)__value_at(i);
+    PageNum page_num = *(PageNum *)item_value(i);
     if (page_num < 0) {
       LOG_WARN("this page num=%d, got invalid child page. page num=%d", this->page_num(), page_num);
     } else {
@@ -747,7 +954,7 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
   }
 
   if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(1), parent_node.key_at(index_in_parent));
+    int cmp_result = comparator(item_key(1), parent_node.key_at(index_in_parent));
     if (cmp_result < 0) {
       LOG_WARN("invalid internal node. the second item should be greate than or equal to parent item. "
                "this page num=%d, parent page num=%d, index in parent=%d",
@@ -758,7 +965,7 @@ bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBuf
   }
 
   if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
+    int cmp_result = comparator(item_key(size() - 1), parent_node.key_at(index_in_parent + 1));
     if (cmp_result >= 0) {
       LOG_WARN("invalid internal node. last item should be less than the item at the first after item in parent."
                "this page num=%d, parent page num=%d, parent item to compare=%d",
@@ -794,13 +1001,27 @@ RC BplusTreeHandler::sync()
   return disk_buffer_pool_->flush_all_pages();
 }
 
+/**
+ * @brief 确定索引实际使用的键值格式
+ * @details 键值太长时一个节点放不下足够多的元素，不能保证分裂之后能放下新插入的元素，只能使用定长格式
+ */
+static int32_t choose_key_format(const IndexFileHeader &header, BplusTreeKeyFormat key_format)
+{
+  if (key_format == BplusTreeKeyFormat::COMPACT && !CompactNode::is_applicable(header)) {
+    LOG_INFO("key is too long to use compact format, fallback to fixed format. key length=%d", header.key_length);
+    key_format = BplusTreeKeyFormat::FIXED;
+  }
+  return static_cast<int32_t>(key_format);
+}
+
 RC BplusTreeHandler::create(LogHandler &log_handler,
                             BufferPoolManager &bpm,
                             const char *file_name, 
                             AttrType attr_type, 
                             int attr_length, 
                             int internal_max_size /* = -1*/,
-                            int leaf_max_size /* = -1 */)
+                            int leaf_max_size /* = -1 */,
+                            BplusTreeKeyFormat key_format /* = BplusTreeKeyFormat::FIXED */)
 {
   RC rc = bpm.create_file(file_name);
   if (OB_FAIL(rc)) {
@@ -818,7 +1039,7 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
   }
   LOG_INFO("Successfully open index file %s.", file_name);
 
-  rc = this->create(log_handler, *bp, attr_type, attr_length, internal_max_size, leaf_max_size);
+  rc = this->create(log_handler, *bp, attr_type, attr_length, internal_max_size, leaf_max_size, key_format);
   if (OB_FAIL(rc)) {
     bpm.close_file(file_name);
     return rc;
@@ -833,13 +1054,25 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
             AttrType attr_type,
             int attr_length,
             int internal_max_size /* = -1 */,
-            int leaf_max_size /* = -1 */)
+            int leaf_max_size /* = -1 */,
+            BplusTreeKeyFormat key_format /* = BplusTreeKeyFormat::FIXED */,
+            int leaf_value_size /* = 0 */)
 {
+  if (leaf_value_size < 0) {
+    LOG_WARN("invalid leaf value size. leaf value size=%d", leaf_value_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
   if (internal_max_size < 0) {
     internal_max_size = calc_internal_page_capacity(attr_length);
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(attr_length);
+    leaf_max_size = leaf_value_size > 0 ? calc_leaf_page_capacity(attr_length, leaf_value_size)
+                                        : calc_leaf_page_capacity(attr_length);
+  }
+  if (leaf_value_size > 0 && leaf_max_size < MIN_VALUE_LEAF_SIZE) {
+    LOG_WARN("leaf value is too large. leaf value size=%d, leaf max size=%d", leaf_value_size, leaf_max_size);
+    return RC::INVALID_ARGUMENT;
   }
 
   log_handler_      = &log_handler;
@@ -865,12 +1098,19 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
 
   char            *pdata         = header_frame->data();
   IndexFileHeader *file_header   = (IndexFileHeader *)pdata;
+  file_header->attr_num          = 1;
   file_header->attr_length[0]    = attr_length;
+  file_header->attr_offset[0]    = 0;
+  file_header->field_id[0]       = 0;
   file_header->key_length        = attr_length + sizeof(RID);
   file_header->attr_type[0]      = attr_type;
   file_header->internal_max_size = internal_max_size;
   file_header->leaf_max_size     = leaf_max_size;
   file_header->root_page         = BP_INVALID_PAGE_NUM;
+  file_header->leaf_value_size   = leaf_value_size;
+  // 紧凑格式的节点中值固定是RID，叶子节点存放其它值时只能使用定长格式
+  file_header->key_format        = leaf_value_size > 0 ? static_cast<int32_t>(BplusTreeKeyFormat::FIXED)
+                                                       : choose_key_format(*file_header, key_format);
 
   // 取消记录日志的原因请参考下面的sync调用的地方。
   // mtr.logger().init_header_page(header_frame, *file_header);
@@ -905,7 +1145,8 @@ RC BplusTreeHandler::create(LogHandler &log_handler,
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const bool unique, const std::vector<int> &field_ids, const std::vector<const FieldMeta*> &fields, int internal_max_size, int leaf_max_size){
+RC BplusTreeHandler::create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const bool unique, const std::vector<int> &field_ids, const std::vector<const FieldMeta*> &fields, int internal_max_size, int leaf_max_size,
+    BplusTreeKeyFormat key_format /* = BplusTreeKeyFormat::FIXED */){
   RC rc = bpm.create_file(file_name);
   if (rc != RC::SUCCESS) {
     LOG_WARN("Failed to create file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
@@ -961,9 +1202,11 @@ RC BplusTreeHandler::create(LogHandler &log_handler, BufferPoolManager &bpm, con
     file_header->attr_offset[i] = fields[i]->offset();
     file_header->attr_length[i] = fields[i]->len();
   }
+  file_header->key_format = choose_key_format(*file_header, key_format);
 
   header_frame->mark_dirty();
 
+  log_handler_      = &log_handler;
   disk_buffer_pool_ = bp;
 
   memcpy(&file_header_, pdata, sizeof(file_header_));
@@ -1046,8 +1289,39 @@ RC BplusTreeHandler::open(LogHandler &log_handler, DiskBufferPool &buffer_pool)
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::reload_header()
+{
+  if (disk_buffer_pool_ == nullptr) {
+    LOG_WARN("b+tree has not been opened");
+    return RC::INTERNAL;
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = disk_buffer_pool_->get_this_page(FIRST_INDEX_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to get first page, rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  frame->read_latch();
+  memcpy(&file_header_, frame->data(), sizeof(IndexFileHeader));
+  frame->read_unlatch();
+  header_dirty_ = false;
+  disk_buffer_pool_->unpin_page(frame);
+
+  key_comparator_.init(file_header_.unique, file_header_.attr_num, file_header_.field_id, file_header_.attr_type, file_header_.attr_length);
+  key_printer_.init(file_header_.attr_num, file_header_.attr_type, file_header_.attr_length);
+  LOG_INFO("reload b+tree header done. root page=%d", file_header_.root_page);
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::close()
 {
+  if (adaptive_hash_ != nullptr) {
+    LOG_INFO("adaptive hash index stat: %s", adaptive_hash_->stat().to_string().c_str());
+    adaptive_hash_.reset();
+  }
+
   if (disk_buffer_pool_ != nullptr) {
     disk_buffer_pool_->close_file();
   }
@@ -1133,6 +1407,66 @@ RC BplusTreeHandler::print_tree()
   return rc;
 }
 
+string BplusTreeStat::to_string() const
+{
+  stringstream ss;
+  ss << "height:" << height << ",leaf nodes:" << leaf_count << ",internal nodes:" << internal_count
+     << ",entries:" << entry_count << ",leaf used bytes:" << leaf_used_bytes
+     << ",internal used bytes:" << internal_used_bytes << ",avg leaf entries:" << avg_leaf_entries()
+     << ",avg fanout:" << avg_fanout();
+  return ss.str();
+}
+
+RC BplusTreeHandler::stat(BplusTreeStat &stat)
+{
+  stat = BplusTreeStat();
+  if (disk_buffer_pool_ == nullptr || is_empty()) {
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = disk_buffer_pool_->get_this_page(file_header_.root_page, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch root page. page id=%d, rc=%s", file_header_.root_page, strrc(rc));
+    return rc;
+  }
+  return stat_node_recursive(frame, 1, stat);
+}
+
+RC BplusTreeHandler::stat_node_recursive(Frame *frame, int depth, BplusTreeStat &stat)
+{
+  BplusTreeMiniTransaction mtr(*this);
+  IndexNodeHandler         node(mtr, file_header_, frame);
+
+  stat.height = max(stat.height, depth);
+  if (node.is_leaf()) {
+    stat.leaf_count++;
+    stat.entry_count += node.size();
+    stat.leaf_used_bytes += node.used_bytes();
+    return disk_buffer_pool_->unpin_page(frame);
+  }
+
+  InternalIndexNodeHandler internal_node(mtr, file_header_, frame);
+  stat.internal_count++;
+  stat.internal_entry_count += internal_node.size();
+  stat.internal_used_bytes += internal_node.used_bytes();
+
+  RC rc = RC::SUCCESS;
+  for (int i = 0; OB_SUCC(rc) && i < internal_node.size(); i++) {
+    PageNum page_num    = internal_node.value_at(i);
+    Frame  *child_frame = nullptr;
+    rc                  = disk_buffer_pool_->get_this_page(page_num, &child_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch child page. page id=%d, rc=%s", page_num, strrc(rc));
+      break;
+    }
+    rc = stat_node_recursive(child_frame, depth + 1, stat);
+  }
+
+  disk_buffer_pool_->unpin_page(frame);
+  return rc;
+}
+
 RC BplusTreeHandler::print_leafs()
 {
   if (is_empty()) {
@@ -1286,6 +1620,16 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTree
 {
   LatchMemo &latch_memo = mtr.latch_memo();
 
+  // 读操作先尝试乐观地查找，失败几次后再退回到加锁的方式
+  if (op == BplusTreeOperationType::READ) {
+    for (int i = 0; i < OPTIMISTIC_READ_RETRY_TIMES; i++) {
+      RC rc = optimistic_find_leaf(mtr, child_page_getter, frame);
+      if (rc != RC::LOCKED_CONCURRENCY_CONFLICT) {
+        return rc;
+      }
+    }
+  }
+
   // root locked
   if (op != BplusTreeOperationType::READ) {
     latch_memo.xlatch(&root_lock_);
@@ -1319,6 +1663,164 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTree
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::optimistic_find_leaf(BplusTreeMiniTransaction &mtr,
+    const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame)
+{
+  // 内部节点先复制出来，校验版本号通过之后再解析，避免读到修改了一半的数据
+  static thread_local char node_copy[BP_PAGE_DATA_SIZE];
+
+  Frame   *current = nullptr;
+  uint64_t version = 0;
+
+  // 根节点可能会变化，要在持有 root_lock_ 时读取根节点的版本号
+  root_lock_.lock_shared();
+  if (is_empty()) {
+    root_lock_.unlock_shared();
+    return RC::EMPTY;
+  }
+
+  const PageNum root_page = file_header_.root_page;
+  RC            rc        = disk_buffer_pool_->get_this_page(root_page, &current);
+  if (OB_SUCC(rc)) {
+    version = current->version();
+  }
+  root_lock_.unlock_shared();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch root page. page id=%d, rc=%s", root_page, strrc(rc));
+    return rc;
+  }
+
+  while (true) {
+    if (Frame::is_version_locked(version)) {
+      break;
+    }
+
+    const bool is_leaf = ((IndexNode *)current->data())->is_leaf;
+    if (!current->validate_version(version)) {
+      break;
+    }
+
+    if (is_leaf) {
+      // 加读锁之后版本号没有变化，说明从父节点拿到这个页面之后它没有被修改过
+      current->read_latch();
+      if (!current->validate_version(version)) {
+        current->read_unlatch();
+        break;
+      }
+      mtr.latch_memo().adopt_page(current, LatchMemoType::SHARED);
+      frame = current;
+      return RC::SUCCESS;
+    }
+
+    int copy_size = BP_PAGE_DATA_SIZE;
+    if (file_header_.key_format == static_cast<int32_t>(BplusTreeKeyFormat::FIXED)) {
+      const int key_num = ((IndexNode *)current->data())->key_num;
+      const int size    = std::clamp(key_num, 0, file_header_.internal_max_size);
+      copy_size         = InternalIndexNode::HEADER_SIZE + size * (file_header_.key_length + static_cast<int>(sizeof(RID)));
+    }
+    memcpy(node_copy, current->data(), copy_size);
+    if (!current->validate_version(version)) {
+      break;
+    }
+
+    InternalIndexNodeHandler internal_node(mtr, file_header_, current, node_copy);
+    const PageNum            child_page = child_page_getter(internal_node);
+
+    Frame *child = nullptr;
+    rc           = disk_buffer_pool_->get_this_page(child_page, &child);
+    if (OB_FAIL(rc)) {
+      // 校验失败时页面编号可能是无效的，这时候不能报错
+      if (!current->validate_version(version)) {
+        break;
+      }
+      LOG_WARN("failed to load page. page num=%d, rc=%s", child_page, strrc(rc));
+      disk_buffer_pool_->unpin_page(current);
+      return rc;
+    }
+
+    const uint64_t child_version = child->version();
+    if (!current->validate_version(version)) {
+      disk_buffer_pool_->unpin_page(child);
+      break;
+    }
+
+    disk_buffer_pool_->unpin_page(current);
+    current = child;
+    version = child_version;
+  }
+
+  disk_buffer_pool_->unpin_page(current);
+  return RC::LOCKED_CONCURRENCY_CONFLICT;
+}
+
+void BplusTreeHandler::enable_adaptive_hash(const AdaptiveHashOptions &options)
+{
+  if (!options.enabled) {
+    adaptive_hash_.reset();
+    return;
+  }
+  adaptive_hash_ = make_unique<AdaptiveHashIndex>(options, file_header_.key_length);
+}
+
+bool BplusTreeHandler::adaptive_hash_stat(AdaptiveHashStat &stat) const
+{
+  if (adaptive_hash_ == nullptr) {
+    return false;
+  }
+  stat = adaptive_hash_->stat();
+  return true;
+}
+
+bool BplusTreeHandler::adaptive_hash_locate(BplusTreeMiniTransaction &mtr, const char *key, Frame *&frame, int &index)
+{
+  PageNum  page_num = BP_INVALID_PAGE_NUM;
+  uint64_t epoch    = 0;
+  if (!adaptive_hash_->lookup(key, page_num, epoch)) {
+    return false;
+  }
+
+  // 先检查一次版本，尽量不去访问已经释放的页面
+  if (!adaptive_hash_->validate(page_num, epoch)) {
+    adaptive_hash_->remove(key, true /*invalid*/);
+    return false;
+  }
+
+  LatchMemo &latch_memo = mtr.latch_memo();
+  Frame     *leaf_frame = nullptr;
+  if (OB_FAIL(latch_memo.get_page(page_num, leaf_frame))) {
+    adaptive_hash_->remove(key, true /*invalid*/);
+    return false;
+  }
+  latch_memo.slatch(leaf_frame);
+
+  // 释放页面之前一定持有页面的写锁并增加了版本，所以加读锁之后再检查一次
+  bool valid = adaptive_hash_->validate(page_num, epoch) && ((IndexNode *)leaf_frame->data())->is_leaf;
+  if (valid) {
+    LeafIndexNodeHandler leaf_node(mtr, file_header_, leaf_frame);
+    const int            position = leaf_node.lookup(key_comparator_, key);
+    // 前面有比它小的键值，当前位置的键值不比它小，这就是从根节点查找会得到的位置
+    valid = position > 0 && position < leaf_node.size();
+    index = position;
+  }
+
+  if (!valid) {
+    latch_memo.release();
+    adaptive_hash_->remove(key, true /*invalid*/);
+    return false;
+  }
+
+  adaptive_hash_->record_hit();
+  frame = leaf_frame;
+  return true;
+}
+
+void BplusTreeHandler::invalidate_adaptive_hash(PageNum page_num)
+{
+  if (adaptive_hash_ != nullptr) {
+    adaptive_hash_->invalidate_page(page_num);
+  }
+}
+
 RC BplusTreeHandler::crabing_protocal_fetch_page(
     BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, PageNum page_num, bool is_root_node, Frame *&frame)
 {
@@ -1341,7 +1843,7 @@ RC BplusTreeHandler::crabing_protocal_fetch_page(
   return rc;
 }
 
-RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *key, const RID *rid)
+RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *key, const char *value)
 {
   LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
   bool                 exists          = false;  // 该数据是否已经存在指定的叶子节点中了
@@ -1351,8 +1853,8 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr,
     return RC::RECORD_DUPLICATE_KEY;
   }
 
-  if (leaf_node.size() < leaf_node.max_size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+  if (leaf_node.can_insert(key)) {
+    leaf_node.insert(insert_position, key, value);
     frame->mark_dirty();
     // disk_buffer_pool_->unpin_page(frame); // unpin pages 由latch memo 来操作
     return RC::SUCCESS;
@@ -1371,12 +1873,26 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr,
   leaf_node.set_next_page(new_frame->page_num());
 
   if (insert_position < leaf_node.size()) {
-    leaf_node.insert(insert_position, key, (const char *)rid);
+    leaf_node.insert(insert_position, key, value);
   } else {
-    new_index_node.insert(insert_position - leaf_node.size(), key, (const char *)rid);
+    new_index_node.insert(insert_position - leaf_node.size(), key, value);
+  }
+
+  const char *separator = new_index_node.key_at(0);
+  vector<char> separator_buffer;
+  if (new_index_node.is_compact()) {
+    // 后缀截断：父节点中只需要一个能区分左右两个节点的最短键值
+    separator_buffer.resize(file_header_.key_length);
+    CompactKeyCodec codec(file_header_);
+    const char     *left_key = leaf_node.key_at(leaf_node.size() - 1);
+    if (codec.shortest_separator(left_key, separator, separator_buffer.data()) &&
+        key_comparator_(left_key, separator_buffer.data()) < 0 &&
+        key_comparator_(separator_buffer.data(), separator) <= 0) {
+      separator = separator_buffer.data();
+    }
   }
 
-  return insert_entry_into_parent(mtr, frame, new_frame, new_index_node.key_at(0));
+  return insert_entry_into_parent(mtr, frame, new_frame, separator);
 }
 
 RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *new_frame, const char *key)
@@ -1431,7 +1947,7 @@ RC BplusTreeHandler::insert_entry_into_parent(BplusTreeMiniTransaction &mtr, Fra
     InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
 
     /// 当前这个父节点还没有满，直接将新节点数据插进入就行了
-    if (parent_node.size() < parent_node.max_size()) {
+    if (parent_node.can_insert(key)) {
       parent_node.insert(key, new_frame->page_num(), key_comparator_);
       new_node_handler.set_parent_page_num(parent_page_num);
 
@@ -1499,6 +2015,7 @@ RC BplusTreeHandler::split(BplusTreeMiniTransaction &mtr, Frame *frame, Frame *&
   new_node.set_parent_page_num(old_node.parent_page_num());
 
   old_node.move_half_to(new_node);
+  invalidate_adaptive_hash(frame->page_num());
 
   frame->mark_dirty();
   new_frame->mark_dirty();
@@ -1538,7 +2055,7 @@ void BplusTreeHandler::update_root_page_num_locked(BplusTreeMiniTransaction &mtr
   LOG_DEBUG("set root page to %d", root_page_num);
 }
 
-RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const RID *rid)
+RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const char *value)
 {
   RC rc = RC::SUCCESS;
   if (file_header_.root_page != BP_INVALID_PAGE_NUM) {
@@ -1557,7 +2074,7 @@ RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *
 
   LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
   leaf_node.init_empty();
-  leaf_node.insert(0, key, (const char *)rid);
+  leaf_node.insert(0, key, value);
   update_root_page_num_locked(mtr, frame->page_num());
   frame->mark_dirty();
 
@@ -1565,21 +2082,95 @@ RC BplusTreeHandler::create_new_tree(BplusTreeMiniTransaction &mtr, const char *
   return rc;
 }
 
-MemPoolItem::item_unique_ptr BplusTreeHandler::make_key(const char *user_key, const RID &rid)
+MemPoolItem::item_unique_ptr BplusTreeHandler::make_key(const char *record, const RID &rid)
 {
   MemPoolItem::item_unique_ptr key = mem_pool_item_->alloc_unique_ptr();
   if (key == nullptr) {
     LOG_WARN("Failed to alloc memory for key.");
     return nullptr;
   }
-  memcpy(static_cast<char *>(key.get()), user_key, (size_t)(file_header_.attr_length));
-  memcpy(static_cast<char *>(key.get()) + (size_t)(file_header_.attr_length), &rid, sizeof(rid));
+
+  fill_key(record, rid, static_cast<char *>(key.get()));
+  return key;
+}
+
+void BplusTreeHandler::fill_key(const char *record, const RID &rid, char *key) const
+{
+  int offset = 0;
+  for (int i = 0; i < file_header_.attr_num; i++) {
+    memcpy(key + offset, record + file_header_.attr_offset[i], file_header_.attr_length[i]);
+    offset += file_header_.attr_length[i];
+  }
+  memcpy(key + offset, &rid, sizeof(rid));
+}
+
+MemPoolItem::item_unique_ptr BplusTreeHandler::make_scan_key(
+    const char *user_key, const RID &rid, bool low_bound, int attr_num)
+{
+  MemPoolItem::item_unique_ptr key = mem_pool_item_->alloc_unique_ptr();
+  if (key == nullptr) {
+    LOG_WARN("Failed to alloc memory for key.");
+    return nullptr;
+  }
+
+  char *pkey = static_cast<char *>(key.get());
+  memset(pkey, 0, file_header_.key_length);
+
+  const AttrComparator &attr_comparator = key_comparator_.attr_comparator();
+  const int             first           = attr_comparator.first_key_attr();
+  ASSERT(attr_num >= 1 && attr_num <= attr_comparator.key_attr_num(), "invalid attr num %d", attr_num);
+
+  // 位图全部清零，表示前 attr_num 个属性不是null
+  int offset = 0;
+  for (int i = 0; i < first; i++) {
+    offset += file_header_.attr_length[i];
+  }
+  int user_key_len = 0;
+  for (int i = first; i < first + attr_num; i++) {
+    user_key_len += file_header_.attr_length[i];
+  }
+  memcpy(pkey + offset, user_key, user_key_len);
+  offset += user_key_len;
+
+  for (int i = first + attr_num; i < file_header_.attr_num; i++) {
+    if (low_bound) {
+      // null 比任何值都小
+      common::Bitmap null_map(pkey, file_header_.attr_length[0] * 8);
+      null_map.set_bit(file_header_.field_id[i]);
+    } else {
+      switch (file_header_.attr_type[i]) {
+        case INTS:
+        case DATES: {
+          const int max_value = numeric_limits<int>::max();
+          memcpy(pkey + offset, &max_value, sizeof(max_value));
+        } break;
+        case FLOATS: {
+          const float max_value = numeric_limits<float>::max();
+          memcpy(pkey + offset, &max_value, sizeof(max_value));
+        } break;
+        default: {
+          memset(pkey + offset, 0xff, file_header_.attr_length[i]);
+        } break;
+      }
+    }
+    offset += file_header_.attr_length[i];
+  }
+  memcpy(pkey + offset, &rid, sizeof(rid));
   return key;
 }
 
 RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
 {
-  if (user_key == nullptr || rid == nullptr) {
+  if (file_header_.leaf_value_size > 0) {
+    LOG_WARN("the value of leaf node is not rid, use insert_entry with value instead");
+    return RC::INVALID_ARGUMENT;
+  }
+  return insert_entry(user_key, rid, reinterpret_cast<const char *>(rid));
+}
+
+RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid, const char *value)
+{
+  if (user_key == nullptr || rid == nullptr || value == nullptr) {
     LOG_WARN("Invalid arguments, key is empty or rid is empty");
     return RC::INVALID_ARGUMENT;
   }
@@ -1599,7 +2190,7 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
   if (is_empty()) {
     root_lock_.lock();
     if (is_empty()) {
-      rc = create_new_tree(mtr, key, rid);
+      rc = create_new_tree(mtr, key, value);
       root_lock_.unlock();
       return rc;
     }
@@ -1614,7 +2205,7 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
     return rc;
   }
 
-  rc = insert_entry_into_leaf_node(mtr, frame, key, rid);
+  rc = insert_entry_into_leaf_node(mtr, frame, key, value);
   if (OB_FAIL(rc)) {
     LOG_TRACE("Failed to insert into leaf of index, rid:%s. rc=%s", rid->to_string().c_str(), strrc(rc));
     return rc;
@@ -1647,6 +2238,42 @@ RC BplusTreeHandler::get_entry(const char *user_key, int key_len, list<RID> &rid
   return rc;
 }
 
+RC BplusTreeHandler::get_entries(
+    const vector<const char *> &user_keys, const vector<int> &key_lens, vector<list<RID>> &rids, int attr_num)
+{
+  if (user_keys.size() != key_lens.size()) {
+    LOG_WARN("invalid argument. key number=%d, key length number=%d", user_keys.size(), key_lens.size());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  rids.clear();
+  rids.resize(user_keys.size());
+
+  // 使用同一个扫描器，它会一直持有上一个键值所在的叶子节点
+  BplusTreeScanner scanner(*this);
+  RC               rc = RC::SUCCESS;
+  for (size_t i = 0; i < user_keys.size(); i++) {
+    rc = scanner.seek(user_keys[i], key_lens[i], attr_num);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to seek scanner. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    RID rid;
+    while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+      rids[i].push_back(rid);
+    }
+
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("scanner return error. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  scanner.close();
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_frame)
 {
   LatchMemo &latch_memo = mtr.latch_memo();
@@ -1684,6 +2311,7 @@ RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_fram
   update_root_page_num_locked(mtr, new_root_page_num);
 
   PageNum old_root_page_num = root_frame->page_num();
+  invalidate_adaptive_hash(old_root_page_num);
   latch_memo.dispose_page(old_root_page_num);
   return RC::SUCCESS;
 }
@@ -1694,7 +2322,7 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
   LatchMemo &latch_memo = mtr.latch_memo();
 
   IndexNodeHandlerType index_node(mtr, file_header_, frame);
-  if (index_node.size() >= index_node.min_size()) {
+  if (!index_node.is_underflow()) {
     return RC::SUCCESS;
   }
 
@@ -1719,7 +2347,9 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
 
   InternalIndexNodeHandler parent_index_node(mtr, file_header_, parent_frame);
 
-  int index = parent_index_node.lookup(key_comparator_, index_node.key_at(index_node.size() - 1));
+  // 紧凑格式的节点可能因为父节点放不下新的键值而没有重新分配，最终变成空节点
+  int index = index_node.size() > 0 ? parent_index_node.lookup(key_comparator_, index_node.key_at(index_node.size() - 1))
+                                    : parent_index_node.value_index(frame->page_num());
   ASSERT(parent_index_node.value_at(index) == frame->page_num(),
          "lookup return an invalid value. index=%d, this page num=%d, but got %d",
          index, frame->page_num(), parent_index_node.value_at(index));
@@ -1744,7 +2374,7 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
   latch_memo.xlatch(neighbor_frame);
 
   IndexNodeHandlerType neighbor_node(mtr, file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
+  if (!index_node.can_coalesce_with(neighbor_node)) {
     rc = redistribute<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
   } else {
     rc = coalesce<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
@@ -1804,6 +2434,9 @@ RC BplusTreeHandler::coalesce(
     left_leaf_node.set_next_page(right_leaf_node.next_page());
   }
 
+  invalidate_adaptive_hash(left_frame->page_num());
+  invalidate_adaptive_hash(right_frame->page_num());
+
   // 释放右边节点
   mtr.latch_memo().dispose_page(right_frame->page_num());
 
@@ -1817,9 +2450,20 @@ RC BplusTreeHandler::redistribute(BplusTreeMiniTransaction &mtr, Frame *neighbor
   InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
   IndexNodeHandlerType     neighbor_node(mtr, file_header_, neighbor_frame);
   IndexNodeHandlerType     node(mtr, file_header_, frame);
-  if (neighbor_node.size() < node.size()) {
+  if (!node.is_compact() && neighbor_node.size() < node.size()) {
     LOG_ERROR("got invalid nodes. neighbor node size %d, this node size %d", neighbor_node.size(), node.size());
   }
+
+  if (node.is_compact()) {
+    // 紧凑格式中新的分隔键可能更长，父节点放不下时就不再调整，当前节点暂时保持较低的填充率
+    const int   parent_index = (index == 0) ? index + 1 : index;
+    const char *new_key      = (index == 0) ? neighbor_node.key_at(1) : neighbor_node.key_at(neighbor_node.size() - 1);
+    if (neighbor_node.size() < 2 || !parent_node.can_set_key_at(parent_index, new_key)) {
+      LOG_TRACE("skip redistribute as parent node has no enough space. parent page num=%d", parent_node.page_num());
+      return RC::SUCCESS;
+    }
+  }
+
   if (index == 0) {
     // the neighbor is at right
     neighbor_node.move_first_to_end(node);
@@ -1836,6 +2480,9 @@ RC BplusTreeHandler::redistribute(BplusTreeMiniTransaction &mtr, Frame *neighbor
     // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
   }
 
+  invalidate_adaptive_hash(neighbor_frame->page_num());
+  invalidate_adaptive_hash(frame->page_num());
+
   neighbor_frame->mark_dirty();
   frame->mark_dirty();
   parent_frame->mark_dirty();
@@ -1857,7 +2504,7 @@ RC BplusTreeHandler::delete_entry_internal(BplusTreeMiniTransaction &mtr, Frame
 
   leaf_frame->mark_dirty();
 
-  if (leaf_index_node.size() >= leaf_index_node.min_size()) {
+  if (!leaf_index_node.is_underflow()) {
     return RC::SUCCESS;
   }
 
@@ -1866,16 +2513,13 @@ RC BplusTreeHandler::delete_entry_internal(BplusTreeMiniTransaction &mtr, Frame
 
 RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
 {
-  MemPoolItem::item_unique_ptr pkey = mem_pool_item_->alloc_unique_ptr();
+  MemPoolItem::item_unique_ptr pkey = make_key(user_key, *rid);
   if (nullptr == pkey) {
     LOG_WARN("Failed to alloc memory for key. size=%d", file_header_.key_length);
     return RC::NOMEM;
   }
   char *key = static_cast<char *>(pkey.get());
 
-  memcpy(key, user_key, (size_t)(file_header_.attr_length));
-  memcpy(key + (size_t)(file_header_.attr_length), rid, sizeof(*rid));
-
   BplusTreeOperationType op = BplusTreeOperationType::DELETE;
 
   RC rc = RC::SUCCESS;
@@ -1899,6 +2543,91 @@ RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
   return rc;
 }
 
+RC BplusTreeHandler::get_value(const char *user_key, const RID *rid, char *value)
+{
+  MemPoolItem::item_unique_ptr pkey = make_key(user_key, *rid);
+  if (nullptr == pkey) {
+    LOG_WARN("Failed to alloc memory for key. size=%d", file_header_.key_length);
+    return RC::NOMEM;
+  }
+  char *key = static_cast<char *>(pkey.get());
+
+  BplusTreeMiniTransaction mtr(*this);
+
+  Frame *frame = nullptr;
+  RC     rc    = find_leaf(mtr, BplusTreeOperationType::READ, key, frame);
+  if (rc == RC::EMPTY) {
+    return RC::RECORD_NOT_EXIST;
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find leaf page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
+  bool                 found = false;
+  const int            index = leaf_node.lookup(key_comparator_, key, &found);
+  if (!found) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  memcpy(value, leaf_node.value_at(index), leaf_node.value_size());
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::update_value(const char *user_key, const RID *rid, const function<bool(char *value)> &updater)
+{
+  MemPoolItem::item_unique_ptr pkey = make_key(user_key, *rid);
+  if (nullptr == pkey) {
+    LOG_WARN("Failed to alloc memory for key. size=%d", file_header_.key_length);
+    return RC::NOMEM;
+  }
+  char *key = static_cast<char *>(pkey.get());
+
+  RC rc = RC::SUCCESS;
+
+  BplusTreeMiniTransaction mtr(*this, &rc);
+
+  Frame *frame = nullptr;
+  rc           = find_leaf(mtr, BplusTreeOperationType::UPDATE, key, frame);
+  if (rc == RC::EMPTY) {
+    rc = RC::RECORD_NOT_EXIST;
+    return rc;
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find leaf page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LeafIndexNodeHandler leaf_node(mtr, file_header_, frame);
+  bool                 found = false;
+  const int            index = leaf_node.lookup(key_comparator_, key, &found);
+  if (!found) {
+    rc = RC::RECORD_NOT_EXIST;
+    return rc;
+  }
+
+  vector<char> value(leaf_node.value_size());
+  memcpy(value.data(), leaf_node.value_at(index), value.size());
+  if (!updater(value.data())) {
+    return rc;
+  }
+
+  // 日志只记录元素的插入和删除，修改值就是在同一个位置先删除再插入，节点中的元素个数不变
+  rc = leaf_node.remove(index);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to remove item. rc=%s", strrc(rc));
+    return rc;
+  }
+  rc = leaf_node.insert(index, key, value.data());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert item. rc=%s", strrc(rc));
+    return rc;
+  }
+  frame->mark_dirty();
+  return rc;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &tree_handler)
@@ -1908,7 +2637,7 @@ BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &tree_handler)
 BplusTreeScanner::~BplusTreeScanner() { close(); }
 
 RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key,
-    int right_len, bool right_inclusive)
+    int right_len, bool right_inclusive, int left_attr_num, int right_attr_num)
 {
   RC rc = RC::SUCCESS;
   if (inited_) {
@@ -1919,20 +2648,49 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
   inited_        = true;
   first_emitted_ = false;
 
-  LatchMemo &latch_memo = mtr_.latch_memo();
+  const AttrComparator &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
+
+  bool point_probe = false;  // 左右边界相同，是等值查找
+
+  MemPoolItem::item_unique_ptr left_pkey;
+  if (nullptr != left_user_key) {
+    rc = make_bound_key(left_user_key, left_len, left_attr_num, true /*left_bound*/, left_inclusive, left_pkey);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to make left key. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  // 没有指定右边界范围，那么就返回右边界最大值
+  if (nullptr == right_user_key) {
+    right_key_ = nullptr;
+  } else {
+    rc = make_bound_key(right_user_key, right_len, right_attr_num, false /*left_bound*/, right_inclusive, right_key_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to make right key. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
 
-  // 校验输入的键值是否是合法范围
-  if (left_user_key && right_user_key) {
-    const auto &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
-    const int   result          = attr_comparator(left_user_key, right_user_key);
+  // 校验输入的键值是否是合法范围。没有指定的属性已经填充了最小值或最大值，可以直接参与比较
+  if (left_pkey != nullptr && right_key_ != nullptr) {
+    const int result = attr_comparator.compare(static_cast<const char *>(left_pkey.get()),
+        static_cast<const char *>(right_key_.get()),
+        std::max(left_attr_num, right_attr_num) /*attr_count*/);
     if (result > 0 ||  // left < right
                        // left == right but is (left,right)/[left,right) or (left,right]
         (result == 0 && (left_inclusive == false || right_inclusive == false))) {
+      right_key_ = nullptr;
       return RC::INVALID_ARGUMENT;
     }
+    point_probe = (result == 0);
   }
 
-  if (nullptr == left_user_key) {
+  if (nullptr == left_pkey) {
+    if (tree_handler_.adaptive_hash_ != nullptr) {
+      tree_handler_.adaptive_hash_->record_probe(false /*point*/);
+    }
+
     rc = tree_handler_.left_most_page(mtr_, current_frame_);
     if (OB_FAIL(rc)) {
       if (rc == RC::EMPTY) {
@@ -1946,109 +2704,194 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
     iter_index_ = 0;
   } else {
+    rc = locate(static_cast<const char *>(left_pkey.get()), point_probe);
+    if (OB_FAIL(rc) || nullptr == current_frame_) {
+      return rc;
+    }
+  }
 
-    char *fixed_left_key = const_cast<char *>(left_user_key);
-    if (tree_handler_.file_header_.attr_type[1] == AttrType::CHARS) {
-      bool should_inclusive_after_fix = false;
-      rc = fix_user_key(left_user_key, left_len, true /*greater*/, &fixed_left_key, &should_inclusive_after_fix);
-      if (OB_FAIL(rc)) {
-        LOG_WARN("failed to fix left user key. rc=%s", strrc(rc));
-        return rc;
-      }
+  if (touch_end()) {
+    current_frame_ = nullptr;
+  }
 
-      if (should_inclusive_after_fix) {
-        left_inclusive = true;
-      }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::make_bound_key(const char *user_key, int key_len, int attr_num, bool left_bound, bool &inclusive,
+    MemPoolItem::item_unique_ptr &key)
+{
+  const AttrComparator  &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
+  const IndexFileHeader &file_header     = tree_handler_.file_header_;
+  if (attr_num < 1 || attr_num > attr_comparator.key_attr_num()) {
+    LOG_WARN("invalid attr num. attr num=%d, key attr num=%d", attr_num, attr_comparator.key_attr_num());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int last_attr  = attr_comparator.first_key_attr() + attr_num - 1;
+  int       prefix_len = 0;  // 最后一个属性之前的属性，都已经是完整的长度
+  for (int i = attr_comparator.first_key_attr(); i < last_attr; i++) {
+    prefix_len += file_header.attr_length[i];
+  }
+
+  char *fixed_key = const_cast<char *>(user_key);
+  if (file_header.attr_type[last_attr] == AttrType::CHARS) {
+    bool  should_inclusive_after_fix = false;
+    char *fixed_attr                 = nullptr;
+
+    RC rc = fix_user_key(
+        user_key + prefix_len, key_len, last_attr, left_bound /*want_greater*/, &fixed_attr, &should_inclusive_after_fix);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fix user key. rc=%s", strrc(rc));
+      return rc;
     }
 
-    MemPoolItem::item_unique_ptr left_pkey;
-    if (left_inclusive) {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::min());
+    if (prefix_len == 0) {
+      fixed_key = fixed_attr;
     } else {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::max());
+      fixed_key = new char[prefix_len + file_header.attr_length[last_attr]];
+      memcpy(fixed_key, user_key, prefix_len);
+      memcpy(fixed_key + prefix_len, fixed_attr, file_header.attr_length[last_attr]);
+      delete[] fixed_attr;
     }
 
-    const char *left_key = (const char *)left_pkey.get();
-
-    if (fixed_left_key != left_user_key) {
-      delete[] fixed_left_key;
-      fixed_left_key = nullptr;
+    if (should_inclusive_after_fix) {
+      inclusive = true;
     }
+  }
 
-    rc = tree_handler_.find_leaf(mtr_, BplusTreeOperationType::READ, left_key, current_frame_);
-    if (rc == RC::EMPTY) {
-      rc             = RC::SUCCESS;
-      current_frame_ = nullptr;
-      return rc;
-    } else if (OB_FAIL(rc)) {
-      LOG_WARN("failed to find left page. rc=%s", strrc(rc));
-      return rc;
-    }
+  // 左边界包含自身或者右边界不包含自身时，使用最小的RID，其它情况使用最大的RID
+  const bool use_min_rid = (left_bound == inclusive);
+  key                    = tree_handler_.make_scan_key(
+      fixed_key, use_min_rid ? *RID::min() : *RID::max(), use_min_rid /*low_bound*/, attr_num);
 
-    LeafIndexNodeHandler left_node(mtr_, tree_handler_.file_header_, current_frame_);
-    int                  left_index = left_node.lookup(tree_handler_.key_comparator_, left_key);
-    // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
-    if (left_index >= left_node.size()) {  // 超出了当前页，就需要向后移动一个位置
-      const PageNum next_page_num = left_node.next_page();
-      if (next_page_num == BP_INVALID_PAGE_NUM) {  // 这里已经是最后一页，说明当前扫描，没有数据
-        latch_memo.release();
-        current_frame_ = nullptr;
-        return RC::SUCCESS;
-      }
+  if (fixed_key != user_key) {
+    delete[] fixed_key;
+    fixed_key = nullptr;
+  }
+  return RC::SUCCESS;
+}
 
-      rc = latch_memo.get_page(next_page_num, current_frame_);
-      if (OB_FAIL(rc)) {
-        LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
-        return rc;
-      }
-      latch_memo.slatch(current_frame_);
+RC BplusTreeScanner::locate(const char *left_key, bool point_probe)
+{
+  LatchMemo &latch_memo = mtr_.latch_memo();
 
-      left_index = 0;
+  AdaptiveHashIndex *adaptive_hash = tree_handler_.adaptive_hash_.get();
+  if (adaptive_hash != nullptr) {
+    adaptive_hash->record_probe(point_probe);
+    if (point_probe && tree_handler_.adaptive_hash_locate(mtr_, left_key, current_frame_, iter_index_)) {
+      return RC::SUCCESS;
     }
-    iter_index_ = left_index;
   }
 
-  // 没有指定右边界范围，那么就返回右边界最大值
-  if (nullptr == right_user_key) {
-    right_key_ = nullptr;
-  } else {
+  RC rc = tree_handler_.find_leaf(mtr_, BplusTreeOperationType::READ, left_key, current_frame_);
+  if (rc == RC::EMPTY) {
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
+  } else if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find left page. rc=%s", strrc(rc));
+    return rc;
+  }
 
-    char *fixed_right_key          = const_cast<char *>(right_user_key);
-    bool  should_include_after_fix = false;
-    if (tree_handler_.file_header_.attr_type[1] == AttrType::CHARS) {
-      rc = fix_user_key(right_user_key, right_len, false /*want_greater*/, &fixed_right_key, &should_include_after_fix);
-      if (OB_FAIL(rc)) {
-        LOG_WARN("failed to fix right user key. rc=%s", strrc(rc));
-        return rc;
-      }
+  LeafIndexNodeHandler left_node(mtr_, tree_handler_.file_header_, current_frame_);
+  int                  left_index = left_node.lookup(tree_handler_.key_comparator_, left_key);
 
-      if (should_include_after_fix) {
-        right_inclusive = true;
-      }
+  // 记录等值查找的位置，只记录校验时可以确认的位置，参考 adaptive_hash_locate
+  if (point_probe && adaptive_hash != nullptr && adaptive_hash->building() && left_index > 0 &&
+      left_index < left_node.size()) {
+    adaptive_hash->insert(left_key, current_frame_->page_num());
+  }
+  // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
+  if (left_index >= left_node.size()) {  // 超出了当前页，就需要向后移动一个位置
+    const PageNum next_page_num = left_node.next_page();
+    if (next_page_num == BP_INVALID_PAGE_NUM) {  // 这里已经是最后一页，说明当前扫描，没有数据
+      latch_memo.release();
+      current_frame_ = nullptr;
+      return RC::SUCCESS;
     }
-    if (right_inclusive) {
-      right_key_ = tree_handler_.make_key(fixed_right_key, *RID::max());
-    } else {
-      right_key_ = tree_handler_.make_key(fixed_right_key, *RID::min());
+
+    rc = latch_memo.get_page(next_page_num, current_frame_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+      return rc;
     }
+    latch_memo.slatch(current_frame_);
+
+    left_index = 0;
+  }
+  iter_index_ = left_index;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::seek(const char *user_key, int key_len, int attr_num)
+{
+  inited_ = true;
 
-    if (fixed_right_key != right_user_key) {
-      delete[] fixed_right_key;
-      fixed_right_key = nullptr;
+  bool                         left_inclusive  = true;
+  bool                         right_inclusive = true;
+  MemPoolItem::item_unique_ptr left_pkey;
+  RC rc = make_bound_key(user_key, key_len, attr_num, true /*left_bound*/, left_inclusive, left_pkey);
+  if (OB_SUCC(rc)) {
+    rc = make_bound_key(user_key, key_len, attr_num, false /*left_bound*/, right_inclusive, right_key_);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to make seek key. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const char *left_key = static_cast<const char *>(left_pkey.get());
+
+  // 如果插入位置在叶子节点中间，前一条数据比它小，后一条数据不比它小，那么数据一定从这里开始
+  bool located = false;
+  if (current_frame_ != nullptr) {
+    LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+    const int            index = node.lookup(tree_handler_.key_comparator_, left_key);
+    if (index > 0 && index < node.size()) {
+      iter_index_ = index;
+      located     = true;
     }
   }
 
-  if (touch_end()) {
+  if (!located) {
+    mtr_.latch_memo().release();
     current_frame_ = nullptr;
+
+    rc = locate(left_key, true /*point_probe*/);
+    if (OB_FAIL(rc) || nullptr == current_frame_) {
+      return rc;
+    }
   }
 
+  // 第一条数据也需要经过 next_entry 的边界检查，所以这里退一个位置。
+  // 不能像 open 一样把 current_frame_ 置空，下一次 seek 还要用到这个叶子节点
+  first_emitted_ = true;
+  iter_index_--;
   return RC::SUCCESS;
 }
 
 void BplusTreeScanner::fetch_item(RID &rid)
 {
   LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
-  memcpy(&rid, node.value_at(iter_index_), sizeof(rid));
+  if (tree_handler_.file_header_.leaf_value_size > 0) {
+    // 值不是RID时，从键值的最后取出RID
+    memcpy(&rid, node.key_at(iter_index_) + tree_handler_.file_header_.key_length - sizeof(RID), sizeof(rid));
+  } else {
+    memcpy(&rid, node.value_at(iter_index_), sizeof(rid));
+  }
+}
+
+const char *BplusTreeScanner::current_value()
+{
+  if (nullptr == current_frame_ || iter_index_ < 0) {
+    return nullptr;
+  }
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  return node.value_at(iter_index_);
+}
+
+void BplusTreeScanner::fetch_key(char *key)
+{
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  memcpy(key, node.key_at(iter_index_), tree_handler_.file_header_.key_length - sizeof(RID));
 }
 
 bool BplusTreeScanner::touch_end()
@@ -2118,6 +2961,58 @@ RC BplusTreeScanner::next_entry(RID &rid)
   return next_entry(rid);
 }
 
+RC BplusTreeScanner::next_batch(RID *rids, int capacity, int &count, char *keys)
+{
+  count = 0;
+
+  const int key_len = tree_handler_.file_header_.key_length - static_cast<int>(sizeof(RID));
+
+  RC   rc        = RC::SUCCESS;
+  bool reach_end = false;
+  while (count < capacity) {
+    // 当前叶子节点中的数据直接复制，翻页和第一条数据交给 next_entry 处理
+    if (current_frame_ != nullptr && first_emitted_) {
+      LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+      const int            size = node.size();
+      while (count < capacity && iter_index_ + 1 < size) {
+        iter_index_++;
+        if (touch_end()) {
+          // 保留当前位置，不把 current_frame_ 置空，seek 之后还可以继续使用这个叶子节点
+          iter_index_--;
+          reach_end = true;
+          break;
+        }
+        fetch_item(rids[count]);
+        if (keys != nullptr) {
+          fetch_key(keys + count * key_len);
+        }
+        count++;
+      }
+
+      if (count >= capacity || reach_end) {
+        rc = (reach_end && count == 0) ? RC::RECORD_EOF : RC::SUCCESS;
+        break;
+      }
+    }
+
+    rc = next_entry(rids[count]);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+    if (keys != nullptr) {
+      fetch_key(keys + count * key_len);
+    }
+    count++;
+  }
+
+  if (rc == RC::RECORD_EOF && count > 0) {
+    rc = RC::SUCCESS;
+  } else if (rc == RC::SUCCESS && count == 0) {
+    rc = RC::RECORD_EOF;
+  }
+  return rc;
+}
+
 RC BplusTreeScanner::close()
 {
   inited_ = false;
@@ -2126,19 +3021,19 @@ RC BplusTreeScanner::close()
 }
 
 RC BplusTreeScanner::fix_user_key(
-    const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive)
+    const char *user_key, int key_len, int attr, bool want_greater, char **fixed_key, bool *should_inclusive)
 {
   if (nullptr == fixed_key || nullptr == should_inclusive) {
     return RC::INVALID_ARGUMENT;
   }
 
   // 这里很粗暴，变长字段才需要做调整，其它默认都不需要做调整
-  assert(tree_handler_.file_header_.attr_type[1] == AttrType::CHARS);
+  assert(tree_handler_.file_header_.attr_type[attr] == AttrType::CHARS);
   assert(strlen(user_key) >= static_cast<size_t>(key_len));
 
   *should_inclusive = false;
 
-  int32_t attr_length = tree_handler_.file_header_.attr_length[1];
+  int32_t attr_length = tree_handler_.file_header_.attr_length[attr];
   char   *key_buf     = new char[attr_length];
   if (nullptr == key_buf) {
     return RC::NOMEM;
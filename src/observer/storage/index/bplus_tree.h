@@ -28,7 +28,9 @@ See the Mulan PSL v2 for more details. */
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/record/record_manager.h"
 #include "storage/index/latch_memo.h"
+#include "storage/index/bplus_tree_adaptive_hash.h"
 #include "storage/index/bplus_tree_log.h"
+#include "storage/index/bplus_tree_compact_node.h"
 
 class BplusTreeHandler;
 class BplusTreeMiniTransaction;
@@ -47,6 +49,7 @@ enum class BplusTreeOperationType
   READ,
   INSERT,
   DELETE,
+  UPDATE,  ///< 只修改叶子节点中的值，不会改变树的结构
 };
 
 /**
@@ -56,9 +59,17 @@ enum class BplusTreeOperationType
 class AttrComparator
 {
 public:
-  void init(int attr_num, int *field_id, AttrType *type, int *length){
+  /**
+   * @brief 初始化比较器
+   * @param field_id 每个属性在表中的字段编号，用于查询null位图。单字段索引可以传nullptr
+   */
+  void init(int attr_num, const int *field_id, const AttrType *type, const int *length)
+  {
+    field_id_.clear();
+    attr_type_.clear();
+    attr_length_.clear();
     for (int i = 0; i < attr_num; i++) {
-      field_id_.emplace_back(field_id[i]);
+      field_id_.emplace_back(field_id == nullptr ? i : field_id[i]);
       attr_type_.emplace_back(type[i]);
       attr_length_.emplace_back(length[i]);
     }
@@ -71,50 +82,67 @@ public:
     }
     return l;
   }
-  
-  int operator()(const char *v1, const char *v2) const
+
+  /**
+   * @brief 多字段创建的索引，第一个属性是记录的null位图，不参与比较
+   * @details 只有一个属性的索引(直接使用类型和长度创建的B+树)没有位图
+   */
+  bool has_null_bitmap() const { return attr_type_.size() > 1; }
+  /// 第一个参与比较的属性的下标
+  int  first_key_attr() const { return has_null_bitmap() ? 1 : 0; }
+  /// 参与比较的属性个数
+  int  key_attr_num() const { return static_cast<int>(attr_type_.size()) - first_key_attr(); }
+
+  int operator()(const char *v1, const char *v2) const { return compare(v1, v2, key_attr_num()); }
+
+  /**
+   * @brief 只比较前 attr_count 个参与比较的属性
+   * @details null值比任何非null值都小，两个null值相等
+   */
+  int compare(const char *v1, const char *v2, int attr_count) const
   {
     int cmp = 0;
-    
-    int offset = attr_length_[0];
-    common::Bitmap l_map(const_cast<char*>(v1), attr_length_[0] * 8);
-    common::Bitmap r_map(const_cast<char*>(v2), attr_length_[0] * 8);
-    for (size_t i = 1; i < attr_type_.size(); i++) {
-      
-      if (l_map.get_bit(field_id_[i]) == true || r_map.get_bit(field_id_[i]) == true) {
-        return -1;
+
+    const bool   has_bitmap = has_null_bitmap();
+    const size_t first      = first_key_attr();
+    const size_t last       = std::min(attr_type_.size(), first + attr_count);
+
+    int offset = has_bitmap ? attr_length_[0] : 0;
+    common::Bitmap l_map(const_cast<char *>(v1), has_bitmap ? attr_length_[0] * 8 : 0);
+    common::Bitmap r_map(const_cast<char *>(v2), has_bitmap ? attr_length_[0] * 8 : 0);
+    for (size_t i = first; i < last; i++) {
+      if (has_bitmap) {
+        const bool l_null = l_map.get_bit(field_id_[i]);
+        const bool r_null = r_map.get_bit(field_id_[i]);
+        if (l_null || r_null) {
+          if (l_null != r_null) {
+            return l_null ? -1 : 1;
+          }
+          offset += attr_length_[i];
+          continue;
+        }
       }
+
       switch (attr_type_[i]) {
         case INTS:
         case DATES: {
-          if (0 == (cmp = common::compare_int((void *)(v1 + offset), (void *)(v2 + offset)))) {
-            offset += attr_length_[i];
-          } else {
-            return cmp;
-          }
-          break;
-        } 
+          cmp = common::compare_int((void *)(v1 + offset), (void *)(v2 + offset));
+        } break;
         case FLOATS: {
-          if (0 == (cmp = common::compare_float((void *)(v1 + offset), (void *)(v2 + offset)))) {
-            offset += attr_length_[i];
-          } else {
-            return cmp;
-          }
-          break;
-        }
+          cmp = common::compare_float((void *)(v1 + offset), (void *)(v2 + offset));
+        } break;
         case CHARS: {
-          if (0 == (cmp = common::compare_string((void *)(v1 + offset), attr_length_[i], (void *)(v2 + offset), attr_length_[i]))) {
-            offset += attr_length_[i];
-          } else {
-            return cmp;
-          }
-          break;
-        }
+          cmp = common::compare_string((void *)(v1 + offset), attr_length_[i], (void *)(v2 + offset), attr_length_[i]);
+        } break;
         default: {
-          ASSERT(false, "unknown attr type. %d", attr_type_);
+          ASSERT(false, "unknown attr type. %d", attr_type_[i]);
           return 0;
         }
       }
+      if (cmp != 0) {
+        return cmp;
+      }
+      offset += attr_length_[i];
     }
     return cmp;
   }
@@ -133,7 +161,11 @@ private:
 class KeyComparator
 {
 public:
-  void init(AttrType type, int length) { attr_comparator_.init(1, 0, &type, &length); }
+  void init(AttrType type, int length)
+  {
+    attr_comparator_.init(1, nullptr, &type, &length);
+    unique_ = false;
+  }
 
   void init(bool unique, int attr_num, int *field_id, AttrType *type, int *length)
   {
@@ -169,6 +201,8 @@ class AttrPrinter
 public:
   void init(int attr_num, AttrType *type, int *length)
   {
+    attr_type_.clear();
+    attr_length_.clear();
     for(int i=0; i<attr_num; i++){
       attr_type_.emplace_back(type[i]);
       attr_length_.emplace_back(length[i]);
@@ -205,13 +239,14 @@ public:
         case CHARS: {
           std::string str;
           for (int i = 0; i < attr_length_[idx]; i++) {
-            if (v[i] == 0) {
+            if (v[offset + i] == 0) {
               break;
             }
-            str.push_back(v[i]);
+            str.push_back(v[offset + i]);
           }
           st += str;
           st += ",";
+          offset += attr_length_[idx];
           break;
         }
         default: {
@@ -253,6 +288,16 @@ private:
   AttrPrinter attr_printer_;
 };
 
+/**
+ * @brief B+树节点中键值的存放格式
+ * @ingroup BPlusTree
+ */
+enum class BplusTreeKeyFormat : int32_t
+{
+  FIXED   = 0,  ///< 定长格式，每个元素都是完整的键值，节点最多存放 max_size 个元素
+  COMPACT = 1,  ///< 紧凑格式，变长元素加公共前缀压缩，按照占用的空间判断节点是否已满，参考 CompactNode
+};
+
 /**
  * @brief the meta information of bplus tree
  * @ingroup BPlusTree
@@ -276,6 +321,8 @@ struct IndexFileHeader
   int32_t  field_id[16];
   int32_t  key_length;         
   AttrType attr_type[16]; 
+  int32_t  key_format;         ///< 参考 BplusTreeKeyFormat，老的索引文件是0，也就是定长格式
+  int32_t  leaf_value_size;    ///< 叶子节点中值的大小，0表示存放的是RID。聚簇存放记录时值是整条记录
 
   const string to_string() const
   {
@@ -286,7 +333,9 @@ struct IndexFileHeader
        << "attr_type:" << attr_type << ","
        << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
-       << "leaf_max_size:" << leaf_max_size << ";";
+       << "leaf_max_size:" << leaf_max_size << ","
+       << "key_format:" << key_format << ","
+       << "leaf_value_size:" << leaf_value_size << ";";
 
     return ss.str();
   }
@@ -320,7 +369,7 @@ struct IndexNode
  * the key is in format: the key value of record and rid.
  * so the key in leaf page must be unique.
  * the value is rid.
- * can you implenment a cluster index ?
+ * 聚簇存放记录时(参考 IndexFileHeader::leaf_value_size)，值是完整的记录。
  */
 struct LeafIndexNode : public IndexNode
 {
@@ -364,6 +413,8 @@ class IndexNodeHandler
 {
 public:
   IndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame);
+  /// @brief 在页面数据的副本上操作，乐观读时使用。frame 只用来获取页面编号
+  IndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame, char *data);
   virtual ~IndexNodeHandler() = default;
 
   /// @brief 初始化一个新的页面
@@ -388,6 +439,9 @@ public:
   PageNum parent_page_num() const;
   PageNum page_num() const;
 
+  /// 是否使用紧凑格式存放键值
+  bool is_compact() const;
+
   /**
    * @brief 判断对指定的操作，是否安全的
    * @details 安全是指在操作执行后，节点不需要调整，比如分裂、合并或重新分配
@@ -396,6 +450,22 @@ public:
    */
   bool is_safe(BplusTreeOperationType op, bool is_root_node);
 
+  /**
+   * @brief 再插入任意一个元素都可能放不下
+   * @details 定长格式按照元素个数判断，紧凑格式按照剩余空间判断，并且结果是保守的
+   */
+  bool is_full() const;
+  /// @brief 元素太少，需要与相邻节点合并或者重新分配
+  bool is_underflow() const;
+  /// @brief 精确判断插入这个键值后是否还能放下，不能放下就需要分裂
+  bool can_insert(const char *key) const;
+  /// @brief 与另一个节点的元素合并到一起后能否放下
+  bool can_coalesce_with(const IndexNodeHandler &other) const;
+  /// @brief 节点分裂时，从哪个元素开始移动到新节点
+  int  split_index() const;
+  /// @brief 节点中的数据占用的字节数，用于统计
+  int  used_bytes() const;
+
   /**
    * @brief 验证当前节点是否有问题
    */
@@ -418,11 +488,37 @@ protected:
   char         *__key_at(int index) const { return __item_at(index); }
   char         *__value_at(int index) const { return __item_at(index) + key_size(); };
 
+  /**
+   * @brief 获取第index个键值，兼容两种格式
+   * @details 紧凑格式的键值会解码到handler内部的临时空间中，同时最多有 KEY_BUFFER_NUM 个结果有效
+   */
+  const char *item_key(int index) const;
+  /// @brief 获取第index个值，兼容两种格式
+  char       *item_value(int index) const;
+  /**
+   * @brief 按照定长格式获取从index开始的num个元素，用于记录日志或者复制到其它节点
+   * @param buffer 紧凑格式的元素会解码到这里
+   */
+  span<const char> items_at(int index, int num, vector<char> &buffer) const;
+
+  CompactNode compact_node() const { return CompactNode(header_, node_); }
+
+  /**
+   * @brief 在紧凑格式的节点中，对 [first, last) 范围内的键值做二分查找
+   * @return 第一个大于等于key的位置，与 common::lower_bound 的语义相同
+   */
+  int compact_lower_bound(const KeyComparator &comparator, const char *key, int first, int last, bool *found) const;
+
 protected:
+  static constexpr int KEY_BUFFER_NUM = 4;
+
   BplusTreeMiniTransaction &mtr_;
   const IndexFileHeader    &header_;
   Frame                    *frame_ = nullptr;
   IndexNode                *node_  = nullptr;
+
+  mutable vector<char> key_buffer_;        ///< 紧凑格式解码键值使用的临时空间
+  mutable int          key_buffer_index_ = 0;
 };
 
 /**
@@ -482,6 +578,7 @@ class InternalIndexNodeHandler final : public IndexNodeHandler
 {
 public:
   InternalIndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame);
+  InternalIndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame, char *data);
   virtual ~InternalIndexNodeHandler() = default;
 
   RC init_empty();
@@ -495,6 +592,8 @@ public:
    * 返回指定子节点在当前节点中的索引
    */
   int  value_index(PageNum page_num);
+  /// @brief 修改键值后节点能否放下，定长格式总是可以
+  bool can_set_key_at(int index, const char *key) const;
   void set_key_at(int index, const char *key);
   void remove(int index);
 
@@ -539,6 +638,32 @@ private:
   InternalIndexNode *internal_node_ = nullptr;
 };
 
+/**
+ * @brief B+树的统计信息
+ * @ingroup BPlusTree
+ * @details 用于比较不同键值格式的扇出和树高
+ */
+struct BplusTreeStat
+{
+  int     height               = 0;
+  int64_t leaf_count           = 0;
+  int64_t internal_count       = 0;
+  int64_t entry_count          = 0;  ///< 叶子节点中的元素个数
+  int64_t internal_entry_count = 0;  ///< 内部节点中的元素个数，也就是子节点的个数
+  int64_t leaf_used_bytes      = 0;
+  int64_t internal_used_bytes  = 0;
+
+  /// @brief 平均每个叶子节点有多少个元素
+  double avg_leaf_entries() const { return leaf_count == 0 ? 0 : static_cast<double>(entry_count) / leaf_count; }
+  /// @brief 内部节点的平均扇出
+  double avg_fanout() const
+  {
+    return internal_count == 0 ? 0 : static_cast<double>(internal_entry_count) / internal_count;
+  }
+
+  string to_string() const;
+};
+
 /**
  * @brief B+树的实现
  * @ingroup BPlusTree
@@ -546,6 +671,15 @@ private:
 class BplusTreeHandler
 {
 public:
+  /// 叶子节点存放其它值(而不是RID)时，至少要能放下这么多个元素
+  static constexpr int MIN_VALUE_LEAF_SIZE = 4;
+
+  /**
+   * @brief 叶子节点中值的最大长度，参考 MIN_VALUE_LEAF_SIZE
+   * @param attr_length 键值的长度，不包含RID
+   */
+  static int max_leaf_value_size(int attr_length);
+
   /**
    * @brief 创建一个B+树
    * @param log_handler 记录日志
@@ -555,11 +689,18 @@ public:
    * @param attr_length 属性长度
    * @param internal_max_size 内部节点最大大小
    * @param leaf_max_size 叶子节点最大大小
+   * @param key_format 键值的存放格式。紧凑格式不使用 internal_max_size 和 leaf_max_size，
+   * 键值太长不能使用紧凑格式时会退回到定长格式
+   * @param leaf_value_size 叶子节点中值的大小，0表示值是RID。不是0时只能使用定长格式，
+   * 并且需要使用带 value 参数的接口修改数据，参考 IndexFileHeader::leaf_value_size
    */
-  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, AttrType attr_type, int attr_length, int internal_max_size = -1, int leaf_max_size = -1);
-  RC create(LogHandler &log_handler, DiskBufferPool &buffer_pool, AttrType attr_type, int attr_length, int internal_max_size = -1, int leaf_max_size = -1);
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, AttrType attr_type, int attr_length, int internal_max_size = -1, int leaf_max_size = -1,
+      BplusTreeKeyFormat key_format = BplusTreeKeyFormat::FIXED);
+  RC create(LogHandler &log_handler, DiskBufferPool &buffer_pool, AttrType attr_type, int attr_length, int internal_max_size = -1, int leaf_max_size = -1,
+      BplusTreeKeyFormat key_format = BplusTreeKeyFormat::FIXED, int leaf_value_size = 0);
   //RC create(const char *file_name, AttrType attr_type, int attr_length, int internal_max_size = -1, int leaf_max_size = -1);
-  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const bool unique, const std::vector<int> &field_ids, const std::vector<const FieldMeta*> &fields, int internal_max_size = -1, int leaf_max_size = -1);
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, const bool unique, const std::vector<int> &field_ids, const std::vector<const FieldMeta*> &fields, int internal_max_size = -1, int leaf_max_size = -1,
+      BplusTreeKeyFormat key_format = BplusTreeKeyFormat::FIXED);
   /**
    * @brief 打开一个B+树
    * @param log_handler 记录日志
@@ -569,6 +710,13 @@ public:
   RC open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name);
   RC open(LogHandler &log_handler, DiskBufferPool &buffer_pool);
 
+  /**
+   * @brief 重新从头页面读取B+树的文件头
+   * @details 重做日志时使用的是临时打开的B+树，会修改头页面(比如根节点)，
+   * 已经打开的B+树要在日志重做完成后重新读取，否则会使用旧的根节点
+   */
+  RC reload_header();
+
   /**
    * 关闭句柄indexHandle对应的索引文件
    */
@@ -581,6 +729,12 @@ public:
    * @note 这里假设user_key的内存大小与attr_length 一致
    */
   RC insert_entry(const char *user_key, const RID *rid);
+  /**
+   * @brief 插入一个键值对，值的大小是 IndexFileHeader::leaf_value_size
+   * @details 键值仍然是 (user_key, rid)，rid 用来区分重复的 user_key。完全相同的键值已经存在时返回
+   * RECORD_DUPLICATE_KEY
+   */
+  RC insert_entry(const char *user_key, const RID *rid, const char *value);
 
   /**
    * @brief 从IndexHandle句柄对应的索引中删除一个值为（user_key，rid）的索引项
@@ -589,6 +743,21 @@ public:
    */
   RC delete_entry(const char *user_key, const RID *rid);
 
+  /**
+   * @brief 查找键值为 (user_key, rid) 的元素，复制它的值
+   * @param[out] value 内存大小至少是值的大小，参考 IndexFileHeader::leaf_value_size
+   * @return RECORD_NOT_EXIST 指定的键值不存在
+   */
+  RC get_value(const char *user_key, const RID *rid, char *value);
+
+  /**
+   * @brief 修改键值为 (user_key, rid) 的元素的值
+   * @details 持有叶子节点的写锁时调用 updater，updater 在值的副本上修改，返回true时才写回到节点中，
+   * 所以查找和修改是原子的。updater 中不能再访问这棵树
+   * @return RECORD_NOT_EXIST 指定的键值不存在
+   */
+  RC update_value(const char *user_key, const RID *rid, const function<bool(char *value)> &updater);
+
   bool is_empty() const;
 
   /**
@@ -598,8 +767,30 @@ public:
    */
   RC get_entry(const char *user_key, int key_len, list<RID> &rids);
 
+  /**
+   * @brief 批量获取多个值的record
+   * @details 相邻的键值落在同一个叶子节点中时，不需要再从根节点查找，所以 user_keys 最好是递增的
+   * @param key_lens 每个user_key的长度
+   * @param rids 返回值，与 user_keys 一一对应
+   * @param attr_num 每个 user_key 包含的属性个数，参考 make_scan_key
+   */
+  RC get_entries(const vector<const char *> &user_keys, const vector<int> &key_lens, vector<list<RID>> &rids,
+      int attr_num = 1);
+
   RC sync();
 
+  /**
+   * @brief 启用自适应哈希索引，参考 AdaptiveHashIndex
+   * @details 需要在打开或创建B+树之后、并发访问之前调用。options.enabled 为false时不做任何事情
+   */
+  void enable_adaptive_hash(const AdaptiveHashOptions &options);
+
+  /**
+   * @brief 获取自适应哈希索引的统计信息
+   * @return 没有启用自适应哈希索引时返回false
+   */
+  bool adaptive_hash_stat(AdaptiveHashStat &stat) const;
+
   /**
    * Check whether current B+ tree is invalid or not.
    * @return true means current tree is valid, return false means current tree is invalid.
@@ -631,6 +822,11 @@ public:
   RC print_tree();
   RC print_leafs();
 
+  /**
+   * @brief 遍历整棵树，统计节点个数、树高和空间使用情况
+   */
+  RC stat(BplusTreeStat &stat);
+
 private:
   /**
    * 这些函数都是线程不安全的，不要在多线程的环境下调用
@@ -638,6 +834,8 @@ private:
   RC print_leaf(Frame *frame);
   RC print_internal_node_recursive(Frame *frame);
 
+  RC stat_node_recursive(Frame *frame, int depth, BplusTreeStat &stat);
+
   bool validate_leaf_link(BplusTreeMiniTransaction &mtr);
   bool validate_node_recursive(BplusTreeMiniTransaction &mtr, Frame *frame);
 
@@ -664,6 +862,30 @@ protected:
   RC find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op,
       const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
 
+  /**
+   * @brief 使用乐观锁耦合（optimistic lock coupling）查找叶子节点，只能用于读操作
+   * @details 下降过程中内部节点只pin不加锁，读取页面前后比较页面的版本号（参考 Frame::version），
+   * 并且在pin住子节点之后再校验一次父节点的版本号，保证子节点指针仍然有效。
+   * 找到的叶子节点加读锁后交给 latch memo 管理，与 crabing protocol 的结果一样。
+   * @return 有并发修改导致校验失败时返回 LOCKED_CONCURRENCY_CONFLICT，调用者可以重试或者退回到加锁的方式
+   */
+  RC optimistic_find_leaf(BplusTreeMiniTransaction &mtr,
+      const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
+
+  /**
+   * @brief 使用自适应哈希索引定位等值查找的起始位置，跳过从根节点的查找
+   * @details 找到的叶子节点加读锁之后交给 latch memo 管理，位置的校验参考 AdaptiveHashIndex
+   * @param key 扫描的左边界
+   * @param[out] index 叶子节点中第一个不小于 key 的位置
+   * @return 哈希表中没有或者记录的位置已经失效时返回false，调用者需要从根节点查找
+   */
+  bool adaptive_hash_locate(BplusTreeMiniTransaction &mtr, const char *key, Frame *&frame, int &index);
+
+  /**
+   * @brief 节点的结构发生变化，自适应哈希索引中指向这个页面的数据失效。调用者需要持有页面的写锁
+   */
+  void invalidate_adaptive_hash(PageNum page_num);
+
   /**
    * @brief 使用crabing protocol 获取页面
    */
@@ -711,12 +933,12 @@ protected:
   /**
    * @brief 在叶子节点插入一个元素
    */
-  RC insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *pkey, const RID *rid);
+  RC insert_entry_into_leaf_node(BplusTreeMiniTransaction &mtr, Frame *frame, const char *pkey, const char *value);
 
   /**
    * @brief 创建一个新的B+树
    */
-  RC create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const RID *rid);
+  RC create_new_tree(BplusTreeMiniTransaction &mtr, const char *key, const char *value);
 
   /**
    * @brief 更新根节点的页号
@@ -729,7 +951,22 @@ protected:
   RC adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_frame);
 
 private:
-  common::MemPoolItem::item_unique_ptr make_key(const char *user_key, const RID &rid);
+  /**
+   * @brief 从记录中取出索引的各个属性，拼接上rid，构造出B+树中存储的键值
+   * @param record 完整的记录。单字段索引的attr_offset是0，也可以直接传入字段的值
+   */
+  common::MemPoolItem::item_unique_ptr make_key(const char *record, const RID &rid);
+  /// @brief 与 make_key 相同，但是键值写到调用者提供的内存中，内存大小是 key_length
+  void fill_key(const char *record, const RID &rid, char *key) const;
+
+  /**
+   * @brief 使用前 attr_num 个参与比较的属性构造扫描边界
+   * @param user_key 前 attr_num 个参与比较的属性的值，按照属性长度依次存放
+   * @param low_bound 为true时其它属性设置为最小值(null)，否则设置为最大值
+   * @param attr_num user_key 中包含的属性个数，多字段索引可以使用前缀扫描
+   */
+  common::MemPoolItem::item_unique_ptr make_scan_key(
+      const char *user_key, const RID &rid, bool low_bound, int attr_num = 1);
 
 protected:
   LogHandler     *log_handler_      = nullptr;  /// 日志处理器
@@ -741,14 +978,20 @@ protected:
   // 这个锁可以使用递归读写锁，但是这里偷懒先不改
   common::SharedMutex root_lock_;
 
+  /// 乐观读连续失败这么多次之后，退回到加锁的方式
+  static constexpr int OPTIMISTIC_READ_RETRY_TIMES = 2;
+
   KeyComparator key_comparator_;
   KeyPrinter    key_printer_;
 
   unique_ptr<common::MemPoolItem> mem_pool_item_;
 
+  unique_ptr<AdaptiveHashIndex> adaptive_hash_;  ///< 自适应哈希索引，没有启用时为空
+
 private:
   friend class BplusTreeScanner;
   friend class BplusTreeTester;
+  friend class BplusTreeBulkLoader;
 };
 
 /**
@@ -769,10 +1012,13 @@ public:
    * @param right_user_key 扫描范围的右边界。如果是null，则没有右边界
    * @param right_len right_user_key 的内存大小(只有在变长字段中才会关注)
    * @param right_inclusive 右边界的值是否包含在内
+   * @param left_attr_num left_user_key 包含的属性个数，参考 BplusTreeHandler::make_scan_key
+   * @param right_attr_num right_user_key 包含的属性个数
+   * @details 多字段索引可以只指定前几个属性，len 描述的是最后一个属性的长度
    * TODO 重构参数表示方法
    */
   RC open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key, int right_len,
-      bool right_inclusive);
+      bool right_inclusive, int left_attr_num = 1, int right_attr_num = 1);
 
   /**
    * @brief 获取下一条记录
@@ -785,6 +1031,30 @@ public:
    */
   RC next_entry(RID &rid);
 
+  /**
+   * @brief 批量获取记录，最多获取 capacity 条
+   * @details 在当前叶子节点中连续复制，只有翻页时才走 next_entry 的逻辑
+   * @param[out] count 获取到的记录条数。返回RECORD_EOF时一定是0，返回其它错误时是出错前获取到的条数
+   * @param[out] keys 不为空时同时复制每条记录的键值(不包含RID)，每个键值的长度是 key_length - sizeof(RID)
+   */
+  RC next_batch(RID *rids, int capacity, int &count, char *keys = nullptr);
+
+  /**
+   * @brief 最近一次 next_entry 返回的元素的值
+   * @details 指向叶子节点中的数据，只在下一次调用 next_entry 之前有效。叶子节点存放的是记录时
+   * (参考 IndexFileHeader::leaf_value_size)用来读取记录
+   */
+  const char *current_value();
+
+  /**
+   * @brief 重新定位到等于 user_key 的数据，之后使用 next_entry 获取这个键值对应的所有记录
+   * @details 用于批量的等值查找。如果新的键值落在当前持有的叶子节点中间，就直接在叶子节点中查找，
+   * 不需要从根节点重新下降，否则从根节点重新查找。多次 seek 的键值是递增的时候效果最好。
+   * 可以不调用 open 直接使用。
+   * @param attr_num user_key 包含的属性个数
+   */
+  RC seek(const char *user_key, int key_len, int attr_num = 1);
+
   /**
    * @brief 关闭当前扫描器
    * @details 可以不调用，在析构函数时会自动执行
@@ -794,10 +1064,30 @@ public:
 private:
   /**
    * 如果key的类型是CHARS, 扩展或缩减user_key的大小刚好是schema中定义的大小
+   * @param attr 需要调整的属性在键值中的编号
+   */
+  RC fix_user_key(
+      const char *user_key, int key_len, int attr, bool want_greater, char **fixed_key, bool *should_inclusive);
+
+  /**
+   * @brief 把 user_key 转换成 B+ 树中完整的键值，最后一个属性是变长字段时会先调用 fix_user_key
+   * @param key_len 最后一个属性的长度
+   * @param attr_num user_key 包含的属性个数
+   * @param left_bound 为true时生成的是扫描范围的左边界，否则是右边界
+   * @param[in,out] inclusive 是否包含 user_key 本身，修正键值之后可能会变化
+   */
+  RC make_bound_key(const char *user_key, int key_len, int attr_num, bool left_bound, bool &inclusive,
+      common::MemPoolItem::item_unique_ptr &key);
+
+  /**
+   * @brief 从根节点开始查找第一个大于等于 left_key 的位置，找不到时 current_frame_ 为空
+   * @param point_probe 是否是等值查找。等值查找会先尝试使用自适应哈希索引
    */
-  RC fix_user_key(const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive);
+  RC locate(const char *left_key, bool point_probe);
 
   void fetch_item(RID &rid);
+  /// 复制当前位置的键值，不包含RID
+  void fetch_key(char *key);
 
   /**
    * @brief 判断是否到了扫描的结束位置
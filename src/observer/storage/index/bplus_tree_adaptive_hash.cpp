@@ -0,0 +1,213 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/bplus_tree_adaptive_hash.h"
+#include "common/conf/ini.h"
+#include "common/lang/sstream.h"
+#include "common/lang/string.h"
+
+AdaptiveHashOptions AdaptiveHashOptions::from_config()
+{
+  AdaptiveHashOptions options;
+
+  const char *section         = "INDEX";
+  string      enabled         = common::get_properties()->get("ADAPTIVE_HASH_INDEX", "", section);
+  string      memory_limit    = common::get_properties()->get("ADAPTIVE_HASH_MEMORY_MB", "", section);
+  string      build_threshold = common::get_properties()->get("ADAPTIVE_HASH_BUILD_THRESHOLD", "", section);
+  if (!enabled.empty()) {
+    options.enabled = (enabled == "true" || enabled == "1");
+  }
+  if (!memory_limit.empty()) {
+    int64_t memory_limit_mb = 0;
+    common::str_to_val(memory_limit, memory_limit_mb);
+    if (memory_limit_mb > 0) {
+      options.memory_limit = memory_limit_mb * 1024 * 1024;
+    }
+  }
+  if (!build_threshold.empty()) {
+    common::str_to_val(build_threshold, options.build_threshold);
+  }
+  return options;
+}
+
+double AdaptiveHashStat::hit_ratio() const
+{
+  const uint64_t total = hit_count + miss_count;
+  return total == 0 ? 0.0 : static_cast<double>(hit_count) / total;
+}
+
+string AdaptiveHashStat::to_string() const
+{
+  stringstream ss;
+  ss << "hit:" << hit_count << ", miss:" << miss_count << ", hit ratio:" << hit_ratio() << ", invalid:" << invalid_count
+     << ", evict:" << evict_count << ", entries:" << entry_count;
+  return ss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+atomic<int64_t> AdaptiveHashIndex::total_memory_{0};
+
+AdaptiveHashIndex::AdaptiveHashIndex(const AdaptiveHashOptions &options, int key_length)
+    : options_(options), key_length_(key_length)
+{}
+
+AdaptiveHashIndex::~AdaptiveHashIndex()
+{
+  for (Shard &shard : shards_) {
+    lock_guard guard(shard.lock);
+    while (!shard.lru.empty()) {
+      erase_locked(shard, shard.lru.begin());
+    }
+  }
+}
+
+int64_t AdaptiveHashIndex::entry_memory() const
+{
+  // 粗略估计：键值本身、链表节点和哈希表节点
+  return key_length_ + static_cast<int64_t>(sizeof(Entry)) + 64;
+}
+
+void AdaptiveHashIndex::record_probe(bool point)
+{
+  if (point) {
+    if (point_probes_.load(memory_order_relaxed) < options_.build_threshold) {
+      point_probes_.fetch_add(1, memory_order_relaxed);
+    }
+  } else if (point_probes_.load(memory_order_relaxed) != 0) {
+    point_probes_.store(0, memory_order_relaxed);
+  }
+}
+
+bool AdaptiveHashIndex::lookup(const char *key, PageNum &page_num, uint64_t &epoch)
+{
+  const string_view key_view(key, key_length_);
+  Shard            &shard = shard_of(key_view);
+
+  lock_guard guard(shard.lock);
+  auto       iter = shard.entries.find(key_view);
+  if (iter == shard.entries.end()) {
+    miss_count_.fetch_add(1, memory_order_relaxed);
+    return false;
+  }
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, iter->second);
+  page_num = iter->second->page_num;
+  epoch    = iter->second->epoch;
+  return true;
+}
+
+void AdaptiveHashIndex::insert(const char *key, PageNum page_num)
+{
+  const string_view key_view(key, key_length_);
+  Shard            &shard  = shard_of(key_view);
+  const int64_t     memory = entry_memory();
+
+  lock_guard guard(shard.lock);
+  auto       iter = shard.entries.find(key_view);
+  if (iter != shard.entries.end()) {
+    erase_locked(shard, iter->second);
+  }
+
+  // 超过内存上限时从当前分片淘汰最久没有访问的数据，当前分片没有数据时就不再记录
+  while (total_memory_.load(memory_order_relaxed) + memory > options_.memory_limit) {
+    if (shard.lru.empty()) {
+      return;
+    }
+    erase_locked(shard, std::prev(shard.lru.end()));
+    evict_count_.fetch_add(1, memory_order_relaxed);
+  }
+
+  Entry entry;
+  entry.key      = string(key_view);
+  entry.page_num = page_num;
+  entry.epoch    = ref_page(page_num);
+  shard.lru.push_front(std::move(entry));
+  shard.entries.emplace(string_view(shard.lru.front().key), shard.lru.begin());
+
+  total_memory_.fetch_add(memory, memory_order_relaxed);
+  entry_count_.fetch_add(1, memory_order_relaxed);
+}
+
+void AdaptiveHashIndex::remove(const char *key, bool invalid)
+{
+  const string_view key_view(key, key_length_);
+  Shard            &shard = shard_of(key_view);
+
+  if (invalid) {
+    invalid_count_.fetch_add(1, memory_order_relaxed);
+    miss_count_.fetch_add(1, memory_order_relaxed);
+  }
+
+  lock_guard guard(shard.lock);
+  auto       iter = shard.entries.find(key_view);
+  if (iter != shard.entries.end()) {
+    erase_locked(shard, iter->second);
+  }
+}
+
+void AdaptiveHashIndex::erase_locked(Shard &shard, list<Entry>::iterator iter)
+{
+  unref_page(iter->page_num);
+  shard.entries.erase(string_view(iter->key));
+  shard.lru.erase(iter);
+
+  total_memory_.fetch_sub(entry_memory(), memory_order_relaxed);
+  entry_count_.fetch_sub(1, memory_order_relaxed);
+}
+
+uint64_t AdaptiveHashIndex::ref_page(PageNum page_num)
+{
+  PageShard &page_shard = page_shard_of(page_num);
+  lock_guard guard(page_shard.lock);
+  PageInfo  &page_info = page_shard.pages[page_num];
+  page_info.ref_count++;
+  return page_info.epoch;
+}
+
+void AdaptiveHashIndex::unref_page(PageNum page_num)
+{
+  PageShard &page_shard = page_shard_of(page_num);
+  lock_guard guard(page_shard.lock);
+  auto       iter = page_shard.pages.find(page_num);
+  if (iter != page_shard.pages.end() && --iter->second.ref_count <= 0) {
+    page_shard.pages.erase(iter);
+  }
+}
+
+bool AdaptiveHashIndex::validate(PageNum page_num, uint64_t epoch)
+{
+  PageShard &page_shard = page_shard_of(page_num);
+  lock_guard guard(page_shard.lock);
+  auto       iter = page_shard.pages.find(page_num);
+  return iter != page_shard.pages.end() && iter->second.epoch == epoch;
+}
+
+void AdaptiveHashIndex::invalidate_page(PageNum page_num)
+{
+  // 页面上没有记录数据时不需要处理。失效的数据会在下次访问或者被淘汰时删除
+  PageShard &page_shard = page_shard_of(page_num);
+  lock_guard guard(page_shard.lock);
+  auto       iter = page_shard.pages.find(page_num);
+  if (iter != page_shard.pages.end()) {
+    iter->second.epoch++;
+  }
+}
+
+AdaptiveHashStat AdaptiveHashIndex::stat() const
+{
+  AdaptiveHashStat stat;
+  stat.hit_count     = hit_count_.load(memory_order_relaxed);
+  stat.miss_count    = miss_count_.load(memory_order_relaxed);
+  stat.invalid_count = invalid_count_.load(memory_order_relaxed);
+  stat.evict_count   = evict_count_.load(memory_order_relaxed);
+  stat.entry_count   = entry_count_.load(memory_order_relaxed);
+  return stat;
+}
@@ -0,0 +1,176 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/functional.h"
+#include "common/lang/list.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/lang/string_view.h"
+#include "common/lang/unordered_map.h"
+#include "storage/buffer/page.h"
+
+/**
+ * @brief 自适应哈希索引的参数
+ * @ingroup BPlusTree
+ * @details 从配置文件的 [INDEX] 中读取
+ */
+struct AdaptiveHashOptions
+{
+  static constexpr int64_t DEFAULT_MEMORY_LIMIT    = 16L * 1024 * 1024;
+  static constexpr int     DEFAULT_BUILD_THRESHOLD = 64;
+
+  bool    enabled         = false;                    ///< 是否使用自适应哈希索引
+  int64_t memory_limit    = DEFAULT_MEMORY_LIMIT;     ///< 所有索引的哈希表一共可以使用的内存
+  int     build_threshold = DEFAULT_BUILD_THRESHOLD;  ///< 连续这么多次等值查找之后才开始记录查找结果
+
+  /**
+   * @brief 读取配置 ADAPTIVE_HASH_INDEX、ADAPTIVE_HASH_MEMORY_MB 和 ADAPTIVE_HASH_BUILD_THRESHOLD
+   */
+  static AdaptiveHashOptions from_config();
+};
+
+/**
+ * @brief 自适应哈希索引的统计信息
+ * @ingroup BPlusTree
+ */
+struct AdaptiveHashStat
+{
+  uint64_t hit_count     = 0;  ///< 通过哈希表直接定位到叶子节点的次数
+  uint64_t miss_count    = 0;  ///< 需要从根节点查找的次数，包括哈希表中的数据已经失效的情况
+  uint64_t invalid_count = 0;  ///< 哈希表中找到了，但是叶子节点已经变化，不能使用的次数
+  uint64_t evict_count   = 0;  ///< 内存不够时淘汰的个数
+  int64_t  entry_count   = 0;  ///< 当前的数据个数
+
+  double hit_ratio() const;
+  string to_string() const;
+};
+
+/**
+ * @brief B+树的自适应哈希索引
+ * @ingroup BPlusTree
+ * @details 参考 InnoDB 的 adaptive hash index。频繁的等值查找每次都要从根节点下降到叶子节点，
+ * 每一层都要加锁或者校验版本号。这里记录查找的键值(扫描的左边界)落在哪个叶子节点上，
+ * 下次直接访问这个叶子节点。
+ * 只有连续出现多次等值查找时才会记录新的数据，范围扫描会打断这个过程。
+ * 使用时需要在叶子节点加读锁之后确认：
+ * 1. 页面的版本(epoch)没有变化。叶子节点分裂、合并、重新分配或者释放时都会增加版本；
+ * 2. 在叶子节点中查找的位置前面有比它小的键值，当前位置的键值不比它小。
+ * 叶子节点是按照顺序链接起来的，满足第2点就说明这个位置就是从根节点查找得到的位置，
+ * 所以第1点只是尽早淘汰无效的数据，并防止访问已经释放的页面。
+ * 哈希表按照键值分成多个分片，每个分片按照LRU淘汰，所有索引的哈希表共享一个内存上限。
+ */
+class AdaptiveHashIndex
+{
+public:
+  AdaptiveHashIndex(const AdaptiveHashOptions &options, int key_length);
+  ~AdaptiveHashIndex();
+
+  /**
+   * @brief 记录一次查找
+   * @param point 是否是等值查找
+   */
+  void record_probe(bool point);
+
+  /// 当前是否记录新的查找结果
+  bool building() const { return point_probes_.load(memory_order_relaxed) >= options_.build_threshold; }
+
+  /**
+   * @brief 查找键值所在的叶子节点
+   * @param key B+树中完整的键值，长度是 key_length
+   * @param[out] epoch 记录时叶子节点的版本，参考 validate
+   */
+  bool lookup(const char *key, PageNum &page_num, uint64_t &epoch);
+
+  /**
+   * @brief 记录键值所在的叶子节点
+   * @details 调用者需要持有叶子节点的锁，保证记录的页面版本与页面内容一致
+   */
+  void insert(const char *key, PageNum page_num);
+
+  /// 删除键值，同时记录一次失效
+  void remove(const char *key, bool invalid);
+
+  /// 页面的版本有没有变化
+  bool validate(PageNum page_num, uint64_t epoch);
+
+  /**
+   * @brief 叶子节点的结构发生了变化，这个页面上记录的数据全部失效
+   * @details 调用者需要持有页面的写锁
+   */
+  void invalidate_page(PageNum page_num);
+
+  void record_hit() { hit_count_.fetch_add(1, memory_order_relaxed); }
+
+  AdaptiveHashStat stat() const;
+
+private:
+  struct Entry
+  {
+    string   key;
+    PageNum  page_num = BP_INVALID_PAGE_NUM;
+    uint64_t epoch    = 0;
+  };
+
+  struct alignas(64) Shard
+  {
+    mutex       lock;
+    list<Entry> lru;  ///< 最近访问的在前面
+    /// 哈希表的键值引用链表节点中的 Entry::key，链表节点的地址不会变化
+    unordered_map<string_view, list<Entry>::iterator> entries;
+  };
+
+  /// 页面的版本和记录在这个页面上的数据个数。没有数据时删除，避免页面信息越来越多
+  struct PageInfo
+  {
+    uint64_t epoch     = 0;
+    int      ref_count = 0;
+  };
+
+  struct alignas(64) PageShard
+  {
+    mutex                             lock;
+    unordered_map<PageNum, PageInfo> pages;
+  };
+
+  static constexpr int SHARD_NUM = 16;
+
+  Shard     &shard_of(string_view key) { return shards_[hash<string_view>()(key) % SHARD_NUM]; }
+  PageShard &page_shard_of(PageNum page_num) { return page_shards_[static_cast<uint32_t>(page_num) % SHARD_NUM]; }
+
+  /// 增加页面的引用计数并返回当前版本
+  uint64_t ref_page(PageNum page_num);
+  void     unref_page(PageNum page_num);
+
+  /// 删除分片中的一个数据，调用者需要持有分片的锁
+  void erase_locked(Shard &shard, list<Entry>::iterator iter);
+
+  int64_t entry_memory() const;
+
+private:
+  AdaptiveHashOptions options_;
+  int                 key_length_ = 0;
+
+  Shard     shards_[SHARD_NUM];
+  PageShard page_shards_[SHARD_NUM];
+
+  atomic<int> point_probes_{0};  ///< 连续的等值查找次数
+
+  atomic<uint64_t> hit_count_{0};
+  atomic<uint64_t> miss_count_{0};
+  atomic<uint64_t> invalid_count_{0};
+  atomic<uint64_t> evict_count_{0};
+  atomic<int64_t>  entry_count_{0};
+
+  /// 所有索引的哈希表使用的内存
+  static atomic<int64_t> total_memory_;
+};
@@ -0,0 +1,690 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/bplus_tree_bulk_loader.h"
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/filesystem.h"
+#include "common/lang/fstream.h"
+#include "common/lang/queue.h"
+#include "common/log/log.h"
+#include "storage/index/bplus_tree.h"
+
+BplusTreeBulkLoadOptions BplusTreeBulkLoadOptions::from_config()
+{
+  BplusTreeBulkLoadOptions options;
+
+  const char *section     = "INDEX";
+  string      enabled     = common::get_properties()->get("BULK_LOAD", "", section);
+  string      fill_factor = common::get_properties()->get("BULK_LOAD_FILL_FACTOR", "", section);
+  string      sort_memory = common::get_properties()->get("BULK_LOAD_SORT_MEMORY_MB", "", section);
+  if (!enabled.empty()) {
+    options.enabled = (enabled == "true" || enabled == "1");
+  }
+  if (!fill_factor.empty()) {
+    common::str_to_val(fill_factor, options.fill_factor);
+  }
+  if (!sort_memory.empty()) {
+    int64_t sort_memory_mb = 0;
+    common::str_to_val(sort_memory, sort_memory_mb);
+    if (sort_memory_mb > 0) {
+      options.sort_memory = sort_memory_mb * 1024 * 1024;
+    }
+  }
+  return options;
+}
+
+/**
+ * @brief 正在构建的一层节点
+ * @details 每一层的元素个数在开始构建前就知道了，所以可以提前计算好节点个数，
+ * 把元素平均分配到各个节点上，避免最后一个节点只有很少的元素。
+ */
+struct BplusTreeBulkLoader::LevelBuilder
+{
+  bool is_leaf    = false;
+  int  node_num   = 0;  ///< 这一层节点的个数
+  int  base_size  = 0;  ///< 每个节点至少有多少个元素
+  int  extra_num  = 0;  ///< 前 extra_num 个节点多放一个元素
+  int  node_index = 0;  ///< 当前正在填充第几个节点
+
+  Frame *frame = nullptr;  ///< 当前正在填充的节点
+
+  int target_size() const { return base_size + (node_index < extra_num ? 1 : 0); }
+
+  // 以下是紧凑格式使用的
+  int                          size_limit = 0;  ///< 节点按照填充因子最多占用多少空间
+  int                          item_num   = 0;  ///< 当前节点的元素个数
+  vector<char>                 items;           ///< 当前节点的元素，定长格式
+  unique_ptr<CompactNodeSizer> sizer;           ///< 计算当前节点的元素重建后占用的空间
+  vector<char>                 last_key;        ///< 当前节点的最后一个键值
+  vector<char>                 separator;       ///< 当前节点在上一层中的键值
+};
+
+/**
+ * @brief 读取一个排好序的有序段
+ * @details 有序段可能在临时文件中，也可能是分区内存中排好序的数据
+ */
+class BplusTreeBulkLoader::RunReader
+{
+public:
+  static constexpr int BUFFER_SIZE = 64 * 1024;
+
+  RunReader(int key_length) : key_length_(key_length) {}
+
+  RC open(const string &filename)
+  {
+    buffer_.resize(BUFFER_SIZE);
+    key_.resize(key_length_);
+    file_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+    file_.open(filename, ios::in | ios::binary);
+    if (!file_.is_open()) {
+      LOG_WARN("failed to open sorted run file. filename=%s", filename.c_str());
+      return RC::IOERR_OPEN;
+    }
+    return RC::SUCCESS;
+  }
+
+  void open(const vector<const char *> &sorted_keys) { sorted_keys_ = &sorted_keys; }
+
+  /// @brief 读取下一个键值，读到结尾返回false
+  bool next()
+  {
+    if (sorted_keys_ != nullptr) {
+      if (position_ >= sorted_keys_->size()) {
+        return false;
+      }
+      current_ = (*sorted_keys_)[position_++];
+      return true;
+    }
+
+    file_.read(key_.data(), key_.size());
+    current_ = key_.data();
+    return file_.gcount() == static_cast<std::streamsize>(key_.size());
+  }
+
+  const char *key() const { return current_; }
+
+private:
+  int          key_length_ = 0;
+  vector<char> buffer_;
+  ifstream     file_;
+  vector<char> key_;
+
+  const vector<const char *> *sorted_keys_ = nullptr;
+  size_t                      position_    = 0;
+  const char                 *current_     = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// class BplusTreeBulkLoader::Partition
+
+BplusTreeBulkLoader::Partition::~Partition() { cleanup(); }
+
+RC BplusTreeBulkLoader::Partition::add(const char *record, const RID &rid)
+{
+  if (record == nullptr) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int key_length = loader_.key_length_;
+  if (!buffer_.empty() && static_cast<int64_t>(buffer_.size() + key_length) > sort_memory_) {
+    RC rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  const size_t offset = buffer_.size();
+  buffer_.resize(offset + key_length);
+  loader_.tree_handler_.fill_key(record, rid, buffer_.data() + offset);
+  entry_count_++;
+  sealed_ = false;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::Partition::seal()
+{
+  if (sealed_) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  // 已经有临时文件了，剩余的数据也写到临时文件中，与原来单个分区的行为一致
+  if (!run_files_.empty() && !buffer_.empty()) {
+    rc = spill();
+  } else {
+    sort_buffer();
+  }
+  sealed_ = OB_SUCC(rc);
+  return rc;
+}
+
+void BplusTreeBulkLoader::Partition::sort_buffer()
+{
+  const int key_length = loader_.key_length_;
+  sorted_keys_.clear();
+  sorted_keys_.reserve(buffer_.size() / key_length);
+  for (size_t offset = 0; offset < buffer_.size(); offset += key_length) {
+    sorted_keys_.push_back(buffer_.data() + offset);
+  }
+
+  const KeyComparator &comparator = loader_.tree_handler_.key_comparator_;
+  sort(sorted_keys_.begin(), sorted_keys_.end(),
+      [&comparator](const char *left, const char *right) { return comparator(left, right) < 0; });
+}
+
+RC BplusTreeBulkLoader::Partition::spill()
+{
+  sort_buffer();
+
+  string filename = loader_.next_run_file();
+  run_files_.push_back(filename);
+
+  ofstream file(filename, ios::out | ios::binary | ios::trunc);
+  if (!file.is_open()) {
+    LOG_WARN("failed to create sorted run file. filename=%s", filename.c_str());
+    return RC::IOERR_OPEN;
+  }
+
+  for (const char *key : sorted_keys_) {
+    file.write(key, loader_.key_length_);
+  }
+  file.close();
+  if (file.fail()) {
+    LOG_WARN("failed to write sorted run file. filename=%s", filename.c_str());
+    return RC::IOERR_WRITE;
+  }
+
+  LOG_INFO("spill sorted run to file. filename=%s, entries=%ld",
+           filename.c_str(), static_cast<int64_t>(sorted_keys_.size()));
+  sorted_keys_.clear();
+  buffer_.clear();
+  run_count_++;
+  return RC::SUCCESS;
+}
+
+void BplusTreeBulkLoader::Partition::cleanup()
+{
+  for (const string &filename : run_files_) {
+    error_code ec;
+    filesystem::remove(filename, ec);
+  }
+  run_files_.clear();
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+  sorted_keys_.clear();
+  sorted_keys_.shrink_to_fit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class BplusTreeBulkLoader
+
+BplusTreeBulkLoader::BplusTreeBulkLoader(BplusTreeHandler &tree_handler, const BplusTreeBulkLoadOptions &options)
+    : tree_handler_(tree_handler), options_(options), key_length_(tree_handler.file_header().key_length)
+{
+  options_.fill_factor = clamp(options_.fill_factor, 50, 100);
+  if (tree_handler.file_header().key_format == static_cast<int32_t>(BplusTreeKeyFormat::COMPACT)) {
+    codec_ = make_unique<CompactKeyCodec>(tree_handler.file_header());
+  }
+  partitions_.push_back(make_unique<Partition>(*this, options_.sort_memory));
+}
+
+BplusTreeBulkLoader::~BplusTreeBulkLoader() { cleanup(); }
+
+RC BplusTreeBulkLoader::add(const char *record, const RID &rid) { return partitions_[0]->add(record, rid); }
+
+RC BplusTreeBulkLoader::create_partitions(int count)
+{
+  if (count <= 0 || entry_count() > 0) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int64_t sort_memory = max<int64_t>(options_.sort_memory / count, key_length_);
+  partitions_.clear();
+  for (int i = 0; i < count; i++) {
+    partitions_.push_back(make_unique<Partition>(*this, sort_memory));
+  }
+  return RC::SUCCESS;
+}
+
+int64_t BplusTreeBulkLoader::entry_count() const
+{
+  int64_t count = 0;
+  for (const auto &partition : partitions_) {
+    count += partition->entry_count();
+  }
+  return count;
+}
+
+int BplusTreeBulkLoader::run_count() const
+{
+  int count = 0;
+  for (const auto &partition : partitions_) {
+    count += partition->run_count();
+  }
+  return count;
+}
+
+string BplusTreeBulkLoader::next_run_file()
+{
+  return string(tree_handler_.buffer_pool().filename()) + ".sort." + std::to_string(run_file_id_.fetch_add(1));
+}
+
+RC BplusTreeBulkLoader::merge(const function<RC(const char *key)> &consumer)
+{
+  RC rc = RC::SUCCESS;
+  for (auto &partition : partitions_) {
+    rc = partition->seal();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  if (partitions_.size() == 1 && partitions_[0]->run_files_.empty()) {
+    for (const char *key : partitions_[0]->sorted_keys_) {
+      rc = consumer(key);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    return rc;
+  }
+
+  vector<unique_ptr<RunReader>> readers;
+  for (auto &partition : partitions_) {
+    for (const string &filename : partition->run_files_) {
+      auto reader = make_unique<RunReader>(key_length_);
+      rc          = reader->open(filename);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      readers.push_back(std::move(reader));
+    }
+    if (!partition->sorted_keys_.empty()) {
+      auto reader = make_unique<RunReader>(key_length_);
+      reader->open(partition->sorted_keys_);
+      readers.push_back(std::move(reader));
+    }
+  }
+
+  // 多路归并，堆顶是所有有序段中最小的键值
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+  auto greater = [&comparator](RunReader *left, RunReader *right) { return comparator(left->key(), right->key()) > 0; };
+  priority_queue<RunReader *, vector<RunReader *>, decltype(greater)> heap(greater);
+  for (auto &reader : readers) {
+    if (reader->next()) {
+      heap.push(reader.get());
+    }
+  }
+
+  while (!heap.empty()) {
+    RunReader *reader = heap.top();
+    heap.pop();
+
+    rc = consumer(reader->key());
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (reader->next()) {
+      heap.push(reader);
+    }
+  }
+  return rc;
+}
+
+int BplusTreeBulkLoader::node_count(int64_t item_num, int max_size) const
+{
+  const int min_size = max_size - max_size / 2;
+  const int per_node = clamp(max_size * options_.fill_factor / 100, min_size, max_size);
+
+  int64_t count = (item_num + per_node - 1) / per_node;
+  // 平均分配之后每个节点的元素个数不能少于最小值，否则删除数据时马上就要合并节点
+  while (count > 1 && item_num / count < min_size && (item_num + count - 2) / (count - 1) <= max_size) {
+    count--;
+  }
+  return static_cast<int>(max<int64_t>(count, 1));
+}
+
+RC BplusTreeBulkLoader::prepare_levels()
+{
+  const IndexFileHeader &header = tree_handler_.file_header();
+
+  levels_.clear();
+  int64_t item_num = entry_count();
+  int     max_size = header.leaf_max_size;
+  while (true) {
+    LevelBuilder level;
+    level.is_leaf   = levels_.empty();
+    level.node_num  = node_count(item_num, max_size);
+    level.base_size = static_cast<int>(item_num / level.node_num);
+    level.extra_num = static_cast<int>(item_num % level.node_num);
+    levels_.push_back(std::move(level));
+
+    LOG_INFO("bulk load level %d: items=%ld, nodes=%d", static_cast<int>(levels_.size()) - 1, item_num, level.node_num);
+    if (level.node_num == 1) {
+      break;
+    }
+
+    item_num = level.node_num;
+    max_size = header.internal_max_size;
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeBulkLoader::release_pending_leaf(PageNum next_page)
+{
+  if (pending_leaf_ == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  auto *leaf         = reinterpret_cast<LeafIndexNode *>(pending_leaf_->data());
+  leaf->next_brother = next_page;
+  pending_leaf_->mark_dirty();
+  pending_leaf_->write_unlatch();
+  RC rc         = tree_handler_.buffer_pool().unpin_page(pending_leaf_);
+  pending_leaf_ = nullptr;
+  return rc;
+}
+
+RC BplusTreeBulkLoader::allocate_node(LevelBuilder &level)
+{
+  Frame *frame = nullptr;
+  RC     rc    = tree_handler_.buffer_pool().allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate page for bulk load. rc=%s", strrc(rc));
+    return rc;
+  }
+  frame->write_latch();
+
+  auto *node    = reinterpret_cast<IndexNode *>(frame->data());
+  node->is_leaf = level.is_leaf;
+  node->key_num = 0;
+  node->parent  = BP_INVALID_PAGE_NUM;
+  level.frame   = frame;
+
+  if (level.is_leaf) {
+    reinterpret_cast<LeafIndexNode *>(node)->next_brother = BP_INVALID_PAGE_NUM;
+    rc = release_pending_leaf(frame->page_num());
+  }
+  return rc;
+}
+
+RC BplusTreeBulkLoader::append_item(int level_index, const char *key, const char *value, PageNum &page_num)
+{
+  RC            rc    = RC::SUCCESS;
+  LevelBuilder &level = levels_[level_index];
+  if (level.frame == nullptr) {
+    rc = allocate_node(level);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  auto *node       = reinterpret_cast<IndexNode *>(level.frame->data());
+  char *array      = level.is_leaf ? reinterpret_cast<LeafIndexNode *>(node)->array
+                                   : reinterpret_cast<InternalIndexNode *>(node)->array;
+  int   value_size = level.is_leaf ? sizeof(RID) : sizeof(PageNum);
+  char *item       = array + node->key_num * (key_length_ + value_size);
+  memcpy(item, key, key_length_);
+  memcpy(item + key_length_, value, value_size);
+  node->key_num++;
+
+  page_num = level.frame->page_num();
+  if (node->key_num == level.target_size()) {
+    rc = finish_node(level_index);
+  }
+  return rc;
+}
+
+RC BplusTreeBulkLoader::finish_node(int level_index)
+{
+  RC            rc    = RC::SUCCESS;
+  LevelBuilder &level = levels_[level_index];
+  Frame        *frame = level.frame;
+  level.frame         = nullptr;
+  level.node_index++;
+
+  auto   *node     = reinterpret_cast<IndexNode *>(frame->data());
+  PageNum page_num = frame->page_num();
+  if (level_index + 1 < static_cast<int>(levels_.size())) {
+    // 内部节点的第0个键值不会被使用，但是这里也记录下来，作为上一层中这个节点的键值
+    const char *first_key = level.is_leaf ? reinterpret_cast<LeafIndexNode *>(node)->array
+                                          : reinterpret_cast<InternalIndexNode *>(node)->array;
+    PageNum     parent    = BP_INVALID_PAGE_NUM;
+    rc = append_item(level_index + 1, first_key, reinterpret_cast<const char *>(&page_num), parent);
+    if (OB_FAIL(rc)) {
+      frame->write_unlatch();
+      tree_handler_.buffer_pool().unpin_page(frame);
+      return rc;
+    }
+    node->parent = parent;
+  } else {
+    root_page_ = page_num;
+  }
+
+  frame->mark_dirty();
+  if (level.is_leaf) {
+    pending_leaf_ = frame;
+    return RC::SUCCESS;
+  }
+
+  frame->write_unlatch();
+  return tree_handler_.buffer_pool().unpin_page(frame);
+}
+
+RC BplusTreeBulkLoader::compact_append_item(int level_index, const char *key, const char *value, PageNum &page_num)
+{
+  RC rc = RC::SUCCESS;
+  if (level_index == static_cast<int>(levels_.size())) {
+    LevelBuilder level;
+    level.is_leaf    = (level_index == 0);
+    level.size_limit = CompactNode::capacity_of(level.is_leaf) * options_.fill_factor / 100;
+    level.sizer      = make_unique<CompactNodeSizer>(
+        *codec_, CompactNode::capacity_of(level.is_leaf), level.is_leaf ? sizeof(RID) : sizeof(PageNum));
+    level.last_key.resize(key_length_);
+    level.separator.resize(key_length_);
+    levels_.push_back(std::move(level));
+  }
+
+  LevelBuilder &level = levels_[level_index];
+  if (level.item_num > 0 && level.sizer->size_with(key) > level.size_limit) {
+    rc = compact_finish_node(level_index, false /*last*/);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    // 叶子节点在上一层中只需要一个能区分左右两个节点的最短键值
+    const KeyComparator &comparator = tree_handler_.key_comparator_;
+    if (!level.is_leaf || !codec_->shortest_separator(level.last_key.data(), key, level.separator.data()) ||
+        comparator(level.last_key.data(), level.separator.data()) >= 0 ||
+        comparator(level.separator.data(), key) > 0) {
+      memcpy(level.separator.data(), key, key_length_);
+    }
+  } else if (level.item_num == 0) {
+    memcpy(level.separator.data(), key, key_length_);
+  }
+
+  if (level.frame == nullptr) {
+    rc = allocate_node(level);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  const int value_size = level.is_leaf ? sizeof(RID) : sizeof(PageNum);
+  level.items.insert(level.items.end(), key, key + key_length_);
+  level.items.insert(level.items.end(), value, value + value_size);
+  level.item_num++;
+  level.sizer->add(key);
+  memcpy(level.last_key.data(), key, key_length_);
+
+  page_num = level.frame->page_num();
+  return rc;
+}
+
+RC BplusTreeBulkLoader::compact_finish_node(int level_index, bool last)
+{
+  LevelBuilder &level = levels_[level_index];
+  Frame        *frame = level.frame;
+  level.frame         = nullptr;
+  level.node_index++;
+
+  auto       *node = reinterpret_cast<IndexNode *>(frame->data());
+  CompactNode compact_node(tree_handler_.file_header(), node);
+  compact_node.init_empty();
+  RC rc = compact_node.rebuild(level.items.data(), level.item_num);
+  level.items.clear();
+  level.item_num = 0;
+  level.sizer->reset();
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to build compact node. level=%d, rc=%s", level_index, strrc(rc));
+    frame->write_unlatch();
+    tree_handler_.buffer_pool().unpin_page(frame);
+    return rc;
+  }
+
+  PageNum page_num = frame->page_num();
+  if (!last || level_index + 1 < static_cast<int>(levels_.size())) {
+    PageNum parent = BP_INVALID_PAGE_NUM;
+    rc = compact_append_item(level_index + 1, level.separator.data(), reinterpret_cast<const char *>(&page_num), parent);
+    if (OB_FAIL(rc)) {
+      frame->write_unlatch();
+      tree_handler_.buffer_pool().unpin_page(frame);
+      return rc;
+    }
+    node->parent = parent;
+  } else {
+    root_page_ = page_num;
+  }
+
+  frame->mark_dirty();
+  if (level.is_leaf) {
+    pending_leaf_ = frame;
+    return RC::SUCCESS;
+  }
+
+  frame->write_unlatch();
+  return tree_handler_.buffer_pool().unpin_page(frame);
+}
+
+RC BplusTreeBulkLoader::finish()
+{
+  if (!tree_handler_.is_empty()) {
+    LOG_WARN("cannot bulk load into a non-empty b+tree");
+    return RC::INTERNAL;
+  }
+
+  const int64_t entry_count = this->entry_count();
+  if (entry_count == 0) {
+    cleanup();
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (codec_) {
+    levels_.clear();
+  } else {
+    rc = prepare_levels();
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+  vector<char>         last_key(key_length_);
+  bool                 has_last_key = false;
+  int64_t              built_count  = 0;
+
+  rc = merge([&](const char *key) -> RC {
+    if (has_last_key && comparator(last_key.data(), key) == 0) {
+      LOG_WARN("duplicate key found while bulk loading");
+      return RC::RECORD_DUPLICATE_KEY;
+    }
+    memcpy(last_key.data(), key, key_length_);
+    has_last_key = true;
+    built_count++;
+
+    PageNum page_num = BP_INVALID_PAGE_NUM;
+    // 叶子节点的值是RID，也就是键值的最后一部分
+    if (codec_) {
+      return compact_append_item(0, key, key + key_length_ - sizeof(RID), page_num);
+    }
+    return append_item(0, key, key + key_length_ - sizeof(RID), page_num);
+  });
+
+  // 紧凑格式从下往上结束每一层最后一个节点，结束时可能会增加新的一层
+  for (int i = 0; OB_SUCC(rc) && codec_ && i < static_cast<int>(levels_.size()); i++) {
+    if (levels_[i].item_num > 0) {
+      rc = compact_finish_node(i, true /*last*/);
+    }
+  }
+  if (OB_SUCC(rc)) {
+    rc = release_pending_leaf(BP_INVALID_PAGE_NUM);
+  }
+  if (OB_FAIL(rc)) {
+    cleanup();
+    return rc;
+  }
+
+  ASSERT(built_count == entry_count && root_page_ != BP_INVALID_PAGE_NUM,
+         "bulk load lost entries. built=%ld, expected=%ld", built_count, entry_count);
+  cleanup();
+
+  // 构建的页面都没有记录日志，必须在记录根节点之前全部落盘，否则重启后根节点会指向不完整的页面
+  rc = tree_handler_.buffer_pool().flush_all_pages_to_disk();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush pages after bulk load. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 更新根节点的日志就是索引构建完成的日志
+  {
+    BplusTreeMiniTransaction mtr(tree_handler_, &rc);
+    tree_handler_.update_root_page_num_locked(mtr, root_page_);
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 元数据页面刷盘时会等待根节点的日志落盘
+  rc = tree_handler_.sync();
+  if (OB_SUCC(rc)) {
+    rc = tree_handler_.buffer_pool().flush_all_pages_to_disk();
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sync b+tree after bulk load. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("bulk load b+tree done. entries=%ld, levels=%d, runs=%d, root page=%d",
+           entry_count, static_cast<int>(levels_.size()), run_count(), root_page_);
+  return RC::SUCCESS;
+}
+
+void BplusTreeBulkLoader::cleanup()
+{
+  for (LevelBuilder &level : levels_) {
+    if (level.frame != nullptr) {
+      level.frame->write_unlatch();
+      tree_handler_.buffer_pool().unpin_page(level.frame);
+      level.frame = nullptr;
+    }
+  }
+  if (pending_leaf_ != nullptr) {
+    pending_leaf_->write_unlatch();
+    tree_handler_.buffer_pool().unpin_page(pending_leaf_);
+    pending_leaf_ = nullptr;
+  }
+
+  for (auto &partition : partitions_) {
+    partition->cleanup();
+  }
+}
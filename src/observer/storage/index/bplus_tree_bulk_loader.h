@@ -0,0 +1,186 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/deque.h"
+#include "common/lang/functional.h"
+#include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/rc.h"
+#include "storage/buffer/page.h"
+#include "storage/record/record.h"
+
+class BplusTreeHandler;
+class CompactKeyCodec;
+class Frame;
+
+/**
+ * @brief 批量构建B+树的参数
+ * @ingroup BPlusTree
+ * @details 从配置文件的 [INDEX] 中读取
+ */
+struct BplusTreeBulkLoadOptions
+{
+  static constexpr int     DEFAULT_FILL_FACTOR = 90;                 ///< 节点的填充百分比
+  static constexpr int64_t DEFAULT_SORT_MEMORY = 64L * 1024 * 1024;  ///< 排序使用的内存
+
+  bool    enabled     = true;                 ///< 创建索引时是否使用批量构建
+  int     fill_factor = DEFAULT_FILL_FACTOR;  ///< 节点填充到最大容量的百分之多少，范围是[50, 100]
+  int64_t sort_memory = DEFAULT_SORT_MEMORY;  ///< 超过这个大小就把排好序的数据写到临时文件中
+
+  /**
+   * @brief 读取配置 BULK_LOAD、BULK_LOAD_FILL_FACTOR 和 BULK_LOAD_SORT_MEMORY_MB
+   */
+  static BplusTreeBulkLoadOptions from_config();
+};
+
+/**
+ * @brief 自底向上批量构建B+树
+ * @ingroup BPlusTree
+ * @details 给一个有数据的表创建索引时，逐条插入会不停地分裂节点，并且每次修改都要记录日志。
+ * 批量构建先收集所有的键值，使用外部排序排好序，然后按照填充因子从左到右依次填满叶子节点，
+ * 再逐层向上构建内部节点。每个页面只写一次，也不需要分裂。
+ * 构建过程中不记录页面修改的日志，而是在所有页面落盘之后，只记录一条更新根节点的日志，
+ * 作为索引构建完成的标志。
+ * 紧凑格式的节点能放多少个元素与键值有关，无法提前计算每一层的节点个数，
+ * 所以一边添加一边计算占用的空间，超过填充因子就结束当前节点，层数也随之增长。
+ * 叶子节点在上一层中的键值使用后缀截断后的最短分隔键。
+ * 当前只能在一棵空的B+树上使用，也就是刚创建还没有其它人访问的索引。
+ *
+ * 收集和排序可以并行：调用 create_partitions 分成多个分区，每个线程向自己的分区添加数据，
+ * 最后所有分区的有序段一起归并，构建树的过程仍然是单线程的。
+ */
+class BplusTreeBulkLoader
+{
+public:
+  class Partition;
+
+  BplusTreeBulkLoader(BplusTreeHandler &tree_handler, const BplusTreeBulkLoadOptions &options = {});
+  ~BplusTreeBulkLoader();
+
+  /**
+   * @brief 添加一条数据，等同于向第0个分区添加
+   * @param record 完整的记录，与 BplusTreeHandler::insert_entry 的参数一样
+   */
+  RC add(const char *record, const RID &rid);
+
+  /**
+   * @brief 分成 count 个分区，需要在添加数据之前调用
+   * @details 排序使用的内存平均分给各个分区
+   */
+  RC create_partitions(int count);
+
+  int        partition_count() const { return static_cast<int>(partitions_.size()); }
+  Partition &partition(int index) { return *partitions_[index]; }
+
+  /**
+   * @brief 排序并构建B+树
+   * @details 需要等所有分区都添加完数据之后再调用
+   * @return RECORD_DUPLICATE_KEY 有重复的键值
+   */
+  RC finish();
+
+  int64_t entry_count() const;
+  /// @brief 排序时写到临时文件中的有序段的个数
+  int     run_count() const;
+
+private:
+  struct LevelBuilder;
+  class RunReader;
+
+  /// @brief 按照顺序遍历所有分区的数据
+  RC   merge(const function<RC(const char *key)> &consumer);
+  /// @brief 下一个临时文件的名字，多个分区会同时调用
+  string next_run_file();
+
+  /**
+   * @brief 计算一层有多少个节点
+   * @param item_num 这一层总共有多少个元素
+   * @param max_size 节点最多放多少个元素
+   */
+  int node_count(int64_t item_num, int max_size) const;
+
+  RC   prepare_levels();
+  RC   allocate_node(LevelBuilder &level);
+  RC   append_item(int level, const char *key, const char *value, PageNum &page_num);
+  RC   finish_node(int level);
+
+  /// @brief 紧凑格式添加一个元素，当前节点放不下时先结束当前节点
+  RC compact_append_item(int level, const char *key, const char *value, PageNum &page_num);
+  /**
+   * @brief 紧凑格式结束当前节点
+   * @param last 所有数据都已经添加完了，如果这一层只有这一个节点，它就是根节点
+   */
+  RC compact_finish_node(int level, bool last);
+  RC   release_pending_leaf(PageNum next_page);
+  void cleanup();
+
+private:
+  BplusTreeHandler        &tree_handler_;
+  BplusTreeBulkLoadOptions options_;
+  int                      key_length_ = 0;
+
+  vector<unique_ptr<Partition>> partitions_;    ///< 至少有一个分区
+  atomic<int>                   run_file_id_{0};
+
+  unique_ptr<CompactKeyCodec> codec_;  ///< 使用紧凑格式时才有
+
+  deque<LevelBuilder>  levels_;  ///< 紧凑格式构建时会增加新的层，使用deque保证其它层的引用依然有效
+  Frame               *pending_leaf_ = nullptr;  ///< 已经填满的叶子节点，等分配了下一个叶子节点再设置它的 next_brother
+  PageNum              root_page_    = BP_INVALID_PAGE_NUM;
+};
+
+/**
+ * @brief 批量构建的一个分区
+ * @ingroup BPlusTree
+ * @details 收集一部分键值，内存满了就排序后写到临时文件中。
+ * 不同的分区可以在不同的线程中同时使用，同一个分区同时只能有一个线程使用。
+ */
+class BplusTreeBulkLoader::Partition
+{
+public:
+  Partition(BplusTreeBulkLoader &loader, int64_t sort_memory) : loader_(loader), sort_memory_(sort_memory) {}
+  ~Partition();
+
+  /// @copydoc BplusTreeBulkLoader::add
+  RC add(const char *record, const RID &rid);
+
+  /**
+   * @brief 数据添加完了，把内存中剩余的数据排好序
+   * @details 在添加数据的线程中调用，排序也就并行了。不调用的话 finish 时再排序
+   */
+  RC seal();
+
+  int64_t entry_count() const { return entry_count_; }
+  int     run_count() const { return run_count_; }
+
+private:
+  friend class BplusTreeBulkLoader;
+
+  /// @brief 把内存中的数据排序
+  void sort_buffer();
+  /// @brief 把内存中排好序的数据写到临时文件中
+  RC   spill();
+  void cleanup();
+
+private:
+  BplusTreeBulkLoader &loader_;
+  int64_t              sort_memory_ = 0;
+
+  vector<char>         buffer_;       ///< 还没有写到临时文件的数据，每个元素都是一个完整的键值(包含RID)
+  vector<const char *> sorted_keys_;  ///< buffer_ 中的数据排序后的结果
+  vector<string>       run_files_;    ///< 排好序的临时文件
+  int64_t              entry_count_ = 0;
+  int                  run_count_   = 0;
+  bool                 sealed_      = false;
+};
@@ -0,0 +1,613 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/bplus_tree_compact_node.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/bitmap.h"
+#include "common/lang/limits.h"
+#include "common/log/log.h"
+#include "storage/index/bplus_tree.h"
+
+namespace {
+
+void write_big_endian(char *buffer, uint32_t value)
+{
+  buffer[0] = static_cast<char>(value >> 24);
+  buffer[1] = static_cast<char>(value >> 16);
+  buffer[2] = static_cast<char>(value >> 8);
+  buffer[3] = static_cast<char>(value);
+}
+
+/// 读取4个字节，超出数据长度的部分按照0处理
+uint32_t read_big_endian(const char *data, int len, int pos)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    const uint8_t byte = (pos + i < len) ? static_cast<uint8_t>(data[pos + i]) : 0;
+    value              = (value << 8) | byte;
+  }
+  return value;
+}
+
+/// 按字节比较顺序与数值顺序一致的整数/浮点数，长度都是4
+bool is_ordered_numeric(AttrType type, int length)
+{
+  return (type == INTS || type == DATES || type == FLOATS) && length == 4;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+CompactKeyCodec::CompactKeyCodec(const IndexFileHeader &header) : header_(header)
+{
+  // 与 AttrComparator 保持一致：多个属性时，第一个属性是null位图
+  has_null_bitmap_ = header.attr_num > 1;
+  bitmap_length_   = has_null_bitmap_ ? header.attr_length[0] : 0;
+}
+
+int CompactKeyCodec::max_encoded_length() const
+{
+  int length = 0;
+  for (int i = has_null_bitmap_ ? 1 : 0; i < header_.attr_num; i++) {
+    length += header_.attr_length[i] + (has_null_bitmap_ ? 1 : 0);
+  }
+  return length + static_cast<int>(sizeof(RID)) + bitmap_length_;
+}
+
+int CompactKeyCodec::encode(const char *key, char *buffer) const { return encode_internal(key, buffer, nullptr); }
+
+int CompactKeyCodec::encode_internal(const char *key, char *buffer, vector<bool> *truncatable) const
+{
+  int  pos   = 0;
+  auto store = [&](char byte, bool can_truncate) {
+    buffer[pos] = byte;
+    if (truncatable != nullptr) {
+      truncatable->push_back(can_truncate);
+    }
+    pos++;
+  };
+
+  common::Bitmap null_map(const_cast<char *>(key), bitmap_length_ * 8);
+
+  int offset = bitmap_length_;
+  for (int i = has_null_bitmap_ ? 1 : 0; i < header_.attr_num; i++) {
+    const AttrType type   = header_.attr_type[i];
+    const int      length = header_.attr_length[i];
+    const char    *value  = key + offset;
+    offset += length;
+
+    if (has_null_bitmap_) {
+      // 截断到这个字节时，属性值都是0，浮点数会解码成NaN
+      const bool is_null = null_map.get_bit(header_.field_id[i]);
+      store(is_null ? 0 : 1, type != FLOATS && (type == CHARS || is_ordered_numeric(type, length)));
+      if (is_null) {
+        continue;
+      }
+    }
+
+    if (is_ordered_numeric(type, length)) {
+      uint32_t bits = 0;
+      memcpy(&bits, value, sizeof(bits));
+      if (type == FLOATS) {
+        bits = (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+      } else {
+        bits ^= 0x80000000U;
+      }
+      char bytes[4];
+      write_big_endian(bytes, bits);
+      for (char byte : bytes) {
+        store(byte, type != FLOATS);
+      }
+    } else if (type == CHARS) {
+      const int str_len = static_cast<int>(strnlen(value, length));
+      for (int j = 0; j < str_len; j++) {
+        store(value[j], true);
+      }
+      if (str_len < length) {
+        store(0, true);
+      }
+    } else {
+      for (int j = 0; j < length; j++) {
+        store(value[j], false);
+      }
+    }
+  }
+
+  const RID *rid = reinterpret_cast<const RID *>(key + offset);
+  char       bytes[sizeof(RID)];
+  write_big_endian(bytes, static_cast<uint32_t>(rid->page_num));
+  write_big_endian(bytes + 4, static_cast<uint32_t>(rid->slot_num));
+  for (char byte : bytes) {
+    store(byte, true);
+  }
+
+  for (int i = 0; i < bitmap_length_; i++) {
+    store(key[i], false);
+  }
+
+  while (pos > 0 && buffer[pos - 1] == 0) {
+    pos--;
+  }
+  return pos;
+}
+
+void CompactKeyCodec::decode(const char *data, int len, char *key) const
+{
+  int  pos       = 0;
+  auto next_byte = [&]() -> char { return pos < len ? data[pos++] : (pos++, 0); };
+
+  // null位图放在最后，先跳过
+  int offset = bitmap_length_;
+
+  // 属性的null标记，解码完成之后写到位图中
+  bool null_flags[sizeof(header_.attr_type) / sizeof(header_.attr_type[0])] = {false};
+
+  for (int i = has_null_bitmap_ ? 1 : 0; i < header_.attr_num; i++) {
+    const AttrType type   = header_.attr_type[i];
+    const int      length = header_.attr_length[i];
+    char          *value  = key + offset;
+    offset += length;
+
+    if (has_null_bitmap_) {
+      null_flags[i] = (next_byte() == 0);
+      if (null_flags[i]) {
+        memset(value, 0, length);
+        continue;
+      }
+    }
+
+    if (is_ordered_numeric(type, length)) {
+      uint32_t bits = read_big_endian(data, len, pos);
+      pos += 4;
+      if (type == FLOATS) {
+        bits = (bits & 0x80000000U) ? (bits & 0x7fffffffU) : ~bits;
+      } else {
+        bits ^= 0x80000000U;
+      }
+      memcpy(value, &bits, sizeof(bits));
+    } else if (type == CHARS) {
+      int j = 0;
+      while (j < length && pos < len) {
+        const char byte = data[pos++];
+        if (byte == 0) {
+          break;
+        }
+        value[j++] = byte;
+      }
+      memset(value + j, 0, length - j);
+    } else {
+      for (int j = 0; j < length; j++) {
+        value[j] = next_byte();
+      }
+    }
+  }
+
+  RID *rid      = reinterpret_cast<RID *>(key + offset);
+  rid->page_num = static_cast<PageNum>(read_big_endian(data, len, pos));
+  rid->slot_num = static_cast<SlotNum>(read_big_endian(data, len, pos + 4));
+  pos += static_cast<int>(sizeof(RID));
+
+  for (int i = 0; i < bitmap_length_; i++) {
+    key[i] = next_byte();
+  }
+
+  if (has_null_bitmap_) {
+    common::Bitmap null_map(key, bitmap_length_ * 8);
+    for (int i = 1; i < header_.attr_num; i++) {
+      if (null_flags[i]) {
+        null_map.set_bit(header_.field_id[i]);
+      } else {
+        null_map.clear_bit(header_.field_id[i]);
+      }
+    }
+  }
+}
+
+bool CompactKeyCodec::shortest_separator(const char *left, const char *right, char *separator) const
+{
+  const int    max_length = max_encoded_length();
+  vector<char> left_encoded(max_length);
+  vector<char> right_encoded(max_length);
+  vector<bool> truncatable;
+  truncatable.reserve(max_length);
+
+  const int left_len  = encode_internal(left, left_encoded.data(), nullptr);
+  const int right_len = encode_internal(right, right_encoded.data(), &truncatable);
+
+  int diff = 0;
+  while (diff < right_len && diff < left_len && left_encoded[diff] == right_encoded[diff]) {
+    diff++;
+  }
+
+  if (diff >= right_len || diff + 1 >= right_len || !truncatable[diff]) {
+    return false;
+  }
+
+  const uint8_t left_byte  = diff < left_len ? static_cast<uint8_t>(left_encoded[diff]) : 0;
+  const uint8_t right_byte = static_cast<uint8_t>(right_encoded[diff]);
+  if (left_byte >= right_byte) {
+    return false;
+  }
+
+  decode(right_encoded.data(), diff + 1, separator);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompactNodeSizer::CompactNodeSizer(const CompactKeyCodec &codec, int capacity, int value_size)
+    : codec_(codec),
+      capacity_(capacity),
+      value_size_(value_size),
+      first_(codec.max_encoded_length()),
+      buffer_(codec.max_encoded_length())
+{}
+
+void CompactNodeSizer::reset()
+{
+  first_len_     = 0;
+  count_         = 0;
+  encoded_bytes_ = 0;
+  common_        = 0;
+}
+
+void CompactNodeSizer::add(const char *key)
+{
+  if (count_ == 0) {
+    first_len_ = codec_.encode(key, first_.data());
+    common_    = first_len_;
+    encoded_bytes_ += first_len_;
+    count_++;
+    return;
+  }
+
+  const int len = codec_.encode(key, buffer_.data());
+  int       common = 0;
+  while (common < common_ && common < len && buffer_[common] == first_[common]) {
+    common++;
+  }
+  common_ = common;
+  encoded_bytes_ += len;
+  count_++;
+}
+
+int CompactNodeSizer::size_with(const char *key) const
+{
+  const int len = codec_.encode(key, buffer_.data());
+  if (count_ == 0) {
+    return calc_size(1, len, len);
+  }
+
+  int common = 0;
+  while (common < common_ && common < len && buffer_[common] == first_[common]) {
+    common++;
+  }
+  return calc_size(count_ + 1, encoded_bytes_ + len, common);
+}
+
+int CompactNodeSizer::size() const { return calc_size(count_, encoded_bytes_, common_); }
+
+int CompactNodeSizer::effective_prefix(int count, int common) const
+{
+  if (count == 0) {
+    return 0;
+  }
+  return min(common, capacity_ / 4 / count);
+}
+
+int CompactNodeSizer::calc_size(int count, int64_t encoded_bytes, int common) const
+{
+  if (count == 0) {
+    return 0;
+  }
+  const int prefix = effective_prefix(count, common);
+  // 每个元素: 槽位(2) + 后缀长度(2) + 后缀 + 值，再加上一个公共前缀
+  const int64_t size =
+      static_cast<int64_t>(count) * (2 + 2 + value_size_) + encoded_bytes - static_cast<int64_t>(count) * prefix + prefix;
+  return static_cast<int>(min<int64_t>(size, numeric_limits<int>::max()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompactNode::CompactNode(const IndexFileHeader &header, IndexNode *node)
+    : header_(header), codec_(header), node_(node), key_length_(header.key_length)
+{
+  const int node_header_size = node->is_leaf ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+
+  area_       = reinterpret_cast<char *>(node) + node_header_size;
+  capacity_   = capacity_of(node->is_leaf);
+  value_size_ = node->is_leaf ? static_cast<int>(sizeof(RID)) : static_cast<int>(sizeof(PageNum));
+}
+
+int CompactNode::capacity_of(bool is_leaf)
+{
+  const int node_header_size = is_leaf ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  return static_cast<int>(BP_PAGE_DATA_SIZE) - node_header_size - HEADER_SIZE;
+}
+
+bool CompactNode::is_applicable(const IndexFileHeader &header)
+{
+  CompactKeyCodec codec(header);
+  const int       max_length = codec.max_encoded_length();
+  const int       capacity   = capacity_of(true);
+  const int       max_entry  = 2 + 2 + max_length + static_cast<int>(sizeof(RID));
+  return max_length <= MAX_ENCODED_LENGTH && max_entry * 8 <= capacity;
+}
+
+uint16_t CompactNode::read_u16(int offset) const
+{
+  uint16_t value = 0;
+  memcpy(&value, area_ + offset, sizeof(value));
+  return value;
+}
+
+void CompactNode::write_u16(int offset, uint16_t value) { memcpy(area_ + offset, &value, sizeof(value)); }
+
+int CompactNode::size() const { return node_->key_num; }
+
+int CompactNode::prefix_length() const { return read_u16(0); }
+
+void CompactNode::init_empty()
+{
+  write_u16(0, 0);
+  write_u16(2, static_cast<uint16_t>(HEADER_SIZE + capacity_));
+  write_u16(4, 0);
+  write_u16(6, 0);
+  node_->key_num = 0;
+}
+
+int CompactNode::used_bytes() const
+{
+  const int prefix_len = prefix_length();
+  const int heap_bytes = HEADER_SIZE + capacity_ - prefix_len - heap_begin() - garbage_bytes();
+  return size() * 2 + heap_bytes + prefix_len;
+}
+
+int CompactNode::max_entry_size() const { return 2 + entry_size(codec_.max_encoded_length()); }
+
+void CompactNode::key_at(int index, char *key) const
+{
+  char buffer[MAX_ENCODED_LENGTH];
+
+  const int   prefix_len = prefix_length();
+  const int   offset     = entry_offset(index);
+  const int   suffix_len = read_u16(offset);
+  memcpy(buffer, prefix(), prefix_len);
+  memcpy(buffer + prefix_len, area_ + offset + 2, suffix_len);
+  codec_.decode(buffer, prefix_len + suffix_len, key);
+}
+
+char *CompactNode::value_at(int index) const
+{
+  const int offset = entry_offset(index);
+  return area_ + offset + 2 + read_u16(offset);
+}
+
+void CompactNode::items_at(int index, int num, char *items) const
+{
+  const int item_size = this->item_size();
+  for (int i = 0; i < num; i++) {
+    char *item = items + static_cast<size_t>(i) * item_size;
+    key_at(index + i, item);
+    memcpy(item + key_length_, value_at(index + i), value_size_);
+  }
+}
+
+bool CompactNode::can_insert(const char *key) const
+{
+  char      encoded[MAX_ENCODED_LENGTH];
+  const int len        = codec_.encode(key, encoded);
+  const int prefix_len = prefix_length();
+  const int n          = size();
+  if (len >= prefix_len && 0 == memcmp(encoded, prefix(), prefix_len) && (n + 1) * prefix_len <= capacity_ / 4) {
+    return free_bytes() >= entry_size(len - prefix_len) + 2;
+  }
+
+  CompactNodeSizer sizer(codec_, capacity_, value_size_);
+  vector<char>     buffer(key_length_);
+  for (int i = 0; i < n; i++) {
+    key_at(i, buffer.data());
+    sizer.add(buffer.data());
+  }
+  return sizer.size_with(key) <= capacity_;
+}
+
+bool CompactNode::insert_in_place(int index, const char *encoded, int len, const char *value)
+{
+  const int prefix_len = prefix_length();
+  const int n          = size();
+  if (len < prefix_len || 0 != memcmp(encoded, prefix(), prefix_len) || (n + 1) * prefix_len > capacity_ / 4) {
+    return false;
+  }
+
+  const int suffix_len = len - prefix_len;
+  const int need       = entry_size(suffix_len);
+  if (free_bytes() < need + 2) {
+    return false;
+  }
+
+  if (heap_begin() - slot_offset(n + 1) < need) {
+    // 空洞整理之后公共前缀可能变长，需要重新检查
+    compact();
+    return insert_in_place(index, encoded, len, value);
+  }
+
+  const int offset = heap_begin() - need;
+  write_u16(offset, static_cast<uint16_t>(suffix_len));
+  memcpy(area_ + offset + 2, encoded + prefix_len, suffix_len);
+  memcpy(area_ + offset + 2 + suffix_len, value, value_size_);
+
+  memmove(area_ + slot_offset(index + 1), area_ + slot_offset(index), static_cast<size_t>(n - index) * 2);
+  write_u16(slot_offset(index), static_cast<uint16_t>(offset));
+  write_u16(2, static_cast<uint16_t>(offset));
+  node_->key_num++;
+  return true;
+}
+
+RC CompactNode::insert_items(int index, const char *items, int num)
+{
+  if (num == 1) {
+    char      encoded[MAX_ENCODED_LENGTH];
+    const int len = codec_.encode(items, encoded);
+    if (insert_in_place(index, encoded, len, items + key_length_)) {
+      return RC::SUCCESS;
+    }
+  }
+
+  const int    n         = size();
+  const size_t item_size = this->item_size();
+  vector<char> all_items((n + num) * item_size);
+  items_at(0, index, all_items.data());
+  memcpy(all_items.data() + index * item_size, items, num * item_size);
+  items_at(index, n - index, all_items.data() + (index + num) * item_size);
+  return rebuild(all_items.data(), n + num);
+}
+
+void CompactNode::remove_items(int index, int num)
+{
+  const int n = size();
+  if (num >= n) {
+    init_empty();
+    return;
+  }
+
+  if (num > 1) {
+    // 删除多个元素时通常是节点分裂或者合并，重建可以让公共前缀更长
+    const size_t item_size = this->item_size();
+    vector<char> rest_items((n - num) * item_size);
+    items_at(0, index, rest_items.data());
+    items_at(index + num, n - index - num, rest_items.data() + index * item_size);
+    RC rc = rebuild(rest_items.data(), n - num);
+    ASSERT(OB_SUCC(rc), "rebuild node with less items should never fail. rc=%s", strrc(rc));
+    return;
+  }
+
+  const int offset = entry_offset(index);
+  const int bytes  = entry_size(read_u16(offset));
+  if (offset == heap_begin()) {
+    write_u16(2, static_cast<uint16_t>(offset + bytes));
+  } else {
+    write_u16(4, static_cast<uint16_t>(garbage_bytes() + bytes));
+  }
+  memmove(area_ + slot_offset(index), area_ + slot_offset(index + 1), static_cast<size_t>(n - index - 1) * 2);
+  node_->key_num--;
+}
+
+bool CompactNode::can_set_key_at(int index, const char *key) const
+{
+  const int        n = size();
+  CompactNodeSizer sizer(codec_, capacity_, value_size_);
+  vector<char>     buffer(key_length_);
+  for (int i = 0; i < n; i++) {
+    if (i == index) {
+      sizer.add(key);
+    } else {
+      key_at(i, buffer.data());
+      sizer.add(buffer.data());
+    }
+  }
+  return sizer.size() <= capacity_;
+}
+
+RC CompactNode::set_key_at(int index, const char *key)
+{
+  const int    n         = size();
+  const size_t item_size = this->item_size();
+  vector<char> items(n * item_size);
+  items_at(0, n, items.data());
+  memcpy(items.data() + index * item_size, key, key_length_);
+  return rebuild(items.data(), n);
+}
+
+bool CompactNode::is_full() const { return free_bytes() < max_entry_size() + size() * prefix_length(); }
+
+bool CompactNode::is_underflow() const { return used_bytes() < capacity_ / 3; }
+
+bool CompactNode::can_remove_one() const { return used_bytes() - max_entry_size() >= capacity_ / 3; }
+
+bool CompactNode::can_merge(const CompactNode &other) const
+{
+  CompactNodeSizer sizer(codec_, capacity_, value_size_);
+  vector<char>     buffer(key_length_);
+  for (const CompactNode *node : {this, &other}) {
+    for (int i = 0; i < node->size(); i++) {
+      node->key_at(i, buffer.data());
+      sizer.add(buffer.data());
+    }
+  }
+  return sizer.size() <= capacity_;
+}
+
+int CompactNode::split_index() const
+{
+  const int n = size();
+  if (n < 2) {
+    return n;
+  }
+
+  vector<int> costs(n);
+  int         total = 0;
+  for (int i = 0; i < n; i++) {
+    costs[i] = 2 + entry_size(read_u16(entry_offset(i)));
+    total += costs[i];
+  }
+
+  int accumulated = 0;
+  for (int i = 0; i < n; i++) {
+    accumulated += costs[i];
+    if (accumulated * 2 >= total) {
+      return clamp(i + 1, 1, n - 1);
+    }
+  }
+  return n - 1;
+}
+
+RC CompactNode::rebuild(const char *items, int num)
+{
+  const size_t     item_size = this->item_size();
+  CompactNodeSizer sizer(codec_, capacity_, value_size_);
+  for (int i = 0; i < num; i++) {
+    sizer.add(items + i * item_size);
+  }
+  if (sizer.size() > capacity_) {
+    LOG_WARN("items cannot fit in compact node. items=%d, size=%d, capacity=%d", num, sizer.size(), capacity_);
+    return RC::RECORD_NOMEM;
+  }
+
+  const int prefix_len = sizer.prefix_length();
+  const int area_end   = HEADER_SIZE + capacity_;
+  memcpy(area_ + area_end - prefix_len, sizer.first_encoded(), prefix_len);
+
+  char encoded[MAX_ENCODED_LENGTH];
+  int  heap = area_end - prefix_len;
+  for (int i = 0; i < num; i++) {
+    const char *item       = items + i * item_size;
+    const int   len        = codec_.encode(item, encoded);
+    const int   suffix_len = len - prefix_len;
+    heap -= entry_size(suffix_len);
+    write_u16(heap, static_cast<uint16_t>(suffix_len));
+    memcpy(area_ + heap + 2, encoded + prefix_len, suffix_len);
+    memcpy(area_ + heap + 2 + suffix_len, item + key_length_, value_size_);
+    write_u16(slot_offset(i), static_cast<uint16_t>(heap));
+  }
+
+  write_u16(0, static_cast<uint16_t>(prefix_len));
+  write_u16(2, static_cast<uint16_t>(heap));
+  write_u16(4, 0);
+  node_->key_num = num;
+  return RC::SUCCESS;
+}
+
+void CompactNode::compact()
+{
+  const int    n = size();
+  vector<char> items(n * item_size());
+  items_at(0, n, items.data());
+  RC rc = rebuild(items.data(), n);
+  ASSERT(OB_SUCC(rc), "compact node should never fail. rc=%s", strrc(rc));
+}
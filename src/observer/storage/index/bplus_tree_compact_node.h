@@ -0,0 +1,234 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/lang/vector.h"
+#include "common/rc.h"
+
+struct IndexFileHeader;
+struct IndexNode;
+
+/**
+ * @brief 紧凑格式中键值的编码
+ * @ingroup BPlusTree
+ * @details 把定长的键值(属性 + RID)编码成变长的字节串，编码之后按字节比较的顺序与原来的比较顺序一致，
+ * 这样同一个节点中的键值会有比较长的公共前缀。
+ * - 多字段索引的每个属性前面有一个字节表示是否为null(0表示null)，null值不再保存属性值；
+ * - INTS/DATES 使用大端序并翻转符号位；FLOATS 转换成可以按字节比较的形式；
+ * - CHARS 只保存到第一个'\0'为止，如果没有占满整个属性，就再保存一个'\0'作为结束符；
+ * - RID 的两个整数使用大端序，RID都是非负数，不需要翻转符号位；
+ * - 最后保存原始的null位图，解码时可以完整地还原出来；
+ * - 去掉末尾所有的0，解码时不足的部分都按照0处理。
+ * FLOATS 的比较带有误差，编码后按字节比较的顺序与比较函数并不完全一致，
+ * 所以编码的顺序只用来提高压缩率，正确性不依赖于它。
+ */
+class CompactKeyCodec
+{
+public:
+  explicit CompactKeyCodec(const IndexFileHeader &header);
+
+  /// @brief 编码后最长的长度
+  int max_encoded_length() const;
+
+  /**
+   * @brief 编码一个键值
+   * @param key 定长格式的键值
+   * @param buffer 至少有 max_encoded_length 字节
+   * @return 编码后的长度
+   */
+  int encode(const char *key, char *buffer) const;
+
+  /**
+   * @brief 解码一个键值
+   * @param data 编码后的数据，可以比 encode 的结果短，缺少的部分按照0处理
+   * @param key 定长格式的键值，大小是 key_length
+   */
+  void decode(const char *data, int len, char *key) const;
+
+  /**
+   * @brief 后缀截断。计算一个尽量短的分隔键，满足 left < separator <= right
+   * @details 找到 left 与 right 编码后第一个不同的字节，保留 right 编码到这个字节为止的部分。
+   * 不同的字节落在 FLOATS 属性或者null位图中时不能截断。
+   * @param separator 定长格式的键值，大小是 key_length
+   * @return 是否截断成功。调用者还应该使用比较函数验证结果
+   */
+  bool shortest_separator(const char *left, const char *right, char *separator) const;
+
+private:
+  /**
+   * @brief 编码，同时记录每个字节处能否截断
+   * @param truncatable 如果不是null，对每个字节标记是否能在这里截断
+   */
+  int encode_internal(const char *key, char *buffer, vector<bool> *truncatable) const;
+
+private:
+  const IndexFileHeader &header_;
+  bool                   has_null_bitmap_ = false;
+  int                    bitmap_length_   = 0;
+};
+
+/**
+ * @brief 计算一组元素重建成紧凑格式的节点后占用的空间
+ * @ingroup BPlusTree
+ * @details 按照顺序逐个添加键值，记录公共前缀和编码后的总长度
+ */
+class CompactNodeSizer
+{
+public:
+  CompactNodeSizer(const CompactKeyCodec &codec, int capacity, int value_size);
+
+  /// @brief 添加一个键值
+  void add(const char *key);
+  /// @brief 如果再添加这个键值，节点会占用多少空间
+  int  size_with(const char *key) const;
+  /// @brief 当前节点会占用多少空间
+  int  size() const;
+  /// @brief 重建时使用的前缀长度
+  int  prefix_length() const { return effective_prefix(count_, common_); }
+  int  count() const { return count_; }
+  void reset();
+
+  /// @brief 编码后的第一个键值，前缀就是它的前 prefix_length 个字节
+  const char *first_encoded() const { return first_.data(); }
+
+private:
+  int effective_prefix(int count, int common) const;
+  int calc_size(int count, int64_t encoded_bytes, int common) const;
+
+private:
+  const CompactKeyCodec &codec_;
+  int                    capacity_   = 0;
+  int                    value_size_ = 0;
+
+  vector<char>         first_;    ///< 第一个键值编码后的结果
+  int                  first_len_ = 0;
+  mutable vector<char> buffer_;   ///< 编码时使用的临时空间
+  int                  count_         = 0;
+  int64_t              encoded_bytes_ = 0;  ///< 所有键值编码后的总长度
+  int                  common_        = 0;  ///< 所有键值编码后的公共前缀长度
+};
+
+/**
+ * @brief 紧凑格式的节点
+ * @ingroup BPlusTree
+ * @details 紧凑格式的节点使用槽位目录存放变长的元素，所有元素共享一个公共前缀。
+ * @code
+ * storage format(after the common header of leaf or internal node):
+ * | prefix length | heap begin | garbage bytes | reserved | slot0 | slot1 | ... | slotn |
+ * | free space ... | entry ... | prefix |
+ * entry: | suffix length | suffix | value |
+ * @endcode
+ * 槽位按照键值的顺序存放每个元素的偏移，元素从后往前分配。删除元素只是删除槽位，留下的空洞在空间不足时整理。
+ * 为了保证插入一个元素时节点不会因为公共前缀变短而放不下，公共前缀节省的空间不超过节点容量的1/4，
+ * 也就是 元素个数 * 前缀长度 <= 容量 / 4。
+ * 节点中的元素个数依然记录在 IndexNode::key_num 中。
+ */
+class CompactNode
+{
+public:
+  static constexpr int HEADER_SIZE        = 8;
+  static constexpr int MAX_ENCODED_LENGTH = 1024;  ///< 键值编码后的最大长度
+
+  CompactNode(const IndexFileHeader &header, IndexNode *node);
+
+  void init_empty();
+
+  /// @brief 可以存放元素的空间，不包含节点头
+  int capacity() const { return capacity_; }
+  /// @brief 叶子节点或内部节点可以存放元素的空间
+  static int capacity_of(bool is_leaf);
+  /// @brief 有效数据占用的空间，包括槽位、元素和前缀，不包括空洞
+  int used_bytes() const;
+  int free_bytes() const { return capacity_ - used_bytes(); }
+  int prefix_length() const;
+
+  int value_size() const { return value_size_; }
+  int item_size() const { return key_length_ + value_size_; }
+
+  /// @brief 解码第index个键值，key 的大小是 key_length
+  void  key_at(int index, char *key) const;
+  char *value_at(int index) const;
+  /// @brief 按照定长格式(键值 + 值)复制出从index开始的num个元素
+  void  items_at(int index, int num, char *items) const;
+
+  /**
+   * @brief 精确计算插入一个键值后是否还能放下
+   */
+  bool can_insert(const char *key) const;
+
+  /**
+   * @brief 在index位置插入num个定长格式的元素
+   * @return 空间不足时返回 RECORD_NOMEM，节点不做任何修改
+   */
+  RC insert_items(int index, const char *items, int num);
+  void remove_items(int index, int num);
+
+  bool can_set_key_at(int index, const char *key) const;
+  RC   set_key_at(int index, const char *key);
+
+  /**
+   * @brief 不管插入什么键值都一定能放下
+   * @details 插入的键值可能与公共前缀不同，导致所有元素都需要保存完整的键值，
+   * 所以要预留 元素个数 * 前缀长度 的空间
+   */
+  bool is_full() const;
+  /// @brief 有效数据少于容量的1/3
+  bool is_underflow() const;
+  /// @brief 删除任意一个元素后都不会低于下限
+  bool can_remove_one() const;
+  /// @brief 与另一个节点的所有元素合并后能否放下
+  bool can_merge(const CompactNode &other) const;
+  /// @brief 按照占用空间对半拆分时，右半部分从哪个元素开始
+  int  split_index() const;
+
+  /**
+   * @brief 使用这些元素重新构建节点
+   * @return 放不下时返回 RECORD_NOMEM，节点不做任何修改
+   */
+  RC rebuild(const char *items, int num);
+
+  /// @brief 元素最多占用的空间，包括槽位
+  int max_entry_size() const;
+
+  /**
+   * @brief 检查索引的键值能否使用紧凑格式
+   * @details 为了保证节点分裂之后一定能放下新插入的元素，一个元素最多占用容量的1/8
+   */
+  static bool is_applicable(const IndexFileHeader &header);
+
+private:
+  uint16_t    read_u16(int offset) const;
+  void        write_u16(int offset, uint16_t value);
+  int         size() const;
+  int         slot_offset(int index) const { return HEADER_SIZE + index * 2; }
+  int         entry_offset(int index) const { return read_u16(slot_offset(index)); }
+  int         entry_size(int suffix_len) const { return 2 + suffix_len + value_size_; }
+  int         heap_begin() const { return read_u16(2); }
+  int         garbage_bytes() const { return read_u16(4); }
+  const char *prefix() const { return area_ + capacity_ + HEADER_SIZE - prefix_length(); }
+
+  /// @brief 按照编码后的格式把元素直接插入到index位置，不重建节点
+  bool insert_in_place(int index, const char *encoded, int len, const char *value);
+
+  /// @brief 整理空洞
+  void compact();
+
+private:
+  const IndexFileHeader &header_;
+  CompactKeyCodec        codec_;
+  IndexNode             *node_       = nullptr;
+  char                  *area_       = nullptr;
+  int                    capacity_   = 0;
+  int                    key_length_ = 0;
+  int                    value_size_ = 0;
+};
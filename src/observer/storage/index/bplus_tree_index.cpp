@@ -13,12 +13,39 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/bplus_tree_index.h"
+#include "common/conf/ini.h"
 #include "common/log/log.h"
 #include "storage/table/table.h"
 #include "storage/db/db.h"
 
 BplusTreeIndex::~BplusTreeIndex() noexcept { close(); }
 
+/**
+ * @brief 读取配置 [INDEX] KEY_FORMAT，确定新建索引的键值格式
+ * @details fixed 是定长格式，compact 是紧凑格式。
+ * auto 在索引包含较长的字符串字段时使用紧凑格式，因为字符串通常有比较长的公共前缀，并且很少占满整个字段。
+ */
+static BplusTreeKeyFormat key_format_from_config(const std::vector<const FieldMeta *> &field_metas)
+{
+  static constexpr int AUTO_COMPACT_CHARS_LENGTH = 16;
+
+  string key_format = common::get_properties()->get("KEY_FORMAT", "fixed", "INDEX");
+  if (key_format == "compact") {
+    return BplusTreeKeyFormat::COMPACT;
+  }
+  if (key_format != "auto") {
+    return BplusTreeKeyFormat::FIXED;
+  }
+
+  // 多字段索引的第一个字段是null位图
+  for (size_t i = field_metas.size() > 1 ? 1 : 0; i < field_metas.size(); i++) {
+    if (field_metas[i]->type() == AttrType::CHARS && field_metas[i]->len() >= AUTO_COMPACT_CHARS_LENGTH) {
+      return BplusTreeKeyFormat::COMPACT;
+    }
+  }
+  return BplusTreeKeyFormat::FIXED;
+}
+
 RC BplusTreeIndex::create(Table *table, const char *file_name, const bool unique, const IndexMeta &index_meta, const std::vector<int> &field_ids, const std::vector<const FieldMeta*> &field_metas)
 {
   if (inited_) {
@@ -30,13 +57,16 @@ RC BplusTreeIndex::create(Table *table, const char *file_name, const bool unique
   Index::init(index_meta, field_metas);
 
   BufferPoolManager &bpm = table->db()->buffer_pool_manager();
-  RC rc = index_handler_.create(table->db()->log_handler(), bpm, file_name, unique, field_ids, field_metas);
+  RC rc = index_handler_.create(table->db()->log_handler(), bpm, file_name, unique, field_ids, field_metas,
+      -1 /*internal_max_size*/, -1 /*leaf_max_size*/, key_format_from_config(field_metas));
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name, index_meta.name(), index_meta.field(), strrc(rc));
     return rc;
   }
 
+  index_handler_.enable_adaptive_hash(AdaptiveHashOptions::from_config());
+
   inited_ = true;
   table_  = table;
   LOG_INFO("Successfully create index, file_name:%s, index:%s, field:%s",
@@ -62,6 +92,8 @@ RC BplusTreeIndex::open(Table *table, const char *file_name, const IndexMeta &in
     return rc;
   }
 
+  index_handler_.enable_adaptive_hash(AdaptiveHashOptions::from_config());
+
   inited_ = true;
   table_  = table;
   LOG_INFO("Successfully open index, file_name:%s, index:%s, field:%s",
@@ -90,11 +122,12 @@ RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
   return index_handler_.delete_entry(record, rid);
 }
 
-IndexScanner *BplusTreeIndex::create_scanner(
-    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+IndexScanner *BplusTreeIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive,
+    const char *right_key, int right_len, bool right_inclusive, int left_attr_num, int right_attr_num)
 {
   BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(index_handler_);
-  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  RC rc = index_scanner->open(
+      left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, left_attr_num, right_attr_num);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
     delete index_scanner;
@@ -103,21 +136,40 @@ IndexScanner *BplusTreeIndex::create_scanner(
   return index_scanner;
 }
 
+RC BplusTreeIndex::get_entries(const std::vector<const char *> &keys, const std::vector<int> &key_lens,
+    std::vector<std::list<RID>> &rids, int attr_num)
+{
+  return index_handler_.get_entries(keys, key_lens, rids, attr_num);
+}
+
 RC BplusTreeIndex::sync() { return index_handler_.sync(); }
 
+RC BplusTreeIndex::on_redo_done() { return index_handler_.reload_header(); }
+
 ////////////////////////////////////////////////////////////////////////////////
 BplusTreeIndexScanner::BplusTreeIndexScanner(BplusTreeHandler &tree_handler) : tree_scanner_(tree_handler) {}
 
 BplusTreeIndexScanner::~BplusTreeIndexScanner() noexcept { tree_scanner_.close(); }
 
-RC BplusTreeIndexScanner::open(
-    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+RC BplusTreeIndexScanner::open(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+    int right_len, bool right_inclusive, int left_attr_num, int right_attr_num)
 {
-  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  return tree_scanner_.open(
+      left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, left_attr_num, right_attr_num);
 }
 
 RC BplusTreeIndexScanner::next_entry(RID *rid) { return tree_scanner_.next_entry(*rid); }
 
+RC BplusTreeIndexScanner::next_batch(RID *rids, int capacity, int &count)
+{
+  return tree_scanner_.next_batch(rids, capacity, count);
+}
+
+RC BplusTreeIndexScanner::next_batch_with_keys(RID *rids, char *keys, int capacity, int &count)
+{
+  return tree_scanner_.next_batch(rids, capacity, count, keys);
+}
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
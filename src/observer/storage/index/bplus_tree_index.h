@@ -38,10 +38,20 @@ public:
    * 扫描指定范围的数据
    */
   IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
-      int right_len, bool right_inclusive) override;
+      int right_len, bool right_inclusive, int left_attr_num = 1, int right_attr_num = 1) override;
+
+  RC get_entries(const std::vector<const char *> &keys, const std::vector<int> &key_lens,
+      std::vector<std::list<RID>> &rids, int attr_num = 1) override;
 
   RC sync() override;
 
+  RC on_redo_done() override;
+
+  /**
+   * @brief 底层的B+树。批量构建索引时使用
+   */
+  BplusTreeHandler &tree_handler() { return index_handler_; }
+
 private:
   bool             inited_ = false;
   Table           *table_  = nullptr;
@@ -59,10 +69,12 @@ public:
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  RC next_batch(RID *rids, int capacity, int &count) override;
+  RC next_batch_with_keys(RID *rids, char *keys, int capacity, int &count) override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
-      bool right_inclusive);
+      bool right_inclusive, int left_attr_num = 1, int right_attr_num = 1);
 
 private:
   BplusTreeScanner tree_scanner_;
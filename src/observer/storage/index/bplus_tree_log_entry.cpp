@@ -328,11 +328,19 @@ RC NormalOperationLogEntryHandler::rollback(BplusTreeMiniTransaction &mtr, Bplus
   if (nullptr == frame()) {
     return RC::INTERNAL;
   }
-  IndexNodeHandler node_handler(mtr, tree_handler.file_header(), frame());
+  // 需要使用具体的节点类型，基类无法定位元素的位置
+  InternalIndexNodeHandler internal_node(mtr, tree_handler.file_header(), frame());
+  LeafIndexNodeHandler     leaf_node(mtr, tree_handler.file_header(), frame());
+  IndexNodeHandler        *real_handler = nullptr;
+  if (leaf_node.is_leaf()) {
+    real_handler = &leaf_node;
+  } else {
+    real_handler = &internal_node;
+  }
   if (operation_type().type() == LogOperation::Type::NODE_INSERT) {
-    return node_handler.recover_remove_items(index_, item_num_);
+    return real_handler->recover_remove_items(index_, item_num_);
   } else {  // should be NODE_REMOVE
-    return node_handler.recover_insert_items(index_, items_.data(), item_num_);
+    return real_handler->recover_insert_items(index_, items_.data(), item_num_);
   }
 }
 
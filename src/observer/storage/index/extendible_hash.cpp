@@ -0,0 +1,892 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/extendible_hash.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/bitmap.h"
+#include "common/lang/defer.h"
+#include "common/lang/sstream.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/frame.h"
+#include "storage/field/field_meta.h"
+
+using namespace common;
+
+/// 文件头所在的页面，第0个页面是缓冲池自己使用的
+static constexpr PageNum EXTENDIBLE_HASH_HEADER_PAGE = 1;
+
+namespace {
+
+uint32_t depth_mask(int depth) { return depth >= 32 ? ~0U : ((1U << depth) - 1); }
+
+/// 把一个页面上的桶头和元素组成 BUCKET_IMAGE 的数据
+vector<char> make_bucket_image(int local_depth, PageNum next_page, const char *entries, int entry_num, int entry_size)
+{
+  ExtendibleHashBucketHeader header;
+  header.local_depth = local_depth;
+  header.size        = entry_num;
+  header.next_page   = next_page;
+
+  vector<char> image(ExtendibleHashBucketHeader::SIZE + static_cast<size_t>(entry_num) * entry_size);
+  memcpy(image.data(), &header, ExtendibleHashBucketHeader::SIZE);
+  if (entry_num > 0) {
+    memcpy(image.data() + ExtendibleHashBucketHeader::SIZE, entries, static_cast<size_t>(entry_num) * entry_size);
+  }
+  return image;
+}
+
+}  // namespace
+
+string ExtendibleHashFileHeader::to_string() const
+{
+  stringstream ss;
+  ss << "attr_num:" << attr_num << ", key_length:" << key_length << ", unique:" << unique
+     << ", bucket_capacity:" << bucket_capacity
+     << ", global_depth:" << global_depth << ", directory_page_num:" << directory_page_num;
+  return ss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class ExtendibleHashHandler
+
+ExtendibleHashHandler::~ExtendibleHashHandler() { close(); }
+
+RC ExtendibleHashHandler::create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, bool unique,
+    const vector<int> &field_ids, const vector<const FieldMeta *> &fields)
+{
+  if (fields.empty() || fields.size() > static_cast<size_t>(ExtendibleHashFileHeader::MAX_ATTR_NUM) ||
+      fields.size() != field_ids.size()) {
+    LOG_WARN("invalid fields of extendible hash. field num=%d", static_cast<int>(fields.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 多字段时第一个字段是null位图，不需要检查类型
+  for (size_t i = fields.size() > 1 ? 1 : 0; i < fields.size(); i++) {
+    const AttrType type = fields[i]->type();
+    if (type != AttrType::INTS && type != AttrType::DATES && type != AttrType::CHARS) {
+      LOG_WARN("extendible hash does not support field type %s. field=%s", attr_type_to_string(type), fields[i]->name());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  RC rc = bpm.create_file(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  DiskBufferPool *bp = nullptr;
+  rc                 = bpm.open_file(log_handler, file_name, bp);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  ExtendibleHashFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.attr_num = static_cast<int32_t>(fields.size());
+  for (size_t i = 0; i < fields.size(); i++) {
+    header.attr_length[i] = fields[i]->len();
+    header.attr_offset[i] = fields[i]->offset();
+    header.field_id[i]    = field_ids[i];
+    header.attr_type[i]   = fields[i]->type();
+    header.key_length += fields[i]->len();
+  }
+  header.unique             = unique ? 1 : 0;
+  header.bucket_capacity    = ExtendibleHashBucketHeader::capacity(header.entry_size());
+  header.global_depth       = 0;
+  header.directory_page_num = 1;
+
+  // 文件头、第一个目录页面和第一个桶不记录日志，创建完成后直接刷到磁盘。原因参考 BplusTreeHandler::create
+  Frame *header_frame    = nullptr;
+  Frame *directory_frame = nullptr;
+  Frame *bucket_frame    = nullptr;
+  rc                     = bp->allocate_page(&header_frame);
+  if (OB_SUCC(rc)) {
+    rc = bp->allocate_page(&directory_frame);
+  }
+  if (OB_SUCC(rc)) {
+    rc = bp->allocate_page(&bucket_frame);
+  }
+  if (OB_FAIL(rc) || header_frame->page_num() != EXTENDIBLE_HASH_HEADER_PAGE) {
+    LOG_WARN("failed to allocate pages for extendible hash. file name=%s, rc=%s", file_name, strrc(rc));
+    bpm.close_file(file_name);
+    return OB_FAIL(rc) ? rc : RC::INTERNAL;
+  }
+
+  header.directory_pages[0] = directory_frame->page_num();
+
+  auto directory = reinterpret_cast<PageNum *>(directory_frame->data());
+  for (int i = 0; i < ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY; i++) {
+    directory[i] = BP_INVALID_PAGE_NUM;
+  }
+  directory[0] = bucket_frame->page_num();
+
+  vector<char> image = make_bucket_image(0, BP_INVALID_PAGE_NUM, nullptr, 0, header.entry_size());
+  memcpy(bucket_frame->data(), image.data(), image.size());
+  memcpy(header_frame->data(), &header, sizeof(header));
+
+  for (Frame *frame : {header_frame, directory_frame, bucket_frame}) {
+    frame->mark_dirty();
+  }
+  bp->unpin_page(directory_frame);
+  bp->unpin_page(bucket_frame);
+
+  log_handler_      = &log_handler;
+  disk_buffer_pool_ = bp;
+  header_frame_     = header_frame;
+  header_           = reinterpret_cast<ExtendibleHashFileHeader *>(header_frame->data());
+
+  rc = bp->flush_all_pages_to_disk();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush extendible hash. file name=%s, rc=%s", file_name, strrc(rc));
+    close();
+    return rc;
+  }
+
+  LOG_INFO("Successfully create extendible hash %s. header=%s", file_name, header_->to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("%s has been opened before.", file_name);
+    return RC::RECORD_OPENNED;
+  }
+
+  DiskBufferPool *bp = nullptr;
+  RC              rc = bpm.open_file(log_handler, file_name, bp);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  Frame *frame = nullptr;
+  rc           = bp->get_this_page(EXTENDIBLE_HASH_HEADER_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get header page. file name=%s, rc=%s", file_name, strrc(rc));
+    bpm.close_file(file_name);
+    return rc;
+  }
+
+  log_handler_      = &log_handler;
+  disk_buffer_pool_ = bp;
+  header_frame_     = frame;
+  header_           = reinterpret_cast<ExtendibleHashFileHeader *>(frame->data());
+  LOG_INFO("Successfully open extendible hash %s. header=%s", file_name, header_->to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::close()
+{
+  if (header_frame_ != nullptr) {
+    disk_buffer_pool_->unpin_page(header_frame_);
+    header_frame_ = nullptr;
+    header_       = nullptr;
+  }
+  if (disk_buffer_pool_ != nullptr) {
+    disk_buffer_pool_->close_file();
+  }
+  disk_buffer_pool_ = nullptr;
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::sync() { return disk_buffer_pool_->flush_all_pages(); }
+
+void ExtendibleHashHandler::make_key(const char *record, char *key) const
+{
+  int offset = 0;
+  for (int i = 0; i < header_->attr_num; i++) {
+    memcpy(key + offset, record + header_->attr_offset[i], header_->attr_length[i]);
+    offset += header_->attr_length[i];
+  }
+}
+
+void ExtendibleHashHandler::make_search_key(const char *user_key, int key_len, char *key) const
+{
+  // null位图全部清零，表示所有字段都不是null
+  memset(key, 0, header_->key_length);
+  const int offset = header_->attr_num > 1 ? header_->attr_length[0] : 0;
+  memcpy(key + offset, user_key, key_len);
+}
+
+uint64_t ExtendibleHashHandler::hash_key(const char *key) const
+{
+  // FNV-1a，哈希值会持久化到目录的结构中，不能使用与实现相关的 std::hash
+  uint64_t hash   = 14695981039346656037ULL;
+  auto     update = [&hash](const char *data, int len) {
+    for (int i = 0; i < len; i++) {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ULL;
+    }
+  };
+
+  const bool has_bitmap = header_->attr_num > 1;
+  Bitmap     null_map(const_cast<char *>(key), has_bitmap ? header_->attr_length[0] * 8 : 0);
+  int        offset = has_bitmap ? header_->attr_length[0] : 0;
+  for (int i = has_bitmap ? 1 : 0; i < header_->attr_num; i++) {
+    const char *value = key + offset;
+    offset += header_->attr_length[i];
+
+    if (has_bitmap && null_map.get_bit(header_->field_id[i])) {
+      const char null_flag = 1;
+      update(&null_flag, 1);
+      continue;
+    }
+
+    const char not_null_flag = 0;
+    update(&not_null_flag, 1);
+    if (header_->attr_type[i] == AttrType::CHARS) {
+      update(value, static_cast<int>(strnlen(value, header_->attr_length[i])));
+    } else {
+      update(value, header_->attr_length[i]);
+    }
+  }
+
+  // FNV的低位分布不够均匀，目录使用的是低位，再混合一次
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+bool ExtendibleHashHandler::key_equal(const char *key1, const char *key2) const
+{
+  const bool has_bitmap = header_->attr_num > 1;
+  Bitmap     null_map1(const_cast<char *>(key1), has_bitmap ? header_->attr_length[0] * 8 : 0);
+  Bitmap     null_map2(const_cast<char *>(key2), has_bitmap ? header_->attr_length[0] * 8 : 0);
+  int        offset = has_bitmap ? header_->attr_length[0] : 0;
+  for (int i = has_bitmap ? 1 : 0; i < header_->attr_num; i++) {
+    const int length = header_->attr_length[i];
+    if (has_bitmap) {
+      const bool null1 = null_map1.get_bit(header_->field_id[i]);
+      const bool null2 = null_map2.get_bit(header_->field_id[i]);
+      if (null1 != null2) {
+        return false;
+      }
+      if (null1) {
+        offset += length;
+        continue;
+      }
+    }
+
+    const int cmp = header_->attr_type[i] == AttrType::CHARS ? strncmp(key1 + offset, key2 + offset, length)
+                                                             : memcmp(key1 + offset, key2 + offset, length);
+    if (cmp != 0) {
+      return false;
+    }
+    offset += length;
+  }
+  return true;
+}
+
+bool ExtendibleHashHandler::key_has_null(const char *key) const
+{
+  if (header_->attr_num <= 1) {
+    return false;
+  }
+
+  Bitmap null_map(const_cast<char *>(key), header_->attr_length[0] * 8);
+  for (int i = 1; i < header_->attr_num; i++) {
+    if (null_map.get_bit(header_->field_id[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RC ExtendibleHashHandler::find_bucket(uint64_t hash, PageNum &bucket) const
+{
+  const uint32_t index          = static_cast<uint32_t>(hash) & depth_mask(header_->global_depth);
+  const int      directory_page = index / ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY;
+  const int      slot           = index % ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY;
+
+  Frame *frame = nullptr;
+  RC     rc    = disk_buffer_pool_->get_this_page(header_->directory_pages[directory_page], &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get directory page. page=%d, rc=%s", header_->directory_pages[directory_page], strrc(rc));
+    return rc;
+  }
+
+  bucket = reinterpret_cast<const PageNum *>(frame->data())[slot];
+  disk_buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::read_bucket(
+    PageNum bucket, vector<char> &entries, vector<PageNum> &pages, int &local_depth) const
+{
+  const int entry_size = header_->entry_size();
+
+  entries.clear();
+  pages.clear();
+  for (PageNum page_num = bucket; page_num != BP_INVALID_PAGE_NUM;) {
+    Frame *frame = nullptr;
+    RC     rc    = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get bucket page. page=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    auto        bucket_header = reinterpret_cast<const ExtendibleHashBucketHeader *>(frame->data());
+    const char *data          = frame->data() + ExtendibleHashBucketHeader::SIZE;
+    entries.insert(entries.end(), data, data + static_cast<size_t>(bucket_header->size) * entry_size);
+    if (pages.empty()) {
+      local_depth = bucket_header->local_depth;
+    }
+    pages.push_back(page_num);
+
+    page_num = bucket_header->next_page;
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::get_entries(const char *user_key, int key_len, list<RID> &rids, vector<char> *keys)
+{
+  const int bitmap_len = header_->attr_num > 1 ? header_->attr_length[0] : 0;
+  if (key_len < 0 || key_len > header_->key_length - bitmap_len) {
+    // 比字段还长的字符串不会与任何值相等
+    return RC::SUCCESS;
+  }
+
+  vector<char> key(header_->key_length);
+  make_search_key(user_key, key_len, key.data());
+  const uint64_t hash       = hash_key(key.data());
+  const int      entry_size = header_->entry_size();
+
+  lock_.lock_shared();
+  DEFER(lock_.unlock_shared());
+
+  PageNum bucket = BP_INVALID_PAGE_NUM;
+  RC      rc     = find_bucket(hash, bucket);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  for (PageNum page_num = bucket; page_num != BP_INVALID_PAGE_NUM;) {
+    Frame *frame = nullptr;
+    rc           = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get bucket page. page=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    auto        bucket_header = reinterpret_cast<const ExtendibleHashBucketHeader *>(frame->data());
+    const char *entries       = frame->data() + ExtendibleHashBucketHeader::SIZE;
+    for (int i = 0; i < bucket_header->size; i++) {
+      const char *entry = entries + static_cast<size_t>(i) * entry_size;
+      if (key_equal(entry, key.data())) {
+        rids.push_back(*reinterpret_cast<const RID *>(entry + header_->key_length));
+        if (keys != nullptr) {
+          keys->insert(keys->end(), entry, entry + header_->key_length);
+        }
+      }
+    }
+
+    page_num = bucket_header->next_page;
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::insert_entry(const char *record, const RID *rid)
+{
+  if (record == nullptr || rid == nullptr) {
+    LOG_WARN("invalid arguments, record is empty or rid is empty");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  const int    entry_size = header_->entry_size();
+  vector<char> entry(entry_size);
+  make_key(record, entry.data());
+  memcpy(entry.data() + header_->key_length, rid, sizeof(*rid));
+  const uint64_t hash = hash_key(entry.data());
+  // 与SQL标准相同，唯一索引允许多个包含null的键值
+  const bool check_unique = header_->unique != 0 && !key_has_null(entry.data());
+
+  lock_guard guard(lock_);
+
+  // 桶满了并且可以分裂时，分裂之后重新查找
+  while (true) {
+    PageNum bucket = BP_INVALID_PAGE_NUM;
+    RC      rc     = find_bucket(hash, bucket);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    vector<char>    entries;
+    vector<PageNum> pages;
+    int             local_depth = 0;
+    rc                          = read_bucket(bucket, entries, pages, local_depth);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    const int entry_num = static_cast<int>(entries.size() / entry_size);
+    for (int i = 0; i < entry_num; i++) {
+      const char *existing = entries.data() + static_cast<size_t>(i) * entry_size;
+      if (!key_equal(existing, entry.data())) {
+        continue;
+      }
+      if (0 == memcmp(existing + header_->key_length, rid, sizeof(*rid))) {
+        LOG_TRACE("entry exists");
+        return RC::RECORD_DUPLICATE_KEY;
+      }
+      if (check_unique) {
+        LOG_TRACE("duplicate key in unique index");
+        return RC::RECORD_DUPLICATE_KEY;
+      }
+    }
+
+    ExtendibleHashMiniTransaction mtr(*this);
+
+    // 前面的页面都是满的，只有最后一个页面可能有空间
+    if (entry_num < static_cast<int>(pages.size()) * header_->bucket_capacity) {
+      Frame *frame = nullptr;
+      rc           = mtr.get_page(pages.back(), frame);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      const int size = reinterpret_cast<ExtendibleHashBucketHeader *>(frame->data())->size;
+      mtr.modify(frame, ExtendibleHashOperation::Type::INSERT_ENTRY, size, entry);
+      return mtr.commit();
+    }
+
+    // 只有哈希值在局部深度之上还有不同的位时，分裂才有可能把元素分开
+    bool           splittable = false;
+    const uint32_t high_mask  = depth_mask(ExtendibleHashFileHeader::MAX_GLOBAL_DEPTH) & ~depth_mask(local_depth);
+    for (int i = 0; i < entry_num && !splittable; i++) {
+      const uint64_t other = hash_key(entries.data() + static_cast<size_t>(i) * entry_size);
+      splittable           = ((static_cast<uint32_t>(other) ^ static_cast<uint32_t>(hash)) & high_mask) != 0;
+    }
+
+    if (!splittable) {
+      rc = append_overflow_page(mtr, pages.back(), local_depth, entry.data());
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      return mtr.commit();
+    }
+
+    rc = split_bucket(mtr, hash);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to split bucket. bucket=%d, rc=%s", bucket, strrc(rc));
+      return rc;
+    }
+    rc = mtr.commit();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+}
+
+RC ExtendibleHashHandler::delete_entry(const char *record, const RID *rid)
+{
+  const int    entry_size = header_->entry_size();
+  vector<char> key(header_->key_length);
+  make_key(record, key.data());
+  const uint64_t hash = hash_key(key.data());
+
+  lock_guard guard(lock_);
+
+  PageNum bucket = BP_INVALID_PAGE_NUM;
+  RC      rc     = find_bucket(hash, bucket);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  PageNum prev_page = BP_INVALID_PAGE_NUM;
+  for (PageNum page_num = bucket; page_num != BP_INVALID_PAGE_NUM;) {
+    Frame *frame = nullptr;
+    rc           = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get bucket page. page=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    auto        bucket_header = reinterpret_cast<const ExtendibleHashBucketHeader *>(frame->data());
+    const char *entries       = frame->data() + ExtendibleHashBucketHeader::SIZE;
+    const int   size          = bucket_header->size;
+    const PageNum next_page   = bucket_header->next_page;
+
+    int found = -1;
+    for (int i = 0; i < size && found < 0; i++) {
+      const char *entry = entries + static_cast<size_t>(i) * entry_size;
+      if (key_equal(entry, key.data()) && 0 == memcmp(entry + header_->key_length, rid, sizeof(*rid))) {
+        found = i;
+      }
+    }
+    disk_buffer_pool_->unpin_page(frame);
+
+    if (found >= 0) {
+      ExtendibleHashMiniTransaction mtr(*this);
+      if (size == 1 && prev_page != BP_INVALID_PAGE_NUM) {
+        // 溢出页面空了，从链表中摘掉
+        Frame *prev_frame = nullptr;
+        rc                = mtr.get_page(prev_page, prev_frame);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        mtr.modify(prev_frame, ExtendibleHashOperation::Type::SET_NEXT_PAGE, next_page, span<const char>());
+        mtr.dispose_page(page_num);
+      } else {
+        rc = mtr.get_page(page_num, frame);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        mtr.modify(frame, ExtendibleHashOperation::Type::DELETE_ENTRY, found, span<const char>());
+      }
+      return mtr.commit();
+    }
+
+    prev_page = page_num;
+    page_num  = next_page;
+  }
+
+  return RC::RECORD_NOT_EXIST;
+}
+
+RC ExtendibleHashHandler::append_overflow_page(
+    ExtendibleHashMiniTransaction &mtr, PageNum last_page, int local_depth, const char *entry)
+{
+  Frame *last_frame = nullptr;
+  Frame *new_frame  = nullptr;
+  RC     rc         = mtr.get_page(last_page, last_frame);
+  if (OB_SUCC(rc)) {
+    rc = mtr.allocate_page(new_frame);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to prepare overflow page. last page=%d, rc=%s", last_page, strrc(rc));
+    return rc;
+  }
+
+  vector<char> image = make_bucket_image(local_depth, BP_INVALID_PAGE_NUM, entry, 1, header_->entry_size());
+  mtr.modify(new_frame, ExtendibleHashOperation::Type::BUCKET_IMAGE, 0, image);
+  mtr.modify(last_frame, ExtendibleHashOperation::Type::SET_NEXT_PAGE, new_frame->page_num(), span<const char>());
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::split_bucket(ExtendibleHashMiniTransaction &mtr, uint64_t hash)
+{
+  using Type = ExtendibleHashOperation::Type;
+
+  PageNum bucket = BP_INVALID_PAGE_NUM;
+  RC      rc     = find_bucket(hash, bucket);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  vector<char>    entries;
+  vector<PageNum> old_pages;
+  int             local_depth = 0;
+  rc                          = read_bucket(bucket, entries, old_pages, local_depth);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const bool need_double = (local_depth == header_->global_depth);
+  if (need_double && header_->global_depth >= ExtendibleHashFileHeader::MAX_GLOBAL_DEPTH) {
+    LOG_WARN("extendible hash directory is too large. global depth=%d", header_->global_depth);
+    return RC::INTERNAL;
+  }
+
+  // 按照第 local_depth 位把元素分成两部分
+  const int    entry_size = header_->entry_size();
+  const int    entry_num  = static_cast<int>(entries.size() / entry_size);
+  vector<char> low_entries;
+  vector<char> high_entries;
+  for (int i = 0; i < entry_num; i++) {
+    const char *entry = entries.data() + static_cast<size_t>(i) * entry_size;
+    vector<char> &part = ((hash_key(entry) >> local_depth) & 1) ? high_entries : low_entries;
+    part.insert(part.end(), entry, entry + entry_size);
+  }
+
+  const int capacity  = header_->bucket_capacity;
+  auto      page_need = [capacity, entry_size](const vector<char> &part) {
+    const int num = static_cast<int>(part.size() / entry_size);
+    return max(1, (num + capacity - 1) / capacity);
+  };
+  const int low_page_num  = page_need(low_entries);
+  const int high_page_num = page_need(high_entries);
+
+  // 先获取所有需要的页面，再开始修改
+  ExtendibleHashFileHeader new_header = *header_;
+  vector<Frame *>          new_directory_frames;
+  if (need_double && (2 << header_->global_depth) > ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY) {
+    new_directory_frames.resize(header_->directory_page_num);
+    for (Frame *&frame : new_directory_frames) {
+      rc = mtr.allocate_page(frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to allocate directory page. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+  }
+
+  vector<Frame *> low_frames(low_page_num);
+  vector<Frame *> high_frames(high_page_num);
+  for (int i = 0; i < low_page_num; i++) {
+    rc = mtr.get_page(old_pages[i], low_frames[i]);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  for (Frame *&frame : high_frames) {
+    rc = mtr.allocate_page(frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate bucket page. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  if (need_double) {
+    rc = double_directory(mtr, new_directory_frames, new_header);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  auto write_chain = [&mtr, entry_size, capacity, local_depth](const vector<Frame *> &frames, const vector<char> &part) {
+    const int num = static_cast<int>(part.size() / entry_size);
+    for (size_t i = 0; i < frames.size(); i++) {
+      const int     start = static_cast<int>(i) * capacity;
+      const int     count = min(capacity, num - start);
+      const PageNum next  = (i + 1 < frames.size()) ? frames[i + 1]->page_num() : BP_INVALID_PAGE_NUM;
+      vector<char>  image = make_bucket_image(
+          local_depth + 1, next, part.data() + static_cast<size_t>(start) * entry_size, max(count, 0), entry_size);
+      mtr.modify(frames[i], Type::BUCKET_IMAGE, 0, image);
+    }
+  };
+  write_chain(low_frames, low_entries);
+  write_chain(high_frames, high_entries);
+
+  // 不再使用的溢出页面
+  for (size_t i = low_page_num; i < old_pages.size(); i++) {
+    mtr.dispose_page(old_pages[i]);
+  }
+
+  // 目录中属于新桶的槽位：低 local_depth 位与原来的桶相同，第 local_depth 位是1
+  ExtendibleHashDirectorySplit split;
+  split.depth               = local_depth + 1;
+  split.pattern             = (static_cast<uint32_t>(hash) & depth_mask(local_depth)) | (1U << local_depth);
+  split.bucket              = high_frames.front()->page_num();
+  const int  slot_num       = 1 << new_header.global_depth;
+  const int  page_capacity  = ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY;
+  const uint32_t stride     = 1U << split.depth;
+  for (int i = 0; i < new_header.directory_page_num; i++) {
+    const uint32_t start = static_cast<uint32_t>(i) * page_capacity;
+    split.slot_count     = min(page_capacity, slot_num - static_cast<int>(start));
+    const uint32_t first = start + ((split.pattern - start) & (stride - 1));
+    if (first >= start + split.slot_count) {
+      continue;
+    }
+
+    Frame *frame = nullptr;
+    rc           = mtr.get_page(new_header.directory_pages[i], frame);
+    if (OB_FAIL(rc)) {
+      // 前面已经修改了页面，这里只能失败。一般是缓冲池满了
+      LOG_ERROR("failed to get directory page while splitting bucket. page=%d, rc=%s",
+          new_header.directory_pages[i], strrc(rc));
+      return rc;
+    }
+    mtr.modify(frame, Type::DIRECTORY_SPLIT, static_cast<int32_t>(start),
+        span<const char>(reinterpret_cast<const char *>(&split), sizeof(split)));
+  }
+
+  if (need_double) {
+    rc = update_header(mtr, new_header);
+  }
+
+  LOG_DEBUG("split bucket. bucket=%d, new bucket=%d, local depth=%d, global depth=%d, low=%d, high=%d",
+      bucket, split.bucket, split.depth, new_header.global_depth,
+      static_cast<int>(low_entries.size() / entry_size), static_cast<int>(high_entries.size() / entry_size));
+  return rc;
+}
+
+RC ExtendibleHashHandler::double_directory(
+    ExtendibleHashMiniTransaction &mtr, const vector<Frame *> &new_pages, ExtendibleHashFileHeader &header)
+{
+  using Type = ExtendibleHashOperation::Type;
+
+  const int old_slot_num = 1 << header.global_depth;
+  if (new_pages.empty()) {
+    // 扩大之后仍然在第一个目录页面中，把前半部分复制到后半部分
+    Frame *frame = nullptr;
+    RC     rc    = mtr.get_page(header.directory_pages[0], frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    vector<char> slots(frame->data(), frame->data() + old_slot_num * sizeof(PageNum));
+    mtr.modify(frame, Type::DIRECTORY_SLOTS, old_slot_num, slots);
+  } else {
+    for (size_t i = 0; i < new_pages.size(); i++) {
+      Frame *old_frame = nullptr;
+      RC     rc        = disk_buffer_pool_->get_this_page(header.directory_pages[i], &old_frame);
+      if (OB_FAIL(rc)) {
+        LOG_ERROR("failed to get directory page. page=%d, rc=%s", header.directory_pages[i], strrc(rc));
+        return rc;
+      }
+      vector<char> slots(
+          old_frame->data(), old_frame->data() + ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY * sizeof(PageNum));
+      disk_buffer_pool_->unpin_page(old_frame);
+
+      mtr.modify(new_pages[i], Type::DIRECTORY_SLOTS, 0, slots);
+      header.directory_pages[header.directory_page_num + i] = new_pages[i]->page_num();
+    }
+    header.directory_page_num += static_cast<int32_t>(new_pages.size());
+  }
+
+  header.global_depth++;
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::update_header(ExtendibleHashMiniTransaction &mtr, const ExtendibleHashFileHeader &header)
+{
+  Frame *frame = nullptr;
+  RC     rc    = mtr.get_page(EXTENDIBLE_HASH_HEADER_PAGE, frame);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to get header page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  mtr.modify(frame,
+      ExtendibleHashOperation::Type::HEADER,
+      0,
+      span<const char>(reinterpret_cast<const char *>(&header), sizeof(header)));
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::validate()
+{
+  lock_.lock_shared();
+  DEFER(lock_.unlock_shared());
+
+  const int slot_num   = 1 << header_->global_depth;
+  const int entry_size = header_->entry_size();
+  for (int index = 0; index < slot_num; index++) {
+    PageNum bucket = BP_INVALID_PAGE_NUM;
+    RC      rc     = find_bucket(static_cast<uint64_t>(index), bucket);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    vector<char>    entries;
+    vector<PageNum> pages;
+    int             local_depth = 0;
+    rc                          = read_bucket(bucket, entries, pages, local_depth);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (local_depth > header_->global_depth) {
+      LOG_WARN("invalid local depth. bucket=%d, local depth=%d, global depth=%d", bucket, local_depth, header_->global_depth);
+      return RC::INTERNAL;
+    }
+
+    // 同一个桶的所有槽位的低 local_depth 位相同，元素的哈希值也要落在这个桶里
+    const uint32_t mask = depth_mask(local_depth);
+    for (size_t i = 0; i < entries.size() / entry_size; i++) {
+      const uint64_t hash = hash_key(entries.data() + i * entry_size);
+      if ((static_cast<uint32_t>(hash) & mask) != (static_cast<uint32_t>(index) & mask)) {
+        LOG_WARN("entry is in a wrong bucket. bucket=%d, slot=%d, hash=%lx", bucket, index, hash);
+        return RC::INTERNAL;
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class ExtendibleHashMiniTransaction
+
+ExtendibleHashMiniTransaction::ExtendibleHashMiniTransaction(ExtendibleHashHandler &handler)
+    : handler_(handler),
+      logger_(handler.log_handler(), handler.buffer_pool().id(), handler.header_->entry_size())
+{}
+
+ExtendibleHashMiniTransaction::~ExtendibleHashMiniTransaction()
+{
+  if (done_) {
+    return;
+  }
+
+  if (!logger_.empty()) {
+    commit();
+    return;
+  }
+
+  release();
+  for (PageNum page_num : allocated_pages_) {
+    handler_.buffer_pool().dispose_page(page_num);
+  }
+}
+
+RC ExtendibleHashMiniTransaction::get_page(PageNum page_num, Frame *&frame)
+{
+  for (Frame *existing : frames_) {
+    if (existing->page_num() == page_num) {
+      frame = existing;
+      return RC::SUCCESS;
+    }
+  }
+
+  RC rc = handler_.buffer_pool().get_this_page(page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get page. page=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+  frame->write_latch();
+  frames_.push_back(frame);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashMiniTransaction::allocate_page(Frame *&frame)
+{
+  RC rc = handler_.buffer_pool().allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate page. rc=%s", strrc(rc));
+    return rc;
+  }
+  frame->write_latch();
+  frames_.push_back(frame);
+  allocated_pages_.push_back(frame->page_num());
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashMiniTransaction::commit()
+{
+  done_ = true;
+
+  RC rc = logger_.commit();
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to commit extendible hash modification. rc=%s", strrc(rc));
+  }
+
+  release();
+  for (PageNum page_num : disposed_pages_) {
+    RC rc2 = handler_.buffer_pool().dispose_page(page_num);
+    if (OB_FAIL(rc2)) {
+      LOG_WARN("failed to dispose page. page=%d, rc=%s", page_num, strrc(rc2));
+    }
+  }
+  disposed_pages_.clear();
+  return rc;
+}
+
+void ExtendibleHashMiniTransaction::release()
+{
+  for (Frame *frame : frames_) {
+    frame->write_unlatch();
+    handler_.buffer_pool().unpin_page(frame);
+  }
+  frames_.clear();
+}
@@ -0,0 +1,241 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/list.h"
+#include "common/lang/mutex.h"
+#include "common/lang/span.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/buffer/page.h"
+#include "storage/index/extendible_hash_log.h"
+#include "storage/record/record.h"
+
+class FieldMeta;
+class LogHandler;
+class BufferPoolManager;
+class DiskBufferPool;
+class Frame;
+class ExtendibleHashMiniTransaction;
+
+/**
+ * @brief 可扩展哈希
+ * @defgroup ExtendibleHash
+ * @details 目录中有 2^global_depth 个槽位，使用键值哈希值的低 global_depth 位找到槽位，槽位中记录了桶的页面编号。
+ * 每个桶有自己的局部深度 local_depth，有 2^(global_depth-local_depth) 个槽位指向同一个桶。
+ * 桶满了之后分裂成两个局部深度加一的桶，局部深度等于全局深度时先把目录扩大一倍。
+ * 哈希值完全相同的元素(比如非唯一索引中的重复键值)无法通过分裂分开，这时在桶后面链接溢出页面。
+ * 一次查找只需要访问目录页面和桶页面(以及很少出现的溢出页面)，与数据量无关。
+ */
+
+/**
+ * @brief 可扩展哈希的文件头，是文件的第一个页面
+ * @ingroup ExtendibleHash
+ * @details 目录可能很大，存放在单独的目录页面中，每个目录页面存放 DIRECTORY_PAGE_CAPACITY 个槽位。
+ */
+struct ExtendibleHashFileHeader
+{
+  static constexpr int MAX_ATTR_NUM            = 16;
+  static constexpr int MAX_GLOBAL_DEPTH        = 16;
+  static constexpr int DIRECTORY_PAGE_CAPACITY = 1024;
+  static constexpr int MAX_DIRECTORY_PAGES     = (1 << MAX_GLOBAL_DEPTH) / DIRECTORY_PAGE_CAPACITY;
+
+  int32_t  attr_num;
+  int32_t  attr_length[MAX_ATTR_NUM];
+  int32_t  attr_offset[MAX_ATTR_NUM];
+  int32_t  field_id[MAX_ATTR_NUM];
+  AttrType attr_type[MAX_ATTR_NUM];
+  int32_t  key_length;                              ///< 所有属性的长度之和，不包含RID
+  int32_t  unique;                                  ///< 是否唯一索引
+  int32_t  bucket_capacity;                         ///< 一个桶页面最多存放的元素个数
+  int32_t  global_depth;                            ///< 目录的全局深度
+  int32_t  directory_page_num;                      ///< 目录页面的个数
+  PageNum  directory_pages[MAX_DIRECTORY_PAGES];    ///< 目录页面的编号
+
+  /// 元素的大小，即键值和RID
+  int32_t entry_size() const { return key_length + static_cast<int32_t>(sizeof(RID)); }
+
+  string to_string() const;
+};
+
+static_assert(sizeof(ExtendibleHashFileHeader) <= BP_PAGE_DATA_SIZE, "extendible hash file header is too large");
+
+/**
+ * @brief 桶页面(包括溢出页面)的头
+ * @ingroup ExtendibleHash
+ * @details 后面紧跟着 size 个元素，每个元素是键值加上RID，元素之间没有顺序
+ */
+struct ExtendibleHashBucketHeader
+{
+  int32_t local_depth;  ///< 局部深度，溢出页面与所属的桶相同
+  int32_t size;         ///< 当前页面上的元素个数
+  PageNum next_page;    ///< 下一个溢出页面，没有时是 BP_INVALID_PAGE_NUM
+
+  static constexpr int SIZE = 12;
+
+  static int capacity(int entry_size) { return (BP_PAGE_DATA_SIZE - SIZE) / entry_size; }
+};
+
+static_assert(sizeof(ExtendibleHashBucketHeader) == ExtendibleHashBucketHeader::SIZE, "invalid bucket header size");
+
+/**
+ * @brief 可扩展哈希
+ * @ingroup ExtendibleHash
+ * @details 键值的格式与B+树相同：多个字段时第一个字段是记录的null位图，后面依次是各个字段的值。
+ * 计算哈希值和比较键值时，只看索引字段自己的null位以及字段的值，不看其它字段的null位。
+ * 字符串只比较到第一个'\0'为止，与B+树的比较方式相同。
+ * 浮点数按照误差比较，相等的值可能有不同的哈希值，所以不支持浮点数字段。
+ *
+ * 并发控制比较简单：查找加读锁，插入和删除加写锁。
+ * 删除元素时不合并桶也不缩小目录，只回收空的溢出页面。
+ */
+class ExtendibleHashHandler
+{
+public:
+  ExtendibleHashHandler() = default;
+  ~ExtendibleHashHandler();
+
+  /**
+   * @brief 创建一个新的哈希索引文件
+   * @param unique 是否唯一索引。唯一索引中相同的键值只能对应一个RID，包含null的键值除外
+   * @param field_ids 每个字段在表中的编号，用于查询null位图
+   * @param fields 索引的字段。多个字段时第一个是记录的null位图
+   */
+  RC create(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name, bool unique,
+      const vector<int> &field_ids, const vector<const FieldMeta *> &fields);
+  RC open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name);
+  RC close();
+
+  /**
+   * @brief 插入一条数据
+   * @param record 完整的记录，从中取出索引字段组成键值
+   */
+  RC insert_entry(const char *record, const RID *rid);
+  RC delete_entry(const char *record, const RID *rid);
+
+  /**
+   * @brief 查找键值对应的所有数据
+   * @param user_key 所有参与比较的字段的值，按照字段长度依次存放，不包含null位图。
+   * 最后一个字符串字段可以比字段短，参考 IndexScanPhysicalOperator::make_key
+   * @param key_len user_key 的长度
+   * @param[out] keys 不为空时，返回每条数据在索引中的完整键值
+   */
+  RC get_entries(const char *user_key, int key_len, list<RID> &rids, vector<char> *keys = nullptr);
+
+  RC sync();
+
+  /// 检查目录和桶的结构，测试使用
+  RC validate();
+
+  /// 参与比较的字段个数，不包含null位图
+  int key_attr_num() const { return header_->attr_num > 1 ? header_->attr_num - 1 : header_->attr_num; }
+  int key_length() const { return header_->key_length; }
+  int global_depth() const { return header_->global_depth; }
+  bool unique() const { return header_->unique != 0; }
+
+  DiskBufferPool &buffer_pool() const { return *disk_buffer_pool_; }
+  LogHandler     &log_handler() const { return *log_handler_; }
+
+  friend class ExtendibleHashMiniTransaction;
+
+private:
+  /// 使用记录中的索引字段构造键值
+  void make_key(const char *record, char *key) const;
+  /// 使用用户提供的字段值构造键值，所有字段都不是null
+  void make_search_key(const char *user_key, int key_len, char *key) const;
+
+  uint64_t hash_key(const char *key) const;
+  bool     key_equal(const char *key1, const char *key2) const;
+  /// 键值中是否有null字段
+  bool     key_has_null(const char *key) const;
+
+  /// 哈希值对应的桶
+  RC find_bucket(uint64_t hash, PageNum &bucket) const;
+
+  /**
+   * @brief 读取一个桶以及所有溢出页面中的元素
+   * @param[out] pages 桶以及溢出页面的编号，按照链接的顺序
+   */
+  RC read_bucket(PageNum bucket, vector<char> &entries, vector<PageNum> &pages, int &local_depth) const;
+
+  /**
+   * @brief 分裂哈希值所在的桶
+   * @details 收集桶以及溢出页面中的所有元素，按照哈希值的第 local_depth 位分到旧桶和新桶中。
+   * 局部深度等于全局深度时先把目录扩大一倍
+   */
+  RC split_bucket(ExtendibleHashMiniTransaction &mtr, uint64_t hash);
+
+  /**
+   * @brief 把目录扩大一倍，新增的槽位与对应的旧槽位指向相同的桶
+   * @param new_pages 新增的目录页面，目录只有一个页面并且扩大之后仍然放得下时为空
+   * @param[in,out] header 修改后的文件头
+   */
+  RC double_directory(ExtendibleHashMiniTransaction &mtr, const vector<Frame *> &new_pages, ExtendibleHashFileHeader &header);
+
+  /// 修改文件头页面
+  RC update_header(ExtendibleHashMiniTransaction &mtr, const ExtendibleHashFileHeader &header);
+
+  /// 分配一个溢出页面链接到 last_page 后面，并放入一个元素
+  RC append_overflow_page(ExtendibleHashMiniTransaction &mtr, PageNum last_page, int local_depth, const char *entry);
+
+private:
+  LogHandler     *log_handler_      = nullptr;
+  DiskBufferPool *disk_buffer_pool_ = nullptr;
+
+  /// 文件头页面一直固定在缓冲池中，header_ 直接指向页面的数据，重做日志修改了文件头后也不需要重新加载
+  Frame                    *header_frame_ = nullptr;
+  ExtendibleHashFileHeader *header_       = nullptr;
+  common::SharedMutex       lock_;
+};
+
+/**
+ * @brief 可扩展哈希修改操作使用的事务辅助类
+ * @ingroup ExtendibleHash
+ * @details 修改的页面加写锁，提交时写入日志、设置LSN后再释放。
+ * 需要分配的页面都在修改之前分配，中途失败时不需要回滚。
+ * 释放页面会马上记录缓冲池日志，所以要等提交之后才真正释放。
+ */
+class ExtendibleHashMiniTransaction final
+{
+public:
+  ExtendibleHashMiniTransaction(ExtendibleHashHandler &handler);
+  ~ExtendibleHashMiniTransaction();
+
+  /// 获取一个需要修改的页面，同一个页面只会加一次锁
+  RC get_page(PageNum page_num, Frame *&frame);
+  RC allocate_page(Frame *&frame);
+  /// 提交之后再释放页面
+  void dispose_page(PageNum page_num) { disposed_pages_.push_back(page_num); }
+
+  void modify(Frame *frame, ExtendibleHashOperation::Type type, int32_t slot, span<const char> data)
+  {
+    logger_.modify(frame, type, slot, data);
+  }
+
+  /**
+   * @brief 写入日志并释放所有页面
+   * @details 没有提交就析构时，如果已经修改了页面仍然会提交，否则释放分配的页面
+   */
+  RC commit();
+
+private:
+  void release();
+
+private:
+  ExtendibleHashHandler &handler_;
+  ExtendibleHashLogger   logger_;
+  vector<Frame *>        frames_;           ///< 加了写锁的页面
+  vector<PageNum>        allocated_pages_;  ///< 新分配的页面，没有修改任何页面就结束时释放
+  vector<PageNum>        disposed_pages_;
+  bool                   done_ = false;
+};
@@ -0,0 +1,296 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/extendible_hash_log.h"
+#include "common/log/log.h"
+#include "common/lang/sstream.h"
+#include "common/lang/unordered_map.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/frame.h"
+#include "storage/clog/log_entry.h"
+#include "storage/clog/log_handler.h"
+#include "storage/index/extendible_hash.h"
+
+using namespace common;
+
+namespace {
+
+/**
+ * @brief 日志中一个页面修改操作的头，后面跟着 data_len 字节的数据
+ */
+struct ItemHeader
+{
+  int32_t operation_type;
+  PageNum page_num;
+  int32_t slot;
+  int32_t data_len;
+};
+
+RC read_item(Deserializer &buffer, ItemHeader &item, vector<char> &data)
+{
+  if (buffer.read(reinterpret_cast<char *>(&item), sizeof(item)) != 0 || item.data_len < 0 ||
+      item.data_len > buffer.remain()) {
+    return RC::LOG_ENTRY_INVALID;
+  }
+  data.resize(item.data_len);
+  if (item.data_len > 0 && buffer.read(data.data(), item.data_len) != 0) {
+    return RC::LOG_ENTRY_INVALID;
+  }
+  return RC::SUCCESS;
+}
+
+}  // namespace
+
+string ExtendibleHashOperation::to_string() const
+{
+  string ret = std::to_string(type_id()) + ":";
+  switch (type_) {
+    case Type::HEADER: return ret + "HEADER";
+    case Type::BUCKET_IMAGE: return ret + "BUCKET_IMAGE";
+    case Type::INSERT_ENTRY: return ret + "INSERT_ENTRY";
+    case Type::DELETE_ENTRY: return ret + "DELETE_ENTRY";
+    case Type::SET_NEXT_PAGE: return ret + "SET_NEXT_PAGE";
+    case Type::DIRECTORY_SLOTS: return ret + "DIRECTORY_SLOTS";
+    case Type::DIRECTORY_SPLIT: return ret + "DIRECTORY_SPLIT";
+    default: return ret + "UNKNOWN";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class ExtendibleHashLogger
+
+ExtendibleHashLogger::ExtendibleHashLogger(LogHandler &log_handler, int32_t buffer_pool_id, int32_t entry_size)
+    : log_handler_(log_handler), buffer_pool_id_(buffer_pool_id), entry_size_(entry_size)
+{}
+
+void ExtendibleHashLogger::modify(Frame *frame, ExtendibleHashOperation::Type type, int32_t slot, span<const char> data)
+{
+  RC rc = apply(frame->data(), entry_size_, type, slot, data);
+  ASSERT(OB_SUCC(rc), "failed to modify extendible hash page. page=%d, operation=%s, rc=%s",
+      frame->page_num(), ExtendibleHashOperation(type).to_string().c_str(), strrc(rc));
+  frame->mark_dirty();
+
+  if (buffer_.size() == 0) {
+    buffer_.write_int32(buffer_pool_id_);
+    buffer_.write_int32(entry_size_);
+  }
+
+  ItemHeader item;
+  item.operation_type = ExtendibleHashOperation(type).type_id();
+  item.page_num       = frame->page_num();
+  item.slot           = slot;
+  item.data_len       = static_cast<int32_t>(data.size());
+  buffer_.write(reinterpret_cast<const char *>(&item), sizeof(item));
+  buffer_.write(data);
+
+  frames_.push_back(frame);
+}
+
+RC ExtendibleHashLogger::commit()
+{
+  if (frames_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  LSN lsn = 0;
+  RC  rc  = log_handler_.append(lsn, LogModule::Id::HASH_INDEX, std::move(buffer_.data()));
+  buffer_.data().clear();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to append extendible hash log entry. rc=%s", strrc(rc));
+    frames_.clear();
+    return rc;
+  }
+
+  for (Frame *frame : frames_) {
+    frame->set_lsn(lsn);
+  }
+  frames_.clear();
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashLogger::apply(
+    char *page_data, int32_t entry_size, ExtendibleHashOperation::Type type, int32_t slot, span<const char> data)
+{
+  using Type = ExtendibleHashOperation::Type;
+
+  auto bucket  = reinterpret_cast<ExtendibleHashBucketHeader *>(page_data);
+  char *entries = page_data + ExtendibleHashBucketHeader::SIZE;
+  switch (type) {
+    case Type::HEADER:
+    case Type::BUCKET_IMAGE: {
+      if (data.size() > static_cast<size_t>(BP_PAGE_DATA_SIZE)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      memcpy(page_data, data.data(), data.size());
+    } break;
+
+    case Type::INSERT_ENTRY: {
+      if (slot != bucket->size || static_cast<int>(data.size()) != entry_size ||
+          slot >= ExtendibleHashBucketHeader::capacity(entry_size)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      memcpy(entries + static_cast<size_t>(slot) * entry_size, data.data(), entry_size);
+      bucket->size++;
+    } break;
+
+    case Type::DELETE_ENTRY: {
+      if (slot < 0 || slot >= bucket->size) {
+        return RC::INVALID_ARGUMENT;
+      }
+      const int last = bucket->size - 1;
+      if (slot != last) {
+        memcpy(entries + static_cast<size_t>(slot) * entry_size, entries + static_cast<size_t>(last) * entry_size,
+            entry_size);
+      }
+      bucket->size--;
+    } break;
+
+    case Type::SET_NEXT_PAGE: {
+      bucket->next_page = slot;
+    } break;
+
+    case Type::DIRECTORY_SLOTS: {
+      const int count = static_cast<int>(data.size() / sizeof(PageNum));
+      if (slot < 0 || slot + count > ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY) {
+        return RC::INVALID_ARGUMENT;
+      }
+      memcpy(page_data + static_cast<size_t>(slot) * sizeof(PageNum), data.data(), count * sizeof(PageNum));
+    } break;
+
+    case Type::DIRECTORY_SPLIT: {
+      ExtendibleHashDirectorySplit split;
+      if (data.size() != sizeof(split)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      memcpy(&split, data.data(), sizeof(split));
+      if (split.slot_count < 0 || split.slot_count > ExtendibleHashFileHeader::DIRECTORY_PAGE_CAPACITY) {
+        return RC::INVALID_ARGUMENT;
+      }
+
+      auto           slots = reinterpret_cast<PageNum *>(page_data);
+      const uint32_t mask  = (1U << split.depth) - 1;
+      for (int i = 0; i < split.slot_count; i++) {
+        if ((static_cast<uint32_t>(slot + i) & mask) == split.pattern) {
+          slots[i] = split.bucket;
+        }
+      }
+    } break;
+
+    default: {
+      LOG_WARN("unknown extendible hash operation. type=%d", static_cast<int>(type));
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashLogger::redo(BufferPoolManager &bpm, const LogEntry &entry)
+{
+  ASSERT(entry.module().id() == LogModule::Id::HASH_INDEX, "invalid log entry: %s", entry.to_string().c_str());
+
+  Deserializer buffer(entry.data(), entry.payload_size());
+  int32_t      buffer_pool_id = -1;
+  int32_t      entry_size     = 0;
+  if (buffer.read_int32(buffer_pool_id) != 0 || buffer.read_int32(entry_size) != 0) {
+    LOG_ERROR("failed to read extendible hash log header. entry=%s", entry.to_string().c_str());
+    return RC::LOG_ENTRY_INVALID;
+  }
+
+  DiskBufferPool *buffer_pool = nullptr;
+  RC              rc          = bpm.get_buffer_pool(buffer_pool_id, buffer_pool);
+  if (OB_FAIL(rc) || buffer_pool == nullptr) {
+    LOG_WARN("failed to get buffer pool. rc=%s, buffer_pool_id=%d", strrc(rc), buffer_pool_id);
+    return rc;
+  }
+
+  // 一个页面可能有多个修改，先根据页面原来的LSN决定是否需要重做，全部重做完成后再设置LSN
+  unordered_map<PageNum, Frame *> frames;
+  vector<Frame *>                 redo_frames;
+
+  ItemHeader   item;
+  vector<char> data;
+  while (OB_SUCC(rc) && buffer.remain() > 0) {
+    rc = read_item(buffer, item, data);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to read extendible hash log item. entry=%s", entry.to_string().c_str());
+      break;
+    }
+
+    Frame *frame = nullptr;
+    auto   iter  = frames.find(item.page_num);
+    if (iter == frames.end()) {
+      rc = buffer_pool->get_this_page(item.page_num, &frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get page. page num=%d, rc=%s", item.page_num, strrc(rc));
+        break;
+      }
+      if (frame->lsn() >= entry.lsn()) {
+        LOG_TRACE("no need to redo. page=%d, frame lsn=%ld, redo lsn=%ld", item.page_num, frame->lsn(), entry.lsn());
+        buffer_pool->unpin_page(frame);
+        frame = nullptr;
+      } else {
+        redo_frames.push_back(frame);
+      }
+      frames.emplace(item.page_num, frame);
+    } else {
+      frame = iter->second;
+    }
+
+    if (frame == nullptr) {
+      continue;
+    }
+
+    rc = apply(frame->data(), entry_size, ExtendibleHashOperation(item.operation_type).type(), item.slot, data);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to redo extendible hash log item. page=%d, operation=%s, rc=%s",
+          item.page_num, ExtendibleHashOperation(item.operation_type).to_string().c_str(), strrc(rc));
+    }
+  }
+
+  for (Frame *frame : redo_frames) {
+    if (OB_SUCC(rc)) {
+      frame->set_lsn(entry.lsn());
+      frame->mark_dirty();
+    }
+    buffer_pool->unpin_page(frame);
+  }
+  return rc;
+}
+
+string ExtendibleHashLogger::log_entry_to_string(const LogEntry &entry)
+{
+  stringstream ss;
+  Deserializer buffer(entry.data(), entry.payload_size());
+  int32_t      buffer_pool_id = -1;
+  int32_t      entry_size     = 0;
+  if (buffer.read_int32(buffer_pool_id) != 0 || buffer.read_int32(entry_size) != 0) {
+    return ss.str();
+  }
+
+  ss << "buffer_pool_id:" << buffer_pool_id << ", entry_size:" << entry_size;
+
+  ItemHeader   item;
+  vector<char> data;
+  while (buffer.remain() > 0 && OB_SUCC(read_item(buffer, item, data))) {
+    ss << ", {" << ExtendibleHashOperation(item.operation_type).to_string() << ", page:" << item.page_num
+       << ", slot:" << item.slot << ", data_len:" << item.data_len << "}";
+  }
+  return ss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class ExtendibleHashLogReplayer
+
+ExtendibleHashLogReplayer::ExtendibleHashLogReplayer(BufferPoolManager &bpm) : buffer_pool_manager_(bpm) {}
+
+RC ExtendibleHashLogReplayer::replay(const LogEntry &entry)
+{
+  return ExtendibleHashLogger::redo(buffer_pool_manager_, entry);
+}
@@ -0,0 +1,142 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "common/lang/serializer.h"
+#include "common/lang/span.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/buffer/page.h"
+#include "storage/clog/log_replayer.h"
+
+class LogEntry;
+class LogHandler;
+class Frame;
+class DiskBufferPool;
+class BufferPoolManager;
+
+/**
+ * @brief 可扩展哈希索引的页面修改操作
+ * @ingroup CLog
+ * @details 与B+树的逻辑日志不同，这里的操作都只修改一个页面，并且不依赖其它页面的内容，
+ * 重做时不需要打开哈希索引，直接修改页面即可。
+ */
+class ExtendibleHashOperation
+{
+public:
+  enum class Type : int32_t
+  {
+    HEADER,           ///< 修改文件头页。数据是文件头的内容
+    BUCKET_IMAGE,     ///< 重新设置整个桶页面。数据是桶页面的头和所有元素，初始化和分裂时使用
+    INSERT_ENTRY,     ///< 在桶的末尾追加一个元素。slot 是追加的位置
+    DELETE_ENTRY,     ///< 删除桶中的一个元素，最后一个元素移动到删除的位置。slot 是删除的位置
+    SET_NEXT_PAGE,    ///< 修改桶的溢出页面编号。slot 是新的页面编号
+    DIRECTORY_SLOTS,  ///< 修改目录页面中连续的几个槽位。slot 是页面内的起始位置，数据是桶的页面编号
+    DIRECTORY_SPLIT,  ///< 桶分裂后把目录页面中属于新桶的槽位指向新桶。slot 是页面第一个槽位的全局下标
+  };
+
+public:
+  explicit ExtendibleHashOperation(Type type) : type_(type) {}
+  explicit ExtendibleHashOperation(int32_t type) : type_(static_cast<Type>(type)) {}
+
+  Type    type() const { return type_; }
+  int32_t type_id() const { return static_cast<int32_t>(type_); }
+
+  string to_string() const;
+
+private:
+  Type type_;
+};
+
+/**
+ * @brief DIRECTORY_SPLIT 操作的数据
+ * @details 全局下标的低 depth 位等于 pattern 的槽位指向 bucket
+ */
+struct ExtendibleHashDirectorySplit
+{
+  int32_t  depth;       ///< 分裂后桶的局部深度
+  uint32_t pattern;     ///< 新桶的哈希值的低 depth 位
+  PageNum  bucket;      ///< 新桶的页面编号
+  int32_t  slot_count;  ///< 页面中有效的槽位个数，目录只有一个页面时可能不满
+};
+
+/**
+ * @brief 可扩展哈希索引的日志记录器
+ * @ingroup CLog
+ * @details 一次插入或删除可能修改多个页面，比如桶分裂时要修改旧桶、新桶、目录和文件头。
+ * 这些修改先记录在内存中，提交时作为一条日志写入，重做时要么全部重做，要么全部不做，
+ * 不会出现目录指向了新桶，新桶的数据却没有恢复的情况。
+ * 所有修改都通过 modify 完成：先修改页面，再记录日志，正常执行和重做使用的是同一份代码。
+ */
+class ExtendibleHashLogger final
+{
+public:
+  /**
+   * @param entry_size 桶中一个元素的大小，即键值加上RID的长度，删除元素时使用
+   */
+  ExtendibleHashLogger(LogHandler &log_handler, int32_t buffer_pool_id, int32_t entry_size);
+  ~ExtendibleHashLogger() = default;
+
+  /**
+   * @brief 修改页面并记录日志
+   * @details 调用者需要持有页面的写锁
+   */
+  void modify(Frame *frame, ExtendibleHashOperation::Type type, int32_t slot, span<const char> data);
+
+  bool empty() const { return frames_.empty(); }
+
+  /**
+   * @brief 把记录的所有修改作为一条日志写入，并设置修改过的页面的LSN
+   */
+  RC commit();
+
+  /**
+   * @brief 执行一个页面修改操作
+   * @param page_data 页面的数据，参考 Frame::data
+   */
+  static RC apply(char *page_data, int32_t entry_size, ExtendibleHashOperation::Type type, int32_t slot,
+      span<const char> data);
+
+  /**
+   * @brief 重做一条日志
+   * @details 页面的LSN不小于日志的LSN时，说明这条日志的修改已经在页面上了，跳过这个页面
+   */
+  static RC redo(BufferPoolManager &bpm, const LogEntry &entry);
+
+  static string log_entry_to_string(const LogEntry &entry);
+
+private:
+  LogHandler &log_handler_;
+  int32_t     buffer_pool_id_ = -1;
+  int32_t     entry_size_     = 0;
+
+  common::Serializer buffer_;  ///< 已经记录的修改
+  vector<Frame *>    frames_;  ///< 修改过的页面，可能有重复
+};
+
+/**
+ * @brief 可扩展哈希索引的日志重做器
+ * @ingroup CLog
+ */
+class ExtendibleHashLogReplayer final : public LogReplayer
+{
+public:
+  ExtendibleHashLogReplayer(BufferPoolManager &bpm);
+  virtual ~ExtendibleHashLogReplayer() = default;
+
+  /// @copydoc LogReplayer::replay
+  RC replay(const LogEntry &entry) override;
+
+private:
+  BufferPoolManager &buffer_pool_manager_;
+};
@@ -0,0 +1,163 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/hash_index.h"
+#include "common/log/log.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+HashIndex::~HashIndex() noexcept { close(); }
+
+RC HashIndex::create(Table *table, const char *file_name, const bool unique, const IndexMeta &index_meta,
+    const std::vector<int> &field_ids, const std::vector<const FieldMeta *> &field_metas)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_metas);
+
+  BufferPoolManager &bpm = table->db()->buffer_pool_manager();
+  RC rc = index_handler_.create(table->db()->log_handler(), bpm, file_name, unique, field_ids, field_metas);
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to create hash index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  table_  = table;
+  LOG_INFO("Successfully create hash index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::open(Table *table, const char *file_name, const IndexMeta &index_meta,
+    const std::vector<const FieldMeta *> &field_metas)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_metas);
+
+  BufferPoolManager &bpm = table->db()->buffer_pool_manager();
+  RC rc = index_handler_.open(table->db()->log_handler(), bpm, file_name);
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to open hash index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  table_  = table;
+  LOG_INFO("Successfully open hash index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close hash index, index:%s, field:%s", index_meta_.name(), index_meta_.field());
+    index_handler_.close();
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::insert_entry(const char *record, const RID *rid) { return index_handler_.insert_entry(record, rid); }
+
+RC HashIndex::delete_entry(const char *record, const RID *rid) { return index_handler_.delete_entry(record, rid); }
+
+IndexScanner *HashIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive,
+    const char *right_key, int right_len, bool right_inclusive, int left_attr_num, int right_attr_num)
+{
+  const int attr_num = index_handler_.key_attr_num();
+  if (left_key == nullptr || right_key == nullptr || !left_inclusive || !right_inclusive ||
+      left_attr_num != attr_num || right_attr_num != attr_num || left_len != right_len ||
+      0 != memcmp(left_key, right_key, left_len)) {
+    LOG_WARN("hash index only supports equality lookup on all fields. index=%s", index_meta_.name());
+    return nullptr;
+  }
+
+  HashIndexScanner *index_scanner = new HashIndexScanner(index_handler_);
+  RC rc = index_scanner->open(left_key, left_len);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open hash index scanner. rc=%d:%s", rc, strrc(rc));
+    delete index_scanner;
+    return nullptr;
+  }
+  return index_scanner;
+}
+
+RC HashIndex::get_entries(const std::vector<const char *> &keys, const std::vector<int> &key_lens,
+    std::vector<std::list<RID>> &rids, int attr_num)
+{
+  if (attr_num != index_handler_.key_attr_num()) {
+    return RC::UNIMPLENMENT;
+  }
+
+  rids.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    RC rc = index_handler_.get_entries(keys[i], key_lens[i], rids[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get entries from hash index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::sync() { return index_handler_.sync(); }
+
+////////////////////////////////////////////////////////////////////////////////
+HashIndexScanner::HashIndexScanner(ExtendibleHashHandler &hash_handler) : hash_handler_(hash_handler) {}
+
+RC HashIndexScanner::open(const char *key, int key_len)
+{
+  std::list<RID> rids;
+  RC rc = hash_handler_.get_entries(key, key_len, rids, &keys_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  rids_.assign(rids.begin(), rids.end());
+  return RC::SUCCESS;
+}
+
+RC HashIndexScanner::next_entry(RID *rid)
+{
+  if (pos_ >= rids_.size()) {
+    return RC::RECORD_EOF;
+  }
+  *rid = rids_[pos_++];
+  return RC::SUCCESS;
+}
+
+RC HashIndexScanner::next_batch_with_keys(RID *rids, char *keys, int capacity, int &count)
+{
+  const size_t key_length = hash_handler_.key_length();
+  count                   = 0;
+  for (; count < capacity && pos_ < rids_.size(); count++, pos_++) {
+    rids[count] = rids_[pos_];
+    memcpy(keys + count * key_length, keys_.data() + pos_ * key_length, key_length);
+  }
+  return count > 0 ? RC::SUCCESS : RC::RECORD_EOF;
+}
+
+RC HashIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
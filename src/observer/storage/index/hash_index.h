@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "storage/index/extendible_hash.h"
+#include "storage/index/index.h"
+
+/**
+ * @brief 哈希索引
+ * @ingroup Index
+ * @details 底层是可扩展哈希，只支持所有索引字段都是等值条件的查找，不支持范围查找。
+ */
+class HashIndex : public Index
+{
+public:
+  HashIndex() = default;
+  virtual ~HashIndex() noexcept;
+
+  RC create(Table *table, const char *file_name, const bool unique, const IndexMeta &index_meta,
+      const std::vector<int> &field_ids, const std::vector<const FieldMeta *> &field_metas);
+  RC open(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &field_metas);
+  RC close();
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  /**
+   * @brief 只支持左右边界相同、都包含边界并且指定了所有字段的扫描，即等值查找
+   * @details 其它情况返回空指针
+   */
+  IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+      int right_len, bool right_inclusive, int left_attr_num = 1, int right_attr_num = 1) override;
+
+  RC get_entries(const std::vector<const char *> &keys, const std::vector<int> &key_lens,
+      std::vector<std::list<RID>> &rids, int attr_num = 1) override;
+
+  RC sync() override;
+
+  ExtendibleHashHandler &hash_handler() { return index_handler_; }
+
+private:
+  bool                  inited_ = false;
+  Table                *table_  = nullptr;
+  ExtendibleHashHandler index_handler_;
+};
+
+/**
+ * @brief 哈希索引扫描器
+ * @ingroup Index
+ * @details 打开时就取出所有匹配的数据，一个键值对应的数据通常很少
+ */
+class HashIndexScanner : public IndexScanner
+{
+public:
+  HashIndexScanner(ExtendibleHashHandler &hash_handler);
+  ~HashIndexScanner() noexcept override = default;
+
+  RC next_entry(RID *rid) override;
+  RC next_batch_with_keys(RID *rids, char *keys, int capacity, int &count) override;
+  RC destroy() override;
+
+  RC open(const char *key, int key_len);
+
+private:
+  ExtendibleHashHandler &hash_handler_;
+  std::vector<RID>       rids_;
+  std::vector<char>      keys_;
+  size_t                 pos_ = 0;
+};
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <stddef.h>
+#include <list>
 #include <vector>
 
 #include "common/rc.h"
@@ -42,6 +43,23 @@ public:
 
   const IndexMeta &index_meta() const { return index_meta_; }
 
+  /**
+   * @brief 索引包含的字段。多字段索引的第一个字段是记录的null位图，不是用户指定的字段
+   */
+  const std::vector<FieldMeta> &field_metas() const { return field_metas_; }
+
+  /**
+   * @brief 键值的长度，即所有索引字段长度之和，不包含RID
+   */
+  int key_length() const
+  {
+    int length = 0;
+    for (const FieldMeta &field_meta : field_metas_) {
+      length += field_meta.len();
+    }
+    return length;
+  }
+
   /**
    * @brief 插入一条数据
    *
@@ -67,9 +85,26 @@ public:
    * @param right_key 要扫描的右边界
    * @param right_len 右边界的长度
    * @param right_inclusive 是否包含右边界
+   * @param left_attr_num 左边界包含的字段个数。多字段索引可以只指定前几个字段，按照字段长度依次存放，
+   * left_len 是最后一个字段的长度
+   * @param right_attr_num 右边界包含的字段个数
    */
   virtual IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
-      int right_len, bool right_inclusive) = 0;
+      int right_len, bool right_inclusive, int left_attr_num = 1, int right_attr_num = 1) = 0;
+
+  /**
+   * @brief 批量等值查找
+   * @details 键值按照索引的顺序递增排列时，相邻的键值可以共用从根节点下降的路径
+   * @param keys 要查找的键值
+   * @param key_lens 每个键值的长度
+   * @param[out] rids 与 keys 一一对应，每个键值对应的所有记录
+   * @param attr_num 每个键值包含的字段个数，与 create_scanner 相同
+   */
+  virtual RC get_entries(const std::vector<const char *> &keys, const std::vector<int> &key_lens,
+      std::vector<std::list<RID>> &rids, int attr_num = 1)
+  {
+    return RC::UNIMPLENMENT;
+  }
 
   /**
    * @brief 同步索引数据到磁盘
@@ -77,6 +112,11 @@ public:
    */
   virtual RC sync() = 0;
 
+  /**
+   * @brief 日志重做完成后调用，用来刷新索引缓存在内存中的元数据
+   */
+  virtual RC on_redo_done() { return RC::SUCCESS; }
+
 protected:
   RC init(const IndexMeta &index_meta, const std::vector<const FieldMeta*> &field_metas);
 
@@ -100,5 +140,30 @@ public:
    * 如果没有更多的元素，返回RECORD_EOF
    */
   virtual RC next_entry(RID *rid) = 0;
-  virtual RC destroy()            = 0;
+
+  /**
+   * @brief 批量遍历元素数据，最多返回 capacity 条
+   * @details 如果没有更多的元素，返回RECORD_EOF，此时 count 是0
+   */
+  virtual RC next_batch(RID *rids, int capacity, int &count)
+  {
+    RC rc = RC::SUCCESS;
+    for (count = 0; count < capacity; count++) {
+      rc = next_entry(&rids[count]);
+      if (OB_FAIL(rc)) {
+        break;
+      }
+    }
+    return (rc == RC::RECORD_EOF && count > 0) ? RC::SUCCESS : rc;
+  }
+
+  /**
+   * @brief 与 next_batch 相同，同时返回每条数据的键值
+   * @details 键值是索引字段的值按照 Index::field_metas 的顺序依次存放，长度是 Index::key_length。
+   * 可以直接用这些值构造记录中对应的字段，不需要再读取记录
+   * @param[out] keys 内存大小至少是 capacity * Index::key_length
+   */
+  virtual RC next_batch_with_keys(RID *rids, char *keys, int capacity, int &count) { return RC::UNIMPLENMENT; }
+
+  virtual RC destroy() = 0;
 };
@@ -23,8 +23,17 @@ const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELD_NAME("field_name");
 const static Json::StaticString FIELD_UNIQUE("unique");
 const static Json::StaticString FIELD_FIELD_NUM("field_num");
+const static Json::StaticString FIELD_TYPE("type");
 
-RC IndexMeta::init(const char *name, bool unique, const std::vector<const FieldMeta*> &fields)
+static const char *index_type_name(IndexType type)
+{
+  switch (type) {
+    case IndexType::HASH: return "hash";
+    default: return "btree";
+  }
+}
+
+RC IndexMeta::init(const char *name, bool unique, const std::vector<const FieldMeta*> &fields, IndexType type)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Failed to init index, name is empty.");
@@ -33,6 +42,7 @@ RC IndexMeta::init(const char *name, bool unique, const std::vector<const FieldM
 
   name_ = name;
   unique_ = unique;
+  type_   = type;
   for (const FieldMeta *field : fields) {
     field_.emplace_back(field->name());
   }
@@ -43,6 +53,7 @@ void IndexMeta::to_json(Json::Value &json_value) const
 {
   json_value[FIELD_NAME] = name_;
   json_value[FIELD_UNIQUE] = unique_;
+  json_value[FIELD_TYPE] = index_type_name(type_);
   json_value[FIELD_FIELD_NUM] = field_.size();
   Json::Value fields;
   for (int i = 0; i < field_.size(); i++) {
@@ -58,6 +69,7 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
   const Json::Value &unique = json_value[FIELD_UNIQUE];
   const Json::Value &field_num = json_value[FIELD_FIELD_NUM];
   const Json::Value &field_value = json_value[FIELD_FIELD_NAME];
+  const Json::Value &type_value = json_value[FIELD_TYPE];
   if (!name_value.isString()) {
     LOG_ERROR("Index name is not a string. json value=%s", name_value.toStyledString().c_str());
     return RC::INTERNAL;
@@ -92,6 +104,23 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     }
   }
 
+  // 老版本的元数据没有记录索引类型，都是B+树索引
+  IndexType type = IndexType::BPLUS_TREE;
+  if (!type_value.isNull()) {
+    if (!type_value.isString()) {
+      LOG_ERROR("Index type of index [%s] is not a string. json value=%s",
+          name_value.asCString(),
+          type_value.toStyledString().c_str());
+      return RC::INTERNAL;
+    }
+    if (0 == strcmp(type_value.asCString(), index_type_name(IndexType::HASH))) {
+      type = IndexType::HASH;
+    } else if (0 != strcmp(type_value.asCString(), index_type_name(IndexType::BPLUS_TREE))) {
+      LOG_ERROR("Unknown index type of index [%s]: %s", name_value.asCString(), type_value.asCString());
+      return RC::INTERNAL;
+    }
+  }
+
   std::vector<const FieldMeta*> fields;
   for (int i = 0; i < field_value.size(); i++) {
     const FieldMeta *field = table.field(field_value[i].asCString());
@@ -102,7 +131,7 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     fields.emplace_back(field);
   }
 
-  return index.init(name_value.asCString(), unique.asBool(), fields);
+  return index.init(name_value.asCString(), unique.asBool(), fields, type);
 }
 
 const char *IndexMeta::name() const { return name_.c_str(); }
@@ -119,5 +148,5 @@ void IndexMeta::desc(std::ostream &os) const
     fields += field;
     fields += " ";
   }
-  os << "index name=" << name_ << ", field=" << fields;
+  os << "index name=" << name_ << ", type=" << index_type_name(type_) << ", field=" << fields;
 }
\ No newline at end of file
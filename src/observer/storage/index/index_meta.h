@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/rc.h"
+#include "common/types.h"
 #include "common/lang/string.h"
 
 class TableMeta;
@@ -27,19 +28,21 @@ class Value;
 /**
  * @brief 描述一个索引
  * @ingroup Index
- * @details 一个索引包含了表的哪些字段，索引的名称等。
- * 如果以后实现了多种类型的索引，还需要记录索引的类型，对应类型的一些元数据等
+ * @details 一个索引包含了表的哪些字段，索引的名称以及索引的类型等。
  */
 class IndexMeta
 {
 public:
   IndexMeta() = default;
 
-  RC init(const char *name, bool unique, const std::vector<const FieldMeta*> &fields);
+  RC init(const char *name, bool unique, const std::vector<const FieldMeta*> &fields,
+      IndexType type = IndexType::BPLUS_TREE);
 
 public:
   const char *name() const;
   const std::vector<std::string> &field() const;
+  bool        unique() const { return unique_; }
+  IndexType   type() const { return type_; }
 
   void desc(ostream &os) const;
 
@@ -49,6 +52,7 @@ public:
 
 protected:
   bool unique_; 
+  IndexType type_ = IndexType::BPLUS_TREE;
   string name_;   // index's name
   std::vector<std::string> field_;
 };
\ No newline at end of file
@@ -0,0 +1,112 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/index_worker_pool.h"
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+IndexParallelOptions IndexParallelOptions::from_config()
+{
+  IndexParallelOptions options;
+
+  const char *section     = "INDEX";
+  string      threads     = common::get_properties()->get("INDEX_WORKER_THREADS", "", section);
+  string      min_indexes = common::get_properties()->get("PARALLEL_MAINTENANCE_MIN_INDEXES", "", section);
+  if (!threads.empty()) {
+    common::str_to_val(threads, options.worker_threads);
+  }
+  if (!min_indexes.empty()) {
+    common::str_to_val(min_indexes, options.maintenance_min_indexes);
+  }
+  options.worker_threads = max(options.worker_threads, 0);
+  return options;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+IndexWorkerPool::IndexWorkerPool(const IndexParallelOptions &options) : options_(options)
+{
+#ifndef CONCURRENCY
+  if (options_.worker_threads > 0) {
+    LOG_INFO("index worker threads are not supported without CONCURRENCY");
+    options_.worker_threads = 0;
+  }
+#endif
+
+  if (options_.worker_threads > 0) {
+    int ret = executor_.init("IndexWorker", options_.worker_threads, options_.worker_threads, 60 * 1000);
+    if (ret != 0) {
+      LOG_WARN("failed to init index worker pool. threads=%d, ret=%d", options_.worker_threads, ret);
+      options_.worker_threads = 0;
+    } else {
+      LOG_INFO("index worker pool started. threads=%d", options_.worker_threads);
+    }
+  }
+}
+
+IndexWorkerPool::~IndexWorkerPool()
+{
+  if (options_.worker_threads > 0) {
+    executor_.shutdown();
+    executor_.await_termination();
+  }
+}
+
+IndexWorkerPool &IndexWorkerPool::instance()
+{
+  static IndexWorkerPool pool(IndexParallelOptions::from_config());
+  return pool;
+}
+
+void IndexWorkerPool::run(const vector<function<RC()>> &tasks, vector<RC> &results)
+{
+  results.assign(tasks.size(), RC::SUCCESS);
+  if (tasks.empty()) {
+    return;
+  }
+
+  // 这些变量在当前栈上，等所有任务都结束了才会返回
+  mutex              lock;
+  condition_variable cond;
+  size_t             pending = 0;
+  for (size_t i = 1; i < tasks.size(); i++) {
+    if (enabled()) {
+      {
+        lock_guard<mutex> guard(lock);
+        pending++;
+      }
+      int ret = executor_.execute([&, i]() {
+        RC rc = tasks[i]();
+
+        lock_guard<mutex> guard(lock);
+        results[i] = rc;
+        if (--pending == 0) {
+          cond.notify_all();
+        }
+      });
+      if (ret == 0) {
+        continue;
+      }
+
+      LOG_WARN("failed to submit index task, run it in current thread. ret=%d", ret);
+      lock_guard<mutex> guard(lock);
+      pending--;
+    }
+    results[i] = tasks[i]();
+  }
+
+  results[0] = tasks[0]();
+
+  unique_lock<mutex> guard(lock);
+  cond.wait(guard, [&pending]() { return pending == 0; });
+}
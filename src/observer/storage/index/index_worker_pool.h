@@ -0,0 +1,79 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/functional.h"
+#include "common/lang/vector.h"
+#include "common/thread/thread_pool_executor.h"
+
+/**
+ * @brief 索引并行处理的参数
+ * @ingroup Index
+ * @details 从配置文件的 [INDEX] 中读取
+ */
+struct IndexParallelOptions
+{
+  static constexpr int DEFAULT_MAINTENANCE_MIN_INDEXES = 4;
+
+  int worker_threads          = 0;  ///< 工作线程的个数，0表示不并行
+  int maintenance_min_indexes = DEFAULT_MAINTENANCE_MIN_INDEXES;  ///< 表上至少有这么多个索引时，才并行修改索引
+
+  /**
+   * @brief 读取配置 INDEX_WORKER_THREADS 和 PARALLEL_MAINTENANCE_MIN_INDEXES
+   */
+  static IndexParallelOptions from_config();
+};
+
+/**
+ * @brief 索引的工作线程池
+ * @ingroup Index
+ * @details 所有表共用一个线程池，有两个用途：
+ * - 插入或删除一条记录时，同时修改多个索引。每个索引只修改一次，单个索引的修改仍然是串行的；
+ * - 创建索引时把表的页面分成几段，并行扫描记录、生成有序段。
+ * 调用者自己也执行一个任务，所以并行度是工作线程个数加一。
+ * 非并发编译(没有 CONCURRENCY)时缓冲池等很多锁什么都不做，不会启动工作线程。
+ */
+class IndexWorkerPool
+{
+public:
+  explicit IndexWorkerPool(const IndexParallelOptions &options);
+  ~IndexWorkerPool();
+
+  /**
+   * @brief 全局的线程池，第一次使用时按照配置创建
+   */
+  static IndexWorkerPool &instance();
+
+  const IndexParallelOptions &options() const { return options_; }
+
+  bool enabled() const { return options_.worker_threads > 0; }
+  /// 最多有多少个任务同时执行，包括调用者自己
+  int  parallelism() const { return options_.worker_threads + 1; }
+
+  /// 修改 index_num 个索引时是否应该并行
+  bool parallel_maintenance(int index_num) const
+  {
+    return enabled() && index_num > 1 && index_num >= options_.maintenance_min_indexes;
+  }
+
+  /**
+   * @brief 并行执行一组任务，等待全部结束
+   * @details 第0个任务在当前线程中执行，其它任务交给工作线程。工作线程接收不了的任务也在当前线程中执行。
+   * 任务之间不能互相等待
+   * @param[out] results 每个任务的返回值
+   */
+  void run(const vector<function<RC()>> &tasks, vector<RC> &results);
+
+private:
+  IndexParallelOptions       options_;
+  common::ThreadPoolExecutor executor_;
+};
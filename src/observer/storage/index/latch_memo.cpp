@@ -61,6 +61,14 @@ RC LatchMemo::allocate_page(Frame *&frame)
   return rc;
 }
 
+void LatchMemo::adopt_page(Frame *frame, LatchMemoType latch_type)
+{
+  ASSERT(latch_type == LatchMemoType::SHARED || latch_type == LatchMemoType::EXCLUSIVE,
+         "invalid latch type: %d", static_cast<int>(latch_type));
+  items_.emplace_back(LatchMemoType::PIN, frame);
+  items_.emplace_back(latch_type, frame);
+}
+
 void LatchMemo::dispose_page(PageNum page_num) { disposed_pages_.emplace_back(page_num); }
 
 void LatchMemo::latch(Frame *frame, LatchMemoType type)
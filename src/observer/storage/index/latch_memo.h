@@ -62,6 +62,12 @@ public:
   /// @brief 分配页面
   RC allocate_page(Frame *&frame);
 
+  /**
+   * @brief 接管一个已经pin住并且加了锁的页面
+   * @details 乐观读时先自己pin住页面、加锁并校验版本号，成功后再交给latch memo统一释放
+   */
+  void adopt_page(Frame *frame, LatchMemoType latch_type);
+
   /// @brief 标记为即将释放的页面
   void dispose_page(PageNum page_num);
 
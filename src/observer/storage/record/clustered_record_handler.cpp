@@ -0,0 +1,275 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/record/clustered_record_handler.h"
+#include "common/lang/algorithm.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/table/table_meta.h"
+
+ClusteredRecordHandler::ClusteredRecordHandler() = default;
+
+ClusteredRecordHandler::~ClusteredRecordHandler() { close(); }
+
+RC ClusteredRecordHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler, const TableMeta &table_meta)
+{
+  if (tree_ != nullptr) {
+    LOG_ERROR("clustered record handler has been opened");
+    return RC::RECORD_OPENNED;
+  }
+
+  const FieldMeta *primary_key = table_meta.primary_key();
+  if (nullptr == primary_key) {
+    LOG_WARN("clustered table has no primary key. table=%s", table_meta.name());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  auto tree = make_unique<BplusTreeHandler>();
+
+  RC rc = RC::SUCCESS;
+  // 新建的数据文件只有缓冲池自己的文件头页面
+  if (buffer_pool.page_count() <= 1) {
+    rc = tree->create(log_handler,
+        buffer_pool,
+        primary_key->type(),
+        primary_key->len(),
+        -1 /*internal_max_size*/,
+        -1 /*leaf_max_size*/,
+        BplusTreeKeyFormat::FIXED,
+        table_meta.record_size());
+  } else {
+    rc = tree->open(log_handler, buffer_pool);
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init clustered b+tree. table=%s, rc=%s", table_meta.name(), strrc(rc));
+    return rc;
+  }
+
+  tree_        = std::move(tree);
+  key_type_    = primary_key->type();
+  key_offset_  = primary_key->offset();
+  key_len_     = primary_key->len();
+  record_size_ = table_meta.record_size();
+  LOG_INFO("open clustered record handler done. table=%s, primary key=%s", table_meta.name(), primary_key->name());
+  return RC::SUCCESS;
+}
+
+void ClusteredRecordHandler::close()
+{
+  // 数据文件由表负责关闭，BplusTreeHandler::close 会关闭文件，这里不能调用
+  tree_.reset();
+}
+
+RID ClusteredRecordHandler::make_rid(const char *record) const
+{
+  RID rid;
+  memset(&rid, 0, sizeof(rid));
+
+  const char *key = record + key_offset_;
+  int         len = key_len_;
+  if (key_type_ == AttrType::CHARS) {
+    len = static_cast<int>(strnlen(key, len));
+  }
+  memcpy(&rid, key, len);
+  return rid;
+}
+
+RC ClusteredRecordHandler::insert_record(const char *data, int record_size, RID *rid)
+{
+  if (record_size != record_size_) {
+    LOG_WARN("invalid record size. record size=%d, expect=%d", record_size, record_size_);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  RID new_rid = make_rid(data);
+  RC  rc      = tree_->insert_entry(reinterpret_cast<const char *>(&new_rid), &new_rid, data);
+  if (OB_FAIL(rc)) {
+    if (rc != RC::RECORD_DUPLICATE_KEY) {
+      LOG_WARN("failed to insert record into clustered b+tree. rc=%s", strrc(rc));
+    }
+    return rc;
+  }
+
+  *rid = new_rid;
+  return rc;
+}
+
+RC ClusteredRecordHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
+{
+  RID new_rid;
+  RC  rc = insert_record(data, record_size, &new_rid);
+  if (rc == RC::RECORD_DUPLICATE_KEY) {
+    rc = RC::SUCCESS;
+  }
+  if (OB_SUCC(rc) && new_rid != rid) {
+    LOG_WARN("the primary key of recovered record does not match rid. rid=%s, primary key=%s",
+             rid.to_string().c_str(), new_rid.to_string().c_str());
+  }
+  return rc;
+}
+
+RC ClusteredRecordHandler::delete_record(const RID &rid)
+{
+  return tree_->delete_entry(reinterpret_cast<const char *>(&rid), &rid);
+}
+
+RC ClusteredRecordHandler::get_record(const RID &rid, Record &record)
+{
+  vector<char> data(record_size_);
+  RC           rc = tree_->get_value(reinterpret_cast<const char *>(&rid), &rid, data.data());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get record from clustered b+tree. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  record.copy_data(data.data(), record_size_);
+  record.set_rid(rid);
+  return rc;
+}
+
+RC ClusteredRecordHandler::update_record(const RID &rid, const char *data)
+{
+  if (make_rid(data) != rid) {
+    LOG_WARN("cannot change the primary key of clustered record. rid=%s", rid.to_string().c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
+  return tree_->update_value(reinterpret_cast<const char *>(&rid), &rid, [this, data](char *value) {
+    memcpy(value, data, record_size_);
+    return true;
+  });
+}
+
+RC ClusteredRecordHandler::visit_record(const RID &rid, function<bool(Record &)> updater)
+{
+  return tree_->update_value(reinterpret_cast<const char *>(&rid), &rid, [this, &rid, &updater](char *value) {
+    // value 已经是叶子节点中记录的副本，updater 失败时不会修改节点
+    Record record;
+    record.set_rid(rid);
+    record.set_data(value, record_size_);
+    return updater(record);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ClusteredRecordScanner::ClusteredRecordScanner(ClusteredRecordHandler &handler) : handler_(handler) {}
+
+void ClusteredRecordScanner::save_bound(const char *key, int len, string &bound) const
+{
+  if (handler_.key_type() == AttrType::CHARS) {
+    len = static_cast<int>(strnlen(key, len));
+  } else {
+    len = handler_.key_len();
+  }
+  bound.assign(key, len);
+}
+
+RC ClusteredRecordScanner::set_key_range(const char *left_key, int left_len, bool left_inclusive,
+    const char *right_key, int right_len, bool right_inclusive)
+{
+  has_left_ = (left_key != nullptr);
+  if (has_left_) {
+    save_bound(left_key, left_len, left_key_);
+  }
+  left_inclusive_ = left_inclusive;
+
+  has_right_ = (right_key != nullptr);
+  if (has_right_) {
+    save_bound(right_key, right_len, right_key_);
+  }
+  right_inclusive_ = right_inclusive;
+
+  batch_.clear();
+  batch_rids_.clear();
+  batch_index_ = 0;
+  eof_         = false;
+  return RC::SUCCESS;
+}
+
+RC ClusteredRecordScanner::fetch_batch()
+{
+  batch_.clear();
+  batch_rids_.clear();
+  batch_index_ = 0;
+
+  const int record_size = handler_.record_size();
+  // 一批最多复制一个页面大小的记录
+  const int capacity    = max(1, BP_PAGE_DATA_SIZE / record_size);
+
+  BplusTreeScanner scanner(handler_.tree());
+
+  RC rc = scanner.open(has_left_ ? left_key_.data() : nullptr,
+      static_cast<int>(left_key_.size()),
+      left_inclusive_,
+      has_right_ ? right_key_.data() : nullptr,
+      static_cast<int>(right_key_.size()),
+      right_inclusive_);
+  if (rc == RC::INVALID_ARGUMENT) {
+    // 左边界大于右边界，范围是空的
+    eof_ = true;
+    return RC::RECORD_EOF;
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open clustered b+tree scanner. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  RID rid;
+  while (static_cast<int>(batch_rids_.size()) < capacity) {
+    rc = scanner.next_entry(rid);
+    if (rc == RC::RECORD_EOF) {
+      eof_ = true;
+      break;
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch next clustered record. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    const char *value = scanner.current_value();
+    batch_.insert(batch_.end(), value, value + record_size);
+    batch_rids_.push_back(rid);
+  }
+
+  if (batch_rids_.empty()) {
+    eof_ = true;
+    return RC::RECORD_EOF;
+  }
+
+  // 下一批从这一批最后一个主键之后开始
+  const RID &last = batch_rids_.back();
+  save_bound(reinterpret_cast<const char *>(&last), sizeof(last), left_key_);
+  has_left_       = true;
+  left_inclusive_ = false;
+  return RC::SUCCESS;
+}
+
+RC ClusteredRecordScanner::next(Record &record)
+{
+  if (batch_index_ >= batch_rids_.size()) {
+    if (eof_) {
+      return RC::RECORD_EOF;
+    }
+
+    RC rc = fetch_batch();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  const int record_size = handler_.record_size();
+  record.copy_data(batch_.data() + batch_index_ * record_size, record_size);
+  record.set_rid(batch_rids_[batch_index_]);
+  batch_index_++;
+  return RC::SUCCESS;
+}
@@ -0,0 +1,130 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/functional.h"
+#include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/record/record.h"
+
+class BplusTreeHandler;
+class DiskBufferPool;
+class LogHandler;
+class TableMeta;
+
+/**
+ * @brief 聚簇存放的记录
+ * @ingroup RecordManager
+ * @details 表的数据文件本身就是一棵按照主键排序的B+树，叶子节点中的值是完整的记录，
+ * 参考 IndexFileHeader::leaf_value_size。
+ * 主键只能是一个字段，长度不超过RID。记录的RID就是主键的值(不足的部分补0)，
+ * 所以二级索引中存放的RID也就是主键，按照RID获取记录就是按照主键查找B+树。
+ * 主键字段是字符串时，第一个'\0'之后的内容不属于主键，生成RID时会清零。
+ * 插入重复的主键时返回 RECORD_DUPLICATE_KEY。
+ * 记录的修改、删除与日志都由B+树负责，不使用记录页面和 VisibilityMap。
+ */
+class ClusteredRecordHandler
+{
+public:
+  ClusteredRecordHandler();
+  ~ClusteredRecordHandler();
+
+  /**
+   * @brief 打开数据文件对应的B+树，文件中还没有B+树时创建
+   */
+  RC   init(DiskBufferPool &buffer_pool, LogHandler &log_handler, const TableMeta &table_meta);
+  void close();
+
+  /// 记录的RID，也就是记录的主键
+  RID make_rid(const char *record) const;
+
+  RC insert_record(const char *data, int record_size, RID *rid);
+  /**
+   * @brief 恢复时插入记录
+   * @details B+树的日志已经重做过，记录可能已经存在，这时直接返回成功
+   */
+  RC recover_insert_record(const char *data, int record_size, const RID &rid);
+  RC delete_record(const RID &rid);
+  RC get_record(const RID &rid, Record &record);
+  /**
+   * @brief 使用 data 替换 rid 对应的记录
+   * @details 不能修改主键，新的记录主键不同时返回 INVALID_ARGUMENT
+   */
+  RC update_record(const RID &rid, const char *data);
+  /**
+   * @brief 在持有叶子节点写锁时访问记录，updater 返回true时把修改写回
+   */
+  RC visit_record(const RID &rid, function<bool(Record &)> updater);
+
+  BplusTreeHandler &tree() const { return *tree_; }
+  AttrType          key_type() const { return key_type_; }
+  int               key_len() const { return key_len_; }
+  int               record_size() const { return record_size_; }
+
+private:
+  unique_ptr<BplusTreeHandler> tree_;
+  /// 主键字段的信息。不能保存 FieldMeta 指针，创建索引时表的元数据会整个替换掉
+  AttrType                     key_type_    = AttrType::UNDEFINED;
+  int                          key_offset_  = 0;
+  int                          key_len_     = 0;
+  int                          record_size_ = 0;
+};
+
+/**
+ * @brief 按照主键顺序遍历聚簇存放的记录
+ * @ingroup RecordManager
+ * @details 每次从B+树中复制最多一个叶子节点的记录，复制完就释放叶子节点的锁，
+ * 下一批从上一批最后一个主键之后重新查找。这样调用者处理记录(比如事务检查、修改记录)时
+ * 不会持有页面的锁。遍历过程中其它线程插入或删除的记录可能看得到也可能看不到。
+ */
+class ClusteredRecordScanner
+{
+public:
+  ClusteredRecordScanner(ClusteredRecordHandler &handler);
+  ~ClusteredRecordScanner() = default;
+
+  /**
+   * @brief 只遍历主键在指定范围内的记录
+   * @details 参数与 BplusTreeScanner::open 相同，边界为空表示没有边界。在 next 之前调用
+   */
+  RC set_key_range(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
+      bool right_inclusive);
+
+  /**
+   * @brief 获取下一条记录，记录的数据是复制出来的
+   * @return RECORD_EOF 遍历结束
+   */
+  RC next(Record &record);
+
+private:
+  /// 从B+树中复制下一批记录
+  RC fetch_batch();
+
+  /// 把主键保存为扫描边界，字符串边界的长度是实际的字符个数
+  void save_bound(const char *key, int len, string &bound) const;
+
+private:
+  ClusteredRecordHandler &handler_;
+
+  bool   has_left_       = false;
+  string left_key_;
+  bool   left_inclusive_ = true;
+  bool   has_right_      = false;
+  string right_key_;
+  bool   right_inclusive_ = true;
+
+  vector<char> batch_;           ///< 当前这一批的记录，依次存放
+  vector<RID>  batch_rids_;
+  size_t       batch_index_ = 0;
+  bool         eof_         = false;
+};
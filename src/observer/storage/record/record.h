@@ -52,22 +52,23 @@ struct RID
 
   static int compare(const RID *rid1, const RID *rid2)
   {
-    int page_diff = rid1->page_num - rid2->page_num;
-    if (page_diff != 0) {
-      return page_diff;
-    } else {
-      return rid1->slot_num - rid2->slot_num;
+    // 聚簇存放的表使用主键作为RID，页面编号可能是任意值，不能用减法比较
+    if (rid1->page_num != rid2->page_num) {
+      return rid1->page_num < rid2->page_num ? -1 : 1;
+    }
+    if (rid1->slot_num != rid2->slot_num) {
+      return rid1->slot_num < rid2->slot_num ? -1 : 1;
     }
+    return 0;
   }
 
   /**
-   * 返回一个不可能出现的最小的RID
-   * 虽然page num 0和slot num 0都是合法的，但是page num 0通常用于存放meta数据，所以对数据部分来说都是
-   * 不合法的. 这里在bplus tree中查找时会用到。
+   * 返回一个“最小的”RID，这里在bplus tree中查找时会用到。
+   * 聚簇存放的表使用主键作为RID，page num可能是负数，所以使用对应数值类型的最小值
    */
   static RID *min()
   {
-    static RID rid{0, 0};
+    static RID rid{numeric_limits<PageNum>::min(), numeric_limits<SlotNum>::min()};
     return &rid;
   }
 
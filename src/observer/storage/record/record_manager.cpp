@@ -14,8 +14,10 @@ See the Mulan PSL v2 for more details. */
 #include "storage/record/record_manager.h"
 #include "common/log/log.h"
 #include "storage/common/condition_filter.h"
+#include "storage/record/clustered_record_handler.h"
 #include "storage/trx/trx.h"
 #include "storage/clog/log_handler.h"
+#include "storage/table/table.h"
 
 using namespace common;
 
@@ -564,6 +566,8 @@ RC PaxRecordPageHandler::update_record(const RID &rid, const char *data) { retur
 RC PaxRecordPageHandler::update_record(Record *rid, const char *data) { return update_record(rid->rid(), data); }
 ////////////////////////////////////////////////////////////////////////////////
 
+RecordFileHandler::RecordFileHandler(StorageFormat storage_format) : storage_format_(storage_format) {}
+
 RecordFileHandler::~RecordFileHandler() { this->close(); }
 
 RC RecordFileHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler, TableMeta *table_meta)
@@ -577,6 +581,20 @@ RC RecordFileHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler,
   log_handler_      = &log_handler;
   table_meta_       = table_meta;
 
+  if (storage_format_ == StorageFormat::CLUSTERED_FORMAT) {
+    clustered_ = make_unique<ClusteredRecordHandler>();
+    RC rc      = clustered_->init(buffer_pool, log_handler, *table_meta);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init clustered record handler. rc=%s", strrc(rc));
+      clustered_.reset();
+      disk_buffer_pool_ = nullptr;
+      log_handler_      = nullptr;
+      table_meta_       = nullptr;
+      return rc;
+    }
+    return RC::SUCCESS;
+  }
+
   RC rc = init_free_pages();
 
   LOG_INFO("open record file handle done. rc=%s", strrc(rc));
@@ -586,6 +604,7 @@ RC RecordFileHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler,
 void RecordFileHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
+    clustered_.reset();
     free_pages_.clear();
     disk_buffer_pool_ = nullptr;
     log_handler_      = nullptr;
@@ -626,6 +645,10 @@ RC RecordFileHandler::init_free_pages()
 
 RC RecordFileHandler::update_record(Record *rec, const char* data)
 {
+  if (clustered_ != nullptr) {
+    return clustered_->update_record(rec->rid(), data != nullptr ? data : rec->data());
+  }
+
   RC ret = RC::SUCCESS;
   if (storage_format_ == StorageFormat::ROW_FORMAT) {
     RowRecordPageHandler record_page_handler;
@@ -634,6 +657,7 @@ RC RecordFileHandler::update_record(Record *rec, const char* data)
       LOG_WARN("failed to init record page handler. page num=%d, rc=%s", rec->rid().page_num, strrc(ret));
       return ret;
     }
+    visibility_map_.clear(rec->rid().page_num);
     return record_page_handler.update_record(rec, data);
   }
   else if (storage_format_ == StorageFormat::PAX_FORMAT) {
@@ -643,6 +667,7 @@ RC RecordFileHandler::update_record(Record *rec, const char* data)
       LOG_WARN("failed to init record page handler. page num=%d, rc=%s", rec->rid().page_num, strrc(ret));
       return ret;
     }
+    visibility_map_.clear(rec->rid().page_num);
     return record_page_handler.update_record(rec, data);
   }
   return RC::SUCCESS;
@@ -650,6 +675,10 @@ RC RecordFileHandler::update_record(Record *rec, const char* data)
 
 RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
 {
+  if (clustered_ != nullptr) {
+    return clustered_->insert_record(data, record_size, rid);
+  }
+
   RC ret = RC::SUCCESS;
 
   unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
@@ -710,12 +739,17 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
     lock_.unlock();
   }
 
-  // 找到空闲位置
+  // 找到空闲位置。页面的写锁在 record_page_handler 析构时才释放
+  visibility_map_.clear(current_page_num);
   return record_page_handler->insert_record(data, rid);
 }
 
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
 {
+  if (clustered_ != nullptr) {
+    return clustered_->recover_insert_record(data, record_size, rid);
+  }
+
   RC ret = RC::SUCCESS;
 
   unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
@@ -731,6 +765,10 @@ RC RecordFileHandler::recover_insert_record(const char *data, int record_size, c
 
 RC RecordFileHandler::delete_record(const RID *rid)
 {
+  if (clustered_ != nullptr) {
+    return clustered_->delete_record(*rid);
+  }
+
   RC rc = RC::SUCCESS;
 
   unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
@@ -741,6 +779,7 @@ RC RecordFileHandler::delete_record(const RID *rid)
     return rc;
   }
 
+  visibility_map_.clear(rid->page_num);
   rc = record_page_handler->delete_record(rid);
   // 📢 这里注意要清理掉资源，否则会与insert_record中的加锁顺序冲突而可能出现死锁
   // delete record的加锁逻辑是拿到页面锁，删除指定记录，然后加上和释放record manager锁
@@ -759,6 +798,10 @@ RC RecordFileHandler::delete_record(const RID *rid)
 
 RC RecordFileHandler::get_record(const RID &rid, Record &record)
 {
+  if (clustered_ != nullptr) {
+    return clustered_->get_record(rid, record);
+  }
+
   unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
 
   RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, rid.page_num, ReadWriteMode::READ_WRITE);
@@ -779,8 +822,53 @@ RC RecordFileHandler::get_record(const RID &rid, Record &record)
   return rc;
 }
 
+RC RecordFileHandler::get_records(const RID *rids, int count, Record *records)
+{
+  if (clustered_ != nullptr) {
+    for (int i = 0; i < count; i++) {
+      RC rc = clustered_->get_record(rids[i], records[i]);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  PageNum current_page = BP_INVALID_PAGE_NUM;
+  for (int i = 0; i < count; i++) {
+    const RID &rid = rids[i];
+    RC         rc  = RC::SUCCESS;
+    if (rid.page_num != current_page) {
+      // init 会先释放之前的页面
+      rc = page_handler->init(*disk_buffer_pool_, *log_handler_, rid.page_num, ReadWriteMode::READ_ONLY);
+      if (OB_FAIL(rc)) {
+        LOG_ERROR("Failed to init record page handler.page number=%d", rid.page_num);
+        return rc;
+      }
+      current_page = rid.page_num;
+    }
+
+    Record inplace_record;
+    rc = page_handler->get_record(rid, inplace_record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record from record page handle. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    records[i].copy_data(inplace_record.data(), inplace_record.len());
+    records[i].set_rid(rid);
+  }
+  return RC::SUCCESS;
+}
+
 RC RecordFileHandler::visit_record(const RID &rid, function<bool(Record &)> updater)
 {
+  if (clustered_ != nullptr) {
+    return clustered_->visit_record(rid, updater);
+  }
+
   unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
 
   RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, rid.page_num, ReadWriteMode::READ_WRITE);
@@ -804,13 +892,54 @@ RC RecordFileHandler::visit_record(const RID &rid, function<bool(Record &)> upda
 
   bool updated = updater(record);
   if (updated) {
+    visibility_map_.clear(rid.page_num);
     rc = page_handler->update_record(rid, record.data());
   }
   return rc;
 }
 
+RC RecordFileHandler::refresh_visibility(
+    PageNum page_num, function<int32_t(const Record &)> visible_from, int32_t &page_visible_from)
+{
+  if (clustered_ != nullptr) {
+    // 聚簇存放的记录不在记录页面中，RID也不是页面编号
+    return RC::UNIMPLENMENT;
+  }
+
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init record page handler. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  page_visible_from = 0;
+
+  RecordPageIterator iterator;
+  iterator.init(page_handler.get());
+  Record record;
+  while (iterator.has_next()) {
+    rc = iterator.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record from page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    page_visible_from = std::max(page_visible_from, visible_from(record));
+    if (page_visible_from == VisibilityMap::NEVER_ALL_VISIBLE) {
+      break;
+    }
+  }
+
+  visibility_map_.set(page_num, page_visible_from);
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
+RecordFileScanner::RecordFileScanner() = default;
+
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
 
 RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler,
@@ -823,13 +952,22 @@ RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *
   trx_              = trx;
   log_handler_      = &log_handler;
   rw_mode_          = mode;
+  condition_filter_ = condition_filter;
+
+  if (table != nullptr && table->table_meta().storage_format() == StorageFormat::CLUSTERED_FORMAT) {
+    // 聚簇存放的记录按照主键顺序遍历，不需要按页面遍历
+    clustered_scanner_ = make_unique<ClusteredRecordScanner>(*table->record_handler()->clustered_handler());
+    clustered_eof_     = false;
+    return RC::SUCCESS;
+  }
 
   RC rc = bp_iterator_.init(buffer_pool, 1);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
-  condition_filter_ = condition_filter;
+  // 接下来会顺序访问所有页面，提前预读
+  buffer_pool.prefetch(1 /*start_page*/);
   if (table == nullptr || table->table_meta().storage_format() == StorageFormat::ROW_FORMAT) {
     record_page_handler_ = new RowRecordPageHandler();
   } else {
@@ -839,6 +977,38 @@ RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *
   return rc;
 }
 
+RC RecordFileScanner::set_page_range(PageNum start_page, PageNum end_page)
+{
+  if (clustered_scanner_ != nullptr) {
+    return RC::UNIMPLENMENT;
+  }
+
+  if (disk_buffer_pool_ == nullptr || start_page < 1 || end_page < start_page) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  RC rc = bp_iterator_.init(*disk_buffer_pool_, start_page, end_page);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init bp iterator. rc=%s", strrc(rc));
+    return rc;
+  }
+  if (start_page > 1) {
+    disk_buffer_pool_->prefetch(start_page);
+  }
+  return rc;
+}
+
+RC RecordFileScanner::set_key_range(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+    int right_len, bool right_inclusive)
+{
+  if (clustered_scanner_ == nullptr) {
+    return RC::UNIMPLENMENT;
+  }
+
+  clustered_eof_ = false;
+  return clustered_scanner_->set_key_range(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+}
+
 /**
  * @brief 从当前位置开始找到下一条有效的记录
  *
@@ -847,6 +1017,10 @@ RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *
  */
 RC RecordFileScanner::fetch_next_record()
 {
+  if (clustered_scanner_ != nullptr) {
+    return fetch_next_clustered_record();
+  }
+
   RC rc = RC::SUCCESS;
   if (record_page_iterator_.is_valid()) {
     // 当前页面还是有效的，尝试看一下是否有有效记录
@@ -899,29 +1073,56 @@ RC RecordFileScanner::fetch_next_record_in_page()
       return rc;
     }
 
-    // 如果有过滤条件，就用过滤条件过滤一下
-    if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
+    rc = check_record();
+    if (rc == RC::RECORD_INVISIBLE) {
       continue;
     }
+    return rc;
+  }
+
+  next_record_.rid().slot_num = -1;
+  return RC::RECORD_EOF;
+}
 
-    // 如果是某个事务上遍历数据，还要看看事务访问是否有冲突
-    if (trx_ == nullptr) {
+RC RecordFileScanner::fetch_next_clustered_record()
+{
+  // 记录是从B+树中复制出来的，检查记录时不持有页面的锁
+  while (true) {
+    RC rc = clustered_scanner_->next(next_record_);
+    if (rc == RC::RECORD_EOF) {
+      clustered_eof_ = true;
+      return rc;
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch next clustered record. rc=%s", strrc(rc));
       return rc;
     }
 
-    // 让当前事务探测一下是否访问冲突，或者需要加锁、等锁等操作，由事务自己决定
-    // TODO 把判断事务有效性的逻辑从Scanner中移除
-    rc = trx_->visit_record(table_, next_record_, rw_mode_);
+    rc = check_record();
     if (rc == RC::RECORD_INVISIBLE) {
-      // 可以参考MvccTrx，表示当前记录不可见
-      // 这种模式仅在 readonly 事务下是有效的
       continue;
     }
     return rc;
   }
+}
 
-  next_record_.rid().slot_num = -1;
-  return RC::RECORD_EOF;
+RC RecordFileScanner::check_record()
+{
+  // 如果有过滤条件，就用过滤条件过滤一下
+  if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
+    return RC::RECORD_INVISIBLE;
+  }
+
+  // 如果是某个事务上遍历数据，还要看看事务访问是否有冲突
+  if (trx_ == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  // 让当前事务探测一下是否访问冲突，或者需要加锁、等锁等操作，由事务自己决定
+  // TODO 把判断事务有效性的逻辑从Scanner中移除
+  // 返回 RECORD_INVISIBLE 可以参考MvccTrx，表示当前记录不可见
+  // 这种模式仅在 readonly 事务下是有效的
+  return trx_->visit_record(table_, next_record_, rw_mode_);
 }
 
 RC RecordFileScanner::close_scan()
@@ -938,11 +1139,19 @@ RC RecordFileScanner::close_scan()
     delete record_page_handler_;
     record_page_handler_ = nullptr;
   }
+  clustered_scanner_.reset();
+  clustered_eof_ = false;
 
   return RC::SUCCESS;
 }
 
-bool RecordFileScanner::has_next() { return next_record_.rid().slot_num != -1; }
+bool RecordFileScanner::has_next()
+{
+  if (clustered_scanner_ != nullptr) {
+    return !clustered_eof_;
+  }
+  return next_record_.rid().slot_num != -1;
+}
 
 RC RecordFileScanner::next(Record &record)
 {
@@ -961,6 +1170,11 @@ RC RecordFileScanner::update_current(const Record &record)
     return RC::INVALID_ARGUMENT;
   }
 
+  if (clustered_scanner_ != nullptr) {
+    return table_->record_handler()->clustered_handler()->update_record(record.rid(), record.data());
+  }
+
+  table_->record_handler()->visibility_map().clear(record.rid().page_num);
   return record_page_handler_->update_record(record.rid(), record.data());
 }
 
@@ -996,6 +1210,8 @@ RC ChunkFileScanner::open_scan_chunk(
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
+  // 接下来会顺序访问所有页面，提前预读
+  buffer_pool.prefetch(1 /*start_page*/);
   if (table == nullptr || table->table_meta().storage_format() == StorageFormat::ROW_FORMAT) {
     record_page_handler_ = new RowRecordPageHandler();
   } else {
@@ -15,11 +15,14 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/lang/bitmap.h"
+#include "common/lang/memory.h"
 #include "common/lang/sstream.h"
+#include "common/lang/unordered_set.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/common/chunk.h"
 #include "storage/record/record.h"
 #include "storage/record/record_log.h"
+#include "storage/record/visibility_map.h"
 #include "common/types.h"
 #include <string>
 
@@ -29,6 +32,8 @@ class RecordPageHandler;
 class LogHandler;
 class Trx;
 class Table;
+class ClusteredRecordHandler;
+class ClusteredRecordScanner;
 
 /**
  * @brief 这里负责管理在一个文件上表记录(行)的组织/管理
@@ -365,7 +370,7 @@ private:
 class RecordFileHandler
 {
 public:
-  RecordFileHandler(StorageFormat storage_format) : storage_format_(storage_format){};
+  RecordFileHandler(StorageFormat storage_format);
   ~RecordFileHandler();
 
   /**
@@ -410,8 +415,31 @@ public:
 
   RC get_record(const RID &rid, Record &record);
 
+  /**
+   * @brief 批量获取记录
+   * @details 同一个页面上连续的记录只会pin一次页面，所以调用方最好先按照页面编号排好序
+   * @param rids 记录的标识符
+   * @param count 记录的个数
+   * @param[out] records 与 rids 一一对应
+   */
+  RC get_records(const RID *rids, int count, Record *records);
+
   RC visit_record(const RID &rid, function<bool(Record &)> updater);
 
+  /**
+   * @brief 检查页面上的所有记录，计算并保存页面的可见性标记
+   * @details 计算时持有页面的读锁，与修改记录时清除标记互斥
+   * @param visible_from 返回一条记录从哪个事务开始可见，不是对之后所有事务都可见时返回
+   * VisibilityMap::NEVER_ALL_VISIBLE
+   * @param[out] page_visible_from 页面上所有记录都可见的最小事务号
+   */
+  RC refresh_visibility(PageNum page_num, function<int32_t(const Record &)> visible_from, int32_t &page_visible_from);
+
+  VisibilityMap &visibility_map() { return visibility_map_; }
+
+  /// 聚簇存放(CLUSTERED_FORMAT)时所有的操作都交给它处理，其它格式时为空
+  ClusteredRecordHandler *clustered_handler() const { return clustered_.get(); }
+
 private:
   /**
    * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
@@ -425,6 +453,9 @@ private:
   common::Mutex          lock_;  ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
   StorageFormat          storage_format_;
   TableMeta             *table_meta_;
+  VisibilityMap          visibility_map_;  ///< 页面的可见性标记，页面上的记录修改时清除
+
+  unique_ptr<ClusteredRecordHandler> clustered_;
 };
 
 /**
@@ -435,7 +466,7 @@ private:
 class RecordFileScanner
 {
 public:
-  RecordFileScanner() = default;
+  RecordFileScanner();
   ~RecordFileScanner();
 
   /**
@@ -450,6 +481,19 @@ public:
   RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler, ReadWriteMode mode,
       ConditionFilter *condition_filter);
 
+  /**
+   * @brief 只遍历 [start_page, end_page) 中的页面
+   * @details 在 open_scan 之后、获取记录之前调用。并行扫描时每个线程遍历文件的一段页面
+   */
+  RC set_page_range(PageNum start_page, PageNum end_page);
+
+  /**
+   * @brief 只遍历主键在指定范围内的记录，只有聚簇存放的表支持
+   * @details 在 open_scan 之后、获取记录之前调用，参数参考 ClusteredRecordScanner::set_key_range
+   */
+  RC set_key_range(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
+      bool right_inclusive);
+
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
    */
@@ -477,6 +521,17 @@ private:
    */
   RC fetch_next_record_in_page();
 
+  /**
+   * @brief 聚簇存放时按照主键顺序获取下一条有效的记录
+   */
+  RC fetch_next_clustered_record();
+
+  /**
+   * @brief 使用过滤条件和事务检查 next_record_
+   * @return RECORD_INVISIBLE 记录不满足条件或者对当前事务不可见，需要跳过
+   */
+  RC check_record();
+
 private:
   // TODO 对于一个纯粹的record遍历器来说，不应该关心表和事务
   Table *table_ = nullptr;  ///< 当前遍历的是哪张表。这个字段仅供事务函数使用，如果设计合适，可以去掉
@@ -491,6 +546,9 @@ private:
   RecordPageHandler *record_page_handler_ = nullptr;  ///< 处理文件某页面的记录
   RecordPageIterator record_page_iterator_;           ///< 遍历某个页面上的所有record
   Record             next_record_;                    ///< 获取的记录放在这里缓存起来
+
+  unique_ptr<ClusteredRecordScanner> clustered_scanner_;  ///< 聚簇存放时使用，此时不使用页面相关的成员
+  bool                               clustered_eof_ = false;
 };
 
 /**
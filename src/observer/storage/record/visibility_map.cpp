@@ -0,0 +1,37 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/record/visibility_map.h"
+
+bool VisibilityMap::get(PageNum page_num, int32_t &visible_from)
+{
+  lock_.lock();
+  auto iter  = pages_.find(page_num);
+  bool found = iter != pages_.end();
+  if (found) {
+    visible_from = iter->second;
+  }
+  lock_.unlock();
+  return found;
+}
+
+void VisibilityMap::set(PageNum page_num, int32_t visible_from)
+{
+  lock_.lock();
+  pages_[page_num] = visible_from;
+  lock_.unlock();
+}
+
+void VisibilityMap::clear(PageNum page_num)
+{
+  lock_.lock();
+  pages_.erase(page_num);
+  lock_.unlock();
+}
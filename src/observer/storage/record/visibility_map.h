@@ -0,0 +1,49 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/limits.h"
+#include "common/lang/mutex.h"
+#include "common/lang/unordered_map.h"
+#include "common/types.h"
+
+/**
+ * @brief 记录文件中每个页面的可见性标记
+ * @ingroup RecordManager
+ * @details 记录页面上的所有记录从哪个事务开始都是可见的。只扫描索引的查询可以根据这个标记判断记录是否可见，
+ * 不需要读取记录。
+ * 标记只保存在内存中，重启之后所有页面都是未知状态。页面上的记录有任何修改时都会清除标记，
+ * 修改和清除都在页面的写锁内完成，计算标记的时候持有页面的读锁，所以标记不会比页面的内容旧。
+ */
+class VisibilityMap
+{
+public:
+  /// 页面上有记录不是对之后所有的事务都可见，比如还没有提交的记录或者已经删除的记录
+  static constexpr int32_t NEVER_ALL_VISIBLE = numeric_limits<int32_t>::max();
+
+public:
+  VisibilityMap()  = default;
+  ~VisibilityMap() = default;
+
+  /**
+   * @brief 获取页面的可见性标记
+   * @param[out] visible_from 页面上的所有记录对事务号不小于它的事务都可见
+   * @return 页面的状态未知时返回false
+   */
+  bool get(PageNum page_num, int32_t &visible_from);
+
+  void set(PageNum page_num, int32_t visible_from);
+  void clear(PageNum page_num);
+
+private:
+  common::Mutex                   lock_;
+  unordered_map<PageNum, int32_t> pages_;
+};
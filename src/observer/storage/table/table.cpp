@@ -25,8 +25,12 @@ See the Mulan PSL v2 for more details. */
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/common/condition_filter.h"
 #include "storage/common/meta_util.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
+#include "storage/index/hash_index.h"
 #include "storage/index/bplus_tree_index.h"
 #include "storage/index/index.h"
+#include "storage/index/index_worker_pool.h"
+#include "storage/record/clustered_record_handler.h"
 #include "storage/record/record_manager.h"
 #include "storage/table/table.h"
 #include "storage/trx/trx.h"
@@ -221,10 +225,17 @@ RC Table::open(Db *db, const char *meta_file, const char *base_dir)
       field_metas.emplace_back(field_meta);
     }
 
-    BplusTreeIndex *index      = new BplusTreeIndex();
-    string          index_file = table_index_file(base_dir, name(), index_meta->name());
-
-    rc                         = index->open(this, index_file.c_str(), *index_meta, field_metas);
+    Index *index      = nullptr;
+    string index_file = table_index_file(base_dir, name(), index_meta->name());
+    if (index_meta->type() == IndexType::HASH) {
+      auto hash_index = new HashIndex();
+      index           = hash_index;
+      rc              = hash_index->open(this, index_file.c_str(), *index_meta, field_metas);
+    } else {
+      auto bplus_tree_index = new BplusTreeIndex();
+      index                 = bplus_tree_index;
+      rc                    = bplus_tree_index->open(this, index_file.c_str(), *index_meta, field_metas);
+    }
     if (rc != RC::SUCCESS) {
       delete index;
       LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%s",
@@ -331,6 +342,8 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
   // 复制所有字段的值
   int   record_size = table_meta_.record_size();
   char *record_data = (char *)malloc(record_size);
+  // 字符串只复制到结束符为止，剩下的字节(比如null位图)需要是0，否则读出来的字段可能被当作NULL
+  memset(record_data, 0, record_size);
 
   for (int i = 0; i < value_num; i++) {
     const FieldMeta *field    = table_meta_.field(i + normal_field_start_index);
@@ -386,6 +399,11 @@ RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode
 
 RC Table::get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode mode)
 {
+  if (table_meta_.storage_format() == StorageFormat::CLUSTERED_FORMAT) {
+    LOG_WARN("chunk scan is not supported by clustered table. table=%s", name());
+    return RC::UNIMPLENMENT;
+  }
+
   RC rc = scanner.open_scan_chunk(this, *data_buffer_pool_, db_->log_handler(), mode);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
@@ -408,18 +426,106 @@ RC Table::delete_record(const RID &rid)
 RC Table::delete_record(const Record &record)
 {
   RC rc = RC::SUCCESS;
-  for (Index *index : indexes_) {
-    rc = index->delete_entry(record.data(), &record.rid());
-    ASSERT(RC::SUCCESS == rc, 
-           "failed to delete entry from index. table name=%s, index name=%s, rid=%s, rc=%s",
-           name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
+  // 每个索引都要删除，与顺序无关，索引多时交给工作线程同时删除
+  if (IndexWorkerPool::instance().parallel_maintenance(static_cast<int>(indexes_.size()))) {
+    vector<function<RC()>> tasks;
+    for (Index *index : indexes_) {
+      tasks.emplace_back([index, &record]() { return index->delete_entry(record.data(), &record.rid()); });
+    }
+    vector<RC> results;
+    IndexWorkerPool::instance().run(tasks, results);
+    for (size_t i = 0; i < results.size(); i++) {
+      ASSERT(RC::SUCCESS == results[i],
+             "failed to delete entry from index. table name=%s, index name=%s, rid=%s, rc=%s",
+             name(), indexes_[i]->index_meta().name(), record.rid().to_string().c_str(), strrc(results[i]));
+    }
+  } else {
+    for (Index *index : indexes_) {
+      rc = index->delete_entry(record.data(), &record.rid());
+      ASSERT(RC::SUCCESS == rc, 
+             "failed to delete entry from index. table name=%s, index name=%s, rid=%s, rc=%s",
+             name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
+    }
   }
   rc = record_handler_->delete_record(&record.rid());
   return rc;
 }
 
+RC Table::collect_index_keys(Trx *trx, BplusTreeBulkLoader &loader)
+{
+  // 页面太少时分区没有意义，每个分区至少这么多个页面
+  constexpr int MIN_PAGES_PER_PARTITION = 16;
+
+  // 第0个页面是缓冲池的文件头，数据从第1个页面开始
+  // 聚簇存放的数据文件是一棵B+树，不能按页面分区
+  const PageNum    page_count    = data_buffer_pool_->page_count();
+  IndexWorkerPool &worker_pool   = IndexWorkerPool::instance();
+  const int        partition_num = table_meta_.storage_format() == StorageFormat::CLUSTERED_FORMAT
+                                       ? 1
+                                       : clamp((page_count - 1) / MIN_PAGES_PER_PARTITION, 1, worker_pool.parallelism());
+
+  RC rc = loader.create_partitions(partition_num);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create bulk load partitions. table=%s, partitions=%d, rc=%s", name(), partition_num, strrc(rc));
+    return rc;
+  }
+
+  const PageNum          pages_per_partition = (page_count - 1 + partition_num - 1) / partition_num;
+  vector<function<RC()>> tasks;
+  for (int i = 0; i < partition_num; i++) {
+    const PageNum start_page = 1 + i * pages_per_partition;
+    const PageNum end_page   = (i == partition_num - 1) ? page_count : start_page + pages_per_partition;
+    tasks.emplace_back([this, trx, &loader, partition_num, i, start_page, end_page]() -> RC {
+      RecordFileScanner scanner;
+      RC                rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
+      if (OB_SUCC(rc) && partition_num > 1) {
+        rc = scanner.set_page_range(start_page, end_page);
+      }
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to create scanner while creating index. table=%s, rc=%s", name(), strrc(rc));
+        return rc;
+      }
+
+      BplusTreeBulkLoader::Partition &partition = loader.partition(i);
+      Record                          record;
+      while (OB_SUCC(rc = scanner.next(record))) {
+        rc = partition.add(record.data(), record.rid());
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to add record into bulk loader. table=%s, rid=%s, rc=%s",
+              name(), record.rid().to_string().c_str(), strrc(rc));
+          return rc;
+        }
+      }
+      if (rc != RC::RECORD_EOF) {
+        LOG_WARN("failed to scan records while creating index. table=%s, pages=[%d, %d), rc=%s",
+            name(), start_page, end_page, strrc(rc));
+        return rc;
+      }
+      scanner.close_scan();
+
+      // 剩余的数据在扫描线程中排好序，归并时就不用再排序了
+      return partition.seal();
+    });
+  }
+
+  vector<RC> results;
+  worker_pool.run(tasks, results);
+  for (RC result : results) {
+    if (OB_FAIL(result)) {
+      return result;
+    }
+  }
+
+  LOG_INFO("collected index keys. table=%s, partitions=%d, entries=%ld", name(), partition_num, loader.entry_count());
+  return RC::SUCCESS;
+}
+
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
 {
+  if (IndexWorkerPool::instance().parallel_maintenance(static_cast<int>(indexes_.size()))) {
+    return parallel_insert_entry_of_indexes(record, rid);
+  }
+
   RC rc = RC::SUCCESS;
   for (Index *index : indexes_) {
     rc = index->insert_entry(record, &rid);
@@ -430,6 +536,37 @@ RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
   return rc;
 }
 
+RC Table::parallel_insert_entry_of_indexes(const char *record, const RID &rid)
+{
+  vector<function<RC()>> tasks;
+  tasks.reserve(indexes_.size());
+  for (Index *index : indexes_) {
+    tasks.emplace_back([index, record, &rid]() { return index->insert_entry(record, &rid); });
+  }
+
+  vector<RC> results;
+  IndexWorkerPool::instance().run(tasks, results);
+
+  // 与串行插入的结果保持一致：第一个失败的索引之前都插入了，之后的都没有插入。
+  // 调用者回滚时按照这个约定删除，所以要把后面插入成功的删掉
+  auto first_failed = find_if(results.begin(), results.end(), [](RC rc) { return OB_FAIL(rc); });
+  if (first_failed == results.end()) {
+    return RC::SUCCESS;
+  }
+
+  for (size_t i = first_failed - results.begin() + 1; i < results.size(); i++) {
+    if (OB_FAIL(results[i])) {
+      continue;
+    }
+    RC rc = indexes_[i]->delete_entry(record, &rid);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("failed to rollback index entry. table=%s, index=%s, rid=%s, rc=%s",
+          name(), indexes_[i]->index_meta().name(), rid.to_string().c_str(), strrc(rc));
+    }
+  }
+  return *first_failed;
+}
+
 RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists)
 {
   RC rc = RC::SUCCESS;
@@ -463,6 +600,15 @@ Index *Table::find_index_by_field(const char *field_name) const
   return nullptr;
 }
 
+int64_t Table::estimated_record_num() const
+{
+  if (nullptr == data_buffer_pool_ || table_meta_.record_size() <= 0) {
+    return 0;
+  }
+  const int64_t records_per_page = std::max(1, BP_PAGE_DATA_SIZE / table_meta_.record_size());
+  return static_cast<int64_t>(data_buffer_pool_->page_count()) * records_per_page;
+}
+
 RC Table::sync()
 {
   RC rc = RC::SUCCESS;
@@ -483,6 +629,27 @@ RC Table::sync()
   return rc;
 }
 
+RC Table::on_redo_done()
+{
+  RC rc = RC::SUCCESS;
+  if (record_handler_->clustered_handler() != nullptr) {
+    rc = record_handler_->clustered_handler()->tree().reload_header();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to reload clustered b+tree header. table=%s, rc=%s", name(), strrc(rc));
+      return rc;
+    }
+  }
+
+  for (Index *index : indexes_) {
+    rc = index->on_redo_done();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to reload index after redo. table=%s, index=%s, rc=%s",
+          name(), index->index_meta().name(), strrc(rc));
+      return rc;
+    }
+  }
+  return rc;
+}
 
 RC Table::write_text(int64_t &offset, int64_t length, const char *data)
 {
@@ -591,6 +758,11 @@ RC Table::update_record(Record &record, const std::vector<std::string> &attr_nam
   }
   record.set_data(data);  // 谁来管理old_data呢？
 
+  if (!same_primary_key(old_data, data)) {
+    LOG_WARN("cannot update primary key of clustered table. table=%s", name());
+    return RC::UNIMPLENMENT;
+  }
+
   rc = delete_entry_of_indexes(old_data, record.rid(), false);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to delete indexes of record (rid=%d.%d). rc=%d:%s",
@@ -630,6 +802,11 @@ RC Table::update_record(Record &old_record, Record &new_record)
 {
   RC rc = RC::SUCCESS;
 
+  if (!same_primary_key(old_record.data(), new_record.data())) {
+    LOG_WARN("cannot update primary key of clustered table. table=%s", name());
+    return RC::UNIMPLENMENT;
+  }
+
   rc = delete_entry_of_indexes(old_record.data(), old_record.rid(), false);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to delete indexes of record (rid=%d.%d). rc=%d:%s",
@@ -664,7 +841,18 @@ RC Table::update_record(Record &old_record, Record &new_record)
   return rc;
 }
 
-RC Table::create_index(Trx *trx, bool unique, const std::vector<const FieldMeta *> &field_metas, const char *index_name)
+bool Table::same_primary_key(const char *old_data, const char *new_data) const
+{
+  const FieldMeta *primary_key = table_meta_.primary_key();
+  if (nullptr == primary_key) {
+    return true;
+  }
+  return record_handler_->clustered_handler()->make_rid(old_data) ==
+         record_handler_->clustered_handler()->make_rid(new_data);
+}
+
+RC Table::create_index(Trx *trx, bool unique, const std::vector<const FieldMeta *> &field_metas, const char *index_name,
+    IndexType index_type)
 {
   if (common::is_blank(index_name) || field_metas.empty()) {
     LOG_INFO("Invalid input arguments, table name is %s, index_name is blank or attribute_name is blank", name());
@@ -672,7 +860,7 @@ RC Table::create_index(Trx *trx, bool unique, const std::vector<const FieldMeta
   }
 
   IndexMeta new_index_meta;
-  RC        rc = new_index_meta.init(index_name, unique, field_metas);
+  RC        rc = new_index_meta.init(index_name, unique, field_metas, index_type);
   if (rc != RC::SUCCESS) {
     std::string field_names = field_metas[0]->name();
     for (int i = 0; i < field_metas.size(); i++) {
@@ -704,39 +892,62 @@ RC Table::create_index(Trx *trx, bool unique, const std::vector<const FieldMeta
   }
 
   
-  BplusTreeIndex *index      = new BplusTreeIndex();
-  std::string     index_file = table_index_file(base_dir_.c_str(), name(), index_name);
-  rc                         = index->create(this, index_file.c_str(), unique, new_index_meta, field_ids, field_metas);
-  if (rc != RC::SUCCESS) {
-    delete index;
-    LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
-    return rc;
+  Index          *index            = nullptr;
+  BplusTreeIndex *bplus_tree_index = nullptr;
+  std::string     index_file       = table_index_file(base_dir_.c_str(), name(), index_name);
+  if (index_type == IndexType::HASH) {
+    auto hash_index = new HashIndex();
+    index           = hash_index;
+    rc              = hash_index->create(this, index_file.c_str(), unique, new_index_meta, field_ids, field_metas);
+  } else {
+    bplus_tree_index = new BplusTreeIndex();
+    index            = bplus_tree_index;
+    rc = bplus_tree_index->create(this, index_file.c_str(), unique, new_index_meta, field_ids, field_metas);
   }
-
-  // 遍历当前的所有数据，插入这个索引
-  RecordFileScanner scanner;
-  rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
   if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
+    delete index;
+    LOG_ERROR("Failed to create index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
     return rc;
   }
 
-  Record record;
-  while (scanner.has_next()) {
-    rc = scanner.next(record);
+  // 默认先收集所有的键值并排序，再自底向上构建B+树，比逐条插入快很多，也不用为每条数据记录日志
+  // 哈希索引没有顺序，只能逐条插入
+  const BplusTreeBulkLoadOptions bulk_load_options = BplusTreeBulkLoadOptions::from_config();
+  if (bplus_tree_index != nullptr && bulk_load_options.enabled) {
+    BplusTreeBulkLoader bulk_loader(bplus_tree_index->tree_handler(), bulk_load_options);
+    rc = collect_index_keys(trx, bulk_loader);
+    if (OB_SUCC(rc)) {
+      rc = bulk_loader.finish();
+    }
     if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to scan records while creating index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
+      LOG_WARN("failed to bulk load index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
       return rc;
     }
-    rc = index->insert_entry(record.data(), &record.rid());
+  } else {
+    // 遍历当前的所有数据，插入这个索引
+    RecordFileScanner scanner;
+    rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
     if (rc != RC::SUCCESS) {
-      // TODO: 插入失败，应该删除索引
-      LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
-          name(), index_name, strrc(rc));
+      LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
+      return rc;
+    }
+
+    Record record;
+    while (OB_SUCC(rc = scanner.next(record))) {
+      rc = index->insert_entry(record.data(), &record.rid());
+      if (rc != RC::SUCCESS) {
+        // TODO: 插入失败，应该删除索引
+        LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
+            name(), index_name, strrc(rc));
+        return rc;
+      }
+    }
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to scan records while creating index. table=%s, index=%s, rc=%s", name(), index_name, strrc(rc));
       return rc;
     }
+    scanner.close_scan();
   }
-  scanner.close_scan();
   LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
 
   indexes_.push_back(index);
@@ -28,6 +28,7 @@ class ChunkFileScanner;
 class ConditionFilter;
 class DefaultConditionFilter;
 class Index;
+class BplusTreeBulkLoader;
 class IndexScanner;
 class RecordDeleter;
 class Trx;
@@ -63,7 +64,8 @@ public:
   RC update_record(Record &old_record, Record &new_record);
   // TODO refactor
   RC create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name);
-  RC create_index(Trx *trx, bool unique, const std::vector<const FieldMeta *> &field_metas, const char *index_name);
+  RC create_index(Trx *trx, bool unique, const std::vector<const FieldMeta *> &field_metas, const char *index_name,
+      IndexType index_type = IndexType::BPLUS_TREE);
 
   RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode);
 
@@ -91,17 +93,41 @@ public:
 
   RC sync();
 
+  /**
+   * @brief 页面日志重做完成后调用
+   * @details 重做日志时没有经过表，表上的B+树(聚簇数据和索引)要重新读取文件头
+   */
+  RC on_redo_done();
+
 private:
   RC insert_entry_of_indexes(const char *record, const RID &rid);
+  /// 索引比较多时，使用索引工作线程同时插入所有索引
+  RC parallel_insert_entry_of_indexes(const char *record, const RID &rid);
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
 
+  /**
+   * @brief 把表中的所有记录添加到批量构建器中
+   * @details 有索引工作线程时，把数据页面分成几段，每个线程扫描一段并生成各自的有序段
+   */
+  RC collect_index_keys(Trx *trx, BplusTreeBulkLoader &loader);
+
+  /// 两条记录的主键是否相同。聚簇存放的表不支持修改主键，没有主键时总是返回true
+  bool same_primary_key(const char *old_data, const char *new_data) const;
+
 private:
   RC init_record_handler(const char *base_dir);
 
 public:
   Index *find_index(const char *index_name) const;
+  /// 第一个字段是 field_name 的索引
   Index *find_index_by_field(const char *field_name) const;
 
+  /**
+   * @brief 估算表中有多少条记录，用于选择执行计划
+   * @details 数据文件的页面数乘以每个页面最多存放的记录数，不读取页面，是一个上限
+   */
+  int64_t estimated_record_num() const;
+
 private:
   Db                *db_ = nullptr;
   std::string             base_dir_;
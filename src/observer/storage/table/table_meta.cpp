@@ -17,12 +17,14 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "common/global_context.h"
 #include "storage/table/table_meta.h"
+#include "storage/index/bplus_tree.h"
 #include "storage/trx/trx.h"
 #include "json/json.h"
 
 static const Json::StaticString FIELD_TABLE_ID("table_id");
 static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_STORAGE_FORMAT("storage_format");
+static const Json::StaticString FIELD_PRIMARY_KEY("primary_key");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
 
@@ -32,6 +34,7 @@ TableMeta::TableMeta(const TableMeta &other)
       fields_(other.fields_),
       indexes_(other.indexes_),
       storage_format_(other.storage_format_),
+      primary_key_(other.primary_key_),
       record_size_(other.record_size_)
 {}
 
@@ -40,6 +43,7 @@ void TableMeta::swap(TableMeta &other) noexcept
   name_.swap(other.name_);
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
+  primary_key_.swap(other.primary_key_);
   std::swap(record_size_, other.record_size_);
 }
 
@@ -91,6 +95,12 @@ RC TableMeta::init(int32_t table_id, const char *name, const std::vector<FieldMe
 
   record_size_ = field_offset;
 
+  rc = init_primary_key(attributes, storage_format);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("invalid primary key. table name=%s, rc=%s", name, strrc(rc));
+    return rc;
+  }
+
   table_id_ = table_id;
   name_     = name;
   storage_format_ = storage_format;
@@ -98,6 +108,50 @@ RC TableMeta::init(int32_t table_id, const char *name, const std::vector<FieldMe
   return RC::SUCCESS;
 }
 
+RC TableMeta::init_primary_key(span<const AttrInfoSqlNode> attributes, StorageFormat storage_format)
+{
+  primary_key_.clear();
+  for (const AttrInfoSqlNode &attr_info : attributes) {
+    if (!attr_info.primary_key) {
+      continue;
+    }
+    if (!primary_key_.empty()) {
+      LOG_WARN("only one primary key column is supported. first=%s, second=%s",
+               primary_key_.c_str(), attr_info.name.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+    primary_key_ = attr_info.name;
+  }
+
+  if (storage_format != StorageFormat::CLUSTERED_FORMAT) {
+    if (!primary_key_.empty()) {
+      LOG_WARN("primary key is only supported by clustered tables. primary key=%s", primary_key_.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+    return RC::SUCCESS;
+  }
+
+  const FieldMeta *pk = primary_key();
+  if (nullptr == pk) {
+    LOG_WARN("clustered table requires a primary key");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 主键直接当做记录的RID使用，二级索引中存放的也就是主键。浮点数按照误差比较，不能作为主键
+  if (pk->type() == AttrType::FLOATS || pk->len() > static_cast<int>(sizeof(RID))) {
+    LOG_WARN("unsupported primary key. field=%s, type=%s, length=%d, max length=%d",
+             pk->name(), attr_type_to_string(pk->type()), pk->len(), static_cast<int>(sizeof(RID)));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (record_size_ > BplusTreeHandler::max_leaf_value_size(pk->len())) {
+    LOG_WARN("record is too large for clustered table. record size=%d, max size=%d",
+             record_size_, BplusTreeHandler::max_leaf_value_size(pk->len()));
+    return RC::INVALID_ARGUMENT;
+  }
+  return RC::SUCCESS;
+}
+
 RC TableMeta::add_index(const IndexMeta &index)
 {
   indexes_.push_back(index);
@@ -153,7 +207,9 @@ const IndexMeta *TableMeta::index(const char *name) const
 const IndexMeta *TableMeta::find_index_by_field(const char *field) const
 {
   for (const IndexMeta &index : indexes_) {
-    if (0 == strcmp(index.field().at(1).c_str(), field)) {
+    // 多字段索引的第一个字段是null位图，按照第一个用户指定的字段查找
+    const std::vector<std::string> &fields = index.field();
+    if (0 == strcmp(fields.at(fields.size() > 1 ? 1 : 0).c_str(), field)) {
       return &index;
     }
   }
@@ -168,12 +224,20 @@ int TableMeta::record_size() const { return record_size_; }
 
 const FieldMeta *TableMeta::null_field() const { return &fields_[0]; }
 
+const FieldMeta *TableMeta::primary_key() const
+{
+  return primary_key_.empty() ? nullptr : field(primary_key_.c_str());
+}
+
 int TableMeta::serialize(std::ostream &ss) const
 {
   Json::Value table_value;
   table_value[FIELD_TABLE_ID]   = table_id_;
   table_value[FIELD_TABLE_NAME] = name_;
   table_value[FIELD_STORAGE_FORMAT] = static_cast<int>(storage_format_);
+  if (!primary_key_.empty()) {
+    table_value[FIELD_PRIMARY_KEY] = primary_key_;
+  }
 
   Json::Value fields_value;
   for (const FieldMeta &field : fields_) {
@@ -245,6 +309,16 @@ int TableMeta::deserialize(std::istream &is)
 
   int32_t storage_format = storage_format_value.asInt();
 
+  std::string        primary_key;
+  const Json::Value &primary_key_value = table_value[FIELD_PRIMARY_KEY];
+  if (!primary_key_value.isNull()) {
+    if (!primary_key_value.isString()) {
+      LOG_ERROR("Invalid primary key. json value=%s", primary_key_value.toStyledString().c_str());
+      return -1;
+    }
+    primary_key = primary_key_value.asString();
+  }
+
   RC  rc        = RC::SUCCESS;
   int field_num = fields_value.size();
 
@@ -265,6 +339,7 @@ int TableMeta::deserialize(std::istream &is)
 
   table_id_ = table_id;
   storage_format_ = static_cast<StorageFormat>(storage_format);
+  primary_key_.swap(primary_key);
   name_.swap(table_name);
   fields_.swap(fields);
   record_size_ = fields_.back().offset() + fields_.back().len() - fields_.begin()->offset();
@@ -317,6 +392,9 @@ void TableMeta::desc(std::ostream &os) const
     index.desc(os);
     os << std::endl;
   }
+  if (!primary_key_.empty()) {
+    os << "\tprimary key(" << primary_key_ << ')' << std::endl;
+  }
   os << ')' << std::endl;
 }
 
@@ -47,6 +47,8 @@ public:
   const FieldMeta    *field(int index) const;
   const FieldMeta    *field(const char *name) const;
   const FieldMeta    *null_field() const;
+  /// 主键字段，没有主键时返回nullptr。只有聚簇存放(CLUSTERED_FORMAT)的表有主键
+  const FieldMeta    *primary_key() const;
   const FieldMeta    *find_field_by_offset(int offset) const;
   auto                field_metas() const -> const std::vector<FieldMeta>                *{ return &fields_; }
   auto                trx_fields() const -> std::span<const FieldMeta>;
@@ -70,6 +72,10 @@ public:
   void to_string(std::string &output) const override;
   void desc(std::ostream &os) const;
 
+private:
+  /// 记录主键字段并检查聚簇表的主键是否合法
+  RC init_primary_key(std::span<const AttrInfoSqlNode> attributes, StorageFormat storage_format);
+
 protected:
   int32_t                table_id_ = -1;
   std::string            name_;
@@ -77,6 +83,7 @@ protected:
   std::vector<FieldMeta> fields_;  
   std::vector<IndexMeta> indexes_;
   StorageFormat          storage_format_;
+  std::string            primary_key_;  ///< 主键字段的名字，没有主键时为空
 
   int record_size_ = 0;
 };
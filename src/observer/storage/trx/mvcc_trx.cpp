@@ -44,6 +44,15 @@ const vector<FieldMeta> *MvccTrxKit::trx_fields() const { return &fields_; }
 
 int32_t MvccTrxKit::next_trx_id() { return ++current_trx_id_; }
 
+void MvccTrxKit::update_trx_id(int32_t trx_id)
+{
+  lock_.lock();
+  if (current_trx_id_ < trx_id) {
+    current_trx_id_ = trx_id;
+  }
+  lock_.unlock();
+}
+
 int32_t MvccTrxKit::max_trx_id() const { return numeric_limits<int32_t>::max(); }
 
 Trx *MvccTrxKit::create_trx(LogHandler &log_handler)
@@ -111,6 +120,34 @@ LogReplayer *MvccTrxKit::create_log_replayer(Db &db, LogHandler &log_handler)
   return new MvccTrxLogReplayer(db, *this, log_handler);
 }
 
+void MvccTrxKit::checkpoint_info(LogHandler &log_handler, LSN &lsn, int32_t &max_trx_id)
+{
+  lock_.lock();
+  lsn = log_handler.current_lsn();
+  for (Trx *trx : trxes_) {
+    LSN first_lsn = static_cast<MvccTrx *>(trx)->first_lsn_;
+    if (first_lsn > 0 && first_lsn < lsn) {
+      lsn = first_lsn;
+    }
+  }
+  max_trx_id = current_trx_id_;
+  lock_.unlock();
+}
+
+void MvccTrxKit::begin_modify(MvccTrx &trx, LogHandler &log_handler)
+{
+  lock_.lock();
+  trx.first_lsn_ = log_handler.current_lsn() + 1;
+  lock_.unlock();
+}
+
+void MvccTrxKit::end_modify(MvccTrx &trx)
+{
+  lock_.lock();
+  trx.first_lsn_ = 0;
+  lock_.unlock();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 MvccTrx::MvccTrx(MvccTrxKit &kit, LogHandler &log_handler) : trx_kit_(kit), log_handler_(log_handler)
@@ -134,6 +171,10 @@ RC MvccTrx::insert_record(Table *table, Record &record)
   begin_field.set_int(record, -trx_id_);
   end_field.set_int(record, trx_kit_.max_trx_id());
 
+  if (first_lsn_ == 0 && !recovering_) {
+    trx_kit_.begin_modify(*this, log_handler_.log_handler());
+  }
+
   RC rc = table->insert_record(record);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to insert record into table. rc=%s", strrc(rc));
@@ -156,6 +197,10 @@ RC MvccTrx::delete_record(Table *table, Record &record)
 
   RC delete_result = RC::SUCCESS;
 
+  if (first_lsn_ == 0 && !recovering_) {
+    trx_kit_.begin_modify(*this, log_handler_.log_handler());
+  }
+
   RC rc = table->visit_record(record.rid(), [this, table, &delete_result, &end_field](Record &inplace_record) -> bool {
     RC rc = this->visit_record(table, inplace_record, ReadWriteMode::READ_WRITE);
     if (OB_FAIL(rc)) {
@@ -241,6 +286,40 @@ RC MvccTrx::visit_record(Table *table, Record &record, ReadWriteMode mode)
   return rc;
 }
 
+bool MvccTrx::page_all_visible(Table *table, PageNum page_num)
+{
+  RecordFileHandler *record_handler = table->record_handler();
+  if (record_handler->clustered_handler() != nullptr) {
+    // 聚簇存放的记录没有页面可见性标记，RID也不是页面编号
+    return false;
+  }
+
+  int32_t visible_from = 0;
+  if (!record_handler->visibility_map().get(page_num, visible_from)) {
+    Field begin_field;
+    Field end_field;
+    trx_fields(table, begin_field, end_field);
+
+    // 已经提交并且没有删除的记录，begin xid 是提交时的事务号，end xid 是最大值
+    auto record_visible_from = [&begin_field, &end_field, this](const Record &record) -> int32_t {
+      const int32_t begin_xid = begin_field.get_int(record);
+      const int32_t end_xid   = end_field.get_int(record);
+      if (begin_xid <= 0 || end_xid != trx_kit_.max_trx_id()) {
+        return VisibilityMap::NEVER_ALL_VISIBLE;
+      }
+      return begin_xid;
+    };
+
+    RC rc = record_handler->refresh_visibility(page_num, record_visible_from, visible_from);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to refresh page visibility. table=%s, page num=%d, rc=%s", table->name(), page_num, strrc(rc));
+      return false;
+    }
+  }
+
+  return trx_id_ >= visible_from;
+}
+
 /**
  * @brief 获取指定表上的事务使用的字段
  *
@@ -340,6 +419,9 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
   }
 
   operations_.clear();
+  if (first_lsn_ != 0) {
+    trx_kit_.end_modify(*this);
+  }
 
   LOG_TRACE("append trx commit log. trx id=%d, commit_xid=%d, rc=%s", trx_id_, commit_xid, strrc(rc));
   return rc;
@@ -419,6 +501,9 @@ RC MvccTrx::rollback()
   if (!recovering_) {
     rc = log_handler_.rollback(trx_id_);
   }
+  if (first_lsn_ != 0) {
+    trx_kit_.end_modify(*this);
+  }
   LOG_TRACE("append trx rollback log. trx id=%d, rc=%s", trx_id_, strrc(rc));
   return rc;
 }
@@ -464,9 +549,11 @@ RC MvccTrx::redo(Db *db, const LogEntry &log_entry)
     } break;
 
     case MvccTrxLogOperation::Type::COMMIT: {
-      // auto *trx_log_record = reinterpret_cast<const MvccTrxCommitLogEntry *>(log_entry.data());
+      auto *trx_log_record = reinterpret_cast<const MvccTrxCommitLogEntry *>(log_entry.data());
       // commit_with_trx_id(trx_log_record->commit_trx_id);
       // 遇到了提交日志，说明前面的记录都已经提交成功了
+      // 提交ID与事务ID是同一个序列分配的，恢复后新的事务ID必须比它大，否则看不到这个事务提交的数据
+      trx_kit_.update_trx_id(trx_log_record->commit_trx_id);
     } break;
 
     case MvccTrxLogOperation::Type::ROLLBACK: {
@@ -41,9 +41,26 @@ public:
 
   LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) override;
 
+  void checkpoint_info(LogHandler &log_handler, LSN &lsn, int32_t &max_trx_id) override;
+
 public:
   int32_t next_trx_id();
 
+  /**
+   * @brief 保证后面分配的事务ID都比trx_id大
+   * @details 恢复时使用，日志中的事务ID与提交ID都不能再被分配
+   */
+  void update_trx_id(int32_t trx_id) override;
+
+  /**
+   * @brief 事务第一次修改数据之前调用，记录事务第一条日志可能的LSN
+   * @details 与 checkpoint_info 使用同一把锁，保证检查点要么看到这个事务，要么事务的日志都在检查点之后
+   */
+  void begin_modify(MvccTrx &trx, LogHandler &log_handler);
+
+  /// @brief 事务提交或回滚的日志写完之后调用，之后检查点就不用再考虑这个事务了
+  void end_modify(MvccTrx &trx);
+
 public:
   int32_t max_trx_id() const;
 
@@ -73,6 +90,12 @@ public:
   
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
 
+  /**
+   * @brief 使用页面的可见性标记判断，标记未知时检查页面上所有的记录
+   * @details 页面上的记录都已经提交并且没有删除时，对事务号不小于最大的 begin xid 的事务都可见
+   */
+  bool page_all_visible(Table *table, PageNum page_num) override;
+
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -92,8 +115,11 @@ private:
   // using OperationSet = unordered_set<Operation, OperationHasher, OperationEqualer>;
   using OperationSet = vector<Operation>;
 
+  friend class MvccTrxKit;
+
   MvccTrxKit       &trx_kit_;
   MvccTrxLogHandler log_handler_;
+  LSN               first_lsn_  = 0;  ///< 事务第一条日志的LSN(不会更大)，没有修改过数据时是0。由 MvccTrxKit::lock_ 保护
   int32_t           trx_id_     = -1;
   bool              started_    = false;
   bool              recovering_ = false;
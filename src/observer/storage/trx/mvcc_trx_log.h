@@ -107,6 +107,8 @@ public:
 
   RC rollback(int32_t trx_id);
 
+  LogHandler &log_handler() { return log_handler_; }
+
 private:
   LogHandler &log_handler_;
 };
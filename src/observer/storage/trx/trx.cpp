@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "storage/field/field.h"
+#include "storage/clog/log_handler.h"
 #include "storage/field/field_meta.h"
 #include "storage/record/record_manager.h"
 #include "storage/table/table.h"
@@ -45,3 +46,9 @@ TrxKit *TrxKit::create(const char *name)
   
   return trx_kit;
 }
+
+void TrxKit::checkpoint_info(LogHandler &log_handler, LSN &lsn, int32_t &max_trx_id)
+{
+  lsn        = log_handler.current_lsn();
+  max_trx_id = 0;
+}
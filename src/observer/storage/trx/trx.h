@@ -129,6 +129,21 @@ public:
 
   virtual LogReplayer *create_log_replayer(Db &db, LogHandler &log_handler) = 0;
 
+  /**
+   * @brief 做检查点时获取事务相关的信息
+   * @details 检查点不能跨过活跃事务的第一条日志，否则重启时只能看到事务的一部分日志。
+   * @param log_handler 事务使用的日志处理器
+   * @param[out] lsn 当前的LSN与所有活跃事务第一条日志LSN中最小的那个
+   * @param[out] max_trx_id 当前已经分配的最大事务ID，需要与检查点一起持久化
+   */
+  virtual void checkpoint_info(LogHandler &log_handler, LSN &lsn, int32_t &max_trx_id);
+
+  /**
+   * @brief 保证后面分配的事务ID都比trx_id大
+   * @details 恢复时使用，日志中以及检查点中的事务ID都不能再被分配
+   */
+  virtual void update_trx_id(int32_t trx_id) {}
+
 public:
   static TrxKit *create(const char *name);
 };
@@ -147,6 +162,12 @@ public:
   virtual RC delete_record(Table *table, Record &record)                    = 0;
   virtual RC visit_record(Table *table, Record &record, ReadWriteMode mode) = 0;
 
+  /**
+   * @brief 不读取记录，判断页面上的所有记录是否都对当前事务可见
+   * @details 只扫描索引的查询使用。返回false时调用者需要读取记录再调用 visit_record 判断
+   */
+  virtual bool page_all_visible(Table *table, PageNum page_num) { return false; }
+
   virtual RC start_if_need() = 0;
   virtual RC commit()        = 0;
   virtual RC rollback()      = 0;
@@ -47,6 +47,7 @@ public:
   RC insert_record(Table *table, Record &record) override;
   RC delete_record(Table *table, Record &record) override;
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
+  bool page_all_visible(Table *table, PageNum page_num) override { return true; }
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <chrono>
 #include <iostream>
+#include <map>
 
 #include "gtest/gtest.h"
 #include "sql/expr/aggregate_hash_table.h"
@@ -103,79 +104,223 @@ TEST(AggregateHashTableTest, standard_hash_table)
   }
 }
 
-#ifdef USE_SIMD
-TEST(AggregateHashTableTest, DISABLED_linear_probing_hash_table)
+TEST(AggregateHashTableTest, standard_hash_table_aggregates)
 {
-  // simple case
-  {
-    Chunk                   group_chunk;
-    Chunk                   aggr_chunk;
-    std::unique_ptr<Column> column1 = std::make_unique<Column>(AttrType::INTS, 4);
-    std::unique_ptr<Column> column2 = std::make_unique<Column>(AttrType::INTS, 4);
-    for (int i = 0; i < 1023; i++) {
-      int key = i % 8;
-      column1->append_one((char *)&key);
-      column2->append_one((char *)&i);
+  // 分组字段是 (char(8), int)，聚合 sum/count/min/max/avg，分组足够多，需要多次扩容，分多个 chunk 添加
+  const int group_num = 20000;
+  const int row_num   = 100000;
+
+  AggregateExpr sum_expr(AggrFuncType::SUM, nullptr);
+  AggregateExpr count_expr(AggrFuncType::COUNT, nullptr);
+  AggregateExpr min_expr(AggrFuncType::MIN, nullptr);
+  AggregateExpr max_expr(AggrFuncType::MAX, nullptr);
+  AggregateExpr avg_expr(AggrFuncType::AVG, nullptr);
+  std::vector<Expression *> aggregate_exprs = {&sum_expr, &count_expr, &min_expr, &max_expr, &avg_expr};
+  StandardAggregateHashTable hash_table(aggregate_exprs);
+
+  std::map<std::pair<std::string, int>, std::vector<int>> expected;
+  for (int begin = 0; begin < row_num; begin += 8192) {
+    Chunk group_chunk;
+    Chunk aggr_chunk;
+    auto  group1 = std::make_unique<Column>(AttrType::CHARS, 8);
+    auto  group2 = std::make_unique<Column>(AttrType::INTS, 4);
+    std::vector<std::unique_ptr<Column>> aggrs;
+    for (int i = 0; i < 5; i++) {
+      aggrs.push_back(std::make_unique<Column>(i == 4 ? AttrType::FLOATS : AttrType::INTS, 4));
     }
-    group_chunk.add_column(std::move(column1), 0);
-    aggr_chunk.add_column(std::move(column2), 1);
 
-    auto linear_probing_hash_table = std::make_unique<LinearProbingAggregateHashTable<int>>(AggregateExpr::Type::SUM);
-    RC   rc                        = linear_probing_hash_table->add_chunk(group_chunk, aggr_chunk);
-    ASSERT_EQ(rc, RC::SUCCESS);
+    for (int r = begin; r < std::min(row_num, begin + 8192); r++) {
+      const int   group = (r * 7919) % group_num;
+      std::string name  = "g" + std::to_string(group % 100);
+      char        name_buffer[8];
+      memset(name_buffer, 'x', sizeof(name_buffer));  // '\0' 后面的字节不影响分组
+      memcpy(name_buffer, name.c_str(), name.size() + 1);
+      int key = group / 100;
+      group1->append_one(name_buffer);
+      group2->append_one((char *)&key);
+
+      int   value       = r % 1000 - 500;
+      float float_value = value + 0.5f;
+      for (int i = 0; i < 4; i++) {
+        aggrs[i]->append_one((char *)&value);
+      }
+      aggrs[4]->append_one((char *)&float_value);
+      expected[{name, key}].push_back(value);
+    }
+
+    group_chunk.add_column(std::move(group1), 0);
+    group_chunk.add_column(std::move(group2), 1);
+    for (int i = 0; i < 5; i++) {
+      aggr_chunk.add_column(std::move(aggrs[i]), i);
+    }
+    ASSERT_EQ(RC::SUCCESS, hash_table.add_chunk(group_chunk, aggr_chunk));
+  }
+  ASSERT_EQ(group_num, hash_table.size());
+
+  StandardAggregateHashTable::Scanner scanner(&hash_table);
+  scanner.open_scan();
+  int rows = 0;
+  while (true) {
     Chunk output_chunk;
-    output_chunk.add_column(
-        make_unique<Column>(group_chunk.column(0).attr_type(), group_chunk.column(0).attr_len()), 0);
-    output_chunk.add_column(make_unique<Column>(aggr_chunk.column(0).attr_type(), aggr_chunk.column(0).attr_len()), 1);
-    LinearProbingAggregateHashTable<int>::Scanner scanner(linear_probing_hash_table.get());
-    scanner.open_scan();
-    rc = scanner.next(output_chunk);
-    ASSERT_EQ(rc, RC::SUCCESS);
-    ASSERT_EQ(output_chunk.rows(), 8);
-    for (int i = 0; i < 8; i++) {
-      std::cout << "column1: " << output_chunk.get_value(1, i).get_string() << " "
-                << "sum(column2)" << output_chunk.get_value(0, i).get_string() << std::endl;
+    output_chunk.add_column(make_unique<Column>(AttrType::CHARS, 8), 0);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 1);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 2);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 3);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 4);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 5);
+    output_chunk.add_column(make_unique<Column>(AttrType::DOUBLES, 8), 6);
+    RC rc = scanner.next(output_chunk);
+    if (rc == RC::RECORD_EOF) {
+      break;
+    }
+    ASSERT_EQ(RC::SUCCESS, rc);
+    ASSERT_LE(output_chunk.rows(), output_chunk.capacity());
+
+    for (int r = 0; r < output_chunk.rows(); r++) {
+      std::string name(output_chunk.column(0).data() + r * 8);
+      int         key = output_chunk.get_value(1, r).get_int();
+      auto        it  = expected.find({name, key});
+      ASSERT_NE(it, expected.end()) << name << "," << key;
+
+      const std::vector<int> &values = it->second;
+      int64_t                 sum    = 0;
+      for (int value : values) {
+        sum += value;
+      }
+      ASSERT_EQ(sum, output_chunk.get_value(2, r).get_int());
+      ASSERT_EQ(static_cast<int>(values.size()), output_chunk.get_value(3, r).get_int());
+      ASSERT_EQ(*std::min_element(values.begin(), values.end()), output_chunk.get_value(4, r).get_int());
+      ASSERT_EQ(*std::max_element(values.begin(), values.end()), output_chunk.get_value(5, r).get_int());
+      ASSERT_DOUBLE_EQ(static_cast<double>(sum) / values.size() + 0.5, output_chunk.get_value(6, r).get_double());
+      expected.erase(it);
+      rows++;
     }
   }
+  scanner.close_scan();
+  ASSERT_EQ(group_num, rows);
+  ASSERT_TRUE(expected.empty());
+}
 
-  // hash conflict
-  {
-    Chunk                   group_chunk;
-    Chunk                   aggr_chunk;
-    std::unique_ptr<Column> column1 = std::make_unique<Column>(AttrType::INTS, 4);
-    std::unique_ptr<Column> column2 = std::make_unique<Column>(AttrType::INTS, 4);
-    for (int i = 0; i < 1002; i++) {
-      int key, value = 1;
-      if (i % 2 == 0) {
-        key = 1;
-      } else {
-        key = 257;
+/**
+ * @brief 使用 (key, SUM, COUNT, MIN, MAX, AVG) 聚合 row_num 行，与 std::map 的结果比较
+ * @details 分组 0 的键值是 numeric_limits<K>::min()，也就是哈希表中表示空槽的值
+ */
+template <typename K>
+void check_linear_probing_hash_table(int row_num, int group_num, int capacity)
+{
+  constexpr AttrType key_type = sizeof(K) == sizeof(int32_t) ? AttrType::INTS : AttrType::LONGS;
+
+  AggregateExpr        sum_expr(AggrFuncType::SUM, nullptr);
+  AggregateExpr        count_expr(AggrFuncType::COUNT, nullptr);
+  AggregateExpr        min_expr(AggrFuncType::MIN, nullptr);
+  AggregateExpr        max_expr(AggrFuncType::MAX, nullptr);
+  AggregateExpr        avg_expr(AggrFuncType::AVG, nullptr);
+  vector<Expression *> aggregate_exprs = {&sum_expr, &count_expr, &min_expr, &max_expr, &avg_expr};
+
+  LinearProbingAggregateHashTable<K> hash_table(aggregate_exprs, capacity);
+
+  std::map<K, std::vector<int>> expected;
+  for (int begin = 0; begin < row_num; begin += 8192) {
+    Chunk group_chunk;
+    Chunk aggr_chunk;
+    auto  group = std::make_unique<Column>(key_type, sizeof(K));
+    std::vector<std::unique_ptr<Column>> aggrs;
+    for (int i = 0; i < 5; i++) {
+      aggrs.push_back(std::make_unique<Column>(i == 4 ? AttrType::FLOATS : AttrType::INTS, 4));
+    }
+
+    for (int r = begin; r < std::min(row_num, begin + 8192); r++) {
+      const int g   = static_cast<int>((r * 7919L) % group_num);
+      K         key = g == 0 ? std::numeric_limits<K>::min() : static_cast<K>(g) * 257;
+      if constexpr (sizeof(K) == sizeof(int64_t)) {
+        key = g == 0 ? key : key << 32 | g;  // 高32位和低32位都不相同
       }
+      group->append_one((char *)&key);
 
-      column1->append_one((char *)&key);
-      column2->append_one((char *)&value);
+      int   value       = r % 1000 - 500;
+      float float_value = value + 0.5f;
+      for (int i = 0; i < 4; i++) {
+        aggrs[i]->append_one((char *)&value);
+      }
+      aggrs[4]->append_one((char *)&float_value);
+      expected[key].push_back(value);
     }
-    group_chunk.add_column(std::move(column1), 0);
-    aggr_chunk.add_column(std::move(column2), 1);
 
-    auto linear_probing_hash_table =
-        std::make_unique<LinearProbingAggregateHashTable<int>>(AggregateExpr::Type::SUM, 256);
-    RC rc = linear_probing_hash_table->add_chunk(group_chunk, aggr_chunk);
-    ASSERT_EQ(rc, RC::SUCCESS);
+    group_chunk.add_column(std::move(group), 0);
+    for (int i = 0; i < 5; i++) {
+      aggr_chunk.add_column(std::move(aggrs[i]), i + 1);
+    }
+    ASSERT_EQ(RC::SUCCESS, hash_table.add_chunk(group_chunk, aggr_chunk));
+  }
+  ASSERT_EQ(group_num, hash_table.size());
+
+  typename LinearProbingAggregateHashTable<K>::Scanner scanner(&hash_table);
+  scanner.open_scan();
+  int rows = 0;
+  while (true) {
     Chunk output_chunk;
-    output_chunk.add_column(
-        make_unique<Column>(group_chunk.column(0).attr_type(), group_chunk.column(0).attr_len()), 0);
-    output_chunk.add_column(make_unique<Column>(aggr_chunk.column(0).attr_type(), aggr_chunk.column(0).attr_len()), 1);
-    LinearProbingAggregateHashTable<int>::Scanner scanner(linear_probing_hash_table.get());
-    scanner.open_scan();
-    rc = scanner.next(output_chunk);
-    ASSERT_EQ(rc, RC::SUCCESS);
-    ASSERT_EQ(output_chunk.rows(), 2);
-    ASSERT_STREQ(output_chunk.get_value(1, 0).get_string().c_str(), "501");
-    ASSERT_STREQ(output_chunk.get_value(1, 1).get_string().c_str(), "501");
+    output_chunk.add_column(make_unique<Column>(key_type, sizeof(K)), 0);
+    output_chunk.add_column(make_unique<Column>(AttrType::LONGS, 8), 1);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 2);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 3);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 4);
+    output_chunk.add_column(make_unique<Column>(AttrType::DOUBLES, 8), 5);
+    RC rc = scanner.next(output_chunk);
+    if (rc == RC::RECORD_EOF) {
+      break;
+    }
+    ASSERT_EQ(RC::SUCCESS, rc);
+
+    for (int r = 0; r < output_chunk.rows(); r++) {
+      const K key = reinterpret_cast<const K *>(output_chunk.column(0).data())[r];
+      auto    it  = expected.find(key);
+      ASSERT_NE(it, expected.end()) << key;
+
+      const std::vector<int> &values = it->second;
+      int64_t                 sum    = 0;
+      for (int value : values) {
+        sum += value;
+      }
+      ASSERT_EQ(sum, reinterpret_cast<const int64_t *>(output_chunk.column(1).data())[r]);
+      ASSERT_EQ(static_cast<int>(values.size()), output_chunk.get_value(2, r).get_int());
+      ASSERT_EQ(*std::min_element(values.begin(), values.end()), output_chunk.get_value(3, r).get_int());
+      ASSERT_EQ(*std::max_element(values.begin(), values.end()), output_chunk.get_value(4, r).get_int());
+      ASSERT_DOUBLE_EQ(static_cast<double>(sum) / values.size() + 0.5, output_chunk.get_value(5, r).get_double());
+      expected.erase(it);
+      rows++;
+    }
+  }
+  scanner.close_scan();
+  ASSERT_EQ(group_num, rows);
+  ASSERT_TRUE(expected.empty());
+}
+
+TEST(AggregateHashTableTest, linear_probing_hash_table)
+{
+  // 分别使用 AVX2 和标量的实现，CPU 不支持 AVX2 时两次都是标量的实现
+  for (bool simd : {true, false}) {
+    set_simd_enabled(simd);
+    // 分组很少
+    check_linear_probing_hash_table<int32_t>(1023, 8, 16384);
+    // 初始的槽很少，多次扩容，探测的距离很长
+    check_linear_probing_hash_table<int32_t>(50000, 20000, 16);
+    check_linear_probing_hash_table<int64_t>(1023, 8, 16384);
+    check_linear_probing_hash_table<int64_t>(50000, 20000, 16);
   }
+  set_simd_enabled(true);
+}
+
+TEST(AggregateHashTableTest, linear_probing_hash_table_invalid_argument)
+{
+  AggregateExpr                            sum_expr(AggrFuncType::SUM, nullptr);
+  LinearProbingAggregateHashTable<int32_t> hash_table({&sum_expr});
+
+  Chunk group_chunk;
+  Chunk aggr_chunk;
+  group_chunk.add_column(std::make_unique<Column>(AttrType::LONGS, 8), 0);
+  aggr_chunk.add_column(std::make_unique<Column>(AttrType::INTS, 4), 1);
+  ASSERT_EQ(RC::INVALID_ARGUMENT, hash_table.add_chunk(group_chunk, aggr_chunk));
 }
-#endif
 
 int main(int argc, char **argv)
 {
@@ -9,6 +9,7 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include <memory>
+#include <tuple>
 
 #include "sql/expr/arithmetic_operator.hpp"
 #include "gtest/gtest.h"
@@ -83,8 +84,7 @@ TEST(ArithmeticTest, arithmetic_test)
       ASSERT_EQ(result[i], -1);
     }
   }
-// sum
-#ifdef USE_SIMD
+  // sum
   {
     int              size = 100;
     std::vector<int> a(size, 0);
@@ -103,7 +103,66 @@ TEST(ArithmeticTest, arithmetic_test)
     int res = mm256_sum_ps(a.data(), size);
     ASSERT_FLOAT_EQ(res, 4950.0);
   }
-#endif
+}
+
+// 分别使用 AVX2 和标量的实现计算，结果应该相同。长度不是 SIMD 宽度的整数倍，最后几个值由标量处理
+TEST(ArithmeticTest, simd_and_scalar)
+{
+  const int          size = 1003;
+  std::vector<int>   int_left(size), int_right(size);
+  std::vector<float> float_left(size), float_right(size);
+  for (int i = 0; i < size; i++) {
+    int_left[i]    = i * 37 % 101 - 50;
+    int_right[i]   = i * 13 % 97 - 48;
+    float_left[i]  = int_left[i] * 0.25f;
+    float_right[i] = int_right[i] * 0.5f;
+  }
+
+  auto run = [&](bool simd) {
+    set_simd_enabled(simd);
+    std::vector<int>     ints;
+    std::vector<float>   floats;
+    std::vector<uint8_t> compares;
+
+    std::vector<int>   int_result(size);
+    std::vector<float> float_result(size);
+    binary_operator<false, false, int, AddOperator>(int_left.data(), int_right.data(), int_result.data(), size);
+    ints.insert(ints.end(), int_result.begin(), int_result.end());
+    binary_operator<false, true, int, SubtractOperator>(int_left.data(), int_right.data(), int_result.data(), size);
+    ints.insert(ints.end(), int_result.begin(), int_result.end());
+    binary_operator<true, false, int, MultiplyOperator>(int_left.data(), int_right.data(), int_result.data(), size);
+    ints.insert(ints.end(), int_result.begin(), int_result.end());
+    binary_operator<false, false, float, SubtractOperator>(
+        float_left.data(), float_right.data(), float_result.data(), size);
+    floats.insert(floats.end(), float_result.begin(), float_result.end());
+    binary_operator<false, false, float, MultiplyOperator>(
+        float_left.data(), float_right.data(), float_result.data(), size);
+    floats.insert(floats.end(), float_result.begin(), float_result.end());
+
+    for (CompOp op : {CompOp::EQUAL_TO,
+             CompOp::NOT_EQUAL,
+             CompOp::LESS_THAN,
+             CompOp::LESS_EQUAL,
+             CompOp::GREAT_THAN,
+             CompOp::GREAT_EQUAL}) {
+      std::vector<uint8_t> int_compare(size, 1);
+      std::vector<uint8_t> float_compare(size, 1);
+      compare_result<int, false, false>(int_left.data(), int_right.data(), size, int_compare, op);
+      compare_result<float, false, true>(float_left.data(), float_right.data(), size, float_compare, op);
+      compares.insert(compares.end(), int_compare.begin(), int_compare.end());
+      compares.insert(compares.end(), float_compare.begin(), float_compare.end());
+    }
+    ints.push_back(mm256_sum_epi32(int_left.data(), size));
+    floats.push_back(mm256_sum_ps(float_left.data(), size));
+    return std::make_tuple(ints, floats, compares);
+  };
+
+  auto simd_result   = run(true);
+  auto scalar_result = run(false);
+  set_simd_enabled(true);
+  ASSERT_EQ(std::get<0>(simd_result), std::get<0>(scalar_result));
+  ASSERT_EQ(std::get<1>(simd_result), std::get<1>(scalar_result));
+  ASSERT_EQ(std::get<2>(simd_result), std::get<2>(scalar_result));
 }
 
 int main(int argc, char **argv)
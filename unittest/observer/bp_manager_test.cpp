@@ -13,6 +13,12 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/chrono.h"
+#include "common/lang/random.h"
+#include "common/lang/thread.h"
 #include "gtest/gtest.h"
 
 void test_get(BPFrameManager &frame_manager)
@@ -125,6 +131,247 @@ TEST(test_frame_manager, test_frame_manager_simple_lru)
   frame_manager.cleanup();
 }
 
+TEST(test_frame_manager, test_frame_manager_concurrent_get)
+{
+  // 多个线程并发地获取页面，检查获取到的页面以及命中次数是否正确。吞吐量参考 benchmark/buffer_pool_concurrency_test
+  BPFrameManager frame_manager("Test");
+  frame_manager.init(2);
+
+  const int buffer_pool_id = 0;
+  const int page_num       = 200;
+  for (PageNum i = 0; i < page_num; i++) {
+    Frame *frame = frame_manager.alloc(buffer_pool_id, i);
+    ASSERT_NE(frame, nullptr);
+    frame->unpin();
+  }
+
+  const int get_per_thread = 20000;
+  for (int thread_num : {1, 2, 4, 8}) {
+    atomic<int> error_count{0};
+    BPFrameStat stat_before = frame_manager.stat();
+
+    vector<thread> threads;
+    for (int t = 0; t < thread_num; t++) {
+      threads.emplace_back([&frame_manager, &error_count, t]() {
+        mt19937 random(t);
+        for (int i = 0; i < get_per_thread; i++) {
+          PageNum page_num_to_get = random() % page_num;
+          Frame  *frame           = frame_manager.get(buffer_pool_id, page_num_to_get);
+          if (frame == nullptr || frame->page_num() != page_num_to_get) {
+            error_count++;
+            continue;
+          }
+          frame->unpin();
+        }
+      });
+    }
+    for (thread &t : threads) {
+      t.join();
+    }
+
+    ASSERT_EQ(error_count.load(), 0);
+
+    // 所有页面都在内存中，每次获取都应该命中
+    BPFrameStat stat_after = frame_manager.stat();
+    ASSERT_EQ(static_cast<uint64_t>(thread_num * get_per_thread), stat_after.hit_count - stat_before.hit_count);
+    ASSERT_EQ(stat_before.miss_count, stat_after.miss_count);
+  }
+
+  // 所有的页面都已经unpin了，可以全部淘汰
+  ASSERT_EQ(page_num, frame_manager.purge_frames(page_num, [](Frame *) { return RC::SUCCESS; }));
+  ASSERT_EQ(0, frame_manager.frame_num());
+  ASSERT_EQ(static_cast<uint64_t>(page_num), frame_manager.stat().evict_count);
+  frame_manager.cleanup();
+}
+
+TEST(test_frame_manager, test_frame_manager_lru_k)
+{
+  // 先访问一些热点页面两次，再像全表扫描一样访问一批页面一次
+  BPFrameManager frame_manager("Test");
+  frame_manager.init(1);
+
+  const int buffer_pool_id = 0;
+  const int hot_num        = 32;
+  const int scan_num       = 64;
+  for (PageNum i = 0; i < hot_num; i++) {
+    Frame *frame = frame_manager.alloc(buffer_pool_id, i);
+    ASSERT_NE(frame, nullptr);
+    frame->unpin();
+  }
+
+  // 间隔太短的两次访问只算作一次
+  this_thread::sleep_for(chrono::milliseconds(5));
+  for (PageNum i = 0; i < hot_num; i++) {
+    Frame *frame = frame_manager.get(buffer_pool_id, i);
+    ASSERT_NE(frame, nullptr);
+    frame->access();
+    frame->unpin();
+  }
+
+  auto scan = [&frame_manager]() {
+    for (PageNum i = hot_num; i < hot_num + scan_num; i++) {
+      Frame *frame = frame_manager.alloc(buffer_pool_id, i);
+      ASSERT_NE(frame, nullptr);
+      frame->unpin();
+    }
+  };
+  scan();
+
+  // LRU-K 淘汰的是扫描的页面，热点页面都还在
+  ASSERT_EQ(BPReplacePolicy::LRU_K, frame_manager.replace_policy());
+  ASSERT_EQ(scan_num, frame_manager.purge_frames(scan_num, [](Frame *) { return RC::SUCCESS; }));
+  for (PageNum i = 0; i < hot_num; i++) {
+    Frame *frame = frame_manager.get(buffer_pool_id, i);
+    ASSERT_NE(frame, nullptr);
+    frame->unpin();
+  }
+
+  // LRU 淘汰的是最近访问时间最早的热点页面
+  scan();
+  frame_manager.set_replace_policy(BPReplacePolicy::LRU);
+  ASSERT_EQ(hot_num, frame_manager.purge_frames(hot_num, [](Frame *) { return RC::SUCCESS; }));
+  for (PageNum i = 0; i < hot_num; i++) {
+    ASSERT_EQ(nullptr, frame_manager.get(buffer_pool_id, i));
+  }
+
+  BPFrameStat stat = frame_manager.stat();
+  ASSERT_EQ(stat.hit_count, static_cast<uint64_t>(hot_num * 2));
+  ASSERT_EQ(stat.miss_count, static_cast<uint64_t>(hot_num));
+  ASSERT_EQ(stat.evict_count, static_cast<uint64_t>(scan_num + hot_num));
+
+  ASSERT_EQ(scan_num, frame_manager.purge_frames(scan_num, [](Frame *) { return RC::SUCCESS; }));
+  frame_manager.cleanup();
+}
+
+TEST(test_buffer_pool, test_buffer_pool_cleaner)
+{
+  // 申请比内存能放下的多得多的页面，修改后再读出来检查，同时检查清理线程是否在工作
+  VacuousLogHandler log_handler;
+  const char       *file_name = "bp_manager_test_cleaner.bp";
+  ::remove(file_name);
+
+  const int         frame_num   = DEFAULT_ITEM_NUM_PER_POOL;
+  const int         free_frames = 32;
+  BufferPoolManager bpm(frame_num * BP_PAGE_SIZE);
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  bpm.set_cleaner_options(free_frames, 10 /*interval_ms*/);
+  ASSERT_EQ(RC::SUCCESS, bpm.start_cleaner());
+
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, file_name, bp));
+
+  const int       page_num = frame_num * 4;
+  vector<PageNum> page_nums;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    frame->write_latch();
+    snprintf(frame->data(), BP_PAGE_DATA_SIZE, "page %d", frame->page_num());
+    frame->mark_dirty();
+    frame->write_unlatch();
+    page_nums.push_back(frame->page_num());
+    bp->unpin_page(frame);
+  }
+
+  for (PageNum page_num : page_nums) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+    ASSERT_EQ(string("page ") + std::to_string(page_num), string(frame->data()));
+    bp->unpin_page(frame);
+  }
+
+  // 内存中最多放 frame_num 个页面，其它页面都要淘汰掉
+  BPFrameStat stat = bpm.get_frame_manager().stat();
+  ASSERT_GE(stat.evict_count, static_cast<uint64_t>(page_num - frame_num));
+  ASSERT_GT(stat.miss_count, 0UL);
+  ASSERT_GE(stat.hit_count + stat.miss_count, static_cast<uint64_t>(page_num));
+
+#ifdef CONCURRENCY
+  // 清理线程会在后台把空闲页帧补充到 free_frames
+  for (int i = 0; i < 100 && bpm.get_frame_manager().free_frame_num() < free_frames; i++) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  ASSERT_GE(bpm.get_frame_manager().free_frame_num(), static_cast<size_t>(free_frames));
+  ASSERT_GT(bpm.get_frame_manager().stat().cleaner_flush_count, 0UL);
+#endif
+
+  ASSERT_EQ(RC::SUCCESS, bpm.stop_cleaner());
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_buffer_pool, test_buffer_pool_read_ahead)
+{
+  // 页面比内存能放下的多，顺序读取时大部分页面应该是预读进来的
+  VacuousLogHandler log_handler;
+  const char       *file_name = "bp_manager_test_read_ahead.bp";
+  ::remove(file_name);
+
+  const int         frame_num = DEFAULT_ITEM_NUM_PER_POOL;
+  BufferPoolManager bpm(frame_num * BP_PAGE_SIZE);
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  bpm.set_read_ahead_pages(16);
+
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, file_name, bp));
+
+  const int page_num = frame_num * 3;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    snprintf(frame->data(), BP_PAGE_DATA_SIZE, "page %d", frame->page_num());
+    frame->mark_dirty();
+    bp->unpin_page(frame);
+  }
+
+  auto scan = [&bp, page_num]() {
+    for (PageNum page_num_to_read = 1; page_num_to_read <= page_num; page_num_to_read++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num_to_read, &frame));
+      ASSERT_EQ(string("page ") + std::to_string(page_num_to_read), string(frame->data()));
+      bp->unpin_page(frame);
+    }
+  };
+
+  // 没有启动预读线程时，在当前线程中预读
+  BPFrameStat stat_before = bpm.get_frame_manager().stat();
+  scan();
+  BPFrameStat stat_after = bpm.get_frame_manager().stat();
+  ASSERT_GT(stat_after.read_ahead_count, stat_before.read_ahead_count);
+  ASSERT_LT(stat_after.miss_count - stat_before.miss_count, static_cast<uint64_t>(page_num / 2));
+
+  // 预读的页面不能覆盖内存中更新的页面
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+  snprintf(frame->data(), BP_PAGE_DATA_SIZE, "updated");
+  frame->mark_dirty();
+  bp->unpin_page(frame);
+  ASSERT_EQ(RC::SUCCESS, bp->read_ahead(1, page_num));
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &frame));
+  ASSERT_EQ(string("updated"), string(frame->data()));
+  snprintf(frame->data(), BP_PAGE_DATA_SIZE, "page %d", page_num);
+  frame->mark_dirty();
+  bp->unpin_page(frame);
+
+  // 在后台预读
+  stat_before = bpm.get_frame_manager().stat();
+  ASSERT_EQ(RC::SUCCESS, bpm.start_read_ahead());
+  bp->prefetch(1);
+  scan();
+  ASSERT_EQ(RC::SUCCESS, bpm.stop_read_ahead());
+
+  // 后台预读可能跟不上扫描，不过内存放不下所有页面，至少要重新读入 page_num - frame_num 个页面
+  stat_after = bpm.get_frame_manager().stat();
+  ASSERT_GE(stat_after.read_ahead_count + stat_after.miss_count - stat_before.read_ahead_count - stat_before.miss_count,
+      static_cast<uint64_t>(page_num - frame_num));
+  ASSERT_GE(stat_after.hit_count + stat_after.miss_count - stat_before.hit_count - stat_before.miss_count,
+      static_cast<uint64_t>(page_num));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
 int main(int argc, char **argv)
 {
 
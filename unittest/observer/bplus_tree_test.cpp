@@ -15,6 +15,9 @@ See the Mulan PSL v2 for more details. */
 #include <iostream>
 #include <list>
 #include <filesystem>
+#include <algorithm>
+#include <random>
+#include <set>
 
 #include "common/log/log.h"
 #include "common/lang/memory.h"
@@ -22,6 +25,8 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_loader.h"
+#include "storage/index/index_worker_pool.h"
 #include "storage/clog/vacuous_log_handler.h"
 #include "storage/buffer/double_write_buffer.h"
 #include "gtest/gtest.h"
@@ -794,6 +799,111 @@ TEST(test_bplus_tree, test_scanner)
   handler.close();
 }
 
+TEST(test_bplus_tree, test_scanner_batch_and_seek)
+{
+  LoggerFactory::init_default("test.log");
+
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "scanner_batch.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(buffer_pool_file.c_str()));
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+  ASSERT_NE(nullptr, buffer_pool);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::INTS, sizeof(int), ORDER, ORDER));
+
+  // 插入[1 - 199] 所有奇数，每个值有3条记录，重复的值会跨越多个叶子节点
+  const int dup_num = 3;
+  for (int i = 0; i < 100; i++) {
+    int key = i * 2 + 1;
+    for (int j = 0; j < dup_num; j++) {
+      RID rid(key, j);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+    }
+  }
+
+  // 批量获取的结果与逐条获取的结果一致
+  auto scan_batch = [&handler](const int *begin, const int *end, int capacity, vector<RID> &rids) {
+    BplusTreeScanner scanner(handler);
+    RC rc = scanner.open((const char *)begin, sizeof(int), true, (const char *)end, sizeof(int), true);
+    ASSERT_EQ(RC::SUCCESS, rc);
+
+    vector<RID> batch(capacity);
+    int         count = 0;
+    while ((rc = scanner.next_batch(batch.data(), capacity, count)) == RC::SUCCESS) {
+      ASSERT_GT(count, 0);
+      rids.insert(rids.end(), batch.begin(), batch.begin() + count);
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(0, count);
+  };
+
+  for (int capacity : {1, 2, 7, 1000}) {
+    vector<RID> rids;
+    scan_batch(nullptr, nullptr, capacity, rids);
+    ASSERT_EQ(100 * dup_num, static_cast<int>(rids.size()));
+    for (int i = 0; i < static_cast<int>(rids.size()); i++) {
+      ASSERT_EQ(i / dup_num * 2 + 1, rids[i].page_num);
+      ASSERT_EQ(i % dup_num, rids[i].slot_num);
+    }
+
+    rids.clear();
+    int begin = 50;
+    int end   = 120;
+    scan_batch(&begin, &end, capacity, rids);
+    ASSERT_EQ(35 * dup_num, static_cast<int>(rids.size()));
+    ASSERT_EQ(51, rids.front().page_num);
+    ASSERT_EQ(119, rids.back().page_num);
+
+    rids.clear();
+    begin = 10;
+    end   = 10;
+    scan_batch(&begin, &end, capacity, rids);
+    ASSERT_EQ(0, static_cast<int>(rids.size()));
+  }
+
+  // 批量等值查找，包括存在和不存在的值，递增和乱序的键值
+  vector<int> keys;
+  for (int i = -3; i < 205; i++) {
+    keys.push_back(i);
+  }
+  for (int round = 0; round < 2; round++) {
+    if (round == 1) {
+      std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+    }
+
+    vector<const char *> user_keys;
+    vector<int>          key_lens;
+    for (const int &key : keys) {
+      user_keys.push_back((const char *)&key);
+      key_lens.push_back(sizeof(int));
+    }
+
+    vector<list<RID>> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entries(user_keys, key_lens, rids));
+    ASSERT_EQ(keys.size(), rids.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      const int key      = keys[i];
+      const int expected = (key > 0 && key < 200 && key % 2 == 1) ? dup_num : 0;
+      ASSERT_EQ(expected, static_cast<int>(rids[i].size())) << "key=" << key;
+      for (const RID &rid : rids[i]) {
+        ASSERT_EQ(key, rid.page_num);
+      }
+    }
+  }
+
+  handler.close();
+}
+
 TEST(test_bplus_tree, test_bplus_tree_insert)
 {
   LoggerFactory::init_default("test.log");
@@ -827,6 +937,754 @@ TEST(test_bplus_tree, test_bplus_tree_insert)
   handler = nullptr;
 }
 
+/**
+ * @brief 扫描整棵树，检查键值按照顺序排列并且RID与键值对应
+ * @details 测试数据的键值是i，RID是 (i / page_size + 1, i % page_size)
+ */
+TEST(test_bplus_tree, test_adaptive_hash)
+{
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "adaptive_hash.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(buffer_pool_file.c_str()));
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, buffer_pool_file.c_str(), buffer_pool));
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(log_handler, *buffer_pool, AttrType::INTS, sizeof(int), ORDER, ORDER));
+
+  AdaptiveHashOptions options;
+  options.enabled         = true;
+  options.build_threshold = 4;
+  handler.enable_adaptive_hash(options);
+
+  // 插入[0, 400)中的偶数
+  set<int> keys;
+  for (int key = 0; key < 400; key += 2) {
+    RID rid(key, 0);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+    keys.insert(key);
+  }
+
+  auto check_all = [&handler, &keys]() {
+    for (int key = -1; key <= 400; key++) {
+      list<RID> rids;
+      ASSERT_EQ(RC::SUCCESS, handler.get_entry((const char *)&key, sizeof(key), rids));
+      ASSERT_EQ(keys.count(key), rids.size()) << "key=" << key;
+      if (!rids.empty()) {
+        ASSERT_EQ(key, rids.front().page_num);
+      }
+    }
+  };
+
+  check_all();
+  check_all();
+
+  AdaptiveHashStat stat;
+  ASSERT_TRUE(handler.adaptive_hash_stat(stat));
+  ASSERT_GT(stat.entry_count, 0);
+  ASSERT_GT(stat.hit_count, 0);
+  const uint64_t hit_count = stat.hit_count;
+
+  // 删除和插入导致节点合并、重新分配和分裂，记录的位置失效后依然能查到正确的结果
+  for (int key = 0; key < 400; key += 6) {
+    RID rid(key, 0);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&key, &rid));
+    keys.erase(key);
+  }
+  for (int key = 1; key < 400; key += 4) {
+    RID rid(key, 0);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+    keys.insert(key);
+  }
+
+  check_all();
+  check_all();
+  ASSERT_TRUE(handler.validate_tree());
+
+  ASSERT_TRUE(handler.adaptive_hash_stat(stat));
+  ASSERT_GT(stat.invalid_count, 0);
+  ASSERT_GT(stat.hit_count, hit_count);
+
+  // 内存不够时淘汰最久没有访问的数据
+  options.memory_limit = 4096;
+  handler.enable_adaptive_hash(options);
+
+  check_all();
+  ASSERT_TRUE(handler.adaptive_hash_stat(stat));
+  ASSERT_GT(stat.evict_count, 0);
+  ASSERT_LT(stat.entry_count, static_cast<int64_t>(keys.size()));
+
+  handler.close();
+}
+
+void check_bulk_loaded_tree(BplusTreeHandler &handler, const vector<int> &sorted_keys)
+{
+  ASSERT_TRUE(handler.validate_tree());
+
+  BplusTreeScanner scanner(handler);
+  ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+
+  RID    rid;
+  size_t count = 0;
+  RC     rc    = RC::SUCCESS;
+  while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+    ASSERT_LT(count, sorted_keys.size());
+    const int key = sorted_keys[count];
+    ASSERT_EQ(key / page_size + 1, rid.page_num);
+    ASSERT_EQ(key % page_size, rid.slot_num);
+    count++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(sorted_keys.size(), count);
+  scanner.close();
+}
+
+void bulk_load(BplusTreeHandler &handler, const vector<int> &keys, const BplusTreeBulkLoadOptions &options,
+    int *run_count = nullptr)
+{
+  BplusTreeBulkLoader loader(handler, options);
+  for (int key : keys) {
+    RID rid(key / page_size + 1, key % page_size);
+    ASSERT_EQ(RC::SUCCESS, loader.add(reinterpret_cast<const char *>(&key), rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, loader.finish());
+  if (run_count != nullptr) {
+    *run_count = loader.run_count();
+  }
+}
+
+TEST(test_bplus_tree, test_bulk_load)
+{
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "test_bulk_load.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // validate_tree 会pin住访问过的所有页面，数据不能太多，否则会用完buffer pool中的页帧
+  const int   key_num = 2000;
+  vector<int> keys(key_num);
+  for (int i = 0; i < key_num; i++) {
+    keys[i] = i;
+  }
+  vector<int> sorted_keys = keys;
+  shuffle(keys.begin(), keys.end(), std::mt19937(100));
+
+  // 内存排序和外部排序，以及不同的填充因子
+  const int fill_factors[] = {50, 90, 100};
+  const int sort_memories[] = {0, 4096};
+  for (int fill_factor : fill_factors) {
+    for (int sort_memory : sort_memories) {
+      filesystem::remove(buffer_pool_file);
+
+      BplusTreeHandler handler;
+      ASSERT_EQ(RC::SUCCESS,
+          handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::INTS, sizeof(int), ORDER * 2, ORDER * 2));
+
+      BplusTreeBulkLoadOptions options;
+      options.fill_factor = fill_factor;
+      if (sort_memory > 0) {
+        options.sort_memory = sort_memory;
+      }
+      int run_count = 0;
+      bulk_load(handler, keys, options, &run_count);
+      ASSERT_EQ(sort_memory > 0, run_count > 1);
+      check_bulk_loaded_tree(handler, sorted_keys);
+
+      // 范围扫描。扫描器析构时才会释放页面的锁，所以放到单独的作用域中
+      {
+        BplusTreeScanner scanner(handler);
+        int              begin = 100;
+        int              end   = 199;
+        ASSERT_EQ(RC::SUCCESS, scanner.open((const char *)&begin, 4, true, (const char *)&end, 4, false));
+        RID rid;
+        int count = 0;
+        while (scanner.next_entry(rid) == RC::SUCCESS) {
+          ASSERT_EQ(begin + count, rid.slot_num);
+          count++;
+        }
+        ASSERT_EQ(end - begin, count);
+        scanner.close();
+      }
+
+      // 构建出来的树可以正常地插入和删除
+      for (int i = key_num; i < key_num + 200; i++) {
+        RID rid(i / page_size + 1, i % page_size);
+        ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&i, &rid));
+      }
+      for (int i = 0; i < key_num + 200; i += 2) {
+        RID rid(i / page_size + 1, i % page_size);
+        ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&i, &rid));
+      }
+      vector<int> left_keys;
+      for (int i = 1; i < key_num + 200; i += 2) {
+        left_keys.push_back(i);
+      }
+      check_bulk_loaded_tree(handler, left_keys);
+
+      ASSERT_EQ(RC::SUCCESS, bpm.close_file(buffer_pool_file.c_str()));
+    }
+  }
+}
+
+TEST(test_bplus_tree, test_bulk_load_small)
+{
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "test_bulk_load_small.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 只有0个、1个或者刚好一个叶子节点的数据
+  for (int key_num : {0, 1, ORDER, ORDER + 1}) {
+    filesystem::remove(buffer_pool_file);
+
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::INTS, sizeof(int), ORDER, ORDER));
+
+    vector<int> keys;
+    for (int i = 0; i < key_num; i++) {
+      keys.push_back(i);
+    }
+    bulk_load(handler, keys, BplusTreeBulkLoadOptions());
+    ASSERT_EQ(key_num == 0, handler.is_empty());
+    check_bulk_loaded_tree(handler, keys);
+
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(buffer_pool_file.c_str()));
+  }
+
+  // 重复的键值
+  filesystem::remove(buffer_pool_file);
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::INTS, sizeof(int), ORDER, ORDER));
+  BplusTreeBulkLoader loader(handler);
+  int                 key = 1;
+  RID                 rid(1, 1);
+  ASSERT_EQ(RC::SUCCESS, loader.add((const char *)&key, rid));
+  ASSERT_EQ(RC::SUCCESS, loader.add((const char *)&key, rid));
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, loader.finish());
+}
+
+TEST(test_bplus_tree, test_bulk_load_partitions)
+{
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "test_bulk_load_partitions.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  const int   key_num = 2000;
+  vector<int> keys(key_num);
+  for (int i = 0; i < key_num; i++) {
+    keys[i] = i;
+  }
+  vector<int> sorted_keys = keys;
+  shuffle(keys.begin(), keys.end(), std::mt19937(200));
+
+  IndexParallelOptions parallel_options;
+  parallel_options.worker_threads = 3;
+  IndexWorkerPool worker_pool(parallel_options);
+
+  // 每个分区只在内存中排序，或者分区内也写临时文件，各个分区在不同的线程中同时添加数据
+  for (int sort_memory : {0, 8192}) {
+    filesystem::remove(buffer_pool_file);
+
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::INTS, sizeof(int), ORDER * 2, ORDER * 2));
+
+    BplusTreeBulkLoadOptions options;
+    if (sort_memory > 0) {
+      options.sort_memory = sort_memory;
+    }
+    BplusTreeBulkLoader loader(handler, options);
+    const int           partition_num = 4;
+    ASSERT_EQ(RC::SUCCESS, loader.create_partitions(partition_num));
+
+    vector<function<RC()>> tasks;
+    for (int p = 0; p < partition_num; p++) {
+      tasks.emplace_back([&keys, &loader, p]() -> RC {
+        BplusTreeBulkLoader::Partition &partition = loader.partition(p);
+        for (size_t i = p; i < keys.size(); i += partition_num) {
+          int key = keys[i];
+          RID rid(key / page_size + 1, key % page_size);
+          RC  rc = partition.add(reinterpret_cast<const char *>(&key), rid);
+          if (OB_FAIL(rc)) {
+            return rc;
+          }
+        }
+        return partition.seal();
+      });
+    }
+    vector<RC> results;
+    worker_pool.run(tasks, results);
+    for (RC rc : results) {
+      ASSERT_EQ(RC::SUCCESS, rc);
+    }
+
+    ASSERT_EQ(key_num, loader.entry_count());
+    ASSERT_EQ(RC::SUCCESS, loader.finish());
+    ASSERT_EQ(sort_memory > 0, loader.run_count() > partition_num);
+    check_bulk_loaded_tree(handler, sorted_keys);
+
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(buffer_pool_file.c_str()));
+  }
+
+  // 不同分区中的重复键值也能发现
+  filesystem::remove(buffer_pool_file);
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::INTS, sizeof(int), ORDER, ORDER));
+  BplusTreeBulkLoader loader(handler);
+  ASSERT_EQ(RC::SUCCESS, loader.create_partitions(2));
+  int key = 1;
+  RID rid(1, 1);
+  ASSERT_EQ(RC::SUCCESS, loader.partition(0).add((const char *)&key, rid));
+  ASSERT_EQ(RC::SUCCESS, loader.partition(1).add((const char *)&key, rid));
+  ASSERT_EQ(RC::INVALID_ARGUMENT, loader.create_partitions(3));
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, loader.finish());
+}
+
+TEST(test_bplus_tree, test_compact_key_codec)
+{
+  IndexFileHeader header;
+  header.attr_num       = 1;
+  header.attr_length[0] = 16;
+  header.attr_type[0]   = AttrType::CHARS;
+  header.key_length     = 16 + sizeof(RID);
+
+  CompactKeyCodec codec(header);
+  KeyComparator   comparator;
+  comparator.init(AttrType::CHARS, 16);
+
+  auto make_key = [&](const char *str, int page_num, int slot_num) {
+    vector<char> key(header.key_length, 0);
+    memcpy(key.data(), str, std::min(strlen(str), size_t(16)));
+    RID rid(page_num, slot_num);
+    memcpy(key.data() + 16, &rid, sizeof(rid));
+    return key;
+  };
+
+  vector<vector<char>> keys = {make_key("", 0, 0),
+      make_key("a", 0, 1),
+      make_key("abc", 1, 0),
+      make_key("abc", 1, 1),
+      make_key("abcd", 0, 0),
+      make_key("abcdefghijklmnop", 2, 3),
+      make_key("abd", 0x12345, 0x678)};
+
+  vector<char> encoded(codec.max_encoded_length());
+  vector<char> decoded(header.key_length);
+  for (size_t i = 0; i < keys.size(); i++) {
+    // 编码后可以还原
+    const int len = codec.encode(keys[i].data(), encoded.data());
+    ASSERT_LE(len, codec.max_encoded_length());
+    codec.decode(encoded.data(), len, decoded.data());
+    ASSERT_EQ(0, memcmp(keys[i].data(), decoded.data(), header.key_length));
+
+    // 编码后按字节比较的顺序与比较函数一致
+    for (size_t j = i + 1; j < keys.size(); j++) {
+      ASSERT_LT(comparator(keys[i].data(), keys[j].data()), 0);
+      vector<char> other(codec.max_encoded_length());
+      const int    other_len = codec.encode(keys[j].data(), other.data());
+      const int    cmp       = memcmp(encoded.data(), other.data(), std::min(len, other_len));
+      ASSERT_TRUE(cmp < 0 || (cmp == 0 && len < other_len));
+
+      // 后缀截断后的分隔键在两个键值之间
+      vector<char> separator(header.key_length);
+      if (codec.shortest_separator(keys[i].data(), keys[j].data(), separator.data())) {
+        ASSERT_LT(comparator(keys[i].data(), separator.data()), 0);
+        ASSERT_LE(comparator(separator.data(), keys[j].data()), 0);
+      }
+    }
+  }
+
+  // 字符串后面的部分都不需要
+  vector<char> left  = make_key("user_0001_aaaaaa", 0, 0);
+  vector<char> right = make_key("user_0002_bbbbbb", 0, 0);
+  vector<char> separator(header.key_length);
+  ASSERT_TRUE(codec.shortest_separator(left.data(), right.data(), separator.data()));
+  ASSERT_EQ(0, memcmp(separator.data(), "user_0002", 9));
+  ASSERT_EQ(0, separator[9]);
+}
+
+/**
+ * @brief 与B+树相同的顺序：先按照字符串，再按照RID
+ */
+struct CompactEntryLess
+{
+  bool operator()(const pair<string, RID> &a, const pair<string, RID> &b) const
+  {
+    if (a.first != b.first) {
+      return a.first < b.first;
+    }
+    return RID::compare(&a.second, &b.second) < 0;
+  }
+};
+using CompactEntrySet = set<pair<string, RID>, CompactEntryLess>;
+
+/**
+ * @brief 随机生成一个字符串，有比较长的公共前缀，长度也不固定
+ * @param long_prefix 使用很长的随机前缀，相邻的键值只在最后几个字节不同，这样后缀截断和前缀压缩都不起作用，
+ * 节点中只能放很少的元素，用来测试内部节点的分裂与合并
+ */
+static string random_compact_key(std::mt19937 &random, int max_length, bool long_prefix = false)
+{
+  const int id = random() % 5000;
+  string    result;
+  if (long_prefix) {
+    std::mt19937 prefix_random(id % 64);
+    for (int i = 0; i < 160; i++) {
+      result.push_back(static_cast<char>('a' + prefix_random() % 26));
+    }
+    result += "/" + std::to_string(id);
+  } else {
+    result = "customer/region-" + std::to_string(id % 7) + "/id-" + std::to_string(id);
+    result.append(random() % 32, 'x');
+  }
+  result.resize(std::min<size_t>(result.size(), max_length));
+  return result;
+}
+
+/**
+ * @brief 扫描整棵树，与期望的结果比较
+ */
+static void check_compact_tree(BplusTreeHandler &handler, const CompactEntrySet &expected, int attr_length)
+{
+  ASSERT_TRUE(handler.validate_tree());
+
+  {
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    RID  rid;
+    auto iter = expected.begin();
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      ASSERT_NE(iter, expected.end());
+      ASSERT_EQ(iter->second, rid);
+      ++iter;
+    }
+    ASSERT_EQ(iter, expected.end());
+    scanner.close();
+  }
+
+  // 随机挑几个键值做等值查询
+  int count = 0;
+  for (auto iter = expected.begin(); iter != expected.end() && count < 20; ++count) {
+    vector<char> key(attr_length, 0);
+    memcpy(key.data(), iter->first.data(), iter->first.size());
+    list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(key.data(), iter->first.size(), rids));
+    int num = 0;
+    for (auto it = expected.lower_bound({iter->first, *RID::min()}); it != expected.end() && it->first == iter->first;
+         ++it) {
+      num++;
+    }
+    ASSERT_EQ(num, static_cast<int>(rids.size()));
+    std::advance(iter, std::min<size_t>(37, std::distance(iter, expected.end())));
+  }
+}
+
+TEST(test_bplus_tree, test_compact_random)
+{
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "test_compact_random.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  const int attr_length = 200;
+  for (bool long_prefix : {false, true}) {
+    filesystem::remove(buffer_pool_file);
+
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::CHARS, attr_length, -1, -1,
+            BplusTreeKeyFormat::COMPACT));
+    ASSERT_EQ(static_cast<int32_t>(BplusTreeKeyFormat::COMPACT), handler.file_header().key_format);
+
+    std::mt19937              random(2024);
+    CompactEntrySet           expected;
+    vector<pair<string, RID>> inserted;
+    for (int round = 0; round < 8; round++) {
+      for (int i = 0; i < 1500; i++) {
+        if (!inserted.empty() && random() % 3 == 0) {
+          const size_t index = random() % inserted.size();
+          auto         entry = inserted[index];
+          inserted[index]    = inserted.back();
+          inserted.pop_back();
+
+          vector<char> key(attr_length, 0);
+          memcpy(key.data(), entry.first.data(), entry.first.size());
+          ASSERT_EQ(RC::SUCCESS, handler.delete_entry(key.data(), &entry.second));
+          expected.erase(entry);
+        } else {
+          string       str = random_compact_key(random, attr_length, long_prefix);
+          RID          rid(random() % 1000, random() % 100);
+          vector<char> key(attr_length, 0);
+          memcpy(key.data(), str.data(), str.size());
+          RC rc = handler.insert_entry(key.data(), &rid);
+          if (expected.count({str, rid}) > 0) {
+            ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, rc);
+          } else {
+            ASSERT_EQ(RC::SUCCESS, rc);
+            expected.insert({str, rid});
+            inserted.push_back({str, rid});
+          }
+        }
+      }
+      check_compact_tree(handler, expected, attr_length);
+    }
+
+    BplusTreeStat stat;
+    ASSERT_EQ(RC::SUCCESS, handler.stat(stat));
+    ASSERT_EQ(static_cast<int64_t>(expected.size()), stat.entry_count);
+    ASSERT_GE(stat.height, long_prefix ? 3 : 2);
+    LOG_INFO("compact tree stat: %s", stat.to_string().c_str());
+
+    // 删除所有数据
+    for (const auto &entry : inserted) {
+      vector<char> key(attr_length, 0);
+      memcpy(key.data(), entry.first.data(), entry.first.size());
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(key.data(), &entry.second));
+    }
+    expected.clear();
+    ASSERT_TRUE(handler.is_empty());
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(buffer_pool_file.c_str()));
+  }
+}
+
+TEST(test_bplus_tree, test_compact_multi_field)
+{
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "test_compact_multi_field.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  // 记录格式: | null bitmap(4) | name CHARS(32) | age INTS(4) | score FLOATS(4) |
+  FieldMeta null_field("__null", AttrType::CHARS, 0, 4, false, 0);
+  FieldMeta name_field("name", AttrType::CHARS, 4, 32, true, 1);
+  FieldMeta age_field("age", AttrType::INTS, 36, 4, true, 2);
+  FieldMeta score_field("score", AttrType::FLOATS, 40, 4, true, 3);
+  const int record_size = 44;
+
+  vector<const FieldMeta *> fields    = {&null_field, &name_field, &age_field, &score_field};
+  vector<int>               field_ids = {0, 1, 2, 3};
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(log_handler, bpm, buffer_pool_file.c_str(), false, field_ids, fields, -1, -1,
+          BplusTreeKeyFormat::COMPACT));
+  ASSERT_EQ(static_cast<int32_t>(BplusTreeKeyFormat::COMPACT), handler.file_header().key_format);
+
+  std::mt19937                 random(7);
+  vector<pair<vector<char>, RID>> records;
+  for (int i = 0; i < 3000; i++) {
+    vector<char> record(record_size, 0);
+    common::Bitmap null_map(record.data(), 32);
+    string       name = "name-" + std::to_string(random() % 300);
+    memcpy(record.data() + 4, name.data(), name.size());
+    if (random() % 10 == 0) {
+      null_map.set_bit(2);
+    } else {
+      int age = static_cast<int>(random() % 200) - 100;
+      memcpy(record.data() + 36, &age, sizeof(age));
+    }
+    float score = static_cast<float>(random() % 1000) / 7;
+    memcpy(record.data() + 40, &score, sizeof(score));
+
+    RID rid(i / page_size + 1, i % page_size);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(record.data(), &rid));
+    records.emplace_back(std::move(record), rid);
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  // 删除一半的数据
+  for (size_t i = 0; i < records.size(); i += 2) {
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(records[i].first.data(), &records[i].second));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  {
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    RID rid;
+    int count = 0;
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      ASSERT_EQ(1, (rid.page_num * page_size + rid.slot_num - page_size) % 2);
+      count++;
+    }
+    ASSERT_EQ(static_cast<int>(records.size() / 2), count);
+    scanner.close();
+  }
+
+  // 前缀查询
+  for (int i = 0; i < 10; i++) {
+    char   name[32] = {0};
+    string str      = "name-" + std::to_string(i * 29);
+    memcpy(name, str.data(), str.size());
+    int expected_count = 0;
+    for (size_t j = 1; j < records.size(); j += 2) {
+      if (memcmp(records[j].first.data() + 4, name, sizeof(name)) == 0) {
+        expected_count++;
+      }
+    }
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(name, str.size(), true, name, str.size(), true));
+    RID rid;
+    int count = 0;
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      count++;
+    }
+    ASSERT_EQ(expected_count, count);
+    scanner.close();
+  }
+
+  // 多字段前缀上的范围查询: name = ? and age >= low and age < high，以及 name = ? and age > low
+  auto count_records = [&records](const char *name, int low, bool low_inclusive, int high, bool has_high) {
+    int expected_count = 0;
+    for (size_t j = 1; j < records.size(); j += 2) {
+      const char    *record = records[j].first.data();
+      common::Bitmap null_map(const_cast<char *>(record), 32);
+      int            age = 0;
+      memcpy(&age, record + 36, sizeof(age));
+      if (memcmp(record + 4, name, 32) == 0 && !null_map.get_bit(2) && (age > low || (low_inclusive && age == low)) &&
+          (!has_high || age < high)) {
+        expected_count++;
+      }
+    }
+    return expected_count;
+  };
+  for (int i = 0; i < 10; i++) {
+    char   left_key[36]  = {0};
+    char   right_key[36] = {0};
+    string str           = "name-" + std::to_string(i * 31);
+    int    low           = i * 20 - 100;
+    int    high          = low + 50;
+    memcpy(left_key, str.data(), str.size());
+    memcpy(right_key, str.data(), str.size());
+    memcpy(left_key + 32, &low, sizeof(low));
+    memcpy(right_key + 32, &high, sizeof(high));
+
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS, scanner.open(left_key, sizeof(low), true, right_key, sizeof(high), false, 2, 2));
+    RID rid;
+    int count = 0;
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      count++;
+    }
+    ASSERT_EQ(count_records(left_key, low, true, high, true), count);
+    scanner.close();
+
+    ASSERT_EQ(RC::SUCCESS, scanner.open(left_key, sizeof(low), false, right_key, str.size(), true, 2, 1));
+    count = 0;
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      count++;
+    }
+    ASSERT_EQ(count_records(left_key, low, false, 0, false), count);
+    scanner.close();
+
+    // 两个字段都是等值条件
+    vector<const char *> user_keys = {left_key};
+    vector<int>          key_lens  = {sizeof(low)};
+    vector<list<RID>>    rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entries(user_keys, key_lens, rids, 2));
+    ASSERT_EQ(count_records(left_key, low, true, low + 1, true), static_cast<int>(rids[0].size()));
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(buffer_pool_file.c_str()));
+}
+
+TEST(test_bplus_tree, test_compact_bulk_load)
+{
+  filesystem::path test_directory("bplus_tree");
+  filesystem::path buffer_pool_file = test_directory / "test_compact_bulk_load.btree";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  const int              attr_length = 200;
+  std::mt19937           random(11);
+  CompactEntrySet expected;
+  // 一半的键值使用很长的前缀，构建出来的树有多层内部节点
+  for (int i = 0; i < 6000; i++) {
+    string str = random_compact_key(random, attr_length, i % 2 == 0);
+    expected.insert({str, RID(i / page_size + 1, i % page_size)});
+  }
+
+  for (int fill_factor : {50, 100}) {
+    filesystem::remove(buffer_pool_file);
+
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS,
+        handler.create(log_handler, bpm, buffer_pool_file.c_str(), AttrType::CHARS, attr_length, -1, -1,
+            BplusTreeKeyFormat::COMPACT));
+
+    BplusTreeBulkLoadOptions options;
+    options.fill_factor = fill_factor;
+    {
+      BplusTreeBulkLoader loader(handler, options);
+      for (const auto &entry : expected) {
+        vector<char> key(attr_length, 0);
+        memcpy(key.data(), entry.first.data(), entry.first.size());
+        ASSERT_EQ(RC::SUCCESS, loader.add(key.data(), entry.second));
+      }
+      ASSERT_EQ(RC::SUCCESS, loader.finish());
+    }
+    check_compact_tree(handler, expected, attr_length);
+
+    // 构建出来的树可以正常地插入和删除
+    CompactEntrySet left = expected;
+    int                    index = 0;
+    for (const auto &entry : expected) {
+      if (index++ % 3 == 0) {
+        vector<char> key(attr_length, 0);
+        memcpy(key.data(), entry.first.data(), entry.first.size());
+        ASSERT_EQ(RC::SUCCESS, handler.delete_entry(key.data(), &entry.second));
+        left.erase(entry);
+      }
+    }
+    for (int i = 0; i < 500; i++) {
+      string       str = random_compact_key(random, attr_length);
+      RID          rid(100 + i / page_size, i % page_size);
+      vector<char> key(attr_length, 0);
+      memcpy(key.data(), str.data(), str.size());
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key.data(), &rid));
+      left.insert({str, rid});
+    }
+    check_compact_tree(handler, left, attr_length);
+
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(buffer_pool_file.c_str()));
+  }
+}
+
 int main(int argc, char **argv)
 {
 
@@ -0,0 +1,362 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/db/db.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+
+namespace {
+
+/// 第二个字段是主键，主键不在记录的开头
+vector<AttrInfoSqlNode> clustered_attrs(AttrType key_type = AttrType::INTS, int key_length = 4)
+{
+  vector<AttrInfoSqlNode> attr_infos(3);
+  attr_infos[0].name   = "payload";
+  attr_infos[0].type   = AttrType::INTS;
+  attr_infos[0].length = 4;
+
+  attr_infos[1].name        = "id";
+  attr_infos[1].type        = key_type;
+  attr_infos[1].length      = key_length;
+  attr_infos[1].primary_key = true;
+
+  attr_infos[2].name   = "name";
+  attr_infos[2].type   = AttrType::CHARS;
+  attr_infos[2].length = 16;
+  return attr_infos;
+}
+
+RC insert_row(Table *table, Trx *trx, int id)
+{
+  vector<Value> values(3);
+  values[0].set_int(id * 10);
+  values[1].set_int(id);
+  values[2].set_string(("name_" + to_string(id)).c_str());
+
+  Record record;
+  RC     rc = table->make_record(static_cast<int>(values.size()), values.data(), record);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  return trx->insert_record(table, record);
+}
+
+int id_of(Table *table, const Record &record)
+{
+  const FieldMeta *field = table->table_meta().field("id");
+  return *reinterpret_cast<const int *>(record.data() + field->offset());
+}
+
+int payload_of(Table *table, const Record &record)
+{
+  const FieldMeta *field = table->table_meta().field("payload");
+  return *reinterpret_cast<const int *>(record.data() + field->offset());
+}
+
+/// 聚簇存放的表中，记录的RID就是主键的值，不足的部分补0
+RID rid_of(int id)
+{
+  RID rid;
+  memset(&rid, 0, sizeof(rid));
+  memcpy(&rid, &id, sizeof(id));
+  return rid;
+}
+
+/// 按照遍历的顺序返回所有记录的主键，trx 为空时返回所有记录，包括已经删除的
+vector<int> scan_ids(Table *table, const int *left = nullptr, const int *right = nullptr, Trx *trx = nullptr)
+{
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY));
+  if (left != nullptr || right != nullptr) {
+    EXPECT_EQ(RC::SUCCESS,
+        scanner.set_key_range(reinterpret_cast<const char *>(left), sizeof(int), true,
+            reinterpret_cast<const char *>(right), sizeof(int), false));
+  }
+
+  vector<int> ids;
+  Record      record;
+  RC          rc = RC::SUCCESS;
+  while (OB_SUCC(rc = scanner.next(record))) {
+    ids.push_back(id_of(table, record));
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  return ids;
+}
+
+}  // namespace
+
+TEST(ClusteredTable, table_meta)
+{
+  TableMeta meta;
+
+  // 聚簇存放的表必须有主键
+  vector<AttrInfoSqlNode> attrs = clustered_attrs();
+  attrs[1].primary_key          = false;
+  EXPECT_EQ(RC::INVALID_ARGUMENT, meta.init(1, "t", nullptr, attrs, StorageFormat::CLUSTERED_FORMAT));
+
+  // 只有聚簇存放的表可以有主键
+  attrs = clustered_attrs();
+  EXPECT_EQ(RC::INVALID_ARGUMENT, meta.init(1, "t", nullptr, attrs, StorageFormat::ROW_FORMAT));
+
+  // 只支持一个主键字段
+  attrs[0].primary_key = true;
+  EXPECT_EQ(RC::INVALID_ARGUMENT, meta.init(1, "t", nullptr, attrs, StorageFormat::CLUSTERED_FORMAT));
+
+  // 浮点数和超过RID长度的字段不能作为主键
+  attrs = clustered_attrs(AttrType::FLOATS, 4);
+  EXPECT_EQ(RC::INVALID_ARGUMENT, meta.init(1, "t", nullptr, attrs, StorageFormat::CLUSTERED_FORMAT));
+  attrs = clustered_attrs(AttrType::CHARS, 16);
+  EXPECT_EQ(RC::INVALID_ARGUMENT, meta.init(1, "t", nullptr, attrs, StorageFormat::CLUSTERED_FORMAT));
+
+  // 记录太大时一个叶子节点放不下几条记录
+  attrs            = clustered_attrs();
+  attrs[2].length  = BP_PAGE_DATA_SIZE;
+  EXPECT_EQ(RC::INVALID_ARGUMENT, meta.init(1, "t", nullptr, attrs, StorageFormat::CLUSTERED_FORMAT));
+
+  attrs = clustered_attrs(AttrType::CHARS, 8);
+  ASSERT_EQ(RC::SUCCESS, meta.init(1, "t", nullptr, attrs, StorageFormat::CLUSTERED_FORMAT));
+  ASSERT_NE(nullptr, meta.primary_key());
+  EXPECT_STREQ("id", meta.primary_key()->name());
+
+  // 主键随元数据一起持久化
+  stringstream ss;
+  ASSERT_GT(meta.serialize(ss), 0);
+  TableMeta meta2;
+  ASSERT_GT(meta2.deserialize(ss), 0);
+  ASSERT_NE(nullptr, meta2.primary_key());
+  EXPECT_STREQ("id", meta2.primary_key()->name());
+  EXPECT_EQ(StorageFormat::CLUSTERED_FORMAT, meta2.storage_format());
+}
+
+TEST(ClusteredTable, crud)
+{
+  filesystem::path test_directory("clustered_table_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directories(test_directory / "test_db");
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init("test_db", (test_directory / "test_db").c_str(), "mvcc", "disk"));
+  ASSERT_EQ(RC::SUCCESS, db->create_table("t", clustered_attrs(), StorageFormat::CLUSTERED_FORMAT));
+  Table *table = db->find_table("t");
+  ASSERT_NE(nullptr, table);
+  ASSERT_NE(nullptr, table->record_handler()->clustered_handler());
+
+  // 乱序插入，包括负数主键，数量足够让B+树分裂成多层
+  const int   row_num = 2000;
+  vector<int> ids;
+  for (int i = 0; i < row_num; i++) {
+    ids.push_back(i - row_num / 2);
+  }
+  shuffle(ids.begin(), ids.end(), mt19937(0));
+
+  TrxKit &trx_kit = db->trx_kit();
+  Trx    *trx     = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  for (int id : ids) {
+    ASSERT_EQ(RC::SUCCESS, insert_row(table, trx, id));
+  }
+  // 主键重复
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, insert_row(table, trx, ids.front()));
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  // 按照主键顺序遍历
+  vector<int> sorted_ids = ids;
+  sort(sorted_ids.begin(), sorted_ids.end());
+  ASSERT_EQ(sorted_ids, scan_ids(table));
+
+  // 主键区间 [-10, 20)
+  const int   left = -10, right = 20;
+  vector<int> range_ids;
+  for (int i = left; i < right; i++) {
+    range_ids.push_back(i);
+  }
+  ASSERT_EQ(range_ids, scan_ids(table, &left, &right));
+  ASSERT_EQ(vector<int>(sorted_ids.begin() + row_num / 2 + right, sorted_ids.end()), scan_ids(table, &right, nullptr));
+
+  // 按照RID(也就是主键)获取记录
+  Record record;
+  RID    rid = rid_of(123);
+  ASSERT_EQ(RC::SUCCESS, table->get_record(rid, record));
+  ASSERT_EQ(123, id_of(table, record));
+  ASSERT_EQ(1230, payload_of(table, record));
+
+  // 修改非主键字段
+  Value payload;
+  payload.set_int(-1);
+  ASSERT_EQ(RC::SUCCESS, table->update_record(record, "payload", &payload));
+  Record updated;
+  ASSERT_EQ(RC::SUCCESS, table->get_record(rid, updated));
+  ASSERT_EQ(-1, payload_of(table, updated));
+  ASSERT_EQ(123, id_of(table, updated));
+
+  // 不能修改主键
+  Value id_value;
+  id_value.set_int(row_num * 10);
+  ASSERT_EQ(RC::UNIMPLENMENT, table->update_record(updated, "id", &id_value));
+
+  // 删除一半的记录
+  trx = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  vector<int> remain_ids;
+  {
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, ReadWriteMode::READ_WRITE));
+    while (OB_SUCC(scanner.next(record))) {
+      if (id_of(table, record) % 2 == 0) {
+        ASSERT_EQ(RC::SUCCESS, trx->delete_record(table, record));
+      } else {
+        remain_ids.push_back(id_of(table, record));
+      }
+    }
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  trx = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  ASSERT_EQ(remain_ids, scan_ids(table, nullptr, nullptr, trx));
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  // MVCC 删除只是标记，记录物理删除之后主键才可以再插入
+  ASSERT_EQ(RC::SUCCESS, table->get_record(rid_of(0), record));
+  trx = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, insert_row(table, trx, 0));
+  ASSERT_EQ(RC::SUCCESS, table->delete_record(record));
+  ASSERT_EQ(RC::RECORD_NOT_EXIST, table->get_record(rid_of(0), record));
+  ASSERT_EQ(RC::SUCCESS, insert_row(table, trx, 0));
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+  const int zero = 0, one = 1;
+  ASSERT_EQ(vector<int>{0}, scan_ids(table, &zero, &one));
+
+  db.reset();
+  filesystem::remove_all(test_directory);
+}
+
+TEST(ClusteredTable, create_index_on_populated_table)
+{
+  // 创建索引会替换表的元数据，之后仍然可以按照主键访问记录
+  filesystem::path test_directory("clustered_table_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directories(test_directory / "test_db");
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init("test_db", (test_directory / "test_db").c_str(), "mvcc", "disk"));
+  ASSERT_EQ(RC::SUCCESS, db->create_table("t", clustered_attrs(), StorageFormat::CLUSTERED_FORMAT));
+  Table *table = db->find_table("t");
+  ASSERT_NE(nullptr, table);
+
+  const int row_num = 10;
+  TrxKit   &trx_kit = db->trx_kit();
+  Trx      *trx     = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  for (int i = row_num - 1; i >= 0; i--) {
+    ASSERT_EQ(RC::SUCCESS, insert_row(table, trx, i));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  trx = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  const TableMeta          &table_meta  = table->table_meta();
+  vector<const FieldMeta *> field_metas = {table_meta.null_field(), table_meta.field("payload")};
+  ASSERT_EQ(RC::SUCCESS, table->create_index(trx, false, field_metas, "i_payload"));
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  vector<int> expected;
+  for (int i = 0; i < row_num; i++) {
+    expected.push_back(i);
+  }
+  ASSERT_EQ(expected, scan_ids(table));
+
+  const int left = 3, right = 7;
+  ASSERT_EQ(vector<int>({3, 4, 5, 6}), scan_ids(table, &left, &right));
+
+  Record record;
+  ASSERT_EQ(RC::SUCCESS, table->get_record(rid_of(5), record));
+  ASSERT_EQ(5, id_of(table, record));
+  ASSERT_EQ(50, payload_of(table, record));
+
+  // 新插入的记录同时写入二级索引
+  trx = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  ASSERT_EQ(RC::SUCCESS, insert_row(table, trx, row_num));
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, insert_row(table, trx, 0));
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+  expected.push_back(row_num);
+  ASSERT_EQ(expected, scan_ids(table));
+
+  db.reset();
+  filesystem::remove_all(test_directory);
+}
+
+TEST(ClusteredTable, recover)
+{
+  // 数据页面没有落地，使用B+树的日志恢复聚簇存放的记录
+  filesystem::path test_directory("clustered_table_test");
+  filesystem::remove_all(test_directory);
+  filesystem::path db_path  = test_directory / "test_db";
+  filesystem::path db_path2 = test_directory / "test_db2";
+  filesystem::create_directories(db_path);
+  filesystem::create_directories(db_path2);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init("test_db", db_path.c_str(), "mvcc", "disk"));
+  ASSERT_EQ(RC::SUCCESS, db->create_table("t", clustered_attrs(), StorageFormat::CLUSTERED_FORMAT));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+  Table *table = db->find_table("t");
+  ASSERT_NE(nullptr, table);
+
+  const int row_num = 500;
+  TrxKit   &trx_kit = db->trx_kit();
+  Trx      *trx     = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  for (int i = row_num - 1; i >= 0; i--) {
+    ASSERT_EQ(RC::SUCCESS, insert_row(table, trx, i));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  DiskLogHandler &log_handler = static_cast<DiskLogHandler &>(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, log_handler.wait_lsn(log_handler.current_lsn()));
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  auto db2 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db2->init("test_db2", db_path2.c_str(), "mvcc", "disk"));
+  Table *table2 = db2->find_table("t");
+  ASSERT_NE(nullptr, table2);
+
+  vector<int> expected;
+  for (int i = 0; i < row_num; i++) {
+    expected.push_back(i);
+  }
+  ASSERT_EQ(expected, scan_ids(table2));
+
+  db2.reset();
+  db.reset();
+  filesystem::remove_all(test_directory);
+}
@@ -151,6 +151,69 @@ TEST(DiskLogHandler, test_replay)
   // filesystem::remove_all(path);
 }
 
+TEST(DiskLogHandler, torn_tail)
+{
+  const char *path = "test_log_handler_torn_tail";
+  filesystem::remove_all(path);
+
+  const int times = 100;
+  {
+    DiskLogHandler  handler;
+    TestLogReplayer replayer;
+    ASSERT_EQ(RC::SUCCESS, handler.init(path));
+    ASSERT_EQ(RC::SUCCESS, handler.replay(replayer, 0));
+    ASSERT_EQ(RC::SUCCESS, handler.start());
+    for (int i = 0; i < times; ++i) {
+      LSN          lsn = 0;
+      vector<char> data(10);
+      ASSERT_EQ(RC::SUCCESS, handler.append(lsn, LogModule::Id::BUFFER_POOL, std::move(data)));
+    }
+    ASSERT_EQ(RC::SUCCESS, handler.stop());
+    ASSERT_EQ(RC::SUCCESS, handler.await_termination());
+  }
+
+  // 模拟崩溃时最后一条日志只写了一部分
+  vector<string> files;
+  {
+    LogFileManager file_manager;
+    ASSERT_EQ(RC::SUCCESS, file_manager.init(path, 1000));
+    ASSERT_EQ(RC::SUCCESS, file_manager.list_files(files, 0));
+  }
+  ASSERT_EQ(1, files.size());
+  const uintmax_t file_size = filesystem::file_size(files[0]);
+  {
+    ofstream ofs(files[0], ios::app | ios::binary);
+    ofs << "torn log entry";
+  }
+
+  DiskLogHandler  handler;
+  TestLogReplayer replayer;
+  ASSERT_EQ(RC::SUCCESS, handler.init(path));
+  ASSERT_EQ(RC::SUCCESS, handler.replay(replayer, 0));
+  ASSERT_EQ(times, replayer.count());
+  ASSERT_EQ(times, handler.current_lsn());
+  ASSERT_EQ(file_size, filesystem::file_size(files[0]));
+
+  // 截断之后新的日志可以接着写，并且能读出来
+  ASSERT_EQ(RC::SUCCESS, handler.start());
+  for (int i = 0; i < times; ++i) {
+    LSN          lsn = 0;
+    vector<char> data(10);
+    ASSERT_EQ(RC::SUCCESS, handler.append(lsn, LogModule::Id::BUFFER_POOL, std::move(data)));
+  }
+  ASSERT_EQ(RC::SUCCESS, handler.stop());
+  ASSERT_EQ(RC::SUCCESS, handler.await_termination());
+
+  int count = 0;
+  ASSERT_EQ(RC::SUCCESS, handler.iterate([&count](LogEntry &) -> RC {
+    count++;
+    return RC::SUCCESS;
+  }, 0));
+  ASSERT_EQ(times * 2, count);
+
+  filesystem::remove_all(path);
+}
+
 TEST(DiskLogHandler, multi_thread)
 {
   const char *directory = "test_log_handler_multi_thread";
@@ -180,6 +243,51 @@ TEST(DiskLogHandler, multi_thread)
   ASSERT_EQ(RC::SUCCESS, handler.await_termination());
 }
 
+TEST(DiskLogHandler, commit_policy)
+{
+  // every commit policy should wake up the committers and keep all log entries after restart
+  const char *directory = "test_log_handler_commit_policy";
+
+  for (LogCommitPolicy policy : {LogCommitPolicy::SYNC_PER_GROUP, LogCommitPolicy::SYNC_INTERVAL, LogCommitPolicy::NO_SYNC}) {
+    filesystem::remove_all(directory);
+
+    DiskLogHandler  handler;
+    TestLogReplayer replayer;
+    ASSERT_EQ(RC::SUCCESS, handler.init(directory));
+    handler.set_commit_policy(policy, 10);
+    ASSERT_EQ(RC::SUCCESS, handler.replay(replayer, 0));
+    ASSERT_EQ(RC::SUCCESS, handler.start());
+
+    const int          times = 2500;
+    ThreadPoolExecutor executor;
+    ASSERT_EQ(0, executor.init("TestCommitPolicy", 8, 8, 60 * 1000));
+
+    for (int i = 0; i < times; ++i) {
+      ASSERT_EQ(0, executor.execute([&handler]() -> void {
+        LSN          lsn = 0;
+        vector<char> data(10);
+        ASSERT_EQ(handler.append(lsn, LogModule::Id::BUFFER_POOL, std::move(data)), RC::SUCCESS);
+        ASSERT_EQ(RC::SUCCESS, handler.wait_lsn(lsn));
+        ASSERT_GE(handler.current_committed_lsn(), lsn);
+      }));
+    }
+
+    ASSERT_EQ(0, executor.shutdown());
+    ASSERT_EQ(0, executor.await_termination());
+    ASSERT_EQ(handler.current_committed_lsn(), times);
+    ASSERT_EQ(RC::SUCCESS, handler.stop());
+    ASSERT_EQ(RC::SUCCESS, handler.await_termination());
+
+    DiskLogHandler  handler2;
+    TestLogReplayer replayer2;
+    ASSERT_EQ(RC::SUCCESS, handler2.init(directory));
+    ASSERT_EQ(RC::SUCCESS, handler2.replay(replayer2, 0));
+    ASSERT_EQ(times, replayer2.count());
+  }
+
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
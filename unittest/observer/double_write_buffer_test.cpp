@@ -12,10 +12,13 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai on 2024/04/19
 //
 
+#include <fcntl.h>
+#include <unistd.h>
 #include <filesystem>
 
 #include "gtest/gtest.h"
 
+#include "common/io/io.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/buffer/double_write_buffer.h"
 #include "storage/clog/vacuous_log_handler.h"
@@ -201,6 +204,97 @@ TEST(DoubleWriteBuffer, single_file_exception)
   bpm  = nullptr;
 }
 
+TEST(DoubleWriteBuffer, torn_page_recover)
+{
+  /*
+  测试页面写回数据文件时写坏了，
+  一批页面写入double write buffer后，把数据文件中的一个页面写坏，
+  同时把double write buffer文件最后一个页面截断，模拟写了一半的情况
+  重启后写坏的页面可以从double write buffer中恢复，截断的页面不会覆盖数据文件
+  */
+  filesystem::path directory("double_write_buffer_test_torn_page_dir");
+  filesystem::remove_all(directory);
+  filesystem::create_directories(directory);
+
+  filesystem::path src_path = directory / "src";
+  filesystem::create_directories(src_path);
+  filesystem::path dst_path = directory / "dst";
+  filesystem::path buffer_pool_filename         = src_path / "buffer_pool.bp";
+  filesystem::path double_write_buffer_filename = src_path / "double_write_buffer.dwb";
+
+  const int batch_pages = 8;
+
+  auto              bpm = make_unique<BufferPoolManager>();
+  VacuousLogHandler log_handler;
+  auto              double_write_buffer = make_unique<DiskDoubleWriteBuffer>(*bpm, batch_pages);
+  ASSERT_EQ(RC::SUCCESS, double_write_buffer->open_file(double_write_buffer_filename.c_str()));
+  ASSERT_EQ(bpm->init(std::move(double_write_buffer)), RC::SUCCESS);
+
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(buffer_pool_filename.c_str()));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, buffer_pool_filename.c_str(), buffer_pool));
+
+  const int page_count = batch_pages * 2;
+  for (int i = 0; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    ASSERT_EQ(i + 1, frame->page_num());
+    memset(frame->data(), 'a', BP_PAGE_DATA_SIZE);
+    frame->mark_dirty();
+    frame->unpin();
+  }
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->flush_all_pages());
+  auto disk_double_write_buffer = static_cast<DiskDoubleWriteBuffer *>(bpm->get_dblwr_buffer());
+  ASSERT_EQ(RC::SUCCESS, disk_double_write_buffer->flush_page());
+
+  // 修改刚好一批页面，最后一个页面加入时整批写入磁盘
+  for (PageNum page_num = 1; page_num <= batch_pages; page_num++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(page_num, &frame));
+    memset(frame->data(), 'b', BP_PAGE_DATA_SIZE);
+    frame->mark_dirty();
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->flush_page(*frame));
+    frame->unpin();
+  }
+
+  filesystem::copy(src_path, dst_path, filesystem::copy_options::recursive);
+  bpm = nullptr;
+
+  filesystem::path buffer_pool_filename2         = dst_path / "buffer_pool.bp";
+  filesystem::path double_write_buffer_filename2 = dst_path / "double_write_buffer.dwb";
+
+  const PageNum torn_page_num = 4;
+  int           fd            = open(buffer_pool_filename2.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  vector<char> garbage(BP_PAGE_SIZE / 2, 'x');
+  ASSERT_EQ(0, pwriten(fd, garbage.data(), garbage.size(), (int64_t)torn_page_num * BP_PAGE_SIZE));
+  close(fd);
+
+  filesystem::resize_file(double_write_buffer_filename2, filesystem::file_size(double_write_buffer_filename2) - 100);
+
+  auto bpm2                 = make_unique<BufferPoolManager>();
+  auto double_write_buffer2 = make_unique<DiskDoubleWriteBuffer>(*bpm2, batch_pages);
+  ASSERT_EQ(RC::SUCCESS, double_write_buffer2->open_file(double_write_buffer_filename2.c_str()));
+  ASSERT_EQ(bpm2->init(std::move(double_write_buffer2)), RC::SUCCESS);
+
+  DiskBufferPool *buffer_pool2 = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm2->open_file(log_handler, buffer_pool_filename2.c_str(), buffer_pool2));
+  disk_double_write_buffer = static_cast<DiskDoubleWriteBuffer *>(bpm2->get_dblwr_buffer());
+  ASSERT_EQ(RC::SUCCESS, disk_double_write_buffer->recover());
+
+  vector<char> expected(BP_PAGE_DATA_SIZE);
+  for (PageNum page_num = 1; page_num <= page_count; page_num++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool2->get_this_page(page_num, &frame));
+    memset(expected.data(), page_num <= batch_pages ? 'b' : 'a', expected.size());
+    ASSERT_EQ(0, memcmp(expected.data(), frame->data(), expected.size())) << "page num=" << page_num;
+    frame->unpin();
+  }
+
+  bpm2 = nullptr;
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
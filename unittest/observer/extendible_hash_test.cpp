@@ -0,0 +1,371 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "common/lang/bitmap.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/integrated_log_replayer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/extendible_hash.h"
+
+using namespace std;
+using namespace common;
+
+namespace {
+
+/// 查找一个整数键值，返回按照 RID 排序的结果
+vector<RID> lookup(ExtendibleHashHandler &handler, int key)
+{
+  list<RID> rids;
+  EXPECT_EQ(RC::SUCCESS, handler.get_entries(reinterpret_cast<const char *>(&key), sizeof(key), rids));
+  vector<RID> result(rids.begin(), rids.end());
+  sort(result.begin(), result.end(), [](const RID &a, const RID &b) { return RID::compare(&a, &b) < 0; });
+  return result;
+}
+
+}  // namespace
+
+TEST(ExtendibleHash, insert_split_delete)
+{
+  filesystem::path test_directory = "extendible_hash_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+  const filesystem::path file_name = test_directory / "int.hash";
+
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  VacuousLogHandler log_handler;
+
+  FieldMeta id_field("id", AttrType::INTS, 0, 4, true, 0);
+  auto      handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::SUCCESS, handler->create(log_handler, *bpm, file_name.c_str(), false, {0}, {&id_field}));
+
+  const int insert_num = 20000;
+  vector<int> keys(insert_num);
+  for (int i = 0; i < insert_num; i++) {
+    keys[i] = i;
+  }
+  mt19937 generator(2024);
+  shuffle(keys.begin(), keys.end(), generator);
+
+  for (int key : keys) {
+    RID rid(key, key % 100);
+    ASSERT_EQ(RC::SUCCESS, handler->insert_entry(reinterpret_cast<const char *>(&key), &rid));
+  }
+  ASSERT_GT(handler->global_depth(), 0);
+  ASSERT_EQ(RC::SUCCESS, handler->validate());
+
+  // 同一个键值和RID重复插入
+  int key = 7;
+  RID rid(7, 7);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler->insert_entry(reinterpret_cast<const char *>(&key), &rid));
+
+  for (int i = 0; i < insert_num; i += 97) {
+    vector<RID> rids = lookup(*handler, i);
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(i, rids[0].page_num);
+    ASSERT_EQ(i % 100, rids[0].slot_num);
+  }
+  ASSERT_TRUE(lookup(*handler, insert_num + 1).empty());
+
+  // 删除偶数
+  for (int i = 0; i < insert_num; i += 2) {
+    RID rid(i, i % 100);
+    ASSERT_EQ(RC::SUCCESS, handler->delete_entry(reinterpret_cast<const char *>(&i), &rid));
+  }
+  key = 0;
+  rid = RID(0, 0);
+  ASSERT_EQ(RC::RECORD_NOT_EXIST, handler->delete_entry(reinterpret_cast<const char *>(&key), &rid));
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(i % 2, static_cast<int>(lookup(*handler, i).size()));
+  }
+
+  // 重新打开
+  handler.reset();
+  handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::SUCCESS, handler->open(log_handler, *bpm, file_name.c_str()));
+  ASSERT_EQ(RC::SUCCESS, handler->validate());
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(i % 2, static_cast<int>(lookup(*handler, i).size()));
+  }
+
+  handler.reset();
+  bpm.reset();
+}
+
+TEST(ExtendibleHash, duplicate_keys)
+{
+  filesystem::path test_directory = "extendible_hash_test_dir";
+  filesystem::create_directory(test_directory);
+  const filesystem::path file_name = test_directory / "duplicate.hash";
+  filesystem::remove(file_name);
+
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  VacuousLogHandler log_handler;
+
+  FieldMeta id_field("id", AttrType::INTS, 0, 4, true, 0);
+  auto      handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::SUCCESS, handler->create(log_handler, *bpm, file_name.c_str(), false, {0}, {&id_field}));
+
+  // 大量相同的键值无法通过分裂分开，需要使用溢出页面
+  const int dup_num = 3000;
+  for (int i = 0; i < dup_num; i++) {
+    int key = i % 3;
+    RID rid(i, 0);
+    ASSERT_EQ(RC::SUCCESS, handler->insert_entry(reinterpret_cast<const char *>(&key), &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, handler->validate());
+  ASSERT_EQ(dup_num / 3, lookup(*handler, 0).size());
+  ASSERT_EQ(dup_num / 3, lookup(*handler, 1).size());
+  ASSERT_EQ(dup_num / 3, lookup(*handler, 2).size());
+
+  // 删除后溢出页面被回收
+  for (int i = 0; i < dup_num; i += 3) {
+    int key = 0;
+    RID rid(i, 0);
+    ASSERT_EQ(RC::SUCCESS, handler->delete_entry(reinterpret_cast<const char *>(&key), &rid));
+  }
+  ASSERT_TRUE(lookup(*handler, 0).empty());
+  ASSERT_EQ(dup_num / 3, lookup(*handler, 1).size());
+  ASSERT_EQ(RC::SUCCESS, handler->validate());
+
+  handler.reset();
+  bpm.reset();
+}
+
+TEST(ExtendibleHash, multi_fields)
+{
+  filesystem::path test_directory = "extendible_hash_test_dir";
+  filesystem::create_directory(test_directory);
+  const filesystem::path file_name = test_directory / "multi.hash";
+  filesystem::remove(file_name);
+
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  VacuousLogHandler log_handler;
+
+  // 记录格式：null位图(4) name(16) age(4)
+  FieldMeta null_field("__null", AttrType::CHARS, 0, 4, false, 0);
+  FieldMeta name_field("name", AttrType::CHARS, 4, 16, true, 1);
+  FieldMeta age_field("age", AttrType::INTS, 20, 4, true, 2);
+  FieldMeta score_field("score", AttrType::FLOATS, 24, 4, true, 3);
+
+  auto handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::INVALID_ARGUMENT,
+      handler->create(log_handler, *bpm, file_name.c_str(), false, {0, 3}, {&null_field, &score_field}));
+  ASSERT_EQ(RC::SUCCESS,
+      handler->create(
+          log_handler, *bpm, file_name.c_str(), false, {0, 1, 2}, {&null_field, &name_field, &age_field}));
+  ASSERT_EQ(2, handler->key_attr_num());
+
+  auto make_record = [](const char *name, int age, bool age_is_null) {
+    vector<char> record(28, 0);
+    // 字段后面的内容不影响比较
+    memset(record.data() + 4, 'x', 16);
+    snprintf(record.data() + 4, 16, "%s", name);
+    memcpy(record.data() + 20, &age, sizeof(age));
+    if (age_is_null) {
+      Bitmap(record.data(), 32).set_bit(2);
+    }
+    return record;
+  };
+
+  const int num = 2000;
+  for (int i = 0; i < num; i++) {
+    vector<char> record = make_record(("name" + to_string(i % 500)).c_str(), i % 7, i % 10 == 0);
+    RID          rid(i, 0);
+    ASSERT_EQ(RC::SUCCESS, handler->insert_entry(record.data(), &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, handler->validate());
+
+  // 查找的键值是 name 和 age 的值，name 可以比字段短
+  for (int i = 0; i < 500; i += 13) {
+    string name = "name" + to_string(i);
+    for (int age = 0; age < 7; age++) {
+      int expected = 0;
+      for (int j = i; j < num; j += 500) {
+        expected += (j % 7 == age && j % 10 != 0) ? 1 : 0;
+      }
+
+      string key(16, '\0');
+      memcpy(key.data(), name.data(), name.size());
+      key.append(reinterpret_cast<const char *>(&age), sizeof(age));
+
+      list<RID>    rids;
+      vector<char> keys;
+      ASSERT_EQ(RC::SUCCESS, handler->get_entries(key.data(), static_cast<int>(key.size()), rids, &keys));
+      ASSERT_EQ(expected, static_cast<int>(rids.size()));
+      ASSERT_EQ(rids.size() * handler->key_length(), keys.size());
+    }
+  }
+
+  handler.reset();
+  bpm.reset();
+}
+
+TEST(ExtendibleHash, unique)
+{
+  filesystem::path test_directory = "extendible_hash_test_dir";
+  filesystem::create_directory(test_directory);
+  const filesystem::path file_name      = test_directory / "unique.hash";
+  const filesystem::path null_file_name = test_directory / "unique_null.hash";
+  filesystem::remove(file_name);
+  filesystem::remove(null_file_name);
+
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  VacuousLogHandler log_handler;
+
+  FieldMeta id_field("id", AttrType::INTS, 0, 4, true, 0);
+  auto      handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::SUCCESS, handler->create(log_handler, *bpm, file_name.c_str(), true, {0}, {&id_field}));
+  ASSERT_TRUE(handler->unique());
+
+  const int insert_num = 5000;
+  for (int i = 0; i < insert_num; i++) {
+    RID rid(i, 0);
+    ASSERT_EQ(RC::SUCCESS, handler->insert_entry(reinterpret_cast<const char *>(&i), &rid));
+  }
+
+  // 相同的键值，不同的RID
+  for (int i = 0; i < insert_num; i += 7) {
+    RID rid(i, 1);
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler->insert_entry(reinterpret_cast<const char *>(&i), &rid));
+    ASSERT_EQ(1, lookup(*handler, i).size());
+  }
+  ASSERT_EQ(RC::SUCCESS, handler->validate());
+
+  // 删除之后可以再插入
+  int key = 3;
+  RID rid(3, 0);
+  ASSERT_EQ(RC::SUCCESS, handler->delete_entry(reinterpret_cast<const char *>(&key), &rid));
+  rid = RID(3, 1);
+  ASSERT_EQ(RC::SUCCESS, handler->insert_entry(reinterpret_cast<const char *>(&key), &rid));
+
+  // 唯一性保存在文件头中，重新打开之后仍然生效
+  handler.reset();
+  handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::SUCCESS, handler->open(log_handler, *bpm, file_name.c_str()));
+  ASSERT_TRUE(handler->unique());
+  rid = RID(3, 2);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler->insert_entry(reinterpret_cast<const char *>(&key), &rid));
+
+  // 包含null的键值不冲突。记录格式：null位图(4) age(4)
+  FieldMeta null_field("__null", AttrType::CHARS, 0, 4, false, 0);
+  FieldMeta age_field("age", AttrType::INTS, 4, 4, true, 1);
+  auto      null_handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::SUCCESS,
+      null_handler->create(log_handler, *bpm, null_file_name.c_str(), true, {0, 1}, {&null_field, &age_field}));
+
+  char record[8] = {0};
+  Bitmap(record, 32).set_bit(1);
+  for (int i = 0; i < 3; i++) {
+    RID null_rid(i, 0);
+    ASSERT_EQ(RC::SUCCESS, null_handler->insert_entry(record, &null_rid));
+  }
+  Bitmap(record, 32).clear_bit(1);
+  RID not_null_rid(10, 0);
+  ASSERT_EQ(RC::SUCCESS, null_handler->insert_entry(record, &not_null_rid));
+  not_null_rid = RID(11, 0);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, null_handler->insert_entry(record, &not_null_rid));
+
+  null_handler.reset();
+  handler.reset();
+  bpm.reset();
+}
+
+TEST(ExtendibleHash, redo)
+{
+  filesystem::path test_directory = "extendible_hash_redo_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const filesystem::path file_name     = test_directory / "redo.hash";
+  const filesystem::path log_directory = test_directory / "clog";
+
+  // 1. 创建哈希索引并写入日志，关闭之后复制一份文件用于重做
+  const filesystem::path copied_file_name = test_directory / "redo2.hash";
+  const int              insert_num       = 10000;
+  {
+    auto bpm = make_unique<BufferPoolManager>();
+    ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+    auto log_handler = make_unique<DiskLogHandler>();
+    ASSERT_EQ(RC::SUCCESS, log_handler->init(log_directory.c_str()));
+    IntegratedLogReplayer log_replayer(*bpm);
+    ASSERT_EQ(RC::SUCCESS, log_handler->replay(log_replayer, 0));
+    ASSERT_EQ(RC::SUCCESS, log_handler->start());
+
+    FieldMeta id_field("id", AttrType::INTS, 0, 4, true, 0);
+    auto      handler = make_unique<ExtendibleHashHandler>();
+    ASSERT_EQ(RC::SUCCESS, handler->create(*log_handler, *bpm, file_name.c_str(), false, {0}, {&id_field}));
+
+    for (int i = 0; i < insert_num; i++) {
+      int key = i % 4000;  // 包含重复键值
+      RID rid(i, 1);
+      ASSERT_EQ(RC::SUCCESS, handler->insert_entry(reinterpret_cast<const char *>(&key), &rid));
+    }
+    for (int i = 0; i < insert_num; i += 5) {
+      int key = i % 4000;
+      RID rid(i, 1);
+      ASSERT_EQ(RC::SUCCESS, handler->delete_entry(reinterpret_cast<const char *>(&key), &rid));
+    }
+    ASSERT_GT(handler->global_depth(), 0);
+
+    ASSERT_EQ(RC::SUCCESS, log_handler->stop());
+    ASSERT_EQ(RC::SUCCESS, log_handler->await_termination());
+    handler.reset();
+    bpm.reset();
+    log_handler.reset();
+  }
+  ASSERT_TRUE(filesystem::copy_file(file_name, copied_file_name));
+
+  // 2. 在复制的文件上重做日志
+  auto bpm = make_unique<BufferPoolManager>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  auto log_handler = make_unique<DiskLogHandler>();
+  ASSERT_EQ(RC::SUCCESS, log_handler->init(log_directory.c_str()));
+
+  // 与数据库启动的顺序相同，先打开索引再重做日志
+  auto handler = make_unique<ExtendibleHashHandler>();
+  ASSERT_EQ(RC::SUCCESS, handler->open(*log_handler, *bpm, copied_file_name.c_str()));
+
+  IntegratedLogReplayer log_replayer(*bpm);
+  ASSERT_EQ(RC::SUCCESS, log_handler->replay(log_replayer, 0));
+
+  ASSERT_GT(handler->global_depth(), 0);
+  ASSERT_EQ(RC::SUCCESS, handler->validate());
+  for (int key = 0; key < 4000; key++) {
+    int expected = 0;
+    for (int i = key; i < insert_num; i += 4000) {
+      expected += (i % 5 != 0) ? 1 : 0;
+    }
+    ASSERT_EQ(expected, static_cast<int>(lookup(*handler, key).size()));
+  }
+
+  handler.reset();
+  bpm.reset();
+  log_handler.reset();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
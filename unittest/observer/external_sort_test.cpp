@@ -0,0 +1,349 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "operator_test_util.h"
+#include "sql/operator/external_sorter.h"
+#include "sql/operator/orderby_physical_operator.h"
+
+using namespace std;
+
+namespace {
+
+Value null_value()
+{
+  Value value;
+  value.set_null();
+  return value;
+}
+
+int sign(int value) { return value < 0 ? -1 : (value > 0 ? 1 : 0); }
+
+/// 与原来的排序算子相同的比较方式：升序时NULL在前面，降序时NULL在后面
+int compare_sort_value(const Value &left, const Value &right, bool asc)
+{
+  int result = 0;
+  if (left.is_null() || right.is_null()) {
+    result = left.is_null() == right.is_null() ? 0 : (left.is_null() ? -1 : 1);
+  } else {
+    result = sign(left.compare(right));
+  }
+  return asc ? result : -result;
+}
+
+int compare_encoded(const Value &left, const Value &right, bool asc)
+{
+  string left_key;
+  string right_key;
+  SortKeyEncoder::append(left, asc, left_key);
+  SortKeyEncoder::append(right, asc, right_key);
+  return sign(left_key.compare(right_key));
+}
+
+Value random_value(mt19937 &random, AttrType type)
+{
+  Value value;
+  if (random() % 8 == 0) {
+    value.set_null();
+    return value;
+  }
+  switch (type) {
+    case AttrType::INTS: value.set_int(static_cast<int>(random() % 2001) - 1000); break;
+    case AttrType::FLOATS: value.set_float((static_cast<int>(random() % 2001) - 1000) * 0.5f); break;
+    case AttrType::DOUBLES: value.set_double((static_cast<int>(random() % 200001) - 100000) * 0.25); break;
+    case AttrType::DATES: value.set_date(19000101 + static_cast<int>(random() % 1500000)); break;
+    default: {
+      string s(random() % 6, 'a');
+      for (char &c : s) {
+        c = static_cast<char>('a' + random() % 3);
+      }
+      value.set_string(s.c_str(), static_cast<int>(s.size()));
+    } break;
+  }
+  return value;
+}
+
+struct SortRow
+{
+  vector<Value> keys;
+  vector<Value> payload;
+};
+
+/// 随机生成的行，第一个排序字段是整数，第二个是字符串，payload 中记录行号
+vector<SortRow> make_rows(int num, unsigned seed)
+{
+  mt19937         random(seed);
+  vector<SortRow> rows;
+  for (int i = 0; i < num; i++) {
+    SortRow row;
+    row.keys.push_back(random_value(random, AttrType::INTS));
+    row.keys.push_back(random_value(random, AttrType::CHARS));
+    row.payload.push_back(Value(i));
+    row.payload.push_back(row.keys[1]);
+    row.payload.push_back(Value(static_cast<float>(i) / 4));
+    rows.emplace_back(std::move(row));
+  }
+  return rows;
+}
+
+/// 使用 std::stable_sort 计算期望的顺序，返回行号
+vector<int> expected_order(const vector<SortRow> &rows, const vector<bool> &asc, size_t limit = numeric_limits<size_t>::max())
+{
+  vector<int> order(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    order[i] = static_cast<int>(i);
+  }
+  stable_sort(order.begin(), order.end(), [&](int left, int right) {
+    for (size_t i = 0; i < asc.size(); i++) {
+      int result = compare_sort_value(rows[left].keys[i], rows[right].keys[i], asc[i]);
+      if (result != 0) {
+        return result < 0;
+      }
+    }
+    return false;
+  });
+  order.resize(min(limit, order.size()));
+  return order;
+}
+
+/// 把随机生成的行作为算子的输入，每一行是 (行号, 整数, 字符串)
+unique_ptr<PhysicalOperator> make_rows_operator(const vector<SortRow> &sort_rows)
+{
+  vector<vector<Value>> rows;
+  for (const SortRow &row : sort_rows) {
+    rows.push_back({row.payload[0], row.keys[0], row.keys[1]});
+  }
+  return make_unique<RowsPhysicalOperator>("t", 3, std::move(rows));
+}
+
+vector<int> sort_rows(ExternalSorter &sorter, const vector<SortRow> &rows)
+{
+  for (const SortRow &row : rows) {
+    EXPECT_EQ(RC::SUCCESS, sorter.add(row.keys, row.payload));
+  }
+  EXPECT_EQ(RC::SUCCESS, sorter.finish());
+
+  vector<int>   order;
+  vector<Value> payload;
+  RC            rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = sorter.next(payload))) {
+    EXPECT_EQ(3, static_cast<int>(payload.size()));
+    const SortRow &row = rows.at(payload[0].get_int());
+    EXPECT_EQ(0, compare_sort_value(row.payload[1], payload[1], true));
+    EXPECT_EQ(row.payload[2].get_float(), payload[2].get_float());
+    order.push_back(payload[0].get_int());
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  return order;
+}
+
+}  // namespace
+
+TEST(SortKeyEncoder, order_matches_compare)
+{
+  mt19937 random(1);
+  for (AttrType type :
+      {AttrType::INTS, AttrType::FLOATS, AttrType::DOUBLES, AttrType::DATES, AttrType::CHARS}) {
+    for (int i = 0; i < 2000; i++) {
+      Value left  = random_value(random, type);
+      Value right = random_value(random, type);
+      for (bool asc : {true, false}) {
+        ASSERT_EQ(compare_sort_value(left, right, asc), compare_encoded(left, right, asc))
+            << "type=" << attr_type_to_string(type) << ", left=" << left.to_string()
+            << ", right=" << right.to_string() << ", asc=" << asc;
+      }
+    }
+  }
+
+  ASSERT_EQ(-1, compare_encoded(Value(false), Value(true), true));
+  ASSERT_EQ(1, compare_encoded(Value(false), Value(true), false));
+  ASSERT_EQ(0, compare_encoded(Value(true), Value(true), true));
+
+  // 不同类型的数值按照数值比较
+  Value int_value(3);
+  Value float_value(2.5f);
+  ASSERT_EQ(1, compare_encoded(int_value, float_value, true));
+  ASSERT_EQ(-1, compare_encoded(Value(-3), Value(-2.5f), true));
+  ASSERT_EQ(0, compare_encoded(Value(0.0f), Value(-0.0f), true));
+
+  // 字符串的前缀排在前面，多个字段时前一个字段的长度不会影响后面的字段
+  ASSERT_EQ(-1, compare_encoded(Value("ab"), Value("abc"), true));
+  ASSERT_EQ(1, compare_encoded(Value("ab"), Value("abc"), false));
+  string left_key;
+  string right_key;
+  SortKeyEncoder::encode({Value("a"), Value(9)}, {false, true}, left_key);
+  SortKeyEncoder::encode({Value("ab"), Value(1)}, {false, true}, right_key);
+  ASSERT_GT(left_key.compare(right_key), 0);
+
+  // 升序时NULL在最前面，降序时在最后面
+  ASSERT_EQ(-1, compare_encoded(null_value(), Value(-1000), true));
+  ASSERT_EQ(1, compare_encoded(null_value(), Value(-1000), false));
+}
+
+TEST(LoserTree, merge)
+{
+  mt19937 random(2);
+  for (int ways = 1; ways <= 17; ways++) {
+    vector<vector<int>> inputs(ways);
+    vector<int>         expected;
+    for (vector<int> &input : inputs) {
+      const int num = random() % 20;  // 可能有空的输入
+      for (int i = 0; i < num; i++) {
+        input.push_back(random() % 50);
+      }
+      sort(input.begin(), input.end());
+      expected.insert(expected.end(), input.begin(), input.end());
+    }
+    sort(expected.begin(), expected.end());
+
+    vector<size_t> positions(ways, 0);
+    auto           eof = [&](int way) { return positions[way] >= inputs[way].size(); };
+    LoserTree      tree;
+    tree.init(ways, [&](int left, int right) {
+      if (eof(left) || eof(right)) {
+        return !eof(left);
+      }
+      return inputs[left][positions[left]] < inputs[right][positions[right]];
+    });
+
+    vector<int> result;
+    for (int way = tree.winner(); !eof(way); way = tree.winner()) {
+      result.push_back(inputs[way][positions[way]++]);
+      tree.replay(way);
+    }
+    ASSERT_EQ(expected, result) << "ways=" << ways;
+  }
+}
+
+TEST(ExternalSorter, in_memory)
+{
+  vector<SortRow> rows = make_rows(3000, 3);
+  vector<bool>    asc  = {true, false};
+
+  ExternalSorter sorter(asc, SortOptions());
+  ASSERT_EQ(expected_order(rows, asc), sort_rows(sorter, rows));
+  ASSERT_EQ(0, sorter.spilled_runs());
+
+  // reset 之后可以重新排序
+  sorter.reset();
+  ASSERT_EQ(expected_order(rows, asc), sort_rows(sorter, rows));
+}
+
+TEST(ExternalSorter, spill)
+{
+  vector<SortRow> rows = make_rows(30000, 4);
+  vector<bool>    asc  = {false, true};
+
+  SortOptions options;
+  options.memory     = SortOptions::MIN_MEMORY;
+  options.merge_ways = 64;
+
+  ExternalSorter sorter(asc, options);
+  ASSERT_EQ(expected_order(rows, asc), sort_rows(sorter, rows));
+  ASSERT_GT(sorter.spilled_runs(), 1);
+  ASSERT_LE(sorter.spilled_runs(), options.merge_ways);
+}
+
+TEST(ExternalSorter, multi_pass_merge)
+{
+  vector<SortRow> rows = make_rows(30000, 5);
+  vector<bool>    asc  = {true, true};
+
+  SortOptions options;
+  options.memory     = SortOptions::MIN_MEMORY;
+  options.merge_ways = 3;
+
+  SortOptions one_pass = options;
+  one_pass.merge_ways  = 1000;
+  ExternalSorter one_pass_sorter(asc, one_pass);
+  ASSERT_EQ(expected_order(rows, asc), sort_rows(one_pass_sorter, rows));
+  const int initial_runs = one_pass_sorter.spilled_runs();
+  ASSERT_GT(initial_runs, options.merge_ways);
+
+  // 顺串的个数超过归并的路数，需要先归并出一些中间的顺串
+  ExternalSorter sorter(asc, options);
+  ASSERT_EQ(expected_order(rows, asc), sort_rows(sorter, rows));
+  ASSERT_GT(sorter.spilled_runs(), initial_runs);
+}
+
+TEST(ExternalSorter, top_n)
+{
+  vector<SortRow> rows = make_rows(5000, 6);
+  vector<bool>    asc  = {false, true};
+
+  for (int64_t limit : {0, 1, 10, 100, 5000, 8000}) {
+    SortOptions options;
+    options.memory = SortOptions::MIN_MEMORY;  // top-N 只保留 limit 行，不会写临时文件
+
+    ExternalSorter sorter(asc, options, limit);
+    ASSERT_EQ(expected_order(rows, asc, limit), sort_rows(sorter, rows)) << "limit=" << limit;
+    ASSERT_EQ(0, sorter.spilled_runs());
+  }
+}
+
+TEST(OrderByPhysicalOperator, sort)
+{
+  // 每一行是 (行号, 整数, 字符串)，按照整数降序、字符串升序排列
+  vector<SortRow> sort_rows = make_rows(20000, 7);
+  vector<bool>    asc       = {false, true};
+
+  for (int64_t limit : {-1, 15}) {
+    vector<unique_ptr<OrderByUnit>> units;
+    units.emplace_back(new OrderByUnit(new CellExpr(1), false));
+    units.emplace_back(new OrderByUnit(new CellExpr(2), true));
+    vector<unique_ptr<Expression>> exprs;
+    exprs.emplace_back(new CellExpr(0));
+    exprs.emplace_back(new CellExpr(2));
+
+    SortOptions options;
+    options.memory     = SortOptions::MIN_MEMORY;
+    options.merge_ways = 4;
+
+    OrderByPhysicalOperator oper(std::move(units), std::move(exprs));
+    oper.set_options(options);
+    oper.set_limit(limit);
+    oper.add_child(make_rows_operator(sort_rows));
+
+    ASSERT_EQ(RC::SUCCESS, oper.open(nullptr));
+    if (limit < 0) {
+      ASSERT_GT(oper.spilled_runs(), options.merge_ways);
+    }
+
+    vector<int> order;
+    RC          rc = RC::SUCCESS;
+    while (RC::SUCCESS == (rc = oper.next())) {
+      Tuple *tuple = oper.current_tuple();
+      ASSERT_EQ(2, tuple->cell_num());
+      Value index;
+      Value str;
+      ASSERT_EQ(RC::SUCCESS, tuple->cell_at(0, index));
+      ASSERT_EQ(RC::SUCCESS, tuple->cell_at(1, str));
+      ASSERT_EQ(0, compare_sort_value(sort_rows[index.get_int()].keys[1], str, true));
+      order.push_back(index.get_int());
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    ASSERT_EQ(RC::SUCCESS, oper.close());
+
+    ASSERT_EQ(expected_order(sort_rows, asc, limit < 0 ? sort_rows.size() : limit), order) << "limit=" << limit;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
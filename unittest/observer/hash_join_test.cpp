@@ -0,0 +1,180 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "operator_test_util.h"
+#include "sql/operator/hash_join_physical_operator.h"
+
+using namespace std;
+using namespace common;
+
+vector<vector<Value>> make_rows(int num, int key_mod, int id_base)
+{
+  vector<vector<Value>> rows;
+  for (int i = 0; i < num; i++) {
+    rows.push_back({Value(i % key_mod), Value(id_base + i)});
+  }
+  return rows;
+}
+
+string row_to_string(const Tuple &tuple)
+{
+  string result;
+  for (int i = 0; i < tuple.cell_num(); i++) {
+    Value value;
+    EXPECT_EQ(RC::SUCCESS, tuple.cell_at(i, value));
+    result += value.to_string() + ",";
+  }
+  return result;
+}
+
+/// 使用嵌套循环计算期望的结果
+vector<string> expected_join(const vector<vector<Value>> &left, const vector<vector<Value>> &right)
+{
+  vector<string> result;
+  for (const vector<Value> &left_row : left) {
+    for (const vector<Value> &right_row : right) {
+      if (left_row[0].compare(right_row[0]) != 0) {
+        continue;
+      }
+      string row;
+      for (const Value &value : left_row) {
+        row += value.to_string() + ",";
+      }
+      for (const Value &value : right_row) {
+        row += value.to_string() + ",";
+      }
+      result.push_back(row);
+    }
+  }
+  sort(result.begin(), result.end());
+  return result;
+}
+
+unique_ptr<HashJoinPhysicalOperator> make_join(
+    const vector<vector<Value>> &left, const vector<vector<Value>> &right, const HashJoinOptions &options)
+{
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  left_keys.emplace_back(new CellExpr(0));
+  right_keys.emplace_back(new CellExpr(0));
+
+  auto join = make_unique<HashJoinPhysicalOperator>(std::move(left_keys), std::move(right_keys), options);
+  join->add_child(make_unique<RowsPhysicalOperator>("l", 2, left));
+  join->add_child(make_unique<RowsPhysicalOperator>("r", 2, right));
+  return join;
+}
+
+vector<string> run_join(HashJoinPhysicalOperator &join)
+{
+  vector<string> result;
+  EXPECT_EQ(RC::SUCCESS, join.open(nullptr));
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc = join.next())) {
+    result.push_back(row_to_string(*join.current_tuple()));
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  EXPECT_EQ(RC::SUCCESS, join.close());
+  sort(result.begin(), result.end());
+  return result;
+}
+
+TEST(HashJoinTest, in_memory)
+{
+  vector<vector<Value>> left  = make_rows(100, 100, 0);
+  vector<vector<Value>> right = make_rows(300, 150, 1000);
+
+  auto join = make_join(left, right, HashJoinOptions());
+  ASSERT_EQ(expected_join(left, right), run_join(*join));
+  ASSERT_FALSE(join->spilled());
+
+  // 再执行一次结果相同
+  ASSERT_EQ(expected_join(left, right), run_join(*join));
+}
+
+TEST(HashJoinTest, build_on_smaller_side)
+{
+  vector<vector<Value>> small_rows = make_rows(10, 5, 0);
+  vector<vector<Value>> large_rows = make_rows(50, 10, 1000);
+
+  auto join = make_join(small_rows, large_rows, HashJoinOptions());
+  ASSERT_EQ(expected_join(small_rows, large_rows), run_join(*join));
+  ASSERT_EQ(0, join->build_side());
+
+  join = make_join(large_rows, small_rows, HashJoinOptions());
+  ASSERT_EQ(expected_join(large_rows, small_rows), run_join(*join));
+  ASSERT_EQ(1, join->build_side());
+}
+
+TEST(HashJoinTest, empty_and_null)
+{
+  vector<vector<Value>> left = make_rows(10, 10, 0);
+  vector<vector<Value>> empty_rows;
+
+  auto join = make_join(left, empty_rows, HashJoinOptions());
+  ASSERT_TRUE(run_join(*join).empty());
+
+  join = make_join(empty_rows, left, HashJoinOptions());
+  ASSERT_TRUE(run_join(*join).empty());
+
+  // 与比较表达式相同，两个NULL认为相等
+  Value null_value;
+  null_value.set_null();
+  vector<vector<Value>> right = {{null_value, Value(1)}, {Value(3), Value(2)}};
+  left.push_back({null_value, Value(100)});
+
+  join = make_join(left, right, HashJoinOptions());
+  ASSERT_EQ(expected_join(left, right), run_join(*join));
+  ASSERT_EQ(2, static_cast<int>(run_join(*join).size()));
+}
+
+TEST(HashJoinTest, string_keys)
+{
+  vector<vector<Value>> left;
+  vector<vector<Value>> right;
+  for (int i = 0; i < 50; i++) {
+    string key = "key" + to_string(i % 20);
+    left.push_back({Value(key.c_str()), Value(i)});
+    right.push_back({Value(key.c_str()), Value(i + 1000)});
+  }
+
+  auto join = make_join(left, right, HashJoinOptions());
+  ASSERT_EQ(expected_join(left, right), run_join(*join));
+}
+
+TEST(HashJoinTest, spill)
+{
+  vector<vector<Value>> left  = make_rows(3000, 1000, 0);
+  vector<vector<Value>> right = make_rows(5000, 2000, 10000);
+
+  HashJoinOptions options;
+  options.memory     = 16 * 1024;
+  options.partitions = 4;
+
+  auto join = make_join(left, right, options);
+  ASSERT_EQ(expected_join(left, right), run_join(*join));
+  ASSERT_TRUE(join->spilled());
+
+  // 大量重复的键值，分区之后仍然超过内存限制，最多分几层之后直接在内存中处理
+  left  = make_rows(400, 3, 0);
+  right = make_rows(400, 3, 10000);
+  join  = make_join(left, right, options);
+  ASSERT_EQ(expected_join(left, right), run_join(*join));
+  ASSERT_TRUE(join->spilled());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
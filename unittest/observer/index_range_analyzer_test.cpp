@@ -0,0 +1,160 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+
+#include "sql/expr/expression.h"
+#include "sql/optimizer/index_range_analyzer.h"
+#include "storage/field/field_meta.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+class IndexRangeAnalyzerTest : public ::testing::Test
+{
+protected:
+  unique_ptr<Expression> field(const FieldMeta &meta)
+  {
+    auto expr = make_unique<FieldExpr>();
+    expr->field().set_field(&meta);
+    return expr;
+  }
+
+  void add(CompOp comp, const FieldMeta &meta, int value)
+  {
+    predicates_.emplace_back(new ComparisonExpr(comp, field(meta), make_unique<ValueExpr>(Value(value))));
+  }
+
+  void add_in(const FieldMeta &meta, const vector<int> &values)
+  {
+    vector<unique_ptr<Expression>> exprs;
+    for (int value : values) {
+      exprs.emplace_back(new ValueExpr(Value(value)));
+    }
+    predicates_.emplace_back(
+        new ComparisonExpr(IN_OP, field(meta), make_unique<ExprListExpr>(std::move(exprs))));
+  }
+
+protected:
+  FieldMeta a_{"a", AttrType::INTS, 4, 4, true, 1};
+  FieldMeta b_{"b", AttrType::INTS, 8, 4, true, 2};
+  FieldMeta c_{"c", AttrType::INTS, 12, 4, true, 3};
+
+  vector<unique_ptr<Expression>> predicates_;
+  vector<IndexScanRange>         ranges_;
+};
+
+TEST_F(IndexRangeAnalyzerTest, test_range)
+{
+  add(GREAT_THAN, a_, 3);
+  add(GREAT_EQUAL, a_, 1);
+  add(LESS_EQUAL, a_, 10);
+  add(GREAT_EQUAL, b_, 100);  // 不是索引的第一个字段
+
+  IndexRangeAnalyzer analyzer(predicates_);
+  ASSERT_NE(IndexRangeAnalyzer::NO_MATCH, analyzer.analyze({a_}, false, ranges_));
+  ASSERT_EQ(1, ranges_.size());
+  ASSERT_EQ(1, ranges_[0].left_values.size());
+  ASSERT_EQ(3, ranges_[0].left_values[0].get_int());
+  ASSERT_FALSE(ranges_[0].left_inclusive);
+  ASSERT_EQ(10, ranges_[0].right_values[0].get_int());
+  ASSERT_TRUE(ranges_[0].right_inclusive);
+
+  ASSERT_EQ(IndexRangeAnalyzer::NO_MATCH, analyzer.analyze({c_, a_}, false, ranges_));
+}
+
+TEST_F(IndexRangeAnalyzerTest, test_swapped_comparison)
+{
+  // 5 > a 等价于 a < 5
+  predicates_.emplace_back(new ComparisonExpr(GREAT_THAN, make_unique<ValueExpr>(Value(5)), field(a_)));
+
+  IndexRangeAnalyzer analyzer(predicates_);
+  ASSERT_NE(IndexRangeAnalyzer::NO_MATCH, analyzer.analyze({a_}, false, ranges_));
+  ASSERT_EQ(1, ranges_.size());
+  ASSERT_TRUE(ranges_[0].left_values.empty());
+  ASSERT_EQ(5, ranges_[0].right_values[0].get_int());
+  ASSERT_FALSE(ranges_[0].right_inclusive);
+}
+
+TEST_F(IndexRangeAnalyzerTest, test_in_list)
+{
+  add_in(a_, {7, 3, 5, 3, 100});
+  add(LESS_THAN, a_, 100);
+
+  IndexRangeAnalyzer analyzer(predicates_);
+  ASSERT_NE(IndexRangeAnalyzer::NO_MATCH, analyzer.analyze({a_, b_}, false, ranges_));
+  ASSERT_EQ(3, ranges_.size());
+  const int expected[] = {3, 5, 7};
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(ranges_[i].is_point());
+    ASSERT_EQ(expected[i], ranges_[i].left_values[0].get_int());
+  }
+}
+
+TEST_F(IndexRangeAnalyzerTest, test_composite_prefix)
+{
+  add(EQUAL_TO, a_, 1);
+  add_in(b_, {2, 1});
+  add(GREAT_THAN, c_, 0);
+
+  IndexRangeAnalyzer analyzer(predicates_);
+  const int in_score = analyzer.analyze({a_, b_, c_}, false, ranges_);
+  ASSERT_EQ(2, ranges_.size());
+  ASSERT_EQ(2, ranges_[0].left_values.size());
+  ASSERT_EQ(1, ranges_[0].left_values[0].get_int());
+  ASSERT_EQ(1, ranges_[0].left_values[1].get_int());
+  ASSERT_EQ(2, ranges_[1].left_values[1].get_int());
+
+  // a = 1 and c > 0: 等值前缀后面跟着范围
+  const int range_score = analyzer.analyze({a_, c_}, false, ranges_);
+  ASSERT_EQ(1, ranges_.size());
+  ASSERT_EQ(2, ranges_[0].left_values.size());
+  ASSERT_FALSE(ranges_[0].left_inclusive);
+  ASSERT_EQ(1, ranges_[0].right_values.size());
+  ASSERT_TRUE(ranges_[0].right_inclusive);
+  ASSERT_GT(in_score, range_score);
+
+  const int eq_score = analyzer.analyze({a_}, false, ranges_);
+  ASSERT_EQ(1, ranges_.size());
+  ASSERT_TRUE(ranges_[0].is_point());
+  ASSERT_GT(range_score, eq_score);
+}
+
+TEST_F(IndexRangeAnalyzerTest, test_empty_range)
+{
+  add(GREAT_THAN, a_, 10);
+  add(LESS_THAN, a_, 5);
+
+  IndexRangeAnalyzer analyzer(predicates_);
+  ASSERT_EQ(IndexRangeAnalyzer::EMPTY_MATCH, analyzer.analyze({a_}, false, ranges_));
+  ASSERT_TRUE(ranges_.empty());
+
+  predicates_.clear();
+  add_in(b_, {1, 2});
+  add(EQUAL_TO, b_, 3);
+  IndexRangeAnalyzer analyzer2(predicates_);
+  ASSERT_EQ(IndexRangeAnalyzer::EMPTY_MATCH, analyzer2.analyze({b_}, false, ranges_));
+}
+
+TEST_F(IndexRangeAnalyzerTest, test_unusable_value)
+{
+  // 类型不同的常量不用于索引查找
+  predicates_.emplace_back(new ComparisonExpr(EQUAL_TO, field(a_), make_unique<ValueExpr>(Value(1.5f))));
+
+  IndexRangeAnalyzer analyzer(predicates_);
+  ASSERT_EQ(IndexRangeAnalyzer::NO_MATCH, analyzer.analyze({a_}, false, ranges_));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
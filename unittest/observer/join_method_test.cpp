@@ -0,0 +1,348 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/conf/ini.h"
+#include "gtest/gtest.h"
+#include "operator_test_util.h"
+#include "sql/operator/merge_join_physical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "sql/optimizer/join_method_selector.h"
+#include "sql/optimizer/physical_plan_generator.h"
+#include "storage/db/db.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+namespace {
+
+Value null_value()
+{
+  Value value;
+  value.set_null();
+  return value;
+}
+
+/// 连接结果中左右两边的 payload
+string pair_of(const Tuple &tuple, const TupleCellSpec &left_spec, const TupleCellSpec &right_spec)
+{
+  Value left;
+  Value right;
+  int   index = 0;
+  EXPECT_EQ(RC::SUCCESS, tuple.find_cell(left_spec, left, index));
+  EXPECT_EQ(RC::SUCCESS, tuple.find_cell(right_spec, right, index));
+  return left.to_string() + ":" + right.to_string();
+}
+
+/// 使用嵌套循环计算期望的结果。两个NULL认为相等，与 ComparisonExpr 一致
+vector<string> expected_pairs(const vector<vector<Value>> &left, const vector<vector<Value>> &right, int key_num)
+{
+  vector<string> result;
+  for (const vector<Value> &left_row : left) {
+    for (const vector<Value> &right_row : right) {
+      bool equal = left_row[0].compare(right_row[0]) == 0;
+      for (int i = 1; equal && i < key_num; i++) {
+        equal = left_row[i + 1].compare(right_row[i + 1]) == 0;
+      }
+      if (equal) {
+        result.push_back(left_row[1].to_string() + ":" + right_row[1].to_string());
+      }
+    }
+  }
+  sort(result.begin(), result.end());
+  return result;
+}
+
+vector<string> run_join(
+    PhysicalOperator &join, Trx *trx, const TupleCellSpec &left_spec, const TupleCellSpec &right_spec)
+{
+  vector<string> result;
+  EXPECT_EQ(RC::SUCCESS, join.open(trx));
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc = join.next())) {
+    result.push_back(pair_of(*join.current_tuple(), left_spec, right_spec));
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  EXPECT_EQ(RC::SUCCESS, join.close());
+  sort(result.begin(), result.end());
+  return result;
+}
+
+/// 归并连接的两个孩子按照第一个字段升序输出，NULL在最前面，与B+树索引的顺序一致
+vector<string> run_merge_join(vector<vector<Value>> left, vector<vector<Value>> right, int key_num)
+{
+  auto key_less = [](const vector<Value> &a, const vector<Value> &b) {
+    if (a[0].is_null() || b[0].is_null()) {
+      return a[0].is_null() && !b[0].is_null();
+    }
+    return a[0].compare(b[0]) < 0;
+  };
+  stable_sort(left.begin(), left.end(), key_less);
+  stable_sort(right.begin(), right.end(), key_less);
+
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  left_keys.emplace_back(new CellExpr(0));
+  right_keys.emplace_back(new CellExpr(0));
+  for (int i = 1; i < key_num; i++) {
+    left_keys.emplace_back(new CellExpr(i + 1));
+    right_keys.emplace_back(new CellExpr(i + 1));
+  }
+
+  MergeJoinPhysicalOperator join(std::move(left_keys), std::move(right_keys));
+  const int                 cell_num = key_num + 1;
+  join.add_child(make_unique<RowsPhysicalOperator>("l", cell_num, left));
+  join.add_child(make_unique<RowsPhysicalOperator>("r", cell_num, right));
+  return run_join(join, nullptr, TupleCellSpec("l", "f1"), TupleCellSpec("r", "f1"));
+}
+
+/// (null_bitmap, id, payload)。RowTuple 和索引都把表的第一个字段当作null位图，不使用事务字段时就是这个字段
+vector<AttrInfoSqlNode> join_attrs()
+{
+  vector<AttrInfoSqlNode> attr_infos(3);
+  attr_infos[0].name     = "null_bitmap";
+  attr_infos[0].type     = AttrType::CHARS;
+  attr_infos[0].length   = 4;
+  attr_infos[0].nullable = false;
+
+  attr_infos[1].name     = "id";
+  attr_infos[1].type     = AttrType::INTS;
+  attr_infos[1].length   = 4;
+  attr_infos[1].nullable = true;
+
+  attr_infos[2].name     = "payload";
+  attr_infos[2].type     = AttrType::INTS;
+  attr_infos[2].length   = 4;
+  attr_infos[2].nullable = false;
+  return attr_infos;
+}
+
+/// 创建表并插入数据，with_index 时在 id 上创建索引，与 create index 语句一样把null位图放在索引的第一个字段
+Table *create_table(Db *db, const char *name, const vector<vector<Value>> &rows, bool with_index)
+{
+  EXPECT_EQ(RC::SUCCESS, db->create_table(name, join_attrs()));
+  Table *table = db->find_table(name);
+  EXPECT_NE(nullptr, table);
+
+  TrxKit &trx_kit = db->trx_kit();
+  Trx    *trx     = trx_kit.create_trx(db->log_handler());
+  EXPECT_EQ(RC::SUCCESS, trx->start_if_need());
+  if (with_index) {
+    const TableMeta         &table_meta  = table->table_meta();
+    vector<const FieldMeta *> field_metas = {table_meta.null_field(), table_meta.field("id")};
+    EXPECT_EQ(RC::SUCCESS, table->create_index(trx, false, field_metas, (string("i_") + name).c_str()));
+  }
+  for (const vector<Value> &row : rows) {
+    vector<Value> values = {Value(""), row[0], row[1]};
+    Record        record;
+    EXPECT_EQ(RC::SUCCESS, table->make_record(static_cast<int>(values.size()), values.data(), record));
+    EXPECT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  }
+  EXPECT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+  return table;
+}
+
+vector<vector<Value>> make_rows(int num, int key_mod, int payload_base, int null_num)
+{
+  vector<vector<Value>> rows;
+  for (int i = 0; i < num; i++) {
+    rows.push_back({Value((i * 7) % key_mod), Value(payload_base + i)});
+  }
+  for (int i = 0; i < null_num; i++) {
+    rows.push_back({null_value(), Value(payload_base + num + i)});
+  }
+  return rows;
+}
+
+unique_ptr<LogicalOperator> make_logical_join(Table *left, Table *right)
+{
+  auto join_oper = make_unique<JoinLogicalOperator>();
+  for (Table *table : {left, right}) {
+    join_oper->add_child(make_unique<TableGetLogicalOperator>(table, ReadWriteMode::READ_ONLY, vector<Field>()));
+  }
+  join_oper->expressions().emplace_back(new ComparisonExpr(EQUAL_TO,
+      make_unique<FieldExpr>(left, left->table_meta().field("id")),
+      make_unique<FieldExpr>(right, right->table_meta().field("id"))));
+  return join_oper;
+}
+
+}  // namespace
+
+TEST(MergeJoinTest, duplicates)
+{
+  // 两边都有大量重复的键值，也有只在一边出现的键值
+  vector<vector<Value>> left;
+  vector<vector<Value>> right;
+  for (int i = 0; i < 200; i++) {
+    left.push_back({Value(i % 13), Value(i)});
+    right.push_back({Value(i % 17 + 5), Value(1000 + i)});
+  }
+  EXPECT_EQ(expected_pairs(left, right, 1), run_merge_join(left, right, 1));
+}
+
+TEST(MergeJoinTest, empty_and_null)
+{
+  vector<vector<Value>> empty;
+  vector<vector<Value>> rows = {{Value(1), Value(1)}, {null_value(), Value(2)}};
+  EXPECT_TRUE(run_merge_join(empty, rows, 1).empty());
+  EXPECT_TRUE(run_merge_join(rows, empty, 1).empty());
+
+  // NULL键值只与NULL键值匹配
+  vector<vector<Value>> left  = {{null_value(), Value(10)}, {Value(1), Value(11)}, {null_value(), Value(12)}};
+  vector<vector<Value>> right = {{Value(1), Value(20)}, {null_value(), Value(21)}, {Value(2), Value(22)}};
+  vector<string>        result = run_merge_join(left, right, 1);
+  EXPECT_EQ(expected_pairs(left, right, 1), result);
+  EXPECT_EQ(3, static_cast<int>(result.size()));
+}
+
+TEST(MergeJoinTest, multiple_keys)
+{
+  // 第二对连接字段在归并之后检查
+  vector<vector<Value>> left;
+  vector<vector<Value>> right;
+  for (int i = 0; i < 100; i++) {
+    left.push_back({Value(i % 10), Value(i), Value(i % 3)});
+    right.push_back({Value(i % 7), Value(1000 + i), Value(i % 2)});
+  }
+  left.push_back({null_value(), Value(500), Value(1)});
+  right.push_back({null_value(), Value(501), Value(1)});
+  right.push_back({null_value(), Value(502), Value(0)});
+  EXPECT_EQ(expected_pairs(left, right, 2), run_merge_join(left, right, 2));
+}
+
+TEST(IndexNestedLoopJoinTest, inner_index_scan)
+{
+  filesystem::path test_directory("join_method_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directories(test_directory / "test_db");
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init("test_db", (test_directory / "test_db").c_str(), "vacuous", "disk"));
+
+  // 外表的行数超过一批，键值有重复、有NULL，也有内表中不存在的键值。Table::make_record 不能写入NULL，内表都不是NULL
+  vector<vector<Value>> inner_rows = make_rows(1000, 100, 0, 0);
+  vector<vector<Value>> outer_rows = make_rows(300, 130, 10000, 2);
+  Table                *table      = create_table(db.get(), "t", inner_rows, true);
+  Index                *index      = table->find_index("i_t");
+  ASSERT_NE(nullptr, index);
+
+  TrxKit &trx_kit = db->trx_kit();
+  Trx    *trx     = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+
+  for (int inner_side : {1, 0}) {
+    vector<unique_ptr<Expression>> keys[2];
+    keys[1 - inner_side].emplace_back(new CellExpr(0));
+    keys[inner_side].emplace_back(new FieldExpr(table, table->table_meta().field("id")));
+
+    IndexNestedLoopJoinPhysicalOperator join(inner_side, std::move(keys[0]), std::move(keys[1]));
+    auto outer = make_unique<RowsPhysicalOperator>("s", 2, outer_rows);
+    auto inner = make_unique<IndexScanPhysicalOperator>(
+        table, index, ReadWriteMode::READ_ONLY, vector<IndexScanRange>{IndexScanRange()});
+    if (inner_side == 1) {
+      join.add_child(std::move(outer));
+      join.add_child(std::move(inner));
+    } else {
+      join.add_child(std::move(inner));
+      join.add_child(std::move(outer));
+    }
+
+    vector<string> result = run_join(join, trx, TupleCellSpec("s", "f1"), TupleCellSpec("t", "payload"));
+    EXPECT_EQ(expected_pairs(outer_rows, inner_rows, 1), result);
+  }
+
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+  db.reset();
+  filesystem::remove_all(test_directory);
+}
+
+TEST(JoinMethodSelectorTest, plan)
+{
+  filesystem::path test_directory("join_method_selector_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directories(test_directory / "test_db");
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init("test_db", (test_directory / "test_db").c_str(), "vacuous", "disk"));
+
+  // 小表 s 没有索引，大表 t 和 u 在连接字段上有索引
+  vector<vector<Value>> small_rows = make_rows(20, 1200, 0, 0);
+  vector<vector<Value>> large_rows = make_rows(10000, 1000, 100000, 0);
+  Table                *s          = create_table(db.get(), "s", small_rows, false);
+  Table                *t          = create_table(db.get(), "t", large_rows, true);
+  Table                *u          = create_table(db.get(), "u", large_rows, true);
+  EXPECT_LT(s->estimated_record_num(), t->estimated_record_num());
+
+  HashJoinOptions options;
+  {
+    // 没有连接条件只能使用嵌套循环连接
+    unique_ptr<LogicalOperator> join_oper = make_logical_join(s, t);
+    join_oper->expressions().clear();
+    JoinMethodChoice choice = JoinMethodSelector(options).choose(static_cast<JoinLogicalOperator &>(*join_oper));
+    EXPECT_EQ(JoinMethod::NESTED_LOOP, choice.method);
+  }
+  {
+    // 小表作为外表，在大表的索引中查找
+    unique_ptr<LogicalOperator> join_oper = make_logical_join(s, t);
+    JoinMethodChoice choice = JoinMethodSelector(options).choose(static_cast<JoinLogicalOperator &>(*join_oper));
+    EXPECT_EQ(JoinMethod::INDEX_NESTED_LOOP, choice.method);
+    EXPECT_EQ(1, choice.inner_side);
+    EXPECT_EQ(nullptr, choice.indexes[0]);
+    EXPECT_EQ(t->find_index("i_t"), choice.indexes[1]);
+  }
+  {
+    // 两个大表都有索引，哈希连接需要写临时文件时使用归并连接
+    unique_ptr<LogicalOperator> join_oper = make_logical_join(t, u);
+    EXPECT_EQ(JoinMethod::HASH,
+        JoinMethodSelector(options).choose(static_cast<JoinLogicalOperator &>(*join_oper)).method);
+    HashJoinOptions small_memory;
+    small_memory.memory = 1024;
+    EXPECT_EQ(JoinMethod::MERGE,
+        JoinMethodSelector(small_memory).choose(static_cast<JoinLogicalOperator &>(*join_oper)).method);
+  }
+
+  // 生成物理计划并执行，结果与嵌套循环的结果相同
+  TrxKit &trx_kit = db->trx_kit();
+  Trx    *trx     = trx_kit.create_trx(db->log_handler());
+  ASSERT_EQ(RC::SUCCESS, trx->start_if_need());
+  {
+    unique_ptr<LogicalOperator>  join_oper = make_logical_join(s, t);
+    unique_ptr<PhysicalOperator> oper;
+    ASSERT_EQ(RC::SUCCESS, PhysicalPlanGenerator::create(*join_oper, oper));
+    EXPECT_EQ(PhysicalOperatorType::INDEX_NESTED_LOOP_JOIN, oper->type());
+    EXPECT_EQ(expected_pairs(small_rows, large_rows, 1),
+        run_join(*oper, trx, TupleCellSpec("s", "payload"), TupleCellSpec("t", "payload")));
+  }
+  {
+    get_properties()->put("HASH_JOIN", "false", "SQL");
+    unique_ptr<LogicalOperator>  join_oper = make_logical_join(t, u);
+    unique_ptr<PhysicalOperator> oper;
+    ASSERT_EQ(RC::SUCCESS, PhysicalPlanGenerator::create(*join_oper, oper));
+    get_properties()->put("HASH_JOIN", "true", "SQL");
+    EXPECT_EQ(PhysicalOperatorType::MERGE_JOIN, oper->type());
+    EXPECT_EQ(expected_pairs(large_rows, large_rows, 1),
+        run_join(*oper, trx, TupleCellSpec("t", "payload"), TupleCellSpec("u", "payload")));
+  }
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  trx_kit.destroy_trx(trx);
+
+  db.reset();
+  filesystem::remove_all(test_directory);
+}
@@ -18,6 +18,7 @@ See the Mulan PSL v2 for more details. */
 #define protected public
 #include "storage/clog/log_buffer.h"
 #include "storage/clog/log_file.h"
+#include "common/lang/thread.h"
 
 using namespace std;
 using namespace common;
@@ -66,6 +67,68 @@ TEST(LogEntryBuffer, test_append)
   filesystem::remove("test_log_entry_buffer.log");
 }
 
+TEST(LogEntryBuffer, concurrent_append_with_wrap)
+{
+  // 多个线程并发写日志，缓冲区很小，会不停地回绕，并且写日志的线程需要等待刷盘线程释放空间
+  const int      thread_num        = 8;
+  const int      entry_per_thread  = 2000;
+  const LSN      end_lsn           = thread_num * entry_per_thread;
+  const char    *filename          = "test_log_entry_buffer_concurrent.log";
+  LogEntryBuffer buffer;
+  ASSERT_EQ(RC::SUCCESS, buffer.init(0, 1));
+  buffer.capacity_ = 4096;  // 使用一个很小的缓冲区
+
+  LogFileWriter writer;
+  ASSERT_EQ(RC::SUCCESS, writer.open(filename, end_lsn));
+
+  vector<thread> threads;
+  for (int i = 0; i < thread_num; i++) {
+    threads.emplace_back([&buffer, i]() {
+      for (int j = 0; j < entry_per_thread; j++) {
+        // 日志数据中记录线程编号和序号，大小也不相同，方便校验
+        vector<char> data(sizeof(int) * 2 + (j % 97));
+        memcpy(data.data(), &i, sizeof(int));
+        memcpy(data.data() + sizeof(int), &j, sizeof(int));
+        LSN lsn = 0;
+        ASSERT_EQ(RC::SUCCESS, buffer.append(lsn, LogModule::Id::BUFFER_POOL, std::move(data)));
+      }
+    });
+  }
+
+  int total_count = 0;
+  while (total_count < end_lsn) {
+    int count = 0;
+    ASSERT_EQ(RC::SUCCESS, buffer.flush(writer, count));
+    total_count += count;
+  }
+
+  for (thread &t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(buffer.flushed_lsn(), end_lsn);
+  ASSERT_EQ(buffer.bytes(), 0);
+  ASSERT_EQ(buffer.entry_number(), 0);
+  writer.close();
+
+  // 读出来校验：LSN连续，每个线程的日志按照写入的顺序出现
+  LogFileReader reader;
+  ASSERT_EQ(RC::SUCCESS, reader.open(filename));
+  LSN         expected_lsn = 1;
+  vector<int> next_seq(thread_num, 0);
+  ASSERT_EQ(RC::SUCCESS, reader.iterate([&](LogEntry &entry) {
+    EXPECT_EQ(entry.lsn(), expected_lsn++);
+    int thread_id = 0, seq = 0;
+    memcpy(&thread_id, entry.data(), sizeof(int));
+    memcpy(&seq, entry.data() + sizeof(int), sizeof(int));
+    EXPECT_EQ(seq, next_seq[thread_id]++);
+    EXPECT_EQ(entry.payload_size(), static_cast<int32_t>(sizeof(int) * 2 + (seq % 97)));
+    return RC::SUCCESS;
+  }));
+  ASSERT_EQ(expected_lsn, end_lsn + 1);
+  reader.close();
+  filesystem::remove(filename);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
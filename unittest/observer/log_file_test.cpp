@@ -124,6 +124,112 @@ TEST(LogFileReader, basic)
   filesystem::remove(log_file);
 }
 
+/// 写入一些日志，日志数据是日志的LSN，返回每条日志在文件中的结束位置
+static vector<int64_t> write_entries(const char *filename, int entry_num)
+{
+  filesystem::remove(filename);
+
+  LogFileWriter writer;
+  EXPECT_EQ(RC::SUCCESS, writer.open(filename, 1000));
+
+  vector<int64_t> end_offsets;
+  int64_t         offset = 0;
+  for (LSN lsn = 1; lsn <= entry_num; ++lsn) {
+    vector<char> data(sizeof(lsn) + lsn);
+    memcpy(data.data(), &lsn, sizeof(lsn));
+
+    LogEntry entry;
+    EXPECT_EQ(RC::SUCCESS, entry.init(lsn, LogModule::Id::BUFFER_POOL, std::move(data)));
+    EXPECT_EQ(RC::SUCCESS, writer.write(entry));
+    offset += entry.total_size();
+    end_offsets.push_back(offset);
+  }
+  writer.close();
+  return end_offsets;
+}
+
+TEST(LogFileReader, zero_copy_and_torn_tail)
+{
+  const char     *log_file    = "test_log_file_reader_torn.log";
+  const int       entry_num   = 10;
+  vector<int64_t> end_offsets = write_entries(log_file, entry_num);
+
+  int  count    = 0;
+  auto callback = [&count](LogEntry &entry) -> RC {
+    EXPECT_TRUE(entry.is_view());
+    LSN lsn = 0;
+    memcpy(&lsn, entry.data(), sizeof(lsn));
+    EXPECT_EQ(lsn, entry.lsn());
+    EXPECT_EQ(static_cast<int32_t>(sizeof(lsn) + lsn), entry.payload_size());
+    count++;
+    return RC::SUCCESS;
+  };
+
+  LogFileReader reader;
+  ASSERT_EQ(RC::SUCCESS, reader.open(log_file));
+  ASSERT_EQ(RC::SUCCESS, reader.iterate(callback));
+  ASSERT_EQ(entry_num, count);
+  ASSERT_FALSE(reader.torn());
+  ASSERT_EQ(end_offsets.back(), reader.valid_size());
+  reader.close();
+
+  // 最后一条日志只写了一部分
+  filesystem::resize_file(log_file, end_offsets.back() - 3);
+  ASSERT_EQ(RC::SUCCESS, reader.open(log_file));
+  count = 0;
+  ASSERT_EQ(RC::SUCCESS, reader.iterate(callback));
+  ASSERT_EQ(entry_num - 1, count);
+  ASSERT_TRUE(reader.torn());
+  ASSERT_EQ(end_offsets[entry_num - 2], reader.valid_size());
+  reader.close();
+
+  // 只写了半个日志头
+  filesystem::resize_file(log_file, end_offsets[entry_num - 2] + LogHeader::SIZE / 2);
+  ASSERT_EQ(RC::SUCCESS, reader.open(log_file));
+  count = 0;
+  ASSERT_EQ(RC::SUCCESS, reader.iterate(callback));
+  ASSERT_EQ(entry_num - 1, count);
+  ASSERT_TRUE(reader.torn());
+  reader.close();
+
+  filesystem::remove(log_file);
+}
+
+TEST(LogFileReader, checksum)
+{
+  const char     *log_file    = "test_log_file_reader_checksum.log";
+  const int       entry_num   = 10;
+  vector<int64_t> end_offsets = write_entries(log_file, entry_num);
+
+  // 修改第5条日志的最后一个字节，文件长度不变，但是校验码对不上
+  {
+    fstream fs(log_file, ios::in | ios::out | ios::binary);
+    fs.seekp(end_offsets[4] - 1);
+    fs.put('x');
+  }
+
+  int  count    = 0;
+  auto callback = [&count](LogEntry &entry) -> RC {
+    count++;
+    return RC::SUCCESS;
+  };
+
+  LogFileReader reader;
+  ASSERT_EQ(RC::SUCCESS, reader.open(log_file));
+  ASSERT_EQ(RC::SUCCESS, reader.iterate(callback));
+  ASSERT_EQ(4, count);
+  ASSERT_TRUE(reader.torn());
+  ASSERT_EQ(end_offsets[3], reader.valid_size());
+
+  // 从后面的位置开始读，也会在这里停止
+  count = 0;
+  ASSERT_EQ(RC::SUCCESS, reader.iterate(callback, 8));
+  ASSERT_EQ(0, count);
+  reader.close();
+
+  filesystem::remove(log_file);
+}
+
 TEST(LogFileReadWrite, test_read_write)
 {
   const char *log_file = "test_log_file_read_write.log";
@@ -390,6 +496,55 @@ TEST(LogFileManager, next_file)
   filesystem::remove_all(directory);
 }
 
+TEST(LogFileManager, recycle)
+{
+  const char *directory                 = "recycle";
+  int         max_entry_number_per_file = 1000;
+
+  filesystem::remove_all(directory);
+  ASSERT_TRUE(filesystem::create_directory(directory));
+  LSN lsns[] = {0, 1000, 2000, 3000};
+  for (LSN lsn : lsns) {
+    string   filename = string(LogFileManager::file_prefix_) + to_string(lsn) + LogFileManager::file_suffix_;
+    ofstream ofs(filesystem::path(directory) / filename);
+    ofs.close();
+  }
+
+  LogFileManager manager;
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+
+  // 检查点落在第二个文件中，只有第一个文件可以删除
+  int recycled_count = 0;
+  ASSERT_EQ(RC::SUCCESS, manager.recycle(1999, recycled_count));
+  ASSERT_EQ(1, recycled_count);
+  ASSERT_FALSE(filesystem::exists(filesystem::path(directory) / "clog_0.log"));
+  ASSERT_TRUE(filesystem::exists(filesystem::path(directory) / "clog_1000.log"));
+
+  vector<string> files;
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(files, 0));
+  ASSERT_EQ(3, files.size());
+
+  // 第二个文件的日志都在检查点之前
+  ASSERT_EQ(RC::SUCCESS, manager.recycle(2000, recycled_count));
+  ASSERT_EQ(1, recycled_count);
+
+  // 最后一个文件正在写入，不会删除
+  ASSERT_EQ(RC::SUCCESS, manager.recycle(100000, recycled_count));
+  ASSERT_EQ(1, recycled_count);
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(files, 0));
+  ASSERT_EQ(1, files.size());
+  ASSERT_TRUE(filesystem::exists(filesystem::path(directory) / "clog_3000.log"));
+
+  LogFileWriter writer;
+  ASSERT_EQ(RC::SUCCESS, manager.next_file(writer));
+  LSN lsn = 0;
+  ASSERT_EQ(RC::SUCCESS, LogFileManager::get_lsn_from_filename(filesystem::path(writer.filename()).filename(), lsn));
+  ASSERT_EQ(4000, lsn);
+
+  writer.close();
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
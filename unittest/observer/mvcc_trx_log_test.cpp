@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 
 #include "gtest/gtest.h"
+#include "common/conf/ini.h"
 #include "storage/db/db.h"
 #include "storage/table/table.h"
 #include "storage/record/record.h"
@@ -713,6 +714,220 @@ TEST(MvccTrxLog, wal_rollback_abnormal)
   db.reset();
 }
 
+TEST(MvccTrxLog, fuzzy_checkpoint)
+{
+  /*
+  一个事务插入了一部分数据后不提交，其它事务插入并提交很多数据，然后做检查点。
+  检查点不能跨过未提交事务的第一条日志，检查点之前的日志文件会被删除。
+  这个事务提交后再建一张表，再做一次检查点，这样重启时不会重放任何事务日志，只能依靠检查点中记录的事务ID。
+  复制到另一个目录后启动，检查数据都可见。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  const char      *dbname2          = "test_db2";
+  filesystem::path db_path          = test_directory / dbname;
+  filesystem::path db_path2         = test_directory / dbname2;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+  filesystem::create_directories(db_path2);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  vector<AttrInfoSqlNode> attr_infos(1);
+  attr_infos[0].name   = "field_0";
+  attr_infos[0].type   = AttrType::INTS;
+  attr_infos[0].length = 4;
+
+  const char *long_table_name  = "long_trx_table";
+  const char *short_table_name = "short_trx_table";
+  ASSERT_EQ(RC::SUCCESS, db->create_table(long_table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->create_table(short_table_name, attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+
+  Table  *long_table  = db->find_table(long_table_name);
+  Table  *short_table = db->find_table(short_table_name);
+  TrxKit &trx_kit     = db->trx_kit();
+
+  auto insert = [](Trx *trx, Table *table, int value) {
+    Value  values[1];
+    Record record;
+    values[0].set_int(value);
+    ASSERT_EQ(RC::SUCCESS, table->make_record(1, values, record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  };
+
+  auto insert_and_commit = [&](int count) {
+    for (int i = 0; i < count; i++) {
+      Trx *trx = trx_kit.create_trx(db->log_handler());
+      trx->start_if_need();
+      insert(trx, short_table, i);
+      ASSERT_EQ(RC::SUCCESS, trx->commit());
+      trx_kit.destroy_trx(trx);
+    }
+  };
+
+  // 写满第一个日志文件
+  const int short_trx_num = 500;
+  insert_and_commit(short_trx_num);
+
+  const int long_insert_num = 10;
+  Trx      *long_trx        = trx_kit.create_trx(db->log_handler());
+  long_trx->start_if_need();
+  for (int i = 0; i < long_insert_num; i++) {
+    insert(long_trx, long_table, i);
+  }
+
+  insert_and_commit(short_trx_num);
+
+  LSN long_trx_lsn = 0;
+  int32_t max_trx_id = 0;
+  trx_kit.checkpoint_info(db->log_handler(), long_trx_lsn, max_trx_id);
+  ASSERT_LT(long_trx_lsn, db->log_handler().current_lsn());
+
+  ASSERT_EQ(RC::SUCCESS, db->checkpoint(-1 /*max_flush_pages*/));
+  ASSERT_FALSE(filesystem::exists(db_path / "clog" / "clog_0.log"));
+
+  ASSERT_EQ(RC::SUCCESS, long_trx->commit());
+  trx_kit.destroy_trx(long_trx);
+
+  ASSERT_EQ(RC::SUCCESS, db->create_table("ddl_table", attr_infos));
+  ASSERT_EQ(RC::SUCCESS, db->checkpoint(-1 /*max_flush_pages*/));
+
+  LSN current_lsn = db->log_handler().current_lsn();
+  ASSERT_EQ(RC::SUCCESS, db->log_handler().wait_lsn(current_lsn));
+
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  auto db2 = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db2->init(dbname2, db_path2.c_str(), trx_kit_name, log_handler_name));
+
+  Trx *trx = db2->trx_kit().create_trx(db2->log_handler());
+  trx->start_if_need();
+  auto visible_count = [trx](Table *table) {
+    RecordFileScanner scanner;
+    EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    int    count = 0;
+    Record record;
+    while (OB_SUCC(scanner.next(record))) {
+      if (OB_SUCC(trx->visit_record(table, record, ReadWriteMode::READ_ONLY))) {
+        count++;
+      }
+    }
+    return count;
+  };
+
+  ASSERT_EQ(long_insert_num, visible_count(db2->find_table(long_table_name)));
+  ASSERT_EQ(short_trx_num * 2, visible_count(db2->find_table(short_table_name)));
+  db2->trx_kit().destroy_trx(trx);
+
+  db2.reset();
+  db.reset();
+}
+
+TEST(MvccTrxLog, parallel_redo)
+{
+  /*
+  多个表插入、删除数据，日志落地后复制到另一个目录，使用多个线程回放日志，检查数据是否一致。
+  */
+  filesystem::path test_directory("mvcc_trx_log_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname           = "test_db";
+  const char      *dbname2          = "test_db2";
+  filesystem::path db_path          = test_directory / dbname;
+  filesystem::path db_path2         = test_directory / dbname2;
+  const char      *trx_kit_name     = "mvcc";
+  const char      *log_handler_name = "disk";
+
+  filesystem::create_directories(db_path);
+  filesystem::create_directories(db_path2);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), trx_kit_name, log_handler_name));
+
+  vector<AttrInfoSqlNode> attr_infos(1);
+  attr_infos[0].name   = "field_0";
+  attr_infos[0].type   = AttrType::INTS;
+  attr_infos[0].length = 4;
+
+  const int      table_num = 4;
+  vector<string> table_names;
+  for (int i = 0; i < table_num; i++) {
+    table_names.push_back("table_" + to_string(i));
+    ASSERT_EQ(RC::SUCCESS, db->create_table(table_names.back().c_str(), attr_infos));
+  }
+  ASSERT_EQ(RC::SUCCESS, db->sync());
+
+  // 每个事务在所有表中插入一条数据，每三个事务删除掉前面的一条数据
+  TrxKit     &trx_kit    = db->trx_kit();
+  const int   insert_num = 1000;
+  vector<RID> rids;
+  for (int i = 0; i < insert_num; i++) {
+    Trx *trx = trx_kit.create_trx(db->log_handler());
+    trx->start_if_need();
+    for (const string &table_name : table_names) {
+      Table *table = db->find_table(table_name.c_str());
+      Value  values[1];
+      Record record;
+      values[0].set_int(i);
+      ASSERT_EQ(RC::SUCCESS, table->make_record(1, values, record));
+      ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+      if (table_name == table_names[0]) {
+        rids.push_back(record.rid());
+      }
+    }
+
+    if (i % 3 == 2) {
+      Table *table = db->find_table(table_names[0].c_str());
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table->get_record(rids[i / 3], record));
+      ASSERT_EQ(RC::SUCCESS, trx->delete_record(table, record));
+    }
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    trx_kit.destroy_trx(trx);
+  }
+
+  LSN current_lsn = db->log_handler().current_lsn();
+  ASSERT_EQ(RC::SUCCESS, db->log_handler().wait_lsn(current_lsn));
+
+  filesystem::copy(db_path, db_path2, filesystem::copy_options::recursive);
+
+  get_properties()->put("REDO_WORKERS", "4", "CLOG");
+  auto db2 = make_unique<Db>();
+  RC   rc  = db2->init(dbname2, db_path2.c_str(), trx_kit_name, log_handler_name);
+  get_properties()->put("REDO_WORKERS", "0", "CLOG");
+  ASSERT_EQ(RC::SUCCESS, rc);
+
+  Trx *trx = db2->trx_kit().create_trx(db2->log_handler());
+  trx->start_if_need();
+  for (const string &table_name : table_names) {
+    Table            *table = db2->find_table(table_name.c_str());
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, nullptr, ReadWriteMode::READ_ONLY));
+    int    visible_count = 0;
+    Record record;
+    while (OB_SUCC(scanner.next(record))) {
+      if (OB_SUCC(trx->visit_record(table, record, ReadWriteMode::READ_ONLY))) {
+        visible_count++;
+      }
+    }
+
+    const int expected_count = table_name == table_names[0] ? insert_num - insert_num / 3 : insert_num;
+    ASSERT_EQ(expected_count, visible_count);
+  }
+  db2->trx_kit().destroy_trx(trx);
+
+  db2.reset();
+  db.reset();
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,94 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 算子测试和性能测试共用的辅助类，不需要真正的表
+//
+
+#pragma once
+
+#include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+
+/// 按照下标读取字段的表达式
+class CellExpr : public Expression
+{
+public:
+  explicit CellExpr(int index) : index_(index) {}
+
+  ExprType type() const override { return ExprType::NONE; }
+  AttrType value_type() const override { return AttrType::INTS; }
+  RC       get_value(const Tuple &tuple, Value &value) override { return tuple.cell_at(index_, value); }
+  unique_ptr<Expression> deep_copy() const override { return make_unique<CellExpr>(index_); }
+
+private:
+  int index_;
+};
+
+/**
+ * @brief 依次输出给定数据的算子，代替表扫描
+ * @details 字段名为 table_name.f0, table_name.f1 ...。可以持有数据，也可以只引用调用者的数据，
+ * 后者用于性能测试中避免每次迭代复制所有行，调用者需要保证数据在算子使用期间有效。
+ */
+class RowsPhysicalOperator : public PhysicalOperator
+{
+public:
+  RowsPhysicalOperator(const char *table_name, int cell_num, vector<vector<Value>> rows)
+      : owned_rows_(std::move(rows)), rows_(&owned_rows_)
+  {
+    init_names(table_name, cell_num);
+  }
+  RowsPhysicalOperator(const char *table_name, int cell_num, const vector<vector<Value>> *rows) : rows_(rows)
+  {
+    init_names(table_name, cell_num);
+  }
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::TABLE_SCAN; }
+
+  RC open(Trx *) override
+  {
+    index_ = 0;
+    return RC::SUCCESS;
+  }
+  RC next() override
+  {
+    if (index_ >= rows_->size()) {
+      return RC::RECORD_EOF;
+    }
+    tuple_.set_cells((*rows_)[index_++]);
+    return RC::SUCCESS;
+  }
+  RC     close() override { return RC::SUCCESS; }
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  void init_names(const char *table_name, int cell_num)
+  {
+    for (int i = 0; i < cell_num; i++) {
+      field_names_.push_back("f" + std::to_string(i));
+    }
+    vector<TupleCellSpec> specs;
+    for (const string &field_name : field_names_) {
+      specs.emplace_back(table_name, field_name.c_str());
+    }
+    tuple_.set_names(specs);
+  }
+
+private:
+  vector<string>               field_names_;
+  vector<vector<Value>>        owned_rows_;
+  const vector<vector<Value>> *rows_  = nullptr;
+  size_t                       index_ = 0;
+  ValueListTuple               tuple_;
+};
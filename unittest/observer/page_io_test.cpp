@@ -0,0 +1,107 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "common/lang/filesystem.h"
+#include "common/lang/vector.h"
+#include "common/log/log.h"
+#include "storage/buffer/page.h"
+#include "storage/buffer/page_io.h"
+
+using namespace common;
+
+/// 写入并读回一批页面，页面数量超过io_uring队列深度，页面的顺序是打乱的
+static void test_read_write(PageIO &page_io, const char *filename)
+{
+  filesystem::remove(filename);
+  int fd = open(filename, O_CREAT | O_RDWR, 0644);
+  ASSERT_GE(fd, 0);
+
+  const int    page_count = 200;
+  vector<Page> pages(page_count);
+  for (int i = 0; i < page_count; i++) {
+    memset(pages[i].data, 'a' + i % 26, BP_PAGE_DATA_SIZE);
+    pages[i].lsn = i;
+  }
+
+  vector<PageIORequest> requests(page_count);
+  for (int i = 0; i < page_count; i++) {
+    int page_num       = (i * 7) % page_count;  // 7与200互质，每个页面都会写一次
+    requests[i].fd     = fd;
+    requests[i].offset = (int64_t)page_num * BP_PAGE_SIZE;
+    requests[i].buf    = &pages[page_num];
+    requests[i].size   = BP_PAGE_SIZE;
+  }
+  ASSERT_EQ(RC::SUCCESS, page_io.write_pages(requests));
+  ASSERT_EQ((off_t)page_count * BP_PAGE_SIZE, lseek(fd, 0, SEEK_END));
+
+  vector<Page> read_pages(page_count);
+  for (int i = 0; i < page_count; i++) {
+    requests[i].fd     = fd;
+    requests[i].offset = (int64_t)i * BP_PAGE_SIZE;
+    requests[i].buf    = &read_pages[i];
+    requests[i].size   = BP_PAGE_SIZE;
+  }
+  ASSERT_EQ(RC::SUCCESS, page_io.read_pages(requests));
+  for (int i = 0; i < page_count; i++) {
+    ASSERT_EQ(RC::SUCCESS, requests[i].rc);
+    ASSERT_EQ(pages[i].lsn, read_pages[i].lsn);
+    ASSERT_EQ(0, memcmp(pages[i].data, read_pages[i].data, BP_PAGE_DATA_SIZE));
+  }
+
+  // 读到文件尾之后是失败的，但是不影响其它请求
+  requests.resize(2);
+  requests[0].offset = (int64_t)page_count * BP_PAGE_SIZE;
+  requests[1].offset = 0;
+  ASSERT_NE(RC::SUCCESS, page_io.read_pages(requests));
+  ASSERT_NE(RC::SUCCESS, requests[0].rc);
+  ASSERT_EQ(RC::SUCCESS, requests[1].rc);
+
+  close(fd);
+  filesystem::remove(filename);
+}
+
+TEST(PageIO, backend_name)
+{
+  bool valid = false;
+  ASSERT_EQ(PageIOBackend::SYNC, PageIO::backend_from_name("sync", valid));
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(PageIOBackend::IO_URING, PageIO::backend_from_name("IO_URING", valid));
+  ASSERT_TRUE(valid);
+  PageIO::backend_from_name("aio", valid);
+  ASSERT_FALSE(valid);
+}
+
+TEST(PageIO, sync)
+{
+  unique_ptr<PageIO> page_io = PageIO::create(PageIOBackend::SYNC);
+  ASSERT_EQ(PageIOBackend::SYNC, page_io->backend());
+  test_read_write(*page_io, "page_io_test_sync.data");
+}
+
+TEST(PageIO, io_uring)
+{
+  // 不支持io_uring的系统上会退回到sync
+  unique_ptr<PageIO> page_io = PageIO::create(PageIOBackend::IO_URING);
+  ASSERT_NE(page_io, nullptr);
+  LOG_INFO("page io backend: %s", PageIO::backend_name(page_io->backend()));
+  test_read_write(*page_io, "page_io_test_io_uring.data");
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default(string(argv[0]) + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
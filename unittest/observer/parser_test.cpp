@@ -64,6 +64,28 @@ TEST(ParserTest, group_by_test)
   }
 }
 
+TEST(ParserTest, create_index_type_test)
+{
+  {
+    ParsedSqlResult result;
+    ASSERT_EQ(parse("create index i on tab(a, b)", &result), RC::SUCCESS);
+    ASSERT_EQ(SCF_CREATE_INDEX, result.sql_nodes().front()->flag);
+    ASSERT_EQ(IndexType::BPLUS_TREE, result.sql_nodes().front()->create_index.index_type);
+  }
+  {
+    ParsedSqlResult result;
+    ASSERT_EQ(parse("create unique index i on tab(a) using hash", &result), RC::SUCCESS);
+    ASSERT_EQ(SCF_CREATE_INDEX, result.sql_nodes().front()->flag);
+    ASSERT_EQ(IndexType::HASH, result.sql_nodes().front()->create_index.index_type);
+    ASSERT_TRUE(result.sql_nodes().front()->create_index.unique);
+  }
+  {
+    ParsedSqlResult result;
+    parse("create index i on tab(a) using rtree", &result);
+    ASSERT_EQ(SCF_ERROR, result.sql_nodes().front()->flag);
+  }
+}
+
 int main(int argc, char **argv)
 {
 
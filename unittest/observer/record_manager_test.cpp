@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 #include <sstream>
 #include <filesystem>
 #include <utility>
+#include <algorithm>
+#include <random>
 
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/record/record_manager.h"
@@ -200,6 +202,147 @@ TEST(RecordFileScanner, test_record_file_iterator)
   file_scanner.close_scan();
   ASSERT_EQ(count, rids.size() / 2);
 
+  // 分段扫描，每一段只返回自己页面上的记录，合起来与全部扫描的结果一样
+  const PageNum page_count = bp->page_count();
+  const PageNum middle     = (1 + page_count) / 2;
+  ASSERT_GT(page_count, 2);
+  int range_count = 0;
+  for (auto [start_page, end_page] : {pair<PageNum, PageNum>(1, middle), pair<PageNum, PageNum>(middle, page_count)}) {
+    rc = file_scanner.open_scan(
+        nullptr /*table*/, *bp, &trx, log_handler, ReadWriteMode::READ_ONLY, nullptr /*condition_filter*/);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    ASSERT_EQ(RC::SUCCESS, file_scanner.set_page_range(start_page, end_page));
+    while (OB_SUCC(rc = file_scanner.next(record))) {
+      ASSERT_GE(record.rid().page_num, start_page);
+      ASSERT_LT(record.rid().page_num, end_page);
+      range_count++;
+    }
+    ASSERT_EQ(RC::RECORD_EOF, rc);
+    file_scanner.close_scan();
+  }
+  ASSERT_EQ(count, range_count);
+
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(RecordFileHandler, test_get_records)
+{
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager_get_records.bp";
+  filesystem::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, record_manager_file, bp));
+
+  RecordFileHandler file_handler(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, nullptr));
+
+  const int        record_insert_num = 1000;
+  char             record_data[20];
+  std::vector<RID> rids;
+  for (int i = 0; i < record_insert_num; i++) {
+    memset(record_data, 0, sizeof(record_data));
+    memcpy(record_data, &i, sizeof(i));
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+    rids.push_back(rid);
+  }
+  ASSERT_NE(rids.front().page_num, rids.back().page_num);
+
+  // 按照页面排好序和乱序的结果都与逐条获取一致
+  std::vector<int> order(record_insert_num);
+  for (int i = 0; i < record_insert_num; i++) {
+    order[i] = i;
+  }
+  for (int round = 0; round < 2; round++) {
+    if (round == 1) {
+      std::shuffle(order.begin(), order.end(), std::mt19937(0));
+    }
+
+    std::vector<RID> batch_rids;
+    for (int index : order) {
+      batch_rids.push_back(rids[index]);
+    }
+
+    std::vector<Record> records(record_insert_num);
+    ASSERT_EQ(RC::SUCCESS, file_handler.get_records(batch_rids.data(), record_insert_num, records.data()));
+    for (int i = 0; i < record_insert_num; i++) {
+      ASSERT_EQ(batch_rids[i], records[i].rid());
+      ASSERT_EQ(order[i], *(const int *)records[i].data());
+    }
+  }
+
+  RID invalid_rid = rids.back();
+  ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&invalid_rid));
+  std::vector<Record> records(2);
+  RID                 batch_rids[] = {rids.front(), invalid_rid};
+  ASSERT_NE(RC::SUCCESS, file_handler.get_records(batch_rids, 2, records.data()));
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(RecordFileHandler, test_visibility_map)
+{
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager_visibility_map.bp";
+  filesystem::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, record_manager_file, bp));
+
+  RecordFileHandler file_handler(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, nullptr));
+
+  // 记录的第一个整数作为插入记录的事务号，负数表示还没有提交
+  char record_data[20];
+  RID  rid;
+  for (int i = 1; i <= 10; i++) {
+    memset(record_data, 0, sizeof(record_data));
+    memcpy(record_data, &i, sizeof(i));
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  }
+  const PageNum page_num = rid.page_num;
+
+  auto visible_from = [](const Record &record) {
+    const int32_t xid = *(const int32_t *)record.data();
+    return xid < 0 ? VisibilityMap::NEVER_ALL_VISIBLE : xid;
+  };
+
+  int32_t page_visible_from = 0;
+  ASSERT_FALSE(file_handler.visibility_map().get(page_num, page_visible_from));
+  ASSERT_EQ(RC::SUCCESS, file_handler.refresh_visibility(page_num, visible_from, page_visible_from));
+  ASSERT_EQ(10, page_visible_from);
+  page_visible_from = 0;
+  ASSERT_TRUE(file_handler.visibility_map().get(page_num, page_visible_from));
+  ASSERT_EQ(10, page_visible_from);
+
+  // 页面上插入记录后标记失效
+  const int uncommitted = -1;
+  memcpy(record_data, &uncommitted, sizeof(uncommitted));
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  ASSERT_EQ(page_num, rid.page_num);
+  ASSERT_FALSE(file_handler.visibility_map().get(page_num, page_visible_from));
+  ASSERT_EQ(RC::SUCCESS, file_handler.refresh_visibility(page_num, visible_from, page_visible_from));
+  ASSERT_EQ(VisibilityMap::NEVER_ALL_VISIBLE, page_visible_from);
+
+  // 删除记录后标记也失效
+  ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&rid));
+  ASSERT_FALSE(file_handler.visibility_map().get(page_num, page_visible_from));
+  ASSERT_EQ(RC::SUCCESS, file_handler.refresh_visibility(page_num, visible_from, page_visible_from));
+  ASSERT_EQ(10, page_visible_from);
+
+  file_handler.close();
   bpm->close_file(record_manager_file);
   delete bpm;
 }